@@ -0,0 +1,149 @@
+// Copyright (c) 2023 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include "batch_input.h"
+
+#include <shapes/path_algos.h>
+#include <shapes/shapes.h>
+#include <stdutils/algorithm.h>
+#include <stdutils/string.h>
+#include <svg/svg.h>
+
+#include <sstream>
+#include <utility>
+
+namespace batch {
+
+namespace {
+
+shapes::io::ShapeAggregate<scalar> load_cdt_file(const std::filesystem::path& filepath, const stdutils::io::ErrorHandler& err_handler)
+{
+    shapes::io::ShapeAggregate<scalar> result;
+    const auto point_dim = shapes::io::cdt::peek_point_dimension(filepath, err_handler);
+    if (point_dim != 2 && point_dim != 3)
+    {
+        err_handler(stdutils::io::Severity::ERR, "Only support 2D or 3D points");
+        return result;
+    }
+    shapes::Soup2d<scalar> cdt_shapes;
+    if (point_dim == 3)
+    {
+        // See parse_3d_shapes_projected_from_stream()
+        err_handler(stdutils::io::Severity::INFO, "The 3D points are projected on the XY plane");
+        cdt_shapes = shapes::io::cdt::parse_3d_shapes_projected_from_file(filepath, shapes::io::cdt::Projection(), err_handler);
+    }
+    else
+    {
+        cdt_shapes = shapes::io::cdt::parse_2d_shapes_from_file(filepath, err_handler);
+    }
+    if (!cdt_shapes.point_cloud.vertices.empty())
+    {
+        result.emplace_back(std::move(cdt_shapes.point_cloud));
+    }
+    if (!cdt_shapes.edges.vertices.empty())
+    {
+        auto point_paths = shapes::extract_paths(cdt_shapes.edges);
+        for (auto& pp : point_paths) { result.emplace_back(std::move(pp)); }
+    }
+    // Ignore Triangles2d
+    return result;
+}
+
+shapes::io::ShapeAggregate<scalar> load_svg_file(const std::filesystem::path& filepath, const stdutils::io::ErrorHandler& err_handler)
+{
+    shapes::io::ShapeAggregate<scalar> result;
+    auto file_paths = svg::io::parse_svg_paths(filepath, err_handler);
+    result.reserve(file_paths.point_paths.size() + file_paths.cubic_bezier_paths.size());
+    for (auto& pp : file_paths.point_paths)
+        result.emplace_back(std::move(pp));
+    for (auto& cbp : file_paths.cubic_bezier_paths)
+        result.emplace_back(std::move(cbp));
+    return result;
+}
+
+} // namespace
+
+void filter_2d_shapes(shapes::io::ShapeAggregate<scalar>& aggregate, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    stdutils::erase_if(aggregate, [&err_handler](const auto& shape_wrapper) {
+        const auto& shape = shape_wrapper.shape;
+        if (shapes::get_dimension(shape) != 2)
+        {
+            std::stringstream out;
+            out << "Input shape of type " << shapes::get_type_str(shape) << " is not supported and was filtered out";
+            err_handler(stdutils::io::Severity::ERR, out.str());
+            return true;
+        }
+        return false;
+    });
+}
+
+TriangulationInput parse_input_buffer(std::string name, std::string_view buffer, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    TriangulationInput result;
+    result.name = std::move(name);
+    result.shapes = shapes::io::shb::parse_shapes_from_buffer(buffer, err_handler);
+    filter_2d_shapes(result.shapes, err_handler);
+    return result;
+}
+
+TriangulationInput load_input_file(const std::filesystem::path& filepath, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    TriangulationInput result;
+    result.name = filepath.filename().string();
+    const std::string ext = stdutils::string::tolower(filepath.extension().string());
+    if (ext == ".dat")
+    {
+        result.shapes = shapes::io::dat::parse_shapes_from_file(filepath, err_handler);
+    }
+    else if (ext == ".cdt")
+    {
+        result.shapes = load_cdt_file(filepath, err_handler);
+    }
+    else if (ext == shapes::io::shb::FILE_EXTENSION)
+    {
+        result.shapes = shapes::io::shb::parse_shapes_from_file(filepath, err_handler);
+    }
+    else if (ext == ".svg")
+    {
+        result.shapes = load_svg_file(filepath, err_handler);
+    }
+    else
+    {
+        std::stringstream out;
+        out << "Unknown file extension: " << filepath;
+        err_handler(stdutils::io::Severity::ERR, out.str());
+        return result;
+    }
+    filter_2d_shapes(result.shapes, err_handler);
+    return result;
+}
+
+std::vector<TriangulationInput> load_input_files(const std::vector<std::filesystem::path>& filepaths, const stdutils::parallel::Policy& policy, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    std::vector<TriangulationInput> result;
+    try
+    {
+        const std::size_t nb_files = filepaths.size();
+        result.resize(nb_files);
+        std::vector<stdutils::io::ErrorLog> logs(nb_files);
+        stdutils::parallel::for_each_ordered(policy, nb_files, [&filepaths, &result, &logs](std::size_t idx) {
+            result[idx] = load_input_file(filepaths[idx], logs[idx].handler());
+        }, [&result, &logs, &err_handler, nb_files](std::size_t idx) {
+            logs[idx].forward(err_handler);
+            logs[idx].clear();
+            std::stringstream out;
+            out << "Loaded input file " << (idx + 1) << "/" << nb_files << ": " << result[idx].name;
+            err_handler(stdutils::io::Severity::TRACE, out.str());
+        });
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream out;
+        out << "batch::load_input_files: " << e.what();
+        err_handler(stdutils::io::Severity::EXCPT, out.str());
+        result.clear();
+    }
+    return result;
+}
+
+} // namespace batch
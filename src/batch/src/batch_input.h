@@ -0,0 +1,37 @@
+// Copyright (c) 2023 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <shapes/io.h>
+#include <stdutils/io.h>
+#include <stdutils/parallel.h>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace batch {
+
+using scalar = double;
+
+struct TriangulationInput
+{
+    std::string name;
+    shapes::io::ShapeAggregate<scalar> shapes;
+};
+
+// Only the 2D shapes are kept; other shapes are filtered out with an error message.
+void filter_2d_shapes(shapes::io::ShapeAggregate<scalar>& aggregate, const stdutils::io::ErrorHandler& err_handler) noexcept;
+
+// Parse an SHB buffer, e.g. received by the server. It does not need to be aligned. Only the 2D shapes are kept, see filter_2d_shapes().
+TriangulationInput parse_input_buffer(std::string name, std::string_view buffer, const stdutils::io::ErrorHandler& err_handler) noexcept;
+
+// Load a DAT, CDT, SHB or SVG file. The file format is deduced from the file extension. Only the 2D shapes are kept, see filter_2d_shapes().
+TriangulationInput load_input_file(const std::filesystem::path& filepath, const stdutils::io::ErrorHandler& err_handler) noexcept;
+
+// Load several input files concurrently. The result is in the same order as the input paths.
+// The messages of each file, followed by a progress message, are passed to err_handler on the calling thread in the order of the input paths.
+std::vector<TriangulationInput> load_input_files(const std::vector<std::filesystem::path>& filepaths, const stdutils::parallel::Policy& policy, const stdutils::io::ErrorHandler& err_handler) noexcept;
+
+} // namespace batch
@@ -0,0 +1,173 @@
+// Copyright (c) 2023 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include "batch_report.h"
+
+#include <stdutils/io.h>
+#include <stdutils/stats.h>
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace batch {
+
+namespace {
+
+// The quality metrics of a triangulation, in the order of the report columns
+constexpr std::array<std::string_view, 4> quality_metric_names = { "min_angle_deg", "aspect_ratio", "area", "edge_length" };
+
+std::array<const stdutils::stats::Result<scalar>*, 4> quality_metrics(const shapes::TriangulationStats<scalar>& quality)
+{
+    return { &quality.min_angle, &quality.aspect_ratio, &quality.area, &quality.edge_length };
+}
+
+std::string policy_str(delaunay::TriangulationPolicy policy)
+{
+    std::stringstream out;
+    out << policy;
+    return out.str();
+}
+
+// Quote a string for CSV if needed (RFC 4180)
+std::string csv_field(std::string_view str)
+{
+    if (str.find_first_of(",\"\n") == std::string_view::npos)
+        return std::string(str);
+    std::string result = "\"";
+    for (const char c : str)
+    {
+        if (c == '"') { result.push_back('"'); }
+        result.push_back(c);
+    }
+    result.push_back('"');
+    return result;
+}
+
+std::string json_string(std::string_view str)
+{
+    std::string result = "\"";
+    for (const char c : str)
+    {
+        switch (c)
+        {
+            case '"':   result.append("\\\""); break;
+            case '\\':  result.append("\\\\"); break;
+            case '\n':  result.append("\\n"); break;
+            case '\r':  result.append("\\r"); break;
+            case '\t':  result.append("\\t"); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    std::stringstream out;
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+                    result.append(out.str());
+                }
+                else
+                {
+                    result.push_back(c);
+                }
+                break;
+        }
+    }
+    result.push_back('"');
+    return result;
+}
+
+} // namespace
+
+void write_report(std::ostream& out, const std::vector<AlgoBenchmark>& benchmarks, ReportFormat format)
+{
+    switch (format)
+    {
+        case ReportFormat::CSV:
+            write_csv_report(out, benchmarks);
+            break;
+
+        case ReportFormat::JSON:
+            write_json_report(out, benchmarks);
+            break;
+
+        default:
+            assert(0);
+            break;
+    }
+}
+
+void write_csv_report(std::ostream& out, const std::vector<AlgoBenchmark>& benchmarks)
+{
+    stdutils::io::SaveNumericFormat save_fmt(out);
+    out << std::setprecision(6);
+    out << "input,algo,policy,success,runs,input_vertices,vertices,triangles,min_ms,median_ms,p99_ms,mean_ms,concurrent,algo_bytes,output_bytes,compressed_bytes,peak_rss_bytes";
+    for (const auto& metric : quality_metric_names)
+        out << ',' << metric << "_min," << metric << "_mean," << metric << "_stdev," << metric << "_max";
+    out << ",degenerate_faces\n";
+    for (const auto& bench : benchmarks)
+    {
+        out << csv_field(bench.input_name) << ','
+            << csv_field(bench.algo_name) << ','
+            << policy_str(bench.policy) << ','
+            << (bench.success ? 1 : 0) << ','
+            << bench.durations_ms.size() << ','
+            << bench.nb_input_vertices << ','
+            << bench.nb_vertices << ','
+            << bench.nb_triangles << ','
+            << bench.min_ms << ','
+            << bench.median_ms << ','
+            << bench.p99_ms << ','
+            << bench.mean_ms << ','
+            << (bench.concurrent ? 1 : 0) << ','
+            << bench.algo_bytes << ','
+            << bench.output_bytes << ','
+            << bench.compressed_bytes << ','
+            << bench.peak_rss;
+        for (const auto* stats : quality_metrics(bench.quality))
+            out << ',' << stats->min << ',' << stats->mean << ',' << stats->stdev << ',' << stats->max;
+        out << ',' << bench.quality.nb_degenerate_faces << '\n';
+    }
+}
+
+void write_json_report(std::ostream& out, const std::vector<AlgoBenchmark>& benchmarks)
+{
+    stdutils::io::SaveNumericFormat save_fmt(out);
+    out << std::setprecision(6);
+    out << "[";
+    bool first = true;
+    for (const auto& bench : benchmarks)
+    {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "  {\n"
+            << "    \"input\": " << json_string(bench.input_name) << ",\n"
+            << "    \"algo\": " << json_string(bench.algo_name) << ",\n"
+            << "    \"policy\": " << json_string(policy_str(bench.policy)) << ",\n"
+            << "    \"success\": " << (bench.success ? "true" : "false") << ",\n"
+            << "    \"runs\": " << bench.durations_ms.size() << ",\n"
+            << "    \"input_vertices\": " << bench.nb_input_vertices << ",\n"
+            << "    \"vertices\": " << bench.nb_vertices << ",\n"
+            << "    \"triangles\": " << bench.nb_triangles << ",\n"
+            << "    \"min_ms\": " << bench.min_ms << ",\n"
+            << "    \"median_ms\": " << bench.median_ms << ",\n"
+            << "    \"p99_ms\": " << bench.p99_ms << ",\n"
+            << "    \"mean_ms\": " << bench.mean_ms << ",\n"
+            << "    \"concurrent\": " << (bench.concurrent ? "true" : "false") << ",\n"
+            << "    \"algo_bytes\": " << bench.algo_bytes << ",\n"
+            << "    \"output_bytes\": " << bench.output_bytes << ",\n"
+            << "    \"compressed_bytes\": " << bench.compressed_bytes << ",\n"
+            << "    \"peak_rss_bytes\": " << bench.peak_rss << ",\n";
+        const auto metrics = quality_metrics(bench.quality);
+        for (std::size_t idx = 0; idx < metrics.size(); idx++)
+        {
+            const auto& stats = *metrics[idx];
+            out << "    " << json_string(quality_metric_names[idx]) << ": { \"min\": " << stats.min << ", \"mean\": " << stats.mean << ", \"stdev\": " << stats.stdev << ", \"max\": " << stats.max << " },\n";
+        }
+        out << "    \"degenerate_faces\": " << bench.quality.nb_degenerate_faces << "\n"
+            << "  }";
+    }
+    out << "\n]\n";
+}
+
+} // namespace batch
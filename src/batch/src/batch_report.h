@@ -0,0 +1,24 @@
+// Copyright (c) 2023 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include "batch_runner.h"
+
+#include <ostream>
+#include <vector>
+
+namespace batch {
+
+enum class ReportFormat
+{
+    CSV,
+    JSON,
+};
+
+// One line (CSV) or one object (JSON) per algorithm and per input
+void write_report(std::ostream& out, const std::vector<AlgoBenchmark>& benchmarks, ReportFormat format);
+
+void write_csv_report(std::ostream& out, const std::vector<AlgoBenchmark>& benchmarks);
+void write_json_report(std::ostream& out, const std::vector<AlgoBenchmark>& benchmarks);
+
+} // namespace batch
@@ -0,0 +1,318 @@
+// Copyright (c) 2023 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include "batch_runner.h"
+
+#include <dt/dt_impl.h>
+#include <shapes/bounding_box.h>
+#include <shapes/bounding_box_algos.h>
+#include <shapes/compressed_mesh.h>
+#include <shapes/memory.h>
+#include <shapes/path_algos.h>
+#include <shapes/sampling.h>
+#include <shapes/shapes.h>
+#include <shapes/triangle_algos.h>
+#include <stdutils/arena.h>
+#include <stdutils/chrono.h>
+#include <stdutils/memory.h>
+#include <stdutils/parallel.h>
+#include <stdutils/stats.h>
+#include <stdutils/visit.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <variant>
+
+namespace batch {
+
+namespace {
+
+shapes::BoundingBox2d<scalar> input_bounding_box(const TriangulationInput& input)
+{
+    shapes::BoundingBox2d<scalar> bounding_box;
+    for (const auto& shape_wrapper : input.shapes)
+    {
+        std::visit(stdutils::Overloaded {
+            [&bounding_box](const shapes::PointCloud2d<scalar>& s) { bounding_box.merge(shapes::fast_bounding_box(s)); },
+            [&bounding_box](const shapes::PointPath2d<scalar>& s) { bounding_box.merge(shapes::fast_bounding_box(s)); },
+            [&bounding_box](const shapes::CubicBezierPath2d<scalar>& s) { bounding_box.merge(shapes::fast_bounding_box(s)); },
+            [&bounding_box](const shapes::Edges2d<scalar>& s) { bounding_box.merge(shapes::fast_bounding_box(s)); },
+            [](const auto&) { /* Skip */ }
+        }, shape_wrapper.shape);
+    }
+    return bounding_box;
+}
+
+// Replace the Bezier paths with their Casteljau sampling, within a tolerance relative to the diameter of the input: The flat regions
+// get few vertices. The other shapes are copied as they are.
+TriangulationInput sample_bezier_paths(const TriangulationInput& input, float bezier_flatness)
+{
+    const scalar tolerance = static_cast<scalar>(bezier_flatness) * input_bounding_box(input).diameter();
+    TriangulationInput result;
+    result.name = input.name;
+    result.shapes.reserve(input.shapes.size());
+    stdutils::parallel::Policy sampling_policy;
+    sampling_policy.min_chunk_size = 64;            // CBP segments
+    for (const auto& shape_wrapper : input.shapes)
+    {
+        const auto* cbp = std::get_if<shapes::CubicBezierPath2d<scalar>>(&shape_wrapper.shape);
+        if (cbp && !cbp->empty() && tolerance > scalar{0})
+            result.shapes.emplace_back(shapes::CasteljauSamplingCubicBezier2d<scalar>().sample(sampling_policy, *cbp, tolerance), shape_wrapper.descr);
+        else
+            result.shapes.emplace_back(shape_wrapper);
+    }
+    return result;
+}
+
+// Simplify the point paths, all at once so that the topology is preserved between them. The other shapes are copied as they are.
+TriangulationInput simplify_point_paths(TriangulationInput input, const RunSettings& settings)
+{
+    shapes::SimplificationOptions options;
+    options.method = settings.simplification_method;
+    options.tolerance = static_cast<double>(settings.path_simplification) * input_bounding_box(input).diameter();
+    options.preserve_topology = true;
+    std::vector<shapes::PointPath2d<scalar>> paths;
+    for (const auto& shape_wrapper : input.shapes)
+    {
+        if (const auto* pp = std::get_if<shapes::PointPath2d<scalar>>(&shape_wrapper.shape))
+            paths.emplace_back(*pp);
+    }
+    stdutils::parallel::Policy simplification_policy;
+    simplification_policy.min_chunk_size = 1;       // Paths
+    auto simplified_paths = shapes::simplify_paths(simplification_policy, paths, options);
+    auto path_it = simplified_paths.begin();
+    for (auto& shape_wrapper : input.shapes)
+    {
+        if (auto* pp = std::get_if<shapes::PointPath2d<scalar>>(&shape_wrapper.shape))
+            *pp = std::move(*path_it++);
+    }
+    return input;
+}
+
+// Run one triangulation: The setup is not part of the measurement
+void triangulate_and_record(delaunay::Interface<scalar, std::uint32_t>& triangulation_algo, const RunSettings& settings, AlgoBenchmark& bench)
+{
+    std::chrono::duration<float, std::milli> duration{0};
+    shapes::Triangles2d<scalar> triangulation;
+    bench.algo_bytes = std::max(bench.algo_bytes, triangulation_algo.byte_size());
+    {
+        stdutils::chrono::DurationMeas meas(duration);
+        if (settings.timeout_ms > 0)
+        {
+            const delaunay::CancellationToken token(std::chrono::milliseconds(settings.timeout_ms));
+            triangulation = triangulation_algo.triangulate_and_release(settings.policy, &token);
+        }
+        else
+        {
+            triangulation = triangulation_algo.triangulate_and_release(settings.policy);
+        }
+    }
+    bench.durations_ms.push_back(duration.count());
+    bench.nb_vertices = triangulation.vertices.size();
+    bench.nb_triangles = triangulation.faces.size();
+    bench.success &= !triangulation.faces.empty();
+    bench.output_bytes = shapes::byte_size(triangulation);
+    bench.compressed_bytes = shapes::CompressedTriangles<scalar>(triangulation).byte_size();
+    if (bench.durations_ms.size() == 1)
+    {
+        // Sequential if the other algorithms are being measured concurrently
+        stdutils::parallel::Policy stats_policy;
+        if (settings.concurrent) { stats_policy.nb_threads = 1; }
+        bench.quality = shapes::triangulation_stats(stats_policy, triangulation);
+    }
+    bench.peak_rss = std::max(bench.peak_rss, stdutils::memory::get_peak_rss());
+}
+
+// Nearest-rank percentile of a sorted list of samples. q in [0, 1]
+float percentile(const std::vector<float>& sorted_samples, float q)
+{
+    assert(0.f <= q && q <= 1.f);
+    if (sorted_samples.empty()) { return 0.f; }
+    assert(std::is_sorted(std::cbegin(sorted_samples), std::cend(sorted_samples)));
+    const auto n = sorted_samples.size();
+    const auto rank = static_cast<std::size_t>(std::ceil(q * static_cast<float>(n)));
+    return sorted_samples[std::clamp<std::size_t>(rank, 1, n) - 1];
+}
+
+void compute_stats(AlgoBenchmark& bench)
+{
+    if (bench.durations_ms.empty()) { return; }
+    stdutils::stats::CumulSamples<float> samples;
+    samples.add_samples(std::cbegin(bench.durations_ms), std::cend(bench.durations_ms));
+    const auto& result = samples.get_result();
+    bench.min_ms = result.min;
+    bench.mean_ms = result.mean;
+    bench.median_ms = stdutils::stats::median<float>(std::cbegin(bench.durations_ms), std::cend(bench.durations_ms));
+    std::vector<float> sorted_samples = bench.durations_ms;
+    std::sort(std::begin(sorted_samples), std::end(sorted_samples));
+    bench.p99_ms = percentile(sorted_samples, 0.99f);
+}
+
+bool is_selected(const std::string& algo_name, const std::string& auto_algo_name, const RunSettings& settings)
+{
+    return settings.algo_filter.empty()
+        || algo_name == auto_algo_name
+        || std::find(std::cbegin(settings.algo_filter), std::cend(settings.algo_filter), algo_name) != std::cend(settings.algo_filter);
+}
+
+} // namespace
+
+void setup_triangulation(delaunay::Interface<scalar, std::uint32_t>& triangulation_algo, const TriangulationInput& input)
+{
+    bool first_path = true;
+    for (const auto& shape_wrapper : input.shapes)
+    {
+        std::visit(stdutils::Overloaded {
+            [&triangulation_algo](const shapes::PointCloud2d<scalar>& pc) { triangulation_algo.add_steiner(pc); },
+            [&triangulation_algo, &first_path](const shapes::PointPath2d<scalar>& pp) {
+                if (first_path) { triangulation_algo.add_path(pp); first_path = false; }
+                else { triangulation_algo.add_hole(pp); }
+            },
+            [](const shapes::CubicBezierPath2d<scalar>&) { /* Skip */ },
+            [&triangulation_algo](const shapes::Edges2d<scalar>& edges) { triangulation_algo.add_edges(edges); },
+            [](const shapes::Triangles2d<scalar>&) { /* Skip */ },
+            [](const auto&) { assert(0); }
+        }, shape_wrapper.shape);
+    }
+}
+
+std::optional<TriangulationInput> prepare_input(const TriangulationInput& input, const RunSettings& settings)
+{
+    std::optional<TriangulationInput> result;
+    if (std::any_of(input.shapes.cbegin(), input.shapes.cend(), [](const auto& shape_wrapper) { return shapes::is_bezier_path(shape_wrapper.shape); }))
+    {
+        result = sample_bezier_paths(input, settings.bezier_flatness);
+    }
+    if (settings.path_simplification > 0.f)
+    {
+        result = simplify_point_paths(result.has_value() ? std::move(*result) : input, settings);
+    }
+    return result;
+}
+
+std::vector<AlgoBenchmark> run_all_algos(const TriangulationInput& original_input, const RunSettings& settings, const stdutils::io::ErrorHandler& err_handler)
+{
+    const std::optional<TriangulationInput> prepared_input = prepare_input(original_input, settings);
+    const TriangulationInput& input = prepared_input.has_value() ? *prepared_input : original_input;
+
+    std::vector<AlgoBenchmark> result;
+    std::size_t nb_input_vertices = 0;
+    std::size_t nb_constraint_vertices = 0;
+    bool has_skipped_shapes = false;
+    for (const auto& shape_wrapper : input.shapes)
+    {
+        const bool is_constraint = shapes::is_point_path(shape_wrapper.shape) || std::holds_alternative<shapes::Edges2d<scalar>>(shape_wrapper.shape);
+        if (is_constraint || shapes::is_point_cloud(shape_wrapper.shape))
+            nb_input_vertices += shapes::nb_vertices(shape_wrapper.shape);
+        else
+            has_skipped_shapes = true;
+        if (is_constraint) { nb_constraint_vertices += shapes::nb_vertices(shape_wrapper.shape); }
+    }
+    if (has_skipped_shapes)
+    {
+        std::stringstream out;
+        out << input.name << ": Triangles are not part of the triangulation input";
+        err_handler(stdutils::io::Severity::WARN, out.str());
+    }
+
+    std::string auto_algo_name;
+    if (std::find(std::cbegin(settings.algo_filter), std::cend(settings.algo_filter), "auto") != std::cend(settings.algo_filter))
+    {
+        delaunay::InputFeatures features;
+        features.policy = settings.policy;
+        features.nb_vertices = nb_input_vertices;
+        features.nb_constraint_vertices = nb_constraint_vertices;
+        auto_algo_name = delaunay::select_impl_name<scalar>(features, settings.selection_profile);
+        err_handler(stdutils::io::Severity::INFO, input.name + ": The auto selection is " + auto_algo_name);
+    }
+
+    std::vector<delaunay::RegisteredImpl<scalar, std::uint32_t>> algos;
+    for (const auto& algo : delaunay::get_impl_list<scalar>().algos)
+    {
+        if (!is_selected(algo.name, auto_algo_name, settings))
+            continue;
+
+        algos.emplace_back(algo);
+        auto& bench = result.emplace_back();
+        bench.input_name = input.name;
+        bench.algo_name = algo.name;
+        bench.policy = settings.policy;
+        bench.concurrent = settings.concurrent;
+        bench.nb_input_vertices = nb_input_vertices;
+        bench.nb_constraint_vertices = nb_constraint_vertices;
+        bench.success = true;
+        bench.durations_ms.reserve(settings.nb_runs);
+    }
+    assert(algos.size() == result.size());
+
+    // One arena per algorithm, reset after each run: Only the first run grows the buffer
+    std::vector<stdutils::Arena> arenas(settings.arena ? algos.size() : 0);
+    const auto arena = [&arenas](std::size_t algo_idx) { return arenas.empty() ? nullptr : &arenas[algo_idx]; };
+
+    if (settings.concurrent)
+    {
+        // Each algorithm reports to its own log, forwarded in order once the run is complete
+        const stdutils::parallel::Policy policy{ static_cast<unsigned int>(algos.size()), 1 };
+        for (unsigned int run = 0; run < settings.nb_runs; run++)
+        {
+            std::vector<stdutils::io::ErrorLog> logs(algos.size());
+            std::vector<std::unique_ptr<delaunay::Interface<scalar, std::uint32_t>>> triangulation_algos;
+            triangulation_algos.reserve(algos.size());
+            for (std::size_t algo_idx = 0; algo_idx < algos.size(); algo_idx++)
+            {
+                const auto algo_err_handler = logs[algo_idx].handler();
+                auto& triangulation_algo = triangulation_algos.emplace_back(delaunay::get_impl(algos[algo_idx], &algo_err_handler));
+                assert(triangulation_algo);
+                triangulation_algo->set_arena(arena(algo_idx));
+                setup_triangulation(*triangulation_algo, input);
+            }
+            stdutils::parallel::for_each_chunk(policy, algos.size(), [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+                for (std::size_t algo_idx = begin_idx; algo_idx < end_idx; algo_idx++)
+                    triangulate_and_record(*triangulation_algos[algo_idx], settings, result[algo_idx]);
+            });
+            for (auto& algo_arena : arenas) { algo_arena.reset(); }
+            for (const auto& log : logs) { log.forward(err_handler); }
+        }
+    }
+    else
+    {
+        for (std::size_t algo_idx = 0; algo_idx < algos.size(); algo_idx++)
+        {
+            for (unsigned int run = 0; run < settings.nb_runs; run++)
+            {
+                // The setup of the triangulation is not part of the measurement
+                auto triangulation_algo = delaunay::get_impl(algos[algo_idx], &err_handler);
+                assert(triangulation_algo);
+                triangulation_algo->set_arena(arena(algo_idx));
+                setup_triangulation(*triangulation_algo, input);
+                triangulate_and_record(*triangulation_algo, settings, result[algo_idx]);
+                if (settings.arena) { arenas[algo_idx].reset(); }
+            }
+        }
+    }
+    for (auto& bench : result) { compute_stats(bench); }
+    return result;
+}
+
+delaunay::SelectionProfile selection_profile(const std::vector<AlgoBenchmark>& benchmarks)
+{
+    delaunay::SelectionProfile result;
+    for (const auto& bench : benchmarks)
+    {
+        if (!bench.success || bench.concurrent)
+            continue;
+        auto& measurement = result.measurements.emplace_back();
+        measurement.algo_name = bench.algo_name;
+        measurement.features.policy = bench.policy;
+        measurement.features.nb_vertices = bench.nb_input_vertices;
+        measurement.features.nb_constraint_vertices = bench.nb_constraint_vertices;
+        measurement.median_ms = bench.median_ms;
+    }
+    return result;
+}
+
+} // namespace batch
@@ -0,0 +1,72 @@
+// Copyright (c) 2023 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include "batch_input.h"
+
+#include <dt/auto_select.h>
+#include <dt/dt_interface.h>
+#include <shapes/path_algos.h>
+#include <shapes/triangle_algos.h>
+#include <stdutils/io.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace batch {
+
+struct RunSettings
+{
+    delaunay::TriangulationPolicy policy{delaunay::TriangulationPolicy::CDT};
+    unsigned int nb_runs{10};
+    std::vector<std::string> algo_filter{};         // If empty, run all the registered algorithms. "auto" selects the algorithm of delaunay::select_impl_name()
+    delaunay::SelectionProfile selection_profile{}; // Profile of the "auto" selection
+    bool concurrent{false};                         // Each run launches all the selected algorithms at once, on one thread each
+    unsigned int timeout_ms{0};                     // Deadline of each triangulation. A run that times out is a failure. (0: No timeout)
+    bool arena{false};                              // Each algorithm allocates its transient buffers in an arena, reused from one run to the next
+    float bezier_flatness{0.001f};                  // The Bezier paths are sampled within that tolerance, relative to the diameter of the input
+    float path_simplification{0.f};                 // If positive, the point paths are simplified within that tolerance, relative to the diameter of the input
+    shapes::SimplificationMethod simplification_method{shapes::SimplificationMethod::DouglasPeucker};
+};
+
+// Benchmark of one triangulation algorithm on one input
+struct AlgoBenchmark
+{
+    std::string input_name;
+    std::string algo_name;
+    delaunay::TriangulationPolicy policy{delaunay::TriangulationPolicy::CDT};
+    bool concurrent{false};                         // The algorithm ran concurrently with the other ones
+    std::size_t nb_input_vertices{0};
+    std::size_t nb_constraint_vertices{0};          // Input vertices of the paths (including the sampled Bezier paths) and the edges
+    std::size_t nb_vertices{0};                     // Output of the triangulation
+    std::size_t nb_triangles{0};                    // Output of the triangulation
+    bool success{false};                            // All runs produced a valid, non-empty triangulation
+    std::vector<float> durations_ms;                // Wall time of each run
+    float min_ms{0.f};
+    float median_ms{0.f};
+    float p99_ms{0.f};
+    float mean_ms{0.f};
+    std::size_t algo_bytes{0};                      // Memory held by the algorithm once set up (max over the runs), see delaunay::Interface::byte_size()
+    std::size_t output_bytes{0};                    // Memory of the output triangulation
+    std::size_t compressed_bytes{0};                // Memory of the output triangulation once compressed, see shapes::CompressedTriangles
+    std::size_t peak_rss{0};                        // Peak RSS of the process at the end of the runs. It includes the previous runs and inputs.
+    shapes::TriangulationStats<scalar> quality;     // Of the output triangulation of the first run
+};
+
+// Sample the Bezier paths of the input and simplify its point paths, according to the settings. The input is only copied if it has
+// Bezier paths or if the paths are simplified, otherwise the result is empty.
+std::optional<TriangulationInput> prepare_input(const TriangulationInput& input, const RunSettings& settings);
+
+// Same convention as the GUI: The first path is the outer boundary, the next ones are holes. The triangles are skipped.
+void setup_triangulation(delaunay::Interface<scalar, std::uint32_t>& triangulation_algo, const TriangulationInput& input);
+
+// Run all the registered Delaunay implementations (or the subset selected in the settings) on one input
+std::vector<AlgoBenchmark> run_all_algos(const TriangulationInput& input, const RunSettings& settings, const stdutils::io::ErrorHandler& err_handler);
+
+// The median durations of the successful benchmarks, to be saved as the profile of the "auto" selection
+delaunay::SelectionProfile selection_profile(const std::vector<AlgoBenchmark>& benchmarks);
+
+} // namespace batch
@@ -0,0 +1,462 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include "batch_server.h"
+
+#include <shapes/shapes.h>
+#include <stdutils/arena.h>
+#include <stdutils/platform.h>
+#include <stdutils/thread_pool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace batch {
+
+namespace {
+
+using Algo = delaunay::Interface<scalar, std::uint32_t>;
+
+constexpr std::size_t FRAME_HEADER_SIZE = 8;
+
+// Return false at the end of the stream, with an error message if it ends in the middle of a frame
+bool read_frame(std::istream& in, std::uint64_t max_bytes, std::string& payload, std::string& error)
+{
+    unsigned char header[FRAME_HEADER_SIZE];
+    if (!in.read(reinterpret_cast<char*>(header), static_cast<std::streamsize>(FRAME_HEADER_SIZE)))
+    {
+        if (in.gcount() != 0) { error = "Truncated frame header"; }
+        return false;
+    }
+    std::uint64_t length = 0;
+    for (std::size_t k = 0; k < FRAME_HEADER_SIZE; k++) { length |= static_cast<std::uint64_t>(header[k]) << (8 * k); }
+    if (length > max_bytes)
+    {
+        error = "The request of " + std::to_string(length) + " bytes exceeds the maximum size of " + std::to_string(max_bytes) + " bytes";
+        return false;
+    }
+    payload.resize(length);
+    if (!in.read(payload.data(), static_cast<std::streamsize>(length)))
+    {
+        error = "Truncated request";
+        return false;
+    }
+    return true;
+}
+
+void write_frame(std::ostream& out, std::string_view payload)
+{
+    unsigned char header[FRAME_HEADER_SIZE];
+    const std::uint64_t length = payload.size();
+    for (std::size_t k = 0; k < FRAME_HEADER_SIZE; k++) { header[k] = static_cast<unsigned char>((length >> (8 * k)) & 0xFF); }
+    out.write(reinterpret_cast<const char*>(header), static_cast<std::streamsize>(FRAME_HEADER_SIZE));
+    out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    out.flush();
+}
+
+struct Request
+{
+    std::size_t id{0};
+    std::string payload;
+};
+
+// The requests are received on a dedicated thread, so that the next batch fills up while the current one is processed
+class RequestQueue
+{
+public:
+    RequestQueue(std::istream& in, std::uint64_t max_request_bytes);
+    ~RequestQueue();
+
+    // Wait for at least one request, and take up to max_requests of them. Return false once the input stream is closed and all the
+    // requests were taken, after passing the error of the stream, if any, to err_handler.
+    bool pop(std::vector<Request>& requests, std::size_t max_requests, const stdutils::io::ErrorHandler& err_handler);
+
+private:
+    void receive(std::istream& in, std::uint64_t max_request_bytes);
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Request> m_requests;
+    bool m_closed;
+    std::string m_error;
+    std::thread m_thread;
+};
+
+RequestQueue::RequestQueue(std::istream& in, std::uint64_t max_request_bytes)
+    : m_mutex()
+    , m_cv()
+    , m_requests()
+    , m_closed(false)
+    , m_error()
+    , m_thread()
+{
+    m_thread = std::thread([this, &in, max_request_bytes]() { receive(in, max_request_bytes); });
+}
+
+RequestQueue::~RequestQueue()
+{
+    m_thread.join();
+}
+
+void RequestQueue::receive(std::istream& in, std::uint64_t max_request_bytes)
+{
+    std::size_t id = 0;
+    std::string error;
+    try
+    {
+        Request request;
+        while (read_frame(in, max_request_bytes, request.payload, error))
+        {
+            request.id = id++;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_requests.emplace_back(std::move(request));
+            }
+            m_cv.notify_one();
+            request = Request();
+        }
+    }
+    catch (const std::exception& e)
+    {
+        error = std::string("While receiving the requests: ") + e.what();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_error = std::move(error);
+    }
+    m_cv.notify_one();
+}
+
+bool RequestQueue::pop(std::vector<Request>& requests, std::size_t max_requests, const stdutils::io::ErrorHandler& err_handler)
+{
+    assert(max_requests > 0);
+    requests.clear();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return !m_requests.empty() || m_closed; });
+    while (!m_requests.empty() && requests.size() < max_requests)
+    {
+        requests.emplace_back(std::move(m_requests.front()));
+        m_requests.pop_front();
+    }
+    if (requests.empty() && !m_error.empty())
+    {
+        err_handler(stdutils::io::Severity::ERR, m_error);
+        m_error.clear();
+    }
+    return !requests.empty();
+}
+
+// An instance of the algorithm, and its arena, reused from one request to the next
+struct Worker
+{
+    stdutils::io::ErrorLog log;
+    stdutils::Arena arena;
+    std::unique_ptr<Algo> algo;
+};
+
+// The workers are taken by the tasks of a batch and given back once the triangulation is done. They are created on demand, therefore
+// there are as many as the maximum number of concurrent tasks.
+class WorkerPool
+{
+public:
+    WorkerPool(const delaunay::RegisteredImpl<scalar, std::uint32_t>& registered_impl, bool arena);
+
+    std::unique_ptr<Worker> acquire();
+    void release(std::unique_ptr<Worker>&& worker);
+
+private:
+    const delaunay::RegisteredImpl<scalar, std::uint32_t>& m_registered_impl;
+    const bool m_arena;
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<Worker>> m_idle_workers;
+};
+
+WorkerPool::WorkerPool(const delaunay::RegisteredImpl<scalar, std::uint32_t>& registered_impl, bool arena)
+    : m_registered_impl(registered_impl)
+    , m_arena(arena)
+    , m_mutex()
+    , m_idle_workers()
+{ }
+
+std::unique_ptr<Worker> WorkerPool::acquire()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_idle_workers.empty())
+        {
+            auto worker = std::move(m_idle_workers.back());
+            m_idle_workers.pop_back();
+            return worker;
+        }
+    }
+    auto worker = std::make_unique<Worker>();
+    const auto algo_err_handler = worker->log.handler();
+    worker->algo = delaunay::get_impl(m_registered_impl, &algo_err_handler);
+    assert(worker->algo);
+    if (m_arena) { worker->algo->set_arena(&worker->arena); }
+    return worker;
+}
+
+void WorkerPool::release(std::unique_ptr<Worker>&& worker)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_idle_workers.emplace_back(std::move(worker));
+}
+
+// The workers of a NUMA node, and the threads pinned to its CPUs which run them
+struct NumaNodeWorkers
+{
+    std::unique_ptr<WorkerPool> worker_pool;
+    std::unique_ptr<stdutils::parallel::ThreadPool> thread_pool;       // Joined before the workers are destroyed
+};
+
+std::vector<NumaNodeWorkers> make_numa_node_workers(const delaunay::RegisteredImpl<scalar, std::uint32_t>& registered_impl, bool arena, unsigned int nb_threads)
+{
+    const auto nodes = stdutils::platform::numa_nodes();
+    std::size_t nb_cpus = 0;
+    for (const auto& node : nodes) { nb_cpus += node.cpus.size(); }
+    const std::size_t total_threads = nb_threads == 0 ? nb_cpus : nb_threads;
+    std::vector<NumaNodeWorkers> result;
+    result.reserve(nodes.size());
+    for (const auto& node : nodes)
+    {
+        const std::size_t node_threads = std::max(total_threads * node.cpus.size() / nb_cpus, std::size_t{1});
+        auto& node_workers = result.emplace_back();
+        node_workers.worker_pool = std::make_unique<WorkerPool>(registered_impl, arena);
+        node_workers.thread_pool = std::make_unique<stdutils::parallel::ThreadPool>(static_cast<unsigned int>(node_threads), node.cpus);
+    }
+    return result;
+}
+
+// Same contract as stdutils::parallel::for_each_ordered(), with func(node_idx, idx) run by the threads of all the nodes. The calling thread
+// only waits, so that no task runs on a thread that is not pinned.
+template <typename Func, typename OnDone>
+void for_each_ordered_on_nodes(std::vector<NumaNodeWorkers>& nodes, std::size_t n, Func func, OnDone on_done)
+{
+    enum TaskStatus : char { PENDING = 0, DONE, SKIPPED };
+    std::atomic<std::size_t> next_idx{0};
+    std::atomic<bool> stop{false};
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<TaskStatus> status(n, PENDING);                         // Guarded by the mutex
+    std::vector<std::exception_ptr> exceptions(n);
+    const auto node_worker = [&](std::size_t node_idx) {
+        for (std::size_t idx = next_idx++; idx < n; idx = next_idx++)
+        {
+            const bool skip = stop;
+            if (!skip)
+            {
+                try
+                {
+                    func(node_idx, idx);
+                }
+                catch (...)
+                {
+                    exceptions[idx] = std::current_exception();
+                    stop = true;
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                status[idx] = skip ? SKIPPED : DONE;
+            }
+            cv.notify_one();
+        }
+    };
+    std::vector<std::unique_ptr<stdutils::parallel::TaskGroup>> groups;
+    groups.reserve(nodes.size());
+    for (std::size_t node_idx = 0; node_idx < nodes.size(); node_idx++)
+    {
+        auto& group = groups.emplace_back(std::make_unique<stdutils::parallel::TaskGroup>(*nodes[node_idx].thread_pool));
+        for (unsigned int k = 0; k < nodes[node_idx].thread_pool->nb_workers(); k++) { group->run([&node_worker, node_idx]() { node_worker(node_idx); }); }
+    }
+
+    std::exception_ptr first_exception;
+    for (std::size_t idx = 0; idx < n && !first_exception; idx++)
+    {
+        TaskStatus idx_status = PENDING;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&status, idx]() { return status[idx] != PENDING; });
+            idx_status = status[idx];
+        }
+        if (idx_status == SKIPPED) { break; }
+        if (exceptions[idx]) { first_exception = exceptions[idx]; break; }
+        try
+        {
+            on_done(idx);
+        }
+        catch (...)
+        {
+            first_exception = std::current_exception();
+            stop = true;
+        }
+    }
+    for (auto& group : groups) { group->wait(); }
+    if (!first_exception)
+    {
+        const auto it = std::find_if(exceptions.cbegin(), exceptions.cend(), [](const auto& e) { return static_cast<bool>(e); });
+        if (it != exceptions.cend()) { first_exception = *it; }
+    }
+    if (first_exception) { std::rethrow_exception(first_exception); }
+}
+
+struct Job
+{
+    stdutils::io::ErrorLog log;
+    std::string response;
+    bool success{false};
+};
+
+shapes::Triangles2d<scalar> triangulate(Worker& worker, const TriangulationInput& input, const RunSettings& settings)
+{
+    auto& algo = *worker.algo;
+    algo.clear();
+    setup_triangulation(algo, input);
+    shapes::Triangles2d<scalar> result;
+    if (settings.timeout_ms > 0)
+    {
+        const delaunay::CancellationToken token(std::chrono::milliseconds(settings.timeout_ms));
+        result = algo.triangulate(settings.policy, &token);
+    }
+    else
+    {
+        result = algo.triangulate(settings.policy);
+    }
+    if (settings.arena) { worker.arena.reset(); }
+    return result;
+}
+
+void process_request(Request& request, WorkerPool& worker_pool, const std::string& algo_name, const RunSettings& settings, Job& job)
+{
+    const auto job_err_handler = job.log.handler();
+    shapes::io::ShapeAggregate<scalar> response;
+    try
+    {
+        const TriangulationInput original_input = parse_input_buffer("Request " + std::to_string(request.id), request.payload, job_err_handler);
+        request.payload = std::string();
+        if (original_input.shapes.empty())
+        {
+            job_err_handler(stdutils::io::Severity::ERR, original_input.name + ": No input shapes");
+        }
+        else
+        {
+            const std::optional<TriangulationInput> prepared_input = prepare_input(original_input, settings);
+            const TriangulationInput& input = prepared_input.has_value() ? *prepared_input : original_input;
+            auto worker = worker_pool.acquire();
+            auto triangulation = triangulate(*worker, input, settings);
+            worker->log.forward(job_err_handler);
+            worker->log.clear();
+            worker_pool.release(std::move(worker));
+            if (triangulation.faces.empty())
+            {
+                job_err_handler(stdutils::io::Severity::ERR, input.name + ": The triangulation failed");
+            }
+            else
+            {
+                response.emplace_back(std::move(triangulation), algo_name);
+                job.success = true;
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream out;
+        out << "Request " << request.id << ": " << e.what();
+        job_err_handler(stdutils::io::Severity::EXCPT, out.str());
+        response.clear();
+        job.success = false;
+    }
+    std::ostringstream out;
+    shapes::io::shb::save_shapes_as_stream(out, response, job_err_handler);
+    job.response = std::move(out).str();
+}
+
+} // namespace
+
+ServerStats serve(std::istream& in, std::ostream& out, const delaunay::RegisteredImpl<scalar, std::uint32_t>& registered_impl, const RunSettings& settings, const ServerSettings& server_settings, const stdutils::io::ErrorHandler& err_handler)
+{
+    ServerStats stats;
+    WorkerPool worker_pool(registered_impl, settings.arena);
+    std::vector<NumaNodeWorkers> numa_node_workers;
+    if (server_settings.numa)
+    {
+        numa_node_workers = make_numa_node_workers(registered_impl, settings.arena, server_settings.parallel_policy.nb_threads);
+        std::stringstream msg;
+        msg << "Thread pools pinned to " << numa_node_workers.size() << " NUMA node(s)";
+        err_handler(stdutils::io::Severity::TRACE, msg.str());
+    }
+    RequestQueue request_queue(in, server_settings.max_request_bytes);
+    const std::size_t max_batch_size = std::max(server_settings.max_batch_size, std::size_t{1});
+    std::vector<Request> requests;
+    bool output_closed = false;
+    while (request_queue.pop(requests, max_batch_size, err_handler))
+    {
+        stats.nb_batches++;
+        if (output_closed)
+        {
+            // Drain the input, so that the receiving thread can complete
+            stats.nb_requests += requests.size();
+            stats.nb_failures += requests.size();
+            continue;
+        }
+        std::vector<Job> jobs(requests.size());
+        try
+        {
+            const auto on_done = [&](std::size_t idx) {
+                auto& job = jobs[idx];
+                job.log.forward(err_handler);
+                job.log.clear();
+                stats.nb_requests++;
+                if (!job.success) { stats.nb_failures++; }
+                if (output_closed) { return; }
+                write_frame(out, job.response);
+                job.response = std::string();
+                if (!out)
+                {
+                    err_handler(stdutils::io::Severity::ERR, "The output stream is closed");
+                    output_closed = true;
+                }
+            };
+            if (numa_node_workers.empty())
+            {
+                stdutils::parallel::for_each_ordered(server_settings.parallel_policy, requests.size(), [&](std::size_t idx) {
+                    process_request(requests[idx], worker_pool, registered_impl.name, settings, jobs[idx]);
+                }, on_done);
+            }
+            else
+            {
+                for_each_ordered_on_nodes(numa_node_workers, requests.size(), [&](std::size_t node_idx, std::size_t idx) {
+                    process_request(requests[idx], *numa_node_workers[node_idx].worker_pool, registered_impl.name, settings, jobs[idx]);
+                }, on_done);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::stringstream msg;
+            msg << "batch::serve: " << e.what();
+            err_handler(stdutils::io::Severity::EXCPT, msg.str());
+            output_closed = true;
+        }
+        std::stringstream msg;
+        msg << "Batch " << stats.nb_batches << ": " << requests.size() << " requests";
+        err_handler(stdutils::io::Severity::TRACE, msg.str());
+    }
+    return stats;
+}
+
+} // namespace batch
@@ -0,0 +1,57 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include "batch_input.h"
+#include "batch_runner.h"
+
+#include <dt/dt_impl.h>
+#include <stdutils/io.h>
+#include <stdutils/parallel.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+namespace batch {
+
+/**
+ * Triangulation service
+ *
+ * The requests are read from an input stream and the responses are written to an output stream, e.g. the standard input and output of a
+ * process attached to a socket by inetd, systemd or socat. Each message is a frame: Its length in bytes (uint64, little-endian) followed
+ * by an SHB buffer. A request holds the input shapes, with the same conventions as the input files. Its response holds the triangulation,
+ * one Triangles2d whose description is the name of the algorithm, or no shape if the request failed. The responses are in the order of the
+ * requests.
+ *
+ * The requests received while a batch is processed are triangulated together in the next one, each worker of the thread pool reusing an
+ * instance of the algorithm (and its arena) from one request to the next. The response of a request is written and flushed as soon as it,
+ * and the ones before it, are complete.
+ *
+ * With numa, there is one thread pool per NUMA node, its threads pinned to the CPUs of the node, and the requests of a batch are taken by
+ * the threads of all the nodes. The instances of the algorithm, their arenas and the responses are allocated, and first touched, by the
+ * pinned threads, therefore their memory is local to the node that uses it. The number of threads of the policy (all the CPUs if zero) is
+ * shared between the nodes in proportion to their number of CPUs, at least one thread each. This is only effective on Linux: On the
+ * other platforms there is one unpinned pool.
+ */
+struct ServerSettings
+{
+    std::size_t max_batch_size{256};                        // Number of requests
+    std::uint64_t max_request_bytes{std::uint64_t{1} << 30};
+    stdutils::parallel::Policy parallel_policy{ 0, 1 };
+    bool numa{false};
+};
+
+struct ServerStats
+{
+    std::size_t nb_requests{0};
+    std::size_t nb_failures{0};                             // Requests answered without a triangulation
+    std::size_t nb_batches{0};
+};
+
+// Serve the requests until the end of the input stream. The triangulation settings are those of the batch runs (policy, timeout, arena,
+// Bezier flatness and path simplification), the other ones are ignored.
+ServerStats serve(std::istream& in, std::ostream& out, const delaunay::RegisteredImpl<scalar, std::uint32_t>& registered_impl, const RunSettings& settings, const ServerSettings& server_settings, const stdutils::io::ErrorHandler& err_handler);
+
+} // namespace batch
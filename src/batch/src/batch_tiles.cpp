@@ -0,0 +1,321 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include "batch_tiles.h"
+
+#include <dt/deduplication.h>
+#include <dt/dt_interface.h>
+#include <shapes/shapes.h>
+#include <stdutils/span.h>
+#include <stdutils/visit.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <utility>
+#include <variant>
+
+namespace batch {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr std::string_view CORE_DESCR = "core";
+constexpr std::string_view HALO_DESCR = "halo";
+
+// The vertices of the 2D shapes, once the Bezier paths are sampled. The triangles are skipped.
+void append_vertices(const TriangulationInput& original_input, const RunSettings& settings, shapes::Points2d<scalar>& points)
+{
+    const std::optional<TriangulationInput> prepared_input = prepare_input(original_input, settings);
+    const TriangulationInput& input = prepared_input.has_value() ? *prepared_input : original_input;
+    for (const auto& shape_wrapper : input.shapes)
+    {
+        std::visit(stdutils::Overloaded {
+            [&points](const shapes::PointCloud2d<scalar>& pc) { points.insert(points.end(), pc.vertices.cbegin(), pc.vertices.cend()); },
+            [&points](const shapes::PointPath2d<scalar>& pp) { points.insert(points.end(), pp.vertices.cbegin(), pp.vertices.cend()); },
+            [&points](const shapes::Edges2d<scalar>& edges) { points.insert(points.end(), edges.vertices.cbegin(), edges.vertices.cend()); },
+            [](const auto&) { /* Skip */ }
+        }, shape_wrapper.shape);
+    }
+}
+
+const shapes::Points2d<scalar>* find_point_cloud(const TriangulationInput& input, std::string_view descr)
+{
+    for (const auto& shape_wrapper : input.shapes)
+    {
+        const auto* pc = std::get_if<shapes::PointCloud2d<scalar>>(&shape_wrapper.shape);
+        if (pc != nullptr && shape_wrapper.descr == descr) { return &pc->vertices; }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TileManifest parse_tile_manifest(std::istream& in, const stdutils::io::ErrorHandler& err_handler)
+{
+    TileManifest result;
+    bool has_layout = false;
+    auto linestream = stdutils::io::SkipLineStream(in).skip_blank_lines().skip_comment_lines("#");
+    std::string line;
+    std::size_t line_nb = 0;
+    const auto error = [&err_handler, &line_nb](std::string_view msg) {
+        std::stringstream out;
+        out << "Tile manifest: " << msg << " on line " << line_nb;
+        err_handler(stdutils::io::Severity::ERR, out.str());
+    };
+    while (linestream.getline(line, line_nb))
+    {
+        std::istringstream iss(line);
+        std::string keyword;
+        iss >> keyword;
+        if (keyword == "layout")
+        {
+            scalar min_x, min_y, max_x, max_y;
+            auto& layout = result.layout;
+            iss >> min_x >> min_y >> max_x >> max_y >> layout.nb_columns >> layout.nb_rows >> layout.halo;
+            if (iss.fail() || has_layout || min_x > max_x || min_y > max_y || layout.nb_columns == 0 || layout.nb_rows == 0)
+            {
+                error("Invalid layout");
+                return TileManifest();
+            }
+            layout.bounding_box = shapes::BoundingBox2d<scalar>().add(min_x, min_y).add(max_x, max_y);
+            has_layout = true;
+        }
+        else if (keyword == "tile")
+        {
+            std::size_t tile_idx = 0;
+            TileManifest::Tile tile;
+            iss >> tile_idx >> tile.nb_core_points >> tile.nb_halo_points >> tile.input >> tile.output;
+            if (iss.fail() || tile_idx != result.tiles.size())
+            {
+                error("Invalid tile");
+                return TileManifest();
+            }
+            result.tiles.emplace_back(std::move(tile));
+        }
+        else
+        {
+            error("Unknown keyword " + keyword);
+            return TileManifest();
+        }
+    }
+    if (!has_layout || result.tiles.size() != result.layout.nb_tiles())
+    {
+        err_handler(stdutils::io::Severity::ERR, "Tile manifest: The layout does not match the tiles");
+        return TileManifest();
+    }
+    return result;
+}
+
+void write_tile_manifest(std::ostream& out, const TileManifest& manifest)
+{
+    const auto& layout = manifest.layout;
+    const auto min = layout.bounding_box.min();
+    const auto max = layout.bounding_box.max();
+    const auto precision = out.precision(std::numeric_limits<scalar>::max_digits10);
+    out << "# Delaunay tile manifest\n";
+    out << "# layout <min_x> <min_y> <max_x> <max_y> <nb_columns> <nb_rows> <halo>\n";
+    out << "layout " << min.x << ' ' << min.y << ' ' << max.x << ' ' << max.y << ' ' << layout.nb_columns << ' ' << layout.nb_rows << ' ' << layout.halo << '\n';
+    out << "# tile <tile_idx> <nb_core_points> <nb_halo_points> <input file> <output file>\n";
+    for (std::size_t tile_idx = 0; tile_idx < manifest.tiles.size(); tile_idx++)
+    {
+        const auto& tile = manifest.tiles[tile_idx];
+        out << "tile " << tile_idx << ' ' << tile.nb_core_points << ' ' << tile.nb_halo_points << ' ' << tile.input << ' ' << tile.output << '\n';
+    }
+    out.precision(precision);
+}
+
+TileManifest load_tile_manifest(const std::filesystem::path& filepath, const stdutils::io::ErrorHandler& err_handler)
+{
+    std::ifstream in(filepath);
+    if (!in)
+    {
+        err_handler(stdutils::io::Severity::ERR, "Cannot open the tile manifest " + filepath.string());
+        return TileManifest();
+    }
+    return parse_tile_manifest(in, err_handler);
+}
+
+bool plan_tiles(const std::vector<TriangulationInput>& inputs, const std::filesystem::path& folder, const TilingSettings& tiling_settings, const RunSettings& settings, const stdutils::parallel::Policy& parallel_policy, const stdutils::io::ErrorHandler& err_handler)
+{
+    shapes::Points2d<scalar> all_points;
+    for (const auto& input : inputs) { append_vertices(input, settings, all_points); }
+    if (all_points.size() < 3)
+    {
+        err_handler(stdutils::io::Severity::ERR, "Not enough input vertices to plan the tiles");
+        return false;
+    }
+    const auto points = delaunay::deduplicate_points<scalar, std::uint32_t>(parallel_policy, stdutils::make_const_span(all_points)).points;
+    all_points = shapes::Points2d<scalar>();
+    shapes::BoundingBox2d<scalar> bounding_box;
+    for (const auto& p : points) { bounding_box.add(p); }
+
+    std::error_code ec;
+    fs::create_directories(folder, ec);
+    if (ec)
+    {
+        err_handler(stdutils::io::Severity::ERR, "Cannot create the folder " + folder.string() + ": " + ec.message());
+        return false;
+    }
+
+    TileManifest manifest;
+    manifest.layout = delaunay::make_tile_layout(bounding_box, tiling_settings.nb_columns, tiling_settings.nb_rows, static_cast<scalar>(tiling_settings.halo_ratio));
+    auto tile_points = delaunay::split_in_tiles(manifest.layout, points);
+    manifest.tiles.resize(tile_points.size());
+    std::vector<stdutils::io::ErrorLog> tile_logs(tile_points.size());
+    stdutils::parallel::for_each_dynamic(parallel_policy, tile_points.size(), [&](std::size_t, std::size_t tile_idx) {
+        auto& tile = manifest.tiles[tile_idx];
+        tile.nb_core_points = tile_points[tile_idx].core.size();
+        tile.nb_halo_points = tile_points[tile_idx].halo.size();
+        tile.input = "tile_" + std::to_string(tile_idx) + std::string(shapes::io::shb::FILE_EXTENSION);
+        tile.output = "tile_" + std::to_string(tile_idx) + ".triangles" + std::string(shapes::io::shb::FILE_EXTENSION);
+        shapes::io::ShapeAggregate<scalar> tile_shapes;
+        shapes::PointCloud2d<scalar> core;
+        core.vertices = std::move(tile_points[tile_idx].core);
+        tile_shapes.emplace_back(std::move(core), std::string(CORE_DESCR));
+        shapes::PointCloud2d<scalar> halo;
+        halo.vertices = std::move(tile_points[tile_idx].halo);
+        tile_shapes.emplace_back(std::move(halo), std::string(HALO_DESCR));
+        shapes::io::shb::save_shapes_as_file(folder / tile.input, tile_shapes, tile_logs[tile_idx].handler());
+    });
+    for (auto& log : tile_logs) { log.forward(err_handler); }
+    const stdutils::io::StreamWriter<TileManifest, char> writer = [](std::ostream& out, const TileManifest& obj, const stdutils::io::ErrorHandler&) {
+        write_tile_manifest(out, obj);
+    };
+    stdutils::io::save_txt_file(folder / TILE_MANIFEST_FILENAME, writer, manifest, err_handler);
+
+    std::stringstream out;
+    out << "Planned " << manifest.tiles.size() << " tiles of " << points.size() << " points, with a halo of " << manifest.layout.halo;
+    err_handler(stdutils::io::Severity::INFO, out.str());
+    return true;
+}
+
+std::size_t run_tiles(const std::filesystem::path& manifest_path, const std::vector<std::size_t>& tile_indices, const delaunay::RegisteredImpl<scalar, std::uint32_t>& registered_impl, const RunSettings& settings, const stdutils::parallel::Policy& parallel_policy, const stdutils::io::ErrorHandler& err_handler)
+{
+    const auto manifest = load_tile_manifest(manifest_path, err_handler);
+    if (manifest.tiles.empty())
+        return std::max(tile_indices.size(), std::size_t{1});
+    std::vector<std::size_t> selected_tiles = tile_indices;
+    if (selected_tiles.empty())
+    {
+        selected_tiles.resize(manifest.tiles.size());
+        for (std::size_t idx = 0; idx < selected_tiles.size(); idx++) { selected_tiles[idx] = idx; }
+    }
+    const fs::path folder = manifest_path.parent_path();
+
+    // One instance of the algorithm per worker. The messages of each tile are forwarded in order, once it is done.
+    const std::size_t nb_workers = stdutils::parallel::nb_workers(parallel_policy, selected_tiles.size());
+    std::vector<stdutils::io::ErrorLog> worker_logs(nb_workers);
+    std::vector<std::unique_ptr<delaunay::Interface<scalar, std::uint32_t>>> algos(nb_workers);
+    std::vector<stdutils::io::ErrorLog> tile_logs(selected_tiles.size());
+    std::vector<char> failures(selected_tiles.size(), 0);
+    stdutils::parallel::for_each_dynamic(parallel_policy, selected_tiles.size(), [&](std::size_t worker_idx, std::size_t idx) {
+        const std::size_t tile_idx = selected_tiles[idx];
+        const auto tile_err_handler = tile_logs[idx].handler();
+        const std::string tile_name = "Tile " + std::to_string(tile_idx);
+        if (tile_idx >= manifest.tiles.size())
+        {
+            tile_err_handler(stdutils::io::Severity::ERR, tile_name + ": Not in the manifest");
+            failures[idx] = 1;
+            return;
+        }
+        const auto& tile = manifest.tiles[tile_idx];
+        if (tile.nb_core_points + tile.nb_halo_points < 3)
+        {
+            // Nothing to triangulate: An empty output, so that the merge does not report a missing tile
+            shapes::io::shb::save_shapes_as_file(folder / tile.output, shapes::io::ShapeAggregate<scalar>(), tile_err_handler);
+            return;
+        }
+        const TriangulationInput input = load_input_file(folder / tile.input, tile_err_handler);
+        if (!algos[worker_idx])
+        {
+            const auto algo_err_handler = worker_logs[worker_idx].handler();
+            algos[worker_idx] = delaunay::get_impl(registered_impl, &algo_err_handler);
+            assert(algos[worker_idx]);
+        }
+        auto& algo = *algos[worker_idx];
+        algo.clear();
+        setup_triangulation(algo, input);
+        shapes::Triangles2d<scalar> triangles;
+        if (settings.timeout_ms > 0)
+        {
+            const delaunay::CancellationToken token(std::chrono::milliseconds(settings.timeout_ms));
+            triangles = algo.triangulate(delaunay::TriangulationPolicy::PointCloud, &token);
+        }
+        else
+        {
+            triangles = algo.triangulate(delaunay::TriangulationPolicy::PointCloud);
+        }
+        worker_logs[worker_idx].forward(tile_err_handler);
+        worker_logs[worker_idx].clear();
+        if (triangles.faces.empty())
+        {
+            tile_err_handler(stdutils::io::Severity::ERR, tile_name + ": The triangulation failed");
+            failures[idx] = 1;
+            return;
+        }
+        std::stringstream out;
+        out << tile_name << ": " << triangles.faces.size() << " triangles";
+        tile_err_handler(stdutils::io::Severity::INFO, out.str());
+        shapes::io::ShapeAggregate<scalar> result;
+        result.emplace_back(std::move(triangles), registered_impl.name);
+        shapes::io::shb::save_shapes_as_file(folder / tile.output, result, tile_err_handler);
+    });
+    for (auto& log : tile_logs) { log.forward(err_handler); }
+    return static_cast<std::size_t>(std::count(failures.cbegin(), failures.cend(), 1));
+}
+
+delaunay::TileMerge<scalar, std::uint32_t> merge_tiles(const std::filesystem::path& manifest_path, const delaunay::RegisteredImpl<scalar, std::uint32_t>& registered_impl, const stdutils::parallel::Policy& parallel_policy, const stdutils::io::ErrorHandler& err_handler)
+{
+    const auto manifest = load_tile_manifest(manifest_path, err_handler);
+    if (manifest.tiles.empty())
+        return delaunay::TileMerge<scalar, std::uint32_t>();
+    const fs::path folder = manifest_path.parent_path();
+
+    // All the points are the core points of the tiles
+    const std::size_t nb_tiles = manifest.tiles.size();
+    std::vector<shapes::Points2d<scalar>> core_points(nb_tiles);
+    std::vector<shapes::Triangles2d<scalar>> tile_triangulations(nb_tiles);
+    std::vector<stdutils::io::ErrorLog> tile_logs(nb_tiles);
+    stdutils::parallel::for_each_dynamic(parallel_policy, nb_tiles, [&](std::size_t, std::size_t tile_idx) {
+        const auto& tile = manifest.tiles[tile_idx];
+        const auto tile_err_handler = tile_logs[tile_idx].handler();
+        const std::string tile_name = "Tile " + std::to_string(tile_idx);
+        const TriangulationInput input = load_input_file(folder / tile.input, tile_err_handler);
+        const auto* core = find_point_cloud(input, CORE_DESCR);
+        if (core == nullptr || core->size() != tile.nb_core_points)
+        {
+            tile_err_handler(stdutils::io::Severity::ERR, tile_name + ": The core points do not match the manifest");
+            return;
+        }
+        core_points[tile_idx] = *core;
+        std::error_code ec;
+        if (!fs::exists(folder / tile.output, ec))
+        {
+            tile_err_handler(stdutils::io::Severity::WARN, tile_name + ": No triangulation, the tile is filled like a seam");
+            return;
+        }
+        for (auto& shape_wrapper : shapes::io::shb::parse_shapes_from_file(folder / tile.output, tile_err_handler))
+        {
+            if (auto* triangles = std::get_if<shapes::Triangles2d<scalar>>(&shape_wrapper.shape)) { tile_triangulations[tile_idx] = std::move(*triangles); break; }
+        }
+    });
+    for (auto& log : tile_logs) { log.forward(err_handler); }
+
+    shapes::Points2d<scalar> points;
+    for (auto& core : core_points) { points.insert(points.end(), core.cbegin(), core.cend()); core = shapes::Points2d<scalar>(); }
+    auto result = delaunay::merge_tiles(registered_impl, manifest.layout, points, tile_triangulations, err_handler, parallel_policy);
+
+    std::stringstream out;
+    out << "Merged " << nb_tiles << " tiles: " << result.triangles.faces.size() << " triangles, of which " << result.nb_seam_faces << " along the seams ("
+        << result.nb_seam_vertices << " seam vertices, " << result.nb_rejected_faces << " of " << result.nb_checked_faces << " checked faces rejected)";
+    err_handler(stdutils::io::Severity::INFO, out.str());
+    return result;
+}
+
+} // namespace batch
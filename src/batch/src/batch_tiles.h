@@ -0,0 +1,79 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include "batch_input.h"
+#include "batch_runner.h"
+
+#include <dt/dt_impl.h>
+#include <dt/tiling.h>
+#include <stdutils/io.h>
+#include <stdutils/parallel.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace batch {
+
+/**
+ * Tiled triangulation of a large point cloud, on separate machines (see dt/tiling.h)
+ *
+ *  1. plan_tiles() splits the vertices of the inputs in tiles, and writes one SHB input file per tile along with a manifest
+ *  2. run_tiles() triangulates some or all of the tiles of the manifest, e.g. one subset per machine, and writes their triangulations next to
+ *     the input files. The folder of the manifest is typically a shared file system.
+ *  3. merge_tiles() stitches the triangulations of the tiles, fixes the seams, and returns the Delaunay triangulation of all the points
+ *
+ * The paths and edges of the inputs are only sampled for their vertices: The tiled triangulation is a point cloud triangulation.
+ */
+struct TileManifest
+{
+    struct Tile
+    {
+        std::size_t nb_core_points{0};
+        std::size_t nb_halo_points{0};
+        std::string input;                          // SHB file, relative to the folder of the manifest: A point cloud "core" and a point cloud "halo"
+        std::string output;                         // SHB file, relative to the folder of the manifest: The triangulation of the tile
+    };
+    delaunay::TileLayout<scalar> layout;
+    std::vector<Tile> tiles;                        // In the order of the tile indices of the layout
+};
+
+constexpr std::string_view TILE_MANIFEST_FILENAME = "manifest.txt";
+
+/**
+ * Text format:
+ *
+ *   layout <min_x> <min_y> <max_x> <max_y> <nb_columns> <nb_rows> <halo>
+ *   tile <tile_idx> <nb_core_points> <nb_halo_points> <input file> <output file>
+ *
+ * With one tile line per tile, in order. The lines starting with '#' are comments.
+ */
+TileManifest parse_tile_manifest(std::istream& in, const stdutils::io::ErrorHandler& err_handler);
+void write_tile_manifest(std::ostream& out, const TileManifest& manifest);
+
+// Return an empty manifest (without tiles) on error
+TileManifest load_tile_manifest(const std::filesystem::path& filepath, const stdutils::io::ErrorHandler& err_handler);
+
+struct TilingSettings
+{
+    unsigned int nb_columns{4};
+    unsigned int nb_rows{4};
+    float halo_ratio{0.25f};                        // Width of the halo, relative to the smaller side of a tile
+};
+
+// Write the tile inputs and the manifest in folder. The duplicated vertices are merged. Return false on error.
+bool plan_tiles(const std::vector<TriangulationInput>& inputs, const std::filesystem::path& folder, const TilingSettings& tiling_settings, const RunSettings& settings, const stdutils::parallel::Policy& parallel_policy, const stdutils::io::ErrorHandler& err_handler);
+
+// Triangulate the selected tiles of the manifest (all of them if tile_indices is empty), concurrently. Return the number of failures.
+std::size_t run_tiles(const std::filesystem::path& manifest_path, const std::vector<std::size_t>& tile_indices, const delaunay::RegisteredImpl<scalar, std::uint32_t>& registered_impl, const RunSettings& settings, const stdutils::parallel::Policy& parallel_policy, const stdutils::io::ErrorHandler& err_handler);
+
+// Merge the triangulations of the tiles of the manifest. A missing tile triangulation is reported and filled like a seam.
+delaunay::TileMerge<scalar, std::uint32_t> merge_tiles(const std::filesystem::path& manifest_path, const delaunay::RegisteredImpl<scalar, std::uint32_t>& registered_impl, const stdutils::parallel::Policy& parallel_policy, const stdutils::io::ErrorHandler& err_handler);
+
+} // namespace batch
@@ -0,0 +1,441 @@
+/*******************************************************************************
+ * DELAUNAY BATCH
+ *
+ * Headless triangulation of input files with all the registered Delaunay
+ * implementations, and report of the timings.
+ *
+ * Copyright (c) 2023 Pierre DEJOUE
+ * This code is distributed under the terms of the MIT License
+ ******************************************************************************/
+
+#include "batch_input.h"
+#include "batch_report.h"
+#include "batch_runner.h"
+#include "batch_server.h"
+#include "batch_tiles.h"
+
+#ifdef _MSC_VER
+#pragma warning( push )
+#pragma warning( disable : 28020 )               // Warning C28020: The expression 'expr' is not true at this call
+#endif
+#include <argagg/argagg.hpp>
+#ifdef _MSC_VER
+#pragma warning( pop )
+#endif
+
+#include <dt/auto_select.h>
+#include <dt/dt_impl.h>
+#include <shapes/io.h>
+#include <stdutils/io.h>
+#include <stdutils/parallel.h>
+#include <stdutils/platform.h>
+#include <stdutils/profiler.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace {
+
+bool g_any_error = false;
+
+bool g_verbose = false;
+
+void err_callback(stdutils::io::SeverityCode sev, std::string_view msg)
+{
+    if (sev <= stdutils::io::Severity::ERR) { g_any_error = true; }
+    if (sev >= stdutils::io::Severity::TRACE && !g_verbose) { return; }
+    std::cerr << stdutils::io::str_severity_code(sev) << ": " << msg << std::endl;
+}
+
+argagg::parser argparser{ {
+    { "help", { "-h", "--help" }, "Print usage note and exit", 0 },
+    { "platform", { "--platform" }, "Print platform information and exit", 0 },
+    { "list", { "-l", "--list" }, "List the registered Delaunay implementations and exit", 0 },
+    { "algo", { "-a", "--algo" }, "Only run the named implementation, or 'auto' for the one selected for each input. Can be repeated. (Default: all)", 1 },
+    { "selection_profile", { "--selection-profile" }, "Load the profile of the 'auto' selection from a file", 1 },
+    { "save_selection_profile", { "--save-selection-profile" }, "Save the median durations of the runs to a file, as the profile of the 'auto' selection", 1 },
+    { "policy", { "-p", "--policy" }, "Triangulation policy: 'pc' (point cloud) or 'cdt' (constrained). (Default: cdt)", 1 },
+    { "runs", { "-n", "--runs" }, "Number of runs for each implementation. (Default: 10)", 1 },
+    { "format", { "-f", "--format" }, "Output format: 'csv' or 'json'. (Default: csv)", 1 },
+    { "output", { "-o", "--output" }, "Output file. (Default: stdout)", 1 },
+    { "concurrent", { "-c", "--concurrent" }, "Run the selected implementations concurrently, one thread each. Each one is timed independently", 0 },
+    { "timeout", { "-t", "--timeout" }, "Timeout of each triangulation in milliseconds. A run that times out is a failure. (Default: none)", 1 },
+    { "bezier_flatness", { "--bezier-flatness" }, "Tolerance of the sampling of the Bezier paths, relative to the diameter of the input. (Default: 0.001)", 1 },
+    { "simplify", { "--simplify" }, "Simplify the point paths within that tolerance, relative to the diameter of the input, preserving their topology. (Default: 0, disabled)", 1 },
+    { "simplify_method", { "--simplify-method" }, "Simplification of the point paths: 'dp' (Douglas-Peucker) or 'vw' (Visvalingam-Whyatt). (Default: dp)", 1 },
+    { "arena", { "--arena" }, "Allocate the transient buffers of each implementation in an arena, reused from one run to the next", 0 },
+    { "serve", { "--serve" }, "Serve the triangulation requests received on stdin, and write the results to stdout, until the end of the input. See the README for the protocol", 0 },
+    { "max_batch", { "--max-batch" }, "With --serve, maximum number of requests triangulated concurrently in one batch. (Default: 256)", 1 },
+    { "numa", { "--numa" }, "With --serve, one thread pool per NUMA node, pinned to its CPUs (Linux only)", 0 },
+    { "plan_tiles", { "--plan-tiles" }, "Split the vertices of the input files in tiles, and write the inputs of the tiles and their manifest to that folder. See the README", 1 },
+    { "tiles", { "--tiles" }, "With --plan-tiles, the grid of tiles: <columns>x<rows>. (Default: 4x4)", 1 },
+    { "halo", { "--halo" }, "With --plan-tiles, the width of the margin of each tile, relative to the tile size. (Default: 0.25)", 1 },
+    { "run_tiles", { "--run-tiles" }, "Triangulate the tiles of a manifest (point cloud policy), and write their triangulations next to it", 1 },
+    { "tile", { "--tile" }, "With --run-tiles, only triangulate that tile. Can be repeated. (Default: all)", 1 },
+    { "merge_tiles", { "--merge-tiles" }, "Merge the triangulations of the tiles of a manifest, fix the seams, and save the result to the output file (SHB)", 1 },
+    { "jobs", { "-j", "--jobs" }, "Number of threads to load the input files, or to triangulate the requests of a batch with --serve. (Default: hardware concurrency)", 1 },
+    { "verbose", { "-v", "--verbose" }, "Print the progress of the file loading", 0 },
+    { "profile", { "--profile" }, "Record the profiler zones and save them to a file in the Chrome trace format. Requires a build with DELAUNAY_VIEWER_PROFILING", 1 }
+} };
+
+void usage_notes(std::ostream& out)
+{
+    out << "Delaunay Batch\n\n";
+    out << "Usage: delaunay_batch [options] <input files (DAT, CDT, SHB or SVG)>\n";
+    out << "       delaunay_batch --serve [options]\n";
+    out << "       delaunay_batch --plan-tiles <folder> [options] <input files>\n";
+    out << "       delaunay_batch --run-tiles <manifest> [--tile <idx>...] [options]\n";
+    out << "       delaunay_batch --merge-tiles <manifest> --output <SHB file> [options]\n\n";
+    out << "Options:\n\n";
+    out << argparser;
+}
+
+argagg::parser_results parse_command_line(int argc, char *argv[])
+{
+    argagg::parser_results args;
+    try
+    {
+        args = argparser.parse(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        usage_notes(std::cerr);
+        std::stringstream out;
+        out << "While parsing arguments: " << e.what();
+        err_callback(stdutils::io::Severity::EXCPT, out.str());
+        std::exit(EXIT_FAILURE);
+    }
+    return args;
+}
+
+bool parse_run_settings(const argagg::parser_results& args, batch::RunSettings& settings, batch::ReportFormat& format, stdutils::parallel::Policy& load_policy)
+{
+    try
+    {
+        const auto policy = args["policy"].as<std::string>("cdt");
+        if (policy == "cdt")     { settings.policy = delaunay::TriangulationPolicy::CDT; }
+        else if (policy == "pc") { settings.policy = delaunay::TriangulationPolicy::PointCloud; }
+        else { err_callback(stdutils::io::Severity::FATAL, "Unknown triangulation policy: " + policy); return false; }
+
+        const int runs = args["runs"].as<int>(10);
+        if (runs <= 0) { err_callback(stdutils::io::Severity::FATAL, "The number of runs must be positive"); return false; }
+        settings.nb_runs = static_cast<unsigned int>(runs);
+
+        for (const auto& algo : args["algo"].all)
+            settings.algo_filter.emplace_back(algo.as<std::string>());
+
+        settings.concurrent = static_cast<bool>(args["concurrent"]);
+        settings.arena = static_cast<bool>(args["arena"]);
+
+        const int timeout_ms = args["timeout"].as<int>(0);
+        if (timeout_ms < 0) { err_callback(stdutils::io::Severity::FATAL, "The timeout must be positive"); return false; }
+        settings.timeout_ms = static_cast<unsigned int>(timeout_ms);
+
+        settings.bezier_flatness = args["bezier_flatness"].as<float>(0.001f);
+        if (settings.bezier_flatness <= 0.f) { err_callback(stdutils::io::Severity::FATAL, "The Bezier flatness must be positive"); return false; }
+
+        settings.path_simplification = args["simplify"].as<float>(0.f);
+        if (settings.path_simplification < 0.f) { err_callback(stdutils::io::Severity::FATAL, "The simplification tolerance must be positive"); return false; }
+        const auto simplify_method = args["simplify_method"].as<std::string>("dp");
+        if (simplify_method == "dp")      { settings.simplification_method = shapes::SimplificationMethod::DouglasPeucker; }
+        else if (simplify_method == "vw") { settings.simplification_method = shapes::SimplificationMethod::VisvalingamWhyatt; }
+        else { err_callback(stdutils::io::Severity::FATAL, "Unknown simplification method: " + simplify_method); return false; }
+
+        const int jobs = args["jobs"].as<int>(0);
+        if (jobs < 0) { err_callback(stdutils::io::Severity::FATAL, "The number of jobs must be positive"); return false; }
+        load_policy.nb_threads = static_cast<unsigned int>(jobs);
+
+        const auto format_str = args["format"].as<std::string>("csv");
+        if (format_str == "csv")       { format = batch::ReportFormat::CSV; }
+        else if (format_str == "json") { format = batch::ReportFormat::JSON; }
+        else { err_callback(stdutils::io::Severity::FATAL, "Unknown output format: " + format_str); return false; }
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream out;
+        out << "While parsing arguments: " << e.what();
+        err_callback(stdutils::io::Severity::EXCPT, out.str());
+        return false;
+    }
+    return true;
+}
+
+// The triangulation service runs a single implementation: The first one of the --algo options, or the reference one
+int serve(const argagg::parser_results& args, const batch::RunSettings& settings, const stdutils::parallel::Policy& parallel_policy, const stdutils::io::ErrorHandler& err_handler)
+{
+    const auto impl_list = delaunay::get_impl_list<batch::scalar>();
+    const std::string algo_name = settings.algo_filter.empty() ? impl_list.reference : settings.algo_filter.front();
+    if (algo_name == "auto")
+    {
+        err_handler(stdutils::io::Severity::FATAL, "The auto selection is not supported with --serve");
+        return EXIT_FAILURE;
+    }
+    const auto algo_it = std::find_if(std::cbegin(impl_list.algos), std::cend(impl_list.algos), [&algo_name](const auto& algo) { return algo.name == algo_name; });
+    assert(algo_it != std::cend(impl_list.algos));
+
+    batch::ServerSettings server_settings;
+    server_settings.parallel_policy.nb_threads = parallel_policy.nb_threads;
+    server_settings.numa = static_cast<bool>(args["numa"]);
+    try
+    {
+        const int max_batch = args["max_batch"].as<int>(static_cast<int>(server_settings.max_batch_size));
+        if (max_batch <= 0) { err_handler(stdutils::io::Severity::FATAL, "The maximum batch size must be positive"); return EXIT_FAILURE; }
+        server_settings.max_batch_size = static_cast<std::size_t>(max_batch);
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream out;
+        out << "While parsing arguments: " << e.what();
+        err_handler(stdutils::io::Severity::EXCPT, out.str());
+        return EXIT_FAILURE;
+    }
+
+    // The requests are read on another thread than the one writing the responses: stdin must not flush stdout
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+    err_handler(stdutils::io::Severity::INFO, "Serving the triangulation requests with " + algo_name);
+    const auto stats = batch::serve(std::cin, std::cout, *algo_it, settings, server_settings, err_handler);
+    std::stringstream out;
+    out << "Served " << stats.nb_requests << " requests in " << stats.nb_batches << " batches, " << stats.nb_failures << " failed";
+    err_handler(stdutils::io::Severity::INFO, out.str());
+    return g_any_error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// The implementation of the tiled triangulation: The first one of the --algo options, or the reference one
+const delaunay::RegisteredImpl<batch::scalar, std::uint32_t>* tiling_impl(const batch::RunSettings& settings, const stdutils::io::ErrorHandler& err_handler)
+{
+    static const auto impl_list = delaunay::get_impl_list<batch::scalar>();
+    const std::string algo_name = settings.algo_filter.empty() ? impl_list.reference : settings.algo_filter.front();
+    if (algo_name == "auto")
+    {
+        err_handler(stdutils::io::Severity::FATAL, "The auto selection is not supported by the tiled triangulation");
+        return nullptr;
+    }
+    const auto algo_it = std::find_if(std::cbegin(impl_list.algos), std::cend(impl_list.algos), [&algo_name](const auto& algo) { return algo.name == algo_name; });
+    assert(algo_it != std::cend(impl_list.algos));
+    return &*algo_it;
+}
+
+int plan_tiles(const argagg::parser_results& args, const batch::RunSettings& settings, const stdutils::parallel::Policy& parallel_policy, const stdutils::io::ErrorHandler& err_handler)
+{
+    batch::TilingSettings tiling_settings;
+    try
+    {
+        const auto tiles = args["tiles"].as<std::string>("4x4");
+        const auto sep = tiles.find('x');
+        const int nb_columns = sep == std::string::npos ? 0 : std::stoi(tiles.substr(0, sep));
+        const int nb_rows = sep == std::string::npos ? 0 : std::stoi(tiles.substr(sep + 1));
+        if (nb_columns <= 0 || nb_rows <= 0) { err_handler(stdutils::io::Severity::FATAL, "Invalid grid of tiles: " + tiles); return EXIT_FAILURE; }
+        tiling_settings.nb_columns = static_cast<unsigned int>(nb_columns);
+        tiling_settings.nb_rows = static_cast<unsigned int>(nb_rows);
+        tiling_settings.halo_ratio = args["halo"].as<float>(tiling_settings.halo_ratio);
+        if (tiling_settings.halo_ratio < 0.f) { err_handler(stdutils::io::Severity::FATAL, "The halo must be positive"); return EXIT_FAILURE; }
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream out;
+        out << "While parsing arguments: " << e.what();
+        err_handler(stdutils::io::Severity::EXCPT, out.str());
+        return EXIT_FAILURE;
+    }
+    if (args.pos.empty())
+    {
+        err_handler(stdutils::io::Severity::FATAL, "No input file");
+        return EXIT_FAILURE;
+    }
+    std::vector<std::filesystem::path> input_paths;
+    for (const char* input_path : args.pos) { input_paths.emplace_back(input_path); }
+    const auto inputs = batch::load_input_files(input_paths, parallel_policy, err_handler);
+    const bool success = batch::plan_tiles(inputs, args["plan_tiles"].as<std::string>(), tiling_settings, settings, parallel_policy, err_handler);
+    return success && !g_any_error ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int run_tiles(const argagg::parser_results& args, const batch::RunSettings& settings, const stdutils::parallel::Policy& parallel_policy, const stdutils::io::ErrorHandler& err_handler)
+{
+    const auto* impl = tiling_impl(settings, err_handler);
+    if (impl == nullptr)
+        return EXIT_FAILURE;
+    std::vector<std::size_t> tile_indices;
+    try
+    {
+        for (const auto& tile : args["tile"].all)
+        {
+            const int tile_idx = tile.as<int>();
+            if (tile_idx < 0) { err_handler(stdutils::io::Severity::FATAL, "Invalid tile index"); return EXIT_FAILURE; }
+            tile_indices.push_back(static_cast<std::size_t>(tile_idx));
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream out;
+        out << "While parsing arguments: " << e.what();
+        err_handler(stdutils::io::Severity::EXCPT, out.str());
+        return EXIT_FAILURE;
+    }
+    const auto nb_failures = batch::run_tiles(args["run_tiles"].as<std::string>(), tile_indices, *impl, settings, parallel_policy, err_handler);
+    return nb_failures == 0 && !g_any_error ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int merge_tiles(const argagg::parser_results& args, const batch::RunSettings& settings, const stdutils::parallel::Policy& parallel_policy, const stdutils::io::ErrorHandler& err_handler)
+{
+    const auto* impl = tiling_impl(settings, err_handler);
+    if (impl == nullptr)
+        return EXIT_FAILURE;
+    if (!args["output"])
+    {
+        err_handler(stdutils::io::Severity::FATAL, "The merged triangulation requires an output file");
+        return EXIT_FAILURE;
+    }
+    auto merge = batch::merge_tiles(args["merge_tiles"].as<std::string>(), *impl, parallel_policy, err_handler);
+    if (merge.triangles.faces.empty())
+    {
+        err_handler(stdutils::io::Severity::ERR, "The merged triangulation is empty");
+        return EXIT_FAILURE;
+    }
+    shapes::io::ShapeAggregate<batch::scalar> result;
+    result.emplace_back(std::move(merge.triangles), impl->name);
+    shapes::io::shb::save_shapes_as_file(args["output"].as<std::string>(), result, err_handler);
+    return g_any_error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // Parse command line
+    const auto args = parse_command_line(argc, argv);
+    if (args["help"])
+    {
+        usage_notes(std::cout);
+        return EXIT_SUCCESS;
+    }
+    if (args["platform"])
+    {
+        stdutils::platform::print_platform_info(std::cout);
+        stdutils::platform::print_cpu_topology(std::cout);
+        return EXIT_SUCCESS;
+    }
+
+    const stdutils::io::ErrorHandler err_handler(err_callback);
+
+    // Register the Delaunay triangulation implementations
+    if (!delaunay::register_all_implementations())
+    {
+        err_handler(stdutils::io::Severity::FATAL, "Issue during Delaunay implementations' registration");
+        return EXIT_FAILURE;
+    }
+    const auto impl_list = delaunay::get_impl_list<batch::scalar>();
+    if (args["list"])
+    {
+        for (const auto& algo : impl_list.algos)
+            std::cout << algo.name << (algo.name == impl_list.reference ? " (reference)" : "") << '\n';
+        return EXIT_SUCCESS;
+    }
+
+    g_verbose = static_cast<bool>(args["verbose"]);
+    if (!g_verbose) { stdutils::io::set_severity_threshold(stdutils::io::Severity::INFO); }
+    batch::RunSettings settings;
+    batch::ReportFormat format = batch::ReportFormat::CSV;
+    stdutils::parallel::Policy load_policy;
+    if (!parse_run_settings(args, settings, format, load_policy))
+        return EXIT_FAILURE;
+    for (const auto& name : settings.algo_filter)
+    {
+        if (name != "auto" && std::none_of(std::cbegin(impl_list.algos), std::cend(impl_list.algos), [&name](const auto& algo) { return algo.name == name; }))
+        {
+            err_handler(stdutils::io::Severity::FATAL, "Unknown Delaunay implementation: " + name);
+            return EXIT_FAILURE;
+        }
+    }
+    if (args["serve"])
+    {
+        return serve(args, settings, load_policy, err_handler);
+    }
+    if (args["plan_tiles"])
+    {
+        return plan_tiles(args, settings, load_policy, err_handler);
+    }
+    if (args["run_tiles"])
+    {
+        return run_tiles(args, settings, load_policy, err_handler);
+    }
+    if (args["merge_tiles"])
+    {
+        return merge_tiles(args, settings, load_policy, err_handler);
+    }
+    if (args.pos.empty())
+    {
+        usage_notes(std::cerr);
+        err_handler(stdutils::io::Severity::FATAL, "No input file");
+        return EXIT_FAILURE;
+    }
+
+    if (args["selection_profile"])
+    {
+        settings.selection_profile = delaunay::load_selection_profile(args["selection_profile"].as<std::string>(), err_handler);
+    }
+
+    if (args["profile"]) { stdutils::profiler::set_enabled(true); }
+
+    // Load all the input files, then run the benchmarks so that the file loading does not interfere with the timings
+    std::vector<std::filesystem::path> input_paths;
+    input_paths.reserve(args.pos.size());
+    for (const char* input_path : args.pos) { input_paths.emplace_back(input_path); }
+    const auto inputs = batch::load_input_files(input_paths, load_policy, err_handler);
+
+    // Run
+    std::vector<batch::AlgoBenchmark> benchmarks;
+    for (const auto& input : inputs)
+    {
+        if (input.shapes.empty())
+        {
+            err_handler(stdutils::io::Severity::ERR, "No input shapes in file " + input.name);
+            continue;
+        }
+        auto input_benchmarks = batch::run_all_algos(input, settings, err_handler);
+        std::move(std::begin(input_benchmarks), std::end(input_benchmarks), std::back_inserter(benchmarks));
+    }
+
+    // Report
+    if (args["output"])
+    {
+        const std::filesystem::path output_path = args["output"].as<std::string>();
+        const stdutils::io::StreamWriter<std::vector<batch::AlgoBenchmark>, char> writer = [format](std::ostream& out, const auto& obj, const auto&) {
+            batch::write_report(out, obj, format);
+        };
+        stdutils::io::save_txt_file(output_path, writer, benchmarks, err_handler);
+    }
+    else
+    {
+        batch::write_report(std::cout, benchmarks, format);
+    }
+    if (args["save_selection_profile"])
+    {
+        delaunay::save_selection_profile(args["save_selection_profile"].as<std::string>(), batch::selection_profile(benchmarks), err_handler);
+    }
+    if (args["profile"])
+    {
+        stdutils::profiler::save_chrome_trace_file(args["profile"].as<std::string>(), err_handler);
+    }
+
+    return g_any_error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,428 @@
+/*******************************************************************************
+ * PERFORMANCE REGRESSION BENCHMARK OF THE EXAMPLES CORPUS
+ *
+ * Run the full pipeline load -> sample -> triangulate -> proximity graphs on a corpus of input files, and on upsampled versions
+ * of the same inputs. The median timings are compared against a baseline file, recorded on a previous run on the same machine.
+ *
+ * Copyright (c) 2024 Pierre DEJOUE
+ * This code is distributed under the terms of the MIT License
+ ******************************************************************************/
+
+#include "batch_input.h"
+
+#ifdef _MSC_VER
+#pragma warning( push )
+#pragma warning( disable : 28020 )               // Warning C28020: The expression 'expr' is not true at this call
+#endif
+#include <argagg/argagg.hpp>
+#ifdef _MSC_VER
+#pragma warning( pop )
+#endif
+
+#include <dt/dt_impl.h>
+#include <dt/dt_interface.h>
+#include <dt/proximity_graphs.h>
+#include <shapes/point_cloud.h>
+#include <shapes/sampling.h>
+#include <shapes/shapes.h>
+#include <stdutils/benchmark.h>
+#include <stdutils/io.h>
+#include <stdutils/visit.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace {
+
+using scalar = batch::scalar;
+
+void err_callback(stdutils::io::SeverityCode sev, std::string_view msg)
+{
+    std::cerr << stdutils::io::str_severity_code(sev) << ": " << msg << std::endl;
+}
+
+argagg::parser argparser{ {
+    { "help", { "-h", "--help" }, "Print usage note and exit", 0 },
+    { "baseline", { "-b", "--baseline" }, "Baseline timings file (CSV). Recorded if it does not exist yet.", 1 },
+    { "update_baseline", { "-u", "--update-baseline" }, "Overwrite the baseline timings with those of this run", 0 },
+    { "threshold", { "-t", "--threshold" }, "Slowdown relative to the baseline above which a regression is reported. (Default: 0.10)", 1 },
+    { "scales", { "-s", "--scales" }, "Comma-separated upsampling factors of the paths of each input. (Default: 1,4,16)", 1 },
+    { "runs", { "-n", "--runs" }, "Minimum number of runs of each measurement. (Default: 5)", 1 },
+    { "max_runs", { "--max-runs" }, "Maximum number of runs of each measurement. (Default: 20)", 1 },
+    { "ci", { "--ci" }, "Target half width of the 95% confidence interval of the mean, relative to the mean. (Default: 0.05)", 1 }
+} };
+
+void usage_notes(std::ostream& out)
+{
+    out << "Performance regression benchmark of the examples corpus\n\n";
+    out << "Usage:\n\n";
+    out << "  bench_corpus [options] <file or directory> [<file or directory> ...]\n\n";
+    out << "The directories are searched for DAT, CDT, SHB and SVG files. The exit code is EXIT_FAILURE if a regression is detected.\n\n";
+    out << "Options:\n\n";
+    out << argparser;
+}
+
+constexpr std::array<delaunay::TriangulationPolicy, 2> triangulation_policies = {
+    delaunay::TriangulationPolicy::PointCloud,
+    delaunay::TriangulationPolicy::CDT
+};
+
+constexpr std::array<std::string_view, 4> input_extensions = { ".cdt", ".dat", ".shb", ".svg" };
+
+std::vector<std::filesystem::path> list_input_files(const std::vector<std::filesystem::path>& paths, const stdutils::io::ErrorHandler& err_handler)
+{
+    std::vector<std::filesystem::path> result;
+    for (const auto& path : paths)
+    {
+        std::error_code ec;
+        if (std::filesystem::is_directory(path, ec))
+        {
+            std::vector<std::filesystem::path> dir_files;
+            for (const auto& entry : std::filesystem::directory_iterator(path, ec))
+            {
+                const auto ext = entry.path().extension().string();
+                if (entry.is_regular_file() && std::find(input_extensions.cbegin(), input_extensions.cend(), ext) != input_extensions.cend())
+                    dir_files.emplace_back(entry.path());
+            }
+            std::sort(dir_files.begin(), dir_files.end());
+            result.insert(result.end(), dir_files.cbegin(), dir_files.cend());
+        }
+        else if (std::filesystem::is_regular_file(path, ec))
+        {
+            result.emplace_back(path);
+        }
+        else
+        {
+            err_handler(stdutils::io::Severity::ERR, "No such file or directory: " + path.string());
+        }
+    }
+    return result;
+}
+
+std::vector<unsigned int> parse_scales(const std::string& str)
+{
+    std::vector<unsigned int> result;
+    std::stringstream in(str);
+    std::string token;
+    while (std::getline(in, token, ','))
+    {
+        const int scale = std::stoi(token);
+        if (scale <= 0) { throw std::invalid_argument("The scales must be positive"); }
+        result.push_back(static_cast<unsigned int>(scale));
+    }
+    return result;
+}
+
+/**
+ * Baseline timings
+ *
+ * One line per measurement: input,scale,stage,algo,policy,median_ms
+ */
+using BaselineKey = std::string;
+using Baseline = std::map<BaselineKey, double>;
+
+BaselineKey baseline_key(std::string_view input, unsigned int scale, std::string_view stage, std::string_view algo, std::string_view policy)
+{
+    std::stringstream out;
+    out << input << ',' << scale << ',' << stage << ',' << algo << ',' << policy;
+    return out.str();
+}
+
+Baseline read_baseline(const std::filesystem::path& filepath, const stdutils::io::ErrorHandler& err_handler)
+{
+    Baseline result;
+    std::ifstream in(filepath);
+    std::string line;
+    std::getline(in, line);         // Header
+    while (std::getline(in, line))
+    {
+        const auto pos = line.rfind(',');
+        if (pos == std::string::npos) { continue; }
+        try
+        {
+            result[line.substr(0, pos)] = std::stod(line.substr(pos + 1));
+        }
+        catch (const std::exception&)
+        {
+            err_handler(stdutils::io::Severity::WARN, "Invalid line in the baseline file: " + line);
+        }
+    }
+    return result;
+}
+
+void write_baseline(const std::filesystem::path& filepath, const Baseline& baseline, const stdutils::io::ErrorHandler& err_handler)
+{
+    std::ofstream out(filepath);
+    if (!out.is_open())
+    {
+        err_handler(stdutils::io::Severity::ERR, "Cannot write the baseline file: " + filepath.string());
+        return;
+    }
+    out << "input,scale,stage,algo,policy,median_ms\n";
+    for (const auto& [key, median_ms] : baseline)
+        out << key << ',' << median_ms << '\n';
+}
+
+/**
+ * Sampled input: The paths are sampled at the length of the longest segment of each path, divided by the scale
+ */
+struct SampledInput
+{
+    std::vector<shapes::PointPath2d<scalar>> paths;
+    std::vector<shapes::PointCloud2d<scalar>> point_clouds;
+    std::size_t nb_vertices() const;
+};
+
+std::size_t SampledInput::nb_vertices() const
+{
+    std::size_t result = 0;
+    for (const auto& pp : paths) { result += pp.vertices.size(); }
+    for (const auto& pc : point_clouds) { result += pc.vertices.size(); }
+    return result;
+}
+
+template <typename Sampler>
+shapes::PointPath2d<scalar> sample_path(const Sampler& sampler, unsigned int scale)
+{
+    return sampler.sample(sampler.max_segment_length() / static_cast<scalar>(scale));
+}
+
+SampledInput sample_input(const batch::TriangulationInput& input, unsigned int scale)
+{
+    SampledInput result;
+    for (const auto& shape_wrapper : input.shapes)
+    {
+        std::visit(stdutils::Overloaded {
+            [&result](const shapes::PointCloud2d<scalar>& pc) { result.point_clouds.push_back(pc); },
+            [&result, scale](const shapes::PointPath2d<scalar>& pp) {
+                result.paths.push_back(sample_path(shapes::UniformSamplingPointPath2d<scalar>(pp), scale));
+            },
+            [&result, scale](const shapes::CubicBezierPath2d<scalar>& cbp) {
+                result.paths.push_back(sample_path(shapes::UniformSamplingCubicBezier2d<scalar>(cbp), scale));
+            },
+            [](const shapes::Edges2d<scalar>&) { /* Skip */ },
+            [](const shapes::Triangles2d<scalar>&) { /* Skip */ },
+            [](const auto&) { assert(0); }
+        }, shape_wrapper.shape);
+    }
+    return result;
+}
+
+// Same convention as batch::setup_triangulation()
+std::unique_ptr<delaunay::Interface<scalar, std::uint32_t>> setup_triangulation(const delaunay::RegisteredImpl<scalar, std::uint32_t>& impl, const SampledInput& input, const stdutils::io::ErrorHandler& err_handler)
+{
+    auto triangulation_algo = delaunay::get_impl(impl, &err_handler);
+    bool first_path = true;
+    for (const auto& pp : input.paths)
+    {
+        if (first_path) { triangulation_algo->add_path(pp); first_path = false; }
+        else { triangulation_algo->add_hole(pp); }
+    }
+    for (const auto& pc : input.point_clouds)
+        triangulation_algo->add_steiner(pc);
+    return triangulation_algo;
+}
+
+shapes::PointCloud2d<scalar> all_vertices(const SampledInput& input)
+{
+    shapes::PointCloud2d<scalar> result;
+    result.vertices.reserve(input.nb_vertices());
+    for (const auto& pp : input.paths) { result.vertices.insert(result.vertices.end(), pp.vertices.cbegin(), pp.vertices.cend()); }
+    for (const auto& pc : input.point_clouds) { result.vertices.insert(result.vertices.end(), pc.vertices.cbegin(), pc.vertices.cend()); }
+    return result;
+}
+
+/**
+ * Comparison with the baseline
+ */
+struct Comparison
+{
+    Comparison(const Baseline& baseline, Baseline& new_baseline, double threshold) : baseline(baseline), new_baseline(new_baseline), threshold(threshold) {}
+
+    void report(std::string_view input, unsigned int scale, std::string_view stage, std::string_view algo, std::string_view policy, std::size_t nb_vertices, const stdutils::benchmark::Report& report);
+
+    const Baseline& baseline;
+    Baseline& new_baseline;
+    double threshold;
+    unsigned int nb_regressions{0};
+};
+
+void Comparison::report(std::string_view input, unsigned int scale, std::string_view stage, std::string_view algo, std::string_view policy, std::size_t nb_vertices, const stdutils::benchmark::Report& report)
+{
+    const auto key = baseline_key(input, scale, stage, algo, policy);
+    const double median_ms = report.result.median;
+    new_baseline[key] = median_ms;
+    std::cout << key << ','
+              << nb_vertices << ','
+              << report.samples_ms.size() << ','
+              << report.nb_outliers << ','
+              << median_ms << ','
+              << report.result.mean << ','
+              << report.ci_half_width << ',';
+    const auto baseline_it = baseline.find(key);
+    if (baseline_it == baseline.cend() || baseline_it->second <= 0.0)
+    {
+        std::cout << ",,new" << std::endl;
+        return;
+    }
+    const double ratio = median_ms / baseline_it->second;
+    std::string_view status = "ok";
+    // A difference within the confidence interval is not significant, whatever the ratio
+    const bool significant = std::abs(median_ms - baseline_it->second) > report.ci_half_width;
+    if (significant && ratio > 1.0 + threshold) { status = "regression"; nb_regressions++; }
+    else if (significant && ratio < 1.0 - threshold) { status = "improvement"; }
+    std::cout << baseline_it->second << ',' << ratio << ',' << status << std::endl;
+}
+
+std::string to_string(delaunay::TriangulationPolicy policy)
+{
+    std::stringstream out;
+    out << policy;
+    return out.str();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    argagg::parser_results args;
+    std::filesystem::path baseline_path;
+    double threshold = 0.0;
+    std::vector<unsigned int> scales;
+    stdutils::benchmark::Settings bench_settings;
+    bench_settings.time_budget = std::chrono::milliseconds(2000);
+    try
+    {
+        args = argparser.parse(argc, argv);
+        baseline_path = args["baseline"].as<std::string>("");
+        threshold = args["threshold"].as<double>(0.10);
+        scales = parse_scales(args["scales"].as<std::string>("1,4,16"));
+        bench_settings.min_runs = args["runs"].as<unsigned int>(5);
+        bench_settings.max_runs = args["max_runs"].as<unsigned int>(20);
+        bench_settings.target_ci_ratio = args["ci"].as<double>(0.05);
+    }
+    catch (const std::exception& e)
+    {
+        usage_notes(std::cerr);
+        std::stringstream out;
+        out << "While parsing arguments: " << e.what();
+        err_callback(stdutils::io::Severity::EXCPT, out.str());
+        return EXIT_FAILURE;
+    }
+    if (args["help"])
+    {
+        usage_notes(std::cout);
+        return EXIT_SUCCESS;
+    }
+    if (threshold <= 0.0 || scales.empty() || bench_settings.min_runs == 0 || bench_settings.max_runs < bench_settings.min_runs)
+    {
+        err_callback(stdutils::io::Severity::FATAL, "Invalid threshold, scales or number of runs");
+        return EXIT_FAILURE;
+    }
+
+    const stdutils::io::ErrorHandler err_handler(err_callback);
+    const stdutils::io::ErrorHandler silent_handler([](stdutils::io::SeverityCode, std::string_view) {});
+    if (!delaunay::register_all_implementations())
+    {
+        err_handler(stdutils::io::Severity::FATAL, "Issue during Delaunay implementations' registration");
+        return EXIT_FAILURE;
+    }
+    const auto impl_list = delaunay::get_impl_list<scalar, std::uint32_t>();
+
+    std::vector<std::filesystem::path> input_args;
+    for (const char* input_arg : args.pos) { input_args.emplace_back(input_arg); }
+    const auto input_paths = list_input_files(input_args, err_handler);
+    if (input_paths.empty())
+    {
+        usage_notes(std::cerr);
+        err_handler(stdutils::io::Severity::FATAL, "No input file");
+        return EXIT_FAILURE;
+    }
+
+    // Baseline
+    Baseline baseline;
+    const bool has_baseline_file = !baseline_path.empty() && std::filesystem::exists(baseline_path);
+    if (has_baseline_file && !args["update_baseline"]) { baseline = read_baseline(baseline_path, err_handler); }
+    Baseline new_baseline;
+    Comparison comparison(baseline, new_baseline, threshold);
+
+    std::cout << "input,scale,stage,algo,policy,nb_vertices,runs,outliers,median_ms,mean_ms,ci95_ms,baseline_ms,ratio,status" << std::endl;
+    for (const auto& input_path : input_paths)
+    {
+        // Load
+        const auto input = batch::load_input_file(input_path, err_handler);
+        if (input.shapes.empty()) { continue; }
+        const auto load_report = stdutils::benchmark::run([&input_path, &silent_handler]() { return batch::load_input_file(input_path, silent_handler).shapes.size(); }, bench_settings);
+        comparison.report(input.name, 1, "load", "", "", 0, load_report);
+
+        for (const auto scale : scales)
+        {
+            // Sample
+            const auto sampled_input = sample_input(input, scale);
+            const std::size_t nb_vertices = sampled_input.nb_vertices();
+            if (nb_vertices < 3) { break; }
+            const auto sample_report = stdutils::benchmark::run([&input, scale]() { return sample_input(input, scale).paths.size(); }, bench_settings);
+            comparison.report(input.name, scale, "sample", "", "", nb_vertices, sample_report);
+
+            // Triangulate. The setup of the triangulation is not measured.
+            for (const auto& impl : impl_list.algos)
+            {
+                for (const auto policy : triangulation_policies)
+                {
+                    if (policy == delaunay::TriangulationPolicy::CDT && sampled_input.paths.empty()) { continue; }
+                    bool success = true;
+                    const auto triangulate_report = stdutils::benchmark::run_with_setup(
+                        [&impl, &sampled_input, &silent_handler]() { return setup_triangulation(impl, sampled_input, silent_handler); },
+                        [policy, &success](auto& triangulation_algo) {
+                            const auto triangles = triangulation_algo->triangulate_and_release(policy);
+                            success &= !triangles.faces.empty();
+                            return triangles.faces.size();
+                        },
+                        bench_settings);
+                    if (!success)
+                    {
+                        err_handler(stdutils::io::Severity::WARN, impl.name + " failed on " + input.name);
+                        continue;
+                    }
+                    comparison.report(input.name, scale, "triangulate", impl.name, to_string(policy), nb_vertices, triangulate_report);
+                }
+            }
+
+            // Proximity graphs
+            const auto pc = all_vertices(sampled_input);
+            const auto proximity_report = stdutils::benchmark::run([&pc, &silent_handler]() { return delaunay::proximity_graphs<shapes::Point2d<scalar>, std::uint32_t>(pc, silent_handler).dt.indices.size(); }, bench_settings);
+            comparison.report(input.name, scale, "proximity", "", "", nb_vertices, proximity_report);
+        }
+    }
+
+    if (!baseline_path.empty() && (!has_baseline_file || args["update_baseline"]))
+    {
+        write_baseline(baseline_path, new_baseline, err_handler);
+        std::cerr << "Baseline timings recorded in " << baseline_path.string() << std::endl;
+    }
+    if (comparison.nb_regressions > 0)
+    {
+        std::stringstream out;
+        out << comparison.nb_regressions << " performance regression(s) above " << (100.0 * threshold) << "%";
+        err_handler(stdutils::io::Severity::ERR, out.str());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,183 @@
+/*******************************************************************************
+ * BENCHMARK OF THE DELAUNAY TRIANGULATIONS
+ *
+ * Sweep point cloud sizes, distributions and vertex orders for the registered Delaunay implementations
+ *
+ * Copyright (c) 2024 Pierre DEJOUE
+ * This code is distributed under the terms of the MIT License
+ ******************************************************************************/
+
+#include "point_distributions.h"
+
+#ifdef _MSC_VER
+#pragma warning( push )
+#pragma warning( disable : 28020 )               // Warning C28020: The expression 'expr' is not true at this call
+#endif
+#include <argagg/argagg.hpp>
+#ifdef _MSC_VER
+#pragma warning( pop )
+#endif
+
+#include <dt/dt_impl.h>
+#include <dt/dt_interface.h>
+#include <shapes/point_cloud.h>
+#include <shapes/triangle.h>
+#include <stdutils/benchmark.h>
+#include <stdutils/enum.h>
+#include <stdutils/io.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using index = std::uint32_t;
+
+void err_callback(stdutils::io::SeverityCode sev, std::string_view msg)
+{
+    std::cerr << stdutils::io::str_severity_code(sev) << ": " << msg << std::endl;
+}
+
+argagg::parser argparser{ {
+    { "help", { "-h", "--help" }, "Print usage note and exit", 0 },
+    { "min", { "--min" }, "Smallest point cloud size. (Default: 1000)", 1 },
+    { "max", { "--max" }, "Largest point cloud size. (Default: 1000000)", 1 },
+    { "runs", { "-n", "--runs" }, "Minimum number of runs of each measurement. (Default: 5)", 1 },
+    { "max_runs", { "--max-runs" }, "Maximum number of runs of each measurement. (Default: 50)", 1 },
+    { "ci", { "--ci" }, "Target half width of the 95% confidence interval of the mean, relative to the mean. (Default: 0.02)", 1 },
+    { "fp32", { "--fp32" }, "Run the implementations registered with a float interface", 0 }
+} };
+
+void usage_notes(std::ostream& out)
+{
+    out << "Benchmark of the Delaunay triangulations\n\n";
+    out << "Options:\n\n";
+    out << argparser;
+}
+
+constexpr std::array<delaunay::VertexOrder, 3> vertex_orders = {
+    delaunay::VertexOrder::AsProvided,
+    delaunay::VertexOrder::Hilbert,
+    delaunay::VertexOrder::BRIO
+};
+
+struct Measurement
+{
+    std::size_t nb_triangles{0};
+    stdutils::benchmark::Report report;
+};
+
+// The measure includes the vertex ordering, which is done when the input is added to the triangulation
+template <typename F>
+Measurement measure(const delaunay::RegisteredImpl<F, index>& impl, delaunay::VertexOrder order, const shapes::PointCloud2d<F>& pc, const stdutils::benchmark::Settings& settings, const stdutils::io::ErrorHandler& err_handler)
+{
+    Measurement result;
+    result.report = stdutils::benchmark::run_with_setup(
+        [&impl, &err_handler]() { return delaunay::get_impl(impl, &err_handler); },
+        [order, &pc, &result](auto& dt_algo) {
+            dt_algo->set_vertex_order(order);
+            dt_algo->add_steiner(pc);
+            const auto triangles = dt_algo->triangulate_and_release(delaunay::TriangulationPolicy::PointCloud);
+            result.nb_triangles = triangles.faces.size();
+            return triangles.faces.size();
+        },
+        settings);
+    return result;
+}
+
+template <typename F>
+void run_benchmark(std::size_t min_size, std::size_t max_size, const stdutils::benchmark::Settings& bench_settings, const stdutils::io::ErrorHandler& err_handler)
+{
+    const auto impl_list = delaunay::get_impl_list<F, index>();
+
+    std::cout << "algo,distribution,vertex_order,nb_points,nb_triangles,runs,outliers,min_ms,median_ms,mean_ms,ci95_ms" << std::endl;
+    for (std::size_t dist_idx = 0; dist_idx < stdutils::enum_size<bench::PointDistribution>(); dist_idx++)
+    {
+        const auto distribution = static_cast<bench::PointDistribution>(dist_idx);
+        for (std::size_t n = min_size; n <= max_size; n *= 10)
+        {
+            // Setup (not measured). The points are shuffled, like the output of a scanner with no spatial coherence.
+            auto pc = bench::generate_point_cloud<F>(distribution, n);
+            std::shuffle(pc.vertices.begin(), pc.vertices.end(), std::mt19937(1));
+
+            // Measurements
+            for (const auto& impl : impl_list.algos)
+            {
+                for (const auto order : vertex_orders)
+                {
+                    const auto meas = measure(impl, order, pc, bench_settings, err_handler);
+                    const auto& result = meas.report.result;
+                    std::cout << impl.name << ','
+                              << bench::to_string(distribution) << ','
+                              << order << ','
+                              << n << ','
+                              << meas.nb_triangles << ','
+                              << meas.report.samples_ms.size() << ','
+                              << meas.report.nb_outliers << ','
+                              << result.min << ','
+                              << result.median << ','
+                              << result.mean << ','
+                              << meas.report.ci_half_width << std::endl;
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    argagg::parser_results args;
+    std::size_t min_size = 0;
+    std::size_t max_size = 0;
+    stdutils::benchmark::Settings bench_settings;
+    try
+    {
+        args = argparser.parse(argc, argv);
+        min_size = args["min"].as<std::size_t>(1000);
+        max_size = args["max"].as<std::size_t>(1000000);
+        bench_settings.min_runs = args["runs"].as<unsigned int>(5);
+        bench_settings.max_runs = args["max_runs"].as<unsigned int>(50);
+        bench_settings.target_ci_ratio = args["ci"].as<double>(0.02);
+    }
+    catch (const std::exception& e)
+    {
+        usage_notes(std::cerr);
+        std::stringstream out;
+        out << "While parsing arguments: " << e.what();
+        err_callback(stdutils::io::Severity::EXCPT, out.str());
+        return EXIT_FAILURE;
+    }
+    if (args["help"])
+    {
+        usage_notes(std::cout);
+        return EXIT_SUCCESS;
+    }
+    if (min_size < 3 || max_size < min_size || bench_settings.min_runs == 0 || bench_settings.max_runs < bench_settings.min_runs)
+    {
+        err_callback(stdutils::io::Severity::FATAL, "Invalid sizes or number of runs");
+        return EXIT_FAILURE;
+    }
+
+    const stdutils::io::ErrorHandler err_handler(err_callback);
+    if (!delaunay::register_all_implementations())
+    {
+        err_handler(stdutils::io::Severity::FATAL, "Issue during Delaunay implementations' registration");
+        return EXIT_FAILURE;
+    }
+    if (args["fp32"])
+        run_benchmark<float>(min_size, max_size, bench_settings, err_handler);
+    else
+        run_benchmark<double>(min_size, max_size, bench_settings, err_handler);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,242 @@
+/*******************************************************************************
+ * BENCHMARK OF THE PROXIMITY GRAPHS
+ *
+ * Sweep point cloud sizes and distributions for the algorithms of graphs/proximity.h
+ *
+ * Copyright (c) 2023 Pierre DEJOUE
+ * This code is distributed under the terms of the MIT License
+ ******************************************************************************/
+
+#include "point_distributions.h"
+
+#ifdef _MSC_VER
+#pragma warning( push )
+#pragma warning( disable : 28020 )               // Warning C28020: The expression 'expr' is not true at this call
+#endif
+#include <argagg/argagg.hpp>
+#ifdef _MSC_VER
+#pragma warning( pop )
+#endif
+
+#include <dt/dt_impl.h>
+#include <graphs/graph.h>
+#include <graphs/graph_algos.h>
+#include <graphs/proximity.h>
+#include <shapes/point_cloud.h>
+#include <shapes/triangle.h>
+#include <shapes/vect.h>
+#include <stdutils/benchmark.h>
+#include <stdutils/enum.h>
+#include <stdutils/io.h>
+#include <stdutils/parallel.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using scalar = double;
+using index_t = std::uint32_t;
+
+void err_callback(stdutils::io::SeverityCode sev, std::string_view msg)
+{
+    std::cerr << stdutils::io::str_severity_code(sev) << ": " << msg << std::endl;
+}
+
+argagg::parser argparser{ {
+    { "help", { "-h", "--help" }, "Print usage note and exit", 0 },
+    { "min", { "--min" }, "Smallest point cloud size. (Default: 1000)", 1 },
+    { "max", { "--max" }, "Largest point cloud size. (Default: 10000000)", 1 },
+    { "max_naive", { "--max-naive" }, "Largest size for the naive quadratic algorithms RNG_naive and GG_naive. (Default: 20000)", 1 },
+    { "runs", { "-n", "--runs" }, "Minimum number of runs of each measurement. (Default: 5)", 1 },
+    { "max_runs", { "--max-runs" }, "Maximum number of runs of each measurement. (Default: 50)", 1 },
+    { "ci", { "--ci" }, "Target half width of the 95% confidence interval of the mean, relative to the mean. (Default: 0.02)", 1 }
+} };
+
+void usage_notes(std::ostream& out)
+{
+    out << "Benchmark of the proximity graphs\n\n";
+    out << "Options:\n\n";
+    out << argparser;
+}
+
+struct WeightEdge
+{
+    using index = index_t;
+
+    const graphs::Edge<index_t>& edge() const { return m_edge; }
+    scalar weight() const { return m_length; }
+
+    graphs::Edge<index_t> m_edge;
+    scalar m_length;
+};
+
+using WeightEdges = std::vector<WeightEdge>;
+using WeightEdgeIt = WeightEdges::iterator;
+using ProximityAlgo = std::function<WeightEdgeIt(const shapes::Triangles2d<scalar, index_t>&, WeightEdgeIt, WeightEdgeIt)>;
+
+struct BenchAlgo
+{
+    std::string_view name;
+    bool is_quadratic;
+    ProximityAlgo algo;
+};
+
+const std::vector<BenchAlgo>& bench_algos()
+{
+    static const std::vector<BenchAlgo> algos = {
+        { "NN",  false, [](const auto&, WeightEdgeIt begin, WeightEdgeIt end) { return graphs::nearest_neighbor(begin, end); } },
+        { "MST", false, [](const auto&, WeightEdgeIt begin, WeightEdgeIt end) { return graphs::minimum_spanning_tree(begin, end); } },
+        { "MST_par", false, [](const auto&, WeightEdgeIt begin, WeightEdgeIt end) { return graphs::minimum_spanning_tree(stdutils::parallel::Policy(), begin, end); } },
+        { "RNG", false, [](const auto& triangles, WeightEdgeIt begin, WeightEdgeIt end) {
+            const auto& vertices = triangles.vertices;
+            return graphs::relative_neighborhood_graph(begin, end, triangles.faces, [&vertices](const index_t p, const index_t q) { return shapes::norm(vertices[q] - vertices[p]); });
+        } },
+        { "GG",  false, [](const auto& triangles, WeightEdgeIt begin, WeightEdgeIt end) {
+            const auto& vertices = triangles.vertices;
+            return graphs::gabriel_graph(begin, end, triangles.faces, [&vertices](const index_t p, const index_t q) { return shapes::norm(vertices[q] - vertices[p]); });
+        } },
+        { "Hierarchy", false, [](const auto& triangles, WeightEdgeIt begin, WeightEdgeIt end) {
+            // All the graphs from NN to GG. The output edges are those of the GG.
+            const auto& vertices = triangles.vertices;
+            return graphs::proximity_hierarchy(begin, end, triangles.faces, [&vertices](const index_t p, const index_t q) { return shapes::norm(vertices[q] - vertices[p]); }).gg_end;
+        } },
+        { "RNG_naive", true, [](const auto& triangles, WeightEdgeIt begin, WeightEdgeIt end) {
+            const auto& vertices = triangles.vertices;
+            return graphs::relative_neighborhood_graph(begin, end, [&vertices](const index_t p, const index_t q) { return shapes::norm(vertices[q] - vertices[p]); });
+        } },
+        { "GG_naive",  true, [](const auto& triangles, WeightEdgeIt begin, WeightEdgeIt end) {
+            const auto& vertices = triangles.vertices;
+            return graphs::gabriel_graph(begin, end, [&vertices](const index_t p, const index_t q) { return shapes::norm(vertices[q] - vertices[p]); });
+        } }
+    };
+    return algos;
+}
+
+// The input of the proximity graph algorithms is the set of edges of the Delaunay triangulation
+WeightEdges delaunay_edges(const shapes::Triangles2d<scalar, index_t>& triangles)
+{
+    WeightEdges result;
+    const auto edge_soup = graphs::to_edge_soup<index_t>(triangles.faces);
+    result.reserve(edge_soup.size());
+    for (const auto& e : edge_soup)
+    {
+        result.push_back(WeightEdge{ e, shapes::norm(triangles.vertices[e.dest()] - triangles.vertices[e.orig()]) });
+    }
+    return result;
+}
+
+struct Measurement
+{
+    std::size_t nb_output_edges{0};
+    stdutils::benchmark::Report report;
+};
+
+Measurement measure(const BenchAlgo& bench_algo, const shapes::Triangles2d<scalar, index_t>& triangles, const WeightEdges& edges, const stdutils::benchmark::Settings& settings)
+{
+    Measurement result;
+    result.report = stdutils::benchmark::run_with_setup(
+        [&edges]() { return edges; },       // The algorithms reorder the input range
+        [&bench_algo, &triangles, &result](WeightEdges& edges_cpy) {
+            const WeightEdgeIt graph_end = bench_algo.algo(triangles, edges_cpy.begin(), edges_cpy.end());
+            result.nb_output_edges = static_cast<std::size_t>(std::distance(edges_cpy.begin(), graph_end));
+            return result.nb_output_edges;
+        },
+        settings);
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    argagg::parser_results args;
+    std::size_t min_size = 0;
+    std::size_t max_size = 0;
+    std::size_t max_naive_size = 0;
+    stdutils::benchmark::Settings bench_settings;
+    try
+    {
+        args = argparser.parse(argc, argv);
+        min_size = args["min"].as<std::size_t>(1000);
+        max_size = args["max"].as<std::size_t>(10000000);
+        max_naive_size = args["max_naive"].as<std::size_t>(20000);
+        bench_settings.min_runs = args["runs"].as<unsigned int>(5);
+        bench_settings.max_runs = args["max_runs"].as<unsigned int>(50);
+        bench_settings.target_ci_ratio = args["ci"].as<double>(0.02);
+    }
+    catch (const std::exception& e)
+    {
+        usage_notes(std::cerr);
+        std::stringstream out;
+        out << "While parsing arguments: " << e.what();
+        err_callback(stdutils::io::Severity::EXCPT, out.str());
+        return EXIT_FAILURE;
+    }
+    if (args["help"])
+    {
+        usage_notes(std::cout);
+        return EXIT_SUCCESS;
+    }
+    if (min_size < 3 || max_size < min_size || bench_settings.min_runs == 0 || bench_settings.max_runs < bench_settings.min_runs)
+    {
+        err_callback(stdutils::io::Severity::FATAL, "Invalid sizes or number of runs");
+        return EXIT_FAILURE;
+    }
+
+    const stdutils::io::ErrorHandler err_handler(err_callback);
+    if (!delaunay::register_all_implementations())
+    {
+        err_handler(stdutils::io::Severity::FATAL, "Issue during Delaunay implementations' registration");
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "algo,distribution,nb_points,nb_input_edges,nb_output_edges,runs,outliers,min_ms,median_ms,mean_ms,ci95_ms" << std::endl;
+    for (std::size_t dist_idx = 0; dist_idx < stdutils::enum_size<bench::PointDistribution>(); dist_idx++)
+    {
+        const auto distribution = static_cast<bench::PointDistribution>(dist_idx);
+        for (std::size_t n = min_size; n <= max_size; n *= 10)
+        {
+            // Setup (not measured)
+            const auto pc = bench::generate_point_cloud<scalar>(distribution, n);
+            auto [dt_name, dt_algo] = delaunay::get_ref_impl<scalar, index_t>(&err_handler);
+            if (!dt_algo)
+            {
+                err_handler(stdutils::io::Severity::FATAL, "Could not find a Delaunay triangulation algo");
+                return EXIT_FAILURE;
+            }
+            dt_algo->add_steiner(pc);
+            const auto triangles = dt_algo->triangulate_and_release(delaunay::TriangulationPolicy::PointCloud);
+            const auto edges = delaunay_edges(triangles);
+
+            // Measurements
+            for (const auto& bench_algo : bench_algos())
+            {
+                if (bench_algo.is_quadratic && n > max_naive_size)
+                    continue;
+                const auto meas = measure(bench_algo, triangles, edges, bench_settings);
+                const auto& result = meas.report.result;
+                std::cout << bench_algo.name << ','
+                          << bench::to_string(distribution) << ','
+                          << n << ','
+                          << edges.size() << ','
+                          << meas.nb_output_edges << ','
+                          << meas.report.samples_ms.size() << ','
+                          << meas.report.nb_outliers << ','
+                          << result.min << ','
+                          << result.median << ','
+                          << result.mean << ','
+                          << meas.report.ci_half_width << std::endl;
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2023 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <shapes/generators.h>
+#include <shapes/point_cloud.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace bench {
+
+enum class PointDistribution
+{
+    Uniform = 0,            // Uniform in the unit square
+    Clustered,              // Gaussian clusters
+    Grid,                   // Regular grid (degenerate case: co-circular points)
+    _ENUM_SIZE_
+};
+
+std::string_view to_string(PointDistribution distribution);
+
+// Deterministic for a given seed
+template <typename F>
+shapes::PointCloud2d<F> generate_point_cloud(PointDistribution distribution, std::size_t n, std::uint32_t seed = 0);
+
+
+//
+//
+// Implementation
+//
+//
+
+
+inline std::string_view to_string(PointDistribution distribution)
+{
+    switch (distribution)
+    {
+        case PointDistribution::Uniform:    return "uniform";
+        case PointDistribution::Clustered:  return "clustered";
+        case PointDistribution::Grid:       return "grid";
+        default:                            assert(0); return "unknown";
+    }
+}
+
+template <typename F>
+shapes::PointCloud2d<F> generate_point_cloud(PointDistribution distribution, std::size_t n, std::uint32_t seed)
+{
+    switch (distribution)
+    {
+        case PointDistribution::Uniform:    return shapes::generators::uniform_point_cloud<F>(n, seed);
+        case PointDistribution::Clustered:  return shapes::generators::clustered_point_cloud<F>(n, seed);
+        case PointDistribution::Grid:       return shapes::generators::grid_point_cloud<F>(n);
+        default:                            assert(0); return shapes::PointCloud2d<F>();
+    }
+}
+
+} // namespace bench
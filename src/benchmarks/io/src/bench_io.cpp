@@ -0,0 +1,270 @@
+/*******************************************************************************
+ * BENCHMARK OF THE READERS AND WRITERS OF THE FILE FORMATS
+ *
+ * Throughput of the DAT, CDT and SVG parsers, and of the DAT and CDT writers, on generated files of increasing sizes
+ *
+ * Copyright (c) 2024 Pierre DEJOUE
+ * This code is distributed under the terms of the MIT License
+ ******************************************************************************/
+
+#ifdef _MSC_VER
+#pragma warning( push )
+#pragma warning( disable : 28020 )               // Warning C28020: The expression 'expr' is not true at this call
+#endif
+#include <argagg/argagg.hpp>
+#ifdef _MSC_VER
+#pragma warning( pop )
+#endif
+
+#include <shapes/edge.h>
+#include <shapes/generators.h>
+#include <shapes/io.h>
+#include <shapes/path.h>
+#include <shapes/soup.h>
+#include <stdutils/benchmark.h>
+#include <stdutils/io.h>
+#include <svg/svg.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <variant>
+
+namespace {
+
+using index = std::uint32_t;
+
+void err_callback(stdutils::io::SeverityCode sev, std::string_view msg)
+{
+    std::cerr << stdutils::io::str_severity_code(sev) << ": " << msg << std::endl;
+}
+
+argagg::parser argparser{ {
+    { "help", { "-h", "--help" }, "Print usage note and exit", 0 },
+    { "min", { "--min" }, "Size of the smallest generated file, in MB. (Default: 1)", 1 },
+    { "max", { "--max" }, "Size of the largest generated file, in MB. The sizes are multiplied by 4 up to that one. (Default: 64)", 1 },
+    { "dir", { "-d", "--dir" }, "Directory of the generated files. (Default: the temporary directory of the system)", 1 },
+    { "keep", { "--keep" }, "Keep the generated files", 0 },
+    { "runs", { "-n", "--runs" }, "Minimum number of runs of each measurement. (Default: 3)", 1 },
+    { "max_runs", { "--max-runs" }, "Maximum number of runs of each measurement. (Default: 10)", 1 },
+    { "ci", { "--ci" }, "Target half width of the 95% confidence interval of the mean, relative to the mean. (Default: 0.05)", 1 }
+} };
+
+void usage_notes(std::ostream& out)
+{
+    out << "Benchmark of the readers and writers of the file formats\n\n";
+    out << "The output is a CSV table of the throughputs. The shapes of a CDT file are its vertices and edges.\n";
+    out << "There is no SVG writer: The SVG files are generated by the benchmark, and only the parser is measured.\n\n";
+    out << "Options:\n\n";
+    out << argparser;
+}
+
+constexpr std::size_t mega_byte = 1 << 20;
+constexpr std::size_t nb_vertices_per_path = 1000;
+constexpr std::size_t estimated_bytes_per_vertex = 40;      // In the DAT format, two coordinates in full precision
+
+// Closed paths of random points, for a DAT file of about target_bytes
+shapes::io::ShapeAggregate<double> generate_paths(std::size_t target_bytes)
+{
+    shapes::io::ShapeAggregate<double> result;
+    const std::size_t nb_paths = std::max(std::size_t{1}, target_bytes / (nb_vertices_per_path * estimated_bytes_per_vertex));
+    result.reserve(nb_paths);
+    for (std::size_t path_idx = 0; path_idx < nb_paths; path_idx++)
+    {
+        shapes::PointPath2d<double> pp;
+        pp.closed = true;
+        pp.vertices = shapes::generators::uniform_point_cloud<double>(nb_vertices_per_path, static_cast<std::uint32_t>(path_idx)).vertices;
+        result.emplace_back(std::move(pp));
+    }
+    return result;
+}
+
+// The same paths, as an edge soup
+shapes::Soup2d<double, index> to_soup(const shapes::io::ShapeAggregate<double>& paths)
+{
+    shapes::Soup2d<double, index> result;
+    for (const auto& wrapper : paths)
+    {
+        const auto& pp = std::get<shapes::PointPath2d<double>>(wrapper.shape);
+        const auto first_idx = static_cast<index>(result.edges.vertices.size());
+        const auto nb_vertices = static_cast<index>(pp.vertices.size());
+        result.edges.vertices.insert(result.edges.vertices.end(), pp.vertices.cbegin(), pp.vertices.cend());
+        for (index idx = 0; idx < nb_vertices; idx++)
+            result.edges.indices.emplace_back(first_idx + idx, first_idx + (idx + 1) % nb_vertices);
+    }
+    return result;
+}
+
+// Not measured: There is no SVG writer in the tree
+void write_svg_file(const std::filesystem::path& filepath, const shapes::io::ShapeAggregate<double>& paths)
+{
+    std::ofstream out(filepath);
+    out.precision(9);
+    out << "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 1 1\">\n";
+    for (const auto& wrapper : paths)
+    {
+        const auto& pp = std::get<shapes::PointPath2d<double>>(wrapper.shape);
+        out << "<path d=\"";
+        char cmd = 'M';
+        for (const auto& p : pp.vertices) { out << cmd << p.x << ',' << p.y << ' '; cmd = 'L'; }
+        out << "Z\"/>\n";
+    }
+    out << "</svg>\n";
+}
+
+std::size_t file_size_or_zero(const std::filesystem::path& filepath)
+{
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(filepath, ec);
+    return ec ? 0 : static_cast<std::size_t>(size);
+}
+
+class Table
+{
+public:
+    explicit Table(const stdutils::benchmark::Settings& settings) : m_settings(settings)
+    {
+        std::cout << "format,operation,file_mb,nb_shapes,runs,outliers,min_ms,median_ms,ci95_ms,mb_per_s,shapes_per_s" << std::endl;
+    }
+
+    // The function returns the number of shapes read or written
+    template <typename Func>
+    void measure(std::string_view format, std::string_view operation, const std::filesystem::path& filepath, Func&& func)
+    {
+        std::size_t nb_shapes = 0;
+        const auto report = stdutils::benchmark::run([&func, &nb_shapes]() { nb_shapes = func(); return nb_shapes; }, m_settings);
+        const double file_mb = static_cast<double>(file_size_or_zero(filepath)) / static_cast<double>(mega_byte);
+        const double median_s = report.result.median / 1000.0;
+        std::cout << format << ','
+                  << operation << ','
+                  << file_mb << ','
+                  << nb_shapes << ','
+                  << report.samples_ms.size() << ','
+                  << report.nb_outliers << ','
+                  << report.result.min << ','
+                  << report.result.median << ','
+                  << report.ci_half_width << ','
+                  << (median_s > 0.0 ? file_mb / median_s : 0.0) << ','
+                  << (median_s > 0.0 ? static_cast<double>(nb_shapes) / median_s : 0.0) << std::endl;
+    }
+
+private:
+    stdutils::benchmark::Settings m_settings;
+};
+
+void run_benchmark(std::size_t target_bytes, const std::filesystem::path& dir, bool keep_files, Table& table, const stdutils::io::ErrorHandler& err_handler)
+{
+    const auto paths = generate_paths(target_bytes);
+    const auto soup = to_soup(paths);
+    const auto prefix = "bench_io_" + std::to_string(target_bytes / mega_byte) + "mb";
+    const auto dat_path = dir / (prefix + ".dat");
+    const auto cdt_path = dir / (prefix + ".cdt");
+    const auto svg_path = dir / (prefix + ".svg");
+
+    // DAT
+    table.measure("dat", "save_shapes_as_stream", dat_path, [&]() {
+        std::ofstream out(dat_path);
+        shapes::io::dat::save_shapes_as_stream(out, paths, err_handler);
+        return paths.size();
+    });
+    table.measure("dat", "parse_shapes_from_stream", dat_path, [&]() {
+        std::ifstream in(dat_path);
+        return shapes::io::dat::parse_shapes_from_stream(in, err_handler).size();
+    });
+    table.measure("dat", "parse_shapes_from_stream (callback)", dat_path, [&]() {
+        std::ifstream in(dat_path);
+        std::size_t nb_shapes = 0;
+        shapes::io::dat::parse_shapes_from_stream(in, [&nb_shapes](shapes::io::ShapeWrapper<double>&&) { nb_shapes++; return true; }, err_handler);
+        return nb_shapes;
+    });
+
+    // CDT
+    const std::size_t nb_soup_shapes = soup.edges.vertices.size() + soup.edges.indices.size();
+    table.measure("cdt", "save_2d_shapes_as_stream", cdt_path, [&]() {
+        std::ofstream out(cdt_path);
+        shapes::io::cdt::save_2d_shapes_as_stream(out, soup, err_handler);
+        return nb_soup_shapes;
+    });
+    table.measure("cdt", "peek_point_dimension", cdt_path, [&]() {
+        std::ifstream in(cdt_path);
+        return static_cast<std::size_t>(shapes::io::cdt::peek_point_dimension(in, err_handler) > 0 ? 1 : 0);
+    });
+    table.measure("cdt", "parse_2d_shapes_from_stream", cdt_path, [&]() {
+        std::ifstream in(cdt_path);
+        const auto result = shapes::io::cdt::parse_2d_shapes_from_stream(in, err_handler);
+        return result.point_cloud.vertices.size() + result.edges.vertices.size() + result.edges.indices.size();
+    });
+
+    // SVG
+    write_svg_file(svg_path, paths);
+    table.measure("svg", "parse_svg_paths", svg_path, [&]() {
+        return svg::io::parse_svg_paths(svg_path, err_handler).point_paths.size();
+    });
+
+    if (!keep_files)
+    {
+        std::error_code ec;
+        for (const auto& filepath : { dat_path, cdt_path, svg_path }) { std::filesystem::remove(filepath, ec); }
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    argagg::parser_results args;
+    std::size_t min_mb = 0;
+    std::size_t max_mb = 0;
+    std::filesystem::path dir;
+    stdutils::benchmark::Settings bench_settings;
+    try
+    {
+        args = argparser.parse(argc, argv);
+        min_mb = args["min"].as<std::size_t>(1);
+        max_mb = args["max"].as<std::size_t>(64);
+        if (args["dir"]) { dir = args["dir"].as<std::string>(); }
+        else { dir = std::filesystem::temp_directory_path(); }
+        bench_settings.min_runs = args["runs"].as<unsigned int>(3);
+        bench_settings.max_runs = args["max_runs"].as<unsigned int>(10);
+        bench_settings.target_ci_ratio = args["ci"].as<double>(0.05);
+    }
+    catch (const std::exception& e)
+    {
+        usage_notes(std::cerr);
+        std::stringstream out;
+        out << "While parsing arguments: " << e.what();
+        err_callback(stdutils::io::Severity::EXCPT, out.str());
+        return EXIT_FAILURE;
+    }
+    if (args["help"])
+    {
+        usage_notes(std::cout);
+        return EXIT_SUCCESS;
+    }
+    if (min_mb == 0 || max_mb < min_mb || bench_settings.min_runs == 0 || bench_settings.max_runs < bench_settings.min_runs)
+    {
+        err_callback(stdutils::io::Severity::FATAL, "Invalid sizes or number of runs");
+        return EXIT_FAILURE;
+    }
+    std::error_code ec;
+    if (!std::filesystem::is_directory(dir, ec))
+    {
+        err_callback(stdutils::io::Severity::FATAL, "No such directory: " + dir.string());
+        return EXIT_FAILURE;
+    }
+
+    const stdutils::io::ErrorHandler err_handler(err_callback);
+    Table table(bench_settings);
+    for (std::size_t size_mb = min_mb; size_mb <= max_mb; size_mb *= 4)
+        run_benchmark(size_mb * mega_byte, dir, static_cast<bool>(args["keep"]), table, err_handler);
+
+    return EXIT_SUCCESS;
+}
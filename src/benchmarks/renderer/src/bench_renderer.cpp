@@ -0,0 +1,377 @@
+/*******************************************************************************
+ * BENCHMARK OF THE 2D RENDERER
+ *
+ * Render synthetic scenes of points, lines or triangles split into a number of shapes, in an offscreen framebuffer, and measure
+ * the upload of the buffers and the frame times of renderer::Draw2D
+ *
+ * Copyright (c) 2024 Pierre DEJOUE
+ * This code is distributed under the terms of the MIT License
+ ******************************************************************************/
+
+#include "draw_command.h"
+#include "drawing_options.h"
+#include "renderer.h"
+#include "renderer_helpers.h"
+
+#ifdef _MSC_VER
+#pragma warning( push )
+#pragma warning( disable : 28020 )               // Warning C28020: The expression 'expr' is not true at this call
+#endif
+#include <argagg/argagg.hpp>
+#ifdef _MSC_VER
+#pragma warning( pop )
+#endif
+
+#include <base/canvas.h>
+#include <base/color_data.h>
+#include <base/offscreen_framebuffer.h>
+#include <base/opengl_and_glfw.h>
+#include <shapes/bounding_box.h>
+#include <shapes/bounding_box_algos.h>
+#include <shapes/generators.h>
+#include <shapes/path.h>
+#include <shapes/point_cloud.h>
+#include <shapes/shapes.h>
+#include <shapes/triangle.h>
+#include <stdutils/io.h>
+#include <stdutils/stats.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using scalar = double;
+
+void err_callback(stdutils::io::SeverityCode sev, std::string_view msg)
+{
+    std::cerr << stdutils::io::str_severity_code(sev) << ": " << msg << std::endl;
+}
+
+argagg::parser argparser{ {
+    { "help", { "-h", "--help" }, "Print usage note and exit", 0 },
+    { "primitives", { "-p", "--primitives" }, "Number of points, line vertices or triangles of each scene. (Default: 1000000)", 1 },
+    { "shapes", { "-s", "--shapes" }, "Comma-separated numbers of shapes the primitives are split into. (Default: 1,100,10000)", 1 },
+    { "frames", { "-f", "--frames" }, "Number of frames rendered per scene. (Default: 100)", 1 },
+    { "width", { "--width" }, "Width of the framebuffer. (Default: 1920)", 1 },
+    { "height", { "--height" }, "Height of the framebuffer. (Default: 1080)", 1 },
+    { "zoom", { "-z", "--zoom" }, "Zoom on the center of the scene: Above 1, part of the scene is out of view. (Default: 1)", 1 }
+} };
+
+void usage_notes(std::ostream& out)
+{
+    out << "Benchmark of the 2D renderer\n\n";
+    out << "The output is a CSV table with, for each scene: The size and the bandwidth of the upload of the buffers on the first frame,\n";
+    out << "then the medians of the CPU time to submit the draw calls and of the GPU time (timer queries) of the next frames, and the\n";
+    out << "average frame time, the GPU work included.\n\n";
+    out << "Options:\n\n";
+    out << argparser;
+}
+
+constexpr ColorData BackgroundColor = { 40.f / 255.f, 40.f / 255.f, 40.f / 255.f, 1.f };
+constexpr ColorData VertexColor = { 20.f / 255.f, 90.f / 255.f, 116.f / 255.f, 1.f };
+constexpr ColorData EdgeColor = { 91.f / 255.f, 94.f / 255.f, 137.f / 255.f, 1.f };
+constexpr ColorData FaceColor = { 80.f / 255.f, 82.f / 255.f, 105.f / 255.f, 1.f };
+
+enum class SceneType
+{
+    Points = 0,
+    PointDensity,                               // The points of the Points scene, colored by density
+    Lines,
+    Triangles
+};
+
+constexpr std::array<SceneType, 4> scene_types = { SceneType::Points, SceneType::PointDensity, SceneType::Lines, SceneType::Triangles };
+
+std::string_view to_string(SceneType type)
+{
+    switch (type)
+    {
+        case SceneType::Points:         return "points";
+        case SceneType::PointDensity:   return "point_density";
+        case SceneType::Lines:          return "lines";
+        case SceneType::Triangles:      return "triangles";
+    }
+    return "";
+}
+
+std::vector<std::size_t> parse_list(const std::string& str)
+{
+    std::vector<std::size_t> result;
+    std::istringstream iss(str);
+    std::string token;
+    while (std::getline(iss, token, ','))
+    {
+        const auto value = std::stoul(token);
+        if (value == 0) { throw std::invalid_argument("The numbers must be positive"); }
+        result.push_back(value);
+    }
+    return result;
+}
+
+// Regular mesh of the unit square with about nb_faces triangles
+shapes::Triangles2d<scalar> grid_mesh(std::size_t nb_faces)
+{
+    const auto side = static_cast<std::uint32_t>(std::max(1.0, std::round(std::sqrt(static_cast<double>(nb_faces) / 2.0))));
+    const scalar step = scalar{1} / static_cast<scalar>(side);
+    shapes::Triangles2d<scalar> result;
+    result.vertices.reserve(static_cast<std::size_t>(side + 1) * (side + 1));
+    for (std::uint32_t j = 0; j <= side; j++)
+        for (std::uint32_t i = 0; i <= side; i++)
+            result.vertices.emplace_back(static_cast<scalar>(i) * step, static_cast<scalar>(j) * step);
+    result.faces.reserve(2 * static_cast<std::size_t>(side) * side);
+    for (std::uint32_t j = 0; j < side; j++)
+        for (std::uint32_t i = 0; i < side; i++)
+        {
+            const std::uint32_t v = j * (side + 1) + i;
+            result.faces.emplace_back(v, v + 1, v + side + 2);
+            result.faces.emplace_back(v, v + side + 2, v + side + 1);
+        }
+    return result;
+}
+
+// The shapes are laid out on a square grid of cells, each one filled by a shape
+struct Scene
+{
+    std::vector<shapes::AllShapes<scalar>> all_shapes;
+    DrawCommands<scalar> draw_commands;
+    shapes::BoundingBox2d<float> bounding_box;
+};
+
+void build_scene(SceneType type, std::size_t nb_primitives, std::size_t nb_shapes, Scene& scene)
+{
+    const auto grid_side = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(nb_shapes))));
+    const std::size_t nb_primitives_per_shape = std::max(std::size_t{3}, nb_primitives / nb_shapes);
+    constexpr scalar cell_margin = scalar{0.05};
+    scene.all_shapes.clear();
+    scene.all_shapes.reserve(nb_shapes);
+    for (std::size_t shape_idx = 0; shape_idx < nb_shapes; shape_idx++)
+    {
+        const auto seed = static_cast<std::uint32_t>(shape_idx);
+        const auto offset = shapes::Vect2d<scalar>(static_cast<scalar>(shape_idx % grid_side), static_cast<scalar>(shape_idx / grid_side));
+        const auto to_cell = [&offset](auto& vertices) {
+            for (auto& p : vertices) { p = offset + ((scalar{1} - 2 * cell_margin) * p) + shapes::Vect2d<scalar>(cell_margin, cell_margin); }
+        };
+        switch (type)
+        {
+            case SceneType::Points:
+            case SceneType::PointDensity:
+            {
+                auto pc = shapes::generators::uniform_point_cloud<scalar>(nb_primitives_per_shape, seed);
+                to_cell(pc.vertices);
+                scene.all_shapes.emplace_back(std::move(pc));
+                break;
+            }
+            case SceneType::Lines:
+            {
+                auto pp = shapes::generators::random_polygon<scalar>(nb_primitives_per_shape, seed);
+                to_cell(pp.vertices);
+                scene.all_shapes.emplace_back(std::move(pp));
+                break;
+            }
+            case SceneType::Triangles:
+            {
+                auto tri = grid_mesh(nb_primitives_per_shape);
+                to_cell(tri.vertices);
+                scene.all_shapes.emplace_back(std::move(tri));
+                break;
+            }
+        }
+    }
+    scene.draw_commands.clear();
+    scene.draw_commands.reserve(nb_shapes);
+    for (const auto& shape : scene.all_shapes)
+    {
+        auto& draw_command = scene.draw_commands.emplace_back(shape);
+        draw_command.vertices.color = VertexColor;
+        draw_command.edges.color = EdgeColor;
+        draw_command.faces.color = FaceColor;
+    }
+    scene.bounding_box = shapes::BoundingBox2d<float>().add(0.f, 0.f).add(static_cast<float>(grid_side), static_cast<float>(grid_side));
+}
+
+// Only the primitives of the scene type are drawn: The vertices of the paths and the edges of the triangles are hidden
+DrawingOptions scene_drawing_options(SceneType type)
+{
+    DrawingOptions options;
+    const bool points = type == SceneType::Points || type == SceneType::PointDensity;
+    options.point_options = { points, 2.f, type == SceneType::PointDensity ? renderer::PointColor::Density : renderer::PointColor::Uniform };
+    options.path_options = { type == SceneType::Lines, 1.f };
+    options.surface_options = { type == SceneType::Triangles, 1.f, renderer::FaceColor::Uniform };
+    return options;
+}
+
+// Negative if there is no sample
+float median_or_negative(const std::vector<float>& values)
+{
+    return values.empty() ? -1.f : stdutils::stats::median<float>(values.cbegin(), values.cend());
+}
+
+struct Measurement
+{
+    std::size_t upload_bytes{0};
+    float upload_ms{0.f};
+    unsigned int draw_calls{0};
+    float cpu_submit_ms{0.f};
+    float gpu_ms{-1.f};
+    float frame_ms{0.f};
+};
+
+Measurement measure(renderer::Draw2D& draw_2d, const Scene& scene, const DrawingOptions& options, const Canvas<float>& canvas, unsigned int nb_frames)
+{
+    Measurement result;
+    const renderer::Flag::type flags = renderer::Flag::ViewportBackground;
+
+    // The draw list is built from scratch, then the first frame uploads all the buffers
+    update_opengl_draw_list(draw_2d.draw_list(), scene.draw_commands, true, options);
+    renderer::stable_sort_draw_commands(draw_2d.draw_list());
+    glFinish();
+    draw_2d.clear_framebuffer(BackgroundColor);
+    draw_2d.render(canvas, flags);
+    glFinish();
+    result.upload_bytes = draw_2d.frame_stats().upload_bytes;
+    result.upload_ms = draw_2d.frame_stats().update_buffers_ms;
+
+    // The next frames only issue the draw calls
+    std::vector<float> cpu_submit_ms;
+    std::vector<float> gpu_ms;
+    cpu_submit_ms.reserve(nb_frames);
+    gpu_ms.reserve(nb_frames);
+    float previous_gpu_ms = draw_2d.frame_stats().gpu_ms;
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int frame_idx = 0; frame_idx < nb_frames; frame_idx++)
+    {
+        draw_2d.clear_framebuffer(BackgroundColor);
+        draw_2d.render(canvas, flags);
+        const auto& stats = draw_2d.frame_stats();
+        cpu_submit_ms.push_back(stats.render_assets_ms);
+        result.draw_calls = stats.draw_calls;
+        if (stats.gpu_ms >= 0.f && stats.gpu_ms != previous_gpu_ms) { gpu_ms.push_back(stats.gpu_ms); }
+        previous_gpu_ms = stats.gpu_ms;
+    }
+    glFinish();
+    const std::chrono::duration<float, std::milli> duration = std::chrono::steady_clock::now() - start;
+    result.frame_ms = duration.count() / static_cast<float>(std::max(nb_frames, 1u));
+    result.cpu_submit_ms = median_or_negative(cpu_submit_ms);
+    result.gpu_ms = median_or_negative(gpu_ms);
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    argagg::parser_results args;
+    std::size_t nb_primitives = 0;
+    std::vector<std::size_t> shape_counts;
+    unsigned int nb_frames = 0;
+    int width = 0;
+    int height = 0;
+    float zoom = 1.f;
+    try
+    {
+        args = argparser.parse(argc, argv);
+        nb_primitives = args["primitives"].as<std::size_t>(1000000);
+        shape_counts = parse_list(args["shapes"].as<std::string>("1,100,10000"));
+        nb_frames = args["frames"].as<unsigned int>(100);
+        width = args["width"].as<int>(1920);
+        height = args["height"].as<int>(1080);
+        zoom = args["zoom"].as<float>(1.f);
+    }
+    catch (const std::exception& e)
+    {
+        usage_notes(std::cerr);
+        std::stringstream out;
+        out << "While parsing arguments: " << e.what();
+        err_callback(stdutils::io::Severity::EXCPT, out.str());
+        return EXIT_FAILURE;
+    }
+    if (args["help"])
+    {
+        usage_notes(std::cout);
+        return EXIT_SUCCESS;
+    }
+    if (nb_primitives == 0 || nb_frames == 0 || width <= 0 || height <= 0 || !(zoom > 0.f))
+    {
+        err_callback(stdutils::io::Severity::FATAL, "Invalid number of primitives or frames, size or zoom");
+        return EXIT_FAILURE;
+    }
+
+    const stdutils::io::ErrorHandler err_handler(err_callback);
+
+    // Hidden window, only for its OpenGL context. No vsync: The frames are not throttled by the display.
+    GLFWOptions glfw_options;
+    glfw_options.title = "bench_renderer";
+    glfw_options.enable_vsync = false;
+    glfw_options.visible = false;
+    bool any_fatal_err = false;
+    unsigned int back_framebuffer_id = 0;
+    GLFWWindowContext glfw_context = create_glfw_window_load_opengl(width, height, glfw_options, any_fatal_err, back_framebuffer_id, &err_handler);
+    if (any_fatal_err || glfw_context.window() == nullptr)
+        return EXIT_FAILURE;
+    const OffscreenFramebuffer framebuffer(width, height);
+    if (!framebuffer.complete())
+    {
+        err_handler(stdutils::io::Severity::FATAL, "Failed to create the offscreen framebuffer");
+        return EXIT_FAILURE;
+    }
+
+    // Everything is uploaded on the first frame, and the static layer cache would skip the rendering of the next frames
+    renderer::Draw2D::Settings renderer_settings;
+    renderer_settings.back_framebuffer_id = framebuffer.id();
+    renderer_settings.static_layer_cache = false;
+    renderer_settings.upload_bytes_per_frame = 0;
+
+    std::cout << "scene,nb_primitives,nb_shapes,zoom,upload_mb,upload_ms,upload_mb_per_s,draw_calls,frames,cpu_submit_ms,gpu_ms,frame_ms" << std::endl;
+    for (const auto type : scene_types)
+    {
+        const auto options = scene_drawing_options(type);
+        for (const auto nb_shapes : shape_counts)
+        {
+            // A new renderer for each scene, so that its GPU buffers start empty
+            renderer::Draw2D draw_2d(renderer_settings, &err_handler);
+            if (!draw_2d.initialized())
+            {
+                err_handler(stdutils::io::Severity::FATAL, "Failed to initialize the renderer");
+                return EXIT_FAILURE;
+            }
+            draw_2d.set_viewport_background_color(BackgroundColor);
+            draw_2d.init_framebuffer(width, height);
+
+            Scene scene;
+            build_scene(type, nb_primitives, nb_shapes, scene);
+            auto view_bb = scene.bounding_box;
+            shapes::scale_around_center_in_place(view_bb, 1.f / zoom);
+            const Canvas<float> canvas(0.f, 0.f, static_cast<float>(width), static_cast<float>(height), view_bb);
+
+            const auto meas = measure(draw_2d, scene, options, canvas, nb_frames);
+            const float upload_mb = static_cast<float>(meas.upload_bytes) / static_cast<float>(1 << 20);
+            std::cout << to_string(type) << ','
+                      << nb_primitives << ','
+                      << nb_shapes << ','
+                      << zoom << ','
+                      << upload_mb << ','
+                      << meas.upload_ms << ','
+                      << (meas.upload_ms > 0.f ? 1000.f * upload_mb / meas.upload_ms : 0.f) << ','
+                      << meas.draw_calls << ','
+                      << nb_frames << ','
+                      << meas.cpu_submit_ms << ','
+                      << meas.gpu_ms << ','
+                      << meas.frame_ms << std::endl;
+            if (gl_errors("bench_renderer", &err_handler))
+                return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,188 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <dt/dt_impl.h>
+#include <dt/dt_interface.h>
+#include <stdutils/io.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace delaunay {
+
+/**
+ * Automatic selection of the Delaunay implementation
+ *
+ * The reference implementation (see get_ref_impl()) is not the fastest one on every input. The "auto" selection picks an implementation
+ * from the features of the input: Its size, and the ratio of the vertices that belong to the constraints.
+ *
+ * If a profile is provided, the implementation is the fastest one on the profiled input that is the closest to the actual one: Same policy,
+ * and the least distance in (log2 of the number of vertices, constraint ratio). A profile is produced by the benchmark runner, see the
+ * options --save-selection-profile and --selection-profile of delaunay_batch.
+ *
+ * Otherwise, or if the profile has no measurement for the policy, a few built-in rules apply, then the reference implementation:
+ *  - A heavily constrained input (constraint ratio >= 0.5) is triangulated with CDT_fp64
+ *  - A small point cloud (<= 2048 vertices) is triangulated with CDT_fp32 if the interface is float. Otherwise, with CDT_spec (CDT_fp32,
+ *    then CDT_fp64 if its output is not valid)
+ *
+ * Only the registered implementations are selected.
+ */
+struct InputFeatures
+{
+    TriangulationPolicy policy{TriangulationPolicy::PointCloud};
+    std::size_t nb_vertices{0};
+    std::size_t nb_constraint_vertices{0};          // Vertices of the paths, holes and edges. Ignored by the PointCloud policy.
+
+    float constraint_ratio() const noexcept;
+};
+
+struct SelectionProfile
+{
+    struct Measurement
+    {
+        std::string algo_name;
+        InputFeatures features;
+        float median_ms{0.f};
+    };
+    std::vector<Measurement> measurements;
+};
+
+// Text format: One measurement per line, "<algo> <pc|cdt> <nb_vertices> <nb_constraint_vertices> <median_ms>". Lines starting with '#' are comments.
+SelectionProfile parse_selection_profile(std::istream& in, const stdutils::io::ErrorHandler& err_handler);
+void write_selection_profile(std::ostream& out, const SelectionProfile& profile);
+
+// Return an empty profile on error
+SelectionProfile load_selection_profile(const std::filesystem::path& filepath, const stdutils::io::ErrorHandler& err_handler);
+void save_selection_profile(const std::filesystem::path& filepath, const SelectionProfile& profile, const stdutils::io::ErrorHandler& err_handler);
+
+// The profile used by the functions below when none is passed, e.g. by delaunay::proximity_graphs(). Empty by default.
+// Not thread-safe: Should be set once at startup.
+void set_default_selection_profile(SelectionProfile profile);
+const SelectionProfile& default_selection_profile();
+
+// Name of the selected implementation, or an empty string if none is registered
+template <typename F, typename I = std::uint32_t>
+std::string select_impl_name(const InputFeatures& features, const SelectionProfile& profile = default_selection_profile());
+
+// Convenience function to build the selected implementation, similar to get_ref_impl()
+template <typename F, typename I = std::uint32_t>
+std::pair<std::string, std::unique_ptr<Interface<F, I>>> get_auto_impl(const InputFeatures& features, const stdutils::io::ErrorHandler* err_handler = nullptr, const SelectionProfile& profile = default_selection_profile());
+
+
+//
+//
+// Implementation
+//
+//
+
+
+namespace details {
+namespace auto_select {
+
+constexpr std::size_t small_point_cloud = 2048;
+constexpr float heavily_constrained = 0.5f;
+
+inline float distance(const InputFeatures& lhs, const InputFeatures& rhs)
+{
+    const auto log_size = [](std::size_t n) { return static_cast<float>(std::log2(static_cast<double>(std::max(n, std::size_t{1})))); };
+    return std::abs(log_size(lhs.nb_vertices) - log_size(rhs.nb_vertices)) + std::abs(lhs.constraint_ratio() - rhs.constraint_ratio());
+}
+
+template <typename F, typename I>
+bool is_registered(const std::string& name)
+{
+    const auto& impl_map = delaunay::details::get_impl_map<F, I>();
+    return impl_map.find(name) != impl_map.end();
+}
+
+// Fastest implementation on the closest profiled input. Empty if the profile has no matching measurement.
+template <typename F, typename I>
+std::string from_profile(const InputFeatures& features, const SelectionProfile& profile)
+{
+    float best_distance = std::numeric_limits<float>::max();
+    float best_ms = std::numeric_limits<float>::max();
+    std::string result;
+    for (const auto& measurement : profile.measurements)
+    {
+        if (measurement.features.policy != features.policy || !is_registered<F, I>(measurement.algo_name))
+            continue;
+        const float d = distance(measurement.features, features);
+        if (d < best_distance || (d == best_distance && measurement.median_ms < best_ms))
+        {
+            best_distance = d;
+            best_ms = measurement.median_ms;
+            result = measurement.algo_name;
+        }
+    }
+    return result;
+}
+
+template <typename F, typename I>
+std::string from_rules(const InputFeatures& features)
+{
+    std::string candidate;
+    if (features.policy == TriangulationPolicy::CDT && features.constraint_ratio() >= heavily_constrained)
+        candidate = "CDT_fp64";
+    else if (features.policy == TriangulationPolicy::PointCloud && features.nb_vertices <= small_point_cloud)
+        candidate = std::is_same_v<F, float> ? "CDT_fp32" : "CDT_spec";
+    return is_registered<F, I>(candidate) ? candidate : std::string();
+}
+
+} // namespace auto_select
+} // namespace details
+
+inline float InputFeatures::constraint_ratio() const noexcept
+{
+    if (policy == TriangulationPolicy::PointCloud || nb_vertices == 0)
+        return 0.f;
+    return static_cast<float>(std::min(nb_constraint_vertices, nb_vertices)) / static_cast<float>(nb_vertices);
+}
+
+template <typename F, typename I>
+std::string select_impl_name(const InputFeatures& features, const SelectionProfile& profile)
+{
+    std::string result = details::auto_select::from_profile<F, I>(features, profile);
+    if (result.empty()) { result = details::auto_select::from_rules<F, I>(features); }
+    if (result.empty()) { result = details::get_ref_impl<F, I>().name; }
+    return result;
+}
+
+template <typename F, typename I>
+std::pair<std::string, std::unique_ptr<Interface<F, I>>> get_auto_impl(const InputFeatures& features, const stdutils::io::ErrorHandler* err_handler, const SelectionProfile& profile)
+{
+    try
+    {
+        auto algo_name = select_impl_name<F, I>(features, profile);
+        return std::make_pair<std::string, std::unique_ptr<Interface<F, I>>>(
+            std::move(algo_name),
+            get_impl(details::get_impl_map<F, I>().at(algo_name), err_handler)
+        );
+    }
+    catch (const std::exception& e)
+    {
+        if (err_handler)
+        {
+            std::stringstream oss;
+            oss << "Exception in delaunay::get_auto_impl<>: " << e.what();
+            (*err_handler)(stdutils::io::Severity::EXCPT, oss.str());
+        }
+    }
+    return std::make_pair<std::string, std::unique_ptr<Interface<F, I>>>("", nullptr);
+}
+
+} // namespace delaunay
@@ -0,0 +1,140 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <dt/dt_impl.h>
+#include <dt/dt_interface.h>
+#include <graphs/index.h>
+#include <shapes/path.h>
+#include <shapes/point.h>
+#include <shapes/triangle.h>
+#include <stdutils/io.h>
+#include <stdutils/parallel.h>
+#include <stdutils/span.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace delaunay {
+
+// A polygon, its holes and the Steiner points inside, triangulated independently of the other groups of a batch
+template <typename F>
+struct PolygonGroup
+{
+    shapes::PointPath2d<F> boundary;
+    std::vector<shapes::PointPath2d<F>> holes;          // And the other constraints inside the boundary, e.g. open paths
+    shapes::Points2d<F> steiner;
+};
+
+/**
+ * Batch triangulation of many small independent polygons, e.g. the footprints of the buildings of a city map
+ *
+ * Each group is triangulated on its own, which is much faster than one constrained triangulation of all the paths. The groups are
+ * distributed dynamically to a pool of workers, each one reusing a single instance of the algorithm.
+ *
+ * The result combines the triangulations of the groups, in the order of the input: The vertices of a group follow those of the previous one,
+ * and so do its faces, whose indices are offset accordingly. A group that fails to triangulate, or whose boundary is empty, is reported and does
+ * not contribute to the result.
+ * The adjacency is only set if all the groups provide it.
+ */
+template <typename F, typename I = std::uint32_t>
+shapes::Triangles2d<F, I> triangulate_batch(const RegisteredImpl<F, I>& registered_impl, const std::vector<PolygonGroup<F>>& groups, TriangulationPolicy policy, const stdutils::io::ErrorHandler& err_handler, const stdutils::parallel::Policy& parallel_policy = stdutils::parallel::Policy());
+
+
+//
+//
+// Implementation
+//
+//
+
+
+template <typename F, typename I>
+shapes::Triangles2d<F, I> triangulate_batch(const RegisteredImpl<F, I>& registered_impl, const std::vector<PolygonGroup<F>>& groups, TriangulationPolicy policy, const stdutils::io::ErrorHandler& err_handler, const stdutils::parallel::Policy& parallel_policy)
+{
+    const std::size_t nb_groups = groups.size();
+    const std::size_t nb_workers = stdutils::parallel::nb_workers(parallel_policy, nb_groups);
+
+    // One instance of the algorithm per worker. The messages of a worker are forwarded once all the groups are done.
+    std::vector<stdutils::io::ErrorLog> logs(nb_workers);
+    std::vector<std::unique_ptr<Interface<F, I>>> algos(nb_workers);
+    for (std::size_t worker_idx = 0; worker_idx < nb_workers; worker_idx++)
+    {
+        const auto algo_err_handler = logs[worker_idx].handler();
+        algos[worker_idx] = get_impl(registered_impl, &algo_err_handler);
+        assert(algos[worker_idx]);
+    }
+
+    std::vector<shapes::Triangles2d<F, I>> triangulations(nb_groups);
+    stdutils::parallel::for_each_dynamic(parallel_policy, nb_groups, [&groups, &algos, &triangulations, policy](std::size_t worker_idx, std::size_t group_idx) {
+        const auto& group = groups[group_idx];
+        if (group.boundary.vertices.empty())
+            return;
+        std::size_t nb_points = group.boundary.vertices.size() + group.steiner.size();
+        for (const auto& hole : group.holes) { nb_points += hole.vertices.size(); }
+        auto& algo = *algos[worker_idx];
+        algo.clear();
+        algo.reserve(nb_points, group.holes.size() + 1);
+        algo.add_path(group.boundary);
+        for (const auto& hole : group.holes) { algo.add_hole(hole); }
+        if (!group.steiner.empty()) { algo.add_steiner(stdutils::make_const_span(group.steiner)); }
+        triangulations[group_idx] = algo.triangulate(policy);
+    });
+    for (const auto& log : logs) { log.forward(err_handler); }
+
+    // Offsets of the groups in the combined result
+    std::vector<std::size_t> vertex_offsets(nb_groups + 1, 0);
+    std::vector<std::size_t> face_offsets(nb_groups + 1, 0);
+    bool has_adjacency = nb_groups > 0;
+    for (std::size_t group_idx = 0; group_idx < nb_groups; group_idx++)
+    {
+        const auto& triangulation = triangulations[group_idx];
+        if (groups[group_idx].boundary.vertices.empty())
+        {
+            err_handler(stdutils::io::Severity::WARN, "triangulate_batch(): Skipped group " + std::to_string(group_idx) + ", whose boundary is empty");
+        }
+        else if (triangulation.faces.empty())
+        {
+            err_handler(stdutils::io::Severity::WARN, "triangulate_batch(): Failed to triangulate group " + std::to_string(group_idx));
+        }
+        vertex_offsets[group_idx + 1] = vertex_offsets[group_idx] + triangulation.vertices.size();
+        face_offsets[group_idx + 1] = face_offsets[group_idx] + triangulation.faces.size();
+        has_adjacency &= triangulation.faces.empty() || shapes::has_adjacency(triangulation);
+    }
+
+    shapes::Triangles2d<F, I> result;
+    result.vertices.resize(vertex_offsets.back());
+    result.faces.resize(face_offsets.back());
+    if (has_adjacency) { result.adjacency.resize(face_offsets.back()); }
+    stdutils::parallel::for_each_chunk(parallel_policy, nb_groups, [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t group_idx = begin_idx; group_idx < end_idx; group_idx++)
+        {
+            const auto& triangulation = triangulations[group_idx];
+            const auto vertex_offset = static_cast<I>(vertex_offsets[group_idx]);
+            const auto face_offset = static_cast<I>(face_offsets[group_idx]);
+            std::copy(triangulation.vertices.cbegin(), triangulation.vertices.cend(), result.vertices.begin() + static_cast<std::ptrdiff_t>(vertex_offsets[group_idx]));
+            for (std::size_t face_idx = 0; face_idx < triangulation.faces.size(); face_idx++)
+            {
+                auto& face = result.faces[face_offsets[group_idx] + face_idx];
+                const auto& group_face = triangulation.faces[face_idx];
+                for (std::size_t k = 0; k < 3; k++) { face[k] = static_cast<I>(group_face[k] + vertex_offset); }
+                if (has_adjacency)
+                {
+                    auto& adjacency = result.adjacency[face_offsets[group_idx] + face_idx];
+                    const auto& group_adjacency = triangulation.adjacency[face_idx];
+                    for (std::size_t k = 0; k < 3; k++)
+                    {
+                        adjacency[k] = graphs::is_defined(group_adjacency[k]) ? static_cast<I>(group_adjacency[k] + face_offset) : group_adjacency[k];
+                    }
+                }
+            }
+        }
+    });
+    assert(shapes::is_valid(result));
+    return result;
+}
+
+} // namespace delaunay
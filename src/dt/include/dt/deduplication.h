@@ -0,0 +1,200 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <dt/batch_triangulation.h>
+#include <graphs/graph.h>
+#include <graphs/graph_algos.h>
+#include <graphs/index.h>
+#include <shapes/edge.h>
+#include <shapes/path.h>
+#include <shapes/point.h>
+#include <stdutils/parallel.h>
+#include <stdutils/profiler.h>
+#include <stdutils/span.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace delaunay {
+
+/**
+ * Removal of the duplicated input points, before a triangulation
+ *
+ * The implementations do not handle the duplicated vertices the same way: Some merge them, some warn, and poly2tri may fail. This pre-pass
+ * merges them upfront. The points are sorted concurrently along (x, y), then the runs of equal points are merged into their first occurrence.
+ * The points kept are in the order of their first occurrence, and remap[k] is the output index of the input point k.
+ *
+ * With epsilon > 0, the points are snapped to a grid of step epsilon first: Two points in the same cell of the grid are duplicates. Note that
+ * two points closer than epsilon are not merged if they lie on both sides of a line of the grid. The coordinates kept are those of the first
+ * occurrence, not snapped. Like shapes::less, -0.0 and +0.0 are equal.
+ */
+template <typename F, typename I = std::uint32_t>
+struct DeduplicatedPoints
+{
+    shapes::Points2d<F> points;
+    std::vector<I> remap;
+};
+
+template <typename F, typename I = std::uint32_t>
+DeduplicatedPoints<F, I> deduplicate_points(const stdutils::parallel::Policy& policy, stdutils::Span<const shapes::Point2d<F>> points, F epsilon = F{0});
+
+// Merge the duplicated vertices of an edge soup, e.g. the junctions of a PSLG, and remap the edges. The loops and the duplicated edges are dropped.
+template <typename F, typename I>
+shapes::Edges2d<F, I> deduplicate(const stdutils::parallel::Policy& policy, const shapes::Edges2d<F, I>& edges, F epsilon = F{0});
+
+// Remove the consecutive duplicates along the paths, and the Steiner points that duplicate another vertex of the group.
+// The paths reduced to a point are removed, the boundary being left empty (see triangulate_batch), and the closed paths reduced to a segment are open.
+template <typename F>
+PolygonGroup<F> deduplicate(const stdutils::parallel::Policy& policy, const PolygonGroup<F>& group, F epsilon = F{0});
+
+
+//
+//
+// Implementation
+//
+//
+
+
+namespace details {
+namespace dedup {
+
+template <typename F>
+shapes::Point2d<F> key(const shapes::Point2d<F>& p, F epsilon)
+{
+    if (epsilon > F{0})
+        return shapes::Point2d<F>(std::floor(p.x / epsilon), std::floor(p.y / epsilon));
+    return shapes::Point2d<F>(p.x + F{0}, p.y + F{0});          // -0.0 + 0.0 == +0.0
+}
+
+} // namespace dedup
+} // namespace details
+
+template <typename F, typename I>
+DeduplicatedPoints<F, I> deduplicate_points(const stdutils::parallel::Policy& policy, stdutils::Span<const shapes::Point2d<F>> points, F epsilon)
+{
+    STDUTILS_PROFILE_ZONE("delaunay::deduplicate_points");
+    const std::size_t nb_points = points.size();
+    assert(nb_points == 0 || nb_points - 1 <= static_cast<std::size_t>(graphs::IndexTraits<I>::max_valid_index()));
+    DeduplicatedPoints<F, I> result;
+    result.remap.resize(nb_points);
+    if (nb_points == 0)
+        return result;
+
+    std::vector<shapes::Point2d<F>> keys(nb_points);
+    stdutils::parallel::for_each_chunk(policy, nb_points, [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++) { keys[idx] = details::dedup::key(points[idx], epsilon); }
+    });
+    std::vector<I> order(nb_points);
+    std::iota(order.begin(), order.end(), I{0});
+    stdutils::parallel::sort(policy, order.begin(), order.end(), [&keys](I lhs, I rhs) {
+        const auto& a = keys[lhs];
+        const auto& b = keys[rhs];
+        return a.x < b.x || (a.x == b.x && (a.y < b.y || (a.y == b.y && lhs < rhs)));
+    });
+
+    // The first occurrence of each run of duplicates is its lowest index
+    std::vector<I> first_occurrence(nb_points);
+    for (std::size_t idx = 0; idx < nb_points; idx++)
+    {
+        const I p = order[idx];
+        first_occurrence[p] = (idx > 0 && keys[order[idx - 1]] == keys[p]) ? first_occurrence[order[idx - 1]] : p;
+    }
+    for (std::size_t idx = 0; idx < nb_points; idx++)
+    {
+        if (first_occurrence[idx] == static_cast<I>(idx))
+        {
+            result.remap[idx] = static_cast<I>(result.points.size());
+            result.points.push_back(points[idx]);
+        }
+        else
+        {
+            assert(static_cast<std::size_t>(first_occurrence[idx]) < idx);
+            result.remap[idx] = result.remap[first_occurrence[idx]];
+        }
+    }
+    return result;
+}
+
+template <typename F, typename I>
+shapes::Edges2d<F, I> deduplicate(const stdutils::parallel::Policy& policy, const shapes::Edges2d<F, I>& edges, F epsilon)
+{
+    STDUTILS_PROFILE_ZONE("delaunay::deduplicate_edges");
+    auto dedup = deduplicate_points<F, I>(policy, stdutils::make_const_span(edges.vertices), epsilon);
+    shapes::Edges2d<F, I> result;
+    result.vertices = std::move(dedup.points);
+    result.indices.reserve(edges.indices.size());
+    for (const auto& e : edges.indices)
+    {
+        const graphs::Edge<I> remapped(dedup.remap[e.orig()], dedup.remap[e.dest()]);
+        if (!graphs::is_loop(remapped)) { result.indices.push_back(graphs::ordered_edge(remapped)); }
+    }
+    stdutils::parallel::sort(policy, result.indices.begin(), result.indices.end(), [](const auto& lhs, const auto& rhs) { return lhs < rhs; });
+    result.indices.erase(std::unique(result.indices.begin(), result.indices.end()), result.indices.end());
+    return result;
+}
+
+template <typename F>
+PolygonGroup<F> deduplicate(const stdutils::parallel::Policy& policy, const PolygonGroup<F>& group, F epsilon)
+{
+    STDUTILS_PROFILE_ZONE("delaunay::deduplicate_group");
+    using I = std::uint32_t;
+    using Path = shapes::PointPath2d<F>;
+
+    // All the vertices of the group: The boundary, the holes, then the Steiner points
+    std::vector<const Path*> paths;
+    paths.push_back(&group.boundary);
+    for (const auto& hole : group.holes) { paths.push_back(&hole); }
+    shapes::Points2d<F> all_points;
+    for (const auto* pp : paths) { all_points.insert(all_points.end(), pp->vertices.cbegin(), pp->vertices.cend()); }
+    all_points.insert(all_points.end(), group.steiner.cbegin(), group.steiner.cend());
+    const auto dedup = deduplicate_points<F, I>(policy, stdutils::make_const_span(all_points), epsilon);
+
+    PolygonGroup<F> result;
+    std::vector<bool> is_used(dedup.points.size(), false);
+    std::size_t in_idx = 0;
+    for (std::size_t path_idx = 0; path_idx < paths.size(); path_idx++)
+    {
+        const Path& pp = *paths[path_idx];
+        Path out;
+        std::vector<I> out_indices;
+        for (std::size_t idx = 0; idx < pp.vertices.size(); idx++, in_idx++)
+        {
+            const I v = dedup.remap[in_idx];
+            if (!out_indices.empty() && out_indices.back() == v)
+                continue;
+            out_indices.push_back(v);
+            out.vertices.push_back(dedup.points[v]);
+        }
+        if (pp.closed && out_indices.size() > 1 && out_indices.back() == out_indices.front())
+        {
+            out_indices.pop_back();
+            out.vertices.pop_back();
+        }
+        if (out.vertices.size() < 2)
+            continue;
+        for (const I v : out_indices) { is_used[v] = true; }
+        out.closed = pp.closed && out.vertices.size() > 2;
+        if (path_idx == 0)
+            result.boundary = std::move(out);
+        else
+            result.holes.push_back(std::move(out));
+    }
+    for (std::size_t idx = 0; idx < group.steiner.size(); idx++, in_idx++)
+    {
+        const I v = dedup.remap[in_idx];
+        if (is_used[v])
+            continue;
+        is_used[v] = true;
+        result.steiner.push_back(dedup.points[v]);
+    }
+    assert(in_idx == all_points.size());
+    return result;
+}
+
+} // namespace delaunay
@@ -0,0 +1,254 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <dt/batch_triangulation.h>
+#include <dt/dt_impl.h>
+#include <dt/dt_interface.h>
+#include <shapes/path.h>
+#include <shapes/point.h>
+#include <shapes/triangle.h>
+#include <stdutils/io.h>
+#include <stdutils/parallel.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace delaunay {
+
+/**
+ * Domain decomposition of a constrained triangulation
+ *
+ * The domain of a constrained triangulation is defined by its closed paths with the even-odd rule, as in the implementations: A path at an even
+ * depth of nesting is an outer boundary, and a path at an odd depth is a hole of its parent. The closed paths are constraints, therefore no
+ * triangle of the CDT crosses them: The CDT inside an outer boundary only depends on its holes and on the vertices inside. Cutting the domain
+ * along its outer boundaries gives independent groups, e.g. the islands of a map, and their triangulations need no stitching.
+ *
+ * The open paths and the Steiner points are assigned to the group they lie in. Those in a hole or outside of the domain are dropped, since
+ * they are not part of any triangle of the constrained triangulation.
+ *
+ * Closed paths that cross or touch each other have no consistent nesting. If it is detected, the error is reported and the result is empty.
+ *
+ * Note that a domain made of one large polygon is not split: It is triangulated by a single instance of the algorithm.
+ */
+template <typename F>
+std::vector<PolygonGroup<F>> decompose_domain(const std::vector<shapes::PointPath2d<F>>& paths, const shapes::Points2d<F>& steiner_points, const stdutils::io::ErrorHandler& err_handler, const stdutils::parallel::Policy& parallel_policy = stdutils::parallel::Policy());
+
+// Constrained triangulation of the domain, with the independent groups of decompose_domain() triangulated concurrently. See triangulate_batch().
+template <typename F, typename I = std::uint32_t>
+shapes::Triangles2d<F, I> triangulate_decomposed_domain(const RegisteredImpl<F, I>& registered_impl, const std::vector<shapes::PointPath2d<F>>& paths, const shapes::Points2d<F>& steiner_points, const stdutils::io::ErrorHandler& err_handler, const stdutils::parallel::Policy& parallel_policy = stdutils::parallel::Policy());
+
+
+//
+//
+// Implementation
+//
+//
+
+
+namespace details {
+namespace decomposition {
+
+constexpr std::size_t NoLoop = std::numeric_limits<std::size_t>::max();
+
+// Even-odd point location in a set of closed paths, which do not cross each other.
+// The edges are bucketed by horizontal bands, and a query counts the crossings of a ray cast from the point towards +x.
+template <typename F>
+class LoopLocator
+{
+public:
+    explicit LoopLocator(const std::vector<const shapes::PointPath2d<F>*>& loops);
+
+    // Indices of the loops containing p, in increasing order. The loop ignored_loop, e.g. the one p is a vertex of, is not tested.
+    void containing_loops(const shapes::Point2d<F>& p, std::vector<std::size_t>& result, std::size_t ignored_loop = NoLoop) const;
+
+private:
+    struct Edge
+    {
+        shapes::Point2d<F> a;
+        shapes::Point2d<F> b;
+        std::size_t loop_idx;
+    };
+
+    std::size_t band(F y) const;
+
+    F m_min_y;
+    F m_band_height;
+    std::vector<std::vector<Edge>> m_bands;
+};
+
+template <typename F>
+LoopLocator<F>::LoopLocator(const std::vector<const shapes::PointPath2d<F>*>& loops)
+    : m_min_y(std::numeric_limits<F>::max())
+    , m_band_height(F{1})
+    , m_bands()
+{
+    std::size_t nb_edges = 0;
+    F max_y = std::numeric_limits<F>::lowest();
+    for (const auto* loop : loops)
+    {
+        nb_edges += loop->vertices.size();
+        for (const auto& p : loop->vertices) { m_min_y = std::min(m_min_y, p.y); max_y = std::max(max_y, p.y); }
+    }
+    if (nb_edges == 0)
+        return;
+    const auto nb_bands = std::clamp<std::size_t>(static_cast<std::size_t>(std::sqrt(static_cast<double>(nb_edges))), 1, 4096);
+    if (max_y > m_min_y) { m_band_height = (max_y - m_min_y) / static_cast<F>(nb_bands); }
+    m_bands.resize(nb_bands);
+    for (std::size_t loop_idx = 0; loop_idx < loops.size(); loop_idx++)
+    {
+        const auto& vertices = loops[loop_idx]->vertices;
+        for (std::size_t idx = 0; idx < vertices.size(); idx++)
+        {
+            const auto& a = vertices[idx];
+            const auto& b = vertices[(idx + 1) % vertices.size()];
+            const std::size_t last_band = band(std::max(a.y, b.y));
+            for (std::size_t band_idx = band(std::min(a.y, b.y)); band_idx <= last_band; band_idx++) { m_bands[band_idx].push_back(Edge{ a, b, loop_idx }); }
+        }
+    }
+}
+
+template <typename F>
+std::size_t LoopLocator<F>::band(F y) const
+{
+    assert(!m_bands.empty());
+    const F pos = std::floor((y - m_min_y) / m_band_height);
+    return pos <= F{0} ? 0 : std::min(static_cast<std::size_t>(pos), m_bands.size() - 1);
+}
+
+template <typename F>
+void LoopLocator<F>::containing_loops(const shapes::Point2d<F>& p, std::vector<std::size_t>& result, std::size_t ignored_loop) const
+{
+    result.clear();
+    if (m_bands.empty())
+        return;
+    for (const auto& edge : m_bands[band(p.y)])
+    {
+        if (edge.loop_idx == ignored_loop || (edge.a.y > p.y) == (edge.b.y > p.y))
+            continue;
+        const F x = edge.a.x + (p.y - edge.a.y) * (edge.b.x - edge.a.x) / (edge.b.y - edge.a.y);
+        if (p.x < x) { result.push_back(edge.loop_idx); }
+    }
+
+    // Keep the loops crossed an odd number of times
+    std::sort(result.begin(), result.end());
+    std::size_t out_idx = 0;
+    for (std::size_t idx = 0; idx < result.size();)
+    {
+        std::size_t next_idx = idx + 1;
+        while (next_idx < result.size() && result[next_idx] == result[idx]) { next_idx++; }
+        if ((next_idx - idx) % 2 == 1) { result[out_idx++] = result[idx]; }
+        idx = next_idx;
+    }
+    result.resize(out_idx);
+}
+
+} // namespace decomposition
+} // namespace details
+
+template <typename F>
+std::vector<PolygonGroup<F>> decompose_domain(const std::vector<shapes::PointPath2d<F>>& paths, const shapes::Points2d<F>& steiner_points, const stdutils::io::ErrorHandler& err_handler, const stdutils::parallel::Policy& parallel_policy)
+{
+    using details::decomposition::NoLoop;
+    std::vector<const shapes::PointPath2d<F>*> loops;
+    std::vector<const shapes::PointPath2d<F>*> open_paths;
+    for (const auto& pp : paths)
+    {
+        if (pp.closed && pp.vertices.size() >= 3)
+            loops.push_back(&pp);
+        else if (!pp.vertices.empty())
+            open_paths.push_back(&pp);
+    }
+    const details::decomposition::LoopLocator<F> locator(loops);
+
+    // Nesting of the loops
+    std::vector<std::size_t> depth(loops.size(), 0);
+    std::vector<std::vector<std::size_t>> containing(loops.size());
+    stdutils::parallel::for_each_chunk(parallel_policy, loops.size(), [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t loop_idx = begin_idx; loop_idx < end_idx; loop_idx++)
+        {
+            locator.containing_loops(loops[loop_idx]->vertices.front(), containing[loop_idx], loop_idx);
+            depth[loop_idx] = containing[loop_idx].size();
+        }
+    });
+    const auto deepest = [&depth](const std::vector<std::size_t>& loop_indices) {
+        const auto it = std::max_element(loop_indices.cbegin(), loop_indices.cend(), [&depth](std::size_t lhs, std::size_t rhs) { return depth[lhs] < depth[rhs]; });
+        return it == loop_indices.cend() ? NoLoop : *it;
+    };
+
+    // The parent of a loop, i.e. the deepest loop containing it, is one level up
+    std::vector<std::size_t> parent(loops.size(), NoLoop);
+    for (std::size_t loop_idx = 0; loop_idx < loops.size(); loop_idx++)
+    {
+        if (depth[loop_idx] == 0)
+            continue;
+        parent[loop_idx] = deepest(containing[loop_idx]);
+        if (parent[loop_idx] == NoLoop || depth[parent[loop_idx]] + 1 != depth[loop_idx])
+        {
+            err_handler(stdutils::io::Severity::ERR, "decompose_domain(): Inconsistent nesting of the closed paths, which cross or touch each other");
+            return std::vector<PolygonGroup<F>>();
+        }
+    }
+
+    // One group per outer boundary
+    std::vector<PolygonGroup<F>> result;
+    std::vector<std::size_t> group_of_loop(loops.size(), NoLoop);
+    for (std::size_t loop_idx = 0; loop_idx < loops.size(); loop_idx++)
+    {
+        if (depth[loop_idx] % 2 == 0)
+        {
+            group_of_loop[loop_idx] = result.size();
+            result.emplace_back().boundary = *loops[loop_idx];
+        }
+    }
+    for (std::size_t loop_idx = 0; loop_idx < loops.size(); loop_idx++)
+    {
+        if (depth[loop_idx] % 2 == 1)
+        {
+            assert(group_of_loop[parent[loop_idx]] != NoLoop);
+            result[group_of_loop[parent[loop_idx]]].holes.push_back(*loops[loop_idx]);
+        }
+    }
+
+    // Group of a point of the domain, or NoLoop
+    const auto group_of_point = [&locator, &depth, &deepest, &group_of_loop](const shapes::Point2d<F>& p, std::vector<std::size_t>& buffer) {
+        locator.containing_loops(p, buffer);
+        const std::size_t loop_idx = deepest(buffer);
+        return loop_idx != NoLoop && depth[loop_idx] % 2 == 0 ? group_of_loop[loop_idx] : NoLoop;
+    };
+    {
+        std::vector<std::size_t> buffer;
+        for (const auto* pp : open_paths)
+        {
+            const std::size_t group_idx = group_of_point(pp->vertices.front(), buffer);
+            if (group_idx != NoLoop) { result[group_idx].holes.push_back(*pp); }
+        }
+    }
+    std::vector<std::size_t> steiner_groups(steiner_points.size(), NoLoop);
+    stdutils::parallel::for_each_chunk(parallel_policy, steiner_points.size(), [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        std::vector<std::size_t> buffer;
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++) { steiner_groups[idx] = group_of_point(steiner_points[idx], buffer); }
+    });
+    for (std::size_t idx = 0; idx < steiner_points.size(); idx++)
+    {
+        if (steiner_groups[idx] != NoLoop) { result[steiner_groups[idx]].steiner.push_back(steiner_points[idx]); }
+    }
+    return result;
+}
+
+template <typename F, typename I>
+shapes::Triangles2d<F, I> triangulate_decomposed_domain(const RegisteredImpl<F, I>& registered_impl, const std::vector<shapes::PointPath2d<F>>& paths, const shapes::Points2d<F>& steiner_points, const stdutils::io::ErrorHandler& err_handler, const stdutils::parallel::Policy& parallel_policy)
+{
+    const auto groups = decompose_domain(paths, steiner_points, err_handler, parallel_policy);
+    if (groups.empty() && std::none_of(paths.cbegin(), paths.cend(), [](const auto& pp) { return pp.closed && pp.vertices.size() >= 3; }))
+    {
+        err_handler(stdutils::io::Severity::WARN, "triangulate_decomposed_domain(): The domain is empty. There must be at least one closed path.");
+    }
+    return triangulate_batch(registered_impl, groups, TriangulationPolicy::CDT, err_handler, parallel_policy);
+}
+
+} // namespace delaunay
@@ -0,0 +1,94 @@
+/* Copyright (c) 2024 Pierre DEJOUE */
+/* This code is distributed under the terms of the MIT License */
+#ifndef DT_C_H
+#define DT_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * C interface of the triangulation libraries (see delaunay::Interface<double, uint32_t>)
+ *
+ * The input vertices are read from raw pointers to the coordinates, with a stride between two consecutive vertices, and the output is copied
+ * to arrays owned by the caller: Call dt_get_faces() with a null array to query the size, allocate, then call it again. A tightly packed
+ * input (stride of 2 * sizeof(double), aligned as a double) is passed as it is to the implementation, which keeps its own copy of the
+ * vertices. Any other input is gathered in a buffer of the handle, reused from one call to the next.
+ *
+ * A handle is reused for several triangulations with dt_clear(), which keeps the capacity of its buffers. A handle must not be used
+ * concurrently by several threads, but distinct handles can.
+ *
+ * The functions do not throw: They return a status, and the message of the latest error is available with dt_last_error().
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct dt_triangulation dt_triangulation;
+
+typedef enum dt_status
+{
+    DT_OK = 0,
+    DT_INVALID_ARGUMENT,
+    DT_NO_RESULT,                       /* dt_triangulate() was not called, or failed, since the latest input */
+    DT_BUFFER_TOO_SMALL,
+    DT_TRIANGULATION_FAILED,
+    DT_OUT_OF_MEMORY,
+    DT_INTERNAL_ERROR
+} dt_status;
+
+typedef enum dt_policy
+{
+    DT_POLICY_POINT_CLOUD = 0,          /* Delaunay triangulation of all the vertices, the paths are not constraints */
+    DT_POLICY_CDT = 1                   /* Constrained Delaunay triangulation, with the holes removed */
+} dt_policy;
+
+/* Register the implementations, once per process before the first handle. Return a non-zero value on success. */
+int dt_register_all_implementations(void);
+
+/* Names of the registered implementations. Return null if idx is out of range. */
+size_t dt_nb_implementations(void);
+const char* dt_implementation_name(size_t idx);
+
+/* Return null if the implementation is unknown. A null name selects the reference implementation. */
+dt_triangulation* dt_create(const char* impl_name);
+void dt_destroy(dt_triangulation* handle);
+
+/* Message of the latest error of the handle, or an empty string. Valid until the next call with the handle. */
+const char* dt_last_error(const dt_triangulation* handle);
+
+/* Remove the input and the result, but keep the capacity of the buffers */
+dt_status dt_clear(dt_triangulation* handle);
+
+/* Optional: Size the buffers for the input of a job, its number of vertices and its number of constraints (paths and holes) */
+dt_status dt_reserve(dt_triangulation* handle, size_t nb_vertices, size_t nb_constraints);
+
+/* xy points to the x coordinate of the first vertex, followed by its y coordinate. stride is in bytes, 0 for tightly packed vertices. */
+dt_status dt_add_path(dt_triangulation* handle, const double* xy, size_t nb_vertices, size_t stride, int closed);
+dt_status dt_add_hole(dt_triangulation* handle, const double* xy, size_t nb_vertices, size_t stride, int closed);
+dt_status dt_add_steiner(dt_triangulation* handle, const double* xy, size_t nb_vertices, size_t stride);
+
+/*
+ * The input is consumed, its vertices being moved to the result instead of being copied. The result is kept in the handle until the next
+ * input, see dt_get_faces() and dt_get_vertices(): The next call to dt_add_*() starts a new input.
+ */
+dt_status dt_triangulate(dt_triangulation* handle, dt_policy policy);
+
+/*
+ * Copy the faces of the result, three vertex indices each, to faces (capacity in number of faces). The number of faces is written to
+ * nb_faces. If faces is null, only the size is queried. If the capacity is too small, nothing is copied and DT_BUFFER_TOO_SMALL is returned.
+ */
+dt_status dt_get_faces(const dt_triangulation* handle, uint32_t* faces, size_t capacity, size_t* nb_faces);
+
+/*
+ * Same as above with the vertices of the result, indexed by the faces, written with the given stride in bytes (0 for tightly packed
+ * vertices). They are the input vertices in the order of the input (see delaunay::Interface::set_vertex_order), therefore a caller that
+ * keeps its input usually only needs the faces.
+ */
+dt_status dt_get_vertices(const dt_triangulation* handle, double* xy, size_t capacity, size_t stride, size_t* nb_vertices);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DT_C_H */
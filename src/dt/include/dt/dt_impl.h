@@ -131,9 +131,10 @@ std::unique_ptr<Interface<F, I>> get_impl(const RegisteredImpl<F, I>& registered
 
     // This handler is copied by the Interface<F, I> ctor
     stdutils::io::ErrorHandler err_handler_with_algo_name = [err_handler_cpy = *err_handler, &registered_impl](stdutils::io::SeverityCode code, stdutils::io::ErrorMessage msg) {
-        std::stringstream out;
-        out << registered_impl.name << ": " << msg;
-        err_handler_cpy(code, out.str());
+        std::string out;
+        out.reserve(registered_impl.name.size() + 2 + msg.size());
+        out.append(registered_impl.name).append(": ").append(msg);
+        err_handler_cpy(code, out);
     };
     return registered_impl.impl_factory(&err_handler_with_algo_name);
 }
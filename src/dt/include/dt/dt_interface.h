@@ -2,14 +2,34 @@
 // This code is distributed under the terms of the MIT License
 #pragma once
 
+#include <dt/validation.h>
+#include <shapes/edge.h>
 #include <shapes/path.h>
+#include <shapes/path_algos.h>
+#include <shapes/point.h>
 #include <shapes/point_cloud.h>
+#include <shapes/point_order.h>
 #include <shapes/triangle.h>
+#include <shapes/triangle_algos.h>
+#include <stdutils/arena.h>
+#include <stdutils/chrono.h>
 #include <stdutils/io.h>
+#include <stdutils/memory.h>
+#include <stdutils/parallel.h>
+#include <stdutils/profiler.h>
+#include <stdutils/span.h>
 
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <memory>
+#include <optional>
 #include <ostream>
+#include <utility>
+#include <vector>
 
 namespace delaunay {
 
@@ -21,26 +41,209 @@ enum class TriangulationPolicy
 
 std::ostream& operator<<(std::ostream& out, TriangulationPolicy policy);
 
+// Order in which the Steiner points are handed over to the implementation
+enum class VertexOrder
+{
+    AsProvided,
+    Hilbert,            // Along a Hilbert curve: Best memory locality
+    BRIO,               // Biased Randomized Insertion Order: Rounds of random points, each one along a Hilbert curve
+};
+
+std::ostream& operator<<(std::ostream& out, VertexOrder order);
+
+/**
+ * Cooperative cancellation of a triangulation
+ *
+ * The token is cancelled either explicitly with cancel(), which can be called from another thread, or once its deadline
+ * has passed. The implementations check the token between the steps of the computation, so the triangulation stops
+ * at the next check, not immediately.
+ */
+class CancellationToken
+{
+public:
+    using Duration = std::chrono::steady_clock::duration;
+
+    CancellationToken() = default;
+    explicit CancellationToken(Duration timeout) : m_cancelled(false), m_deadline(timeout) {}
+
+    void cancel() noexcept { m_cancelled = true; }
+    bool is_cancelled() const noexcept { return m_cancelled || has_timed_out(); }
+    bool has_timed_out() const noexcept { return m_deadline.has_value() && m_deadline->has_expired(); }
+
+private:
+    std::atomic<bool> m_cancelled{false};
+    std::optional<stdutils::chrono::Timeout<Duration>> m_deadline;
+};
+
+// Thrown by the implementations when the token is cancelled. Caught by Interface::triangulate().
+class Cancelled : public std::exception
+{
+public:
+    explicit Cancelled(bool timeout) : m_timeout(timeout) {}
+    const char* what() const noexcept override { return m_timeout ? "The triangulation has timed out" : "The triangulation was cancelled"; }
+    bool timeout() const noexcept { return m_timeout; }
+private:
+    bool m_timeout;
+};
+
+// Duration of the phases of a triangulation, in the order they were run
+struct TimingReport
+{
+    struct Phase
+    {
+        const char* name;                           // Static string of the implementation, e.g. "CDT::insertVertices"
+        float duration_ms;
+    };
+    std::vector<Phase> phases;
+};
+
 template <typename F, typename I>
 class Interface
 {
 public:
     using scalar = F;
     using index = I;
+    using Points = stdutils::Span<const shapes::Point2d<F>>;
 
     Interface(const stdutils::io::ErrorHandler* err_handler);
     virtual ~Interface() = default;
 
-    virtual void add_path(const shapes::PointPath2d<F>& pp) = 0;
-    virtual void add_hole(const shapes::PointPath2d<F>& pp) = 0;
-    virtual void add_steiner(const shapes::PointCloud2d<F>& pc) = 0;
+    // Spatial sort of the Steiner points, applied by the subsequent calls to add_steiner(). The paths and the holes are never reordered.
+    // The output of the triangulation is remapped to the order of the input, whatever the setting.
+    void set_vertex_order(VertexOrder order) noexcept { m_vertex_order = order; }
+
+    // Renumbering of the output of the triangulate functions along a Hilbert curve, for the locality of the downstream passes over its
+    // faces and vertices (see shapes::renumber_along_hilbert_curve). The output is then not in the order of the input: The permutation
+    // applied to the latest output is available with output_permutation(), empty if the renumbering is disabled. Disabled by default.
+    void set_output_renumbering(bool enabled) noexcept { m_output_renumbering = enabled; }
+    const shapes::MeshPermutation<I>& output_permutation() const noexcept { return m_output_permutation; }
+
+    // The input vertices are copied once, in the implementation. The spans need not outlive the calls.
+    void add_path(const shapes::PointPath2d<F>& pp);
+    void add_path(Points vertices, bool closed);
+    void add_hole(const shapes::PointPath2d<F>& pp);
+    void add_hole(Points vertices, bool closed);
+    void add_steiner(const shapes::PointCloud2d<F>& pc);
+    void add_steiner(Points vertices);
+
+    // Constraint edges given as an edge soup, e.g. a PSLG. The implementations that accept segment lists insert the edges as they are.
+    // The others add the paths of the soup (see graphs::extract_paths): The first one as a path, the next ones as holes.
+    void add_edges(const shapes::Edges2d<F, I>& edges);
 
-    shapes::Triangles2d<F, I> triangulate(TriangulationPolicy policy) const noexcept;
+    // If the token is cancelled during the computation, the output is empty
+    shapes::Triangles2d<F, I> triangulate(TriangulationPolicy policy, const CancellationToken* token = nullptr) const noexcept;
+
+    // Same as triangulate(), except that the input vertices are moved to the output instead of being copied.
+    // On success, the instance is left without input and should not be triangulated again.
+    shapes::Triangles2d<F, I> triangulate_and_release(TriangulationPolicy policy, const CancellationToken* token = nullptr) noexcept;
+
+    // Incremental triangulation: Add the Steiner points to the input, and triangulate.
+    // The implementations that support it keep their state alive from one call to the next, so that a call only inserts the new points
+    // instead of triangulating from scratch. The only incremental edit is the insertion of Steiner points: The points cannot be removed, nor
+    // the constraints updated. The state is reset by add_path(), add_hole(), add_edges() and a change of policy, and the implementations
+    // may also triangulate from scratch a new point that their state cannot hold, e.g. outside of its bounding box. Otherwise, this is
+    // equivalent to add_steiner() followed by triangulate().
+    shapes::Triangles2d<F, I> triangulate_incremental(TriangulationPolicy policy, Points new_steiner_points = Points(), const CancellationToken* token = nullptr) noexcept;
+    virtual bool supports_incremental() const noexcept { return false; }
+
+    // The phases of the latest call to one of the triangulate functions above. Reset at the beginning of each call, therefore the
+    // instance must not be triangulated concurrently by several threads.
+    const TimingReport& timing_report() const noexcept { return m_timing_report; }
+
+    // Heap memory held by the instance, in bytes: The input vertices and the internal buffers of the implementation, e.g. the state kept
+    // between two incremental triangulations. The transient buffers of a triangulation are not included (see the peak RSS of the process).
+    std::size_t byte_size() const noexcept;
+
+    // Arena of the transient buffers of the triangulations, e.g. one per job of a batch service, reset between two jobs.
+    // It must outlive the calls to the triangulate functions. By default (nullptr), the transient buffers are allocated on the heap.
+    // The buffers of the third-party libraries are not affected, and neither is the output.
+    void set_arena(stdutils::Arena* arena) noexcept { m_arena = arena; }
+
+    // Validation of the output of the triangulate functions, reported to the error handler (see delaunay::validate). Unlike the
+    // assertions, it is also available in release builds. The sampled Delaunay check is skipped with the CDT policy. Disabled by default.
+    void set_validation(std::optional<ValidationOptions> options, const stdutils::parallel::Policy& policy = stdutils::parallel::Policy()) noexcept { m_validation = options; m_validation_policy = policy; }
+
+    // Reuse of the instance, e.g. one per worker thread: clear() removes the input and the state of the incremental triangulation,
+    // but keeps the capacity of the buffers and the settings (vertex order, arena). reserve() sizes the buffers for the input of a job:
+    // Its number of vertices and its number of constraints (paths and holes). Note that triangulate_and_release() hands the buffer of
+    // the vertices over to the output, therefore a reused instance should be triangulated with triangulate().
+    void clear() noexcept;
+    void reserve(std::size_t nb_points, std::size_t nb_constraints);
 
 protected:
-    virtual void triangulate_impl(TriangulationPolicy policy, shapes::Triangles2d<F, I>& result) const = 0;
+    virtual void add_path_impl(Points vertices, bool closed) = 0;
+    virtual void add_hole_impl(Points vertices, bool closed) = 0;
+    virtual void add_steiner_impl(Points vertices) = 0;
+    virtual void add_edges_impl(const shapes::Edges2d<F, I>& edges);
+
+    // Compute the faces and the adjacency of the triangulation of m_points. The vertices of the result are set by the caller.
+    virtual void triangulate_impl(TriangulationPolicy policy, const CancellationToken* token, shapes::Triangles2d<F, I>& result) const = 0;
+
+    // Same contract as triangulate_impl(). Add the new points to the input first, even if the token is cancelled. The default implementation triangulates from scratch.
+    virtual void triangulate_incremental_impl(TriangulationPolicy policy, Points new_steiner_points, const CancellationToken* token, shapes::Triangles2d<F, I>& result);
+
+    // Heap memory of the internal buffers of the implementation, in bytes
+    virtual std::size_t byte_size_impl() const noexcept = 0;
+
+    // Clear the internal buffers of the implementation, keeping their capacity. Reserve them for nb_constraints paths and holes.
+    virtual void clear_impl() noexcept = 0;
+    virtual void reserve_impl(std::size_t nb_constraints) = 0;
+
+    // Throw Cancelled if the token is cancelled
+    static void check_cancellation(const CancellationToken* token);
+
+    // Allocator of the transient buffers of the implementations
+    template <typename T>
+    stdutils::ArenaAllocator<T> arena_allocator() const noexcept { return stdutils::ArenaAllocator<T>(m_arena); }
+
+    // Scoped measurement of a phase of the triangulation, added to the timing report on destruction. Also a profiler zone.
+    class PhaseTimer
+    {
+    public:
+        PhaseTimer(const Interface& dt, const char* name) noexcept;
+        ~PhaseTimer();
+
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    private:
+        TimingReport& m_report;
+        const char* m_name;
+        std::chrono::steady_clock::time_point m_start;
+#if defined(STDUTILS_PROFILING) && STDUTILS_PROFILING
+        stdutils::profiler::Zone m_zone;
+#endif
+    };
 
     stdutils::io::ErrorHandler m_err_handler;
+    shapes::Points2d<F> m_points;                   // All the input vertices, in the order of the calls to add_*() (each batch of Steiner points in the vertex order)
+
+private:
+    // Extend m_input_index to the vertices added since the last call, if they were not reordered
+    void extend_input_index();
+
+    // Set the vertices of the result, and remap its faces, to the order of the input
+    template <typename Pts>
+    void set_result_vertices(Pts&& points, shapes::Triangles2d<F, I>& result) const;
+
+    // Call func() to compute the faces. Return false if the computation failed, in which case the result is empty.
+    template <typename Func>
+    bool compute_faces(Func func, const CancellationToken* token, shapes::Triangles2d<F, I>& result) const noexcept;
+
+    // If enabled, renumber the output of a triangulation
+    void renumber_result(shapes::Triangles2d<F, I>& result) const;
+
+    // If enabled, validate the output of a triangulation
+    void validate_result(TriangulationPolicy policy, const shapes::Triangles2d<F, I>& result) const noexcept;
+
+    VertexOrder m_vertex_order;
+    bool m_output_renumbering;
+    mutable shapes::MeshPermutation<I> m_output_permutation;
+    stdutils::Arena* m_arena;
+    std::vector<I> m_input_index;                   // Input index of each vertex of m_points. Empty as long as no vertex was reordered.
+    mutable TimingReport m_timing_report;
+    std::optional<ValidationOptions> m_validation;
+    stdutils::parallel::Policy m_validation_policy;
 };
 
 
@@ -54,33 +257,313 @@ protected:
 template <typename F, typename I>
 Interface<F, I>::Interface(const stdutils::io::ErrorHandler* err_handler)
     : m_err_handler()
+    , m_points()
+    , m_vertex_order(VertexOrder::AsProvided)
+    , m_output_renumbering(false)
+    , m_output_permutation()
+    , m_arena(nullptr)
+    , m_input_index()
+    , m_timing_report()
+    , m_validation()
+    , m_validation_policy()
 {
     if (err_handler) { m_err_handler = *err_handler; }
 }
 
 template <typename F, typename I>
-shapes::Triangles2d<F, I> Interface<F, I>::triangulate(TriangulationPolicy policy) const noexcept
+void Interface<F, I>::add_path(const shapes::PointPath2d<F>& pp)
+{
+    STDUTILS_PROFILE_ZONE("delaunay::add_path");
+    assert(shapes::is_valid(pp));
+    add_path_impl(stdutils::make_const_span(pp.vertices), pp.closed);
+    extend_input_index();
+}
+
+template <typename F, typename I>
+void Interface<F, I>::add_path(Points vertices, bool closed)
+{
+    STDUTILS_PROFILE_ZONE("delaunay::add_path");
+    add_path_impl(vertices, closed);
+    extend_input_index();
+}
+
+template <typename F, typename I>
+void Interface<F, I>::add_hole(const shapes::PointPath2d<F>& pp)
+{
+    STDUTILS_PROFILE_ZONE("delaunay::add_hole");
+    assert(shapes::is_valid(pp));
+    add_hole_impl(stdutils::make_const_span(pp.vertices), pp.closed);
+    extend_input_index();
+}
+
+template <typename F, typename I>
+void Interface<F, I>::add_hole(Points vertices, bool closed)
+{
+    STDUTILS_PROFILE_ZONE("delaunay::add_hole");
+    add_hole_impl(vertices, closed);
+    extend_input_index();
+}
+
+template <typename F, typename I>
+void Interface<F, I>::add_steiner(const shapes::PointCloud2d<F>& pc)
+{
+    add_steiner(stdutils::make_const_span(pc.vertices));
+}
+
+template <typename F, typename I>
+void Interface<F, I>::add_steiner(Points vertices)
+{
+    STDUTILS_PROFILE_ZONE("delaunay::add_steiner");
+    if (m_vertex_order == VertexOrder::AsProvided || vertices.size() < 2)
+    {
+        add_steiner_impl(vertices);
+        extend_input_index();
+        return;
+    }
+    const std::vector<I> order = m_vertex_order == VertexOrder::Hilbert
+        ? shapes::hilbert_order<I>(vertices)
+        : shapes::brio_order<I>(vertices);
+    shapes::Points2d<F> sorted_vertices;
+    sorted_vertices.reserve(vertices.size());
+    for (const I idx : order) { sorted_vertices.push_back(vertices[static_cast<std::size_t>(idx)]); }
+    const std::size_t begin_idx = m_points.size();
+    extend_input_index();
+    if (m_input_index.empty())
+    {
+        // First reordered batch: The previous vertices are in the input order
+        m_input_index.resize(begin_idx);
+        for (std::size_t idx = 0; idx < begin_idx; idx++) { m_input_index[idx] = static_cast<I>(idx); }
+    }
+    add_steiner_impl(stdutils::make_const_span(sorted_vertices));
+    assert(m_points.size() == begin_idx + order.size());
+    m_input_index.reserve(m_points.size());
+    for (const I idx : order) { m_input_index.push_back(static_cast<I>(begin_idx + static_cast<std::size_t>(idx))); }
+}
+
+template <typename F, typename I>
+void Interface<F, I>::add_edges(const shapes::Edges2d<F, I>& edges)
+{
+    STDUTILS_PROFILE_ZONE("delaunay::add_edges");
+    assert(shapes::is_valid(edges));
+    add_edges_impl(edges);
+    extend_input_index();
+}
+
+template <typename F, typename I>
+void Interface<F, I>::add_edges_impl(const shapes::Edges2d<F, I>& edges)
+{
+    bool first_path = true;
+    for (const auto& pp : shapes::extract_paths(edges))
+    {
+        if (first_path) { add_path_impl(stdutils::make_const_span(pp.vertices), pp.closed); first_path = false; }
+        else { add_hole_impl(stdutils::make_const_span(pp.vertices), pp.closed); }
+    }
+}
+
+template <typename F, typename I>
+shapes::Triangles2d<F, I> Interface<F, I>::triangulate(TriangulationPolicy policy, const CancellationToken* token) const noexcept
+{
+    STDUTILS_PROFILE_ZONE("delaunay::triangulate");
+    shapes::Triangles2d<F, I> result;
+    const auto func = [this, policy, token, &result]() { check_cancellation(token); triangulate_impl(policy, token, result); };
+    if (compute_faces(func, token, result) && !result.faces.empty())
+    {
+        set_result_vertices(m_points, result);
+        renumber_result(result);
+        validate_result(policy, result);
+    }
+    assert(is_valid(result));
+    return result;
+}
+
+template <typename F, typename I>
+shapes::Triangles2d<F, I> Interface<F, I>::triangulate_and_release(TriangulationPolicy policy, const CancellationToken* token) noexcept
+{
+    STDUTILS_PROFILE_ZONE("delaunay::triangulate");
+    shapes::Triangles2d<F, I> result;
+    const auto func = [this, policy, token, &result]() { check_cancellation(token); triangulate_impl(policy, token, result); };
+    if (compute_faces(func, token, result) && !result.faces.empty())
+    {
+        set_result_vertices(std::move(m_points), result);
+        m_points.clear();
+        m_input_index.clear();
+        renumber_result(result);
+        validate_result(policy, result);
+    }
+    assert(is_valid(result));
+    return result;
+}
+
+template <typename F, typename I>
+shapes::Triangles2d<F, I> Interface<F, I>::triangulate_incremental(TriangulationPolicy policy, Points new_steiner_points, const CancellationToken* token) noexcept
 {
+    STDUTILS_PROFILE_ZONE("delaunay::triangulate_incremental");
     shapes::Triangles2d<F, I> result;
+    const auto func = [this, policy, new_steiner_points, token, &result]() { triangulate_incremental_impl(policy, new_steiner_points, token, result); };
+    const bool success = compute_faces(func, token, result);
+    extend_input_index();
+    if (success && !result.faces.empty())
+    {
+        set_result_vertices(m_points, result);
+        renumber_result(result);
+        validate_result(policy, result);
+    }
+    assert(is_valid(result));
+    return result;
+}
+
+template <typename F, typename I>
+void Interface<F, I>::triangulate_incremental_impl(TriangulationPolicy policy, Points new_steiner_points, const CancellationToken* token, shapes::Triangles2d<F, I>& result)
+{
+    if (!new_steiner_points.empty()) { add_steiner_impl(new_steiner_points); }
+    check_cancellation(token);
+    triangulate_impl(policy, token, result);
+}
+
+template <typename F, typename I>
+void Interface<F, I>::clear() noexcept
+{
+    m_points.clear();
+    m_input_index.clear();
+    m_timing_report.phases.clear();
+    clear_impl();
+}
+
+template <typename F, typename I>
+void Interface<F, I>::reserve(std::size_t nb_points, std::size_t nb_constraints)
+{
+    m_points.reserve(nb_points);
+    if (m_vertex_order != VertexOrder::AsProvided) { m_input_index.reserve(nb_points); }
+    reserve_impl(nb_constraints);
+}
+
+template <typename F, typename I>
+void Interface<F, I>::extend_input_index()
+{
+    if (m_input_index.empty())
+        return;
+    m_input_index.reserve(m_points.size());
+    for (std::size_t idx = m_input_index.size(); idx < m_points.size(); idx++) { m_input_index.push_back(static_cast<I>(idx)); }
+}
+
+template <typename F, typename I>
+template <typename Pts>
+void Interface<F, I>::set_result_vertices(Pts&& points, shapes::Triangles2d<F, I>& result) const
+{
+    const PhaseTimer phase(*this, "delaunay::copy_vertices");
+    if (m_input_index.empty())
+    {
+        result.vertices = std::forward<Pts>(points);
+        return;
+    }
+    assert(m_input_index.size() == points.size());
+    result.vertices.resize(points.size());
+    for (std::size_t idx = 0; idx < points.size(); idx++) { result.vertices[static_cast<std::size_t>(m_input_index[idx])] = points[idx]; }
+    for (auto& face : result.faces)
+    {
+        for (std::size_t k = 0; k < 3; k++) { face[k] = m_input_index[static_cast<std::size_t>(face[k])]; }
+    }
+}
+
+template <typename F, typename I>
+template <typename Func>
+bool Interface<F, I>::compute_faces(Func func, const CancellationToken* token, shapes::Triangles2d<F, I>& result) const noexcept
+{
+    m_timing_report.phases.clear();
+    m_output_permutation.vertex_order.clear();
+    m_output_permutation.face_order.clear();
     try
     {
-        triangulate_impl(policy, result);
+        func();
+        check_cancellation(token);
+        return true;
+    }
+    catch (const Cancelled& e)
+    {
+        if (m_err_handler) { m_err_handler(e.timeout() ? stdutils::io::Severity::WARN : stdutils::io::Severity::INFO, e.what()); }
     }
     catch (const std::exception& e)
     {
-        result.vertices.clear();
-        result.faces.clear();
         if (m_err_handler) { m_err_handler(stdutils::io::Severity::EXCPT, e.what()); }
     }
     catch (...)
     {
-        result.vertices.clear();
-        result.faces.clear();
         if (m_err_handler) { m_err_handler(stdutils::io::Severity::EXCPT, "Unknown exception occured"); }
     }
-    assert(is_valid(result));
-    return result;
+    result.vertices.clear();
+    result.faces.clear();
+    result.adjacency.clear();
+    return false;
+}
+
+template <typename F, typename I>
+void Interface<F, I>::renumber_result(shapes::Triangles2d<F, I>& result) const
+{
+    if (!m_output_renumbering)
+        return;
+    const PhaseTimer phase(*this, "delaunay::renumber");
+    m_output_permutation = shapes::renumber_along_hilbert_curve(result);
+}
+
+template <typename F, typename I>
+void Interface<F, I>::validate_result(TriangulationPolicy policy, const shapes::Triangles2d<F, I>& result) const noexcept
+{
+    if (!m_validation.has_value())
+        return;
+    const PhaseTimer phase(*this, "delaunay::validate");
+    ValidationOptions options = *m_validation;
+    if (policy == TriangulationPolicy::CDT) { options.nb_delaunay_samples = 0; }
+    try
+    {
+        report_validation(validate(m_validation_policy, result, options), m_err_handler);
+    }
+    catch (const std::exception& e)
+    {
+        if (m_err_handler) { m_err_handler(stdutils::io::Severity::EXCPT, e.what()); }
+    }
 }
 
+template <typename F, typename I>
+std::size_t Interface<F, I>::byte_size() const noexcept
+{
+    return stdutils::memory::byte_size(m_points)
+         + stdutils::memory::byte_size(m_input_index)
+         + stdutils::memory::byte_size(m_output_permutation.vertex_order)
+         + stdutils::memory::byte_size(m_output_permutation.face_order)
+         + stdutils::memory::byte_size(m_timing_report.phases)
+         + byte_size_impl();
+}
+
+template <typename F, typename I>
+void Interface<F, I>::check_cancellation(const CancellationToken* token)
+{
+    if (token && token->is_cancelled()) { throw Cancelled(token->has_timed_out()); }
+}
+
+
+template <typename F, typename I>
+Interface<F, I>::PhaseTimer::PhaseTimer(const Interface& dt, const char* name) noexcept
+    : m_report(dt.m_timing_report)
+    , m_name(name)
+    , m_start(std::chrono::steady_clock::now())
+#if defined(STDUTILS_PROFILING) && STDUTILS_PROFILING
+    , m_zone(name)
+#endif
+{
+}
+
+template <typename F, typename I>
+Interface<F, I>::PhaseTimer::~PhaseTimer()
+{
+    const std::chrono::duration<float, std::milli> duration = std::chrono::steady_clock::now() - m_start;
+    try
+    {
+        m_report.phases.push_back(TimingReport::Phase{ m_name, duration.count() });
+    }
+    catch (...)
+    {
+        // Drop the phase
+    }
+}
 
 } // namespace delaunay
@@ -2,17 +2,34 @@
 // This code is distributed under the terms of the MIT License
 #pragma once
 
-#include <dt/dt_impl.h>
+#include <dt/auto_select.h>
+#include <graphs/index.h>
+#include <graphs/triangulation.h>
+#include <shapes/bounding_box.h>
+#include <shapes/incremental_proximity.h>
 #include <shapes/point_cloud.h>
 #include <shapes/proximity_graphs.h>
+#include <shapes/spatial_index.h>
 #include <shapes/triangle_algos.h>
+#include <shapes/voronoi.h>
+#include <stdutils/arena.h>
 #include <stdutils/io.h>
 #include <stdutils/macros.h>
+#include <stdutils/parallel.h>
+#include <stdutils/span.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <sstream>
+#include <vector>
 
 namespace delaunay {
 
 /**
  * See graphs/proximity.h for more information regarding the proximity graphs
+ *
+ * The graphs derived from a triangulation use the Delaunay implementation selected automatically for the input (see dt/auto_select.h)
  */
 
 template <typename P, typename I = std::uint32_t>
@@ -30,6 +47,29 @@ shapes::Edges<P, I> gabriel_graph(const shapes::PointCloud<P>& pc, const stdutil
 template <typename P, typename I = std::uint32_t>
 shapes::Edges<P, I> delaunay_triangulation(const shapes::PointCloud<P>& pc, const stdutils::io::ErrorHandler& err_handler);
 
+// The undirected k-nearest neighbors graph: There is an edge between two points if one is among the k nearest neighbors of the other.
+// The graph is not derived from a triangulation, but from a k-d tree of the points, queried concurrently. Each edge is oriented from the
+// lower to the higher index. With duplicated points, a point and its copies are neighbors at distance 0.
+template <typename P, typename I = std::uint32_t>
+shapes::Edges<P, I> k_nearest_neighbors(const shapes::PointCloud<P>& pc, std::size_t k, const stdutils::io::ErrorHandler& err_handler);
+template <typename P, typename I = std::uint32_t>
+shapes::Edges<P, I> k_nearest_neighbors(const stdutils::parallel::Policy& policy, const shapes::PointCloud<P>& pc, std::size_t k, const stdutils::io::ErrorHandler& err_handler);
+
+// The Voronoi diagram of the point cloud, clipped to clip_box. See shapes/voronoi.h
+template <typename P, typename I = std::uint32_t>
+shapes::VoronoiDiagram<typename P::scalar, I> voronoi_diagram(const stdutils::parallel::Policy& policy, const shapes::PointCloud<P>& pc, const shapes::BoundingBox2d<typename P::scalar>& clip_box, const stdutils::io::ErrorHandler& err_handler);
+
+// Triangulate the point cloud once and derive all the selected proximity graphs from the same triangulation.
+// The transient buffers of both steps are allocated in the arena, if there is one.
+template <typename P, typename I = std::uint32_t>
+shapes::ProximityGraphs<P, I> proximity_graphs(const shapes::PointCloud<P>& pc, const stdutils::io::ErrorHandler& err_handler, const shapes::ProximityGraphsSelection& selection = shapes::ProximityGraphsSelection(), stdutils::Arena* arena = nullptr);
+template <typename P, typename I = std::uint32_t>
+shapes::ProximityGraphs<P, I> proximity_graphs(const stdutils::parallel::Policy& policy, const shapes::PointCloud<P>& pc, const stdutils::io::ErrorHandler& err_handler, const shapes::ProximityGraphsSelection& selection = shapes::ProximityGraphsSelection(), stdutils::Arena* arena = nullptr);
+
+// Triangulate the point cloud and return the proximity graphs maintained under the insertion of points. See shapes/incremental_proximity.h
+template <typename F, typename I = std::uint32_t>
+shapes::IncrementalProximityGraphs<F, I> incremental_proximity_graphs(const shapes::PointCloud<shapes::Point2d<F>>& pc, const stdutils::io::ErrorHandler& err_handler);
+
 
 //
 //
@@ -40,21 +80,34 @@ shapes::Edges<P, I> delaunay_triangulation(const shapes::PointCloud<P>& pc, cons
 
 namespace details {
 
-template <typename P, typename I, typename Func>
-shapes::Edges<P, I> generic_proximity_graph(const shapes::PointCloud<P>& pc, const stdutils::io::ErrorHandler& err_handler, Func func)
+// Delaunay triangulation with the implementation selected for the point cloud (see dt/auto_select.h). Return false if there is none.
+template <typename P, typename I>
+bool auto_triangulation(const shapes::PointCloud<P>& pc, const stdutils::io::ErrorHandler& err_handler, shapes::Triangles<P, I>& triangles, stdutils::Arena* arena = nullptr)
 {
     using F = typename P::scalar;
-
-    // Delaunay triangulation
-    auto [delaunay_name, delaunay_algo] = delaunay::get_ref_impl<F, I>(&err_handler);
+    InputFeatures features;
+    features.policy = delaunay::TriangulationPolicy::PointCloud;
+    features.nb_vertices = pc.vertices.size();
+    auto [delaunay_name, delaunay_algo] = delaunay::get_auto_impl<F, I>(features, &err_handler);
     UNUSED(delaunay_name);
     if (!delaunay_algo)
     {
         err_handler(stdutils::io::Severity::ERR, "Could not find a Delaunay triangulation algo");
-        return shapes::Edges<P>();
+        return false;
     }
+    delaunay_algo->set_arena(arena);
     delaunay_algo->add_steiner(pc);
-    const shapes::Triangles2d<F, I> triangles = delaunay_algo->triangulate(delaunay::TriangulationPolicy::PointCloud);
+    triangles = delaunay_algo->triangulate_and_release(delaunay::TriangulationPolicy::PointCloud);
+    return true;
+}
+
+template <typename P, typename I, typename Func>
+shapes::Edges<P, I> generic_proximity_graph(const shapes::PointCloud<P>& pc, const stdutils::io::ErrorHandler& err_handler, Func func)
+{
+    // Delaunay triangulation
+    shapes::Triangles<P, I> triangles;
+    if (!auto_triangulation(pc, err_handler, triangles))
+        return shapes::Edges<P, I>();
 
     // Compute proximity graph
     return func(triangles);
@@ -65,13 +118,13 @@ shapes::Edges<P, I> generic_proximity_graph(const shapes::PointCloud<P>& pc, con
 template <typename P, typename I>
 shapes::Edges<P, I> nearest_neighbor(const shapes::PointCloud<P>& pc, const stdutils::io::ErrorHandler& err_handler)
 {
-    return details::generic_proximity_graph<P, I>(pc, err_handler, &shapes::nearest_neighbor<P, I>);
+    return details::generic_proximity_graph<P, I>(pc, err_handler, [](const shapes::Triangles<P, I>& triangles) { return shapes::nearest_neighbor<P, I>(triangles); });
 }
 
 template <typename P, typename I>
 shapes::Edges<P, I> minimum_spanning_tree(const shapes::PointCloud<P>& pc, const stdutils::io::ErrorHandler& err_handler)
 {
-    return details::generic_proximity_graph<P, I>(pc, err_handler, &shapes::minimum_spanning_tree<P, I>);
+    return details::generic_proximity_graph<P, I>(pc, err_handler, [](const shapes::Triangles<P, I>& triangles) { return shapes::minimum_spanning_tree<P, I>(triangles); });
 }
 
 template <typename P, typename I>
@@ -92,4 +145,112 @@ shapes::Edges<P, I> delaunay_triangulation(const shapes::PointCloud<P>& pc, cons
     return details::generic_proximity_graph<P, I>(pc, err_handler, &shapes::extract_edges<P, I>);
 }
 
+template <typename P, typename I>
+shapes::Edges<P, I> k_nearest_neighbors(const shapes::PointCloud<P>& pc, std::size_t k, const stdutils::io::ErrorHandler& err_handler)
+{
+    return k_nearest_neighbors<P, I>(stdutils::parallel::Policy(), pc, k, err_handler);
+}
+
+template <typename P, typename I>
+shapes::Edges<P, I> k_nearest_neighbors(const stdutils::parallel::Policy& policy, const shapes::PointCloud<P>& pc, std::size_t k, const stdutils::io::ErrorHandler& err_handler)
+{
+    static_assert(P::dim == 2, "The k-NN graph is only available in 2D");
+    using F = typename P::scalar;
+    shapes::Edges<P, I> result;
+    const std::size_t nb_points = pc.vertices.size();
+    if (nb_points > static_cast<std::size_t>(graphs::IndexTraits<I>::max_valid_index()) + 1)
+    {
+        std::stringstream out;
+        out << "k_nearest_neighbors(): Too many points (" << nb_points << ") for the index type";
+        err_handler(stdutils::io::Severity::ERR, out.str());
+        return result;
+    }
+    result.vertices = pc.vertices;
+    k = std::min(k, nb_points == 0 ? 0 : nb_points - 1);
+    if (k == 0)
+        return result;
+
+    // The k nearest neighbors of each point, excluding itself
+    const shapes::KdTree<F, I> kd_tree(policy, stdutils::make_const_span(pc.vertices));
+    std::vector<I> neighbors(nb_points * k);
+    stdutils::parallel::for_each_chunk(policy, nb_points, [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        std::vector<I> knn;
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++)
+        {
+            // The query point may not come first among its duplicates
+            kd_tree.k_nearest(pc.vertices[idx], k + 1, knn);
+            const auto self_it = std::find(knn.begin(), knn.end(), static_cast<I>(idx));
+            if (self_it != knn.end()) { knn.erase(self_it); }
+            assert(knn.size() >= k);
+            std::copy(knn.cbegin(), knn.cbegin() + static_cast<std::ptrdiff_t>(k), neighbors.begin() + static_cast<std::ptrdiff_t>(idx * k));
+        }
+    });
+
+    // Point idx is the origin of the edge to its neighbor n if idx < n, or if idx is not a neighbor of n (the edge is not seen from n)
+    const auto is_neighbor = [&neighbors, k](std::size_t n_idx, I v) {
+        const auto n_begin = neighbors.cbegin() + static_cast<std::ptrdiff_t>(n_idx * k);
+        return std::find(n_begin, n_begin + static_cast<std::ptrdiff_t>(k), v) != n_begin + static_cast<std::ptrdiff_t>(k);
+    };
+    const auto is_origin = [&is_neighbor](std::size_t idx, I n) {
+        return static_cast<std::size_t>(n) > idx || !is_neighbor(static_cast<std::size_t>(n), static_cast<I>(idx));
+    };
+    std::vector<std::size_t> offsets(nb_points + 1, 0);
+    stdutils::parallel::for_each_chunk(policy, nb_points, [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++)
+            for (std::size_t j = 0; j < k; j++)
+                if (is_origin(idx, neighbors[idx * k + j])) { offsets[idx + 1]++; }
+    });
+    for (std::size_t idx = 1; idx <= nb_points; idx++) { offsets[idx] += offsets[idx - 1]; }
+    result.indices.resize(offsets.back());
+    stdutils::parallel::for_each_chunk(policy, nb_points, [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++)
+        {
+            std::size_t out_idx = offsets[idx];
+            for (std::size_t j = 0; j < k; j++)
+            {
+                const I n = neighbors[idx * k + j];
+                if (is_origin(idx, n)) { result.indices[out_idx++] = graphs::Edge<I>(std::min(static_cast<I>(idx), n), std::max(static_cast<I>(idx), n)); }
+            }
+        }
+    });
+    return result;
+}
+
+template <typename P, typename I>
+shapes::VoronoiDiagram<typename P::scalar, I> voronoi_diagram(const stdutils::parallel::Policy& policy, const shapes::PointCloud<P>& pc, const shapes::BoundingBox2d<typename P::scalar>& clip_box, const stdutils::io::ErrorHandler& err_handler)
+{
+    shapes::Triangles<P, I> triangles;
+    if (!details::auto_triangulation(pc, err_handler, triangles))
+        return shapes::VoronoiDiagram<typename P::scalar, I>();
+    if (!shapes::has_adjacency(triangles)) { triangles.adjacency = graphs::triangle_adjacency(triangles.faces); }
+    return shapes::voronoi_diagram(policy, triangles, clip_box);
+}
+
+template <typename P, typename I>
+shapes::ProximityGraphs<P, I> proximity_graphs(const shapes::PointCloud<P>& pc, const stdutils::io::ErrorHandler& err_handler, const shapes::ProximityGraphsSelection& selection, stdutils::Arena* arena)
+{
+    shapes::Triangles<P, I> triangles;
+    if (!details::auto_triangulation(pc, err_handler, triangles, arena))
+        return shapes::ProximityGraphs<P, I>();
+    return shapes::proximity_graphs(triangles, selection, arena);
+}
+
+template <typename P, typename I>
+shapes::ProximityGraphs<P, I> proximity_graphs(const stdutils::parallel::Policy& policy, const shapes::PointCloud<P>& pc, const stdutils::io::ErrorHandler& err_handler, const shapes::ProximityGraphsSelection& selection, stdutils::Arena* arena)
+{
+    shapes::Triangles<P, I> triangles;
+    if (!details::auto_triangulation(pc, err_handler, triangles, arena))
+        return shapes::ProximityGraphs<P, I>();
+    return shapes::proximity_graphs(policy, triangles, selection, arena);
+}
+
+template <typename F, typename I>
+shapes::IncrementalProximityGraphs<F, I> incremental_proximity_graphs(const shapes::PointCloud<shapes::Point2d<F>>& pc, const stdutils::io::ErrorHandler& err_handler)
+{
+    shapes::Triangles2d<F, I> triangles;
+    if (!details::auto_triangulation(pc, err_handler, triangles))
+        return shapes::IncrementalProximityGraphs<F, I>(shapes::Triangles2d<F, I>());
+    return shapes::IncrementalProximityGraphs<F, I>(triangles);
+}
+
 } // namespace delaunay
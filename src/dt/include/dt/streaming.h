@@ -0,0 +1,601 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <graphs/graph.h>
+#include <graphs/index.h>
+#include <shapes/io.h>
+#include <shapes/point.h>
+#include <shapes/point_order.h>
+#include <shapes/predicates.h>
+#include <stdutils/io.h>
+#include <stdutils/mapped_file.h>
+#include <stdutils/span.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace delaunay {
+
+/**
+ * Streaming Delaunay triangulation of a point set larger than the memory
+ *
+ * The points are received by chunks, sorted along the X axis: Each chunk comes with a front, a lower bound of the X coordinate of all the
+ * points of the next chunks. After a chunk is inserted, a face whose circumcircle lies entirely behind the front cannot be invalidated by
+ * the next points: It is a face of the final triangulation. It is passed to the sink, then dropped, and so are the vertices that are not
+ * referenced anymore. Only the faces whose circumcircles cross the front, and their vertices, are kept in memory.
+ *
+ * The triangulation is incremental (Bowyer-Watson, with a ghost vertex closing the convex hull) and relies on the exact predicates of
+ * shapes/predicates.h. The points of a chunk are inserted along a Hilbert curve. The faces are counterclockwise, and their vertex indices
+ * are the positions of the points in the stream. Duplicated points are skipped: Their index is not referenced by any face.
+ *
+ * Limitations:
+ *  - This is a point cloud triangulation, without constraints
+ *  - The vertices of the convex hull stay in memory until the end of the stream
+ *  - The points received before three of them are not collinear are buffered
+ */
+template <typename I = std::uint32_t>
+using FaceSink = std::function<void(stdutils::Span<const graphs::Triangle<I>> faces)>;
+
+template <typename F, typename I = std::uint32_t>
+class StreamingTriangulation
+{
+public:
+    using Points = stdutils::Span<const shapes::Point2d<F>>;
+
+    explicit StreamingTriangulation(FaceSink<I> sink, const stdutils::io::ErrorHandler* err_handler = nullptr);
+
+    // The points of the chunk must not be behind the previous front, and the front must not decrease.
+    // Return false on error, in which case the chunk is ignored.
+    bool add_chunk(Points points, F front);
+
+    // Pass the remaining faces to the sink. No chunk can be added afterwards.
+    void finish();
+
+    std::size_t nb_received_points() const noexcept { return m_nb_received; }
+    std::size_t nb_duplicates() const noexcept { return m_nb_duplicates; }
+    std::size_t nb_emitted_faces() const noexcept { return m_nb_emitted; }
+    std::size_t nb_active_vertices() const noexcept { return m_vertices.size() + m_pending.size(); }
+    std::size_t nb_active_faces() const noexcept { return m_faces.size() - m_free_faces.size(); }
+
+    // Approximate memory footprint
+    std::size_t byte_size() const noexcept;
+
+private:
+    static constexpr std::size_t no_face = std::numeric_limits<std::size_t>::max();
+    static constexpr I ghost() { return graphs::IndexTraits<I>::undef(); }
+
+    struct Vertex
+    {
+        shapes::Point2d<F> p;
+        std::size_t nb_refs;
+    };
+
+    struct Face
+    {
+        std::array<I, 3> v;                         // Counterclockwise. At most one of them is the ghost vertex.
+        std::array<std::size_t, 3> nbr;             // nbr[k] is across the edge (v[k], v[k+1]). no_face on the convex hull of the emitted faces.
+        std::uint32_t stamp;
+        bool alive;
+    };
+
+    struct BoundaryEdge
+    {
+        I orig;
+        I dest;
+        std::size_t outer;
+        std::size_t new_face;
+    };
+
+    const shapes::Point2d<F>& point(I idx) const { assert(m_vertices.count(idx)); return m_vertices.find(idx)->second.p; }
+    int ghost_pos(const Face& face) const noexcept;
+    bool in_conflict(const Face& face, const shapes::Point2d<F>& p) const;
+    std::size_t locate(const shapes::Point2d<F>& p) const;
+    std::size_t create_face(I a, I b, I c);
+    void release_face(std::size_t f);
+    void replace_neighbor(std::size_t f, std::size_t old_nbr, std::size_t new_nbr);
+    bool bootstrap();
+    void insert(I idx, const shapes::Point2d<F>& p);
+    void emit_final_faces(bool all);
+
+    FaceSink<I> m_sink;
+    const stdutils::io::ErrorHandler* m_err_handler;
+    std::vector<Face> m_faces;
+    std::vector<std::size_t> m_free_faces;
+    std::unordered_map<I, Vertex> m_vertices;
+    std::vector<std::pair<I, shapes::Point2d<F>>> m_pending;       // Before the first face
+    graphs::TriangleSoup<I> m_output;
+    std::vector<std::size_t> m_cavity;
+    std::vector<BoundaryEdge> m_boundary;
+    F m_front;
+    std::size_t m_nb_received;
+    std::size_t m_nb_duplicates;
+    std::size_t m_nb_emitted;
+    std::size_t m_last_face;
+    std::uint32_t m_stamp;
+    bool m_finished;
+};
+
+// Write the faces to a binary stream: Three indices of type I per face, in the byte order of the host
+template <typename I = std::uint32_t>
+FaceSink<I> binary_face_writer(std::ostream& out);
+
+// Triangulate points sorted along the X axis, by chunks of chunk_size points
+template <typename F, typename I = std::uint32_t>
+bool triangulate_streaming(stdutils::Span<const shapes::Point2d<F>> sorted_points, std::size_t chunk_size, const FaceSink<I>& sink, const stdutils::io::ErrorHandler* err_handler = nullptr);
+
+// Triangulate the 2D point clouds of a SHB file, in the order of the file. The file is memory-mapped, and read by chunks of chunk_size points.
+// The points, all point clouds included, must be sorted along the X axis. Their indices are their positions in the sequence of the point clouds.
+template <typename I = std::uint32_t>
+bool triangulate_shb_file_streaming(const std::filesystem::path& filepath, std::size_t chunk_size, const FaceSink<I>& sink, const stdutils::io::ErrorHandler& err_handler);
+
+
+//
+//
+// Implementation
+//
+//
+
+
+template <typename F, typename I>
+StreamingTriangulation<F, I>::StreamingTriangulation(FaceSink<I> sink, const stdutils::io::ErrorHandler* err_handler)
+    : m_sink(std::move(sink))
+    , m_err_handler(err_handler)
+    , m_faces()
+    , m_free_faces()
+    , m_vertices()
+    , m_pending()
+    , m_output()
+    , m_cavity()
+    , m_boundary()
+    , m_front(std::numeric_limits<F>::lowest())
+    , m_nb_received(0)
+    , m_nb_duplicates(0)
+    , m_nb_emitted(0)
+    , m_last_face(no_face)
+    , m_stamp(0)
+    , m_finished(false)
+{
+    assert(m_sink);
+}
+
+template <typename F, typename I>
+bool StreamingTriangulation<F, I>::add_chunk(Points points, F front)
+{
+    const auto report_error = [this](const char* msg) {
+        if (m_err_handler) { (*m_err_handler)(stdutils::io::Severity::ERR, msg); }
+        return false;
+    };
+    if (m_finished)
+        return report_error("Streaming triangulation: A chunk was added after the end of the stream");
+    if (front < m_front)
+        return report_error("Streaming triangulation: The front must not decrease");
+    if (std::any_of(points.begin(), points.end(), [this](const auto& p) { return !(p.x >= m_front) || !std::isfinite(p.y); }))
+        return report_error("Streaming triangulation: The chunk has points behind the previous front, or which are not finite");
+    if (points.size() >= static_cast<std::size_t>(ghost()) - m_nb_received)
+        return report_error("Streaming triangulation: The number of points exceeds the capacity of the index type");
+
+    const std::size_t first_idx = m_nb_received;
+    m_nb_received += points.size();
+    m_front = front;
+    for (const std::size_t local_idx : shapes::hilbert_order<std::size_t>(points))
+    {
+        const I idx = static_cast<I>(first_idx + local_idx);
+        if (m_last_face == no_face)
+        {
+            m_pending.emplace_back(idx, points[local_idx]);
+            bootstrap();
+        }
+        else
+        {
+            insert(idx, points[local_idx]);
+        }
+    }
+    emit_final_faces(false);
+    return true;
+}
+
+template <typename F, typename I>
+void StreamingTriangulation<F, I>::finish()
+{
+    if (m_finished)
+        return;
+    if (m_last_face == no_face && m_nb_received > 0 && m_err_handler)
+        (*m_err_handler)(stdutils::io::Severity::WARN, "Streaming triangulation: All the points are collinear");
+    emit_final_faces(true);
+    m_faces.clear();
+    m_free_faces.clear();
+    m_vertices.clear();
+    m_pending.clear();
+    m_finished = true;
+}
+
+template <typename F, typename I>
+std::size_t StreamingTriangulation<F, I>::byte_size() const noexcept
+{
+    // Node-based map: Count two pointers per element, for the list and the bucket
+    return m_faces.capacity() * sizeof(Face)
+        + m_free_faces.capacity() * sizeof(std::size_t)
+        + m_vertices.size() * (sizeof(std::pair<const I, Vertex>) + 2 * sizeof(void*))
+        + m_pending.capacity() * sizeof(std::pair<I, shapes::Point2d<F>>)
+        + m_output.capacity() * sizeof(graphs::Triangle<I>)
+        + m_cavity.capacity() * sizeof(std::size_t)
+        + m_boundary.capacity() * sizeof(BoundaryEdge);
+}
+
+template <typename F, typename I>
+int StreamingTriangulation<F, I>::ghost_pos(const Face& face) const noexcept
+{
+    for (int k = 0; k < 3; k++)
+    {
+        if (face.v[static_cast<std::size_t>(k)] == ghost())
+            return k;
+    }
+    return -1;
+}
+
+template <typename F, typename I>
+bool StreamingTriangulation<F, I>::in_conflict(const Face& face, const shapes::Point2d<F>& p) const
+{
+    const int g = ghost_pos(face);
+    if (g < 0)
+        return shapes::incircle(point(face.v[0]), point(face.v[1]), point(face.v[2]), p) > 0.0;
+
+    // Ghost face: The open half-plane beyond the hull edge (a, b), and the interior of that edge
+    const auto& a = point(face.v[static_cast<std::size_t>(g + 1) % 3u]);
+    const auto& b = point(face.v[static_cast<std::size_t>(g + 2) % 3u]);
+    const double o = shapes::orient2d(a, b, p);
+    if (o != 0.0)
+        return o > 0.0;
+    const auto strictly_between = [](F u, F lo, F hi) { return std::min(lo, hi) < u && u < std::max(lo, hi); };
+    return a.x != b.x ? strictly_between(p.x, a.x, b.x) : strictly_between(p.y, a.y, b.y);
+}
+
+template <typename F, typename I>
+std::size_t StreamingTriangulation<F, I>::locate(const shapes::Point2d<F>& p) const
+{
+    // Visibility walk from the last created face. It may be stopped by the emitted faces, in which case all the faces are scanned.
+    std::size_t f = m_last_face;
+    assert(f != no_face && m_faces[f].alive);
+    for (std::size_t step = 0; step <= m_faces.size() && f != no_face; step++)
+    {
+        const Face& face = m_faces[f];
+        const int g = ghost_pos(face);
+        if (g >= 0)
+        {
+            if (in_conflict(face, p))
+                return f;
+            f = face.nbr[static_cast<std::size_t>(g + 1) % 3u];
+            continue;
+        }
+        if (std::any_of(face.v.cbegin(), face.v.cend(), [this, &p](I v) { return point(v) == p; }))
+            return no_face;
+        std::size_t next = f;
+        for (std::size_t j = 0; j < 3; j++)
+        {
+            const std::size_t k = (j + step) % 3u;
+            if (shapes::orient2d(point(face.v[k]), point(face.v[(k + 1u) % 3u]), p) < 0.0)
+            {
+                next = face.nbr[k];
+                break;
+            }
+        }
+        if (next == f)
+            return f;           // p is inside the face, or on one of its edges
+        f = next;
+    }
+    for (std::size_t idx = 0; idx < m_faces.size(); idx++)
+    {
+        if (m_faces[idx].alive && in_conflict(m_faces[idx], p))
+            return idx;
+    }
+    return no_face;             // Duplicated point
+}
+
+template <typename F, typename I>
+std::size_t StreamingTriangulation<F, I>::create_face(I a, I b, I c)
+{
+    std::size_t f = m_faces.size();
+    if (m_free_faces.empty())
+    {
+        m_faces.emplace_back();
+    }
+    else
+    {
+        f = m_free_faces.back();
+        m_free_faces.pop_back();
+    }
+    Face& face = m_faces[f];
+    face.v = { a, b, c };
+    face.nbr = { no_face, no_face, no_face };
+    face.stamp = 0;
+    face.alive = true;
+    for (const I v : face.v)
+    {
+        if (v != ghost()) { m_vertices[v].nb_refs++; }
+    }
+    m_last_face = f;
+    return f;
+}
+
+template <typename F, typename I>
+void StreamingTriangulation<F, I>::release_face(std::size_t f)
+{
+    Face& face = m_faces[f];
+    assert(face.alive);
+    face.alive = false;
+    for (const I v : face.v)
+    {
+        if (v == ghost())
+            continue;
+        const auto it = m_vertices.find(v);
+        assert(it != m_vertices.end() && it->second.nb_refs > 0);
+        if (--it->second.nb_refs == 0) { m_vertices.erase(it); }
+    }
+    m_free_faces.push_back(f);
+}
+
+template <typename F, typename I>
+void StreamingTriangulation<F, I>::replace_neighbor(std::size_t f, std::size_t old_nbr, std::size_t new_nbr)
+{
+    auto& nbr = m_faces[f].nbr;
+    const auto it = std::find(nbr.begin(), nbr.end(), old_nbr);
+    assert(it != nbr.end());
+    *it = new_nbr;
+}
+
+template <typename F, typename I>
+bool StreamingTriangulation<F, I>::bootstrap()
+{
+    // Wait for three points that are not collinear
+    assert(!m_pending.empty());
+    const auto& [a_idx, a] = m_pending.front();
+    const auto b_it = std::find_if(m_pending.cbegin(), m_pending.cend(), [&a](const auto& q) { return !(q.second == a); });
+    if (b_it == m_pending.cend())
+        return false;
+    const auto c_it = std::find_if(b_it, m_pending.cend(), [&a, &b_it](const auto& q) { return shapes::orient2d(a, b_it->second, q.second) != 0.0; });
+    if (c_it == m_pending.cend())
+        return false;
+
+    const bool ccw = shapes::orient2d(a, b_it->second, c_it->second) > 0.0;
+    const I b_idx = ccw ? b_it->first : c_it->first;
+    const I c_idx = ccw ? c_it->first : b_it->first;
+    m_vertices[a_idx] = Vertex{ a, 0 };
+    m_vertices[b_it->first] = Vertex{ b_it->second, 0 };
+    m_vertices[c_it->first] = Vertex{ c_it->second, 0 };
+    const std::size_t t = create_face(a_idx, b_idx, c_idx);
+    const std::array<std::size_t, 3> ghosts = { create_face(b_idx, a_idx, ghost()), create_face(c_idx, b_idx, ghost()), create_face(a_idx, c_idx, ghost()) };
+    for (std::size_t k = 0; k < 3; k++)
+    {
+        // The ghost face of the edge k of t: Its edge 0 is shared with t, its edge 1 with the next ghost face, its edge 2 with the previous one
+        m_faces[t].nbr[k] = ghosts[k];
+        m_faces[ghosts[k]].nbr = { t, ghosts[(k + 2u) % 3u], ghosts[(k + 1u) % 3u] };
+    }
+
+    auto remaining = std::move(m_pending);
+    m_pending.clear();
+    const std::array<I, 3> initial = { a_idx, b_idx, c_idx };
+    for (const auto& [idx, p] : remaining)
+    {
+        if (std::find(initial.cbegin(), initial.cend(), idx) == initial.cend())
+            insert(idx, p);
+    }
+    return true;
+}
+
+template <typename F, typename I>
+void StreamingTriangulation<F, I>::insert(I idx, const shapes::Point2d<F>& p)
+{
+    const std::size_t first = locate(p);
+    if (first == no_face)
+    {
+        m_nb_duplicates++;
+        return;
+    }
+
+    // Cavity: The connected set of faces in conflict with p
+    m_stamp++;
+    m_cavity.clear();
+    m_cavity.push_back(first);
+    m_faces[first].stamp = m_stamp;
+    for (std::size_t c = 0; c < m_cavity.size(); c++)
+    {
+        for (const std::size_t n : m_faces[m_cavity[c]].nbr)
+        {
+            if (n == no_face || m_faces[n].stamp == m_stamp || !in_conflict(m_faces[n], p))
+                continue;
+            m_faces[n].stamp = m_stamp;
+            m_cavity.push_back(n);
+        }
+    }
+
+    // Star the boundary of the cavity from p
+    m_vertices[idx] = Vertex{ p, 0 };
+    m_boundary.clear();
+    for (const std::size_t f : m_cavity)
+    {
+        for (std::size_t k = 0; k < 3; k++)
+        {
+            const std::size_t n = m_faces[f].nbr[k];
+            if (n != no_face && m_faces[n].stamp == m_stamp)
+                continue;
+            const I orig = m_faces[f].v[k];
+            const I dest = m_faces[f].v[(k + 1u) % 3u];
+            const std::size_t new_face = create_face(orig, dest, idx);
+            m_faces[new_face].nbr[0] = n;
+            if (n != no_face) { replace_neighbor(n, f, new_face); }
+            m_boundary.push_back(BoundaryEdge{ orig, dest, n, new_face });
+        }
+    }
+    std::sort(m_boundary.begin(), m_boundary.end(), [](const auto& lhs, const auto& rhs) { return lhs.orig < rhs.orig; });
+    for (const auto& edge : m_boundary)
+    {
+        // The edge (dest, p) of the new face is the edge (p, dest) of the new face starting at dest
+        const auto next = std::lower_bound(m_boundary.cbegin(), m_boundary.cend(), edge.dest, [](const auto& lhs, I v) { return lhs.orig < v; });
+        assert(next != m_boundary.cend() && next->orig == edge.dest);
+        m_faces[edge.new_face].nbr[1] = next->new_face;
+        m_faces[next->new_face].nbr[2] = edge.new_face;
+    }
+    for (const std::size_t f : m_cavity)
+        release_face(f);
+}
+
+template <typename F, typename I>
+void StreamingTriangulation<F, I>::emit_final_faces(bool all)
+{
+    for (std::size_t f = 0; f < m_faces.size(); f++)
+    {
+        const Face& face = m_faces[f];
+        if (!face.alive || ghost_pos(face) >= 0)
+            continue;
+        if (!all)
+        {
+            // Circumcircle, with a relative margin since it is not computed exactly
+            const auto& a = point(face.v[0]);
+            const auto& b = point(face.v[1]);
+            const auto& c = point(face.v[2]);
+            const double bx = static_cast<double>(b.x) - static_cast<double>(a.x);
+            const double by = static_cast<double>(b.y) - static_cast<double>(a.y);
+            const double cx = static_cast<double>(c.x) - static_cast<double>(a.x);
+            const double cy = static_cast<double>(c.y) - static_cast<double>(a.y);
+            const double d = 2.0 * (bx * cy - by * cx);
+            if (d == 0.0)
+                continue;
+            const double ux = (cy * (bx * bx + by * by) - by * (cx * cx + cy * cy)) / d;
+            const double uy = (bx * (cx * cx + cy * cy) - cx * (bx * bx + by * by)) / d;
+            const double radius = std::sqrt(ux * ux + uy * uy);
+            const double center_x = static_cast<double>(a.x) + ux;
+            const double margin = 1e-7 * (std::abs(center_x) + radius);
+            if (!(center_x + radius + margin < static_cast<double>(m_front)))
+                continue;
+        }
+        m_output.emplace_back(face.v[0], face.v[1], face.v[2]);
+        for (const std::size_t n : face.nbr)
+        {
+            if (n != no_face) { replace_neighbor(n, f, no_face); }
+        }
+        release_face(f);
+    }
+    if (m_last_face != no_face && !m_faces[m_last_face].alive)
+    {
+        // Restart the walks from any face left, preferably a finite one
+        m_last_face = no_face;
+        for (std::size_t f = 0; f < m_faces.size(); f++)
+        {
+            if (!m_faces[f].alive)
+                continue;
+            m_last_face = f;
+            if (ghost_pos(m_faces[f]) < 0)
+                break;
+        }
+    }
+    if (!m_output.empty())
+    {
+        m_nb_emitted += m_output.size();
+        m_sink(stdutils::make_const_span(m_output));
+        m_output.clear();
+    }
+}
+
+template <typename I>
+FaceSink<I> binary_face_writer(std::ostream& out)
+{
+    return [&out](stdutils::Span<const graphs::Triangle<I>> faces) {
+        std::vector<I> buffer;
+        buffer.reserve(3 * faces.size());
+        for (const auto& face : faces)
+        {
+            buffer.push_back(face[0]);
+            buffer.push_back(face[1]);
+            buffer.push_back(face[2]);
+        }
+        out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(I)));
+    };
+}
+
+template <typename F, typename I>
+bool triangulate_streaming(stdutils::Span<const shapes::Point2d<F>> sorted_points, std::size_t chunk_size, const FaceSink<I>& sink, const stdutils::io::ErrorHandler* err_handler)
+{
+    assert(chunk_size > 0);
+    StreamingTriangulation<F, I> triangulation(sink, err_handler);
+    for (std::size_t begin_idx = 0; begin_idx < sorted_points.size(); begin_idx += chunk_size)
+    {
+        const std::size_t end_idx = std::min(begin_idx + chunk_size, sorted_points.size());
+        const F front = end_idx < sorted_points.size() ? sorted_points[end_idx].x : std::numeric_limits<F>::max();
+        if (!triangulation.add_chunk(stdutils::Span<const shapes::Point2d<F>>(sorted_points.data() + begin_idx, end_idx - begin_idx), front))
+            return false;
+    }
+    triangulation.finish();
+    return true;
+}
+
+template <typename I>
+bool triangulate_shb_file_streaming(const std::filesystem::path& filepath, std::size_t chunk_size, const FaceSink<I>& sink, const stdutils::io::ErrorHandler& err_handler)
+{
+    assert(chunk_size > 0);
+    try
+    {
+        stdutils::io::MappedFile mapped_file;
+        if (!mapped_file.open(filepath))
+        {
+            std::stringstream oss;
+            oss << "Could not open file " << filepath;
+            err_handler(stdutils::io::Severity::ERR, oss.str());
+            return false;
+        }
+        std::vector<shapes::io::shb::ChunkView> chunks;
+        if (!shapes::io::shb::view_chunks(mapped_file.view(), chunks, err_handler))
+            return false;
+        chunks.erase(std::remove_if(chunks.begin(), chunks.end(), [](const auto& chunk) { return chunk.shape_type != 0; }), chunks.end());   // shapes::PointCloud2d
+
+        // Front of a range of points: The first coordinate of the next range, if any
+        StreamingTriangulation<double, I> triangulation(sink, &err_handler);
+        std::vector<shapes::Point2d<double>> buffer;
+        buffer.reserve(chunk_size);
+        for (std::size_t chunk_idx = 0; chunk_idx < chunks.size(); chunk_idx++)
+        {
+            const auto& coordinates = chunks[chunk_idx].coordinates;
+            const std::size_t nb_points = coordinates.size() / 2;
+            for (std::size_t begin_idx = 0; begin_idx < nb_points; begin_idx += chunk_size)
+            {
+                const std::size_t end_idx = std::min(begin_idx + chunk_size, nb_points);
+                buffer.clear();
+                for (std::size_t idx = begin_idx; idx < end_idx; idx++)
+                    buffer.emplace_back(coordinates[2 * idx], coordinates[2 * idx + 1]);
+                double front = std::numeric_limits<double>::max();
+                if (end_idx < nb_points) { front = coordinates[2 * end_idx]; }
+                else
+                {
+                    const auto next = std::find_if(chunks.cbegin() + static_cast<std::ptrdiff_t>(chunk_idx) + 1, chunks.cend(), [](const auto& chunk) { return !chunk.coordinates.empty(); });
+                    if (next != chunks.cend()) { front = next->coordinates[0]; }
+                }
+                if (!triangulation.add_chunk(stdutils::make_const_span(buffer), front))
+                    return false;
+            }
+        }
+        triangulation.finish();
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream oss;
+        oss << "Exception in delaunay::triangulate_shb_file_streaming<>: " << e.what();
+        err_handler(stdutils::io::Severity::EXCPT, oss.str());
+    }
+    return false;
+}
+
+} // namespace delaunay
@@ -0,0 +1,398 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <dt/dt_impl.h>
+#include <dt/dt_interface.h>
+#include <graphs/graph.h>
+#include <graphs/index.h>
+#include <graphs/triangulation.h>
+#include <shapes/bounding_box.h>
+#include <shapes/point.h>
+#include <shapes/predicates.h>
+#include <shapes/spatial_index.h>
+#include <shapes/triangle.h>
+#include <stdutils/io.h>
+#include <stdutils/parallel.h>
+#include <stdutils/span.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace delaunay {
+
+/**
+ * Tiled Delaunay triangulation of a point cloud
+ *
+ * A point cloud too large for one triangulation, e.g. a national-scale elevation dataset, is split along a grid of tiles that are triangulated
+ * independently, for instance on separate machines, then merged. Each tile is triangulated with its own points and those of its halo, a margin
+ * around the tile, so that the faces near the border of the tile are, most of the time, faces of the global triangulation.
+ *
+ * The merge keeps each face of the global Delaunay triangulation once:
+ *  - A face is owned by the tile of its circumcenter (the tiles on the border of the grid extend to infinity), and it is kept if it is a face
+ *    of the global triangulation. That is certain if its circumcircle lies inside the halo of the tile, otherwise it is checked against all
+ *    the points.
+ *  - The seams are the faces still missing, whose circumcircle reaches beyond the halo, and the tiles without a triangulation. The vertices of
+ *    the border of the merged faces and the points they do not reference are triangulated, and the faces of that triangulation that are
+ *    faces of the global one fill the seams.
+ *
+ * The result is the Delaunay triangulation of all the points, whatever the width of the halo: A narrow halo only makes the seams larger. With
+ * four or more co-circular points, it is one of the Delaunay triangulations. The points must not have duplicates, see deduplicate_points().
+ */
+template <typename F>
+struct TileLayout
+{
+    shapes::BoundingBox2d<F> bounding_box;
+    unsigned int nb_columns{1};
+    unsigned int nb_rows{1};
+    F halo{0};                                      // Width of the margin around each tile
+
+    std::size_t nb_tiles() const noexcept { return static_cast<std::size_t>(nb_columns) * nb_rows; }
+    std::size_t tile_of(const shapes::Point2d<F>& p) const;
+    shapes::BoundingBox2d<F> core(std::size_t tile_idx) const;
+    shapes::BoundingBox2d<F> extended(std::size_t tile_idx) const;      // The core and its halo
+};
+
+// The halo is halo_ratio times the smaller side of a tile
+template <typename F>
+TileLayout<F> make_tile_layout(const shapes::BoundingBox2d<F>& bounding_box, unsigned int nb_columns, unsigned int nb_rows, F halo_ratio);
+
+template <typename F>
+struct TilePoints
+{
+    shapes::Points2d<F> core;                       // The points of the tile
+    shapes::Points2d<F> halo;                       // The points of the other tiles inside the halo
+};
+
+template <typename F>
+std::vector<TilePoints<F>> split_in_tiles(const TileLayout<F>& layout, const shapes::Points2d<F>& points);
+
+template <typename F, typename I = std::uint32_t>
+struct TileMerge
+{
+    shapes::Triangles2d<F, I> triangles;            // The vertices are the input points
+    std::size_t nb_tile_faces{0};                   // Faces of the tile triangulations kept
+    std::size_t nb_checked_faces{0};                // Faces owned by a tile whose circumcircle reaches beyond the halo, checked against all the points
+    std::size_t nb_rejected_faces{0};               // Checked faces that are not Delaunay
+    std::size_t nb_seam_vertices{0};                // Vertices triangulated to fill the seams
+    std::size_t nb_seam_faces{0};                   // Faces added along the seams
+};
+
+// tile_triangulations[tile_idx] is the triangulation of the core and halo points of the tile. It can be empty, e.g. if the tile failed. Its
+// vertices are matched with the points by their coordinates.
+template <typename F, typename I>
+TileMerge<F, I> merge_tiles(const RegisteredImpl<F, I>& registered_impl, const TileLayout<F>& layout, const shapes::Points2d<F>& points, const std::vector<shapes::Triangles2d<F, I>>& tile_triangulations, const stdutils::io::ErrorHandler& err_handler, const stdutils::parallel::Policy& parallel_policy = stdutils::parallel::Policy());
+
+
+//
+//
+// Implementation
+//
+//
+
+
+template <typename F>
+std::size_t TileLayout<F>::tile_of(const shapes::Point2d<F>& p) const
+{
+    assert(nb_columns > 0 && nb_rows > 0);
+    const auto cell = [](F v, F min, F length, unsigned int nb_cells) -> std::size_t {
+        const F pos = length > F{0} ? std::floor((v - min) * static_cast<F>(nb_cells) / length) : F{0};
+        return pos <= F{0} ? 0 : std::min(static_cast<std::size_t>(pos), static_cast<std::size_t>(nb_cells - 1));
+    };
+    const std::size_t column = cell(p.x, bounding_box.min().x, bounding_box.width(), nb_columns);
+    const std::size_t row = cell(p.y, bounding_box.min().y, bounding_box.height(), nb_rows);
+    return row * nb_columns + column;
+}
+
+template <typename F>
+shapes::BoundingBox2d<F> TileLayout<F>::core(std::size_t tile_idx) const
+{
+    assert(tile_idx < nb_tiles());
+    const std::size_t column = tile_idx % nb_columns;
+    const std::size_t row = tile_idx / nb_columns;
+    const auto bound = [](F min, F length, std::size_t k, unsigned int nb_cells) { return min + length * static_cast<F>(k) / static_cast<F>(nb_cells); };
+    const auto min = bounding_box.min();
+    shapes::BoundingBox2d<F> result;
+    result.add(bound(min.x, bounding_box.width(), column, nb_columns), bound(min.y, bounding_box.height(), row, nb_rows));
+    result.add(bound(min.x, bounding_box.width(), column + 1, nb_columns), bound(min.y, bounding_box.height(), row + 1, nb_rows));
+    return result;
+}
+
+template <typename F>
+shapes::BoundingBox2d<F> TileLayout<F>::extended(std::size_t tile_idx) const
+{
+    auto result = core(tile_idx);
+    result.add_border(halo);
+    return result;
+}
+
+template <typename F>
+TileLayout<F> make_tile_layout(const shapes::BoundingBox2d<F>& bounding_box, unsigned int nb_columns, unsigned int nb_rows, F halo_ratio)
+{
+    assert(bounding_box.is_populated());
+    TileLayout<F> result;
+    result.bounding_box = bounding_box;
+    result.nb_columns = std::max(nb_columns, 1u);
+    result.nb_rows = std::max(nb_rows, 1u);
+    const F tile_side = std::min(bounding_box.width() / static_cast<F>(result.nb_columns), bounding_box.height() / static_cast<F>(result.nb_rows));
+    result.halo = std::max(halo_ratio, F{0}) * tile_side;
+    return result;
+}
+
+template <typename F>
+std::vector<TilePoints<F>> split_in_tiles(const TileLayout<F>& layout, const shapes::Points2d<F>& points)
+{
+    std::vector<TilePoints<F>> result(layout.nb_tiles());
+    const auto contains = [](const shapes::BoundingBox2d<F>& bb, const shapes::Point2d<F>& p) {
+        return bb.rx.min <= p.x && p.x <= bb.rx.max && bb.ry.min <= p.y && p.y <= bb.ry.max;
+    };
+    for (const auto& p : points)
+    {
+        const std::size_t owner_idx = layout.tile_of(p);
+        result[owner_idx].core.push_back(p);
+        if (layout.halo <= F{0})
+            continue;
+
+        // The tiles whose halo may contain p
+        const std::size_t first_idx = layout.tile_of(shapes::Point2d<F>{ p.x - layout.halo, p.y - layout.halo });
+        const std::size_t last_idx = layout.tile_of(shapes::Point2d<F>{ p.x + layout.halo, p.y + layout.halo });
+        for (std::size_t row = first_idx / layout.nb_columns; row <= last_idx / layout.nb_columns; row++)
+        {
+            for (std::size_t column = first_idx % layout.nb_columns; column <= last_idx % layout.nb_columns; column++)
+            {
+                const std::size_t tile_idx = row * layout.nb_columns + column;
+                if (tile_idx != owner_idx && contains(layout.extended(tile_idx), p)) { result[tile_idx].halo.push_back(p); }
+            }
+        }
+    }
+    return result;
+}
+
+namespace details {
+namespace tiling {
+
+// Find the index of a point by its coordinates
+template <typename F, typename I>
+class PointLocator
+{
+public:
+    explicit PointLocator(const shapes::Points2d<F>& points)
+        : m_points(points)
+        , m_order(points.size())
+    {
+        std::iota(m_order.begin(), m_order.end(), I{0});
+        std::sort(m_order.begin(), m_order.end(), [this](I lhs, I rhs) { return shapes::less<shapes::Point2d<F>>()(m_points[lhs], m_points[rhs]); });
+    }
+
+    I find(const shapes::Point2d<F>& p) const
+    {
+        const auto it = std::lower_bound(m_order.cbegin(), m_order.cend(), p, [this](I idx, const shapes::Point2d<F>& q) { return shapes::less<shapes::Point2d<F>>()(m_points[idx], q); });
+        return (it != m_order.cend() && m_points[*it] == p) ? *it : graphs::IndexTraits<I>::undef();
+    }
+
+private:
+    const shapes::Points2d<F>& m_points;
+    std::vector<I> m_order;
+};
+
+// Return false if the triangle is degenerate
+template <typename F>
+bool circumcircle(const shapes::Point2d<F>& a, const shapes::Point2d<F>& b, const shapes::Point2d<F>& c, shapes::Point2d<F>& center, F& radius)
+{
+    const F bx = b.x - a.x, by = b.y - a.y;
+    const F cx = c.x - a.x, cy = c.y - a.y;
+    const F d = F{2} * (bx * cy - by * cx);
+    if (d == F{0})
+        return false;
+    const F b_sq = bx * bx + by * by;
+    const F c_sq = cx * cx + cy * cy;
+    const F ux = (cy * b_sq - by * c_sq) / d;
+    const F uy = (bx * c_sq - cx * b_sq) / d;
+    center.x = a.x + ux;
+    center.y = a.y + uy;
+    radius = std::sqrt(ux * ux + uy * uy);
+    return std::isfinite(radius);
+}
+
+// The face in counterclockwise order, starting with its smallest index, so that the same face gives the same circumcircle in all the tiles.
+// Return false if the face is degenerate or references an unknown vertex.
+template <typename F, typename I>
+bool normalize(const shapes::Points2d<F>& points, graphs::Triangle<I>& face)
+{
+    for (std::size_t k = 0; k < 3; k++) { if (!graphs::is_defined(face[k])) { return false; } }
+    while (face[0] > face[1] || face[0] > face[2]) { face = graphs::Triangle<I>(face[1], face[2], face[0]); }
+    const double orientation = shapes::orient2d(points[face[0]], points[face[1]], points[face[2]]);
+    if (orientation == 0.0)
+        return false;
+    if (orientation < 0.0) { face = graphs::Triangle<I>(face[0], face[2], face[1]); }
+    return true;
+}
+
+// No point strictly inside the circumcircle of the face, which is in counterclockwise order
+template <typename F, typename I>
+bool is_delaunay(const shapes::KdTree<F, I>& kdtree, const shapes::Points2d<F>& points, const graphs::Triangle<I>& face, const shapes::Point2d<F>& center, F radius, std::vector<I>& candidates)
+{
+    kdtree.radius(center, radius * (F{1} + F{1e-6}), candidates);
+    const auto& a = points[face[0]];
+    const auto& b = points[face[1]];
+    const auto& c = points[face[2]];
+    return std::none_of(candidates.cbegin(), candidates.cend(), [&](I idx) {
+        return idx != face[0] && idx != face[1] && idx != face[2] && shapes::incircle(a, b, c, points[idx]) > 0.0;
+    });
+}
+
+// The merged faces, and their half-edges: A face is only added if none of its half-edges is already present, therefore the faces do not overlap.
+template <typename I>
+class MergedFaces
+{
+public:
+    bool can_add(const graphs::Triangle<I>& face) const
+    {
+        const auto half_edges = half_edges_of(face);
+        return std::none_of(half_edges.cbegin(), half_edges.cend(), [this](const HalfEdge& e) { return m_half_edges.count(e) > 0; });
+    }
+
+    bool add(const graphs::Triangle<I>& face)
+    {
+        if (!can_add(face))
+            return false;
+        const auto half_edges = half_edges_of(face);
+        m_half_edges.insert(half_edges.cbegin(), half_edges.cend());
+        m_faces.push_back(face);
+        return true;
+    }
+
+    // The vertices of the half-edges without a twin, i.e. on the border of the merged faces, and the unreferenced vertices
+    std::vector<I> seam_vertices(std::size_t nb_points) const
+    {
+        std::vector<std::uint8_t> is_seam(nb_points, 1);
+        for (const auto& e : m_half_edges) { is_seam[e.first] = 0; }
+        for (const auto& e : m_half_edges)
+        {
+            if (m_half_edges.count(HalfEdge{ e.second, e.first }) == 0) { is_seam[e.first] = 1; is_seam[e.second] = 1; }
+        }
+        std::vector<I> result;
+        for (std::size_t idx = 0; idx < nb_points; idx++) { if (is_seam[idx]) { result.push_back(static_cast<I>(idx)); } }
+        return result;
+    }
+
+    graphs::TriangleSoup<I>& faces() { return m_faces; }
+
+private:
+    using HalfEdge = std::pair<I, I>;
+    static std::array<HalfEdge, 3> half_edges_of(const graphs::Triangle<I>& face) { return { HalfEdge{ face[0], face[1] }, HalfEdge{ face[1], face[2] }, HalfEdge{ face[2], face[0] } }; }
+    struct HalfEdgeHash
+    {
+        std::size_t operator()(const HalfEdge& e) const noexcept { return std::hash<std::uint64_t>()((static_cast<std::uint64_t>(e.first) << 32) ^ static_cast<std::uint64_t>(e.second)); }
+    };
+
+    std::unordered_set<HalfEdge, HalfEdgeHash> m_half_edges;
+    graphs::TriangleSoup<I> m_faces;
+};
+
+} // namespace tiling
+} // namespace details
+
+template <typename F, typename I>
+TileMerge<F, I> merge_tiles(const RegisteredImpl<F, I>& registered_impl, const TileLayout<F>& layout, const shapes::Points2d<F>& points, const std::vector<shapes::Triangles2d<F, I>>& tile_triangulations, const stdutils::io::ErrorHandler& err_handler, const stdutils::parallel::Policy& parallel_policy)
+{
+    using namespace details::tiling;
+    assert(tile_triangulations.size() == layout.nb_tiles());
+    TileMerge<F, I> result;
+    result.triangles.vertices = points;
+    if (points.size() < 3)
+        return result;
+    const PointLocator<F, I> locator(points);
+    const shapes::KdTree<F, I> kdtree(parallel_policy, stdutils::make_const_span(points));
+    MergedFaces<I> merged;
+
+    // The faces owned by each tile and that are Delaunay. The tiles are processed concurrently, then merged in order.
+    struct TileFaces
+    {
+        graphs::TriangleSoup<I> faces;
+        std::size_t nb_checked{0};
+        std::size_t nb_rejected{0};
+    };
+    std::vector<TileFaces> tile_faces(tile_triangulations.size());
+    const std::size_t nb_workers = stdutils::parallel::nb_workers(parallel_policy, tile_triangulations.size());
+    std::vector<std::vector<I>> candidates(nb_workers);
+    stdutils::parallel::for_each_dynamic(parallel_policy, tile_triangulations.size(), [&](std::size_t worker_idx, std::size_t tile_idx) {
+        const auto& tile = tile_triangulations[tile_idx];
+        const auto extended = layout.extended(tile_idx);
+        auto& out = tile_faces[tile_idx];
+        std::vector<I> remap(tile.vertices.size());
+        std::transform(tile.vertices.cbegin(), tile.vertices.cend(), remap.begin(), [&locator](const auto& p) { return locator.find(p); });
+        for (const auto& tile_face : tile.faces)
+        {
+            const auto tile_vertex = [&remap](I idx) { return idx < remap.size() ? remap[idx] : graphs::IndexTraits<I>::undef(); };
+            graphs::Triangle<I> face(tile_vertex(tile_face[0]), tile_vertex(tile_face[1]), tile_vertex(tile_face[2]));
+            shapes::Point2d<F> center;
+            F radius = F{0};
+            if (!normalize(points, face) || !circumcircle(points[face[0]], points[face[1]], points[face[2]], center, radius))
+                continue;
+            if (layout.tile_of(center) != tile_idx)
+                continue;
+            const F margin = radius * (F{1} + F{1e-6});
+            const bool inside_halo = extended.rx.min <= center.x - margin && center.x + margin <= extended.rx.max
+                                  && extended.ry.min <= center.y - margin && center.y + margin <= extended.ry.max;
+            if (!inside_halo)
+            {
+                out.nb_checked++;
+                if (!is_delaunay(kdtree, points, face, center, radius, candidates[worker_idx])) { out.nb_rejected++; continue; }
+            }
+            out.faces.push_back(face);
+        }
+    });
+    for (auto& tile : tile_faces)
+    {
+        for (const auto& face : tile.faces) { if (merged.add(face)) { result.nb_tile_faces++; } }
+        result.nb_checked_faces += tile.nb_checked;
+        result.nb_rejected_faces += tile.nb_rejected;
+        tile = TileFaces();
+    }
+
+    // Fill the seams
+    const std::vector<I> seam_vertices = merged.seam_vertices(points.size());
+    result.nb_seam_vertices = seam_vertices.size();
+    if (seam_vertices.size() >= 3)
+    {
+        shapes::Points2d<F> seam_points;
+        seam_points.reserve(seam_vertices.size());
+        for (const I idx : seam_vertices) { seam_points.push_back(points[idx]); }
+        auto algo = get_impl(registered_impl, &err_handler);
+        assert(algo);
+        algo->add_steiner(stdutils::make_const_span(seam_points));
+        const auto seam_triangulation = algo->triangulate(TriangulationPolicy::PointCloud);
+        const PointLocator<F, I> seam_locator(seam_points);
+        std::vector<I> seam_candidates;
+        for (const auto& seam_face : seam_triangulation.faces)
+        {
+            const auto seam_vertex = [&](I idx) {
+                const I seam_idx = idx < seam_triangulation.vertices.size() ? seam_locator.find(seam_triangulation.vertices[idx]) : graphs::IndexTraits<I>::undef();
+                return graphs::is_defined(seam_idx) ? seam_vertices[seam_idx] : seam_idx;
+            };
+            graphs::Triangle<I> face(seam_vertex(seam_face[0]), seam_vertex(seam_face[1]), seam_vertex(seam_face[2]));
+            shapes::Point2d<F> center;
+            F radius = F{0};
+            if (!normalize(points, face) || !circumcircle(points[face[0]], points[face[1]], points[face[2]], center, radius))
+                continue;
+            if (merged.can_add(face) && is_delaunay(kdtree, points, face, center, radius, seam_candidates) && merged.add(face)) { result.nb_seam_faces++; }
+        }
+    }
+
+    result.triangles.faces = std::move(merged.faces());
+    result.triangles.adjacency = graphs::triangle_adjacency(result.triangles.faces);
+    return result;
+}
+
+} // namespace delaunay
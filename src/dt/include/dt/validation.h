@@ -0,0 +1,220 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <graphs/graph.h>
+#include <graphs/index.h>
+#include <shapes/point.h>
+#include <shapes/predicates.h>
+#include <shapes/triangle.h>
+#include <stdutils/io.h>
+#include <stdutils/parallel.h>
+#include <stdutils/profiler.h>
+#include <stdutils/span.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <vector>
+
+namespace delaunay {
+
+/**
+ * Validation of the output of a triangulation, cheap enough to be enabled in release builds
+ *
+ * All the checks are O(n) and computed concurrently, without the sets of the debug checks (see shapes::is_valid):
+ *  - The vertex indices are in bounds, and the faces have three distinct vertices
+ *  - The faces have a non-zero area, and all of them have the same orientation
+ *  - The adjacency, if any, is in bounds and symmetric
+ *  - Optionally, the Delaunay criterion is checked on a sample of the edges. An edge is reported if the opposite vertex is strictly inside
+ *    the circumcircle. The faces of a CDT do not have that property along the constraints, therefore it should not be checked for that policy.
+ *
+ * The orientations and the in-circle tests are exact, and evaluated by batches (see shapes/predicates.h).
+ */
+struct ValidationOptions
+{
+    std::size_t nb_delaunay_samples = 0;            // Number of faces whose edges are checked against the Delaunay criterion. Zero to disable.
+};
+
+struct ValidationReport
+{
+    std::size_t nb_out_of_bounds = 0;               // Faces with a vertex index out of bounds
+    std::size_t nb_degenerate = 0;                  // Faces with a repeated vertex or a zero area
+    std::size_t nb_flipped = 0;                     // Faces whose orientation is opposite to that of the majority
+    std::size_t nb_adjacency_errors = 0;            // Neighbors out of bounds, or which do not point back to the face
+    std::size_t nb_delaunay_checks = 0;
+    std::size_t nb_non_delaunay = 0;
+
+    // The degenerate faces are not an error: Some implementations output zero-area faces on collinear inputs.
+    bool is_valid() const noexcept { return nb_out_of_bounds == 0 && nb_flipped == 0 && nb_adjacency_errors == 0 && nb_non_delaunay == 0; }
+};
+
+template <typename F, typename I>
+ValidationReport validate(const stdutils::parallel::Policy& policy, const shapes::Triangles2d<F, I>& triangles, const ValidationOptions& options);
+
+// Report the errors, if any, to the handler. Return report.is_valid().
+bool report_validation(const ValidationReport& report, const stdutils::io::ErrorHandler& err_handler);
+
+
+//
+//
+// Implementation
+//
+//
+
+
+namespace details {
+namespace validation {
+
+struct Counters
+{
+    std::size_t nb_out_of_bounds = 0;
+    std::size_t nb_degenerate = 0;
+    std::size_t nb_ccw = 0;
+    std::size_t nb_cw = 0;
+    std::size_t nb_adjacency_errors = 0;
+};
+
+} // namespace validation
+} // namespace details
+
+template <typename F, typename I>
+ValidationReport validate(const stdutils::parallel::Policy& policy, const shapes::Triangles2d<F, I>& triangles, const ValidationOptions& options)
+{
+    STDUTILS_PROFILE_ZONE("delaunay::validate");
+    using Counters = details::validation::Counters;
+    const auto& faces = triangles.faces;
+    const auto& vertices = triangles.vertices;
+    const auto& adjacency = triangles.adjacency;
+    const std::size_t nb_faces = faces.size();
+    const std::size_t nb_vertices = vertices.size();
+    const bool check_adjacency = !adjacency.empty();
+    ValidationReport report;
+    if (check_adjacency && adjacency.size() != nb_faces) { report.nb_adjacency_errors = std::max(adjacency.size(), nb_faces) - std::min(adjacency.size(), nb_faces); }
+
+    // Faces. Record the sign of the orientation of each face for the Delaunay check.
+    std::vector<std::int8_t> orientation(nb_faces, 0);
+    std::vector<Counters> chunk_counters(stdutils::parallel::nb_chunks(policy, nb_faces));
+    const auto vertices_span = stdutils::make_const_span(vertices);
+    stdutils::parallel::for_each_chunk(policy, nb_faces, [&](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+        auto& counters = chunk_counters[chunk_idx];
+        const auto in_bounds = [nb_vertices](const auto& t) {
+            return static_cast<std::size_t>(t[0]) < nb_vertices && static_cast<std::size_t>(t[1]) < nb_vertices && static_cast<std::size_t>(t[2]) < nb_vertices;
+        };
+        if (std::all_of(faces.cbegin() + static_cast<std::ptrdiff_t>(begin_idx), faces.cbegin() + static_cast<std::ptrdiff_t>(end_idx), in_bounds))
+        {
+            shapes::orient2d_signs(vertices_span, stdutils::Span<const graphs::Triangle<I>>(faces.data() + begin_idx, end_idx - begin_idx), stdutils::Span<std::int8_t>(orientation.data() + begin_idx, end_idx - begin_idx));
+        }
+        else
+        {
+            for (std::size_t f = begin_idx; f < end_idx; f++)
+            {
+                const auto& t = faces[f];
+                if (!in_bounds(t))
+                    continue;
+                const double o = shapes::orient2d(vertices[t[0]], vertices[t[1]], vertices[t[2]]);
+                orientation[f] = static_cast<std::int8_t>((o > 0.0) - (o < 0.0));
+            }
+        }
+        for (std::size_t f = begin_idx; f < end_idx; f++)
+        {
+            const auto& t = faces[f];
+            if (!in_bounds(t))
+            {
+                counters.nb_out_of_bounds++;
+                continue;
+            }
+            if (t[0] == t[1] || t[1] == t[2] || t[2] == t[0] || orientation[f] == 0) { orientation[f] = 0; counters.nb_degenerate++; }
+            else if (orientation[f] > 0) { counters.nb_ccw++; }
+            else { counters.nb_cw++; }
+            if (check_adjacency && f < adjacency.size())
+            {
+                for (std::size_t k = 0; k < 3; k++)
+                {
+                    const I n = adjacency[f][k];
+                    if (!graphs::is_defined(n))
+                        continue;
+                    const bool points_back = static_cast<std::size_t>(n) < adjacency.size()
+                        && std::find(adjacency[n].cbegin(), adjacency[n].cend(), static_cast<I>(f)) != adjacency[n].cend();
+                    if (!points_back) { counters.nb_adjacency_errors++; }
+                }
+            }
+        }
+    });
+    Counters total;
+    for (const auto& counters : chunk_counters)
+    {
+        total.nb_out_of_bounds += counters.nb_out_of_bounds;
+        total.nb_degenerate += counters.nb_degenerate;
+        total.nb_ccw += counters.nb_ccw;
+        total.nb_cw += counters.nb_cw;
+        total.nb_adjacency_errors += counters.nb_adjacency_errors;
+    }
+    report.nb_out_of_bounds = total.nb_out_of_bounds;
+    report.nb_degenerate = total.nb_degenerate;
+    report.nb_flipped = std::min(total.nb_ccw, total.nb_cw);
+    report.nb_adjacency_errors += total.nb_adjacency_errors;
+
+    // Sampled Delaunay check, on faces evenly spaced in the list
+    if (options.nb_delaunay_samples == 0 || !shapes::has_adjacency(triangles) || report.nb_out_of_bounds > 0 || report.nb_adjacency_errors > 0)
+        return report;
+    // Gather a batch of in-circle tests per chunk: The sampled faces in counterclockwise order, and the vertices opposite to their edges
+    const std::size_t nb_samples = std::min(options.nb_delaunay_samples, nb_faces);
+    std::vector<std::size_t> chunk_checks(stdutils::parallel::nb_chunks(policy, nb_samples), 0);
+    std::vector<std::size_t> chunk_failures(chunk_checks.size(), 0);
+    stdutils::parallel::for_each_chunk(policy, nb_samples, [&](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+        graphs::TriangleSoup<I> ccw_faces;
+        std::vector<I> opposites;
+        ccw_faces.reserve(3 * (end_idx - begin_idx));
+        opposites.reserve(3 * (end_idx - begin_idx));
+        for (std::size_t s = begin_idx; s < end_idx; s++)
+        {
+            const std::size_t f = s * nb_faces / nb_samples;
+            if (orientation[f] == 0)
+                continue;
+            const auto& t = faces[f];
+            for (std::size_t k = 0; k < 3; k++)
+            {
+                const I n = adjacency[f][k];
+                if (!graphs::is_defined(n) || orientation[n] == 0)
+                    continue;
+                const auto& tn = faces[n];
+                const I opposite = tn[0] != t[k] && tn[0] != t[(k + 1u) % 3u] ? tn[0] : (tn[1] != t[k] && tn[1] != t[(k + 1u) % 3u] ? tn[1] : tn[2]);
+                ccw_faces.push_back(orientation[f] > 0 ? t : graphs::Triangle<I>(t[0], t[2], t[1]));
+                opposites.push_back(opposite);
+            }
+        }
+        std::vector<std::int8_t> signs(ccw_faces.size());
+        shapes::incircle_signs(vertices_span, stdutils::make_const_span(ccw_faces), stdutils::make_const_span(opposites), stdutils::make_span(signs));
+        chunk_checks[chunk_idx] = signs.size();
+        chunk_failures[chunk_idx] = static_cast<std::size_t>(std::count(signs.cbegin(), signs.cend(), std::int8_t{1}));
+    });
+    for (std::size_t chunk_idx = 0; chunk_idx < chunk_checks.size(); chunk_idx++)
+    {
+        report.nb_delaunay_checks += chunk_checks[chunk_idx];
+        report.nb_non_delaunay += chunk_failures[chunk_idx];
+    }
+    return report;
+}
+
+inline bool report_validation(const ValidationReport& report, const stdutils::io::ErrorHandler& err_handler)
+{
+    if (!err_handler)
+        return report.is_valid();
+    const auto report_count = [&err_handler](stdutils::io::SeverityCode code, std::size_t count, const char* what) {
+        if (count == 0)
+            return;
+        std::stringstream out;
+        out << "Triangulation output: " << count << " " << what;
+        err_handler(code, out.str());
+    };
+    report_count(stdutils::io::Severity::ERR, report.nb_out_of_bounds, "faces with a vertex index out of bounds");
+    report_count(stdutils::io::Severity::WARN, report.nb_degenerate, "degenerate faces");
+    report_count(stdutils::io::Severity::ERR, report.nb_flipped, "faces with the wrong orientation");
+    report_count(stdutils::io::Severity::ERR, report.nb_adjacency_errors, "inconsistent neighbors in the adjacency");
+    report_count(stdutils::io::Severity::ERR, report.nb_non_delaunay, "sampled edges breaking the Delaunay criterion");
+    return report.is_valid();
+}
+
+} // namespace delaunay
@@ -0,0 +1,88 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <dt/auto_select.h>
+
+#include <sstream>
+
+namespace delaunay {
+
+namespace {
+
+SelectionProfile& default_profile()
+{
+    static SelectionProfile profile;
+    return profile;
+}
+
+const char* str_policy(TriangulationPolicy policy)
+{
+    return policy == TriangulationPolicy::CDT ? "cdt" : "pc";
+}
+
+} // namespace
+
+SelectionProfile parse_selection_profile(std::istream& in, const stdutils::io::ErrorHandler& err_handler)
+{
+    SelectionProfile result;
+    auto linestream = stdutils::io::SkipLineStream(in).skip_blank_lines().skip_comment_lines("#");
+    std::string line;
+    std::size_t line_nb = 0;
+    while (linestream.getline(line, line_nb))
+    {
+        std::istringstream iss(line);
+        SelectionProfile::Measurement measurement;
+        std::string policy;
+        iss >> measurement.algo_name >> policy >> measurement.features.nb_vertices >> measurement.features.nb_constraint_vertices >> measurement.median_ms;
+        if (iss.fail() || (policy != "pc" && policy != "cdt"))
+        {
+            std::stringstream out;
+            out << "Selection profile: Invalid measurement on line " << line_nb;
+            err_handler(stdutils::io::Severity::ERR, out.str());
+            continue;
+        }
+        measurement.features.policy = policy == "cdt" ? TriangulationPolicy::CDT : TriangulationPolicy::PointCloud;
+        result.measurements.emplace_back(std::move(measurement));
+    }
+    return result;
+}
+
+void write_selection_profile(std::ostream& out, const SelectionProfile& profile)
+{
+    out << "# Delaunay selection profile: <algo> <pc|cdt> <nb_vertices> <nb_constraint_vertices> <median_ms>\n";
+    for (const auto& measurement : profile.measurements)
+    {
+        out << measurement.algo_name << ' '
+            << str_policy(measurement.features.policy) << ' '
+            << measurement.features.nb_vertices << ' '
+            << measurement.features.nb_constraint_vertices << ' '
+            << measurement.median_ms << '\n';
+    }
+}
+
+SelectionProfile load_selection_profile(const std::filesystem::path& filepath, const stdutils::io::ErrorHandler& err_handler)
+{
+    const stdutils::io::StreamParser<SelectionProfile, char> parser = [](std::istream& in, const stdutils::io::ErrorHandler& handler) {
+        return parse_selection_profile(in, handler);
+    };
+    return stdutils::io::open_and_parse_txt_file(filepath, parser, err_handler);
+}
+
+void save_selection_profile(const std::filesystem::path& filepath, const SelectionProfile& profile, const stdutils::io::ErrorHandler& err_handler)
+{
+    const stdutils::io::StreamWriter<SelectionProfile, char> writer = [](std::ostream& out, const SelectionProfile& obj, const stdutils::io::ErrorHandler&) {
+        write_selection_profile(out, obj);
+    };
+    stdutils::io::save_txt_file(filepath, writer, profile, err_handler);
+}
+
+void set_default_selection_profile(SelectionProfile profile)
+{
+    default_profile() = std::move(profile);
+}
+
+const SelectionProfile& default_selection_profile()
+{
+    return default_profile();
+}
+
+} // namespace delaunay
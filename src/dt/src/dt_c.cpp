@@ -0,0 +1,293 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <dt/dt_c.h>
+
+#include <dt/dt_impl.h>
+#include <dt/dt_interface.h>
+#include <shapes/point.h>
+#include <shapes/triangle.h>
+#include <stdutils/io.h>
+#include <stdutils/span.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+using Algo = delaunay::Interface<double, std::uint32_t>;
+
+// The input and the output are reinterpreted as arrays of these types when they are tightly packed
+static_assert(sizeof(shapes::Point2d<double>) == 2 * sizeof(double));
+static_assert(alignof(shapes::Point2d<double>) == alignof(double));
+static_assert(sizeof(shapes::Triangles2d<double, std::uint32_t>::face) == 3 * sizeof(std::uint32_t));
+
+struct dt_triangulation
+{
+    delaunay::RegisteredImpl<double, std::uint32_t> registered_impl;    // Referred to by the error handler of the algorithm
+    std::string last_error;
+    std::unique_ptr<Algo> algo;
+    std::vector<shapes::Point2d<double>> gathered_vertices;              // Strided input
+    shapes::Triangles2d<double, std::uint32_t> result;
+    bool has_result{false};
+};
+
+namespace {
+
+constexpr std::size_t PACKED_STRIDE = 2 * sizeof(double);
+
+std::vector<delaunay::RegisteredImpl<double, std::uint32_t>>& implementation_list()
+{
+    static std::vector<delaunay::RegisteredImpl<double, std::uint32_t>> algos;
+    return algos;
+}
+
+// Record the errors, the latest one being returned by dt_last_error()
+stdutils::io::ErrorHandler error_recorder(dt_triangulation* handle)
+{
+    return [handle](stdutils::io::SeverityCode code, stdutils::io::ErrorMessage msg) {
+        if (code <= stdutils::io::Severity::ERR) { handle->last_error = msg; }
+    };
+}
+
+dt_status report(dt_triangulation* handle, dt_status status, const char* msg)
+{
+    handle->last_error = msg;
+    return status;
+}
+
+void clear_input_and_result(dt_triangulation* handle) noexcept
+{
+    handle->algo->clear();
+    handle->result.vertices.clear();
+    handle->result.faces.clear();
+    handle->result.adjacency.clear();
+    handle->has_result = false;
+}
+
+// The input was consumed by the previous triangulation
+void start_new_input(dt_triangulation* handle) noexcept
+{
+    if (handle->has_result) { clear_input_and_result(handle); }
+}
+
+// Tightly packed and aligned input is passed as it is, the rest is gathered in the buffer of the handle. xy may be null if there are no vertices.
+Algo::Points input_vertices(dt_triangulation* handle, const double* xy, std::size_t nb_vertices, std::size_t stride)
+{
+    if (nb_vertices == 0) { return Algo::Points(); }
+    if (stride == 0) { stride = PACKED_STRIDE; }
+    const auto* bytes = reinterpret_cast<const unsigned char*>(xy);
+    if (stride == PACKED_STRIDE && reinterpret_cast<std::uintptr_t>(xy) % alignof(double) == 0)
+        return Algo::Points(reinterpret_cast<const shapes::Point2d<double>*>(xy), nb_vertices);
+    auto& gathered = handle->gathered_vertices;
+    gathered.resize(nb_vertices);
+    for (std::size_t idx = 0; idx < nb_vertices; idx++)
+    {
+        std::memcpy(&gathered[idx], bytes + idx * stride, PACKED_STRIDE);
+    }
+    return Algo::Points(gathered.data(), gathered.size());
+}
+
+enum class InputKind
+{
+    Path,
+    Hole,
+    Steiner
+};
+
+dt_status add_vertices(dt_triangulation* handle, const double* xy, std::size_t nb_vertices, std::size_t stride, bool closed, InputKind kind) noexcept
+{
+    if (handle == nullptr) { return DT_INVALID_ARGUMENT; }
+    if (xy == nullptr && nb_vertices > 0) { return report(handle, DT_INVALID_ARGUMENT, "Null vertices"); }
+    if (stride != 0 && stride < PACKED_STRIDE) { return report(handle, DT_INVALID_ARGUMENT, "The stride is smaller than a vertex"); }
+    handle->last_error.clear();
+    try
+    {
+        start_new_input(handle);
+        const auto vertices = input_vertices(handle, xy, nb_vertices, stride);
+        switch (kind)
+        {
+            case InputKind::Path:    handle->algo->add_path(vertices, closed); break;
+            case InputKind::Hole:    handle->algo->add_hole(vertices, closed); break;
+            case InputKind::Steiner: handle->algo->add_steiner(vertices); break;
+        }
+    }
+    catch (const std::bad_alloc&)
+    {
+        return report(handle, DT_OUT_OF_MEMORY, "Out of memory");
+    }
+    catch (const std::exception& e)
+    {
+        return report(handle, DT_INTERNAL_ERROR, e.what());
+    }
+    return DT_OK;
+}
+
+} // namespace
+
+extern "C" {
+
+int dt_register_all_implementations(void)
+{
+    try
+    {
+        const bool success = delaunay::register_all_implementations();
+        implementation_list() = delaunay::get_impl_list<double, std::uint32_t>().algos;
+        return success ? 1 : 0;
+    }
+    catch (const std::exception&)
+    {
+        return 0;
+    }
+}
+
+size_t dt_nb_implementations(void)
+{
+    return implementation_list().size();
+}
+
+const char* dt_implementation_name(size_t idx)
+{
+    const auto& algos = implementation_list();
+    return idx < algos.size() ? algos[idx].name.c_str() : nullptr;
+}
+
+dt_triangulation* dt_create(const char* impl_name)
+{
+    try
+    {
+        const auto impl_list = delaunay::get_impl_list<double, std::uint32_t>();
+        const std::string name = impl_name ? impl_name : impl_list.reference;
+        const auto algo_it = std::find_if(std::cbegin(impl_list.algos), std::cend(impl_list.algos), [&name](const auto& algo) { return algo.name == name; });
+        if (algo_it == std::cend(impl_list.algos))
+            return nullptr;
+        auto handle = std::make_unique<dt_triangulation>();
+        handle->registered_impl = *algo_it;
+        const auto err_handler = error_recorder(handle.get());
+        handle->algo = delaunay::get_impl(handle->registered_impl, &err_handler);
+        return handle->algo ? handle.release() : nullptr;
+    }
+    catch (const std::exception&)
+    {
+        return nullptr;
+    }
+}
+
+void dt_destroy(dt_triangulation* handle)
+{
+    delete handle;
+}
+
+const char* dt_last_error(const dt_triangulation* handle)
+{
+    return handle ? handle->last_error.c_str() : "Null handle";
+}
+
+dt_status dt_clear(dt_triangulation* handle)
+{
+    if (handle == nullptr) { return DT_INVALID_ARGUMENT; }
+    clear_input_and_result(handle);
+    handle->last_error.clear();
+    return DT_OK;
+}
+
+dt_status dt_reserve(dt_triangulation* handle, size_t nb_vertices, size_t nb_constraints)
+{
+    if (handle == nullptr) { return DT_INVALID_ARGUMENT; }
+    try
+    {
+        start_new_input(handle);
+        handle->algo->reserve(nb_vertices, nb_constraints);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return report(handle, DT_OUT_OF_MEMORY, "Out of memory");
+    }
+    catch (const std::exception& e)
+    {
+        return report(handle, DT_INTERNAL_ERROR, e.what());
+    }
+    return DT_OK;
+}
+
+dt_status dt_add_path(dt_triangulation* handle, const double* xy, size_t nb_vertices, size_t stride, int closed)
+{
+    return add_vertices(handle, xy, nb_vertices, stride, closed != 0, InputKind::Path);
+}
+
+dt_status dt_add_hole(dt_triangulation* handle, const double* xy, size_t nb_vertices, size_t stride, int closed)
+{
+    return add_vertices(handle, xy, nb_vertices, stride, closed != 0, InputKind::Hole);
+}
+
+dt_status dt_add_steiner(dt_triangulation* handle, const double* xy, size_t nb_vertices, size_t stride)
+{
+    return add_vertices(handle, xy, nb_vertices, stride, false, InputKind::Steiner);
+}
+
+dt_status dt_triangulate(dt_triangulation* handle, dt_policy policy)
+{
+    if (handle == nullptr) { return DT_INVALID_ARGUMENT; }
+    if (policy != DT_POLICY_POINT_CLOUD && policy != DT_POLICY_CDT) { return report(handle, DT_INVALID_ARGUMENT, "Unknown policy"); }
+    handle->last_error.clear();
+    try
+    {
+        start_new_input(handle);
+        const auto triangulation_policy = policy == DT_POLICY_CDT ? delaunay::TriangulationPolicy::CDT : delaunay::TriangulationPolicy::PointCloud;
+        handle->result = handle->algo->triangulate_and_release(triangulation_policy);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return report(handle, DT_OUT_OF_MEMORY, "Out of memory");
+    }
+    catch (const std::exception& e)
+    {
+        return report(handle, DT_INTERNAL_ERROR, e.what());
+    }
+    if (handle->result.faces.empty())
+    {
+        if (handle->last_error.empty()) { handle->last_error = "The triangulation failed"; }
+        return DT_TRIANGULATION_FAILED;
+    }
+    handle->has_result = true;
+    return DT_OK;
+}
+
+dt_status dt_get_faces(const dt_triangulation* handle, uint32_t* faces, size_t capacity, size_t* nb_faces)
+{
+    if (handle == nullptr || nb_faces == nullptr) { return DT_INVALID_ARGUMENT; }
+    if (!handle->has_result) { *nb_faces = 0; return DT_NO_RESULT; }
+    const auto& result_faces = handle->result.faces;
+    *nb_faces = result_faces.size();
+    if (faces == nullptr) { return DT_OK; }
+    if (capacity < result_faces.size()) { return DT_BUFFER_TOO_SMALL; }
+    std::memcpy(faces, result_faces.data(), result_faces.size() * sizeof(result_faces[0]));
+    return DT_OK;
+}
+
+dt_status dt_get_vertices(const dt_triangulation* handle, double* xy, size_t capacity, size_t stride, size_t* nb_vertices)
+{
+    if (handle == nullptr || nb_vertices == nullptr) { return DT_INVALID_ARGUMENT; }
+    if (stride != 0 && stride < PACKED_STRIDE) { return DT_INVALID_ARGUMENT; }
+    if (!handle->has_result) { *nb_vertices = 0; return DT_NO_RESULT; }
+    const auto& result_vertices = handle->result.vertices;
+    *nb_vertices = result_vertices.size();
+    if (xy == nullptr) { return DT_OK; }
+    if (capacity < result_vertices.size()) { return DT_BUFFER_TOO_SMALL; }
+    if (stride == 0 || stride == PACKED_STRIDE)
+    {
+        std::memcpy(xy, result_vertices.data(), result_vertices.size() * PACKED_STRIDE);
+        return DT_OK;
+    }
+    auto* bytes = reinterpret_cast<unsigned char*>(xy);
+    for (std::size_t idx = 0; idx < result_vertices.size(); idx++)
+    {
+        std::memcpy(bytes + idx * stride, &result_vertices[idx], PACKED_STRIDE);
+    }
+    return DT_OK;
+}
+
+} // extern "C"
@@ -2,11 +2,14 @@
 // This code is distributed under the terms of the MIT License
 #include <dt/dt_impl.h>
 
+#include "impl_divconq.h"
+
 #if BUILD_POLY2TRI
     #include "impl_poly2tri.h"
 #endif
 #if BUILD_CDT
     #include "impl_cdt.h"
+    #include "impl_speculative.h"
 #endif
 #if BUILD_TRIANGLE
     #include "impl_triangle.h"
@@ -20,21 +23,72 @@ bool static_register_all_implementations()
     bool success = true;
 
 #if BUILD_TRIANGLE
-    // Shewchuk's Triangle
-    success &= register_impl<double, std::uint32_t>("Triangle", 4, &get_triangle_impl<double, std::uint32_t>);
+    // Shewchuk's Triangle, with each of its Delaunay algorithms. The default one (divide-and-conquer) is the reference.
+    success &= register_impl<double, std::uint32_t>("Triangle", 10, &get_triangle_impl<double, std::uint32_t>);
+    success &= register_impl<double, std::uint32_t>("Triangle_sweep", 9, &get_triangle_impl<double, std::uint32_t, TriangleAlgorithm::Sweepline>);
+    success &= register_impl<double, std::uint32_t>("Triangle_incr", 8, &get_triangle_impl<double, std::uint32_t, TriangleAlgorithm::Incremental>);
 #endif
 
 #if BUILD_POLY2TRI
     // Poly2tri (the library only supports double)
-    success &= register_impl<double, std::uint32_t>("Poly2tri", 3, &get_poly2tri_impl<double, std::uint32_t>);
+    success &= register_impl<double, std::uint32_t>("Poly2tri", 7, &get_poly2tri_impl<double, std::uint32_t>);
 #endif
 
 #if BUILD_CDT
     // CDT double
-    success &= register_impl<double, std::uint32_t>("CDT_fp64", 2, &get_cdt_impl<double, double, std::uint32_t>);
+    success &= register_impl<double, std::uint32_t>("CDT_fp64", 5, &get_cdt_impl<double, double, std::uint32_t>);
     // CDT float
-    success &= register_impl<double, std::uint32_t>("CDT_fp32", 1, &get_cdt_impl<float, double, std::uint32_t>);
+    success &= register_impl<double, std::uint32_t>("CDT_fp32", 4, &get_cdt_impl<float, double, std::uint32_t>);
+    // CDT float, then CDT double if the output is not valid
+    success &= register_impl<double, std::uint32_t>("CDT_spec", 6, &get_speculative_impl<double, std::uint32_t, CDTImpl<float, double, std::uint32_t>, CDTImpl<double, double, std::uint32_t>>);
+    // CDT double, with the tuning knobs of the library: Vertices inserted in the input order, duplicates merged, smaller k-d tree leaves
+    success &= register_impl<double, std::uint32_t>("CDT_fp64_ordered", 3, &get_cdt_variant_impl<double, double, std::uint32_t, CDTVariant::AsProvided>);
+    success &= register_impl<double, std::uint32_t>("CDT_fp64_dedup", 2, &get_cdt_variant_impl<double, double, std::uint32_t, CDTVariant::Dedup>);
+    success &= register_impl<double, std::uint32_t>("CDT_fp64_leaf8", 1, &get_cdt_variant_impl<double, double, std::uint32_t, CDTVariant::SmallLeaves>);
+#endif
+
+    // In-house divide-and-conquer (point clouds only)
+    success &= register_impl<double, std::uint32_t>("DivConq", 0, &get_divconq_impl<double, std::uint32_t>);
+
+    // Same implementations with a float interface: The input and the output vertices are stored in 32-bit, and the libraries that only
+    // support double convert the vertices before the triangulation.
+#if BUILD_TRIANGLE
+    success &= register_impl<float, std::uint32_t>("Triangle", 10, &get_triangle_impl<float, std::uint32_t>);
+    success &= register_impl<float, std::uint32_t>("Triangle_sweep", 9, &get_triangle_impl<float, std::uint32_t, TriangleAlgorithm::Sweepline>);
+    success &= register_impl<float, std::uint32_t>("Triangle_incr", 8, &get_triangle_impl<float, std::uint32_t, TriangleAlgorithm::Incremental>);
+#endif
+#if BUILD_POLY2TRI
+    success &= register_impl<float, std::uint32_t>("Poly2tri", 7, &get_poly2tri_impl<float, std::uint32_t>);
+#endif
+#if BUILD_CDT
+    success &= register_impl<float, std::uint32_t>("CDT_fp64", 5, &get_cdt_impl<double, float, std::uint32_t>);
+    success &= register_impl<float, std::uint32_t>("CDT_fp32", 4, &get_cdt_impl<float, float, std::uint32_t>);
+    success &= register_impl<float, std::uint32_t>("CDT_spec", 6, &get_speculative_impl<float, std::uint32_t, CDTImpl<float, float, std::uint32_t>, CDTImpl<double, float, std::uint32_t>>);
+    success &= register_impl<float, std::uint32_t>("CDT_fp64_ordered", 3, &get_cdt_variant_impl<double, float, std::uint32_t, CDTVariant::AsProvided>);
+    success &= register_impl<float, std::uint32_t>("CDT_fp64_dedup", 2, &get_cdt_variant_impl<double, float, std::uint32_t, CDTVariant::Dedup>);
+    success &= register_impl<float, std::uint32_t>("CDT_fp64_leaf8", 1, &get_cdt_variant_impl<double, float, std::uint32_t, CDTVariant::SmallLeaves>);
+#endif
+    success &= register_impl<float, std::uint32_t>("DivConq", 0, &get_divconq_impl<float, std::uint32_t>);
+
+    // Same implementations with 64-bit indices, for the triangulations of more than 4G elements. Note that the libraries have their own
+    // index type, which may be narrower: Triangle uses an int, CDT uses a 32-bit index unless it is built with CDT_USE_64_BIT_INDEX_TYPE.
+#if BUILD_TRIANGLE
+    success &= register_impl<double, std::uint64_t>("Triangle", 10, &get_triangle_impl<double, std::uint64_t>);
+    success &= register_impl<double, std::uint64_t>("Triangle_sweep", 9, &get_triangle_impl<double, std::uint64_t, TriangleAlgorithm::Sweepline>);
+    success &= register_impl<double, std::uint64_t>("Triangle_incr", 8, &get_triangle_impl<double, std::uint64_t, TriangleAlgorithm::Incremental>);
+#endif
+#if BUILD_POLY2TRI
+    success &= register_impl<double, std::uint64_t>("Poly2tri", 7, &get_poly2tri_impl<double, std::uint64_t>);
+#endif
+#if BUILD_CDT
+    success &= register_impl<double, std::uint64_t>("CDT_fp64", 5, &get_cdt_impl<double, double, std::uint64_t>);
+    success &= register_impl<double, std::uint64_t>("CDT_fp32", 4, &get_cdt_impl<float, double, std::uint64_t>);
+    success &= register_impl<double, std::uint64_t>("CDT_spec", 6, &get_speculative_impl<double, std::uint64_t, CDTImpl<float, double, std::uint64_t>, CDTImpl<double, double, std::uint64_t>>);
+    success &= register_impl<double, std::uint64_t>("CDT_fp64_ordered", 3, &get_cdt_variant_impl<double, double, std::uint64_t, CDTVariant::AsProvided>);
+    success &= register_impl<double, std::uint64_t>("CDT_fp64_dedup", 2, &get_cdt_variant_impl<double, double, std::uint64_t, CDTVariant::Dedup>);
+    success &= register_impl<double, std::uint64_t>("CDT_fp64_leaf8", 1, &get_cdt_variant_impl<double, double, std::uint64_t, CDTVariant::SmallLeaves>);
 #endif
+    success &= register_impl<double, std::uint64_t>("DivConq", 0, &get_divconq_impl<double, std::uint64_t>);
 
     return success;
 }
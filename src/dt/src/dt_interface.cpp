@@ -25,4 +25,27 @@ std::ostream& operator<<(std::ostream& out, TriangulationPolicy policy)
     return out;
 }
 
+std::ostream& operator<<(std::ostream& out, VertexOrder order)
+{
+    switch (order)
+    {
+        case VertexOrder::AsProvided:
+            out << "As Provided";
+            break;
+
+        case VertexOrder::Hilbert:
+            out << "Hilbert";
+            break;
+
+        case VertexOrder::BRIO:
+            out << "BRIO";
+            break;
+
+        default:
+            assert(0);
+            out << "Unknown enum";
+    }
+    return out;
+}
+
 } // namespace delaunay
@@ -3,37 +3,107 @@
 #pragma once
 
 #include <dt/dt_interface.h>
+#include <shapes/bounding_box.h>
+#include <stdutils/arena.h>
 
 #include "cdt_wrap.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <exception>
 #include <iterator>
+#include <limits>
+#include <memory>
 #include <utility>
 #include <vector>
 
 namespace delaunay {
 
-// Fc  floating-point type used by the library (computation)
-// F   floating-point type used for the interface
-template <typename Fc, typename F, typename I = std::uint32_t>
+// Tuning of the CDT library
+//  - insertion_as_provided: Insert the vertices in the order of the input, instead of the library's own order (VertexInsertionOrder::Auto,
+//    a breadth-first traversal of a k-d tree of the vertices)
+//  - remove_duplicates: Merge the duplicated vertices before the triangulation (the library throws on duplicates otherwise), and remap the
+//    constraint edges. The faces index the first occurrence of each vertex. Not applied to the incremental triangulation.
+struct CDTOptions
+{
+    bool insertion_as_provided = false;
+    bool remove_duplicates = false;
+};
+
+// Variants registered in addition to the default configuration, to compare them on a dataset
+enum class CDTVariant
+{
+    Default,
+    AsProvided,             // CDTOptions::insertion_as_provided
+    Dedup,                  // CDTOptions::remove_duplicates
+    SmallLeaves,            // Nearest point locator: A k-d tree with 8 vertices per leaf, instead of 32
+};
+
+// Fc       floating-point type used by the library (computation)
+// F        floating-point type used for the interface
+// Locator  nearest point locator of the library
+template <typename Fc, typename F, typename I = std::uint32_t, typename Locator = CDT::LocatorKDTree<Fc>>
 class CDTImpl : public Interface<F, I>
 {
 public:
-    CDTImpl(const stdutils::io::ErrorHandler* err_handler = nullptr);
+    CDTImpl(const stdutils::io::ErrorHandler* err_handler = nullptr, const CDTOptions& options = CDTOptions());
 
-    void add_path(const shapes::PointPath2d<F>& pp) override;
-    void add_hole(const shapes::PointPath2d<F>& pp) override;
-    void add_steiner(const shapes::PointCloud2d<F>& pc) override;
+    bool supports_incremental() const noexcept override { return true; }
 
 private:
-    void triangulate_impl(TriangulationPolicy policy, shapes::Triangles2d<F, I>& result) const override;
+    using typename Interface<F, I>::Points;
+    using typename Interface<F, I>::PhaseTimer;
+
+    void add_path_impl(Points vertices, bool closed) override;
+    void add_hole_impl(Points vertices, bool closed) override;
+    void add_steiner_impl(Points vertices) override;
+    void add_edges_impl(const shapes::Edges2d<F, I>& edges) override;
+    void triangulate_impl(TriangulationPolicy policy, const CancellationToken* token, shapes::Triangles2d<F, I>& result) const override;
+    void triangulate_incremental_impl(TriangulationPolicy policy, Points new_steiner_points, const CancellationToken* token, shapes::Triangles2d<F, I>& result) override;
+    std::size_t byte_size_impl() const noexcept override;
+    void clear_impl() noexcept override;
+    void reserve_impl(std::size_t nb_constraints) override;
+
+    using Triangulation = CDT::Triangulation<Fc, Locator>;
+
+    CDT::VertexInsertionOrder::Enum insertion_order() const noexcept;
+
+    // Insert m_points[begin_idx, end_idx) in the triangulation
+    void insert_vertices(Triangulation& cdt, std::size_t begin_idx, std::size_t end_idx, const CancellationToken* token) const;
+
+    // Insert the vertices m_points[idx] for idx in indices
+    void insert_vertices(Triangulation& cdt, const std::vector<std::size_t>& indices, const CancellationToken* token) const;
+
+    // Insert the constraint edges if the policy requires it. Return true if the triangulation has constraints.
+    // If not null, vertex_map[idx] is the index in the library of the vertex m_points[idx].
+    bool insert_edges(Triangulation& cdt, TriangulationPolicy policy, const CancellationToken* token, const std::vector<std::size_t>* vertex_map = nullptr) const;
+
+    // Finalize the triangulation, and copy its faces and adjacency into the result
+    // If not null, original_indices[k] is the index in m_points of the k-th vertex of the library.
+    void extract_result(Triangulation& cdt, bool has_constraints, shapes::Triangles2d<F, I>& result, const std::vector<std::size_t>* original_indices = nullptr) const;
+
+    // The triangulation before it is finalized, kept between two calls to triangulate_incremental()
+    struct IncrementalState
+    {
+        explicit IncrementalState(CDT::VertexInsertionOrder::Enum order) : cdt(order), policy(TriangulationPolicy::PointCloud), has_constraints(false), nb_vertices(0), bbox() {}
+
+        Triangulation cdt;
+        TriangulationPolicy policy;
+        bool has_constraints;
+        std::size_t nb_vertices;
+        shapes::BoundingBox2d<F> bbox;      // Of the vertices of the first insertion: The super-triangle of CDT only encloses that box
+    };
+
+    CDTOptions m_options;
 
-    shapes::Points2d<F> m_points;
     std::vector<std::pair<I, I>> m_polylines_indices;
     std::vector<bool> m_polylines_closed;
+    std::vector<std::pair<I, I>> m_edges;                   // The edges of add_edges(), as indices in m_points
+    std::unique_ptr<IncrementalState> m_incremental;
 
     using Interface<F, I>::m_err_handler;
+    using Interface<F, I>::m_points;
 };
 
 template <typename Fc, typename F, typename I>
@@ -42,6 +112,18 @@ std::unique_ptr<Interface<F, I>> get_cdt_impl(const stdutils::io::ErrorHandler*
     return std::make_unique<CDTImpl<Fc, F, I>>(err_handler);
 }
 
+template <typename Fc, typename F, typename I, CDTVariant Variant>
+std::unique_ptr<Interface<F, I>> get_cdt_variant_impl(const stdutils::io::ErrorHandler* err_handler)
+{
+    CDTOptions options;
+    options.insertion_as_provided = (Variant == CDTVariant::AsProvided);
+    options.remove_duplicates = (Variant == CDTVariant::Dedup);
+    if constexpr (Variant == CDTVariant::SmallLeaves)
+        return std::make_unique<CDTImpl<Fc, F, I, CDT::LocatorKDTree<Fc, 8>>>(err_handler, options);
+    else
+        return std::make_unique<CDTImpl<Fc, F, I>>(err_handler, options);
+}
+
 
 //
 //
@@ -53,75 +135,209 @@ std::unique_ptr<Interface<F, I>> get_cdt_impl(const stdutils::io::ErrorHandler*
 namespace details {
 namespace cdt {
 
+    // The vertices are read directly from the input buffer, without an intermediate copy
     template <typename Fc, typename F>
-    std::vector<CDT::V2d<Fc>> copy_vertices(const shapes::Points2d<F>& points)
-    {
-        std::vector<CDT::V2d<Fc>> result;
-        result.reserve(points.size());
-        std::transform(std::cbegin(points), std::cend(points), std::back_inserter(result), [](const auto& p) {
-            return CDT::V2d<Fc>::make(static_cast<Fc>(p.x), static_cast<Fc>(p.y));
-        });
-        return result;
-    }
+    Fc get_x(const shapes::Point2d<F>& p) { return static_cast<Fc>(p.x); }
+
+    template <typename Fc, typename F>
+    Fc get_y(const shapes::Point2d<F>& p) { return static_cast<Fc>(p.y); }
+
+    // The library indexes the vertices with CDT::VertInd, which may be narrower than the index type of the interface
+    inline bool fits_vertex_index(std::size_t nb_vertices) { return nb_vertices <= static_cast<std::size_t>(std::numeric_limits<CDT::VertInd>::max()); }
+
+    constexpr const char* TooManyPointsMsg = "Too many points for the vertex index of the CDT library. The output will be empty.";
 
 } // namespace cdt
 } // namespace details
 
-template <typename Fc, typename F, typename I>
-CDTImpl<Fc, F, I>::CDTImpl(const stdutils::io::ErrorHandler* err_handler)
+template <typename Fc, typename F, typename I, typename Locator>
+CDTImpl<Fc, F, I, Locator>::CDTImpl(const stdutils::io::ErrorHandler* err_handler, const CDTOptions& options)
     : Interface<F,I>(err_handler)
-    , m_points()
+    , m_options(options)
     , m_polylines_indices()
     , m_polylines_closed()
+    , m_edges()
+    , m_incremental()
 { }
 
-template <typename Fc, typename F, typename I>
-void CDTImpl<Fc, F, I>::add_path(const shapes::PointPath2d<F>& pp)
+template <typename Fc, typename F, typename I, typename Locator>
+void CDTImpl<Fc, F, I, Locator>::add_path_impl(Points vertices, bool closed)
 {
-    assert(shapes::is_valid(pp));
-    if (pp.closed && pp.vertices.size() < 3)
+    if (closed && vertices.size() < 3)
     {
         if (m_err_handler) { m_err_handler(stdutils::io::Severity::WARN, "Ignoring a closed polyline with less than 3 vertices"); }
         return;
     }
 
     const I begin_idx = static_cast<I>(m_points.size());
-    m_points.reserve(m_points.size() + pp.vertices.size());
-    m_points.insert(m_points.end(), pp.vertices.begin(), pp.vertices.end());
+    m_points.reserve(m_points.size() + vertices.size());
+    m_points.insert(m_points.end(), vertices.begin(), vertices.end());
     const I end_idx = static_cast<I>(m_points.size());
 
     m_polylines_indices.emplace_back(begin_idx, end_idx);
-    m_polylines_closed.emplace_back(pp.closed);
+    m_polylines_closed.emplace_back(closed);
+    m_incremental.reset();
 }
 
-template <typename Fc, typename F, typename I>
-void CDTImpl<Fc, F, I>::add_hole(const shapes::PointPath2d<F>& pp)
+template <typename Fc, typename F, typename I, typename Locator>
+void CDTImpl<Fc, F, I, Locator>::add_hole_impl(Points vertices, bool closed)
 {
-    add_path(pp);
+    add_path_impl(vertices, closed);
 }
 
-template <typename Fc, typename F, typename I>
-void CDTImpl<Fc, F, I>::add_steiner(const shapes::PointCloud2d<F>& pc)
+template <typename Fc, typename F, typename I, typename Locator>
+void CDTImpl<Fc, F, I, Locator>::add_steiner_impl(Points vertices)
 {
-    m_points.reserve(m_points.size() + pc.vertices.size());
-    m_points.insert(m_points.end(), pc.vertices.begin(), pc.vertices.end());
+    m_points.reserve(m_points.size() + vertices.size());
+    m_points.insert(m_points.end(), vertices.begin(), vertices.end());
 }
 
-template <typename Fc, typename F, typename I>
-void CDTImpl<Fc, F, I>::triangulate_impl(TriangulationPolicy policy, shapes::Triangles2d<F, I>& result) const
+template <typename Fc, typename F, typename I, typename Locator>
+void CDTImpl<Fc, F, I, Locator>::add_edges_impl(const shapes::Edges2d<F, I>& edges)
+{
+    const I offset = static_cast<I>(m_points.size());
+    m_points.reserve(m_points.size() + edges.vertices.size());
+    m_points.insert(m_points.end(), edges.vertices.begin(), edges.vertices.end());
+    m_edges.reserve(m_edges.size() + edges.indices.size());
+    for (const auto& e : edges.indices) { m_edges.emplace_back(static_cast<I>(offset + e.orig()), static_cast<I>(offset + e.dest())); }
+    m_incremental.reset();
+}
+
+template <typename Fc, typename F, typename I, typename Locator>
+void CDTImpl<Fc, F, I, Locator>::triangulate_impl(TriangulationPolicy policy, const CancellationToken* token, shapes::Triangles2d<F, I>& result) const
 {
     if (m_points.size() < 3)
     {
         if (m_err_handler) { m_err_handler(stdutils::io::Severity::WARN, "Not enough points to triangulate. The output will be empty."); }
         return;
     }
+    if (!details::cdt::fits_vertex_index(m_points.size()))
+    {
+        if (m_err_handler) { m_err_handler(stdutils::io::Severity::ERR, details::cdt::TooManyPointsMsg); }
+        return;
+    }
+
+    Triangulation cdt(insertion_order());
+    if (m_options.remove_duplicates)
+    {
+        const CDT::DuplicatesInfo duplicates = [this]() {
+            const PhaseTimer phase(*this, "CDT::FindDuplicates");
+            return CDT::FindDuplicates<Fc>(m_points.cbegin(), m_points.cend(), &details::cdt::get_x<Fc, F>, &details::cdt::get_y<Fc, F>);
+        }();
+        if (!duplicates.duplicates.empty())
+        {
+            // The first occurrences of the vertices, in the order of the input, which is also the order of the indices of the library
+            std::vector<std::size_t> unique_indices;
+            unique_indices.reserve(m_points.size() - duplicates.duplicates.size());
+            for (std::size_t idx = 0; idx < m_points.size(); idx++)
+            {
+                if (duplicates.mapping[idx] == unique_indices.size()) { unique_indices.push_back(idx); }
+            }
+            insert_vertices(cdt, unique_indices, token);
+            const bool has_constraints = insert_edges(cdt, policy, token, &duplicates.mapping);
+            extract_result(cdt, has_constraints, result, &unique_indices);
+            return;
+        }
+    }
+    insert_vertices(cdt, 0, m_points.size(), token);
+    const bool has_constraints = insert_edges(cdt, policy, token);
+    extract_result(cdt, has_constraints, result);
+}
+
+template <typename Fc, typename F, typename I, typename Locator>
+CDT::VertexInsertionOrder::Enum CDTImpl<Fc, F, I, Locator>::insertion_order() const noexcept
+{
+    return m_options.insertion_as_provided ? CDT::VertexInsertionOrder::AsProvided : CDT::VertexInsertionOrder::Auto;
+}
+
+template <typename Fc, typename F, typename I, typename Locator>
+void CDTImpl<Fc, F, I, Locator>::triangulate_incremental_impl(TriangulationPolicy policy, Points new_steiner_points, const CancellationToken* token, shapes::Triangles2d<F, I>& result)
+{
+    if (!new_steiner_points.empty()) { add_steiner_impl(new_steiner_points); }
+    if (!details::cdt::fits_vertex_index(m_points.size()))
+    {
+        if (m_err_handler) { m_err_handler(stdutils::io::Severity::ERR, details::cdt::TooManyPointsMsg); }
+        m_incremental.reset();
+        return;
+    }
+
+    // The state is taken out for the duration of the computation, so that it is left reset if an exception is thrown
+    std::unique_ptr<IncrementalState> state = std::move(m_incremental);
+    const auto in_bbox = [&state](const shapes::Point2d<F>& p) {
+        return state->bbox.rx.min <= p.x && p.x <= state->bbox.rx.max && state->bbox.ry.min <= p.y && p.y <= state->bbox.ry.max;
+    };
+    if (!state || state->policy != policy || state->nb_vertices > m_points.size()
+        || !std::all_of(m_points.cbegin() + static_cast<std::ptrdiff_t>(state->nb_vertices), m_points.cend(), in_bbox))
+    {
+        if (m_points.size() < 3)
+        {
+            if (m_err_handler) { m_err_handler(stdutils::io::Severity::WARN, "Not enough points to triangulate. The output will be empty."); }
+            return;
+        }
+        state = std::make_unique<IncrementalState>(insertion_order());
+        state->policy = policy;
+        for (const auto& p : m_points) { state->bbox.add(p); }
+        insert_vertices(state->cdt, 0, m_points.size(), token);
+        state->has_constraints = insert_edges(state->cdt, policy, token);
+    }
+    else
+    {
+        // Only insert the points added since the previous call
+        insert_vertices(state->cdt, state->nb_vertices, m_points.size(), token);
+    }
+    state->nb_vertices = m_points.size();
+
+    // Finalizing the triangulation erases triangles, so it is done on a copy
+    Triangulation cdt = [this, &state]() {
+        const PhaseTimer phase(*this, "CDT::copy_state");
+        return state->cdt;
+    }();
+    extract_result(cdt, state->has_constraints, result);
+    m_incremental = std::move(state);
+}
+
+template <typename Fc, typename F, typename I, typename Locator>
+void CDTImpl<Fc, F, I, Locator>::insert_vertices(Triangulation& cdt, std::size_t begin_idx, std::size_t end_idx, const CancellationToken* token) const
+{
+    const PhaseTimer phase(*this, "CDT::insertVertices");
+    assert(begin_idx <= end_idx && end_idx <= m_points.size());
+    const auto get_x = &details::cdt::get_x<Fc, F>;
+    const auto get_y = &details::cdt::get_y<Fc, F>;
+    // A single call: The super-triangle of CDT is built from the bounding box of the vertices of the first call, and the insertion order of
+    // the later calls is randomized. The cancellation token is checked between the phases.
+    if (begin_idx < end_idx)
+    {
+        cdt.insertVertices(m_points.data() + begin_idx, m_points.data() + end_idx, get_x, get_y);
+    }
+    this->check_cancellation(token);
+}
 
-    CDT::Triangulation<Fc> cdt;
-    std::vector<CDT::V2d<Fc>> vertices = details::cdt::copy_vertices<Fc, F>(m_points);
-    cdt.insertVertices(vertices);
-    CDT::EdgeVec edges;
+template <typename Fc, typename F, typename I, typename Locator>
+void CDTImpl<Fc, F, I, Locator>::insert_vertices(Triangulation& cdt, const std::vector<std::size_t>& indices, const CancellationToken* token) const
+{
+    const PhaseTimer phase(*this, "CDT::insertVertices");
+    const auto get_x = [this](std::size_t idx) { return details::cdt::get_x<Fc, F>(m_points[idx]); };
+    const auto get_y = [this](std::size_t idx) { return details::cdt::get_y<Fc, F>(m_points[idx]); };
+    // A single call, see above
+    if (!indices.empty())
+    {
+        cdt.insertVertices(indices.begin(), indices.end(), get_x, get_y);
+    }
+    this->check_cancellation(token);
+}
+
+template <typename Fc, typename F, typename I, typename Locator>
+bool CDTImpl<Fc, F, I, Locator>::insert_edges(Triangulation& cdt, TriangulationPolicy policy, const CancellationToken* token, const std::vector<std::size_t>* vertex_map) const
+{
+    stdutils::ArenaVector<CDT::Edge> edges(this->template arena_allocator<CDT::Edge>());
     if (policy == TriangulationPolicy::CDT)
     {
+        // The edges whose vertices are merged by the deduplication are dropped
+        const auto add_edge = [&edges, vertex_map](I orig, I dest) {
+            const auto v1 = static_cast<CDT::VertInd>(vertex_map ? (*vertex_map)[orig] : orig);
+            const auto v2 = static_cast<CDT::VertInd>(vertex_map ? (*vertex_map)[dest] : dest);
+            if (v1 != v2) { edges.emplace_back(v1, v2); }
+        };
         assert(m_polylines_indices.size() == m_polylines_closed.size());
         std::size_t polyline_idx = 0;
         for (const auto& [begin, end] : m_polylines_indices)
@@ -130,38 +346,93 @@ void CDTImpl<Fc, F, I>::triangulate_impl(TriangulationPolicy policy, shapes::Tri
             edges.reserve(edges.size() + (end - begin));
             for (I idx = begin; idx < (end - 1); idx++)
             {
-                edges.emplace_back(static_cast<CDT::VertInd>(idx), static_cast<CDT::VertInd>(idx + 1));
+                add_edge(idx, static_cast<I>(idx + 1));
             }
             if (m_polylines_closed.at(polyline_idx++))
             {
                 assert(begin != (end-1));        // closed polylines with size < 3 are rejected in add_path/add_hole
-                edges.emplace_back(static_cast<CDT::VertInd>(end - 1), static_cast<CDT::VertInd>(begin));
+                add_edge(static_cast<I>(end - 1), begin);
             }
         }
-        cdt.insertEdges(edges);
-    }
-    if (edges.empty())
-    {
-        // Delaunay triangulation of a point cloud
-        cdt.eraseSuperTriangle();
+        edges.reserve(edges.size() + m_edges.size());
+        for (const auto& [orig, dest] : m_edges) { add_edge(orig, dest); }
+        const PhaseTimer phase(*this, "CDT::insertEdges");
+        cdt.insertEdges(edges.cbegin(), edges.cend(), [](const CDT::Edge& e) { return e.v1(); }, [](const CDT::Edge& e) { return e.v2(); });
+        this->check_cancellation(token);
     }
-    else
+    return !edges.empty();
+}
+
+template <typename Fc, typename F, typename I, typename Locator>
+void CDTImpl<Fc, F, I, Locator>::extract_result(Triangulation& cdt, bool has_constraints, shapes::Triangles2d<F, I>& result, const std::vector<std::size_t>* original_indices) const
+{
     {
-        // Constrained Delaunay triangulation
-        cdt.eraseOuterTrianglesAndHoles();
+        const PhaseTimer phase(*this, "CDT::erase");
+        if (has_constraints)
+        {
+            // Constrained Delaunay triangulation
+            cdt.eraseOuterTrianglesAndHoles();
+        }
+        else
+        {
+            // Delaunay triangulation of a point cloud
+            cdt.eraseSuperTriangle();
+        }
     }
-    const auto cdt_triangles = cdt.triangles;
+    const PhaseTimer phase(*this, "CDT::copy_faces");
+    const auto& cdt_triangles = cdt.triangles;
 
-    result.vertices = m_points;
     result.faces.reserve(cdt_triangles.size());
+    const auto vertex = [original_indices](CDT::VertInd v) { return static_cast<I>(original_indices ? (*original_indices)[v] : v); };
     for (const auto& triangle : cdt_triangles)
     {
         result.faces.emplace_back(
-            static_cast<I>(triangle.vertices[0]),
-            static_cast<I>(triangle.vertices[1]),
-            static_cast<I>(triangle.vertices[2])
+            vertex(triangle.vertices[0]),
+            vertex(triangle.vertices[1]),
+            vertex(triangle.vertices[2])
         );
     }
+
+    // CDT's k-th neighbor is across the edge (k, k+1), which is the convention of graphs::TriangleAdjacency
+    result.adjacency.reserve(cdt_triangles.size());
+    for (const auto& triangle : cdt_triangles)
+    {
+        auto& adj = result.adjacency.emplace_back();
+        for (std::size_t k = 0; k < 3; k++)
+        {
+            const auto neighbor = triangle.neighbors[k];
+            adj[k] = neighbor == CDT::noNeighbor ? graphs::IndexTraits<I>::undef() : static_cast<I>(neighbor);
+        }
+    }
+    assert(graphs::is_valid(result.adjacency, result.faces));
+}
+
+template <typename Fc, typename F, typename I, typename Locator>
+std::size_t CDTImpl<Fc, F, I, Locator>::byte_size_impl() const noexcept
+{
+    std::size_t result = stdutils::memory::byte_size(m_polylines_indices) + stdutils::memory::byte_size(m_polylines_closed) + stdutils::memory::byte_size(m_edges);
+    if (m_incremental)
+    {
+        // The vertices and the triangles. The hash tables of the constraint edges are not accounted for.
+        result += stdutils::memory::byte_size(m_incremental->cdt.vertices) + stdutils::memory::byte_size(m_incremental->cdt.triangles);
+    }
+    return result;
+}
+
+template <typename Fc, typename F, typename I, typename Locator>
+void CDTImpl<Fc, F, I, Locator>::clear_impl() noexcept
+{
+    m_polylines_indices.clear();
+    m_polylines_closed.clear();
+    m_edges.clear();
+    m_incremental.reset();
+}
+
+template <typename Fc, typename F, typename I, typename Locator>
+void CDTImpl<Fc, F, I, Locator>::reserve_impl(std::size_t nb_constraints)
+{
+    m_polylines_indices.reserve(nb_constraints);
+    m_polylines_closed.reserve(nb_constraints);
 }
 
 } // namespace delaunay
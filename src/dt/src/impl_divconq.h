@@ -0,0 +1,599 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <dt/dt_interface.h>
+#include <graphs/graph.h>
+#include <graphs/triangulation.h>
+#include <shapes/point.h>
+#include <shapes/predicates.h>
+#include <stdutils/arena.h>
+#include <stdutils/parallel.h>
+#include <stdutils/thread_pool.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace delaunay {
+
+/**
+ * In-house Delaunay triangulation of a point cloud
+ *
+ * Guibas and Stolfi's divide-and-conquer algorithm on a quad-edge data structure, with robust predicates. The point set is cut
+ * in halves alternately along the x-axis and the y-axis (Dwyer's variant), and the halves are triangulated concurrently, then merged,
+ * recursively down to one subproblem per thread. The constrained triangulation is not supported.
+ */
+template <typename F, typename I = std::uint32_t>
+class DivConqImpl : public Interface<F, I>
+{
+public:
+    DivConqImpl(const stdutils::io::ErrorHandler* err_handler = nullptr);
+
+private:
+    using typename Interface<F, I>::Points;
+    using typename Interface<F, I>::PhaseTimer;
+
+    void add_path_impl(Points vertices, bool closed) override;
+    void add_hole_impl(Points vertices, bool closed) override;
+    void add_steiner_impl(Points vertices) override;
+    void add_edges_impl(const shapes::Edges2d<F, I>& edges) override;
+    void triangulate_impl(TriangulationPolicy policy, const CancellationToken* token, shapes::Triangles2d<F, I>& result) const override;
+    std::size_t byte_size_impl() const noexcept override;
+    void clear_impl() noexcept override;
+    void reserve_impl(std::size_t nb_constraints) override;
+
+    bool m_has_constraints;
+
+    using Interface<F, I>::m_err_handler;
+    using Interface<F, I>::m_points;
+};
+
+template <typename F, typename I>
+std::unique_ptr<Interface<F, I>> get_divconq_impl(const stdutils::io::ErrorHandler* err_handler)
+{
+    return std::make_unique<DivConqImpl<F, I>>(err_handler);
+}
+
+
+//
+//
+// Implementation
+//
+//
+
+
+namespace details {
+namespace divconq {
+
+// One of the four directed edges of a quad-edge: The edge of the triangulation in both directions (r = 0, 2), and the dual edge (r = 1, 3).
+// The rank r in the quad-edge is deduced from the address, hence the alignment of the quad-edges.
+template <typename I>
+struct alignas(16) HalfEdge
+{
+    HalfEdge* next;             // Onext: The next edge counterclockwise around the origin
+    I org;                      // Primal edges: The index of the origin vertex. Dual edges: Flags.
+    I face;                     // Primal edges: The index of the left face, once the faces are extracted
+
+    std::size_t rank() const noexcept { return (reinterpret_cast<std::uintptr_t>(this) / sizeof(HalfEdge)) % 4; }
+    HalfEdge* rot() noexcept { return rank() < 3 ? this + 1 : this - 3; }
+    HalfEdge* inv_rot() noexcept { return rank() > 0 ? this - 1 : this + 3; }
+    HalfEdge* sym() noexcept { return rank() < 2 ? this + 2 : this - 2; }
+    HalfEdge* oprev() noexcept { return rot()->next->rot(); }
+    HalfEdge* lnext() noexcept { return inv_rot()->next->rot(); }
+    HalfEdge* rprev() noexcept { return sym()->next; }
+    I dest() noexcept { return sym()->org; }
+};
+
+template <typename I>
+struct alignas(4 * sizeof(HalfEdge<I>)) QuadEdge
+{
+    static_assert((sizeof(HalfEdge<I>) & (sizeof(HalfEdge<I>) - 1)) == 0);
+    std::array<HalfEdge<I>, 4> e;
+};
+
+// Each subproblem running on its own thread allocates its edges in its own pool. The quad-edges are allocated by chunks, so that their addresses are stable.
+template <typename I>
+class Pool
+{
+public:
+    explicit Pool(const stdutils::ArenaAllocator<QuadEdge<I>>& allocator) : m_allocator(allocator), m_chunks() {}
+
+    QuadEdge<I>& emplace_back()
+    {
+        if (m_chunks.empty() || m_last_chunk_size == ChunkSize)
+        {
+            std::unique_ptr<QuadEdge<I>, ChunkDeleter> chunk(m_allocator.allocate(ChunkSize), ChunkDeleter{ m_allocator });
+            std::uninitialized_value_construct_n(chunk.get(), ChunkSize);
+            m_chunks.emplace_back(std::move(chunk));
+            m_last_chunk_size = 0;
+        }
+        return m_chunks.back().get()[m_last_chunk_size++];
+    }
+
+    template <typename Func>
+    void for_each(Func func)
+    {
+        for (std::size_t chunk_idx = 0; chunk_idx < m_chunks.size(); chunk_idx++)
+        {
+            const std::size_t chunk_size = chunk_idx + 1 == m_chunks.size() ? m_last_chunk_size : ChunkSize;
+            for (std::size_t idx = 0; idx < chunk_size; idx++) { func(m_chunks[chunk_idx].get()[idx]); }
+        }
+    }
+
+private:
+    static constexpr std::size_t ChunkSize = 4096;
+
+    // The quad-edges are trivially destructible
+    struct ChunkDeleter
+    {
+        mutable stdutils::ArenaAllocator<QuadEdge<I>> allocator;
+        void operator()(QuadEdge<I>* chunk) const noexcept { allocator.deallocate(chunk, ChunkSize); }
+    };
+
+    stdutils::ArenaAllocator<QuadEdge<I>> m_allocator;
+    std::vector<std::unique_ptr<QuadEdge<I>, ChunkDeleter>> m_chunks;
+    std::size_t m_last_chunk_size = 0;
+};
+
+template <typename I>
+class Triangulator
+{
+public:
+    using Edge = HalfEdge<I>;
+
+    using Points = stdutils::ArenaVector<shapes::Point2d<double>>;
+
+    // The points must not have duplicates. The buffers of the triangulator are allocated in the arena of the points.
+    Triangulator(const Points& points, unsigned int parallel_depth, std::function<void()> check_cancellation);
+
+    void run();
+
+    // Extract the faces (indices into the input points) and their adjacency
+    void extract(graphs::TriangleSoup<I>& faces, graphs::TriangleAdjacency<I>& adjacency);
+
+private:
+    static constexpr I Undef = graphs::IndexTraits<I>::undef();
+    static constexpr I Visited = Undef - 1;
+    static constexpr I Deleted = 1;
+
+    // The subproblems are cut alternately along the x-axis (axis 0) and the y-axis (axis 1), so that they remain roughly square.
+    // The order along the y-axis is the order along the x-axis after a rotation by 90 degrees, so the merge step is the same for both axes.
+    static bool less(const shapes::Point2d<double>& p, const shapes::Point2d<double>& q, unsigned int axis);
+    void arrange(const Points& points, unsigned int depth, I begin, I end, unsigned int axis);
+
+    // Return the counterclockwise hull edge out of the first vertex, and the clockwise hull edge out of the last vertex, along out_axis
+    std::pair<Edge*, Edge*> triangulate(std::size_t node_idx, unsigned int depth, I begin, I end, unsigned int axis, unsigned int out_axis, Pool<I>& pool);
+    std::pair<Edge*, Edge*> triangulate_base_case(I begin, I end, unsigned int out_axis, Pool<I>& pool);
+    std::pair<Edge*, Edge*> merge(Edge* ldo, Edge* ldi, Edge* rdi, Edge* rdo, Pool<I>& pool);
+    std::pair<Edge*, Edge*> hull_extremes(Edge* rdo, unsigned int axis) const;
+
+    Edge* make_edge(I org, I dest, Pool<I>& pool);
+    static void splice(Edge* a, Edge* b);
+    Edge* connect(Edge* a, Edge* b, Pool<I>& pool);
+    static void delete_edge(Edge* e);
+
+    bool ccw(I a, I b, I c) const { return shapes::orient2d(m_points[a], m_points[b], m_points[c]) > 0.0; }
+    bool in_circle(I a, I b, I c, I d) const { return shapes::incircle(m_points[a], m_points[b], m_points[c], m_points[d]) > 0.0; }
+    bool right_of(I p, Edge* e) const { return ccw(p, e->dest(), e->org); }
+    bool left_of(I p, Edge* e) const { return ccw(p, e->org, e->dest()); }
+
+    const unsigned int m_parallel_depth;
+    std::function<void()> m_check_cancellation;
+    stdutils::ArenaVector<I> m_input_indices;           // Input index of each point of m_points
+    Points m_points;                                    // The input points, arranged by the cuts of the subproblems
+    std::vector<Pool<I>> m_pools;                       // One per node of the binary tree of the concurrent subproblems
+};
+
+template <typename I>
+Triangulator<I>::Triangulator(const Points& points, unsigned int parallel_depth, std::function<void()> check_cancellation)
+    : m_parallel_depth(parallel_depth)
+    , m_check_cancellation(std::move(check_cancellation))
+    , m_input_indices(points.size(), I{0}, points.get_allocator())
+    , m_points(points.get_allocator())
+    , m_pools()
+{
+    assert(points.size() < static_cast<std::size_t>(Visited));
+    const std::size_t nb_pools = (std::size_t{2} << parallel_depth) - 1;
+    m_pools.reserve(nb_pools);
+    for (std::size_t idx = 0; idx < nb_pools; idx++) { m_pools.emplace_back(points.get_allocator()); }
+    std::iota(m_input_indices.begin(), m_input_indices.end(), I{0});
+    arrange(points, 0, I{0}, static_cast<I>(points.size()), 0);
+    m_points.reserve(points.size());
+    for (const I idx : m_input_indices) { m_points.push_back(points[idx]); }
+}
+
+template <typename I>
+bool Triangulator<I>::less(const shapes::Point2d<double>& p, const shapes::Point2d<double>& q, unsigned int axis)
+{
+    if (axis == 0)
+        return p.x < q.x || (p.x == q.x && p.y < q.y);
+    else
+        return p.y < q.y || (p.y == q.y && p.x > q.x);
+}
+
+template <typename I>
+void Triangulator<I>::arrange(const Points& points, unsigned int depth, I begin, I end, unsigned int axis)
+{
+    const I n = end - begin;
+    if (n <= 3)
+        return;
+    const I mid = begin + n / 2;
+    const auto it = [this](I idx) { return m_input_indices.begin() + static_cast<std::ptrdiff_t>(idx); };
+    std::nth_element(it(begin), it(mid), it(end), [&points, axis](I a, I b) { return less(points[a], points[b], axis); });
+    if (depth < m_parallel_depth)
+    {
+        stdutils::parallel::TaskGroup group;
+        group.run([this, &points, depth, begin, mid, axis]() { arrange(points, depth + 1, begin, mid, 1 - axis); });
+        arrange(points, depth + 1, mid, end, 1 - axis);
+        group.wait();
+    }
+    else
+    {
+        arrange(points, depth + 1, begin, mid, 1 - axis);
+        arrange(points, depth + 1, mid, end, 1 - axis);
+    }
+}
+
+template <typename I>
+void Triangulator<I>::run()
+{
+    if (m_points.size() < 2)
+        return;
+    triangulate(0, 0, I{0}, static_cast<I>(m_points.size()), 0, 0, m_pools[0]);
+}
+
+template <typename I>
+std::pair<HalfEdge<I>*, HalfEdge<I>*> Triangulator<I>::triangulate(std::size_t node_idx, unsigned int depth, I begin, I end, unsigned int axis, unsigned int out_axis, Pool<I>& pool)
+{
+    assert(begin + 1 < end);
+    const I n = end - begin;
+    if (n <= 3)
+        return triangulate_base_case(begin, end, out_axis, pool);
+
+    const I mid = begin + n / 2;
+    std::pair<Edge*, Edge*> left;
+    std::pair<Edge*, Edge*> right;
+    if (depth < m_parallel_depth)
+    {
+        const std::size_t left_idx = 2 * node_idx + 1;
+        const std::size_t right_idx = 2 * node_idx + 2;
+        stdutils::parallel::TaskGroup group;
+        group.run([this, &left, left_idx, depth, begin, mid, axis]() {
+            left = triangulate(left_idx, depth + 1, begin, mid, 1 - axis, axis, m_pools[left_idx]);
+        });
+        right = triangulate(right_idx, depth + 1, mid, end, 1 - axis, axis, m_pools[right_idx]);
+        group.wait();
+        m_check_cancellation();
+    }
+    else
+    {
+        left = triangulate(node_idx, depth + 1, begin, mid, 1 - axis, axis, pool);
+        right = triangulate(node_idx, depth + 1, mid, end, 1 - axis, axis, pool);
+        if (n >= (I{1} << 14)) { m_check_cancellation(); }
+    }
+    const auto result = merge(left.first, left.second, right.first, right.second, pool);
+    return axis == out_axis ? result : hull_extremes(result.second, out_axis);
+}
+
+template <typename I>
+std::pair<HalfEdge<I>*, HalfEdge<I>*> Triangulator<I>::triangulate_base_case(I begin, I end, unsigned int out_axis, Pool<I>& pool)
+{
+    // Sort the two or three points along out_axis
+    const auto swap_points = [this](I a, I b) { std::swap(m_points[a], m_points[b]); std::swap(m_input_indices[a], m_input_indices[b]); };
+    for (I i = begin + 1; i < end; i++)
+        for (I j = i; j > begin && less(m_points[j], m_points[j - 1], out_axis); j--)
+            swap_points(j, j - 1);
+
+    if (end - begin == 2)
+    {
+        Edge* a = make_edge(begin, begin + 1, pool);
+        return { a, a->sym() };
+    }
+    assert(end - begin == 3);
+    const I s1 = begin;
+    const I s2 = begin + 1;
+    const I s3 = begin + 2;
+    Edge* a = make_edge(s1, s2, pool);
+    Edge* b = make_edge(s2, s3, pool);
+    splice(a->sym(), b);
+    if (ccw(s1, s2, s3))
+    {
+        connect(b, a, pool);
+        return { a, b->sym() };
+    }
+    else if (ccw(s1, s3, s2))
+    {
+        Edge* c = connect(b, a, pool);
+        return { c->sym(), c };
+    }
+    return { a, b->sym() };         // Collinear points
+}
+
+// Walk the convex hull, starting from a clockwise hull edge, to find the hull edges out of the first and the last vertex along the axis
+template <typename I>
+std::pair<HalfEdge<I>*, HalfEdge<I>*> Triangulator<I>::hull_extremes(Edge* rdo, unsigned int axis) const
+{
+    Edge* first_in = nullptr;           // The hull edge into the first vertex
+    Edge* last_out = rdo;               // The hull edge out of the last vertex
+    Edge* e = rdo;
+    do
+    {
+        if (!first_in || less(m_points[e->dest()], m_points[first_in->dest()], axis)) { first_in = e; }
+        if (less(m_points[last_out->org], m_points[e->org], axis)) { last_out = e; }
+        e = e->lnext();
+    } while (e != rdo);
+    return { first_in->sym(), last_out };
+}
+
+template <typename I>
+std::pair<HalfEdge<I>*, HalfEdge<I>*> Triangulator<I>::merge(Edge* ldo, Edge* ldi, Edge* rdi, Edge* rdo, Pool<I>& pool)
+{
+    // Lower common tangent of the two halves
+    while (true)
+    {
+        if (left_of(rdi->org, ldi)) { ldi = ldi->lnext(); }
+        else if (right_of(ldi->org, rdi)) { rdi = rdi->rprev(); }
+        else { break; }
+    }
+    Edge* basel = connect(rdi->sym(), ldi, pool);
+    if (ldi->org == ldo->org) { ldo = basel->sym(); }
+    if (rdi->org == rdo->org) { rdo = basel; }
+
+    // Zip the two halves from bottom to top
+    const auto valid = [this, &basel](Edge* e) { return right_of(e->dest(), basel); };
+    while (true)
+    {
+        Edge* lcand = basel->sym()->next;
+        if (valid(lcand))
+        {
+            while (in_circle(basel->dest(), basel->org, lcand->dest(), lcand->next->dest()))
+            {
+                Edge* t = lcand->next;
+                delete_edge(lcand);
+                lcand = t;
+            }
+        }
+        Edge* rcand = basel->oprev();
+        if (valid(rcand))
+        {
+            while (in_circle(basel->dest(), basel->org, rcand->dest(), rcand->oprev()->dest()))
+            {
+                Edge* t = rcand->oprev();
+                delete_edge(rcand);
+                rcand = t;
+            }
+        }
+        const bool lvalid = valid(lcand);
+        const bool rvalid = valid(rcand);
+        if (!lvalid && !rvalid)
+            break;
+        if (!lvalid || (rvalid && in_circle(lcand->dest(), lcand->org, rcand->org, rcand->dest())))
+            basel = connect(rcand, basel->sym(), pool);
+        else
+            basel = connect(basel->sym(), lcand->sym(), pool);
+    }
+    return { ldo, rdo };
+}
+
+template <typename I>
+HalfEdge<I>* Triangulator<I>::make_edge(I org, I dest, Pool<I>& pool)
+{
+    auto& q = pool.emplace_back();
+    auto& e = q.e;
+    assert(e[0].rank() == 0);
+    e[0].next = &e[0];
+    e[1].next = &e[3];
+    e[2].next = &e[2];
+    e[3].next = &e[1];
+    e[0].org = org;
+    e[2].org = dest;
+    e[1].org = 0;
+    e[3].org = 0;
+    for (auto& h : e) { h.face = Undef; }
+    return &e[0];
+}
+
+template <typename I>
+void Triangulator<I>::splice(Edge* a, Edge* b)
+{
+    Edge* alpha = a->next->rot();
+    Edge* beta = b->next->rot();
+    std::swap(a->next, b->next);
+    std::swap(alpha->next, beta->next);
+}
+
+template <typename I>
+HalfEdge<I>* Triangulator<I>::connect(Edge* a, Edge* b, Pool<I>& pool)
+{
+    Edge* e = make_edge(a->dest(), b->org, pool);
+    splice(e, a->lnext());
+    splice(e->sym(), b);
+    return e;
+}
+
+template <typename I>
+void Triangulator<I>::delete_edge(Edge* e)
+{
+    splice(e, e->oprev());
+    splice(e->sym(), e->sym()->oprev());
+    e->rot()->org = Deleted;
+}
+
+template <typename I>
+void Triangulator<I>::extract(graphs::TriangleSoup<I>& faces, graphs::TriangleAdjacency<I>& adjacency)
+{
+    stdutils::ArenaVector<Edge*> face_edges(m_points.get_allocator());
+    for (auto& pool : m_pools)
+        pool.for_each([&](QuadEdge<I>& q) {
+            if (q.e[1].org == Deleted)
+                return;
+            for (Edge* h : { &q.e[0], &q.e[2] })
+            {
+                if (h->face != Undef)
+                    continue;
+                // Walk the left face. The inner faces are the counterclockwise triangles, the outer face is the convex hull.
+                std::size_t nb_edges = 0;
+                Edge* e = h;
+                do { e->face = Visited; e = e->lnext(); nb_edges++; } while (e != h);
+                Edge* b = h->lnext();
+                Edge* c = b->lnext();
+                if (nb_edges == 3 && ccw(h->org, b->org, c->org))
+                {
+                    const auto f = static_cast<I>(faces.size());
+                    h->face = b->face = c->face = f;
+                    faces.emplace_back(m_input_indices[h->org], m_input_indices[b->org], m_input_indices[c->org]);
+                    face_edges.push_back(h);
+                }
+            }
+        });
+
+    // The k-th neighbor is across the edge (k, k+1), which is the convention of graphs::TriangleAdjacency
+    adjacency.reserve(faces.size());
+    for (Edge* h : face_edges)
+    {
+        auto& adj = adjacency.emplace_back();
+        Edge* e = h;
+        for (std::size_t k = 0; k < 3; k++)
+        {
+            const I neighbor = e->sym()->face;
+            adj[k] = neighbor == Visited ? Undef : neighbor;
+            e = e->lnext();
+        }
+    }
+}
+
+} // namespace divconq
+} // namespace details
+
+template <typename F, typename I>
+DivConqImpl<F, I>::DivConqImpl(const stdutils::io::ErrorHandler* err_handler)
+    : Interface<F, I>(err_handler)
+    , m_has_constraints(false)
+{ }
+
+template <typename F, typename I>
+void DivConqImpl<F, I>::add_path_impl(Points vertices, bool closed)
+{
+    if (closed && vertices.size() < 3)
+    {
+        if (m_err_handler) { m_err_handler(stdutils::io::Severity::WARN, "Ignoring a closed polyline with less than 3 vertices"); }
+        return;
+    }
+    m_points.reserve(m_points.size() + vertices.size());
+    m_points.insert(m_points.end(), vertices.begin(), vertices.end());
+    m_has_constraints = true;
+}
+
+template <typename F, typename I>
+void DivConqImpl<F, I>::add_hole_impl(Points vertices, bool closed)
+{
+    add_path_impl(vertices, closed);
+}
+
+template <typename F, typename I>
+void DivConqImpl<F, I>::add_steiner_impl(Points vertices)
+{
+    m_points.reserve(m_points.size() + vertices.size());
+    m_points.insert(m_points.end(), vertices.begin(), vertices.end());
+}
+
+template <typename F, typename I>
+void DivConqImpl<F, I>::add_edges_impl(const shapes::Edges2d<F, I>& edges)
+{
+    // The constraints are not stored, only their vertices
+    m_points.reserve(m_points.size() + edges.vertices.size());
+    m_points.insert(m_points.end(), edges.vertices.begin(), edges.vertices.end());
+    m_has_constraints |= !edges.indices.empty();
+}
+
+template <typename F, typename I>
+void DivConqImpl<F, I>::triangulate_impl(TriangulationPolicy policy, const CancellationToken* token, shapes::Triangles2d<F, I>& result) const
+{
+    if (policy == TriangulationPolicy::CDT && m_has_constraints)
+    {
+        if (m_err_handler) { m_err_handler(stdutils::io::Severity::WARN, "The constrained triangulation is not supported. The output will be empty."); }
+        return;
+    }
+
+    // Sort the points lexicographically, and skip the duplicates
+    const stdutils::parallel::Policy parallel_policy;
+    stdutils::ArenaVector<I> sorted_indices(m_points.size(), I{0}, this->template arena_allocator<I>());
+    {
+        const PhaseTimer phase(*this, "DivConq::sort");
+        std::iota(sorted_indices.begin(), sorted_indices.end(), I{0});
+        stdutils::parallel::sort(parallel_policy, sorted_indices.begin(), sorted_indices.end(), [this](I a, I b) {
+            const auto& p = m_points[a];
+            const auto& q = m_points[b];
+            return p.x < q.x || (p.x == q.x && p.y < q.y);
+        });
+    }
+    typename details::divconq::Triangulator<I>::Points points(this->template arena_allocator<shapes::Point2d<double>>());
+    stdutils::ArenaVector<I> vertex_indices(this->template arena_allocator<I>());
+    {
+        const PhaseTimer phase(*this, "DivConq::copy_vertices");
+        points.reserve(m_points.size());
+        vertex_indices.reserve(m_points.size());
+        for (const I idx : sorted_indices)
+        {
+            const shapes::Point2d<double> p(static_cast<double>(m_points[idx].x), static_cast<double>(m_points[idx].y));
+            if (!points.empty() && points.back() == p)
+                continue;
+            points.push_back(p);
+            vertex_indices.push_back(idx);
+        }
+        sorted_indices = stdutils::ArenaVector<I>(sorted_indices.get_allocator());
+    }
+    if (points.size() < 3)
+    {
+        if (m_err_handler) { m_err_handler(stdutils::io::Severity::WARN, "Not enough points to triangulate. The output will be empty."); }
+        return;
+    }
+    this->check_cancellation(token);
+
+    // Depth of the binary tree of concurrent subproblems
+    unsigned int parallel_depth = 0;
+    while ((std::size_t{2} << parallel_depth) <= stdutils::parallel::nb_chunks(parallel_policy, points.size())) { parallel_depth++; }
+
+    details::divconq::Triangulator<I> triangulator(points, parallel_depth, [token]() { Interface<F, I>::check_cancellation(token); });
+    {
+        const PhaseTimer phase(*this, "DivConq::run");
+        triangulator.run();
+    }
+    this->check_cancellation(token);
+    const PhaseTimer phase(*this, "DivConq::copy_faces");
+    triangulator.extract(result.faces, result.adjacency);
+    for (auto& face : result.faces)
+    {
+        for (std::size_t k = 0; k < 3; k++) { face[k] = vertex_indices[static_cast<std::size_t>(face[k])]; }
+    }
+    assert(graphs::is_valid(result.adjacency, result.faces));
+}
+
+template <typename F, typename I>
+std::size_t DivConqImpl<F, I>::byte_size_impl() const noexcept
+{
+    // The quad-edges only live during the triangulation
+    return 0;
+}
+
+template <typename F, typename I>
+void DivConqImpl<F, I>::clear_impl() noexcept
+{
+    m_has_constraints = false;
+}
+
+template <typename F, typename I>
+void DivConqImpl<F, I>::reserve_impl(std::size_t)
+{
+    // The constraints are not stored
+}
+
+} // namespace delaunay
@@ -5,9 +5,12 @@
 #include <graphs/graph.h>
 #include <dt/dt_interface.h>
 #include <poly2tri/poly2tri.h>
+#include <stdutils/arena.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <exception>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <numeric>
@@ -31,20 +34,25 @@ class Poly2triImpl : public Interface<F, I>
 public:
     Poly2triImpl(const stdutils::io::ErrorHandler* err_handler = nullptr);
 
-    void add_path(const shapes::PointPath2d<F>& pp) override;
-    void add_hole(const shapes::PointPath2d<F>& pp) override;
-    void add_steiner(const shapes::PointCloud2d<F>& pc) override;
-
 private:
-    void triangulate_impl(TriangulationPolicy policy, shapes::Triangles2d<F, I>& result) const override;
+    using typename Interface<F, I>::Points;
+    using typename Interface<F, I>::PhaseTimer;
+
+    void add_path_impl(Points vertices, bool closed) override;
+    void add_hole_impl(Points vertices, bool closed) override;
+    void add_steiner_impl(Points vertices) override;
+    void triangulate_impl(TriangulationPolicy policy, const CancellationToken* token, shapes::Triangles2d<F, I>& result) const override;
+    std::size_t byte_size_impl() const noexcept override;
+    void clear_impl() noexcept override;
+    void reserve_impl(std::size_t nb_constraints) override;
 
-    shapes::Points2d<F> m_points;
     std::vector<std::pair<I, I>> m_polylines_indices;
     std::vector<bool> m_polyline_is_closed;
     std::vector<std::pair<I, I>> m_steiner_indices;
     bool m_has_main_path;
 
     using Interface<F, I>::m_err_handler;
+    using Interface<F, I>::m_points;
 };
 
 template <typename F, typename I>
@@ -64,30 +72,59 @@ std::unique_ptr<Interface<F, I>> get_poly2tri_impl(const stdutils::io::ErrorHand
 namespace details {
 namespace p2t {
 
+    // The pool of the points handed over to the library: One allocation, sized up front, whose addresses do not change until the faces are copied
     template <typename F>
-    std::vector<::p2t::Point> copy_vertices(const shapes::Points2d<F>& points)
+    void copy_vertices(const shapes::Points2d<F>& points, stdutils::ArenaVector<::p2t::Point>& pool)
     {
-        std::vector<::p2t::Point> result;
-        result.reserve(points.size());
-        for (const auto& p : points) { result.emplace_back(static_cast<double>(p.x), static_cast<double>(p.y)); }
-        return result;
+        pool.clear();
+        pool.reserve(points.size());
+        for (const auto& p : points) { pool.emplace_back(static_cast<double>(p.x), static_cast<double>(p.y)); }
     }
 
 #if DT_POLY2TRI_ORIGINAL_API
+    // The original API takes the polylines as vectors of pointers: The same buffer is refilled for each polyline, and only grows once to
+    // the size of the longest one.
     template <typename I>
-    std::vector<::p2t::Point*> to_polyline(const std::vector<::p2t::Point>& all_points, std::pair<I, I> range)
+    const std::vector<::p2t::Point*>& to_polyline(stdutils::ArenaVector<::p2t::Point>& all_points, std::pair<I, I> range, std::vector<::p2t::Point*>& buffer)
     {
         const I begin = range.first;
         const I end = range.second;
-        std::vector<::p2t::Point*> result;
         assert(begin <= end);
         assert(end <= all_points.size());
-        result.resize(end - begin, nullptr);
-        std::iota(result.begin(), result.end(), const_cast<::p2t::Point*>(&all_points[begin]));
-        return result;
+        buffer.resize(static_cast<std::size_t>(end - begin));
+        std::iota(buffer.begin(), buffer.end(), all_points.data() + static_cast<std::size_t>(begin));
+        return buffer;
     }
 #endif
 
+    // The vertex indices are the offsets of the points of the faces in the pool. The points that are not in the pool, e.g. those added by
+    // the library, are detected with a total order on the pointers. Return the number of faces that were dropped.
+    template <typename I, typename TriangleList>
+    std::size_t copy_faces(const TriangleList& p2t_triangles, const stdutils::ArenaVector<::p2t::Point>& p2t_points, graphs::TriangleSoup<I>& faces)
+    {
+        const ::p2t::Point* const begin_point = p2t_points.data();
+        const ::p2t::Point* const end_point = begin_point + p2t_points.size();
+        const std::less<const ::p2t::Point*> less;
+        std::size_t nb_invalid = 0;
+        faces.reserve(faces.size() + p2t_triangles.size());
+        for (const auto& triangle : p2t_triangles)
+        {
+            const ::p2t::Point* const a = triangle->GetPoint(0);
+            const ::p2t::Point* const b = triangle->GetPoint(1);
+            const ::p2t::Point* const c = triangle->GetPoint(2);
+            const bool in_pool = !less(a, begin_point) && less(a, end_point)
+                              && !less(b, begin_point) && less(b, end_point)
+                              && !less(c, begin_point) && less(c, end_point);
+            if (!in_pool || a == b || b == c || c == a)
+            {
+                nb_invalid++;
+                continue;
+            }
+            faces.emplace_back(static_cast<I>(a - begin_point), static_cast<I>(b - begin_point), static_cast<I>(c - begin_point));
+        }
+        return nb_invalid;
+    }
+
 } // namespace p2t
 } // namespace details
 
@@ -112,87 +149,84 @@ namespace {
 template <typename F, typename I>
 Poly2triImpl<F, I>::Poly2triImpl(const stdutils::io::ErrorHandler* err_handler)
     : Interface<F,I>(err_handler)
-    , m_points()
     , m_polylines_indices()
     , m_steiner_indices()
     , m_has_main_path(false)
 { }
 
 template <typename F, typename I>
-void Poly2triImpl<F, I>::add_path(const shapes::PointPath2d<F>& pp)
+void Poly2triImpl<F, I>::add_path_impl(Points vertices, bool closed)
 {
-    assert(shapes::is_valid(pp));
 #if DT_POLY2TRI_ORIGINAL_API
     if (m_has_main_path)
     {
         if (m_err_handler) { m_err_handler(stdutils::io::Severity::ERR, "Only one main polyline is supported. Ignoring this one. Try using add_hole() instead."); }
         return;
     }
-    if (!pp.closed && m_err_handler) { m_err_handler(stdutils::io::Severity::WARN, "add_path(): All polylines are interpreted as closed"); }
+    if (!closed && m_err_handler) { m_err_handler(stdutils::io::Severity::WARN, "add_path(): All polylines are interpreted as closed"); }
 #else
-    if (!pp.closed && pp.vertices.size() < 2)
+    if (!closed && vertices.size() < 2)
     {
         if (m_err_handler) { m_err_handler(stdutils::io::Severity::ERR, "add_path(): Ignoring an open polyline with less than 2 vertices"); }
         return;
     }
 #endif
-    if (pp.closed && pp.vertices.size() < 3)
+    if (closed && vertices.size() < 3)
     {
         if (m_err_handler) { m_err_handler(stdutils::io::Severity::ERR, "add_path(): Ignoring a closed polyline with less than 3 vertices"); }
         return;
     }
 
     const I begin_idx = static_cast<I>(m_points.size());
-    m_points.reserve(m_points.size() + pp.vertices.size());
-    m_points.insert(m_points.end(), pp.vertices.begin(), pp.vertices.end());
+    m_points.reserve(m_points.size() + vertices.size());
+    m_points.insert(m_points.end(), vertices.begin(), vertices.end());
     const I end_idx = static_cast<I>(m_points.size());
 
     // The first path will be the main polyline (next paths are the holes)
     m_polylines_indices.emplace(m_polylines_indices.begin(), begin_idx, end_idx);
-    m_polyline_is_closed.emplace_back(pp.closed);
+    m_polyline_is_closed.emplace_back(closed);
 
     m_has_main_path = true;
 }
 
 template <typename F, typename I>
-void Poly2triImpl<F, I>::add_hole(const shapes::PointPath2d<F>& pp)
+void Poly2triImpl<F, I>::add_hole_impl(Points vertices, bool closed)
 {
-    assert(shapes::is_valid(pp));
 #if DT_POLY2TRI_ORIGINAL_API
-    if (!pp.closed && m_err_handler) { m_err_handler(stdutils::io::Severity::WARN, "add_hole(): All polylines are interpreted as closed"); }
+    if (!closed && m_err_handler) { m_err_handler(stdutils::io::Severity::WARN, "add_hole(): All polylines are interpreted as closed"); }
 #else
-    if (!pp.closed && pp.vertices.size() < 2)
+    if (!closed && vertices.size() < 2)
     {
         if (m_err_handler) { m_err_handler(stdutils::io::Severity::ERR, "add_hole(): Ignoring an open polyline with less than 2 vertices"); }
         return;
     }
 #endif
-    if (pp.closed && pp.vertices.size() < 3)
+    if (closed && vertices.size() < 3)
     {
         if (m_err_handler) { m_err_handler(stdutils::io::Severity::ERR, "add_hole(): Ignoring a closed polyline with less than 3 vertices"); }
         return;
     }
 
     const I begin_idx = static_cast<I>(m_points.size());
-    m_points.reserve(m_points.size() + pp.vertices.size());
-    m_points.insert(m_points.end(), pp.vertices.begin(), pp.vertices.end());
+    m_points.reserve(m_points.size() + vertices.size());
+    m_points.insert(m_points.end(), vertices.begin(), vertices.end());
     const I end_idx = static_cast<I>(m_points.size());
     m_polylines_indices.emplace_back(begin_idx, end_idx);
-    m_polyline_is_closed.emplace_back(pp.closed);
+    m_polyline_is_closed.emplace_back(closed);
 }
 
 template <typename F, typename I>
-void Poly2triImpl<F, I>::add_steiner(const shapes::PointCloud2d<F>& pc)
+void Poly2triImpl<F, I>::add_steiner_impl(Points vertices)
 {
     const I begin_idx = static_cast<I>(m_points.size());
-    m_points.reserve(m_points.size() + pc.vertices.size());
-    m_points.insert(m_points.end(), pc.vertices.begin(), pc.vertices.end());
+    m_points.reserve(m_points.size() + vertices.size());
+    m_points.insert(m_points.end(), vertices.begin(), vertices.end());
     const I end_idx = static_cast<I>(m_points.size());
     m_steiner_indices.emplace_back(begin_idx, end_idx);
 }
 
 template <typename F, typename I>
-void Poly2triImpl<F, I>::triangulate_impl(TriangulationPolicy policy, shapes::Triangles2d<F, I>& result) const
+void Poly2triImpl<F, I>::triangulate_impl(TriangulationPolicy policy, const CancellationToken* token, shapes::Triangles2d<F, I>& result) const
 {
     if (m_points.size() < 3)
     {
@@ -217,19 +251,20 @@ void Poly2triImpl<F, I>::triangulate_impl(TriangulationPolicy policy, shapes::Tr
         return;
     }
 
-    std::vector<p2t::Point> p2t_points = details::p2t::copy_vertices(m_points);
+    stdutils::ArenaVector<p2t::Point> p2t_points(this->template arena_allocator<p2t::Point>());
+    {
+        const PhaseTimer phase(*this, "poly2tri::copy_vertices");
+        details::p2t::copy_vertices(m_points, p2t_points);
+    }
 
     // As per poly2tri documentation:
     // Initialize CDT with a simple polyline (this defines the constrained edges)
-    const auto main_polyline = m_has_main_path ? details::p2t::to_polyline<I>(p2t_points, m_polylines_indices.front()) : std::vector<p2t::Point*>();
-    p2t::CDT cdt(main_polyline);
+    std::vector<p2t::Point*> polyline;
+    p2t::CDT cdt(details::p2t::to_polyline<I>(p2t_points, m_polylines_indices.front(), polyline));
 
     // Add holes if necessary (also simple polylines)
     for (unsigned int path_idx = 1; path_idx < m_polylines_indices.size(); path_idx++)
-    {
-        const auto hole_polyline = details::p2t::to_polyline<I>(p2t_points, m_polylines_indices.at(path_idx));
-        cdt.AddHole(hole_polyline);
-    }
+        cdt.AddHole(details::p2t::to_polyline<I>(p2t_points, m_polylines_indices.at(path_idx), polyline));
 
     // Add Steiner points
     for (const auto& range : m_steiner_indices)
@@ -239,8 +274,12 @@ void Poly2triImpl<F, I>::triangulate_impl(TriangulationPolicy policy, shapes::Tr
             cdt.AddPoint(&p2t_points[idx]);
     }
 
-    // Triangulate
-    cdt.Triangulate();
+    // Triangulate. The library cannot be interrupted: The token is only checked before and after the call.
+    this->check_cancellation(token);
+    {
+        const PhaseTimer phase(*this, "poly2tri::Triangulate");
+        cdt.Triangulate();
+    }
     const std::vector<p2t::Triangle*> p2t_triangles = cdt.GetTriangles();
 
 #else
@@ -248,7 +287,11 @@ void Poly2triImpl<F, I>::triangulate_impl(TriangulationPolicy policy, shapes::Tr
     // Modern poly2tri API
     //
 
-    std::vector<p2t::Point> p2t_points = details::p2t::copy_vertices(m_points);
+    stdutils::ArenaVector<p2t::Point> p2t_points(this->template arena_allocator<p2t::Point>());
+    {
+        const PhaseTimer phase(*this, "poly2tri::copy_vertices");
+        details::p2t::copy_vertices(m_points, p2t_points);
+    }
 
     p2t::CDT cdt;
 
@@ -287,7 +330,9 @@ void Poly2triImpl<F, I>::triangulate_impl(TriangulationPolicy policy, shapes::Tr
             cdt.AddPoints(p2t_points.data() + static_cast<std::size_t>(range.first), static_cast<std::size_t>(range.second - range.first));
         }
 
-        // Triangulate
+        // Triangulate. The library cannot be interrupted: The token is only checked before and after the call.
+        this->check_cancellation(token);
+        const PhaseTimer phase(*this, "poly2tri::Triangulate");
         cdt.Triangulate(p2t::Policy::OuterPolygon);
     }
     else
@@ -297,7 +342,9 @@ void Poly2triImpl<F, I>::triangulate_impl(TriangulationPolicy policy, shapes::Tr
         // Add Steiner points
         cdt.AddPoints(p2t_points.data(), p2t_points.size());
 
-        // Triangulate
+        // Triangulate. The library cannot be interrupted: The token is only checked before and after the call.
+        this->check_cancellation(token);
+        const PhaseTimer phase(*this, "poly2tri::Triangulate");
         cdt.Triangulate(p2t::Policy::ConvexHull);
     }
 
@@ -313,25 +360,41 @@ void Poly2triImpl<F, I>::triangulate_impl(TriangulationPolicy policy, shapes::Tr
 
     const auto& p2t_triangles = cdt.GetTriangles();
 #endif
+    this->check_cancellation(token);
 
     // Copy result
-    result.vertices = m_points;
-    const p2t::Point* begin_point = &p2t_points[0];
-    result.faces.reserve(p2t_triangles.size());
-    const I nb_vertices = static_cast<I>(result.vertices.size());
-    for (const auto& triangle : p2t_triangles)
+    const PhaseTimer phase(*this, "poly2tri::copy_faces");
+    const std::size_t nb_invalid = details::p2t::copy_faces<I>(p2t_triangles, p2t_points, result.faces);
+    if (nb_invalid > 0 && m_err_handler)
     {
-        graphs::Triangle<I> face;
-        bool valid_range = true;
-        for (unsigned int i = 0; i < 3; i++)
-        {
-            const p2t::Point* point = triangle->GetPoint(static_cast<int>(i));
-            face[i] = static_cast<I>(std::distance(begin_point, point));
-            valid_range &= (face[i] < nb_vertices);
-        }
-        if (valid_range && graphs::is_valid(face)) { result.faces.emplace_back(std::move(face)); }
-        else if (m_err_handler) { m_err_handler(stdutils::io::Severity::ERR, "The triangulation process returned an invalid triangle"); }
+        std::stringstream out;
+        out << "The triangulation process returned " << nb_invalid << " invalid triangle(s)";
+        m_err_handler(stdutils::io::Severity::ERR, out.str());
     }
 }
 
+template <typename F, typename I>
+std::size_t Poly2triImpl<F, I>::byte_size_impl() const noexcept
+{
+    return stdutils::memory::byte_size(m_polylines_indices)
+         + stdutils::memory::byte_size(m_polyline_is_closed)
+         + stdutils::memory::byte_size(m_steiner_indices);
+}
+
+template <typename F, typename I>
+void Poly2triImpl<F, I>::clear_impl() noexcept
+{
+    m_polylines_indices.clear();
+    m_polyline_is_closed.clear();
+    m_steiner_indices.clear();
+    m_has_main_path = false;
+}
+
+template <typename F, typename I>
+void Poly2triImpl<F, I>::reserve_impl(std::size_t nb_constraints)
+{
+    m_polylines_indices.reserve(nb_constraints);
+    m_polyline_is_closed.reserve(nb_constraints);
+}
+
 } // namespace delaunay
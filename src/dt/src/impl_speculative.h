@@ -0,0 +1,251 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <dt/dt_interface.h>
+#include <dt/validation.h>
+#include <stdutils/io.h>
+#include <stdutils/span.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace delaunay {
+
+/**
+ * Speculative triangulation: A fast implementation first, then a robust one if the output of the first one is not valid
+ *
+ * The typical pair is CDT with float computations, then CDT with double computations. The output of the fast implementation is
+ * validated cheaply (see delaunay::validate, without the sampled Delaunay check): It is rejected if it is empty, if it has degenerate
+ * or flipped faces, or if its adjacency is inconsistent. The messages of a rejected attempt are forwarded as traces.
+ *
+ * The input is stored once, in this instance, and handed over to each attempt in the same order, therefore the faces of the attempts
+ * index the same vertices. The attempts allocate their buffers on the heap, not in the arena of this instance.
+ */
+template <typename F, typename I = std::uint32_t>
+class SpeculativeImpl : public Interface<F, I>
+{
+public:
+    using Factory = std::unique_ptr<Interface<F, I>>(*)(const stdutils::io::ErrorHandler* err_handler);
+
+    SpeculativeImpl(Factory fast_factory, Factory robust_factory, const stdutils::io::ErrorHandler* err_handler = nullptr);
+
+private:
+    using typename Interface<F, I>::Points;
+    using typename Interface<F, I>::PhaseTimer;
+
+    void add_path_impl(Points vertices, bool closed) override;
+    void add_hole_impl(Points vertices, bool closed) override;
+    void add_steiner_impl(Points vertices) override;
+    void add_edges_impl(const shapes::Edges2d<F, I>& edges) override;
+    void triangulate_impl(TriangulationPolicy policy, const CancellationToken* token, shapes::Triangles2d<F, I>& result) const override;
+    std::size_t byte_size_impl() const noexcept override;
+    void clear_impl() noexcept override;
+    void reserve_impl(std::size_t nb_constraints) override;
+
+    enum class InputKind
+    {
+        Path,
+        Hole,
+        Steiner,
+        Edges,
+    };
+
+    // One call to add_*(), as a range of m_points. The edges of InputKind::Edges are m_edges[edges_begin, edges_end).
+    struct InputBatch
+    {
+        InputKind kind;
+        std::size_t begin_idx;
+        std::size_t end_idx;
+        bool closed;
+        std::size_t edges_begin;
+        std::size_t edges_end;
+    };
+
+    void add_batch(InputKind kind, Points vertices, bool closed);
+
+    // Hand the input over to an implementation instance, and triangulate it. If validate_output is true, the output is only kept if it is valid.
+    bool attempt(Factory factory, TriangulationPolicy policy, const CancellationToken* token, bool validate_output, stdutils::io::ErrorLog& log, shapes::Triangles2d<F, I>& result) const;
+
+    Factory m_fast_factory;
+    Factory m_robust_factory;
+    std::vector<InputBatch> m_batches;
+    std::vector<graphs::Edge<I>> m_edges;                   // Relative to the first vertex of their batch
+
+    using Interface<F, I>::m_err_handler;
+    using Interface<F, I>::m_points;
+};
+
+template <typename F, typename I, typename FastImpl, typename RobustImpl>
+std::unique_ptr<Interface<F, I>> get_speculative_impl(const stdutils::io::ErrorHandler* err_handler)
+{
+    const auto fast_factory = [](const stdutils::io::ErrorHandler* handler) -> std::unique_ptr<Interface<F, I>> { return std::make_unique<FastImpl>(handler); };
+    const auto robust_factory = [](const stdutils::io::ErrorHandler* handler) -> std::unique_ptr<Interface<F, I>> { return std::make_unique<RobustImpl>(handler); };
+    return std::make_unique<SpeculativeImpl<F, I>>(+fast_factory, +robust_factory, err_handler);
+}
+
+
+//
+//
+// Implementation
+//
+//
+
+
+template <typename F, typename I>
+SpeculativeImpl<F, I>::SpeculativeImpl(Factory fast_factory, Factory robust_factory, const stdutils::io::ErrorHandler* err_handler)
+    : Interface<F, I>(err_handler)
+    , m_fast_factory(fast_factory)
+    , m_robust_factory(robust_factory)
+    , m_batches()
+    , m_edges()
+{
+    assert(m_fast_factory && m_robust_factory);
+}
+
+template <typename F, typename I>
+void SpeculativeImpl<F, I>::add_batch(InputKind kind, Points vertices, bool closed)
+{
+    const std::size_t begin_idx = m_points.size();
+    m_points.insert(m_points.end(), vertices.begin(), vertices.end());
+    m_batches.push_back(InputBatch{ kind, begin_idx, m_points.size(), closed, m_edges.size(), m_edges.size() });
+}
+
+template <typename F, typename I>
+void SpeculativeImpl<F, I>::add_path_impl(Points vertices, bool closed)
+{
+    // Same rule as the implementations, which would otherwise drop the vertices and shift the indices of the next ones
+    if (closed && vertices.size() < 3)
+    {
+        if (m_err_handler) { m_err_handler(stdutils::io::Severity::WARN, "Ignoring a closed polyline with less than 3 vertices"); }
+        return;
+    }
+    add_batch(InputKind::Path, vertices, closed);
+}
+
+template <typename F, typename I>
+void SpeculativeImpl<F, I>::add_hole_impl(Points vertices, bool closed)
+{
+    if (closed && vertices.size() < 3)
+    {
+        if (m_err_handler) { m_err_handler(stdutils::io::Severity::WARN, "Ignoring a closed polyline with less than 3 vertices"); }
+        return;
+    }
+    add_batch(InputKind::Hole, vertices, closed);
+}
+
+template <typename F, typename I>
+void SpeculativeImpl<F, I>::add_steiner_impl(Points vertices)
+{
+    add_batch(InputKind::Steiner, vertices, false);
+}
+
+template <typename F, typename I>
+void SpeculativeImpl<F, I>::add_edges_impl(const shapes::Edges2d<F, I>& edges)
+{
+    add_batch(InputKind::Edges, stdutils::make_const_span(edges.vertices), false);
+    m_edges.insert(m_edges.end(), edges.indices.cbegin(), edges.indices.cend());
+    m_batches.back().edges_end = m_edges.size();
+}
+
+template <typename F, typename I>
+bool SpeculativeImpl<F, I>::attempt(Factory factory, TriangulationPolicy policy, const CancellationToken* token, bool validate_output, stdutils::io::ErrorLog& log, shapes::Triangles2d<F, I>& result) const
+{
+    const auto log_handler = log.handler();
+    auto impl = factory(&log_handler);
+    assert(impl);
+    impl->reserve(m_points.size(), m_batches.size());
+    for (const auto& batch : m_batches)
+    {
+        const Points vertices(m_points.data() + batch.begin_idx, batch.end_idx - batch.begin_idx);
+        switch (batch.kind)
+        {
+            case InputKind::Path:
+                impl->add_path(vertices, batch.closed);
+                break;
+
+            case InputKind::Hole:
+                impl->add_hole(vertices, batch.closed);
+                break;
+
+            case InputKind::Steiner:
+                impl->add_steiner(vertices);
+                break;
+
+            case InputKind::Edges:
+            {
+                shapes::Edges2d<F, I> edges;
+                edges.vertices.assign(vertices.begin(), vertices.end());
+                edges.indices.assign(m_edges.cbegin() + static_cast<std::ptrdiff_t>(batch.edges_begin), m_edges.cbegin() + static_cast<std::ptrdiff_t>(batch.edges_end));
+                impl->add_edges(edges);
+                break;
+            }
+
+            default:
+                assert(0);
+        }
+    }
+    auto triangles = impl->triangulate_and_release(policy, token);
+    this->check_cancellation(token);
+    if (triangles.faces.empty() || triangles.vertices.size() != m_points.size())
+        return false;
+    if (validate_output)
+    {
+        const ValidationReport report = validate(stdutils::parallel::Policy(), triangles, ValidationOptions());
+        if (!report.is_valid() || report.nb_degenerate > 0)
+            return false;
+    }
+    result.faces = std::move(triangles.faces);
+    result.adjacency = std::move(triangles.adjacency);
+    return true;
+}
+
+template <typename F, typename I>
+void SpeculativeImpl<F, I>::triangulate_impl(TriangulationPolicy policy, const CancellationToken* token, shapes::Triangles2d<F, I>& result) const
+{
+    stdutils::io::ErrorLog fast_log;
+    const bool fast_success = [&]() {
+        const PhaseTimer phase(*this, "Speculative::fast");
+        return attempt(m_fast_factory, policy, token, true, fast_log, result);
+    }();
+    if (fast_success)
+    {
+        fast_log.forward(m_err_handler);
+        return;
+    }
+    if (m_err_handler)
+    {
+        const stdutils::io::ErrorHandler& err_handler = m_err_handler;
+        fast_log.forward([&err_handler](stdutils::io::SeverityCode, stdutils::io::ErrorMessage msg) { err_handler(stdutils::io::Severity::TRACE, msg); });
+        m_err_handler(stdutils::io::Severity::TRACE, "The output of the fast triangulation is not valid. Falling back on the robust one.");
+    }
+    stdutils::io::ErrorLog robust_log;
+    const PhaseTimer phase(*this, "Speculative::robust");
+    attempt(m_robust_factory, policy, token, false, robust_log, result);
+    robust_log.forward(m_err_handler);
+}
+
+template <typename F, typename I>
+std::size_t SpeculativeImpl<F, I>::byte_size_impl() const noexcept
+{
+    return m_batches.capacity() * sizeof(InputBatch) + m_edges.capacity() * sizeof(graphs::Edge<I>);
+}
+
+template <typename F, typename I>
+void SpeculativeImpl<F, I>::clear_impl() noexcept
+{
+    m_batches.clear();
+    m_edges.clear();
+}
+
+template <typename F, typename I>
+void SpeculativeImpl<F, I>::reserve_impl(std::size_t nb_constraints)
+{
+    m_batches.reserve(nb_constraints + 1);
+}
+
+} // namespace delaunay
@@ -4,44 +4,71 @@
 
 #include <graphs/graph.h>
 #include <dt/dt_interface.h>
+#include <shapes/bounding_box.h>
+#include <shapes/predicates.h>
+#include <stdutils/arena.h>
 #include <triangle.h>
 
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <exception>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <sstream>
+#include <string>
 #include <utility>
 #include <vector>
 
 namespace delaunay {
 
+// The algorithms of the Triangle library to compute the Delaunay triangulation
+enum class TriangleAlgorithm
+{
+    DivideAndConquer,           // Default
+    Sweepline,                  // F: Steven Fortune's sweepline algorithm
+    Incremental,                // i: Randomized incremental algorithm
+};
+
 template <typename F, typename I = std::uint32_t>
 class TriangleImpl : public Interface<F, I>
 {
 public:
-    TriangleImpl(const stdutils::io::ErrorHandler* err_handler = nullptr);
-
-    void add_path(const shapes::PointPath2d<F>& pp) override;
-    void add_hole(const shapes::PointPath2d<F>& pp) override;
-    void add_steiner(const shapes::PointCloud2d<F>& pc) override;
+    TriangleImpl(const stdutils::io::ErrorHandler* err_handler = nullptr, TriangleAlgorithm algorithm = TriangleAlgorithm::DivideAndConquer);
 
 private:
-    void triangulate_impl(TriangulationPolicy policy, shapes::Triangles2d<F, I>& result) const override;
+    using typename Interface<F, I>::Points;
+    using typename Interface<F, I>::PhaseTimer;
+
+    void add_path_impl(Points vertices, bool closed) override;
+    void add_hole_impl(Points vertices, bool closed) override;
+    void add_steiner_impl(Points vertices) override;
+    void add_edges_impl(const shapes::Edges2d<F, I>& edges) override;
+    void triangulate_impl(TriangulationPolicy policy, const CancellationToken* token, shapes::Triangles2d<F, I>& result) const override;
+    std::size_t byte_size_impl() const noexcept override;
+    void clear_impl() noexcept override;
+    void reserve_impl(std::size_t nb_constraints) override;
 
-    shapes::Points2d<F> m_points;
+    void add_polyline(Points vertices, bool closed, bool hole);
+
+    TriangleAlgorithm m_algorithm;
     std::vector<std::pair<I, I>> m_polylines_indices;
     std::vector<bool> m_polyline_is_closed;
+    std::vector<bool> m_polyline_is_hole;
+    std::vector<std::pair<I, I>> m_edges;                   // The edges of add_edges(), as indices in m_points
 
     using Interface<F, I>::m_err_handler;
+    using Interface<F, I>::m_points;
 };
 
-template <typename F, typename I>
+template <typename F, typename I, TriangleAlgorithm A = TriangleAlgorithm::DivideAndConquer>
 std::unique_ptr<Interface<F, I>> get_triangle_impl(const stdutils::io::ErrorHandler* err_handler)
 {
-    return std::make_unique<TriangleImpl<F, I>>(err_handler);
+    return std::make_unique<TriangleImpl<F, I>>(err_handler, A);
 }
 
 
@@ -55,18 +82,35 @@ std::unique_ptr<Interface<F, I>> get_triangle_impl(const stdutils::io::ErrorHand
 namespace details {
 namespace triangle {
 
-    template <typename F>
-    using Point = std::array<F, 2>;
+
+    // The Triangle library keeps a global state (the exact arithmetic constants, the random seed),
+    // therefore concurrent calls to ::triangulate must be serialized.
+    inline std::mutex& triangulate_mutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
 
     using Edge = std::array<int, 2>;
 
+    // Triangle reads the input points as an array of interleaved coordinates, which is the memory layout of shapes::Points2d<REAL>:
+    // Those are passed as is, since Triangle does not write to the input buffer. Other scalar types are converted to REAL in `buffer`.
     template <typename F>
-    std::vector<Point<F>> copy_vertices(const shapes::Points2d<F>& points)
+    REAL* point_list(const shapes::Points2d<F>& points, stdutils::ArenaVector<REAL>& buffer)
     {
-        std::vector<Point<F>> result;
-        result.reserve(points.size());
-        std::transform(std::cbegin(points), std::cend(points), std::back_inserter(result), [](const auto&p) { return Point<F> { p.x, p.y }; });
-        return result;
+        assert(!points.empty());
+        if constexpr (std::is_same_v<F, REAL>)
+        {
+            static_assert(std::is_standard_layout_v<shapes::Point2d<F>> && sizeof(shapes::Point2d<F>) == 2 * sizeof(REAL));
+            return const_cast<REAL*>(&points.front().x);
+        }
+        else
+        {
+            buffer.clear();
+            buffer.reserve(2 * points.size());
+            for (const auto& p : points) { buffer.push_back(static_cast<REAL>(p.x)); buffer.push_back(static_cast<REAL>(p.y)); }
+            return buffer.data();
+        }
     }
 
     void reset(triangulateio& tri)
@@ -116,58 +160,138 @@ namespace triangle {
         if (tri.normlist != nullptr) { ::free(tri.normlist); tri.normlist = nullptr; }
     }
 
+    // A point strictly inside the closed polyline `loop`, and outside of the other closed polylines, e.g. the islands inside a hole.
+    // Let v be the lowest (then leftmost) vertex of the loop, which is convex, and a, b its neighbors. Let q be the vertex inside the closed
+    // triangle (a, v, b), or on its edges, that is the closest to v measured along the normal of ab. The line through q parallel to ab cuts
+    // a smaller triangle (a', v, b') off the corner, which contains no vertex and therefore crosses no edge: Its centroid is the seed. It is
+    // strictly inside the loop, even if q is on the edge av or vb. If there is no such vertex, the seed is the centroid of (a, v, b).
+    // Returns false if the corner at v is degenerate.
+    template <typename F>
+    bool hole_seed(const shapes::Points2d<F>& points, std::pair<std::size_t, std::size_t> loop, const std::vector<std::pair<std::size_t, std::size_t>>& other_loops, const std::vector<shapes::BoundingBox2d<F>>& other_bbs, shapes::Point2d<double>& seed)
+    {
+        const auto point = [&points](std::size_t idx) { return shapes::Point2d<double>(static_cast<double>(points[idx].x), static_cast<double>(points[idx].y)); };
+        const auto& [begin, end] = loop;
+        assert(end - begin >= 3);
+        std::size_t v_idx = begin;
+        for (std::size_t idx = begin + 1; idx < end; idx++)
+        {
+            const auto& p = points[idx];
+            const auto& v = points[v_idx];
+            if (p.y < v.y || (p.y == v.y && p.x < v.x)) { v_idx = idx; }
+        }
+        std::size_t a_idx = v_idx == begin ? end - 1 : v_idx - 1;
+        std::size_t b_idx = v_idx + 1 == end ? begin : v_idx + 1;
+        const double orientation = shapes::orient2d(point(a_idx), point(v_idx), point(b_idx));
+        if (orientation == 0.0)
+            return false;
+        if (orientation < 0.0) { std::swap(a_idx, b_idx); }
+        const auto a = point(a_idx);
+        const auto v = point(v_idx);
+        const auto b = point(b_idx);
+
+        // dist is zero on ab, and maximal at v
+        double max_dist = 0.0;
+        const auto test_vertex = [&](std::size_t idx) {
+            const auto p = point(idx);
+            if (idx == a_idx || idx == v_idx || idx == b_idx || p == v)
+                return;
+            const double dist = shapes::orient2d(b, a, p);
+            if (dist >= 0.0 && shapes::orient2d(a, v, p) >= 0.0 && shapes::orient2d(v, b, p) >= 0.0 && dist > max_dist) { max_dist = dist; }
+        };
+        for (std::size_t idx = begin; idx < end; idx++) { test_vertex(idx); }
+        shapes::BoundingBox2d<F> corner_bb;
+        corner_bb.add(points[a_idx]).add(points[v_idx]).add(points[b_idx]);
+        assert(other_loops.size() == other_bbs.size());
+        for (std::size_t loop_idx = 0; loop_idx < other_loops.size(); loop_idx++)
+        {
+            if (other_loops[loop_idx] == loop || !other_bbs[loop_idx].intersect(corner_bb))
+                continue;
+            for (std::size_t idx = other_loops[loop_idx].first; idx < other_loops[loop_idx].second; idx++) { test_vertex(idx); }
+        }
+
+        // a' = v + t (a - v) and b' = v + t (b - v), with 0 < t <= 1
+        const double v_dist = shapes::orient2d(b, a, v);
+        assert(v_dist > 0.0);
+        const double t = std::clamp(1.0 - max_dist / v_dist, std::numeric_limits<double>::epsilon(), 1.0);
+        seed = shapes::Point2d<double>(v.x + t * (a.x + b.x - 2.0 * v.x) / 3.0, v.y + t * (a.y + b.y - 2.0 * v.y) / 3.0);
+        return true;
+    }
+
 } // namespace triangle
 } // namespace details
 
 template <typename F, typename I>
-TriangleImpl<F, I>::TriangleImpl(const stdutils::io::ErrorHandler* err_handler)
+TriangleImpl<F, I>::TriangleImpl(const stdutils::io::ErrorHandler* err_handler, TriangleAlgorithm algorithm)
     : Interface<F,I>(err_handler)
-    , m_points()
+    , m_algorithm(algorithm)
     , m_polylines_indices()
     , m_polyline_is_closed()
+    , m_polyline_is_hole()
+    , m_edges()
 { }
 
 template <typename F, typename I>
-void TriangleImpl<F, I>::add_path(const shapes::PointPath2d<F>& pp)
+void TriangleImpl<F, I>::add_path_impl(Points vertices, bool closed)
 {
-    assert(shapes::is_valid(pp));
-    if (pp.closed && pp.vertices.size() < 3)
+    add_polyline(vertices, closed, false);
+}
+
+template <typename F, typename I>
+void TriangleImpl<F, I>::add_hole_impl(Points vertices, bool closed)
+{
+    add_polyline(vertices, closed, true);
+}
+
+template <typename F, typename I>
+void TriangleImpl<F, I>::add_polyline(Points vertices, bool closed, bool hole)
+{
+    if (closed && vertices.size() < 3)
     {
-        if (m_err_handler) { m_err_handler(stdutils::io::Severity::ERR, "add_path(): Ignoring a closed polyline with less than 3 vertices"); }
+        if (m_err_handler) { m_err_handler(stdutils::io::Severity::ERR, std::string(hole ? "add_hole()" : "add_path()") + ": Ignoring a closed polyline with less than 3 vertices"); }
         return;
     }
 
     const I begin_idx = static_cast<I>(m_points.size());
-    m_points.reserve(m_points.size() + pp.vertices.size());
-    m_points.insert(m_points.end(), pp.vertices.begin(), pp.vertices.end());
+    m_points.reserve(m_points.size() + vertices.size());
+    m_points.insert(m_points.end(), vertices.begin(), vertices.end());
     const I end_idx = static_cast<I>(m_points.size());
 
     m_polylines_indices.emplace_back(begin_idx, end_idx);
-    m_polyline_is_closed.emplace_back(pp.closed);
+    m_polyline_is_closed.emplace_back(closed);
+    m_polyline_is_hole.emplace_back(hole);
 }
 
 template <typename F, typename I>
-void TriangleImpl<F, I>::add_hole(const shapes::PointPath2d<F>& pp)
+void TriangleImpl<F, I>::add_steiner_impl(Points vertices)
 {
-    add_path(pp);
-    // TODO the Triangle library can handle holes
+    m_points.reserve(m_points.size() + vertices.size());
+    m_points.insert(m_points.end(), vertices.begin(), vertices.end());
 }
 
 template <typename F, typename I>
-void TriangleImpl<F, I>::add_steiner(const shapes::PointCloud2d<F>& pc)
+void TriangleImpl<F, I>::add_edges_impl(const shapes::Edges2d<F, I>& edges)
 {
-    m_points.reserve(m_points.size() + pc.vertices.size());
-    m_points.insert(m_points.end(), pc.vertices.begin(), pc.vertices.end());
+    const I offset = static_cast<I>(m_points.size());
+    m_points.reserve(m_points.size() + edges.vertices.size());
+    m_points.insert(m_points.end(), edges.vertices.begin(), edges.vertices.end());
+    m_edges.reserve(m_edges.size() + edges.indices.size());
+    for (const auto& e : edges.indices) { m_edges.emplace_back(static_cast<I>(offset + e.orig()), static_cast<I>(offset + e.dest())); }
 }
 
 template <typename F, typename I>
-void TriangleImpl<F, I>::triangulate_impl(TriangulationPolicy policy, shapes::Triangles2d<F, I>& result) const
+void TriangleImpl<F, I>::triangulate_impl(TriangulationPolicy policy, const CancellationToken* token, shapes::Triangles2d<F, I>& result) const
 {
     if (m_points.size() < 3)
     {
         if (m_err_handler) { m_err_handler(stdutils::io::Severity::WARN, "Not enough points to triangulate. The output will be empty."); }
         return;
     }
+    if (m_points.size() > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+    {
+        // The Triangle library indexes the vertices with an int
+        if (m_err_handler) { m_err_handler(stdutils::io::Severity::ERR, "Too many points for the vertex index of the Triangle library. The output will be empty."); }
+        return;
+    }
 
     struct triangulateio in, out;
     details::triangle::reset(in);
@@ -175,61 +299,163 @@ void TriangleImpl<F, I>::triangulate_impl(TriangulationPolicy policy, shapes::Tr
 
     // Q: Quiet. Suppresses all explanation of what Triangle is doing, unless an error occurs.
     // z: Index everything from zero
-    std::string options = "Qz";
+    // n: Output the list of neighbors of each triangle
+    std::string options = "Qzn";
+    switch (m_algorithm)
+    {
+        case TriangleAlgorithm::DivideAndConquer:
+            break;
+        case TriangleAlgorithm::Sweepline:
+            options.push_back('F');
+            break;
+        case TriangleAlgorithm::Incremental:
+            options.push_back('i');
+            break;
+        default:
+            assert(0);
+            break;
+    }
 
-    std::vector<details::triangle::Point<F>> vertices = details::triangle::copy_vertices(m_points);
-    assert(!vertices.empty());
-    in.numberofpoints = static_cast<int>(vertices.size());
-    in.pointlist = vertices[0].data();
+    stdutils::ArenaVector<REAL> coordinates(this->template arena_allocator<REAL>());
+    in.numberofpoints = static_cast<int>(m_points.size());
+    in.pointlist = details::triangle::point_list(m_points, coordinates);
 
-    std::vector<details::triangle::Edge> edges;
-    if (policy == TriangulationPolicy::CDT)
+    stdutils::ArenaVector<details::triangle::Edge> edges(this->template arena_allocator<details::triangle::Edge>());
     {
-        // p: PSLG (Planar Straight Line Graph) triangulate a point set with constrained edges
-        options.insert(options.begin(), 'p');
+        const PhaseTimer phase(*this, "Triangle::copy_edges");
+        if (policy == TriangulationPolicy::CDT)
+        {
+            // p: PSLG (Planar Straight Line Graph) triangulate a point set with constrained edges
+            options.insert(options.begin(), 'p');
+
+            assert(m_polylines_indices.size() == m_polyline_is_closed.size());
+            std::size_t polyline_idx = 0;
+            for (const auto& [begin, end] : m_polylines_indices)
+            {
+                assert(begin <= end);
+                edges.reserve(edges.size() + (end - begin));
+                for (I idx = begin; idx < (end - 1); idx++)
+                {
+                    edges.emplace_back(details::triangle::Edge{ static_cast<int>(idx), static_cast<int>(idx + 1) });
+                }
+                if (m_polyline_is_closed.at(polyline_idx++))
+                {
+                    assert(begin != (end-1));        // closed polylines with size < 3 are rejected in add_path/add_hole
+                    edges.emplace_back(details::triangle::Edge{ static_cast<int>(end - 1), static_cast<int>(begin) });
+                }
+            }
+            edges.reserve(edges.size() + m_edges.size());
+            for (const auto& [orig, dest] : m_edges) { edges.emplace_back(details::triangle::Edge{ static_cast<int>(orig), static_cast<int>(dest) }); }
+        }
+    }
+    in.numberofsegments = static_cast<int>(edges.size());
+    in.segmentlist = edges.empty() ? nullptr : edges[0].data();
 
-        assert(m_polylines_indices.size() == m_polyline_is_closed.size());
-        std::size_t polyline_idx = 0;
-        for (const auto& [begin, end] : m_polylines_indices)
+    // Triangle removes the triangles of a hole by eating them from a seed point, until it reaches the segments around it
+    stdutils::ArenaVector<REAL> hole_seeds(this->template arena_allocator<REAL>());
+    if (policy == TriangulationPolicy::CDT && std::find(m_polyline_is_hole.cbegin(), m_polyline_is_hole.cend(), true) != m_polyline_is_hole.cend())
+    {
+        const PhaseTimer phase(*this, "Triangle::hole_seeds");
+        std::vector<std::pair<std::size_t, std::size_t>> loops;
+        std::vector<shapes::BoundingBox2d<F>> loop_bbs;
+        for (std::size_t polyline_idx = 0; polyline_idx < m_polylines_indices.size(); polyline_idx++)
         {
-            assert(begin <= end);
-            edges.reserve(edges.size() + (end - begin));
-            for (I idx = begin; idx < (end - 1); idx++)
+            if (!m_polyline_is_closed[polyline_idx])
+                continue;
+            const auto& [begin, end] = m_polylines_indices[polyline_idx];
+            auto& bb = loop_bbs.emplace_back();
+            for (I idx = begin; idx < end; idx++) { bb.add(m_points[idx]); }
+            loops.emplace_back(static_cast<std::size_t>(begin), static_cast<std::size_t>(end));
+        }
+        for (std::size_t polyline_idx = 0; polyline_idx < m_polylines_indices.size(); polyline_idx++)
+        {
+            if (!m_polyline_is_hole[polyline_idx] || !m_polyline_is_closed[polyline_idx])
+                continue;
+            const auto& [begin, end] = m_polylines_indices[polyline_idx];
+            shapes::Point2d<double> seed;
+            if (details::triangle::hole_seed(m_points, std::make_pair(static_cast<std::size_t>(begin), static_cast<std::size_t>(end)), loops, loop_bbs, seed))
             {
-                edges.emplace_back(details::triangle::Edge{ static_cast<int>(idx), static_cast<int>(idx + 1) });
+                hole_seeds.push_back(seed.x);
+                hole_seeds.push_back(seed.y);
             }
-            if (m_polyline_is_closed.at(polyline_idx++))
+            else if (m_err_handler)
             {
-                assert(begin != (end-1));        // closed polylines with size < 3 are rejected in add_path/add_hole
-                edges.emplace_back(details::triangle::Edge{ static_cast<int>(end - 1), static_cast<int>(begin) });
+                m_err_handler(stdutils::io::Severity::WARN, "Triangle: Could not find a point inside a degenerate hole. The hole is not removed.");
             }
         }
     }
-    in.numberofsegments = static_cast<int>(edges.size());
-    in.segmentlist = edges.empty() ? nullptr : edges[0].data();
+    in.numberofholes = static_cast<int>(hole_seeds.size() / 2);
+    in.holelist = hole_seeds.empty() ? nullptr : hole_seeds.data();
 
-    // Triangulate
-    ::triangulate(options.data(), &in, &out, nullptr);
+    // Triangulate. The library cannot be interrupted: The token is only checked before and after the call.
+    {
+        std::lock_guard<std::mutex> lock(details::triangle::triangulate_mutex());
+        this->check_cancellation(token);
+        const PhaseTimer phase(*this, "Triangle::triangulate");
+        ::triangulate(options.data(), &in, &out, nullptr);
+    }
 
     // Copy result
-    result.vertices = m_points;
-    assert(out.numberoftriangles == 0 || out.trianglelist != nullptr);
-    assert(out.numberoftriangles >= 0);
-    result.faces.reserve(static_cast<std::size_t>(out.numberoftriangles));
-    for (auto idx = 0; idx < out.numberoftriangles; idx++)
     {
-        result.faces.emplace_back(
-            static_cast<I>(out.trianglelist[3 * idx + 0]),
-            static_cast<I>(out.trianglelist[3 * idx + 1]),
-            static_cast<I>(out.trianglelist[3 * idx + 2])
-        );
+        const PhaseTimer phase(*this, "Triangle::copy_faces");
+        assert(out.numberoftriangles == 0 || out.trianglelist != nullptr);
+        assert(out.numberoftriangles >= 0);
+        result.faces.reserve(static_cast<std::size_t>(out.numberoftriangles));
+        for (auto idx = 0; idx < out.numberoftriangles; idx++)
+        {
+            result.faces.emplace_back(
+                static_cast<I>(out.trianglelist[3 * idx + 0]),
+                static_cast<I>(out.trianglelist[3 * idx + 1]),
+                static_cast<I>(out.trianglelist[3 * idx + 2])
+            );
+        }
+        if (out.neighborlist != nullptr)
+        {
+            // Triangle's k-th neighbor is opposite to the k-th corner, that is across the edge (k+1, k+2)
+            result.adjacency.reserve(result.faces.size());
+            for (auto idx = 0; idx < out.numberoftriangles; idx++)
+            {
+                auto& adj = result.adjacency.emplace_back();
+                for (int k = 0; k < 3; k++)
+                {
+                    const int neighbor = out.neighborlist[3 * idx + k];
+                    adj[static_cast<std::size_t>((k + 1) % 3)] = neighbor < 0 ? graphs::IndexTraits<I>::undef() : static_cast<I>(neighbor);
+                }
+            }
+            assert(graphs::is_valid(result.adjacency, result.faces));
+        }
     }
 
     // Free resources allocated by the Triangle library
+    const PhaseTimer phase(*this, "Triangle::free_all");
     in.pointlist = nullptr;
     in.segmentlist = nullptr;
+    in.holelist = nullptr;
     details::triangle::free_all(in);
     details::triangle::free_all(out);
 }
 
+template <typename F, typename I>
+std::size_t TriangleImpl<F, I>::byte_size_impl() const noexcept
+{
+    return stdutils::memory::byte_size(m_polylines_indices) + stdutils::memory::byte_size(m_polyline_is_closed) + stdutils::memory::byte_size(m_polyline_is_hole) + stdutils::memory::byte_size(m_edges);
+}
+
+template <typename F, typename I>
+void TriangleImpl<F, I>::clear_impl() noexcept
+{
+    m_polylines_indices.clear();
+    m_polyline_is_closed.clear();
+    m_polyline_is_hole.clear();
+    m_edges.clear();
+}
+
+template <typename F, typename I>
+void TriangleImpl<F, I>::reserve_impl(std::size_t nb_constraints)
+{
+    m_polylines_indices.reserve(nb_constraints);
+    m_polyline_is_closed.reserve(nb_constraints);
+    m_polyline_is_hole.reserve(nb_constraints);
+}
+
 } // namespace delaunay
@@ -0,0 +1,204 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <graphs/graph.h>
+#include <graphs/index.h>
+#include <stdutils/parallel.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace graphs {
+
+/**
+ * Parallel compact indexing of large soups
+ *
+ * Reindex the vertices to interval [0, n-1], n being the number of vertices in use. Like compact_indexing() (see graph_algos.h), the order of
+ * the vertices is preserved, therefore the result does not depend on the number of threads.
+ *
+ * The indices in use are marked in a dense bitmap of range [min_index, max_index], one bit per index, then numbered with a prefix sum of the
+ * number of bits set in each word of the bitmap. The complexity is O(nb_elements + max_index - min_index), and every pass is parallel.
+ *
+ * If old_indices is not null, it is filled with the inverse permutation: old_indices[new_index] is the index of that vertex before the call,
+ * so that the vertex array can be compacted along with the indices.
+ *
+ * Return n, the number of vertices in use.
+ */
+template <typename I>
+std::size_t compact_indexing(const stdutils::parallel::Policy& policy, EdgeSoup<I>& edges, std::vector<I>* old_indices = nullptr);
+
+template <typename I>
+std::size_t compact_indexing(const stdutils::parallel::Policy& policy, TriangleSoup<I>& triangles, std::vector<I>* old_indices = nullptr);
+
+
+//
+//
+// Implementation
+//
+//
+
+
+namespace details {
+namespace compact_indexing {
+
+inline unsigned int popcount(std::uint64_t word) noexcept
+{
+    word = word - ((word >> 1) & 0x5555555555555555ull);
+    word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+    word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return static_cast<unsigned int>((word * 0x0101010101010101ull) >> 56);
+}
+
+// The indices in use in range [min_idx, max_idx], and the rank of each word: The new index of a vertex is the number of vertices in use
+// before it, that is the rank of its word plus the bits set before it in the word.
+template <typename I>
+class IndexBitmap
+{
+public:
+    static constexpr std::size_t word_bits = 64;
+
+    IndexBitmap(I min_idx, I max_idx)
+        : m_min_idx(min_idx)
+        , m_nb_words((static_cast<std::size_t>(max_idx - min_idx) / word_bits) + 1)
+        , m_words(std::make_unique<std::atomic<std::uint64_t>[]>(m_nb_words))
+        , m_ranks(m_nb_words, 0)
+    {
+        assert(min_idx <= max_idx);
+    }
+
+    std::size_t nb_words() const noexcept { return m_nb_words; }
+
+    // Thread-safe
+    void mark(I idx) noexcept
+    {
+        assert(m_min_idx <= idx);
+        const auto offset = static_cast<std::size_t>(idx - m_min_idx);
+        assert(offset / word_bits < m_nb_words);
+        m_words[offset / word_bits].fetch_or(std::uint64_t{1} << (offset % word_bits), std::memory_order_relaxed);
+    }
+
+    // Call after all the indices are marked. Return the number of indices in use.
+    std::size_t rank(const stdutils::parallel::Policy& policy)
+    {
+        std::vector<std::size_t> chunk_offsets(stdutils::parallel::nb_chunks(policy, m_nb_words) + 1, 0);
+        stdutils::parallel::for_each_chunk(policy, m_nb_words, [this, &chunk_offsets](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+            std::size_t count = 0;
+            for (std::size_t w = begin_idx; w < end_idx; w++) { count += popcount(m_words[w].load(std::memory_order_relaxed)); }
+            chunk_offsets[chunk_idx + 1] = count;
+        });
+        for (std::size_t idx = 1; idx < chunk_offsets.size(); idx++) { chunk_offsets[idx] += chunk_offsets[idx - 1]; }
+        assert(chunk_offsets.back() <= static_cast<std::size_t>(IndexTraits<I>::max_valid_index()) + 1);
+        stdutils::parallel::for_each_chunk(policy, m_nb_words, [this, &chunk_offsets](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+            std::size_t rank = chunk_offsets[chunk_idx];
+            for (std::size_t w = begin_idx; w < end_idx; w++)
+            {
+                m_ranks[w] = static_cast<I>(rank);
+                rank += popcount(m_words[w].load(std::memory_order_relaxed));
+            }
+            assert(rank == chunk_offsets[chunk_idx + 1]);
+        });
+        return chunk_offsets.back();
+    }
+
+    // Call rank() first. The index must be in use.
+    I operator[](I idx) const noexcept
+    {
+        assert(m_min_idx <= idx);
+        const auto offset = static_cast<std::size_t>(idx - m_min_idx);
+        const auto word = m_words[offset / word_bits].load(std::memory_order_relaxed);
+        const auto bit = offset % word_bits;
+        assert(word & (std::uint64_t{1} << bit));
+        const auto below_mask = (std::uint64_t{1} << bit) - 1u;
+        return static_cast<I>(m_ranks[offset / word_bits] + static_cast<I>(popcount(word & below_mask)));
+    }
+
+    // Call rank() first. old_indices[new_idx] = idx for each index in use.
+    void inverse(const stdutils::parallel::Policy& policy, std::vector<I>& old_indices, std::size_t nb_indices) const
+    {
+        old_indices.resize(nb_indices);
+        stdutils::parallel::for_each_chunk(policy, m_nb_words, [this, &old_indices](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+            for (std::size_t w = begin_idx; w < end_idx; w++)
+            {
+                auto word = m_words[w].load(std::memory_order_relaxed);
+                auto new_idx = static_cast<std::size_t>(m_ranks[w]);
+                for (std::size_t bit = 0; word != 0; bit++, word >>= 1)
+                {
+                    if (word & 1u) { old_indices[new_idx++] = static_cast<I>(m_min_idx + static_cast<I>(w * word_bits + bit)); }
+                }
+            }
+        });
+    }
+
+private:
+    I m_min_idx;
+    std::size_t m_nb_words;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> m_words;
+    std::vector<I> m_ranks;
+};
+
+// Elt is an edge or a triangle, with N vertex indices
+template <std::uint8_t N, typename I, typename Elt>
+std::size_t compact_indexing(const stdutils::parallel::Policy& policy, std::vector<Elt>& elements, std::vector<I>* old_indices)
+{
+    if (old_indices) { old_indices->clear(); }
+    if (elements.empty())
+        return 0;
+
+    // Range of the indices
+    std::vector<std::pair<I, I>> chunk_minmax(stdutils::parallel::nb_chunks(policy, elements.size()), std::make_pair(elements.front()[0], elements.front()[0]));
+    stdutils::parallel::for_each_chunk(policy, elements.size(), [&elements, &chunk_minmax](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+        auto& minmax = chunk_minmax[chunk_idx];
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++)
+            for (std::uint8_t k = 0; k < N; k++)
+            {
+                minmax.first = std::min(minmax.first, elements[idx][k]);
+                minmax.second = std::max(minmax.second, elements[idx][k]);
+            }
+    });
+    std::pair<I, I> minmax = chunk_minmax.front();
+    for (const auto& [min_idx, max_idx] : chunk_minmax)
+    {
+        minmax.first = std::min(minmax.first, min_idx);
+        minmax.second = std::max(minmax.second, max_idx);
+    }
+
+    // Mark, rank, then remap
+    IndexBitmap<I> bitmap(minmax.first, minmax.second);
+    stdutils::parallel::for_each_chunk(policy, elements.size(), [&elements, &bitmap](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++)
+            for (std::uint8_t k = 0; k < N; k++)
+                bitmap.mark(elements[idx][k]);
+    });
+    const std::size_t nb_indices = bitmap.rank(policy);
+    stdutils::parallel::for_each_chunk(policy, elements.size(), [&elements, &bitmap](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++)
+            for (std::uint8_t k = 0; k < N; k++)
+                elements[idx][k] = bitmap[elements[idx][k]];
+    });
+    if (old_indices) { bitmap.inverse(policy, *old_indices, nb_indices); }
+    return nb_indices;
+}
+
+} // namespace compact_indexing
+} // namespace details
+
+template <typename I>
+std::size_t compact_indexing(const stdutils::parallel::Policy& policy, EdgeSoup<I>& edges, std::vector<I>* old_indices)
+{
+    return details::compact_indexing::compact_indexing<2, I>(policy, edges, old_indices);
+}
+
+template <typename I>
+std::size_t compact_indexing(const stdutils::parallel::Policy& policy, TriangleSoup<I>& triangles, std::vector<I>* old_indices)
+{
+    return details::compact_indexing::compact_indexing<3, I>(policy, triangles, old_indices);
+}
+
+} // namespace graphs
@@ -0,0 +1,181 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <graphs/csr_graph.h>
+#include <graphs/graph.h>
+#include <graphs/index.h>
+#include <graphs/union_find.h>
+#include <stdutils/parallel.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace graphs {
+
+/**
+ * Connected components of a graph
+ *
+ * The vertices are indexed in range [0, labels.size()), labels.size() being one more than the largest index of the input. Each vertex
+ * that belongs to an edge or a triangle is labelled with its component, in range [0, nb_components). The components are numbered in
+ * the order of their smallest vertex, therefore the labels do not depend on the number of threads. The other indices are labelled undef.
+ *
+ * The edges are merged concurrently in a lock-free union-find (see ConcurrentUnionFind), chunk by chunk, then the labels are assigned
+ * in parallel, with a prefix sum of the number of components found in each chunk.
+ */
+template <typename I = std::uint32_t>
+struct Components
+{
+    std::vector<I> labels;
+    std::size_t nb_components{0};
+};
+
+template <typename I>
+Components<I> connected_components(const stdutils::parallel::Policy& policy, const EdgeSoup<I>& edges);
+
+template <typename I>
+Components<I> connected_components(const stdutils::parallel::Policy& policy, const TriangleSoup<I>& triangles);
+
+template <typename I>
+Components<I> connected_components(const stdutils::parallel::Policy& policy, const CsrGraph<I>& graph);
+
+// Number of vertices in each component
+template <typename I>
+std::vector<std::size_t> component_sizes(const Components<I>& components);
+
+
+//
+//
+// Implementation
+//
+//
+
+
+namespace details {
+namespace components {
+
+// The union-find links each root below the other root if it has a lower index, therefore the root of a component is its smallest vertex
+template <typename I, typename IsUsed>
+Components<I> label(const stdutils::parallel::Policy& policy, ConcurrentUnionFind<I>& union_find, IsUsed is_used)
+{
+    Components<I> result;
+    const std::size_t n = static_cast<std::size_t>(union_find.size());
+    result.labels.resize(n, IndexTraits<I>::undef());
+    std::vector<I> roots(n);
+    std::vector<std::size_t> chunk_offsets(stdutils::parallel::nb_chunks(policy, n) + 1, 0);
+    stdutils::parallel::for_each_chunk(policy, n, [&](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+        std::size_t count = 0;
+        for (std::size_t v = begin_idx; v < end_idx; v++)
+        {
+            if (!is_used(v)) { continue; }
+            roots[v] = union_find.find(static_cast<I>(v));
+            if (roots[v] == static_cast<I>(v)) { count++; }
+        }
+        chunk_offsets[chunk_idx + 1] = count;
+    });
+    for (std::size_t idx = 1; idx < chunk_offsets.size(); idx++) { chunk_offsets[idx] += chunk_offsets[idx - 1]; }
+    result.nb_components = chunk_offsets.back();
+    assert(result.nb_components <= IndexTraits<I>::max_valid_index());
+    stdutils::parallel::for_each_chunk(policy, n, [&](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+        std::size_t next_label = chunk_offsets[chunk_idx];
+        for (std::size_t v = begin_idx; v < end_idx; v++)
+        {
+            if (is_used(v) && roots[v] == static_cast<I>(v)) { result.labels[v] = static_cast<I>(next_label++); }
+        }
+        assert(next_label == chunk_offsets[chunk_idx + 1]);
+    });
+    stdutils::parallel::for_each_chunk(policy, n, [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t v = begin_idx; v < end_idx; v++)
+        {
+            if (is_used(v) && roots[v] != static_cast<I>(v)) { result.labels[v] = result.labels[static_cast<std::size_t>(roots[v])]; }
+        }
+    });
+    return result;
+}
+
+} // namespace components
+} // namespace details
+
+template <typename I>
+Components<I> connected_components(const stdutils::parallel::Policy& policy, const EdgeSoup<I>& edges)
+{
+    if (edges.empty())
+        return Components<I>();
+    I max_index = 0;
+    for (const auto& e : edges) { max_index = std::max({ max_index, e.orig(), e.dest() }); }
+    assert(max_index < IndexTraits<I>::max_valid_index());
+    const std::size_t n = static_cast<std::size_t>(max_index) + 1;
+    ConcurrentUnionFind<I> union_find(static_cast<I>(n));
+    const auto used = std::make_unique<std::atomic<bool>[]>(n);
+    stdutils::parallel::for_each_chunk(policy, edges.size(), [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++)
+        {
+            const auto& e = edges[idx];
+            used[static_cast<std::size_t>(e.orig())].store(true, std::memory_order_relaxed);
+            used[static_cast<std::size_t>(e.dest())].store(true, std::memory_order_relaxed);
+            union_find.subset_union(e.orig(), e.dest());
+        }
+    });
+    return details::components::label(policy, union_find, [&used](std::size_t v) { return used[v].load(std::memory_order_relaxed); });
+}
+
+template <typename I>
+Components<I> connected_components(const stdutils::parallel::Policy& policy, const TriangleSoup<I>& triangles)
+{
+    if (triangles.empty())
+        return Components<I>();
+    I max_index = 0;
+    for (const auto& t : triangles) { max_index = std::max({ max_index, t[0], t[1], t[2] }); }
+    assert(max_index < IndexTraits<I>::max_valid_index());
+    const std::size_t n = static_cast<std::size_t>(max_index) + 1;
+    ConcurrentUnionFind<I> union_find(static_cast<I>(n));
+    const auto used = std::make_unique<std::atomic<bool>[]>(n);
+    stdutils::parallel::for_each_chunk(policy, triangles.size(), [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++)
+        {
+            const auto& t = triangles[idx];
+            for (std::size_t k = 0; k < 3; k++) { used[static_cast<std::size_t>(t[k])].store(true, std::memory_order_relaxed); }
+            union_find.subset_union(t[0], t[1]);
+            union_find.subset_union(t[0], t[2]);
+        }
+    });
+    return details::components::label(policy, union_find, [&used](std::size_t v) { return used[v].load(std::memory_order_relaxed); });
+}
+
+template <typename I>
+Components<I> connected_components(const stdutils::parallel::Policy& policy, const CsrGraph<I>& graph)
+{
+    const std::size_t n = graph.nb_vertices();
+    if (n == 0)
+        return Components<I>();
+    assert(n <= IndexTraits<I>::max_valid_index());
+    ConcurrentUnionFind<I> union_find(static_cast<I>(n));
+    stdutils::parallel::for_each_chunk(policy, n, [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t v = begin_idx; v < end_idx; v++)
+        {
+            // Each edge is visited from both of its vertices: Only merge it once
+            graph.for_each_neighbor(static_cast<I>(v), [&union_find, v](I w) {
+                if (static_cast<std::size_t>(w) > v) { union_find.subset_union(static_cast<I>(v), w); }
+            });
+        }
+    });
+    return details::components::label(policy, union_find, [&graph](std::size_t v) { return graph.degree(static_cast<I>(v)) > 0; });
+}
+
+template <typename I>
+std::vector<std::size_t> component_sizes(const Components<I>& components)
+{
+    std::vector<std::size_t> result(components.nb_components, 0);
+    for (const I label : components.labels)
+    {
+        if (is_defined(label)) { result[static_cast<std::size_t>(label)]++; }
+    }
+    return result;
+}
+
+} // namespace graphs
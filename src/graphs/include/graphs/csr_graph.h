@@ -0,0 +1,175 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <graphs/graph.h>
+#include <graphs/index.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace graphs {
+
+/**
+ * Compressed sparse row (CSR) adjacency of an undirected graph
+ *
+ * The half-edges out of vertex v are stored contiguously, in range [first_half_edge(v), first_half_edge(v) + degree(v)). The graph is built
+ * in O(V + E) with a counting pass, and its memory is proportional to the number of edges, whatever the degree of the vertices.
+ *
+ * The vertices are indexed in range [0, nb_vertices()), nb_vertices() being one more than the largest index. The indices that are not part
+ * of any edge are vertices of degree 0.
+ */
+template <typename I = std::uint32_t>
+class CsrGraph
+{
+public:
+    using index = I;
+
+    CsrGraph() = default;
+
+    // Each edge is represented by two half-edges, whose edge index is the position of the edge in the soup. The loop edges are ignored.
+    explicit CsrGraph(const EdgeSoup<I>& edges);
+
+    // The unique edges of the triangles. The neighbors of each vertex are sorted. There are no edge indices.
+    explicit CsrGraph(const TriangleSoup<I>& triangles);
+
+    std::size_t nb_vertices() const noexcept { return m_offsets.empty() ? 0 : m_offsets.size() - 1; }
+    std::size_t nb_half_edges() const noexcept { return m_neighbors.size(); }
+    std::size_t degree(I v) const noexcept;
+
+    std::size_t first_half_edge(I v) const noexcept;
+    I neighbor(std::size_t half_edge) const noexcept { assert(half_edge < m_neighbors.size()); return m_neighbors[half_edge]; }
+    bool has_edge_indices() const noexcept { return m_edge_indices.size() == m_neighbors.size(); }
+    std::size_t edge_index(std::size_t half_edge) const noexcept { assert(has_edge_indices()); return m_edge_indices[half_edge]; }
+
+    template <typename Func>
+    void for_each_neighbor(I v, Func func) const;
+
+private:
+    // Allocate the offsets of the vertices, given their degree in m_offsets[v + 1]
+    void init_offsets();
+
+    std::vector<std::size_t> m_offsets;
+    std::vector<I> m_neighbors;
+    std::vector<std::size_t> m_edge_indices;
+};
+
+
+//
+//
+// Implementation
+//
+//
+
+
+template <typename I>
+CsrGraph<I>::CsrGraph(const EdgeSoup<I>& edges)
+    : m_offsets()
+    , m_neighbors()
+    , m_edge_indices()
+{
+    if (edges.empty())
+        return;
+    I max_index = 0;
+    for (const auto& e : edges) { max_index = std::max({ max_index, e.orig(), e.dest() }); }
+    assert(max_index <= IndexTraits<I>::max_valid_index());
+    m_offsets.resize(static_cast<std::size_t>(max_index) + 2, 0);
+    for (const auto& e : edges)
+    {
+        if (is_loop(e)) { assert(0); continue; }
+        m_offsets[static_cast<std::size_t>(e.orig()) + 1]++;
+        m_offsets[static_cast<std::size_t>(e.dest()) + 1]++;
+    }
+    init_offsets();
+    m_neighbors.resize(m_offsets.back());
+    m_edge_indices.resize(m_offsets.back());
+    std::vector<std::size_t> cursor(m_offsets.cbegin(), m_offsets.cend() - 1);
+    for (std::size_t edge_idx = 0; edge_idx < edges.size(); edge_idx++)
+    {
+        const auto& e = edges[edge_idx];
+        if (is_loop(e)) { continue; }
+        const std::size_t orig_half_edge = cursor[static_cast<std::size_t>(e.orig())]++;
+        const std::size_t dest_half_edge = cursor[static_cast<std::size_t>(e.dest())]++;
+        m_neighbors[orig_half_edge] = e.dest();
+        m_neighbors[dest_half_edge] = e.orig();
+        m_edge_indices[orig_half_edge] = edge_idx;
+        m_edge_indices[dest_half_edge] = edge_idx;
+    }
+}
+
+template <typename I>
+CsrGraph<I>::CsrGraph(const TriangleSoup<I>& triangles)
+    : m_offsets()
+    , m_neighbors()
+    , m_edge_indices()
+{
+    if (triangles.empty())
+        return;
+    I max_index = 0;
+    for (const auto& t : triangles) { max_index = std::max({ max_index, t[0], t[1], t[2] }); }
+    assert(max_index <= IndexTraits<I>::max_valid_index());
+
+    // The inner edges are shared by two triangles, therefore the duplicated neighbors are removed in a second pass
+    m_offsets.resize(static_cast<std::size_t>(max_index) + 2, 0);
+    for (const auto& t : triangles)
+        for (std::size_t k = 0; k < 3; k++)
+            m_offsets[static_cast<std::size_t>(t[k]) + 1] += 2;
+    init_offsets();
+    m_neighbors.resize(m_offsets.back());
+    std::vector<std::size_t> cursor(m_offsets.cbegin(), m_offsets.cend() - 1);
+    for (const auto& t : triangles)
+    {
+        for (const auto& e : t.edges())
+        {
+            m_neighbors[cursor[static_cast<std::size_t>(e.orig())]++] = e.dest();
+            m_neighbors[cursor[static_cast<std::size_t>(e.dest())]++] = e.orig();
+        }
+    }
+    std::size_t out_idx = 0;
+    for (std::size_t v = 0; v + 1 < m_offsets.size(); v++)
+    {
+        const auto begin = m_neighbors.begin() + static_cast<std::ptrdiff_t>(m_offsets[v]);
+        const auto end = m_neighbors.begin() + static_cast<std::ptrdiff_t>(m_offsets[v + 1]);
+        std::sort(begin, end);
+        const auto unique_end = std::unique(begin, end);
+        m_offsets[v] = out_idx;
+        out_idx = static_cast<std::size_t>(std::copy(begin, unique_end, m_neighbors.begin() + static_cast<std::ptrdiff_t>(out_idx)) - m_neighbors.begin());
+    }
+    m_offsets.back() = out_idx;
+    m_neighbors.resize(out_idx);
+    m_neighbors.shrink_to_fit();
+}
+
+template <typename I>
+void CsrGraph<I>::init_offsets()
+{
+    for (std::size_t idx = 1; idx < m_offsets.size(); idx++) { m_offsets[idx] += m_offsets[idx - 1]; }
+}
+
+template <typename I>
+std::size_t CsrGraph<I>::degree(I v) const noexcept
+{
+    const auto v_idx = static_cast<std::size_t>(v);
+    return v_idx < nb_vertices() ? m_offsets[v_idx + 1] - m_offsets[v_idx] : 0;
+}
+
+template <typename I>
+std::size_t CsrGraph<I>::first_half_edge(I v) const noexcept
+{
+    assert(static_cast<std::size_t>(v) < nb_vertices());
+    return m_offsets[static_cast<std::size_t>(v)];
+}
+
+template <typename I>
+template <typename Func>
+void CsrGraph<I>::for_each_neighbor(I v, Func func) const
+{
+    const auto v_idx = static_cast<std::size_t>(v);
+    assert(v_idx < nb_vertices());
+    for (std::size_t half_edge = m_offsets[v_idx]; half_edge < m_offsets[v_idx + 1]; half_edge++) { func(m_neighbors[half_edge]); }
+}
+
+} // namespace graphs
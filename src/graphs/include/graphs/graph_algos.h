@@ -2,9 +2,9 @@
 // This code is distributed under the terms of the MIT License
 #pragma once
 
+#include <graphs/csr_graph.h>
 #include <graphs/graph.h>
 #include <stdutils/algorithm.h>
-#include <stdutils/macros.h>
 
 #include <algorithm>
 #include <cassert>
@@ -73,7 +73,7 @@ std::pair<I, I> minmax_indices(const Path<I>& path);
 template <typename I>
 std::pair<I, I> minmax_indices(const TriangleSoup<I>& triangles);
 
-// Reindex to interval [0; n-1]. Preserve vertex order
+// Reindex to interval [0; n-1]. Preserve vertex order. See also the parallel version in compact_indexing.h
 template <typename InputIt>
 void compact_indexing(InputIt index_begin, InputIt index_end);
 template <typename I>
@@ -104,6 +104,14 @@ using MinMaxDeg = std::pair<std::size_t, std::size_t>;
 template <typename I>
 MinMaxDeg minmax_degree(const EdgeSoup<I>& edges);
 
+// Same, for the vertices of degree > 0 of a graph already built
+template <typename I>
+std::size_t min_degree(const CsrGraph<I>& graph);
+template <typename I>
+std::size_t max_degree(const CsrGraph<I>& graph);
+template <typename I>
+MinMaxDeg minmax_degree(const CsrGraph<I>& graph);
+
 // Extract paths from EdgeSoup
 //
 // Notes:
@@ -122,11 +130,100 @@ std::vector<Path<I>> extract_paths(const EdgeSoup<I>& edges);
 //
 
 
+namespace details {
+
+    // The algorithms below rely on sorted vectors rather than on std::set, which is allocation-heavy and cache unfriendly for large graphs
+
+    template <typename I>
+    EdgeSoup<I> sorted_ordered_edges(const EdgeSoup<I>& edges)
+    {
+        EdgeSoup<I> result;
+        result.reserve(edges.size());
+        std::transform(edges.cbegin(), edges.cend(), std::back_inserter(result), [](const auto& e) { return Edge<I>(std::minmax(e[0], e[1])); });
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    // Sorted list of the unique edges of a triangle soup, as ordered edges
+    template <typename I>
+    EdgeSoup<I> sorted_unique_edges(const TriangleSoup<I>& triangles)
+    {
+        EdgeSoup<I> result;
+        result.reserve(3 * triangles.size());
+        for (const auto& t : triangles)
+            for (const auto& e : t.edges())
+                result.emplace_back(std::minmax(e[0], e[1]));
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+    template <typename I>
+    void sort_unique(std::vector<I>& vertices)
+    {
+        std::sort(vertices.begin(), vertices.end());
+        vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+    }
+
+    template <typename I>
+    std::vector<I> sorted_unique_vertices(const EdgeSoup<I>& edges)
+    {
+        std::vector<I> result;
+        result.reserve(2 * edges.size());
+        for (const auto& e : edges) { result.push_back(e[0]); result.push_back(e[1]); }
+        sort_unique(result);
+        return result;
+    }
+
+    template <typename I>
+    std::vector<I> sorted_unique_vertices(const Path<I>& path)
+    {
+        std::vector<I> result = path.vertices;
+        sort_unique(result);
+        return result;
+    }
+
+    template <typename I>
+    std::vector<I> sorted_unique_vertices(const TriangleSoup<I>& triangles)
+    {
+        std::vector<I> result;
+        result.reserve(3 * triangles.size());
+        for (const auto& t : triangles) { result.push_back(t[0]); result.push_back(t[1]); result.push_back(t[2]); }
+        sort_unique(result);
+        return result;
+    }
+
+    // Erase the edges that are a duplicate of a previous edge in the list, regardless of their orientation. Preserve the order of the edges.
+    // If remove_loops is true, also erase the loop edges.
+    template <typename I>
+    void erase_duplicated_edges(EdgeSoup<I>& edges, bool remove_loops)
+    {
+        std::vector<std::pair<Edge<I>, std::size_t>> indexed_edges;
+        indexed_edges.reserve(edges.size());
+        for (std::size_t idx = 0; idx < edges.size(); idx++) { indexed_edges.emplace_back(Edge<I>(std::minmax(edges[idx][0], edges[idx][1])), idx); }
+        std::sort(indexed_edges.begin(), indexed_edges.end());
+        std::vector<bool> keep(edges.size(), false);
+        for (std::size_t idx = 0; idx < indexed_edges.size(); idx++)
+        {
+            const auto& [e, e_idx] = indexed_edges[idx];
+            const bool first_occurrence = (idx == 0 || indexed_edges[idx - 1].first != e);
+            keep[e_idx] = first_occurrence && !(remove_loops && is_loop(e));
+        }
+        std::size_t out_idx = 0;
+        for (std::size_t idx = 0; idx < edges.size(); idx++)
+        {
+            if (keep[idx]) { edges[out_idx++] = edges[idx]; }
+        }
+        edges.erase(edges.begin() + static_cast<std::ptrdiff_t>(out_idx), edges.end());
+    }
+
+} // namespace details
+
 template <typename I>
 bool has_duplicated_edges(const EdgeSoup<I>& edges)
 {
-    std::set<Edge<I>> ordered_edges;
-    return std::any_of(edges.cbegin(), edges.cend(), [&ordered_edges](const auto& e) { return !ordered_edges.insert(ordered_edge(e)).second; });
+    const auto sorted_edges = details::sorted_ordered_edges(edges);
+    return std::adjacent_find(sorted_edges.cbegin(), sorted_edges.cend()) != sorted_edges.cend();
 }
 
 template <typename I>
@@ -170,8 +267,9 @@ template <typename I>
 bool is_simple(const Path<I>& path)
 {
     assert(is_valid(path));
-    std::set<I> unique_vertices;
-    return std::all_of(path.vertices.cbegin(), path.vertices.cend(), [&unique_vertices](const auto& p) { return unique_vertices.insert(p).second; });
+    std::vector<I> sorted_vertices = path.vertices;
+    std::sort(sorted_vertices.begin(), sorted_vertices.end());
+    return std::adjacent_find(sorted_vertices.cbegin(), sorted_vertices.cend()) == sorted_vertices.cend();
 }
 
 template <typename I>
@@ -189,12 +287,7 @@ constexpr void flip_orientation(Triangle<I>& t)
 template <typename I>
 void filter_out_duplicates(EdgeSoup<I>& edges)
 {
-    std::set<Edge<I>> ordered_edges;
-    stdutils::erase_if(edges, [&ordered_edges](const Edge<I>& e) {
-        const bool inserted = ordered_edges.insert(ordered_edge(e)).second;
-        return !inserted;
-    });
-    assert(edges.size() == ordered_edges.size());
+    details::erase_duplicated_edges(edges, false);
     assert(!has_duplicated_edges(edges));
 }
 
@@ -208,30 +301,29 @@ void filter_out_loops(EdgeSoup<I>& edges)
 template <typename I>
 void filter_out_duplicates_and_loops(EdgeSoup<I>& edges)
 {
-    std::set<Edge<I>> ordered_edges;
-    stdutils::erase_if(edges, [&ordered_edges](const Edge<I>& e) {
-        return is_loop(e) || !ordered_edges.insert(ordered_edge(e)).second;
-    });
-    assert(edges.size() == ordered_edges.size());
+    details::erase_duplicated_edges(edges, true);
     assert(is_valid(edges));
 }
 
 template <typename I>
 std::size_t nb_vertices(const EdgeSoup<I>& edges)
 {
-    return to_vertex_set(edges).size();
+    assert(is_valid(edges));
+    return details::sorted_unique_vertices(edges).size();
 }
 
 template <typename I>
 std::size_t nb_vertices(const Path<I>& path)
 {
-    return to_vertex_set(path).size();
+    assert(is_valid(path));
+    return details::sorted_unique_vertices(path).size();
 }
 
 template <typename I>
 std::size_t nb_vertices(const TriangleSoup<I>& triangles)
 {
-    return to_vertex_set(triangles).size();
+    assert(is_valid(triangles));
+    return details::sorted_unique_vertices(triangles).size();
 }
 
 template <typename I>
@@ -253,11 +345,7 @@ template <typename I>
 std::size_t nb_edges(const TriangleSoup<I>& triangles)
 {
     assert(is_valid(triangles));
-    std::set<Edge<I>> ordered_edges;
-    for (const auto& t : triangles)
-        for (const auto& e : t.edges())
-            ordered_edges.insert(ordered_edge(e));
-    return ordered_edges.size();
+    return details::sorted_unique_edges(triangles).size();
 }
 
 template <typename I>
@@ -288,13 +376,12 @@ template <typename I>
 std::pair<I, I> minmax_indices(const TriangleSoup<I>& triangles)
 {
     assert(!triangles.empty());
-    auto it_triangle = std::cbegin(triangles);
-    std::pair<I, I> result(*it_triangle[0], *it_triangle[0]);
-    while(++it_triangle != std::cend(triangles))
+    std::pair<I, I> result(triangles.front()[0], triangles.front()[0]);
+    for (const auto& t : triangles)
     {
-        stdutils::minmax_update(result, *it_triangle[0]);
-        stdutils::minmax_update(result, *it_triangle[1]);
-        stdutils::minmax_update(result, *it_triangle[2]);
+        stdutils::minmax_update(result, t[0]);
+        stdutils::minmax_update(result, t[1]);
+        stdutils::minmax_update(result, t[2]);
     }
     return result;
 }
@@ -417,37 +504,24 @@ template <typename I>
 VertexSet<I> to_vertex_set(const EdgeSoup<I>& edges)
 {
     assert(is_valid(edges));
-    VertexSet<I> result;
-    for (const auto& e : edges)
-    {
-        result.insert(e[0]);
-        result.insert(e[1]);
-    }
-    return result;
+    const auto vertices = details::sorted_unique_vertices(edges);
+    return VertexSet<I>(vertices.cbegin(), vertices.cend());
 }
 
 template <typename I>
 VertexSet<I> to_vertex_set(const Path<I>& path)
 {
     assert(is_valid(path));
-    VertexSet<I> result;
-    for (const auto& v : path.vertices)
-        result.insert(v);
-    return result;
+    const auto vertices = details::sorted_unique_vertices(path);
+    return VertexSet<I>(vertices.cbegin(), vertices.cend());
 }
 
 template <typename I>
 VertexSet<I> to_vertex_set(const TriangleSoup<I>& triangles)
 {
     assert(is_valid(triangles));
-    VertexSet<I> result;
-    for (const auto& t : triangles)
-    {
-        result.insert(t[0]);
-        result.insert(t[1]);
-        result.insert(t[2]);
-    }
-    return result;
+    const auto vertices = details::sorted_unique_vertices(triangles);
+    return VertexSet<I>(vertices.cbegin(), vertices.cend());
 }
 
 template <typename I>
@@ -471,169 +545,91 @@ template <typename I>
 EdgeSoup<I> to_edge_soup(const TriangleSoup<I>& triangles)
 {
     assert(is_valid(triangles));
-    std::set<Edge<I>> ordered_edges;
-    for (const auto& t : triangles)
-        for (const auto& e : t.edges())
-            ordered_edges.insert(ordered_edge(e));
-    auto result = EdgeSoup<I>(ordered_edges.cbegin(), ordered_edges.cend());
+    auto result = details::sorted_unique_edges(triangles);
     assert(is_valid(result));
     return result;
 }
 
 namespace details {
 
-    // Return a vector of pairs <I index, std::size_t vertex_degree>
+    // Degree of each vertex in range [min_idx, max_idx] of the edge soup, in a single counting pass
     template <typename I>
-    std::vector<std::pair<I, std::size_t>> vertex_degree(const EdgeSoup<I>& edges)
+    std::vector<std::size_t> vertex_degrees(const EdgeSoup<I>& edges)
     {
         assert(is_valid(edges));
         const auto [min_idx, max_idx] = minmax_indices<I>(edges);
-        const auto init_pair = std::make_pair<I, std::size_t>(0, 0);
         assert(min_idx != IndexTraits<I>::undef());
         assert(max_idx != IndexTraits<I>::undef());
         assert(min_idx <= max_idx);
-        std::vector<std::pair<I, std::size_t>> result(static_cast<std::size_t>(1u + max_idx - min_idx), init_pair);
-        I idx = static_cast<I>(min_idx);
-        std::for_each(result.begin(), result.end(), [&idx](auto& pair) { pair.first = idx++; });
+        std::vector<std::size_t> result(static_cast<std::size_t>(1u + max_idx - min_idx), 0);
         for (const auto& e : edges)
         {
-            result[e.orig() - min_idx].second++;
-            result[e.dest() - min_idx].second++;
+            result[e.orig() - min_idx]++;
+            result[e.dest() - min_idx]++;
         }
-        stdutils::erase_if(result, [](const auto& pair) { return pair.second == 0; });
         return result;
     }
 
-    template <typename I>
-    std::size_t nb_edges(const std::vector<Path<I>>& paths)
+    // Min and max of a range of degrees, excluding the zeros
+    template <typename DegreeFunc>
+    MinMaxDeg minmax_nonzero_degree(std::size_t nb_vertices, DegreeFunc degree)
     {
-        return std::accumulate(paths.cbegin(), paths.cend(), std::size_t(0), [](const std::size_t n, const Path<I>& p) -> std::size_t { return n + nb_edges(p); });
+        MinMaxDeg result(std::numeric_limits<std::size_t>::max(), 0);
+        for (std::size_t idx = 0; idx < nb_vertices; idx++)
+        {
+            const std::size_t deg = degree(idx);
+            if (deg == 0) { continue; }
+            result.first = std::min(result.first, deg);
+            result.second = std::max(result.second, deg);
+        }
+        if (result.second == 0) { result.first = 0; }
+        return result;
     }
 
     template <typename I>
-    class AdjList
+    std::size_t nb_edges(const std::vector<Path<I>>& paths)
     {
-    public:
-        static constexpr I Undef = IndexTraits<I>::undef();
-
-        // If the degree of the graph is elready known, pass it as a parameter. Else leave the default value and it will be computed.
-        AdjList(const EdgeSoup<I>& edges, std::size_t max_deg = 0u)
-            : m_adj()
-            , m_min_idx(0)
-            , m_max_idx(0)
-            , m_max_deg(max_deg)
-        {
-            assert(is_valid(edges));
-            assert(!edges.empty());
-            std::tie(m_min_idx, m_max_idx) = minmax_indices(edges);
-            assert(m_max_idx <= IndexTraits<I>::max_valid_index());
-            const std::size_t sz = 1u + m_max_idx - m_min_idx;
-            if (m_max_deg == 0u) { m_max_deg = max_degree(edges); }
-            assert(m_max_deg != 0u);
-            m_adj.resize(sz * m_max_deg, Undef);
-            m_visited.resize(sz);
-            const auto init_half_edge = [this](I from, I to) {
-                assert(m_min_idx <= from && from <= m_max_idx);
-                const auto from_rel_idx = static_cast<std::size_t>(from) - m_min_idx;
-                assert(m_visited[from_rel_idx].m_unvisited < m_max_deg);
-                m_adj[m_max_deg * from_rel_idx + m_visited[from_rel_idx].m_unvisited++] = to;
-            };
-            for (const auto& e : edges)
-            {
-                if (e[0] == e[1]) { assert(0); continue; }
-                init_half_edge(e[0], e[1]);
-                init_half_edge(e[1], e[0]);
-            }
-            for (auto& vis: m_visited) { vis.m_degree = vis.m_unvisited; }
-        }
-
-        void reset_visited()
-        {
-            for (auto& vis: m_visited) { vis.m_unvisited = vis.m_degree; }
-        }
-
-        std::size_t degree(I from) const
-        {
-            const auto rel_idx = static_cast<std::size_t>(from) - m_min_idx;
-            return m_visited[rel_idx].m_degree;
-        }
-
-        std::size_t unvisited(I from) const
-        {
-            const auto rel_idx = static_cast<std::size_t>(from) - m_min_idx;
-            return m_visited[rel_idx].m_unvisited;
-        }
-
-        std::size_t find_sub_idx(I from, I to) const
-        {
-            const auto rel_idx = static_cast<std::size_t>(from) - m_min_idx;
-            std::size_t sub_idx = 0u;
-            while(sub_idx < m_max_deg && m_adj[m_max_deg * rel_idx + sub_idx] != to) { sub_idx++; }
-            return sub_idx;
-        }
-
-        void visit(I from, std::size_t to_sub_idx)
-        {
-            assert(m_min_idx <= from && from <= m_max_idx);
-            const auto rel_idx = static_cast<std::size_t>(from) - m_min_idx;
-            if (m_visited[rel_idx].m_unvisited == 0) { assert(0); return; }
-            assert(to_sub_idx < m_visited[rel_idx].m_unvisited);
-            if (to_sub_idx < m_visited[rel_idx].m_unvisited - 1)
-            {
-                std::swap(m_adj[m_max_deg * rel_idx + to_sub_idx], m_adj[m_max_deg * rel_idx + m_visited[rel_idx].m_unvisited - 1]);
-            }
-            // Else, nothing to do, the visited vertex is already at the end of the list
-            m_visited[rel_idx].m_unvisited--;
-        }
-
-        const I& adj_vertex(I from, std::size_t to_sub_idx) const
-        {
-            assert(to_sub_idx < m_max_deg);
-            assert(m_min_idx <= from && from <= m_max_idx);
-            const auto rel_idx = static_cast<std::size_t>(from) - m_min_idx;
-            return m_adj[m_max_deg * rel_idx + to_sub_idx];
-        }
-    private:
-        struct DegVisited
-        {
-            std::size_t m_unvisited = 0u;
-            std::size_t m_degree = 0u;
-        };
-        std::vector<I> m_adj;
-        std::vector<DegVisited> m_visited;
-        std::size_t m_min_idx;
-        std::size_t m_max_idx;
-        std::size_t m_max_deg;
-    };
+        return std::accumulate(paths.cbegin(), paths.cend(), std::size_t(0), [](const std::size_t n, const Path<I>& p) -> std::size_t { return n + nb_edges(p); });
+    }
 
 } // namespace details
 
 template <typename I>
 std::size_t min_degree(const EdgeSoup<I>& edges)
 {
-    if (edges.empty()) { return 0; }
-    const auto vertex_deg = details::vertex_degree<I>(edges);
-    assert(!vertex_deg.empty());
-    return std::min_element(std::cbegin(vertex_deg), std::cend(vertex_deg), [](const auto& a, const auto& b) { return a.second < b.second; })->second;
+    return minmax_degree(edges).first;
 }
 
 template <typename I>
 std::size_t max_degree(const EdgeSoup<I>& edges)
 {
-    if (edges.empty()) { return 0; }
-    const auto vertex_deg = details::vertex_degree<I>(edges);
-    assert(!vertex_deg.empty());
-    return std::max_element(std::cbegin(vertex_deg), std::cend(vertex_deg), [](const auto& a, const auto& b) { return a.second < b.second; })->second;
+    return minmax_degree(edges).second;
 }
 
 template <typename I>
 std::pair<std::size_t, std::size_t> minmax_degree(const EdgeSoup<I>& edges)
 {
     if (edges.empty()) { return std::pair<std::size_t, std::size_t>(0, 0); }
-    const auto vertex_deg = details::vertex_degree<I>(edges);
-    assert(!vertex_deg.empty());
-    const auto pair_it = std::minmax_element(std::cbegin(vertex_deg), std::cend(vertex_deg), [](const auto& a, const auto& b) { return a.second < b.second; });
-    return std::make_pair(pair_it.first->second, pair_it.second->second);
+    const auto degrees = details::vertex_degrees<I>(edges);
+    return details::minmax_nonzero_degree(degrees.size(), [&degrees](std::size_t idx) { return degrees[idx]; });
+}
+
+template <typename I>
+std::size_t min_degree(const CsrGraph<I>& graph)
+{
+    return minmax_degree(graph).first;
+}
+
+template <typename I>
+std::size_t max_degree(const CsrGraph<I>& graph)
+{
+    return minmax_degree(graph).second;
+}
+
+template <typename I>
+std::pair<std::size_t, std::size_t> minmax_degree(const CsrGraph<I>& graph)
+{
+    return details::minmax_nonzero_degree(graph.nb_vertices(), [&graph](std::size_t idx) { return graph.degree(static_cast<I>(idx)); });
 }
 
 template <typename I>
@@ -644,19 +640,46 @@ std::vector<Path<I>> extract_paths(const EdgeSoup<I>& edges)
     if (edges.empty())
         return result;
 
-    std::vector<std::pair<I, std::size_t>> degrees = details::vertex_degree<I>(edges);
-    const auto max_deg = std::max_element(std::cbegin(degrees), std::cend(degrees), [](const auto& a, const auto& b) { return a.second < b.second; })->second;
+    const CsrGraph<I> graph(edges);
+    const std::size_t nb_vertices = graph.nb_vertices();
 
     // All vertices of deg != 2 are endpoints, and we shall process those ones first. The remaining vertices of deg = 2 are part of closed 1-manifold paths.
-    std::partition(degrees.begin(), degrees.end(), [](const auto& pair_idx_deg){ return pair_idx_deg.second != 2; });
+    std::vector<I> start_vertices;
+    start_vertices.reserve(nb_vertices);
+    for (std::size_t idx = 0; idx < nb_vertices; idx++)
+    {
+        const std::size_t deg = graph.degree(static_cast<I>(idx));
+        if (deg != 0 && deg != 2) { start_vertices.push_back(static_cast<I>(idx)); }
+    }
+    for (std::size_t idx = 0; idx < nb_vertices; idx++)
+    {
+        if (graph.degree(static_cast<I>(idx)) == 2) { start_vertices.push_back(static_cast<I>(idx)); }
+    }
 
-    // Create adjency list
-    details::AdjList<I> adj_list(edges, max_deg);
+    // Traversal support: The half-edges out of a vertex before next_half_edge[v] belong to visited edges
+    std::vector<bool> visited_edge(edges.size(), false);
+    std::vector<std::size_t> next_half_edge(nb_vertices);
+    std::vector<std::size_t> unvisited(nb_vertices);
+    for (std::size_t idx = 0; idx < nb_vertices; idx++)
+    {
+        next_half_edge[idx] = graph.first_half_edge(static_cast<I>(idx));
+        unvisited[idx] = graph.degree(static_cast<I>(idx));
+    }
+    const auto visit_next_edge = [&](I from) {
+        const auto from_idx = static_cast<std::size_t>(from);
+        assert(unvisited[from_idx] > 0);
+        std::size_t& half_edge = next_half_edge[from_idx];
+        while (visited_edge[graph.edge_index(half_edge)]) { half_edge++; }
+        const I to = graph.neighbor(half_edge);
+        visited_edge[graph.edge_index(half_edge)] = true;
+        unvisited[from_idx]--;
+        unvisited[static_cast<std::size_t>(to)]--;
+        return to;
+    };
 
-    for (const auto& [from, deg] : degrees)
+    for (const I from : start_vertices)
     {
-        UNUSED(deg);
-        while (adj_list.unvisited(from) > 0)
+        while (unvisited[static_cast<std::size_t>(from)] > 0)
         {
             Path<I> path;
             I idx = from;
@@ -665,14 +688,11 @@ std::vector<Path<I>> extract_paths(const EdgeSoup<I>& edges)
             while (!(closed_the_loop || next_is_an_endpoint))
             {
                 path.vertices.emplace_back(idx);
-                const auto next_idx = adj_list.adj_vertex(idx, 0);
-                adj_list.visit(idx, 0);
-                const auto sub_idx = adj_list.find_sub_idx(next_idx, idx);
-                adj_list.visit(next_idx, sub_idx);
+                const I next_idx = visit_next_edge(idx);
                 closed_the_loop = (next_idx == from);
-                next_is_an_endpoint = (adj_list.degree(next_idx) != 2);
+                next_is_an_endpoint = (graph.degree(next_idx) != 2);
                 // From graph theory: Either we exit the loop or the next vertex is traversable
-                assert(closed_the_loop || next_is_an_endpoint || adj_list.unvisited(next_idx) > 0);
+                assert(closed_the_loop || next_is_an_endpoint || unvisited[static_cast<std::size_t>(next_idx)] > 0);
                 idx = next_idx;
             }
             if (idx == from)
@@ -2,15 +2,24 @@
 // This code is distributed under the terms of the MIT License
 #pragma once
 
+#include <graphs/csr_graph.h>
+#include <graphs/graph.h>
 #include <graphs/index.h>
 #include <graphs/union_find.h>
 #include <stdutils/algorithm.h>
+#include <stdutils/macros.h>
+#include <stdutils/parallel.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <iterator>
+#include <limits>
+#include <memory>
 #include <set>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace graphs {
@@ -31,27 +40,81 @@ namespace graphs {
  * - const graph::Edge<index>& edge() const
  * - F weight() const
  *
+ * The NN, MST and RNG only compare the weights with each other, therefore they give the same result if the weights are the squared lengths
+ * of the edges instead of their lengths, which spares the computation of a square root per edge and per candidate vertex. The exclusion
+ * test of the GG is not invariant by that transformation, so the GG functions take an EdgeWeight argument telling which of the two is used.
+ *
+ * The RNG and GG have two variants:
+ *  - A naive one that tests each input edge against all the vertices of the input graph, in O(n^2);
+ *  - One that takes as additional input the Delaunay triangulation the edges were extracted from, and only tests the vertices
+ *    in the neighborhood of each edge. Since both graphs are subgraphs of the Delaunay triangulation, the result is the same.
+ *
  *
  * References:
  *  - J.S.B. Mitchell and W. Mulzer "Proximity Algorithms." Chap. 32 in: Handbook of Discrete and Computational Geometry, 3rd edition.
  *    https://www.csun.edu/~ctoth/Handbook/HDCG3.html
  */
 
-// NN
+enum class EdgeWeight
+{
+    Length,
+    SquaredLength
+};
+
+// NN, in O(n) without sorting the edges: Each vertex selects its shortest incident edge, the ties being broken by the position of the
+// edges in the input range. The output edges keep their relative order.
 template <typename WeightedEdgeIt>
 WeightedEdgeIt nearest_neighbor(WeightedEdgeIt begin, WeightedEdgeIt end);
 
+// NN, parallel version. WeightedEdgeIt must be a random access iterator. The output is the same as that of the sequential version.
+template <typename WeightedEdgeIt>
+WeightedEdgeIt nearest_neighbor(const stdutils::parallel::Policy& policy, WeightedEdgeIt begin, WeightedEdgeIt end);
+
 // MST
 template <typename WeightedEdgeIt>
 WeightedEdgeIt minimum_spanning_tree(WeightedEdgeIt begin, WeightedEdgeIt end);
 
+// MST, parallel version. WeightedEdgeIt must be a random access iterator.
+template <typename WeightedEdgeIt>
+WeightedEdgeIt minimum_spanning_tree(const stdutils::parallel::Policy& policy, WeightedEdgeIt begin, WeightedEdgeIt end);
+
 // RNG
 template <typename WeightedEdgeIt, typename WeightFunc>
 WeightedEdgeIt relative_neighborhood_graph(WeightedEdgeIt begin, WeightedEdgeIt end, WeightFunc weight);
 
 // GG
 template <typename WeightedEdgeIt, typename WeightFunc>
-WeightedEdgeIt gabriel_graph(WeightedEdgeIt begin, WeightedEdgeIt end, WeightFunc weight);
+WeightedEdgeIt gabriel_graph(WeightedEdgeIt begin, WeightedEdgeIt end, WeightFunc weight, EdgeWeight edge_weight = EdgeWeight::Length);
+
+// RNG and GG of the edges of a Delaunay triangulation. The input edges must belong to the triangulation passed as argument.
+template <typename WeightedEdgeIt, typename I, typename WeightFunc>
+WeightedEdgeIt relative_neighborhood_graph(WeightedEdgeIt begin, WeightedEdgeIt end, const TriangleSoup<I>& delaunay, WeightFunc weight);
+template <typename WeightedEdgeIt, typename I, typename WeightFunc>
+WeightedEdgeIt gabriel_graph(WeightedEdgeIt begin, WeightedEdgeIt end, const TriangleSoup<I>& delaunay, WeightFunc weight, EdgeWeight edge_weight = EdgeWeight::Length);
+
+// RNG and GG of the edges of a Delaunay triangulation, parallel versions. Each edge is tested independently of the others, then the edges
+// are partitioned as in the sequential versions, whose output is the same. WeightedEdgeIt must be a random access iterator and the weight
+// function must be thread-safe.
+template <typename WeightedEdgeIt, typename I, typename WeightFunc>
+WeightedEdgeIt relative_neighborhood_graph(const stdutils::parallel::Policy& policy, WeightedEdgeIt begin, WeightedEdgeIt end, const TriangleSoup<I>& delaunay, WeightFunc weight);
+template <typename WeightedEdgeIt, typename I, typename WeightFunc>
+WeightedEdgeIt gabriel_graph(const stdutils::parallel::Policy& policy, WeightedEdgeIt begin, WeightedEdgeIt end, const TriangleSoup<I>& delaunay, WeightFunc weight, EdgeWeight edge_weight = EdgeWeight::Length);
+
+// All the graphs at once, exploiting the hierarchy NN ⊆ MST ⊆ RNG ⊆ GG ⊆ DT: Each graph is computed from the edges of the next one.
+// The input range must hold all the edges of the Delaunay triangulation. It is sorted by weight once, then partitioned so that each graph
+// is a prefix of the range: The NN is [begin, nn_end), the MST is [begin, mst_end), and so on up to the DT which is [begin, end).
+// Each stage only processes the output of the previous one.
+template <typename WeightedEdgeIt>
+struct ProximityHierarchy
+{
+    WeightedEdgeIt nn_end;
+    WeightedEdgeIt mst_end;
+    WeightedEdgeIt rng_end;
+    WeightedEdgeIt gg_end;
+};
+
+template <typename WeightedEdgeIt, typename I, typename WeightFunc>
+ProximityHierarchy<WeightedEdgeIt> proximity_hierarchy(WeightedEdgeIt begin, WeightedEdgeIt end, const TriangleSoup<I>& delaunay, WeightFunc weight, EdgeWeight edge_weight = EdgeWeight::Length);
 
 
 //
@@ -61,13 +124,45 @@ WeightedEdgeIt gabriel_graph(WeightedEdgeIt begin, WeightedEdgeIt end, WeightFun
 //
 
 
+namespace details {
+
+template <typename W>
+W squared_length(W w, EdgeWeight edge_weight)
+{
+    return edge_weight == EdgeWeight::Length ? w * w : w;
+}
+
+// Below that number of edges, the weighted edges are sorted with a comparison sort
+constexpr std::size_t radix_sort_threshold = 2048;
+
+// Sort a range of edges by weight. The floating-point weights of a large random access range are sorted with a radix sort.
 template <typename WeightedEdgeIt>
-WeightedEdgeIt nearest_neighbor(WeightedEdgeIt begin, WeightedEdgeIt end)
+void sort_by_weight(const stdutils::parallel::Policy& policy, WeightedEdgeIt begin, WeightedEdgeIt end)
 {
-    using I = typename std::iterator_traits<WeightedEdgeIt>::value_type::index;
+    using WeightedEdge = typename std::iterator_traits<WeightedEdgeIt>::value_type;
+    using W = std::decay_t<decltype(std::declval<const WeightedEdge&>().weight())>;
+    const auto less_weight = [](const auto& lhs, const auto& rhs) { return lhs.weight() < rhs.weight(); };
+    if constexpr (std::is_floating_point_v<W> && std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<WeightedEdgeIt>::iterator_category>)
+    {
+        if (static_cast<std::size_t>(std::distance(begin, end)) >= radix_sort_threshold)
+        {
+            stdutils::radix_sort_by_key(policy, begin, end, [](const auto& edge) { return edge.weight(); });
+            return;
+        }
+        stdutils::parallel::sort(policy, begin, end, less_weight);
+    }
+    else
+    {
+        UNUSED(policy);
+        std::sort(begin, end, less_weight);
+    }
+}
 
-    // Sort edges by weight
-    std::sort(begin, end, [](const auto& lhs, const auto& rhs) { return lhs.weight() < rhs.weight(); });
+// Nearest-neighbor graph of a range of edges sorted by weight
+template <typename WeightedEdgeIt>
+WeightedEdgeIt nearest_neighbor_sorted(WeightedEdgeIt begin, WeightedEdgeIt end)
+{
+    using I = typename std::iterator_traits<WeightedEdgeIt>::value_type::index;
 
     // Support vector containing the degree of each vertex
     I max_index = 0;
@@ -78,7 +173,6 @@ WeightedEdgeIt nearest_neighbor(WeightedEdgeIt begin, WeightedEdgeIt end)
     assert(max_index <= IndexTraits<I>::max_valid_index());
     std::vector<std::uint8_t> vertex_degree(max_index + 1, 0u);
 
-    // Build the nearest-neighbor graph
     WeightedEdgeIt nn_end = begin;
     WeightedEdgeIt current = begin;
     std::size_t point_count = 0;
@@ -112,26 +206,38 @@ WeightedEdgeIt nearest_neighbor(WeightedEdgeIt begin, WeightedEdgeIt end)
     return nn_end;
 }
 
-// Compute the MST with Kruskal's algorithm
 template <typename WeightedEdgeIt>
-WeightedEdgeIt minimum_spanning_tree(WeightedEdgeIt begin, WeightedEdgeIt end)
+auto max_vertex_index(WeightedEdgeIt begin, WeightedEdgeIt end)
 {
     using I = typename std::iterator_traits<WeightedEdgeIt>::value_type::index;
-
-    // Sort edges by weight
-    std::sort(begin, end, [](const auto& lhs, const auto& rhs) { return lhs.weight() < rhs.weight(); });
-
-    // Union-find structure to identify components
     I max_index = 0;
     std::for_each(begin, end, [&max_index](const auto& edge) {
         stdutils::max_update(max_index, edge.edge().orig());
         stdutils::max_update(max_index, edge.edge().dest());
     });
     assert(max_index <= IndexTraits<I>::max_valid_index());
-    std::vector<std::uint8_t> vertex_degree(max_index + 1, 0u);
-    UnionFind<I> components(max_index + 1);
+    return max_index;
+}
 
-    // Build the minimum spanning tree
+constexpr std::size_t no_edge = std::numeric_limits<std::size_t>::max();
+
+// Move the edges flagged in keep, indexed by their position in the range, to the beginning of the range and return the end of those edges
+template <typename WeightedEdgeIt>
+WeightedEdgeIt partition_kept_edges(WeightedEdgeIt begin, WeightedEdgeIt end, const std::vector<std::uint8_t>& keep)
+{
+    WeightedEdgeIt kept_end = begin;
+    std::size_t idx = 0;
+    for (WeightedEdgeIt current = begin; current != end; current++, idx++)
+    {
+        if (keep[idx]) { std::swap(*kept_end, *current); kept_end++; }
+    }
+    return kept_end;
+}
+
+// Kruskal's loop over a range of edges sorted by weight
+template <typename WeightedEdgeIt, typename I>
+WeightedEdgeIt kruskal(WeightedEdgeIt begin, WeightedEdgeIt end, UnionFind<I>& components)
+{
     WeightedEdgeIt mst_end = begin;
     WeightedEdgeIt current = begin;
     while (current != end)
@@ -149,10 +255,174 @@ WeightedEdgeIt minimum_spanning_tree(WeightedEdgeIt begin, WeightedEdgeIt end)
         }
         current++;
     }
-
     return mst_end;
 }
 
+// Filter-Kruskal: Partition the edges around a pivot weight, compute the MST of the light edges, then discard the heavy edges
+// which endpoints are already connected before recursing on the remaining heavy edges. This avoids sorting most of the heavy edges.
+// The sort of the small ranges and the filtering are parallelized.
+//
+// Reference:
+//  - V. Osipov, P. Sanders and J. Singler. "The Filter-Kruskal Minimum Spanning Tree Algorithm". ALENEX 2009.
+template <typename WeightedEdgeIt, typename I>
+WeightedEdgeIt filter_kruskal(const stdutils::parallel::Policy& policy, WeightedEdgeIt begin, WeightedEdgeIt end, UnionFind<I>& components)
+{
+    const auto n = static_cast<std::size_t>(std::distance(begin, end));
+    const std::size_t kruskal_threshold = std::max(static_cast<std::size_t>(components.size()), policy.min_chunk_size);
+    const auto sort_and_kruskal = [&]() {
+        sort_by_weight(policy, begin, end);
+        return kruskal(begin, end, components);
+    };
+    if (n <= kruskal_threshold) { return sort_and_kruskal(); }
+
+    // Partition around the median of three weights
+    const auto pivot = [&]() {
+        auto a = begin->weight();
+        auto b = (begin + static_cast<std::ptrdiff_t>(n / 2))->weight();
+        auto c = (end - 1)->weight();
+        if (b < a) { std::swap(a, b); }
+        if (c < b) { std::swap(b, c); }
+        if (b < a) { std::swap(a, b); }
+        return b;
+    }();
+    const WeightedEdgeIt mid = std::partition(begin, end, [&pivot](const auto& edge) { return !(pivot < edge.weight()); });
+    if (mid == end) { return sort_and_kruskal(); }     // Degenerate partition, e.g. all the weights are equal
+    const WeightedEdgeIt light_mst_end = filter_kruskal(policy, begin, mid, components);
+
+    // Filter out the heavy edges which endpoints are in the same component. The const UnionFind::find() is thread-safe.
+    const auto nb_heavy = static_cast<std::size_t>(std::distance(mid, end));
+    std::vector<std::uint8_t> keep(nb_heavy, 0u);
+    const UnionFind<I>& const_components = components;
+    stdutils::parallel::for_each_chunk(policy, nb_heavy, [&const_components, &keep, mid](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++)
+        {
+            const auto& edge = *(mid + static_cast<std::ptrdiff_t>(idx));
+            keep[idx] = (const_components.find(edge.edge().orig()) != const_components.find(edge.edge().dest())) ? 1u : 0u;
+        }
+    });
+    WeightedEdgeIt heavy_end = mid;
+    for (std::size_t idx = 0; idx < nb_heavy; idx++)
+    {
+        if (keep[idx]) { std::swap(*heavy_end, *(mid + static_cast<std::ptrdiff_t>(idx))); heavy_end++; }
+    }
+    const WeightedEdgeIt heavy_mst_end = filter_kruskal(policy, mid, heavy_end, components);
+
+    // Gather the two parts of the MST at the beginning of the range
+    std::rotate(light_mst_end, mid, heavy_mst_end);
+    return light_mst_end + std::distance(mid, heavy_mst_end);
+}
+
+} // namespace details
+
+template <typename WeightedEdgeIt>
+WeightedEdgeIt nearest_neighbor(WeightedEdgeIt begin, WeightedEdgeIt end)
+{
+    using WeightedEdge = typename std::iterator_traits<WeightedEdgeIt>::value_type;
+    using W = std::decay_t<decltype(std::declval<const WeightedEdge&>().weight())>;
+
+    if (begin == end) { return end; }
+    const std::size_t nb_vertices = static_cast<std::size_t>(details::max_vertex_index(begin, end)) + 1;
+
+    // Shortest incident edge of each vertex. The strict comparison keeps the first of the edges of equal weight.
+    std::vector<std::size_t> shortest_edge(nb_vertices, details::no_edge);
+    std::vector<W> shortest_weight(nb_vertices);
+    std::size_t nb_edges = 0;
+    for (WeightedEdgeIt current = begin; current != end; current++, nb_edges++)
+    {
+        const auto w = current->weight();
+        for (const auto v : { current->edge().orig(), current->edge().dest() })
+        {
+            if (shortest_edge[v] == details::no_edge || w < shortest_weight[v])
+            {
+                shortest_edge[v] = nb_edges;
+                shortest_weight[v] = w;
+            }
+        }
+    }
+
+    // Build the nearest-neighbor graph
+    std::vector<std::uint8_t> keep(nb_edges, 0u);
+    for (const auto edge_idx : shortest_edge)
+    {
+        if (edge_idx != details::no_edge) { keep[edge_idx] = 1u; }
+    }
+    return details::partition_kept_edges(begin, end, keep);
+}
+
+// The shortest incident edge of each vertex is updated concurrently with an atomic min on the edge index, for the total order of the edges
+// by weight then by position. The result does not depend on the scheduling of the threads.
+template <typename WeightedEdgeIt>
+WeightedEdgeIt nearest_neighbor(const stdutils::parallel::Policy& policy, WeightedEdgeIt begin, WeightedEdgeIt end)
+{
+    static_assert(std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<WeightedEdgeIt>::iterator_category>);
+
+    if (begin == end) { return end; }
+    const std::size_t nb_vertices = static_cast<std::size_t>(details::max_vertex_index(begin, end)) + 1;
+    const auto nb_edges = static_cast<std::size_t>(std::distance(begin, end));
+    const auto edge_at = [begin](std::size_t idx) -> const auto& { return *(begin + static_cast<std::ptrdiff_t>(idx)); };
+    const auto shorter = [&edge_at](std::size_t a, std::size_t b) {
+        const auto w_a = edge_at(a).weight();
+        const auto w_b = edge_at(b).weight();
+        return w_a < w_b || (!(w_b < w_a) && a < b);
+    };
+
+    auto shortest_edge = std::make_unique<std::atomic<std::size_t>[]>(nb_vertices);
+    stdutils::parallel::for_each_chunk(policy, nb_vertices, [&shortest_edge](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t v = begin_idx; v < end_idx; v++) { shortest_edge[v].store(details::no_edge, std::memory_order_relaxed); }
+    });
+    stdutils::parallel::for_each_chunk(policy, nb_edges, [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++)
+        {
+            const auto& edge = edge_at(idx).edge();
+            for (const auto v : { edge.orig(), edge.dest() })
+            {
+                auto& shortest = shortest_edge[static_cast<std::size_t>(v)];
+                std::size_t current = shortest.load(std::memory_order_relaxed);
+                while ((current == details::no_edge || shorter(idx, current)) && !shortest.compare_exchange_weak(current, idx, std::memory_order_relaxed)) {}
+            }
+        }
+    });
+
+    // Build the nearest-neighbor graph
+    std::vector<std::uint8_t> keep(nb_edges, 0u);
+    for (std::size_t v = 0; v < nb_vertices; v++)
+    {
+        const std::size_t edge_idx = shortest_edge[v].load(std::memory_order_relaxed);
+        if (edge_idx != details::no_edge) { keep[edge_idx] = 1u; }
+    }
+    return details::partition_kept_edges(begin, end, keep);
+}
+
+// Compute the MST with Kruskal's algorithm
+template <typename WeightedEdgeIt>
+WeightedEdgeIt minimum_spanning_tree(WeightedEdgeIt begin, WeightedEdgeIt end)
+{
+    using I = typename std::iterator_traits<WeightedEdgeIt>::value_type::index;
+
+    // Sort edges by weight
+    details::sort_by_weight(stdutils::parallel::Policy{ 1 }, begin, end);
+
+    // Union-find structure to identify components
+    const I max_index = details::max_vertex_index(begin, end);
+    UnionFind<I> components(max_index + 1);
+
+    // Build the minimum spanning tree
+    return details::kruskal(begin, end, components);
+}
+
+// Compute the MST with the Filter-Kruskal algorithm
+template <typename WeightedEdgeIt>
+WeightedEdgeIt minimum_spanning_tree(const stdutils::parallel::Policy& policy, WeightedEdgeIt begin, WeightedEdgeIt end)
+{
+    using I = typename std::iterator_traits<WeightedEdgeIt>::value_type::index;
+    static_assert(std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<WeightedEdgeIt>::iterator_category>);
+
+    if (begin == end) { return end; }
+    const I max_index = details::max_vertex_index(begin, end);
+    UnionFind<I> components(max_index + 1);
+    return details::filter_kruskal(policy, begin, end, components);
+}
+
 // Naive O(n^2) implementation of the RNG
 template <typename WeightedEdgeIt, typename WeightFunc>
 WeightedEdgeIt relative_neighborhood_graph(WeightedEdgeIt begin, WeightedEdgeIt end, WeightFunc weight)
@@ -191,7 +461,7 @@ WeightedEdgeIt relative_neighborhood_graph(WeightedEdgeIt begin, WeightedEdgeIt
 
 // Naive O(n^2) implementation of the GG
 template <typename WeightedEdgeIt, typename WeightFunc>
-WeightedEdgeIt gabriel_graph(WeightedEdgeIt begin, WeightedEdgeIt end, WeightFunc weight)
+WeightedEdgeIt gabriel_graph(WeightedEdgeIt begin, WeightedEdgeIt end, WeightFunc weight, EdgeWeight edge_weight)
 {
     using I = typename std::iterator_traits<WeightedEdgeIt>::value_type::index;
 
@@ -209,12 +479,9 @@ WeightedEdgeIt gabriel_graph(WeightedEdgeIt begin, WeightedEdgeIt end, WeightFun
     {
         const I i = current->edge().orig();
         const I j = current->edge().dest();
-        const auto w_ij = current->weight();
-        const auto w_ij_sq = w_ij * w_ij;
-        const bool exclusion_zone_is_empty = std::none_of(vertices.cbegin(), vertices.cend(), [i, j, w_ij_sq, &weight](const I k) {
-            const auto w_ik = weight(i, k);
-            const auto w_jk = weight(j, k);
-            return (w_ik * w_ik + w_jk * w_jk) < w_ij_sq;
+        const auto sq_ij = details::squared_length(current->weight(), edge_weight);
+        const bool exclusion_zone_is_empty = std::none_of(vertices.cbegin(), vertices.cend(), [i, j, sq_ij, edge_weight, &weight](const I k) {
+            return (details::squared_length(weight(i, k), edge_weight) + details::squared_length(weight(j, k), edge_weight)) < sq_ij;
         });
         if (exclusion_zone_is_empty)
         {
@@ -228,4 +495,218 @@ WeightedEdgeIt gabriel_graph(WeightedEdgeIt begin, WeightedEdgeIt end, WeightFun
     return gg_end;
 }
 
+namespace details {
+
+// For each edge of a triangulation, the vertex opposite to that edge in the adjacent triangle(s). Sorted by ordered edge.
+template <typename I>
+std::vector<std::pair<Edge<I>, I>> opposite_vertices(const stdutils::parallel::Policy& policy, const TriangleSoup<I>& triangles)
+{
+    std::vector<std::pair<Edge<I>, I>> result(3 * triangles.size());
+    stdutils::parallel::for_each_chunk(policy, triangles.size(), [&triangles, &result](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++)
+        {
+            const auto& t = triangles[idx];
+            result[3 * idx] = std::make_pair(t[0] < t[1] ? Edge<I>(t[0], t[1]) : Edge<I>(t[1], t[0]), t[2]);
+            result[3 * idx + 1] = std::make_pair(t[1] < t[2] ? Edge<I>(t[1], t[2]) : Edge<I>(t[2], t[1]), t[0]);
+            result[3 * idx + 2] = std::make_pair(t[2] < t[0] ? Edge<I>(t[2], t[0]) : Edge<I>(t[0], t[2]), t[1]);
+        }
+    });
+    stdutils::parallel::sort(policy, result.begin(), result.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    return result;
+}
+
+template <typename I>
+std::vector<std::pair<Edge<I>, I>> opposite_vertices(const TriangleSoup<I>& triangles)
+{
+    return opposite_vertices(stdutils::parallel::Policy{ 1 }, triangles);
+}
+
+// True if the opposite vertices of edge ij, in the adjacent triangles, lie outside of its diametral circle
+template <typename I, typename W, typename WeightFunc>
+bool is_gabriel_edge(const std::vector<std::pair<Edge<I>, I>>& opposites, I i, I j, W w_ij, WeightFunc& weight, EdgeWeight edge_weight)
+{
+    const auto sq_ij = squared_length(w_ij, edge_weight);
+    const std::pair<Edge<I>, I> key(i < j ? Edge<I>(i, j) : Edge<I>(j, i), I{0});
+    const auto [first, last] = std::equal_range(opposites.cbegin(), opposites.cend(), key, [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    assert(first != last);      // The edge must belong to the triangulation
+    return std::none_of(first, last, [i, j, sq_ij, edge_weight, &weight](const auto& opp) {
+        const I k = opp.second;
+        return (squared_length(weight(i, k), edge_weight) + squared_length(weight(j, k), edge_weight)) < sq_ij;
+    });
+}
+
+// True if the lune of edge ij is empty. The traversal of the Delaunay triangulation from i is the same as in relative_neighborhood_graph(),
+// but the visited vertices are kept in a short list instead of a stamp per vertex, so that each thread only needs a few bytes of support.
+template <typename I, typename W, typename WeightFunc>
+bool is_rng_edge(const CsrGraph<I>& adjacency, I i, I j, W w_ij, WeightFunc& weight, std::vector<I>& visited, std::vector<I>& to_visit)
+{
+    bool exclusion_zone_is_empty = true;
+    visited.assign(1, i);
+    to_visit.assign(1, i);
+    while (exclusion_zone_is_empty && !to_visit.empty())
+    {
+        const I from = to_visit.back();
+        to_visit.pop_back();
+        adjacency.for_each_neighbor(from, [&](const I k) {
+            if (std::find(visited.cbegin(), visited.cend(), k) != visited.cend()) { return; }
+            visited.push_back(k);
+            if (k == j || !(weight(i, k) < w_ij)) { return; }
+            exclusion_zone_is_empty &= !(weight(j, k) < w_ij);
+            to_visit.push_back(k);
+        });
+    }
+    return exclusion_zone_is_empty;
+}
+
+} // namespace details
+
+// RNG restricted to the neighborhood of each Delaunay edge
+//
+// The lune of an edge pq is contained in the disk of center p and radius |pq|. The vertices in that disk are connected in the Delaunay
+// triangulation (the k-th nearest neighbor of p is adjacent to p or to one of its k-1 nearest neighbors), therefore they are found
+// by a traversal of the triangulation starting from p. The cost of each edge is proportional to the number of vertices in that disk,
+// which is small for well distributed point sets.
+//
+// Reference:
+//  - M.T. Dickerson, R.L. Drysdale, J.R. Sack. "Simple algorithms for enumerating interpoint distances and finding k nearest neighbors."
+//    International Journal of Computational Geometry & Applications 2.03 (1992): 221-239.
+template <typename WeightedEdgeIt, typename I, typename WeightFunc>
+WeightedEdgeIt relative_neighborhood_graph(WeightedEdgeIt begin, WeightedEdgeIt end, const TriangleSoup<I>& delaunay, WeightFunc weight)
+{
+    static_assert(std::is_same_v<I, typename std::iterator_traits<WeightedEdgeIt>::value_type::index>);
+
+    if (delaunay.empty()) { return begin; }
+    const CsrGraph<I> adjacency(delaunay);
+
+    // Traversal support: last_visit[k] is the index of the last edge for which vertex k was visited
+    std::vector<std::size_t> last_visit(adjacency.nb_vertices(), 0u);
+    std::vector<I> to_visit;
+    std::size_t edge_count = 0;
+
+    WeightedEdgeIt rng_end = begin;
+    WeightedEdgeIt current = begin;
+    while (current != end)
+    {
+        const I i = current->edge().orig();
+        const I j = current->edge().dest();
+        const auto w_ij = current->weight();
+        edge_count++;
+        bool exclusion_zone_is_empty = true;
+        to_visit.clear();
+        to_visit.push_back(i);
+        last_visit[i] = edge_count;
+        while (exclusion_zone_is_empty && !to_visit.empty())
+        {
+            const I from = to_visit.back();
+            to_visit.pop_back();
+            adjacency.for_each_neighbor(from, [&](const I k) {
+                if (last_visit[k] == edge_count) { return; }
+                last_visit[k] = edge_count;
+                if (k == j || !(weight(i, k) < w_ij)) { return; }
+                exclusion_zone_is_empty &= !(weight(j, k) < w_ij);
+                to_visit.push_back(k);
+            });
+        }
+        if (exclusion_zone_is_empty)
+        {
+            // The edge belongs to the RNG
+            std::swap(*rng_end, *current);
+            rng_end++;
+        }
+        current++;
+    }
+
+    return rng_end;
+}
+
+// GG restricted to the triangles adjacent to each Delaunay edge
+//
+// An edge of the Delaunay triangulation is a Gabriel edge if and only if the vertices opposite to that edge in its one or two
+// adjacent triangles lie outside of its diametral circle. Complexity in O(n log n), the cost of sorting the edges of the triangulation.
+template <typename WeightedEdgeIt, typename I, typename WeightFunc>
+WeightedEdgeIt gabriel_graph(WeightedEdgeIt begin, WeightedEdgeIt end, const TriangleSoup<I>& delaunay, WeightFunc weight, EdgeWeight edge_weight)
+{
+    static_assert(std::is_same_v<I, typename std::iterator_traits<WeightedEdgeIt>::value_type::index>);
+
+    const auto opposites = details::opposite_vertices(delaunay);
+
+    WeightedEdgeIt gg_end = begin;
+    WeightedEdgeIt current = begin;
+    while (current != end)
+    {
+        if (details::is_gabriel_edge(opposites, current->edge().orig(), current->edge().dest(), current->weight(), weight, edge_weight))
+        {
+            // The edge belongs to the GG
+            std::swap(*gg_end, *current);
+            gg_end++;
+        }
+        current++;
+    }
+
+    return gg_end;
+}
+
+template <typename WeightedEdgeIt, typename I, typename WeightFunc>
+WeightedEdgeIt relative_neighborhood_graph(const stdutils::parallel::Policy& policy, WeightedEdgeIt begin, WeightedEdgeIt end, const TriangleSoup<I>& delaunay, WeightFunc weight)
+{
+    static_assert(std::is_same_v<I, typename std::iterator_traits<WeightedEdgeIt>::value_type::index>);
+    static_assert(std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<WeightedEdgeIt>::iterator_category>);
+
+    if (delaunay.empty()) { return begin; }
+    const CsrGraph<I> adjacency(delaunay);
+    const auto nb_edges = static_cast<std::size_t>(std::distance(begin, end));
+    std::vector<std::uint8_t> keep(nb_edges, 0u);
+    stdutils::parallel::for_each_chunk(policy, nb_edges, [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        std::vector<I> visited;
+        std::vector<I> to_visit;
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++)
+        {
+            const auto& w_edge = *(begin + static_cast<std::ptrdiff_t>(idx));
+            keep[idx] = details::is_rng_edge(adjacency, w_edge.edge().orig(), w_edge.edge().dest(), w_edge.weight(), weight, visited, to_visit) ? 1u : 0u;
+        }
+    });
+    return details::partition_kept_edges(begin, end, keep);
+}
+
+template <typename WeightedEdgeIt, typename I, typename WeightFunc>
+WeightedEdgeIt gabriel_graph(const stdutils::parallel::Policy& policy, WeightedEdgeIt begin, WeightedEdgeIt end, const TriangleSoup<I>& delaunay, WeightFunc weight, EdgeWeight edge_weight)
+{
+    static_assert(std::is_same_v<I, typename std::iterator_traits<WeightedEdgeIt>::value_type::index>);
+    static_assert(std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<WeightedEdgeIt>::iterator_category>);
+
+    const auto opposites = details::opposite_vertices(policy, delaunay);
+    const auto nb_edges = static_cast<std::size_t>(std::distance(begin, end));
+    std::vector<std::uint8_t> keep(nb_edges, 0u);
+    stdutils::parallel::for_each_chunk(policy, nb_edges, [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++)
+        {
+            const auto& w_edge = *(begin + static_cast<std::ptrdiff_t>(idx));
+            keep[idx] = details::is_gabriel_edge(opposites, w_edge.edge().orig(), w_edge.edge().dest(), w_edge.weight(), weight, edge_weight) ? 1u : 0u;
+        }
+    });
+    return details::partition_kept_edges(begin, end, keep);
+}
+
+template <typename WeightedEdgeIt, typename I, typename WeightFunc>
+ProximityHierarchy<WeightedEdgeIt> proximity_hierarchy(WeightedEdgeIt begin, WeightedEdgeIt end, const TriangleSoup<I>& delaunay, WeightFunc weight, EdgeWeight edge_weight)
+{
+    static_assert(std::is_same_v<I, typename std::iterator_traits<WeightedEdgeIt>::value_type::index>);
+
+    // Sort once. The filters keep the relative order of the edges they select, so the input of the MST and NN stages is sorted.
+    details::sort_by_weight(stdutils::parallel::Policy{ 1 }, begin, end);
+
+    ProximityHierarchy<WeightedEdgeIt> result;
+    result.gg_end = gabriel_graph(begin, end, delaunay, weight, edge_weight);
+    result.rng_end = relative_neighborhood_graph(begin, result.gg_end, delaunay, weight);
+    if (begin == result.rng_end)
+    {
+        result.mst_end = result.nn_end = begin;
+        return result;
+    }
+    UnionFind<I> components(details::max_vertex_index(begin, result.rng_end) + 1);
+    result.mst_end = details::kruskal(begin, result.rng_end, components);
+    result.nn_end = details::nearest_neighbor_sorted(begin, result.mst_end);
+    return result;
+}
+
 } // namespace graphs
@@ -3,14 +3,56 @@
 #pragma once
 
 #include <graphs/graph.h>
+#include <graphs/graph_algos.h>
+#include <graphs/index.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstdint>
 #include <map>
+#include <utility>
+#include <vector>
 
 namespace graphs {
 
+/**
+ * Triangle adjacency
+ *
+ * Compact neighbor array attached to a TriangleSoup: For each face f and each edge k of that face (edge k goes from f[k] to f[(k+1)%3],
+ * like in Triangle::edges()), adjacency[f][k] is the index of the face on the other side of the edge, or undef if the edge is on the
+ * boundary of the triangulation.
+ *
+ * Once available, walking from one face to its neighbors is O(1) and the edges of the triangulation can be enumerated in O(n)
+ * without having to rebuild the topology of the triangle soup.
+ */
+template <typename I = std::uint32_t>
+using TriangleAdjacency = std::vector<std::array<I, 3>>;
+
+// Compute the adjacency of a triangle soup in O(n log n). If an edge is shared by more than two faces, only two of them are set as neighbors.
+template <typename I>
+TriangleAdjacency<I> triangle_adjacency(const TriangleSoup<I>& triangles);
+
+// Validate the adjacency against its triangle soup (same size, symmetric, the neighbors share the corresponding edge)
+template <typename I>
+bool is_valid(const TriangleAdjacency<I>& adjacency, const TriangleSoup<I>& triangles);
+
+// Index k of the edge {i, j} in triangle t, in either orientation. Return 3 if the edge does not belong to the triangle.
+template <typename I>
+constexpr std::uint8_t edge_index(const Triangle<I>& t, I i, I j);
+
+// Vertex of the neighbor of face f across its edge k. Return undef if the edge is on the boundary.
+template <typename I>
+I opposite_vertex(const TriangleSoup<I>& triangles, const TriangleAdjacency<I>& adjacency, I f, std::uint8_t k);
+
+// Visit each edge of the triangulation exactly once: func(const Edge<I>& edge, I face, I neighbor_face), neighbor_face being undef on the boundary.
+template <typename I, typename Func>
+void for_each_edge(const TriangleSoup<I>& triangles, const TriangleAdjacency<I>& adjacency, Func func);
+
+// Same output as to_edge_soup(triangles) (up to the order of the edges) in O(n)
+template <typename I>
+EdgeSoup<I> to_edge_soup(const TriangleSoup<I>& triangles, const TriangleAdjacency<I>& adjacency);
+
 // Borders of a 2-manifold (which can have several components)
 template <typename I>
 struct BordersAndInnerEdges
@@ -22,6 +64,8 @@ struct BordersAndInnerEdges
 // Extract the borders of a 2-manifold triangulation
 template <typename I>
 BordersAndInnerEdges<I> extract_borders(const TriangleSoup<I>& triangles);
+template <typename I>
+BordersAndInnerEdges<I> extract_borders(const TriangleSoup<I>& triangles, const TriangleAdjacency<I>& adjacency);
 
 
 //
@@ -31,6 +75,111 @@ BordersAndInnerEdges<I> extract_borders(const TriangleSoup<I>& triangles);
 //
 
 
+template <typename I>
+TriangleAdjacency<I> triangle_adjacency(const TriangleSoup<I>& triangles)
+{
+    constexpr I Undef = IndexTraits<I>::undef();
+    assert(3 * triangles.size() <= IndexTraits<I>::max_valid_index());
+
+    // Half-edges (ordered edge, 3 * face + k) sorted by edge, so that the twin half-edges are contiguous
+    std::vector<std::pair<Edge<I>, I>> half_edges;
+    half_edges.reserve(3 * triangles.size());
+    I face_idx = 0;
+    for (const auto& t : triangles)
+    {
+        std::uint8_t k = 0;
+        for (const auto& e : t.edges())
+        {
+            half_edges.emplace_back(ordered_edge(e), static_cast<I>(3 * face_idx + k++));
+        }
+        face_idx++;
+    }
+    std::sort(half_edges.begin(), half_edges.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+    TriangleAdjacency<I> result(triangles.size(), { Undef, Undef, Undef });
+    for (std::size_t idx = 0; idx + 1 < half_edges.size(); idx++)
+    {
+        const auto& [edge, he] = half_edges[idx];
+        const auto& [next_edge, next_he] = half_edges[idx + 1];
+        if (edge != next_edge) { continue; }
+        result[he / 3][he % 3] = next_he / 3;
+        result[next_he / 3][next_he % 3] = he / 3;
+        idx++;
+    }
+    return result;
+}
+
+template <typename I>
+bool is_valid(const TriangleAdjacency<I>& adjacency, const TriangleSoup<I>& triangles)
+{
+    if (adjacency.size() != triangles.size()) { return false; }
+    for (std::size_t f = 0; f < triangles.size(); f++)
+    {
+        for (std::uint8_t k = 0; k < 3; k++)
+        {
+            const I n = adjacency[f][k];
+            if (!is_defined(n)) { continue; }
+            if (n >= triangles.size()) { return false; }
+            const I i = triangles[f][k];
+            const I j = triangles[f][(k + 1u) % 3u];
+            const auto n_k = edge_index(triangles[n], i, j);
+            if (n_k == 3 || adjacency[n][n_k] != f) { return false; }
+        }
+    }
+    return true;
+}
+
+template <typename I>
+constexpr std::uint8_t edge_index(const Triangle<I>& t, I i, I j)
+{
+    for (std::uint8_t k = 0; k < 3; k++)
+    {
+        const I a = t[k];
+        const I b = t[(k + 1u) % 3u];
+        if ((a == i && b == j) || (a == j && b == i)) { return k; }
+    }
+    return 3;
+}
+
+template <typename I>
+I opposite_vertex(const TriangleSoup<I>& triangles, const TriangleAdjacency<I>& adjacency, I f, std::uint8_t k)
+{
+    assert(adjacency.size() == triangles.size());
+    assert(f < triangles.size() && k < 3);
+    const I n = adjacency[f][k];
+    if (!is_defined(n)) { return IndexTraits<I>::undef(); }
+    const auto n_k = edge_index(triangles[n], triangles[f][k], triangles[f][(k + 1u) % 3u]);
+    assert(n_k < 3);
+    return triangles[n][(n_k + 2u) % 3u];
+}
+
+template <typename I, typename Func>
+void for_each_edge(const TriangleSoup<I>& triangles, const TriangleAdjacency<I>& adjacency, Func func)
+{
+    assert(adjacency.size() == triangles.size());
+    for (std::size_t f = 0; f < triangles.size(); f++)
+    {
+        const auto edges = triangles[f].edges();
+        for (std::uint8_t k = 0; k < 3; k++)
+        {
+            // An interior edge is visited from the face with the lowest index
+            const I n = adjacency[f][k];
+            if (!is_defined(n) || f < n) { func(edges[k], static_cast<I>(f), n); }
+        }
+    }
+}
+
+template <typename I>
+EdgeSoup<I> to_edge_soup(const TriangleSoup<I>& triangles, const TriangleAdjacency<I>& adjacency)
+{
+    EdgeSoup<I> result;
+    result.reserve(3 * triangles.size() / 2 + 3);
+    for_each_edge(triangles, adjacency, [&result](const Edge<I>& e, I, I) {
+        result.emplace_back(ordered_edge(e));
+    });
+    return result;
+}
+
 template <typename I>
 BordersAndInnerEdges<I> extract_borders(const TriangleSoup<I>& triangles)
 {
@@ -59,4 +208,18 @@ BordersAndInnerEdges<I> extract_borders(const TriangleSoup<I>& triangles)
     return result;
 }
 
+// Same output as extract_borders(triangles) in O(n)
+template <typename I>
+BordersAndInnerEdges<I> extract_borders(const TriangleSoup<I>& triangles, const TriangleAdjacency<I>& adjacency)
+{
+    BordersAndInnerEdges<I> result;
+    result.nb_inner_edges = 0;
+    for_each_edge(triangles, adjacency, [&result](const Edge<I>& e, I, I neighbor_face) {
+        if (is_defined(neighbor_face)) { result.nb_inner_edges++; }
+        else { result.borders.emplace_back(ordered_edge(e)); }
+    });
+    std::sort(result.borders.begin(), result.borders.end());
+    return result;
+}
+
 } // namespace graphs
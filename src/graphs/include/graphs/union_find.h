@@ -4,10 +4,11 @@
 
 #include <graphs/index.h>
 
+#include <atomic>
 #include <cassert>
 #include <cstdint>
-#include <exception>
-#include <stdexcept>
+#include <memory>
+#include <utility>
 #include <vector>
 
 namespace graphs {
@@ -15,12 +16,17 @@ namespace graphs {
 /**
  * Union-Find is a classical data structure used to represent a partition of a set of elements.
  *
- * It offers fast (O(ln n)) methods to:
+ * It offers fast methods to:
  *  - FIND the subset an element belongs to;
  *  - compute the UNION of two subsets.
  *
+ * With union by size and path halving the amortized complexity of those operations is O(alpha(n)), alpha being the inverse Ackermann function.
+ *
+ * The const find() does not compress the paths (O(ln n)), but it is safe to call it concurrently as long as no other thread modifies the structure.
+ *
  * For a presentation of this data structure:
  *  - Skiena, S. (2020). Weighted Graph Algorithms, p. 198. In: The Algorithm Design Manual. 2nd Edition. Springer.
+ *  - R.E. Tarjan and J. van Leeuwen. "Worst-case analysis of set union algorithms." Journal of the ACM 31.2 (1984): 245-281.
  */
 template <typename I = std::uint32_t>
 class UnionFind {
@@ -42,15 +48,31 @@ public:
 
     I size() const { return static_cast<I>(m_graph.size()); }
 
+    I find(I i)
+    {
+        assert(i < m_graph.size());
+        // Path halving: Each visited element is linked to its grandparent
+        I parent = m_graph[i].parent;
+        while (parent != i)
+        {
+            const I grandparent = m_graph[parent].parent;
+            m_graph[i].parent = grandparent;
+            i = grandparent;
+            parent = m_graph[i].parent;
+        }
+        return i;
+    }
+
     I find(I i) const
     {
-        I j{0};
-        const std::size_t n = m_graph.size();
-        std::size_t c = 0;
-        while((j = m_graph.at(i).parent) != i && c < n) { i = j; }
-        if (c == n)
-            throw std::logic_error("Infinite loop detected in UnionFind::find()");
-        assert(m_graph.at(i).parent == i);
+        assert(i < m_graph.size());
+        [[maybe_unused]] std::size_t c = 0;
+        I parent{0};
+        while ((parent = m_graph[i].parent) != i)
+        {
+            assert(++c < m_graph.size() && "Infinite loop detected in UnionFind::find()");
+            i = parent;
+        }
         return i;
     }
 
@@ -80,7 +102,7 @@ public:
 
     I subset_size(I i) const
     {
-        return m_graph.at(find(i)).subset_size;
+        return m_graph[find(i)].subset_size;
     }
 
 private:
@@ -92,4 +114,76 @@ private:
     std::vector<Elt> m_graph;
 };
 
+/**
+ * Concurrent Union-Find
+ *
+ * A lock-free variant of the Union-Find, which methods can be called concurrently from several threads:
+ *  - find() is wait-free. It compresses the paths with path halving, using compare-and-swap operations that are allowed to fail;
+ *  - subset_union() is lock-free. It links the root with the highest index below the other root, retrying if a concurrent union modified one of the roots.
+ *
+ * Reference:
+ *  - R.J. Anderson and H. Woll. "Wait-free parallel algorithms for the union-find problem." STOC 1991.
+ */
+template <typename I = std::uint32_t>
+class ConcurrentUnionFind {
+public:
+    using index = I;
+
+    ConcurrentUnionFind(I set_size) :
+        m_size(set_size),
+        m_parent(std::make_unique<std::atomic<I>[]>(set_size))
+    {
+        assert(set_size <= IndexTraits<I>::max_valid_index());
+        for (I idx = 0; idx < set_size; idx++)
+            m_parent[idx].store(idx, std::memory_order_relaxed);
+    }
+
+    I size() const { return m_size; }
+
+    I find(I i)
+    {
+        assert(i < m_size);
+        I parent = m_parent[i].load(std::memory_order_acquire);
+        while (parent != i)
+        {
+            I grandparent = m_parent[parent].load(std::memory_order_acquire);
+            m_parent[i].compare_exchange_weak(parent, grandparent, std::memory_order_release, std::memory_order_relaxed);
+            i = grandparent;
+            parent = m_parent[i].load(std::memory_order_acquire);
+        }
+        return i;
+    }
+
+    bool same_subset(I i, I j)
+    {
+        while (true)
+        {
+            i = find(i);
+            j = find(j);
+            if (i == j) { return true; }
+            // If i is still a root, i and j were in different subsets at the time j was found
+            if (m_parent[i].load(std::memory_order_acquire) == i) { return false; }
+        }
+    }
+
+    // Return true if the two elements were in different subsets
+    bool subset_union(I i, I j)
+    {
+        while (true)
+        {
+            i = find(i);
+            j = find(j);
+            if (i == j) { return false; }
+            if (i < j) { std::swap(i, j); }
+            // Link the root i under the root j, unless i was linked in the meantime
+            I expected = i;
+            if (m_parent[i].compare_exchange_strong(expected, j, std::memory_order_acq_rel, std::memory_order_acquire)) { return true; }
+        }
+    }
+
+private:
+    I m_size;
+    std::unique_ptr<std::atomic<I>[]> m_parent;
+};
+
 } // namespace graphs
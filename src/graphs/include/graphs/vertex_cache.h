@@ -0,0 +1,244 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <graphs/graph.h>
+#include <graphs/graph_algos.h>
+#include <graphs/index.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace graphs {
+
+/**
+ * Ordering of the faces of a triangle soup for the post-transform vertex cache of a GPU
+ *
+ * Linear-speed vertex cache optimisation (T. Forsyth, 2006): The faces are emitted greedily. Each vertex has a score that increases with
+ * its position in a simulated LRU cache and decreases with the number of its faces not emitted yet, so that the next face reuses the
+ * vertices of the latest ones, and the vertices left with few faces are completed before they are evicted. The next face is the best one
+ * among the faces of the vertices in the cache, or the first remaining face if none. The complexity is O(n) for a bounded vertex degree.
+ *
+ * The order is computed on a range of face indices, e.g. the faces of a tile, which is reordered in place.
+ *
+ * Reference:
+ *  - T. Forsyth. "Linear-Speed Vertex Cache Optimisation." 2006. https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+ */
+template <typename I, typename RandomIt>
+void vertex_cache_order(const TriangleSoup<I>& triangles, RandomIt first, RandomIt last);
+
+// Reorder the faces themselves
+template <typename I>
+void optimize_vertex_cache(TriangleSoup<I>& triangles);
+
+// Average cache miss ratio (ACMR): The number of vertex cache misses per face, with a FIFO cache of the given size. In [0.5, 3] for a
+// triangulation, 0.5 being the ideal ratio (one new vertex per two faces).
+template <typename I, typename RandomIt>
+float average_cache_miss_ratio(const TriangleSoup<I>& triangles, RandomIt first, RandomIt last, std::size_t cache_size = 16);
+
+
+//
+//
+// Implementation
+//
+//
+
+
+namespace details {
+namespace vertex_cache {
+
+constexpr std::size_t cache_size = 32;
+constexpr float cache_decay_power = 1.5f;
+constexpr float last_face_score = 0.75f;
+constexpr float valence_boost_scale = 2.f;
+constexpr float valence_boost_power = 0.5f;
+constexpr std::size_t not_in_cache = std::numeric_limits<std::size_t>::max();
+
+inline float vertex_score(std::size_t cache_pos, std::size_t nb_remaining_faces)
+{
+    if (nb_remaining_faces == 0)
+        return -1.f;
+    float score = 0.f;
+    if (cache_pos < 3)
+    {
+        // The vertices of the latest face have a fixed score, otherwise the strips would zigzag
+        score = last_face_score;
+    }
+    else if (cache_pos != not_in_cache)
+    {
+        assert(cache_pos < cache_size);
+        const float scaler = 1.f / static_cast<float>(cache_size - 3);
+        score = std::pow(1.f - static_cast<float>(cache_pos - 3) * scaler, cache_decay_power);
+    }
+    return score + valence_boost_scale * std::pow(static_cast<float>(nb_remaining_faces), -valence_boost_power);
+}
+
+} // namespace vertex_cache
+} // namespace details
+
+template <typename I, typename RandomIt>
+void vertex_cache_order(const TriangleSoup<I>& triangles, RandomIt first, RandomIt last)
+{
+    namespace vc = details::vertex_cache;
+    constexpr std::size_t no_face = std::numeric_limits<std::size_t>::max();
+    assert(first <= last);
+    const auto nb_faces = static_cast<std::size_t>(std::distance(first, last));
+    if (nb_faces < 2)
+        return;
+
+    // Local indexing of the vertices of the range
+    std::vector<I> vertices;
+    vertices.reserve(3 * nb_faces);
+    for (auto it = first; it != last; ++it)
+    {
+        const auto& t = triangles[static_cast<std::size_t>(*it)];
+        vertices.insert(vertices.end(), { t[0], t[1], t[2] });
+    }
+    details::sort_unique(vertices);
+    const std::size_t nb_vertices = vertices.size();
+    std::vector<std::array<std::size_t, 3>> faces(nb_faces);
+    for (std::size_t face_idx = 0; face_idx < nb_faces; face_idx++)
+    {
+        const auto& t = triangles[static_cast<std::size_t>(first[static_cast<std::ptrdiff_t>(face_idx)])];
+        for (std::size_t k = 0; k < 3; k++)
+            faces[face_idx][k] = static_cast<std::size_t>(std::lower_bound(vertices.cbegin(), vertices.cend(), t[k]) - vertices.cbegin());
+    }
+
+    // Faces of each vertex. The remaining faces of vertex v are vertex_faces[offsets[v], offsets[v] + nb_remaining[v]).
+    std::vector<std::size_t> offsets(nb_vertices + 1, 0);
+    for (const auto& f : faces)
+        for (const std::size_t v : f)
+            offsets[v + 1]++;
+    for (std::size_t v = 1; v <= nb_vertices; v++) { offsets[v] += offsets[v - 1]; }
+    std::vector<std::size_t> vertex_faces(offsets.back());
+    std::vector<std::size_t> nb_remaining(nb_vertices, 0);
+    for (std::size_t face_idx = 0; face_idx < nb_faces; face_idx++)
+        for (const std::size_t v : faces[face_idx])
+            vertex_faces[offsets[v] + nb_remaining[v]++] = face_idx;
+
+    std::vector<std::size_t> cache_pos(nb_vertices, vc::not_in_cache);
+    std::vector<float> vertex_score(nb_vertices);
+    for (std::size_t v = 0; v < nb_vertices; v++) { vertex_score[v] = vc::vertex_score(vc::not_in_cache, nb_remaining[v]); }
+    const auto face_score = [&faces, &vertex_score](std::size_t face_idx) {
+        const auto& f = faces[face_idx];
+        return vertex_score[f[0]] + vertex_score[f[1]] + vertex_score[f[2]];
+    };
+    std::vector<float> scores(nb_faces);
+    std::size_t best_face = 0;
+    for (std::size_t face_idx = 0; face_idx < nb_faces; face_idx++)
+    {
+        scores[face_idx] = face_score(face_idx);
+        if (scores[face_idx] > scores[best_face]) { best_face = face_idx; }
+    }
+
+    std::vector<bool> emitted(nb_faces, false);
+    std::vector<std::size_t> order;
+    order.reserve(nb_faces);
+    std::vector<std::size_t> cache;
+    std::vector<std::size_t> next_cache;
+    cache.reserve(vc::cache_size + 3);
+    next_cache.reserve(vc::cache_size + 3);
+    std::size_t next_unemitted = 0;
+    while (order.size() < nb_faces)
+    {
+        if (best_face == no_face)
+        {
+            while (emitted[next_unemitted]) { next_unemitted++; }
+            best_face = next_unemitted;
+        }
+        assert(!emitted[best_face]);
+        emitted[best_face] = true;
+        order.push_back(best_face);
+        const auto& f = faces[best_face];
+
+        // Remove the face from the remaining faces of its vertices
+        for (const std::size_t v : f)
+        {
+            const auto begin = vertex_faces.begin() + static_cast<std::ptrdiff_t>(offsets[v]);
+            const auto end = begin + static_cast<std::ptrdiff_t>(nb_remaining[v]);
+            const auto it = std::find(begin, end, best_face);
+            assert(it != end);
+            std::iter_swap(it, end - 1);
+            nb_remaining[v]--;
+        }
+
+        // The vertices of the face move to the front of the cache, which then overflows by up to 3 vertices
+        next_cache.assign(f.cbegin(), f.cend());
+        for (const std::size_t v : cache)
+        {
+            if (v != f[0] && v != f[1] && v != f[2]) { next_cache.push_back(v); }
+        }
+        for (std::size_t pos = 0; pos < next_cache.size(); pos++)
+        {
+            const std::size_t v = next_cache[pos];
+            cache_pos[v] = pos < vc::cache_size ? pos : vc::not_in_cache;
+            vertex_score[v] = vc::vertex_score(cache_pos[v], nb_remaining[v]);
+        }
+
+        // Update the score of the faces of the vertices whose score changed, and find the best one among those still in the cache
+        best_face = no_face;
+        float best_score = -std::numeric_limits<float>::max();
+        for (std::size_t pos = 0; pos < next_cache.size(); pos++)
+        {
+            const std::size_t v = next_cache[pos];
+            for (std::size_t idx = offsets[v]; idx < offsets[v] + nb_remaining[v]; idx++)
+            {
+                const std::size_t face_idx = vertex_faces[idx];
+                scores[face_idx] = face_score(face_idx);
+                if (pos < vc::cache_size && scores[face_idx] > best_score) { best_score = scores[face_idx]; best_face = face_idx; }
+            }
+        }
+        if (next_cache.size() > vc::cache_size) { next_cache.resize(vc::cache_size); }
+        std::swap(cache, next_cache);
+    }
+
+    // Apply the order to the range
+    const std::vector<typename std::iterator_traits<RandomIt>::value_type> original(first, last);
+    for (std::size_t idx = 0; idx < nb_faces; idx++) { first[static_cast<std::ptrdiff_t>(idx)] = original[order[idx]]; }
+}
+
+template <typename I>
+void optimize_vertex_cache(TriangleSoup<I>& triangles)
+{
+    std::vector<std::size_t> face_order(triangles.size());
+    for (std::size_t face_idx = 0; face_idx < face_order.size(); face_idx++) { face_order[face_idx] = face_idx; }
+    vertex_cache_order(triangles, face_order.begin(), face_order.end());
+    TriangleSoup<I> result;
+    result.reserve(triangles.size());
+    for (const std::size_t face_idx : face_order) { result.push_back(triangles[face_idx]); }
+    triangles = std::move(result);
+}
+
+template <typename I, typename RandomIt>
+float average_cache_miss_ratio(const TriangleSoup<I>& triangles, RandomIt first, RandomIt last, std::size_t cache_size)
+{
+    assert(first <= last && cache_size > 0);
+    const auto nb_faces = static_cast<std::size_t>(std::distance(first, last));
+    if (nb_faces == 0)
+        return 0.f;
+    std::vector<I> fifo(cache_size, IndexTraits<I>::undef());
+    std::size_t fifo_head = 0;
+    std::size_t nb_misses = 0;
+    for (auto it = first; it != last; ++it)
+    {
+        const auto& t = triangles[static_cast<std::size_t>(*it)];
+        for (const I v : { t[0], t[1], t[2] })
+        {
+            if (std::find(fifo.cbegin(), fifo.cend(), v) != fifo.cend()) { continue; }
+            nb_misses++;
+            fifo[fifo_head] = v;
+            fifo_head = (fifo_head + 1) % cache_size;
+        }
+    }
+    return static_cast<float>(nb_misses) / static_cast<float>(nb_faces);
+}
+
+} // namespace graphs
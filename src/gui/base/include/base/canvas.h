@@ -2,11 +2,15 @@
 // This code is distributed under the terms of the MIT License
 #pragma once
 
+#include <lin/mat.h>
+#include <lin/transform.h>
 #include <shapes/bounding_box.h>
 #include <shapes/point.h>
 #include <shapes/vect.h>
+#include <stdutils/span.h>
 
 #include <cassert>
+#include <cstddef>
 #include <type_traits>
 
 using ScreenVect = shapes::Vect2d<float>;
@@ -136,6 +140,25 @@ public:
         );
     }
 
+    // The affine transformation applied by to_screen(p), in precision F
+    lin::mat3<F> to_screen_transform() const
+    {
+        assert(scale > F{0});
+        const F tx = static_cast<F>(bb_corner.x) - scale * bb.rx.min;
+        return flip_y ?
+            lin::affine2<F>(scale, F{0}, F{0}, scale, tx, static_cast<F>(bb_corner.y) - scale * bb.ry.min) :
+            lin::affine2<F>(scale, F{0}, F{0}, -scale, tx, static_cast<F>(bb_corner.y) + scale * bb.ry.max);
+    }
+
+    // Batched version of to_screen(p), see lin::transform_points(). The output has the size of the input.
+    void to_screen(stdutils::Span<const shapes::Point2d<F>> points, stdutils::Span<ScreenPos> out) const
+    {
+        static_assert(sizeof(shapes::Point2d<F>) == 2 * sizeof(F));
+        static_assert(sizeof(ScreenPos) == 2 * sizeof(float));
+        assert(out.size() == points.size());
+        lin::transform_points(to_screen_transform(), reinterpret_cast<const F*>(points.data()), reinterpret_cast<float*>(out.data()), points.size());
+    }
+
     F to_world(const F& length) const
     {
         return length / scale;
@@ -160,6 +183,26 @@ public:
         return ScreenPos(static_cast<float>(sv.x), (flip_y ? -1.f : 1.f) * static_cast<float>(sv.y));
     }
 
+    // The affine transformation applied by to_world(p), in precision F: The inverse of to_screen_transform()
+    lin::mat3<F> to_world_transform() const
+    {
+        assert(scale > F{0});
+        const F inv_scale = F{1} / scale;
+        const F tx = bb.rx.min - static_cast<F>(bb_corner.x) * inv_scale;
+        return flip_y ?
+            lin::affine2<F>(inv_scale, F{0}, F{0}, inv_scale, tx, bb.ry.min - static_cast<F>(bb_corner.y) * inv_scale) :
+            lin::affine2<F>(inv_scale, F{0}, F{0}, -inv_scale, tx, bb.ry.max + static_cast<F>(bb_corner.y) * inv_scale);
+    }
+
+    // Batched version of to_world(p), see lin::transform_points(). The output has the size of the input.
+    void to_world(stdutils::Span<const ScreenPos> points, stdutils::Span<shapes::Point2d<F>> out) const
+    {
+        static_assert(sizeof(shapes::Point2d<F>) == 2 * sizeof(F));
+        static_assert(sizeof(ScreenPos) == 2 * sizeof(float));
+        assert(out.size() == points.size());
+        lin::transform_points(to_world_transform(), reinterpret_cast<const float*>(points.data()), reinterpret_cast<F*>(out.data()), points.size());
+    }
+
     shapes::Vect2d<F> to_world_vector(const ScreenPos& v) const
     {
         assert(scale > F{0});
@@ -0,0 +1,53 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <base/opengl_and_glfw.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Framebuffer object with a RGBA color attachment, e.g. to render in the hidden window of a headless tool. Requires an OpenGL context.
+class OffscreenFramebuffer
+{
+public:
+    OffscreenFramebuffer(int width, int height)
+        : m_framebuffer_id(0)
+        , m_renderbuffer_id(0)
+    {
+        glGenRenderbuffers(1, &m_renderbuffer_id);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffer_id);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        glGenFramebuffers(1, &m_framebuffer_id);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer_id);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_renderbuffer_id);
+        m_complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+    ~OffscreenFramebuffer()
+    {
+        glDeleteFramebuffers(1, &m_framebuffer_id);
+        glDeleteRenderbuffers(1, &m_renderbuffer_id);
+    }
+    OffscreenFramebuffer(const OffscreenFramebuffer&) = delete;
+    OffscreenFramebuffer& operator=(const OffscreenFramebuffer&) = delete;
+
+    bool complete() const { return m_complete; }
+    GLuint id() const { return m_framebuffer_id; }
+
+    void read_pixels(int width, int height, std::vector<std::uint8_t>& pixels) const
+    {
+        pixels.resize(4 * static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer_id);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    }
+
+private:
+    GLuint m_framebuffer_id;
+    GLuint m_renderbuffer_id;
+    bool m_complete{false};
+};
@@ -36,6 +36,7 @@ struct GLFWOptions
     std::string_view title{};
     bool enable_vsync{true};
     bool maximize_window{false};
+    bool visible{true};                                 // A hidden window still has an OpenGL context, e.g. to render offscreen
     unsigned int framebuffer_msaa_samples{0};         // 0 to disable multisampling
 };
 
@@ -64,6 +65,17 @@ public:
     // Set a callback for the scroll event coming from the mouse wheel or a touchpad
     void set_scroll_event_callback(ScrollEventCallback callback);
 
+    // Count the input and window events from now on, see process_events(). Call after the initialization of Dear ImGui, since the
+    // callbacks installed by its backend are chained.
+    void track_events();
+
+    // Process the pending events. If block is true, first wait for an event, for timeout_s seconds at most.
+    // Return true if any input or window event was processed, or if post_empty_event() was called, since the previous call.
+    bool process_events(bool block, double timeout_s);
+
+    // Wake up the main thread waiting in process_events(). Can be called from any thread.
+    static void post_empty_event();
+
     static void glfw_version_info(std::ostream& out);
 
 private:
@@ -99,6 +111,8 @@ void gl_enable_debug(const stdutils::io::ErrorHandler& err_handler);
 
 // Send the GLSL code without the version line
 GLuint gl_compile_shaders(const char* vertex_shader, const char* fragment_shader, const stdutils::io::ErrorHandler* err_handler = nullptr);
+// Same, with a geometry shader in between
+GLuint gl_compile_shaders(const char* vertex_shader, const char* geometry_shader, const char* fragment_shader, const stdutils::io::ErrorHandler* err_handler = nullptr);
 
 // Projection matrix
 lin::mat4f gl_orth_proj_mat(const shapes::BoundingBox3d<float>& screen_3d_bb, bool flip_y = false);
@@ -5,6 +5,7 @@
 #include <stdutils/macros.h>
 
 #include <array>
+#include <atomic>
 #include <algorithm>
 #include <cassert>
 #include <iomanip>
@@ -154,6 +155,100 @@ void glfw_scroll_event_callback(GLFWwindow* window_ptr, double xoffset, double y
     }
 }
 
+// Count of the events that need a redraw. The callbacks of the window are chained.
+struct EventCounterSingleton
+{
+    EventCounterSingleton()
+        : m_window_ptr(nullptr)
+        , m_count(0)
+        , m_chain_cursor_pos(nullptr)
+        , m_chain_cursor_enter(nullptr)
+        , m_chain_mouse_button(nullptr)
+        , m_chain_scroll(nullptr)
+        , m_chain_key(nullptr)
+        , m_chain_char(nullptr)
+        , m_chain_drop(nullptr)
+        , m_chain_window_size(nullptr)
+        , m_chain_window_focus(nullptr)
+        , m_chain_window_refresh(nullptr)
+    { }
+
+    void count(GLFWwindow* window_ptr) { if (window_ptr == m_window_ptr) { m_count.fetch_add(1, std::memory_order_relaxed); } }
+
+    GLFWwindow*                 m_window_ptr;
+    std::atomic<unsigned int>   m_count;
+    GLFWcursorposfun            m_chain_cursor_pos;
+    GLFWcursorenterfun          m_chain_cursor_enter;
+    GLFWmousebuttonfun          m_chain_mouse_button;
+    GLFWscrollfun               m_chain_scroll;
+    GLFWkeyfun                  m_chain_key;
+    GLFWcharfun                 m_chain_char;
+    GLFWdropfun                 m_chain_drop;
+    GLFWwindowsizefun           m_chain_window_size;
+    GLFWwindowfocusfun          m_chain_window_focus;
+    GLFWwindowrefreshfun        m_chain_window_refresh;
+} g_event_counter_singleton;
+
+void glfw_count_cursor_pos_event(GLFWwindow* window_ptr, double x, double y)
+{
+    g_event_counter_singleton.count(window_ptr);
+    if (g_event_counter_singleton.m_chain_cursor_pos) { g_event_counter_singleton.m_chain_cursor_pos(window_ptr, x, y); }
+}
+
+void glfw_count_cursor_enter_event(GLFWwindow* window_ptr, int entered)
+{
+    g_event_counter_singleton.count(window_ptr);
+    if (g_event_counter_singleton.m_chain_cursor_enter) { g_event_counter_singleton.m_chain_cursor_enter(window_ptr, entered); }
+}
+
+void glfw_count_mouse_button_event(GLFWwindow* window_ptr, int button, int action, int mods)
+{
+    g_event_counter_singleton.count(window_ptr);
+    if (g_event_counter_singleton.m_chain_mouse_button) { g_event_counter_singleton.m_chain_mouse_button(window_ptr, button, action, mods); }
+}
+
+void glfw_count_scroll_event(GLFWwindow* window_ptr, double xoffset, double yoffset)
+{
+    g_event_counter_singleton.count(window_ptr);
+    if (g_event_counter_singleton.m_chain_scroll) { g_event_counter_singleton.m_chain_scroll(window_ptr, xoffset, yoffset); }
+}
+
+void glfw_count_key_event(GLFWwindow* window_ptr, int key, int scancode, int action, int mods)
+{
+    g_event_counter_singleton.count(window_ptr);
+    if (g_event_counter_singleton.m_chain_key) { g_event_counter_singleton.m_chain_key(window_ptr, key, scancode, action, mods); }
+}
+
+void glfw_count_char_event(GLFWwindow* window_ptr, unsigned int codepoint)
+{
+    g_event_counter_singleton.count(window_ptr);
+    if (g_event_counter_singleton.m_chain_char) { g_event_counter_singleton.m_chain_char(window_ptr, codepoint); }
+}
+
+void glfw_count_drop_event(GLFWwindow* window_ptr, int path_count, const char* paths[])
+{
+    g_event_counter_singleton.count(window_ptr);
+    if (g_event_counter_singleton.m_chain_drop) { g_event_counter_singleton.m_chain_drop(window_ptr, path_count, paths); }
+}
+
+void glfw_count_window_size_event(GLFWwindow* window_ptr, int width, int height)
+{
+    g_event_counter_singleton.count(window_ptr);
+    if (g_event_counter_singleton.m_chain_window_size) { g_event_counter_singleton.m_chain_window_size(window_ptr, width, height); }
+}
+
+void glfw_count_window_focus_event(GLFWwindow* window_ptr, int focused)
+{
+    g_event_counter_singleton.count(window_ptr);
+    if (g_event_counter_singleton.m_chain_window_focus) { g_event_counter_singleton.m_chain_window_focus(window_ptr, focused); }
+}
+
+void glfw_count_window_refresh_event(GLFWwindow* window_ptr)
+{
+    g_event_counter_singleton.count(window_ptr);
+    if (g_event_counter_singleton.m_chain_window_refresh) { g_event_counter_singleton.m_chain_window_refresh(window_ptr); }
+}
+
 } // namespace
 
 GLFWWindowContext::GLFWWindowContext(int width, int height, const GLFWOptions& options, const stdutils::io::ErrorHandler* err_handler)
@@ -192,6 +287,8 @@ GLFWWindowContext::GLFWWindowContext(int width, int height, const GLFWOptions& o
         glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
     if (options.maximize_window)
         glfwWindowHint(GLFW_MAXIMIZED, GL_TRUE);
+    if (!options.visible)
+        glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
     if (options.framebuffer_msaa_samples > 0)
         glfwWindowHint(GLFW_SAMPLES, static_cast<int>(options.framebuffer_msaa_samples));
     assert(title.data());
@@ -297,6 +394,41 @@ void GLFWWindowContext::set_scroll_event_callback(ScrollEventCallback callback)
     g_scroll_event_singleton.m_chain_callback = glfwSetScrollCallback(m_window_ptr, glfw_scroll_event_callback);
 }
 
+void GLFWWindowContext::track_events()
+{
+    assert(m_window_ptr);
+    assert(g_event_counter_singleton.m_window_ptr == nullptr);      // Only once
+    auto& singleton = g_event_counter_singleton;
+    singleton.m_window_ptr = m_window_ptr;
+    singleton.m_count.store(1);                                     // Draw the first frame
+    singleton.m_chain_cursor_pos = glfwSetCursorPosCallback(m_window_ptr, glfw_count_cursor_pos_event);
+    singleton.m_chain_cursor_enter = glfwSetCursorEnterCallback(m_window_ptr, glfw_count_cursor_enter_event);
+    singleton.m_chain_mouse_button = glfwSetMouseButtonCallback(m_window_ptr, glfw_count_mouse_button_event);
+    singleton.m_chain_scroll = glfwSetScrollCallback(m_window_ptr, glfw_count_scroll_event);
+    singleton.m_chain_key = glfwSetKeyCallback(m_window_ptr, glfw_count_key_event);
+    singleton.m_chain_char = glfwSetCharCallback(m_window_ptr, glfw_count_char_event);
+    singleton.m_chain_drop = glfwSetDropCallback(m_window_ptr, glfw_count_drop_event);
+    singleton.m_chain_window_size = glfwSetWindowSizeCallback(m_window_ptr, glfw_count_window_size_event);
+    singleton.m_chain_window_focus = glfwSetWindowFocusCallback(m_window_ptr, glfw_count_window_focus_event);
+    singleton.m_chain_window_refresh = glfwSetWindowRefreshCallback(m_window_ptr, glfw_count_window_refresh_event);
+}
+
+bool GLFWWindowContext::process_events(bool block, double timeout_s)
+{
+    assert(g_event_counter_singleton.m_window_ptr == m_window_ptr);
+    if (block && g_event_counter_singleton.m_count.load(std::memory_order_relaxed) == 0)
+        glfwWaitEventsTimeout(timeout_s);
+    else
+        glfwPollEvents();
+    return g_event_counter_singleton.m_count.exchange(0, std::memory_order_relaxed) > 0;
+}
+
+void GLFWWindowContext::post_empty_event()
+{
+    g_event_counter_singleton.m_count.fetch_add(1, std::memory_order_relaxed);
+    glfwPostEmptyEvent();
+}
+
 void GLFWWindowContext::glfw_version_info(std::ostream& out)
 {
     out << "GLFW " << GLFW_VERSION_MAJOR << '.' << GLFW_VERSION_MINOR << '.' << GLFW_VERSION_REVISION;
@@ -604,6 +736,11 @@ namespace {
 } // namespace
 
 GLuint gl_compile_shaders(const char* vertex_shader, const char* fragment_shader, const stdutils::io::ErrorHandler* err_handler)
+{
+    return gl_compile_shaders(vertex_shader, nullptr, fragment_shader, err_handler);
+}
+
+GLuint gl_compile_shaders(const char* vertex_shader, const char* geometry_shader, const char* fragment_shader, const stdutils::io::ErrorHandler* err_handler)
 {
     std::array<const char*, 2> shader_strs;
     shader_strs[0] = TARGET_GLSL_VERSION_STR;
@@ -635,6 +772,22 @@ GLuint gl_compile_shaders(const char* vertex_shader, const char* fragment_shader
     glCompileShader(vertex_shader_id);
     if (!check_shader_compilation(vertex_shader_id, "vertex shader", trace_log, err_handler)) { return 0; }
 
+    // Compile geometry shader, if any
+    GLuint geometry_shader_id = 0u;
+    if (geometry_shader != nullptr)
+    {
+        geometry_shader_id = glCreateShader(GL_GEOMETRY_SHADER);
+        if (geometry_shader_id == 0u)
+        {
+            if (err_handler) { (*err_handler)(stdutils::io::Severity::ERR, "glCreateShader(GL_GEOMETRY_SHADER) failed"); }
+            return 0;
+        }
+        shader_strs[1] = geometry_shader;
+        glShaderSource(geometry_shader_id, 2, &shader_strs[0], nullptr);
+        glCompileShader(geometry_shader_id);
+        if (!check_shader_compilation(geometry_shader_id, "geometry shader", trace_log, err_handler)) { return 0; }
+    }
+
     // Compile fragment shader
     const GLuint fragment_shader_id = glCreateShader(GL_FRAGMENT_SHADER);
     if (fragment_shader_id == 0u)
@@ -649,6 +802,7 @@ GLuint gl_compile_shaders(const char* vertex_shader, const char* fragment_shader
 
     // Link the program
     glAttachShader(program_id, vertex_shader_id);
+    if (geometry_shader_id != 0u) { glAttachShader(program_id, geometry_shader_id); }
     glAttachShader(program_id, fragment_shader_id);
     glLinkProgram(program_id);
 
@@ -657,6 +811,11 @@ GLuint gl_compile_shaders(const char* vertex_shader, const char* fragment_shader
     glDetachShader(program_id, fragment_shader_id);
     glDeleteShader(vertex_shader_id);
     glDeleteShader(fragment_shader_id);
+    if (geometry_shader_id != 0u)
+    {
+        glDetachShader(program_id, geometry_shader_id);
+        glDeleteShader(geometry_shader_id);
+    }
 
     // Check the program
     GLint link_status;
@@ -2,33 +2,97 @@
 // This code is distributed under the terms of the MIT License
 #pragma once
 
+#include "renderer.h"
+
 #include <base/color_data.h>
 #include <shapes/shapes.h>
 
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
 struct PrimitiveProperties
 {
     PrimitiveProperties(ColorData color = { 0.f, 0.f, 0.f, 1.f }, bool draw = true) : color(color), draw(draw) {}
+    bool operator==(const PrimitiveProperties& o) const { return color == o.color && draw == o.draw; }
     ColorData color;
     bool draw;
 };
 
+// Issue a new shape version, never zero. Not thread-safe: The shapes are versioned on the main thread.
+inline std::uint64_t new_shape_version()
+{
+    static std::uint64_t latest_version = 0;
+    return ++latest_version;
+}
+
+// Vertices shared by several edge soups, e.g. the proximity graphs of a point cloud, whose own vertices are left empty.
+// The renderer uploads them once, and the edge soups only add their indices. Immutable, therefore versioned once.
+template <typename F>
+struct SharedVertices
+{
+    using scalar = F;
+    static constexpr int dim = 2;
+    explicit SharedVertices(std::vector<shapes::Point2d<F>>&& vertices) : vertices(std::move(vertices)), version(new_shape_version()) {}
+    const std::vector<shapes::Point2d<F>> vertices;
+    const std::uint64_t version;
+};
+
+// A draw command built from shared pointers also holds a reference on the shape and its vertices, so that a job running on a worker thread
+// can keep them alive instead of copying them. The references are not compared, only the pointers.
 template <typename F>
 struct DrawCommand
 {
-    DrawCommand(const shapes::AllShapes<F>& shape);
+    DrawCommand(const shapes::AllShapes<F>& shape, std::uint64_t shape_version = 0, const SharedVertices<F>* shared_vertices = nullptr);
+    DrawCommand(std::shared_ptr<const shapes::AllShapes<F>> shape, std::uint64_t shape_version = 0, std::shared_ptr<const SharedVertices<F>> shared_vertices = nullptr);
+    bool operator==(const DrawCommand<F>& o) const;
+    void release_owners() { shape_owner.reset(); shared_vertices_owner.reset(); }
     const shapes::AllShapes<F>* shape;
+    std::uint64_t shape_version;            // Changes whenever the shape is modified. Zero if the shape is not versioned.
+    const SharedVertices<F>* shared_vertices;   // If not null, the vertices of the shape (an edge soup with no vertices of its own)
+    std::shared_ptr<const shapes::AllShapes<F>> shape_owner;                // Null, or the owner of *shape
+    std::shared_ptr<const SharedVertices<F>> shared_vertices_owner;         // Null, or the owner of *shared_vertices
     PrimitiveProperties vertices;
     PrimitiveProperties edges;
     PrimitiveProperties faces;
+    renderer::ModelTransform model;         // Applied by the renderer: The shape can be moved without rebuilding its buffers
 };
 
 template <typename F>
 using DrawCommands = std::vector<DrawCommand<F>>;
 
 template <typename F>
-DrawCommand<F>::DrawCommand(const shapes::AllShapes<F>& shape)
+DrawCommand<F>::DrawCommand(const shapes::AllShapes<F>& shape, std::uint64_t shape_version, const SharedVertices<F>* shared_vertices)
     : shape(&shape)
+    , shape_version(shape_version)
+    , shared_vertices(shared_vertices)
+    , shape_owner()
+    , shared_vertices_owner()
     , vertices()
     , edges()
     , faces()
+    , model()
 { }
+
+template <typename F>
+DrawCommand<F>::DrawCommand(std::shared_ptr<const shapes::AllShapes<F>> shape, std::uint64_t shape_version, std::shared_ptr<const SharedVertices<F>> shared_vertices)
+    : shape(shape.get())
+    , shape_version(shape_version)
+    , shared_vertices(shared_vertices.get())
+    , shape_owner(std::move(shape))
+    , shared_vertices_owner(std::move(shared_vertices))
+    , vertices()
+    , edges()
+    , faces()
+    , model()
+{
+    assert(this->shape != nullptr);
+}
+
+template <typename F>
+bool DrawCommand<F>::operator==(const DrawCommand<F>& o) const
+{
+    return shape == o.shape && shape_version == o.shape_version && shared_vertices == o.shared_vertices && vertices == o.vertices && edges == o.edges && faces == o.faces && model == o.model;
+}
@@ -8,16 +8,25 @@
 
 #include <base/canvas.h>
 #include <base/color_data.h>
+#include <graphs/vertex_cache.h>
 #include <shapes/edge.h>
 #include <shapes/point_cloud.h>
 #include <shapes/path.h>
 #include <shapes/path_algos.h>
 #include <shapes/triangle.h>
+#include <shapes/vect_batch.h>
+#include <stdutils/macros.h>
+#include <stdutils/parallel.h>
+#include <stdutils/span.h>
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstddef>
 #include <cstdlib>
+#include <numeric>
 #include <utility>
+#include <vector>
 
 template <typename F>
 void draw_point_cloud(const shapes::PointCloud2d<F>& pc, renderer::DrawList& draw_list, const DrawingOptions& options);
@@ -28,6 +37,14 @@ void draw_point_path(const shapes::PointPath2d<F>& pp, renderer::DrawList& draw_
 template <typename F>
 void draw_edge_soup(const shapes::Edges2d<F>& pp, renderer::DrawList& draw_list, const DrawingOptions& options);
 
+// Append the vertices shared by several edge soups, and the indices to draw them as points, and return their block
+template <typename F>
+renderer::DrawList::Block draw_shared_vertices(const std::vector<shapes::Point2d<F>>& vertices, renderer::DrawList& draw_list);
+
+// An edge soup without vertices of its own, which indexes the block of shared vertices: Only the indices of the edges are appended
+template <typename F>
+void draw_edge_soup(const shapes::Edges2d<F>& es, const renderer::DrawList::Block& vertex_block, renderer::DrawList& draw_list, const DrawingOptions& options);
+
 template <typename F, typename I>
 void draw_triangles(const shapes::Triangles2d<F, I>& tri, renderer::DrawList& draw_list, const DrawingOptions& options);
 
@@ -41,6 +58,147 @@ void draw_triangles(const shapes::Triangles2d<F, I>& tri, renderer::DrawList& dr
 //
 
 
+namespace details {
+
+// Append n groups of Stride elements to the buffer: The buffer is resized once, then the chunks of [0, n) are filled concurrently.
+// func(idx, out) writes the Stride elements of group idx at out.
+template <std::size_t Stride, typename T, typename Func>
+void append_parallel(std::vector<T>& buffer, std::size_t n, Func func)
+{
+    const std::size_t begin_idx = buffer.size();
+    buffer.resize(begin_idx + Stride * n);
+    T* out_ptr = buffer.data() + begin_idx;
+    stdutils::parallel::for_each_chunk(stdutils::parallel::Policy(), n, [out_ptr, &func](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t idx = begin; idx < end; idx++) { func(idx, out_ptr + Stride * idx); }
+    });
+}
+
+// Convert the vertices to the renderer format
+template <typename F>
+void append_vertices(const std::vector<shapes::Point2d<F>>& vertices, std::vector<renderer::DrawList::VertexData>& buffer)
+{
+    const shapes::Point2d<F>* in_ptr = vertices.data();
+    append_parallel<1>(buffer, vertices.size(), [in_ptr](std::size_t idx, renderer::DrawList::VertexData* out) {
+        (*out)[0] = static_cast<float>(in_ptr[idx].x);
+        (*out)[1] = static_cast<float>(in_ptr[idx].y);
+    });
+}
+
+// Indices of a sequence of vertices, e.g. to draw them as points
+inline void append_vertex_indices(std::size_t begin_vertex_idx, std::size_t nb_vertices, std::vector<renderer::DrawList::HWindex>& buffer)
+{
+    append_parallel<1>(buffer, nb_vertices, [begin_vertex_idx](std::size_t idx, renderer::DrawList::HWindex* out) {
+        *out = static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + idx);
+    });
+}
+
+// Large triangulations are split in tiles of about that many faces
+constexpr std::size_t faces_per_tile = 4096;
+
+// The faces of the smaller triangulations are drawn in the order of the backend
+constexpr std::size_t vertex_cache_min_faces = 1024;
+
+inline std::size_t tile_grid_size(std::size_t nb_faces)
+{
+    if (nb_faces == 0) { return 0; }
+    return std::max(std::size_t{1}, static_cast<std::size_t>(std::sqrt(static_cast<double>(nb_faces) / static_cast<double>(faces_per_tile))));
+}
+
+// Append the indices of the faces, then those of the edges, both in the order of the tiles, and append the tiles.
+// The tile of a face is the cell of a regular grid over the bounding box of the triangulation that contains the face's centroid.
+template <typename F, typename I>
+void append_tiled_faces(const shapes::Triangles2d<F, I>& tri, std::size_t begin_vertex_idx, renderer::DrawList& draw_list)
+{
+    using renderer::DrawList;
+    const std::size_t nb_faces = tri.faces.size();
+    const std::size_t grid_size = tile_grid_size(nb_faces);
+    const std::size_t nb_tiles = grid_size * grid_size;
+    if (nb_tiles == 0) { return; }
+
+    // Counting sort of the faces by tile
+    const auto bb = shapes::bounding_box(stdutils::Span<const shapes::Point2d<F>>(tri.vertices.data(), tri.vertices.size()));
+    const auto to_cell = [grid_size](F val, F min, F length) {
+        if (!(length > F{0})) { return std::size_t{0}; }
+        const auto cell = static_cast<std::size_t>(static_cast<F>(grid_size) * (val - min) / length);
+        return std::min(cell, grid_size - 1);
+    };
+    std::vector<std::size_t> face_tile;
+    append_parallel<1>(face_tile, nb_faces, [&tri, &bb, &to_cell, grid_size](std::size_t face_idx, std::size_t* out) {
+        const auto& face = tri.faces[face_idx];
+        const F centroid_x = (tri.vertices[face[0]].x + tri.vertices[face[1]].x + tri.vertices[face[2]].x) / F{3};
+        const F centroid_y = (tri.vertices[face[0]].y + tri.vertices[face[1]].y + tri.vertices[face[2]].y) / F{3};
+        *out = to_cell(centroid_y, bb.min().y, bb.height()) * grid_size + to_cell(centroid_x, bb.min().x, bb.width());
+    });
+    std::vector<std::size_t> tile_begin(nb_tiles + 1, 0);
+    for (const std::size_t tile_idx : face_tile) { tile_begin[tile_idx + 1]++; }
+    std::partial_sum(tile_begin.cbegin(), tile_begin.cend(), tile_begin.begin());
+    std::vector<std::size_t> face_order(nb_faces);
+    {
+        std::vector<std::size_t> tile_cursor(tile_begin.cbegin(), tile_begin.cend() - 1);
+        for (std::size_t face_idx = 0; face_idx < nb_faces; face_idx++) { face_order[tile_cursor[face_tile[face_idx]]++] = face_idx; }
+    }
+
+    // Within each tile, the faces are reordered for the post-transform vertex cache of the GPU. The order of the backends is poorly localized.
+    stdutils::parallel::Policy tiles_policy;
+    tiles_policy.min_chunk_size = 1;
+    if (nb_faces >= vertex_cache_min_faces)
+    {
+        stdutils::parallel::for_each_chunk(tiles_policy, nb_tiles, [&tri, &tile_begin, &face_order](std::size_t, std::size_t begin_tile, std::size_t end_tile) {
+            for (std::size_t tile_idx = begin_tile; tile_idx < end_tile; tile_idx++)
+            {
+                const auto tile_first = face_order.begin() + static_cast<std::ptrdiff_t>(tile_begin[tile_idx]);
+                const auto tile_last = face_order.begin() + static_cast<std::ptrdiff_t>(tile_begin[tile_idx + 1]);
+                graphs::vertex_cache_order(tri.faces, tile_first, tile_last);
+            }
+        });
+    }
+
+    // Indices
+    auto& indices = draw_list.m_indices.buffer();
+    const std::size_t begin_face_indices_idx = indices.size();
+    const std::size_t begin_edge_indices_idx = begin_face_indices_idx + 3 * nb_faces;
+    append_parallel<3>(indices, nb_faces, [&tri, &face_order, begin_vertex_idx](std::size_t order_idx, DrawList::HWindex* out) {
+        const auto& face = tri.faces[face_order[order_idx]];
+        out[0] = static_cast<DrawList::HWindex>(begin_vertex_idx + face[0]);
+        out[1] = static_cast<DrawList::HWindex>(begin_vertex_idx + face[1]);
+        out[2] = static_cast<DrawList::HWindex>(begin_vertex_idx + face[2]);
+    });
+    append_parallel<6>(indices, nb_faces, [&tri, &face_order, begin_vertex_idx](std::size_t order_idx, DrawList::HWindex* out) {
+        const auto& face = tri.faces[face_order[order_idx]];
+        const auto i = static_cast<DrawList::HWindex>(begin_vertex_idx + face[0]);
+        const auto j = static_cast<DrawList::HWindex>(begin_vertex_idx + face[1]);
+        const auto k = static_cast<DrawList::HWindex>(begin_vertex_idx + face[2]);
+        out[0] = i; out[1] = j;
+        out[2] = j; out[3] = k;
+        out[4] = k; out[5] = i;
+    });
+
+    // Tiles (one chunk can hold a single tile, since each tile is a few thousands faces)
+    auto& tiles = draw_list.m_tiles.buffer();
+    const std::size_t begin_tile_idx = tiles.size();
+    tiles.resize(begin_tile_idx + nb_tiles);
+    DrawList::Tile* tiles_ptr = tiles.data() + begin_tile_idx;
+    stdutils::parallel::for_each_chunk(tiles_policy, nb_tiles, [&](std::size_t, std::size_t begin_tile, std::size_t end_tile) {
+        for (std::size_t tile_idx = begin_tile; tile_idx < end_tile; tile_idx++)
+        {
+            auto& tile = tiles_ptr[tile_idx];
+            tile.m_faces = std::make_pair(begin_face_indices_idx + 3 * tile_begin[tile_idx], begin_face_indices_idx + 3 * tile_begin[tile_idx + 1]);
+            tile.m_edges = std::make_pair(begin_edge_indices_idx + 6 * tile_begin[tile_idx], begin_edge_indices_idx + 6 * tile_begin[tile_idx + 1]);
+            for (std::size_t order_idx = tile_begin[tile_idx]; order_idx < tile_begin[tile_idx + 1]; order_idx++)
+            {
+                const auto& face = tri.faces[face_order[order_idx]];
+                for (unsigned int corner = 0; corner < 3; corner++)
+                {
+                    const auto& p = tri.vertices[face[corner]];
+                    tile.m_bounding_box.add(static_cast<float>(p.x), static_cast<float>(p.y));
+                }
+            }
+        }
+    });
+}
+
+} // namespace details
+
 template <typename F>
 void draw_point_cloud(const shapes::PointCloud2d<F>& pc, renderer::DrawList& draw_list, const DrawingOptions& options)
 {
@@ -52,14 +210,9 @@ void draw_point_cloud(const shapes::PointCloud2d<F>& pc, renderer::DrawList& dra
         assert(draw_list.m_indices.is_unlocked());
         // Vertices
         const auto begin_vertex_idx = draw_list.m_vertices.consumed();
-        std::transform(std::cbegin(pc.vertices), std::cend(pc.vertices), std::back_inserter(draw_list.m_vertices.buffer()), [](const shapes::Point2d<F>& p) {
-            return renderer::DrawList::VertexData{ static_cast<float>(p.x), static_cast<float>(p.y), 0.f };
-        });
+        details::append_vertices(pc.vertices, draw_list.m_vertices.buffer());
         // Indices
-        for (std::size_t idx = 0; idx < nb_vertices; idx++)
-        {
-            draw_list.m_indices.buffer().emplace_back(static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + idx));
-        }
+        details::append_vertex_indices(begin_vertex_idx, nb_vertices, draw_list.m_indices.buffer());
     }
 
     // Align the buffer indices
@@ -73,6 +226,7 @@ void draw_point_cloud(const shapes::PointCloud2d<F>& pc, renderer::DrawList& dra
         draw_call.m_range = std::make_pair(begin_indices_idx, end_indices_idx);
         draw_call.m_uniform_color = options.vertices.color;
         draw_call.m_uniform_point_size = std::max(1.f, options.point_options.size);
+        draw_call.m_point_color = options.point_options.color;
         draw_call.m_cmd = renderer::DrawCmd::Points;
     }
 }
@@ -93,19 +247,13 @@ void draw_point_path(const shapes::PointPath2d<F>& pp, renderer::DrawList& draw_
         assert(draw_list.m_indices.is_unlocked());
         // Vertices
         const auto begin_vertex_idx = draw_list.m_vertices.consumed();
-        std::transform(std::cbegin(pp.vertices), std::cend(pp.vertices), std::back_inserter(draw_list.m_vertices.buffer()), [](const shapes::Point2d<F>& p) {
-            return renderer::DrawList::VertexData{ static_cast<float>(p.x), static_cast<float>(p.y), 0.f };
-        });
+        details::append_vertices(pp.vertices, draw_list.m_vertices.buffer());
         // Indices
-        for (std::size_t idx = 0; idx < nb_edges; idx++)
-        {
-            draw_list.m_indices.buffer().emplace_back(static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + idx));
-            draw_list.m_indices.buffer().emplace_back(static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + ((idx + 1) % nb_vertices)));
-        }
-        for (std::size_t idx = 0; idx < nb_vertices; idx++)
-        {
-            draw_list.m_indices.buffer().emplace_back(static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + idx));
-        }
+        details::append_parallel<2>(draw_list.m_indices.buffer(), nb_edges, [begin_vertex_idx, nb_vertices](std::size_t idx, renderer::DrawList::HWindex* out) {
+            out[0] = static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + idx);
+            out[1] = static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + ((idx + 1) % nb_vertices));
+        });
+        details::append_vertex_indices(begin_vertex_idx, nb_vertices, draw_list.m_indices.buffer());
     }
 
     // Align the buffer indices
@@ -118,6 +266,7 @@ void draw_point_path(const shapes::PointPath2d<F>& pp, renderer::DrawList& draw_
         auto& draw_call = draw_list.m_draw_calls.emplace_back();
         draw_call.m_range = std::make_pair(begin_edge_indices_idx, end_edge_indices_idx);
         draw_call.m_uniform_color = options.edges.color;
+        draw_call.m_uniform_line_width = std::max(1.f, options.path_options.width);
         draw_call.m_cmd = renderer::DrawCmd::Lines;
     }
     if (options.point_options.show && options.vertices.draw)
@@ -126,6 +275,7 @@ void draw_point_path(const shapes::PointPath2d<F>& pp, renderer::DrawList& draw_
         draw_call.m_range = std::make_pair(begin_point_indices_idx, end_point_indices_idx);
         draw_call.m_uniform_color = options.vertices.color;
         draw_call.m_uniform_point_size = std::max(1.f, options.point_options.size);
+        draw_call.m_point_color = options.point_options.color;
         draw_call.m_cmd = renderer::DrawCmd::Points;
     }
 }
@@ -145,23 +295,18 @@ void draw_edge_soup(const shapes::Edges2d<F>& es, renderer::DrawList& draw_list,
         assert(draw_list.m_indices.is_unlocked());
         // Vertices
         const auto begin_vertex_idx = draw_list.m_vertices.consumed();
-        std::transform(std::cbegin(es.vertices), std::cend(es.vertices), std::back_inserter(draw_list.m_vertices.buffer()), [](const shapes::Point2d<F>& p) {
-            return renderer::DrawList::VertexData{ static_cast<float>(p.x), static_cast<float>(p.y), 0.f };
-        });
+        details::append_vertices(es.vertices, draw_list.m_vertices.buffer());
         // Indices
-        for (const auto& edge : es.indices)
-        {
-            const std::size_t i = static_cast<std::size_t>(edge[0]);
-            const std::size_t j = static_cast<std::size_t>(edge[1]);
+        details::append_parallel<2>(draw_list.m_indices.buffer(), nb_edges, [&es, begin_vertex_idx, nb_vertices](std::size_t idx, renderer::DrawList::HWindex* out) {
+            const std::size_t i = static_cast<std::size_t>(es.indices[idx][0]);
+            const std::size_t j = static_cast<std::size_t>(es.indices[idx][1]);
             assert(i < nb_vertices);
             assert(j < nb_vertices);
-            draw_list.m_indices.buffer().emplace_back(static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + i));
-            draw_list.m_indices.buffer().emplace_back(static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + j));
-        }
-        for (std::size_t i = 0; i < nb_vertices; i++)
-        {
-            draw_list.m_indices.buffer().emplace_back(static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + i));
-        }
+            UNUSED(nb_vertices);
+            out[0] = static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + i);
+            out[1] = static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + j);
+        });
+        details::append_vertex_indices(begin_vertex_idx, nb_vertices, draw_list.m_indices.buffer());
     }
 
     // Align the buffer indices
@@ -174,6 +319,7 @@ void draw_edge_soup(const shapes::Edges2d<F>& es, renderer::DrawList& draw_list,
         auto& draw_call = draw_list.m_draw_calls.emplace_back();
         draw_call.m_range = std::make_pair(begin_edge_indices_idx, end_edge_indices_idx);
         draw_call.m_uniform_color = options.edges.color;
+        draw_call.m_uniform_line_width = std::max(1.f, options.path_options.width);
         draw_call.m_cmd = renderer::DrawCmd::Lines;
     }
     if (options.point_options.show && options.vertices.draw)
@@ -182,6 +328,72 @@ void draw_edge_soup(const shapes::Edges2d<F>& es, renderer::DrawList& draw_list,
         draw_call.m_range = std::make_pair(begin_point_indices_idx, end_point_indices_idx);
         draw_call.m_uniform_color = options.vertices.color;
         draw_call.m_uniform_point_size = std::max(1.f, options.point_options.size);
+        draw_call.m_point_color = options.point_options.color;
+        draw_call.m_cmd = renderer::DrawCmd::Points;
+    }
+}
+
+template <typename F>
+renderer::DrawList::Block draw_shared_vertices(const std::vector<shapes::Point2d<F>>& vertices, renderer::DrawList& draw_list)
+{
+    assert(draw_list.m_vertices.is_unlocked());
+    assert(draw_list.m_indices.is_unlocked());
+    const std::size_t nb_vertices = vertices.size();
+    renderer::DrawList::Block block;
+    block.m_vertices.first = draw_list.m_vertices.consumed();
+    block.m_indices.first = draw_list.m_indices.consumed();
+    block.m_tiles.first = block.m_tiles.second = draw_list.m_tiles.consumed();
+    details::append_vertices(vertices, draw_list.m_vertices.buffer());
+    details::append_vertex_indices(block.m_vertices.first, nb_vertices, draw_list.m_indices.buffer());
+    draw_list.m_vertices.consume(nb_vertices);
+    draw_list.m_indices.consume(nb_vertices);
+    block.m_vertices.second = draw_list.m_vertices.consumed();
+    block.m_indices.second = draw_list.m_indices.consumed();
+    return block;
+}
+
+template <typename F>
+void draw_edge_soup(const shapes::Edges2d<F>& es, const renderer::DrawList::Block& vertex_block, renderer::DrawList& draw_list, const DrawingOptions& options)
+{
+    assert(es.vertices.empty());
+    const std::size_t nb_vertices = vertex_block.m_vertices.second - vertex_block.m_vertices.first;
+    const std::size_t nb_edges = es.indices.size();
+    const auto begin_edge_indices_idx = draw_list.m_indices.consumed();
+    const auto   end_edge_indices_idx = draw_list.m_indices.consumed() + 2 * nb_edges;
+
+    if (draw_list.m_indices.is_unlocked())
+    {
+        const auto begin_vertex_idx = vertex_block.m_vertices.first;
+        details::append_parallel<2>(draw_list.m_indices.buffer(), nb_edges, [&es, begin_vertex_idx, nb_vertices](std::size_t idx, renderer::DrawList::HWindex* out) {
+            const std::size_t i = static_cast<std::size_t>(es.indices[idx][0]);
+            const std::size_t j = static_cast<std::size_t>(es.indices[idx][1]);
+            assert(i < nb_vertices);
+            assert(j < nb_vertices);
+            UNUSED(nb_vertices);
+            out[0] = static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + i);
+            out[1] = static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + j);
+        });
+    }
+
+    // Align the buffer indices
+    draw_list.m_indices.consume(2 * nb_edges);
+
+    // The points are those of the shared block
+    if (options.path_options.show && options.edges.draw)
+    {
+        auto& draw_call = draw_list.m_draw_calls.emplace_back();
+        draw_call.m_range = std::make_pair(begin_edge_indices_idx, end_edge_indices_idx);
+        draw_call.m_uniform_color = options.edges.color;
+        draw_call.m_uniform_line_width = std::max(1.f, options.path_options.width);
+        draw_call.m_cmd = renderer::DrawCmd::Lines;
+    }
+    if (options.point_options.show && options.vertices.draw)
+    {
+        auto& draw_call = draw_list.m_draw_calls.emplace_back();
+        draw_call.m_range = vertex_block.m_indices;
+        draw_call.m_uniform_color = options.vertices.color;
+        draw_call.m_uniform_point_size = std::max(1.f, options.point_options.size);
+        draw_call.m_point_color = options.point_options.color;
         draw_call.m_cmd = renderer::DrawCmd::Points;
     }
 }
@@ -197,54 +409,43 @@ void draw_triangles(const shapes::Triangles2d<F, I>& tri, renderer::DrawList& dr
     const auto   end_edge_indices_idx  = draw_list.m_indices.consumed() + 9 * nb_faces;
     const auto begin_point_indices_idx = draw_list.m_indices.consumed() + 9 * nb_faces;
     const auto   end_point_indices_idx = draw_list.m_indices.consumed() + 9 * nb_faces + nb_vertices;
+    const auto nb_tiles = details::tile_grid_size(nb_faces) * details::tile_grid_size(nb_faces);
+    const auto tiles_range = std::make_pair(draw_list.m_tiles.consumed(), draw_list.m_tiles.consumed() + nb_tiles);
 
     if (draw_list.m_vertices.is_unlocked())
     {
         assert(draw_list.m_indices.is_unlocked());
         // Vertices
         const auto begin_vertex_idx = draw_list.m_vertices.consumed();
-        std::transform(std::cbegin(tri.vertices), std::cend(tri.vertices), std::back_inserter(draw_list.m_vertices.buffer()), [](const shapes::Point2d<F>& p) {
-            return renderer::DrawList::VertexData{ static_cast<float>(p.x), static_cast<float>(p.y), 0.f };
-        });
-        // Indices
-        for (const auto& face : tri.faces)
-        {
-            draw_list.m_indices.buffer().emplace_back(static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + face[0]));
-            draw_list.m_indices.buffer().emplace_back(static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + face[1]));
-            draw_list.m_indices.buffer().emplace_back(static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + face[2]));
-        }
-        for (const auto& face : tri.faces)
-        {
-            draw_list.m_indices.buffer().emplace_back(static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + face[0]));
-            draw_list.m_indices.buffer().emplace_back(static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + face[1]));
-            draw_list.m_indices.buffer().emplace_back(static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + face[1]));
-            draw_list.m_indices.buffer().emplace_back(static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + face[2]));
-            draw_list.m_indices.buffer().emplace_back(static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + face[2]));
-            draw_list.m_indices.buffer().emplace_back(static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + face[0]));
-        }
-        for (std::size_t idx = 0; idx < nb_vertices; idx++)
-        {
-            draw_list.m_indices.buffer().emplace_back(static_cast<renderer::DrawList::HWindex>(begin_vertex_idx + idx));
-        }
+        details::append_vertices(tri.vertices, draw_list.m_vertices.buffer());
+        // Indices of the faces and the edges, by tile
+        details::append_tiled_faces(tri, begin_vertex_idx, draw_list);
+        // Indices of the points
+        details::append_vertex_indices(begin_vertex_idx, nb_vertices, draw_list.m_indices.buffer());
     }
 
     // Align the buffer indices
     draw_list.m_vertices.consume(nb_vertices);
     draw_list.m_indices.consume(9 * nb_faces + nb_vertices);
+    draw_list.m_tiles.consume(nb_tiles);
 
     // Show/no_show is decided by the presence of a DrawCmd (do not modify the vertices and indices buffers)
     if (options.surface_options.show && options.faces.draw)
     {
         auto& draw_call = draw_list.m_draw_calls.emplace_back();
         draw_call.m_range = std::make_pair(begin_face_indices_idx, end_face_indices_idx);
+        draw_call.m_tiles = tiles_range;
         draw_call.m_uniform_color = options.faces.color;
+        draw_call.m_face_color = options.surface_options.color;
         draw_call.m_cmd = renderer::DrawCmd::Triangles;
     }
     if (options.path_options.show && options.edges.draw)
     {
         auto& draw_call = draw_list.m_draw_calls.emplace_back();
         draw_call.m_range = std::make_pair(begin_edge_indices_idx, end_edge_indices_idx);
+        draw_call.m_tiles = tiles_range;
         draw_call.m_uniform_color = options.edges.color;
+        draw_call.m_uniform_line_width = std::max(1.f, options.path_options.width);
         draw_call.m_cmd = renderer::DrawCmd::Lines;
     }
     if (options.point_options.show && options.vertices.draw)
@@ -253,6 +454,7 @@ void draw_triangles(const shapes::Triangles2d<F, I>& tri, renderer::DrawList& dr
         draw_call.m_range = std::make_pair(begin_point_indices_idx, end_point_indices_idx);
         draw_call.m_uniform_color = options.vertices.color;
         draw_call.m_uniform_point_size = std::max(1.f, options.point_options.size);
+        draw_call.m_point_color = options.point_options.color;
         draw_call.m_cmd = renderer::DrawCmd::Points;
     }
 }
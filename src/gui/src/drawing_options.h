@@ -3,6 +3,7 @@
 #pragma once
 
 #include "draw_command.h"
+#include "renderer.h"
 
 struct DrawingOptions
 {
@@ -10,15 +11,21 @@ struct DrawingOptions
     {
         bool show;
         float size;
+        renderer::PointColor color;
+        bool operator==(const Point& o) const { return show == o.show && size == o.size && color == o.color; }
     };
     struct Path
     {
         bool show;
+        float width;
+        bool operator==(const Path& o) const { return show == o.show && width == o.width; }
     };
     struct Surface
     {
         bool show;
         float alpha;
+        renderer::FaceColor color;
+        bool operator==(const Surface& o) const { return show == o.show && alpha == o.alpha && color == o.color; }
     };
 
     // Global
@@ -30,4 +37,10 @@ struct DrawingOptions
     PrimitiveProperties vertices{};
     PrimitiveProperties edges{};
     PrimitiveProperties faces{};
+
+    bool operator==(const DrawingOptions& o) const
+    {
+        return point_options == o.point_options && path_options == o.path_options && surface_options == o.surface_options
+            && vertices == o.vertices && edges == o.edges && faces == o.faces;
+    }
 };
@@ -0,0 +1,134 @@
+#include "file_watcher.h"
+
+#include <base/opengl_and_glfw.h>
+
+#include <cassert>
+#include <exception>
+#include <sstream>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+FileWatcher::FileWatcher(const std::vector<std::filesystem::path>& paths, const std::vector<std::size_t>& file_nb_shapes, FileLoader file_loader, std::chrono::milliseconds poll_period)
+    : m_file_loader(std::move(file_loader))
+    , m_poll_period(poll_period)
+    , m_files()
+    , m_mutex()
+    , m_stop_cv()
+    , m_stop(false)
+    , m_log()
+    , m_job()
+{
+    assert(paths.size() == file_nb_shapes.size());
+    m_files.reserve(paths.size());
+    for (std::size_t idx = 0; idx < paths.size(); idx++)
+    {
+        const auto stamp = file_stamp(paths[idx]);
+        m_files.push_back(WatchedFile{ paths[idx], file_nb_shapes[idx], stamp, stamp, FileStamp(), false, shapes::io::ShapeAggregate<double>() });
+    }
+    m_job = std::async(std::launch::async, [this]() { poll(); });
+}
+
+FileWatcher::~FileWatcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_stop_cv.notify_all();
+}
+
+FileWatcher::FileStamp FileWatcher::file_stamp(const std::filesystem::path& path)
+{
+    FileStamp result;
+    std::error_code ec;
+    result.write_time = std::filesystem::last_write_time(path, ec);
+    if (ec) { return FileStamp(); }
+    result.size = std::filesystem::file_size(path, ec);
+    if (ec) { return FileStamp(); }
+    result.exists = true;
+    return result;
+}
+
+void FileWatcher::poll()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop_cv.wait_for(lock, m_poll_period, [this]() { return m_stop; }))
+    {
+        lock.unlock();
+        for (auto& file : m_files)
+        {
+            // Wait for the writer to be done with the file
+            const auto stamp = file_stamp(file.path);
+            const bool is_stable = stamp == file.polled_stamp;
+            file.polled_stamp = stamp;
+            if (!is_stable || !stamp.exists || stamp == file.loaded_stamp)
+                continue;
+
+            stdutils::io::ErrorLog file_log;
+            bool has_error = false;
+            const stdutils::io::ErrorHandler file_err_handler = [log_handler = file_log.handler(), &has_error](stdutils::io::SeverityCode code, std::string_view msg) {
+                if (code <= stdutils::io::Severity::ERR) { has_error = true; }
+                log_handler(code, msg);
+            };
+            shapes::io::ShapeAggregate<double> file_shapes;
+            try
+            {
+                file_shapes = m_file_loader(file.path, file_err_handler);
+            }
+            catch (const std::exception& e)
+            {
+                std::stringstream out;
+                out << "While reloading file " << file.path << ": " << e.what();
+                file_err_handler(stdutils::io::Severity::EXCPT, out.str());
+            }
+            if (has_error)
+            {
+                // E.g. the file was caught in the middle of a rewrite: Keep the previous shapes, and retry on the next poll. The errors are
+                // reported once per version of the file.
+                if (stamp != file.failed_stamp)
+                {
+                    std::lock_guard<std::mutex> reload_lock(m_mutex);
+                    file_log.forward(m_log.handler());
+                }
+                file.failed_stamp = stamp;
+                continue;
+            }
+            file.loaded_stamp = stamp;
+            {
+                // A reload not collected yet is replaced by the latest one
+                std::lock_guard<std::mutex> reload_lock(m_mutex);
+                file_log.forward(m_log.handler());
+                file.reload = std::move(file_shapes);
+                file.has_reload = true;
+            }
+            GLFWWindowContext::post_empty_event();          // Wake up the idle main loop
+        }
+        lock.lock();
+    }
+}
+
+std::vector<FileWatcher::Reload> FileWatcher::collect(const stdutils::io::ErrorHandler& err_handler)
+{
+    std::vector<Reload> result;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_log.forward(err_handler);
+    m_log.clear();
+    std::size_t first_shape_idx = 0;
+    for (auto& file : m_files)
+    {
+        if (file.has_reload)
+        {
+            auto& reload = result.emplace_back();
+            reload.path = file.path;
+            reload.first_shape_idx = first_shape_idx;
+            reload.nb_replaced_shapes = file.nb_shapes;
+            reload.shapes = std::move(file.reload);
+            file.reload.clear();
+            file.has_reload = false;
+            file.nb_shapes = reload.shapes.size();
+        }
+        first_shape_idx += file.nb_shapes;
+    }
+    return result;
+}
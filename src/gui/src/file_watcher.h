@@ -0,0 +1,78 @@
+#pragma once
+
+#include <shapes/io.h>
+#include <stdutils/io.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <vector>
+
+/**
+ * Watch the input files, e.g. those rewritten continuously by an upstream tool, and reload them in the background
+ *
+ * A worker thread polls the modification time and the size of the files. A file that changed is reloaded once its writer is done, that is
+ * once its time and size are the same on two consecutive polls. The main loop collects the shapes of the reloaded files, along with the range
+ * of the input shapes that they replace: The input shapes of the files are contiguous and in the order of the files. A file whose reload
+ * reports an error keeps its previous shapes, and is reloaded again on the next poll.
+ */
+class FileWatcher
+{
+public:
+    using FileLoader = std::function<shapes::io::ShapeAggregate<double>(const std::filesystem::path&, const stdutils::io::ErrorHandler&)>;
+
+    struct Reload
+    {
+        std::filesystem::path path;
+        std::size_t first_shape_idx{0};
+        std::size_t nb_replaced_shapes{0};                  // The number of input shapes of the file before the reload
+        shapes::io::ShapeAggregate<double> shapes;
+    };
+
+    // file_nb_shapes is the number of input shapes loaded from each file
+    FileWatcher(const std::vector<std::filesystem::path>& paths, const std::vector<std::size_t>& file_nb_shapes, FileLoader file_loader, std::chrono::milliseconds poll_period = std::chrono::milliseconds(250));
+    ~FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // The files reloaded since the previous call, in the order of the files: The ranges of the input shapes assume that the reloads are applied
+    // in that order. Their messages are forwarded to err_handler.
+    std::vector<Reload> collect(const stdutils::io::ErrorHandler& err_handler);
+
+private:
+    struct FileStamp
+    {
+        std::filesystem::file_time_type write_time{};
+        std::uintmax_t size{0};
+        bool exists{false};
+        bool operator==(const FileStamp& o) const { return write_time == o.write_time && size == o.size && exists == o.exists; }
+        bool operator!=(const FileStamp& o) const { return !(*this == o); }
+    };
+    struct WatchedFile
+    {
+        std::filesystem::path path;
+        std::size_t nb_shapes;                              // Accessed by the main thread only
+        FileStamp loaded_stamp;                             // Accessed by the worker thread only
+        FileStamp polled_stamp;                             // Idem
+        FileStamp failed_stamp;                             // Idem. The last version of the file that could not be reloaded.
+        bool has_reload;                                    // Protected by the mutex, along with the reload below
+        shapes::io::ShapeAggregate<double> reload;
+    };
+
+    static FileStamp file_stamp(const std::filesystem::path& path);
+    void poll();
+
+    const FileLoader m_file_loader;
+    const std::chrono::milliseconds m_poll_period;
+    std::vector<WatchedFile> m_files;
+    std::mutex m_mutex;                                     // Protects the reloads, the log and the stop flag
+    std::condition_variable m_stop_cv;
+    bool m_stop;
+    stdutils::io::ErrorLog m_log;
+    std::future<void> m_job;                                // Last member, so that it is destroyed first
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <chrono>
+
+/**
+ * Time budget of the expensive work of a frame
+ *
+ * The tasks of the main loop that can be sliced (the segmentation of the CBPs entering the view, the uploads to the GPU buffers) check
+ * the budget cooperatively: Once it is spent, the rest of their work is carried over to the next frames, so that the frame rate stays
+ * stable on heavy scenes. Each task makes some progress on every frame, even if the budget was already spent.
+ */
+class FrameBudget
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Unlimited budget
+    FrameBudget() : m_deadline(Clock::time_point::max()) {}
+
+    // A zero budget is unlimited
+    FrameBudget(Clock::time_point frame_start, float budget_ms)
+        : m_deadline(budget_ms > 0.f ? frame_start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float, std::milli>(budget_ms)) : Clock::time_point::max())
+    {}
+
+    Clock::time_point deadline() const { return m_deadline; }
+    bool is_spent() const { return m_deadline != Clock::time_point::max() && Clock::now() >= m_deadline; }
+
+private:
+    Clock::time_point m_deadline;
+};
@@ -10,13 +10,18 @@
 #include "argagg_wrap.h"
 #include "drawing_settings.h"
 #include "dt_tracker.h"
+#include "file_watcher.h"
+#include "frame_budget.h"
+#include "performance_window.h"
 #include "project.h"
 #include "renderer.h"
 #include "renderer_helpers.h"
+#include "session.h"
 #include "settings.h"
 #include "settings_window.h"
 #include "shape_control_window.h"
 #include "style.h"
+#include "thumbnails.h"
 #include "viewport_window.h"
 
 #include <base/canvas.h>
@@ -30,23 +35,35 @@
 #include <shapes/bounding_box_algos.h>
 #include <shapes/io.h>
 #include <stdutils/algorithm.h>
+#include <stdutils/chrono.h>
 #include <stdutils/io.h>
+#include <stdutils/log_sink.h>
 #include <stdutils/macros.h>
+#include <stdutils/memory.h>
+#include <stdutils/parallel.h>
 #include <stdutils/platform.h>
+#include <stdutils/profiler.h>
+#include <stdutils/string.h>
 #include <stdutils/time.h>
 #include <svg/svg.h>
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdlib>
 #include <filesystem>
+#include <future>
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <system_error>
 #include <vector>
 
 namespace {
@@ -76,12 +93,19 @@ std::string_view project_title()
 argagg::parser argparser{ {
     { "help", { "-h", "--help" }, "Print usage note and exit", 0 },
     { "version", { "--version" }, "Print version and exit", 0 },
-    { "platform", { "--platform" }, "Print platform information and exit", 0 }
+    { "platform", { "--platform" }, "Print platform information and exit", 0 },
+    { "profile", { "--profile" }, "Record the profiler zones and save them to a file in the Chrome trace format on exit. Requires a build with DELAUNAY_VIEWER_PROFILING", 1 },
+    { "frame-budget", { "--frame-budget" }, "Time budget in milliseconds of the expensive work of a frame (segmentation of the curves, uploads to the GPU), the rest being carried over to the next frames. Zero for no limit. (Default: 8)", 1 },
+    { "no-session", { "--no-session" }, "Do not restore the session of the previous run, nor save the current one on exit", 0 },
+    { "render", { "--render" }, "Render the triangulation of each input file to a PNG image in that directory, without the GUI, then exit", 1 },
+    { "render-size", { "--render-size" }, "Width and height in pixels of the images of --render. (Default: 512)", 1 },
+    { "watch", { "--watch" }, "Watch the input files, and reload them when they are modified. Only the shapes that changed are updated.", 0 }
 } };
 
 void usage_notes(std::ostream& out)
 {
     out << project_title() << "\n\n";
+    out << "Usage: delaunay_viewer [options] [input files (DAT, CDT, SHB or SVG)]\n\n";
     out << "Options:\n\n";
     out << argparser;
 }
@@ -106,21 +130,310 @@ argagg::parser_results parse_command_line(int argc, char *argv[])
 
 using scalar = ViewportWindow::scalar;
 
+// The converted SVG paths are cached in the temporary directory. Return an empty path if there is none.
+const std::filesystem::path& svg_cache_dir()
+{
+    static const std::filesystem::path cache_dir = []() {
+        std::error_code err_code;
+        const auto tmp_dir = std::filesystem::temp_directory_path(err_code);
+        return err_code ? std::filesystem::path() : tmp_dir / project::get_name() / "svg_cache";
+    }();
+    return cache_dir;
+}
+
+shapes::io::ShapeAggregate<scalar> load_svg_file(const std::filesystem::path& path, const stdutils::io::ErrorHandler& err_handler)
+{
+    shapes::io::ShapeAggregate<scalar> result;
+    auto file_paths = svg_cache_dir().empty()
+        ? svg::io::parse_svg_paths(path, err_handler)
+        : svg::io::parse_svg_paths(path, svg_cache_dir(), err_handler);
+    std::stringstream out;
+    out << "Nb of point paths: " << file_paths.point_paths.size() << ". Nb of cubic bezier paths: " << file_paths.cubic_bezier_paths.size() << ".";
+    err_handler(stdutils::io::Severity::INFO, out.str());
+    result.reserve(file_paths.point_paths.size() + file_paths.cubic_bezier_paths.size());
+    for (auto& pp : file_paths.point_paths)
+        result.emplace_back(std::move(pp));
+    for (auto& cbp : file_paths.cubic_bezier_paths)
+        result.emplace_back(std::move(cbp));
+    return result;
+}
+
+// Load the files concurrently, and concatenate their shapes in the order of the input paths
+template <typename FileLoader>
+shapes::io::ShapeAggregate<scalar> load_files(const std::vector<std::filesystem::path>& paths, FileLoader file_loader, const stdutils::io::ErrorHandler& err_handler)
+{
+    shapes::io::ShapeAggregate<scalar> result;
+    std::vector<shapes::io::ShapeAggregate<scalar>> file_shapes(paths.size());
+    std::vector<stdutils::io::ErrorLog> logs(paths.size());
+    try
+    {
+        stdutils::parallel::for_each_ordered(stdutils::parallel::Policy(), paths.size(), [&](std::size_t idx) {
+            file_shapes[idx] = file_loader(paths[idx], logs[idx].handler());
+        }, [&](std::size_t idx) {
+            std::cout << "Loaded file " << paths[idx] << " (" << (idx + 1) << "/" << paths.size() << ")" << std::endl;
+            logs[idx].forward(err_handler);
+            std::move(std::begin(file_shapes[idx]), std::end(file_shapes[idx]), std::back_inserter(result));
+            file_shapes[idx].clear();
+        });
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream out;
+        out << "While loading files: " << e.what();
+        err_handler(stdutils::io::Severity::EXCPT, out.str());
+    }
+    return result;
+}
+
+std::string files_name(const std::vector<std::filesystem::path>& paths)
+{
+    assert(!paths.empty());
+    std::stringstream out;
+    out << paths.front().filename().string();
+    if (paths.size() > 1) { out << " (+" << (paths.size() - 1) << ")"; }
+    return out.str();
+}
+
+shapes::io::ShapeAggregate<scalar> load_cdt_file(const std::filesystem::path& path, const stdutils::io::ErrorHandler& err_handler)
+{
+    shapes::io::ShapeAggregate<scalar> result;
+    const auto point_dim = shapes::io::cdt::peek_point_dimension(path, err_handler);
+    if (point_dim != 2 && point_dim != 3)
+    {
+        err_handler(stdutils::io::Severity::ERR, "Only support 2D or 3D points");
+        return result;
+    }
+    shapes::Soup2d<scalar> cdt_shapes;
+    if (point_dim == 3)
+    {
+        // See parse_3d_shapes_projected_from_stream()
+        err_handler(stdutils::io::Severity::INFO, "The 3D points are projected on the XY plane");
+        cdt_shapes = shapes::io::cdt::parse_3d_shapes_projected_from_file(path, shapes::io::cdt::Projection(), err_handler);
+    }
+    else
+    {
+        cdt_shapes = shapes::io::cdt::parse_2d_shapes_from_file(path, err_handler);
+    }
+    if (!cdt_shapes.point_cloud.vertices.empty())
+    {
+        result.emplace_back(std::move(cdt_shapes.point_cloud));
+    }
+    if (!cdt_shapes.edges.vertices.empty())
+    {
+        auto point_paths = shapes::extract_paths(cdt_shapes.edges);
+        for (auto& pp: point_paths) { result.emplace_back(std::move(pp)); }
+    }
+    // Ignore Triangles2d
+    return result;
+}
+
+// Any of the input formats, depending on the extension of the file
+shapes::io::ShapeAggregate<scalar> load_input_file(const std::filesystem::path& path, const stdutils::io::ErrorHandler& err_handler)
+{
+    const std::string ext = stdutils::string::tolower(path.extension().string());
+    if (ext == ".dat")
+        return shapes::io::dat::parse_shapes_from_file(path, err_handler);
+    if (ext == ".cdt")
+        return load_cdt_file(path, err_handler);
+    if (ext == shapes::io::shb::FILE_EXTENSION)
+        return shapes::io::shb::parse_shapes_from_file(path, err_handler);
+    if (ext == ".svg")
+        return load_svg_file(path, err_handler);
+    std::stringstream out;
+    out << "Unknown file extension: " << path;
+    err_handler(stdutils::io::Severity::ERR, out.str());
+    return shapes::io::ShapeAggregate<scalar>();
+}
+
+void filter_2d_shapes(shapes::io::ShapeAggregate<scalar>& shapes, const stdutils::io::ErrorHandler& err_handler)
+{
+    stdutils::erase_if(shapes, [&err_handler](const auto& shape_wrapper) {
+        const auto& shape = shape_wrapper.shape;
+        if (shapes::get_dimension(shape) != 2)
+        {
+            std::stringstream out;
+            out << "Input shape of type " << shapes::get_type_str(shape) << " is not supported and was filtered out";
+            err_handler(stdutils::io::Severity::ERR, out.str());
+            return true;
+        }
+        return false;
+    });
+}
+
+// Load the input files on a worker thread, so that the GUI shows up immediately. The files are parsed concurrently, and the main loop
+// collects the shapes of each one as soon as it is loaded, in the order of the paths. The shapes of the DAT files are parsed one at a
+// time: Those of the first file not loaded yet are collected as they are parsed, so that the viewport shows them while the file loads.
+class BackgroundLoader
+{
+public:
+    explicit BackgroundLoader(std::vector<std::filesystem::path>&& paths);
+    ~BackgroundLoader();
+    BackgroundLoader(const BackgroundLoader&) = delete;
+    BackgroundLoader& operator=(const BackgroundLoader&) = delete;
+
+    // The shapes of the files loaded since the previous call. Their messages are forwarded to err_handler.
+    shapes::io::ShapeAggregate<scalar> collect(const stdutils::io::ErrorHandler& err_handler);
+
+    // The files not started yet are skipped. The destructor then only waits for the files being parsed.
+    void cancel() { m_cancelled = true; }
+
+    // All the files are loaded, and their shapes collected
+    bool done();
+
+    const std::string& name() const { return m_name; }
+    const std::vector<std::filesystem::path>& paths() const { return m_paths; }
+    std::size_t nb_files() const { return m_paths.size(); }
+    std::size_t nb_loaded() const;
+
+    // The number of shapes collected from each file. Complete once done().
+    const std::vector<std::size_t>& file_nb_shapes() const { return m_file_nb_shapes; }
+
+private:
+    void load();
+    void load_file(std::size_t idx, shapes::io::ShapeAggregate<scalar>& file_shapes, const stdutils::io::ErrorHandler& err_handler);
+
+    const std::vector<std::filesystem::path> m_paths;
+    const std::string m_name;
+    std::atomic<bool> m_cancelled;
+    mutable std::mutex m_mutex;                         // Protects the members below
+    shapes::io::ShapeAggregate<scalar> m_loaded_shapes;
+    stdutils::io::ErrorLog m_loaded_log;
+    std::size_t m_nb_loaded;                            // Also the index of the file whose shapes are collected as they are parsed
+    std::vector<std::size_t> m_file_nb_shapes;          // Each file's count is written by its own task
+    std::future<void> m_job;                            // Last member, so that it is destroyed first
+};
+
+BackgroundLoader::BackgroundLoader(std::vector<std::filesystem::path>&& paths)
+    : m_paths(std::move(paths))
+    , m_name(files_name(m_paths))
+    , m_cancelled(false)
+    , m_mutex()
+    , m_loaded_shapes()
+    , m_loaded_log()
+    , m_nb_loaded(0)
+    , m_file_nb_shapes(m_paths.size(), 0)
+    , m_job()
+{
+    m_job = std::async(std::launch::async, [this]() { load(); });
+}
+
+BackgroundLoader::~BackgroundLoader()
+{
+    cancel();
+}
+
+void BackgroundLoader::load_file(std::size_t idx, shapes::io::ShapeAggregate<scalar>& file_shapes, const stdutils::io::ErrorHandler& err_handler)
+{
+    const auto& path = m_paths[idx];
+    if (stdutils::string::tolower(path.extension().string()) != ".dat")
+    {
+        auto loaded_shapes = load_input_file(path, err_handler);
+        filter_2d_shapes(loaded_shapes, err_handler);
+        m_file_nb_shapes[idx] = loaded_shapes.size();
+        std::lock_guard<std::mutex> lock(m_mutex);         // Also accessed by the completion of the previous file
+        file_shapes = std::move(loaded_shapes);
+        return;
+    }
+    shapes::io::dat::parse_shapes_from_file(path, [this, idx, &file_shapes, &err_handler](shapes::io::ShapeWrapper<scalar>&& shape_wrapper) {
+        shapes::io::ShapeAggregate<scalar> parsed_shape;
+        parsed_shape.emplace_back(std::move(shape_wrapper));
+        filter_2d_shapes(parsed_shape, err_handler);
+        if (parsed_shape.empty()) { return !m_cancelled; }
+        m_file_nb_shapes[idx]++;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_nb_loaded == idx && file_shapes.empty())
+        {
+            m_loaded_shapes.emplace_back(std::move(parsed_shape.front()));
+            GLFWWindowContext::post_empty_event();      // Wake up the idle main loop
+        }
+        else
+        {
+            file_shapes.emplace_back(std::move(parsed_shape.front()));
+        }
+        return !m_cancelled;
+    }, err_handler);
+}
+
+void BackgroundLoader::load()
+{
+    std::vector<shapes::io::ShapeAggregate<scalar>> file_shapes(m_paths.size());
+    std::vector<stdutils::io::ErrorLog> logs(m_paths.size());
+    try
+    {
+        stdutils::parallel::for_each_ordered(stdutils::parallel::Policy(), m_paths.size(), [&](std::size_t idx) {
+            if (m_cancelled) { return; }
+            load_file(idx, file_shapes[idx], logs[idx].handler());
+        }, [&](std::size_t idx) {
+            std::stringstream out;
+            out << "Loaded file " << m_paths[idx] << " (" << (idx + 1) << "/" << m_paths.size() << ")";
+            {
+                // The shapes parsed before the file became the first one not loaded yet, if any
+                std::lock_guard<std::mutex> lock(m_mutex);
+                logs[idx].forward(m_loaded_log.handler());
+                if (!m_cancelled) { m_loaded_log.handler()(stdutils::io::Severity::INFO, out.str()); }
+                std::move(std::begin(file_shapes[idx]), std::end(file_shapes[idx]), std::back_inserter(m_loaded_shapes));
+                file_shapes[idx].clear();
+                m_nb_loaded++;
+                if (m_nb_loaded < m_paths.size())
+                {
+                    // The shapes of the next file parsed so far
+                    std::move(std::begin(file_shapes[m_nb_loaded]), std::end(file_shapes[m_nb_loaded]), std::back_inserter(m_loaded_shapes));
+                    file_shapes[m_nb_loaded].clear();
+                }
+            }
+            GLFWWindowContext::post_empty_event();      // Wake up the idle main loop
+        });
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream out;
+        out << "While loading files: " << e.what();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_loaded_log.handler()(stdutils::io::Severity::EXCPT, out.str());
+    }
+}
+
+shapes::io::ShapeAggregate<scalar> BackgroundLoader::collect(const stdutils::io::ErrorHandler& err_handler)
+{
+    shapes::io::ShapeAggregate<scalar> result;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_loaded_log.forward(err_handler);
+    m_loaded_log.clear();
+    std::swap(result, m_loaded_shapes);
+    return result;
+}
+
+bool BackgroundLoader::done()
+{
+    if (m_job.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return false;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_loaded_shapes.empty() && m_loaded_log.empty();
+}
+
+std::size_t BackgroundLoader::nb_loaded() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nb_loaded;
+}
+
 // Application windows
 struct AppWindows
 {
     std::unique_ptr<SettingsWindow> settings;
     std::unique_ptr<ViewportWindow> viewport;
     std::unique_ptr<ShapeWindow> shape_control;
+    std::unique_ptr<PerformanceWindow> performance;
     struct
     {
         WindowLayout settings;
         WindowLayout viewport;
         WindowLayout shape_control;
+        WindowLayout performance;
     } layout;
 };
 
-void main_menu_bar(AppWindows& windows, renderer::Draw2D& renderer, const DtTracker<scalar>& dt_tracker, bool& application_should_close, bool& gui_dark_mode)
+void main_menu_bar(AppWindows& windows, renderer::Draw2D& renderer, AsyncDrawList<scalar>& async_draw_list, const DtTracker<scalar>& dt_tracker, const BackgroundLoader* background_loader, bool& application_should_close, bool& gui_dark_mode)
 {
     std::string filename = "no_file";
     application_should_close = false;
@@ -139,70 +452,49 @@ void main_menu_bar(AppWindows& windows, renderer::Draw2D& renderer, const DtTrac
                 for (const auto& path : paths)
                 {
                     std::cout << "User selected CDT file " << path << std::endl;
-                    if (shapes::io::cdt::peek_point_dimension(path, io_err_handler) == 2)
-                    {
-                        auto cdt_shapes = shapes::io::cdt::parse_2d_shapes_from_file(path, io_err_handler);
-                        filename = path.filename().string();
-                        shapes.clear();
-                        if (!cdt_shapes.point_cloud.vertices.empty())
-                        {
-                            shapes.emplace_back(std::move(cdt_shapes.point_cloud));
-                        }
-                        if (!cdt_shapes.edges.vertices.empty())
-                        {
-                            auto point_paths = shapes::extract_paths(cdt_shapes.edges);
-                            for (auto& pp: point_paths) { shapes.emplace_back(std::move(pp)); }
-                        }
-                        // Ignore Triangles2d
-                    }
-                    else
-                    {
-                        io_err_handler(stdutils::io::Severity::ERR, "Only support 2D points");
-                    }
+                    filename = path.filename().string();
+                    shapes = load_cdt_file(path, io_err_handler);
                 }
             }
             if (ImGui::MenuItem("Open DAT"))
             {
                 const auto paths = pfd::source_paths(
-                    pfd::open_file("Select a DAT file", "", { "DAT file", "*.dat", "All files", "*.*" })
+                    pfd::open_file("Select DAT files", "", { "DAT file", "*.dat", "All files", "*.*" }, pfd::opt::multiselect)
                 );
-                for (const auto& path : paths)
+                if (!paths.empty())
                 {
-                    std::cout << "User selected DAT file " << path << std::endl;
-                    filename = path.filename().string();
-                    shapes = shapes::io::dat::parse_shapes_from_file(path, io_err_handler);
+                    std::cout << "User selected " << paths.size() << " DAT file(s)" << std::endl;
+                    filename = files_name(paths);
+                    shapes = load_files(paths, [](const std::filesystem::path& path, const stdutils::io::ErrorHandler& err_handler) {
+                        return shapes::io::dat::parse_shapes_from_file(path, err_handler);
+                    }, io_err_handler);
                 }
             }
-            if (ImGui::MenuItem("Open SVG"))
+            if (ImGui::MenuItem("Open SHB"))
             {
                 const auto paths = pfd::source_paths(
-                    pfd::open_file("Select a SVG file", "", { "SVG file", "*.svg" })
+                    pfd::open_file("Select a SHB file", "", { "SHB file", "*.shb", "All files", "*.*" })
                 );
                 for (const auto& path : paths)
                 {
-                    std::cout << "User selected SVG file " << path << std::endl;
-                    auto file_paths = svg::io::parse_svg_paths(path, io_err_handler);
-                    std::cout << "Nb of point paths: " << file_paths.point_paths.size() << ". Nb of cubic bezier paths: " << file_paths.cubic_bezier_paths.size() << "." << std::endl;
+                    std::cout << "User selected SHB file " << path << std::endl;
                     filename = path.filename().string();
-                    shapes.clear();
-                    shapes.reserve(file_paths.point_paths.size() + file_paths.cubic_bezier_paths.size());
-                    for (const auto& pp : file_paths.point_paths)
-                        shapes.emplace_back(std::move(pp));
-                    for (const auto& cbp : file_paths.cubic_bezier_paths)
-                        shapes.emplace_back(std::move(cbp));
+                    shapes = shapes::io::shb::parse_shapes_from_file(path, io_err_handler);
                 }
             }
-            stdutils::erase_if(shapes, [](const auto& shape_wrapper) {
-                const auto& shape = shape_wrapper.shape;
-                if (shapes::get_dimension(shape) != 2)
+            if (ImGui::MenuItem("Open SVG"))
+            {
+                const auto paths = pfd::source_paths(
+                    pfd::open_file("Select SVG files", "", { "SVG file", "*.svg" }, pfd::opt::multiselect)
+                );
+                if (!paths.empty())
                 {
-                    std::stringstream out;
-                    out << "Input shape of type " << shapes::get_type_str(shape) << " is not supported and was filtered out";
-                    err_callback(stdutils::io::Severity::ERR, out.str());
-                    return true;
+                    std::cout << "User selected " << paths.size() << " SVG file(s)" << std::endl;
+                    filename = files_name(paths);
+                    shapes = load_files(paths, &load_svg_file, io_err_handler);
                 }
-                return false;
-            });
+            }
+            filter_2d_shapes(shapes, io_err_handler);
             ImGui::Separator();
             bool save_input_as_dat_menu_enabled = static_cast<bool>(windows.shape_control);
             if (ImGui::MenuItem("Save input as DAT", "", false, save_input_as_dat_menu_enabled))
@@ -216,6 +508,17 @@ void main_menu_bar(AppWindows& windows, renderer::Draw2D& renderer, const DtTrac
                     shapes::io::dat::save_shapes_as_file(path, windows.shape_control->get_triangulation_input_aggregate(), io_err_handler);
                 }
             }
+            if (ImGui::MenuItem("Save input as SHB", "", false, save_input_as_dat_menu_enabled))
+            {
+                std::filesystem::path path = pfd::target_path(
+                    pfd::save_file("Select a file", "", { "SHB", "*.shb" }, pfd::opt::force_overwrite)
+                );
+                if (!path.empty())
+                {
+                    if (!path.has_extension()) { path.replace_extension("shb"); }
+                    shapes::io::shb::save_shapes_as_file(path, windows.shape_control->get_triangulation_input_aggregate(), io_err_handler);
+                }
+            }
             bool save_tab_as_dat_menu_enabled = static_cast<bool>(windows.viewport) && static_cast<bool>(windows.shape_control);
             if (ImGui::MenuItem("Save current viewport as DAT", "", false, save_tab_as_dat_menu_enabled))
             {
@@ -242,11 +545,38 @@ void main_menu_bar(AppWindows& windows, renderer::Draw2D& renderer, const DtTrac
             application_should_close = ImGui::MenuItem("Quit", ImGui::key_shortcut::quit().label);
             ImGui::EndMenu();
         }
+        if (ImGui::BeginMenu("Memory"))
+        {
+            using stdutils::memory::HumanReadable;
+            const std::size_t shapes_bytes = windows.shape_control ? windows.shape_control->shapes_byte_size() : 0;
+            ImGui::Text("Shapes: %s", stdutils::memory::to_string(HumanReadable{ shapes_bytes }).c_str());
+            ImGui::Text("Draw list: %s", stdutils::memory::to_string(HumanReadable{ renderer.draw_list().byte_size() }).c_str());
+            ImGui::Separator();
+            ImGui::Text("Process RSS: %s", stdutils::memory::to_string(HumanReadable{ stdutils::memory::get_current_rss() }).c_str());
+            ImGui::Text("Process peak RSS: %s", stdutils::memory::to_string(HumanReadable{ stdutils::memory::get_peak_rss() }).c_str());
+            ImGui::EndMenu();
+        }
+        if (ImGui::BeginMenu("View"))
+        {
+            bool show_performance_window = static_cast<bool>(windows.performance);
+            if (ImGui::MenuItem("Performance", "", &show_performance_window))
+            {
+                if (show_performance_window) { windows.performance = std::make_unique<PerformanceWindow>(); }
+                else { windows.performance.reset(); }
+            }
+            ImGui::EndMenu();
+        }
+        if (background_loader)
+        {
+            ImGui::Separator();
+            ImGui::Text("Loading %s: %zu/%zu files", background_loader->name().c_str(), background_loader->nb_loaded(), background_loader->nb_files());
+        }
         ImGui::EndMainMenuBar();
     }
     if (!shapes.empty() && windows.viewport)
     {
         windows.viewport->reset();
+        async_draw_list.clear_all();
         renderer.draw_list().clear_all();
         windows.shape_control = std::make_unique<ShapeWindow>(filename, std::move(shapes), dt_tracker, *windows.viewport);
     }
@@ -275,8 +605,35 @@ int main(int argc, char *argv[])
         return EXIT_SUCCESS;
     }
 
-    // Create GLFW window and load OpenGL
-    stdutils::io::ErrorHandler err_handler(err_callback);
+    if (args["profile"]) { stdutils::profiler::set_enabled(true); }
+
+    // The messages are written to stderr by the consumer thread of the log sink, so that neither the main loop nor the worker threads
+    // wait for the console
+    stdutils::io::LogSink log_sink(err_callback);
+    const stdutils::io::ErrorHandler err_handler = log_sink.handler();
+
+    // Headless rendering
+    if (args["render"])
+    {
+        if (!delaunay::register_all_implementations())
+        {
+            err_handler(stdutils::io::Severity::FATAL, "Issue during Delaunay implementations' registration");
+            return EXIT_FAILURE;
+        }
+        std::vector<std::filesystem::path> input_paths;
+        input_paths.reserve(args.pos.size());
+        for (const char* input_path : args.pos) { input_paths.emplace_back(input_path); }
+        ThumbnailOptions options;
+        if (args["render-size"]) { options.width = options.height = args["render-size"].as<int>(); }
+        const auto nb_images = render_thumbnails(input_paths, args["render"].as<std::string>(), Settings(), options, [](const std::filesystem::path& path, const stdutils::io::ErrorHandler& loader_err_handler) {
+            auto shapes = load_input_file(path, loader_err_handler);
+            filter_2d_shapes(shapes, loader_err_handler);
+            return shapes;
+        }, err_handler);
+        if (args["profile"]) { stdutils::profiler::save_chrome_trace_file(args["profile"].as<std::string>(), err_handler); }
+        return nb_images == input_paths.size() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     bool any_fatal_err = false;
     unsigned int back_framebuffer_id = 0;
     GLFWWindowContext glfw_context = [&back_framebuffer_id, &any_fatal_err, &err_handler]() {
@@ -324,9 +681,12 @@ int main(int argc, char *argv[])
     windows.viewport = std::make_unique<ViewportWindow>();
     constexpr float WINDOW_SETTINGS_WIDTH = 400.f;
     constexpr float WINDOW_SETTINGS_HEIGHT = 450.f;
+    constexpr float WINDOW_PERFORMANCE_WIDTH = 320.f;
+    constexpr float WINDOW_PERFORMANCE_HEIGHT = 360.f;
     windows.layout.settings      = WindowLayout(0.f,                   0.f,                    WINDOW_SETTINGS_WIDTH, WINDOW_SETTINGS_HEIGHT);
     windows.layout.viewport      = WindowLayout(WINDOW_SETTINGS_WIDTH, 0.f,                    -1.f,                  -1.f);
     windows.layout.shape_control = WindowLayout(0.f,                   WINDOW_SETTINGS_HEIGHT, WINDOW_SETTINGS_WIDTH, -1.f);
+    windows.layout.performance   = WindowLayout(WINDOW_SETTINGS_WIDTH, 0.f,                    WINDOW_PERFORMANCE_WIDTH, WINDOW_PERFORMANCE_HEIGHT);      // Over the viewport
 
     // Steiner callback
     windows.viewport->set_steiner_callback([&windows, &err_handler](const shapes::Point2d<scalar>& p) {
@@ -334,6 +694,11 @@ int main(int argc, char *argv[])
         else { err_handler(stdutils::io::Severity::WARN, "Could not add steiner point: No control window"); }
     });
 
+    // Pick callback
+    windows.viewport->set_pick_callback([&windows](const ViewportWindow::Key& tab, const shapes::Point2d<scalar>& p, scalar max_distance) {
+        return windows.shape_control ? windows.shape_control->pick_vertex(tab, p, max_distance) : std::nullopt;
+    });
+
     // On macOS, use the touchpad to pan the viewport image
 #if defined(__APPLE__)
     // Scroll event callback
@@ -342,6 +707,30 @@ int main(int argc, char *argv[])
     });
 #endif
 
+    // Input files of the command line, loaded in the background
+    std::unique_ptr<BackgroundLoader> background_loader;
+    if (!args.pos.empty())
+    {
+        std::vector<std::filesystem::path> input_paths;
+        input_paths.reserve(args.pos.size());
+        for (const char* input_path : args.pos) { input_paths.emplace_back(input_path); }
+        background_loader = std::make_unique<BackgroundLoader>(std::move(input_paths));
+    }
+
+    // Restore the session of the previous run, unless input files were passed on the command line: The input shapes and the triangulations
+    // are memory-mapped, the settings are those of the previous run, therefore the first triangulations of the shape window are the restored ones.
+    const bool use_session = !args["no-session"] && !session::default_dir().empty();
+    if (use_session && !background_loader)
+    {
+        session::Snapshot snapshot;
+        if (session::load(session::default_dir(), snapshot, settings, err_handler))
+        {
+            std::cout << "Restored the session " << snapshot.name << std::endl;
+            windows.shape_control = std::make_unique<ShapeWindow>(snapshot.name, std::move(snapshot.input), dt_tracker, *windows.viewport);
+            windows.shape_control->restore_triangulations(std::move(snapshot.triangulations));
+        }
+    }
+
     // Renderer
     renderer::Draw2D::Settings renderer_settings;
     renderer_settings.back_framebuffer_id = back_framebuffer_id;
@@ -353,10 +742,27 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
     CBPSegmentation<scalar> cbp_segmentation;
+    AsyncDrawList<scalar> async_draw_list;
+
+    // Time budget of each frame, so that the frame rate stays stable while heavy geometry is segmented and uploaded
+    const float frame_budget_ms = args["frame-budget"] ? args["frame-budget"].as<float>() : 8.f;
+
+    // Idle mode: Once the screen is settled, the main loop waits for the next event instead of rendering continuously. Dear ImGui needs
+    // a few frames after an event to settle (hovered items, popups, etc.). The wait timeout lets its timed elements (tooltips, text
+    // cursor) update at a low rate. The background jobs post an empty event once done.
+    constexpr int IDLE_MODE_FRAMES_AFTER_ACTIVITY = 3;
+    constexpr double IDLE_MODE_WAIT_TIMEOUT_S = 0.5;
+    glfw_context.track_events();
+    int frames_before_idle = IDLE_MODE_FRAMES_AFTER_ACTIVITY;
 
     // Main loop
     ViewportWindow::Key previously_selected_tab;
     ViewportWindow::TabList tab_list;
+    const ShapeWindow* background_loader_window = nullptr;     // The window that receives the shapes of the background loader
+    const bool watch_input_files = args["watch"];
+    std::unique_ptr<FileWatcher> file_watcher;                  // Started once the files of the command line are loaded
+    const ShapeWindow* file_watcher_window = nullptr;
+    shapes::BoundingBox2d<float> previous_view_bounding_box;
     while (!glfwWindowShouldClose(glfw_context.window()))
     {
         // Poll and handle events (inputs, window resize, etc.)
@@ -364,12 +770,19 @@ int main(int argc, char *argv[])
         // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application.
         // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application.
         // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
-        glfwPollEvents();
+        const bool idle = settings.get_general_settings()->idle_mode && frames_before_idle == 0;
+        if (glfw_context.process_events(idle, IDLE_MODE_WAIT_TIMEOUT_S))
+            frames_before_idle = IDLE_MODE_FRAMES_AFTER_ACTIVITY;
+        else if (frames_before_idle > 0)
+            frames_before_idle--;
         if (glfw_context.window_status().is_minimized)
         {
             dear_imgui_context.sleep(10);
             continue;
         }
+        const auto frame_start = std::chrono::steady_clock::now();
+        const FrameBudget frame_budget(frame_start, frame_budget_ms);
+        PerformanceWindow::Frame perf_frame;
 
         // Start the Dear ImGui frame
         dear_imgui_context.new_frame();
@@ -377,11 +790,71 @@ int main(int argc, char *argv[])
         // Main menu
         {
             bool app_should_close = false;
-            main_menu_bar(windows, *draw_2d_renderer, dt_tracker, app_should_close, gui_dark_mode);
+            main_menu_bar(windows, *draw_2d_renderer, async_draw_list, dt_tracker, background_loader.get(), app_should_close, gui_dark_mode);
             if (app_should_close)
                 glfwSetWindowShouldClose(glfw_context.window(), 1);
         }
 
+        // Files loaded in the background: The shape window is opened with the first one, the next ones are added to its input.
+        // If the window was closed, or replaced by a file opened from the menu, the loading is cancelled.
+        if (background_loader)
+        {
+            auto loaded_shapes = background_loader->collect(err_handler);
+            if (windows.shape_control.get() != background_loader_window)
+            {
+                background_loader->cancel();
+            }
+            else if (!loaded_shapes.empty() && windows.shape_control)
+            {
+                windows.shape_control->add_input_shapes(std::move(loaded_shapes), *windows.viewport);
+            }
+            else if (!loaded_shapes.empty())
+            {
+                windows.viewport->reset();
+                async_draw_list.clear_all();
+                draw_2d_renderer->draw_list().clear_all();
+                windows.shape_control = std::make_unique<ShapeWindow>(background_loader->name(), std::move(loaded_shapes), dt_tracker, *windows.viewport);
+                background_loader_window = windows.shape_control.get();
+            }
+            if (background_loader->done())
+            {
+                if (watch_input_files && windows.shape_control && windows.shape_control.get() == background_loader_window)
+                {
+                    file_watcher = std::make_unique<FileWatcher>(background_loader->paths(), background_loader->file_nb_shapes(), [](const std::filesystem::path& path, const stdutils::io::ErrorHandler& file_err_handler) {
+                        auto shapes = load_input_file(path, file_err_handler);
+                        filter_2d_shapes(shapes, file_err_handler);
+                        return shapes;
+                    });
+                    file_watcher_window = background_loader_window;
+                }
+                background_loader.reset();
+                background_loader_window = nullptr;
+            }
+        }
+
+        // Files reloaded in the background: Only the shapes that changed are replaced. If the window was closed, or replaced by a file
+        // opened from the menu, the watch stops.
+        if (file_watcher)
+        {
+            auto reloads = file_watcher->collect(err_handler);
+            if (windows.shape_control.get() != file_watcher_window)
+            {
+                file_watcher.reset();
+                file_watcher_window = nullptr;
+            }
+            else
+            {
+                for (auto& reload : reloads)
+                {
+                    const std::size_t nb_shapes = reload.shapes.size();
+                    const std::size_t nb_new_shapes = windows.shape_control->replace_input_shapes(reload.first_shape_idx, reload.nb_replaced_shapes, std::move(reload.shapes), *windows.viewport);
+                    std::stringstream out;
+                    out << "Reloaded " << reload.path.filename() << ": " << nb_new_shapes << " of " << nb_shapes << " shape(s) changed";
+                    err_handler(stdutils::io::Severity::INFO, out.str());
+                }
+            }
+        }
+
         // Settings window
         if (windows.settings)
         {
@@ -395,6 +868,7 @@ int main(int argc, char *argv[])
         if (renderer_settings.line_smooth != line_smooth_settings)
         {
             renderer_settings.line_smooth = line_smooth_settings;
+            async_draw_list.clear_all();                    // The job reads the draw list of the renderer
             draw_2d_renderer = std::make_unique<renderer::Draw2D>(renderer_settings, &err_handler);
             if (!draw_2d_renderer || !draw_2d_renderer->initialized())
             {
@@ -416,6 +890,7 @@ int main(int argc, char *argv[])
             {
                 windows.shape_control.reset();              // Close window
                 windows.viewport->reset();                  // Not closed, just reset
+                async_draw_list.clear_all();
                 draw_2d_renderer->draw_list().clear_all();
                 cbp_segmentation.clear_all();
                 previously_selected_tab = "";
@@ -436,6 +911,14 @@ int main(int argc, char *argv[])
             draw_2d_renderer->set_viewport_background_color(windows.viewport->get_background_color());
         }
 
+        // Performance window. It shows the timings of the previous frame.
+        if (windows.performance)
+        {
+            bool can_be_erased = false;
+            windows.performance->visit(can_be_erased, windows.layout.performance);
+            if (can_be_erased) { windows.performance.reset(); }
+        }
+
         // Transfer draw lists to our renderer
         const auto drawing_options = drawing_options_from_settings(settings);
         const DrawCommands<scalar>* draw_commands_ptr = nullptr;
@@ -485,21 +968,73 @@ int main(int argc, char *argv[])
             {
                 assert(draw_commands_ptr);
                 bool new_cbp_segmentation = false;
-                const DrawCommands<scalar>& transformed_draw_commands = cbp_segmentation.convert_cbps(*draw_commands_ptr, fb_viewport_canvas, geometry_has_changed, new_cbp_segmentation);
+                std::chrono::duration<float, std::milli> duration{0};
+                const DrawCommands<scalar>* transformed_draw_commands = nullptr;
+                {
+                    stdutils::chrono::DurationMeas meas(duration);
+                    transformed_draw_commands = &cbp_segmentation.convert_cbps(*draw_commands_ptr, fb_viewport_canvas, geometry_has_changed, frame_budget, new_cbp_segmentation);
+                }
+                perf_frame.convert_cbps_ms = duration.count();
                 const bool update_buffers = geometry_has_changed || new_cbp_segmentation;
-                update_opengl_draw_list<scalar>(draw_2d_renderer->draw_list(), transformed_draw_commands, update_buffers, drawing_options);
-                stable_sort_draw_commands(draw_2d_renderer->draw_list());
+
+                // While the view is panned or zoomed, the renderer may reproject the last image rendered at full quality. Once the view
+                // stops moving, the next frame is rendered at full quality.
+                const auto view_bounding_box = fb_viewport_canvas.actual_bounding_box();
+                if (!update_buffers && !(view_bounding_box == previous_view_bounding_box)) { flags |= renderer::Flag::Interactive; }
+                previous_view_bounding_box = view_bounding_box;
+                {
+                    stdutils::chrono::DurationMeas meas(duration);
+                    async_draw_list.update(draw_2d_renderer->draw_list(), *transformed_draw_commands, update_buffers, drawing_options);
+                }
+                perf_frame.draw_list_ms = duration.count();
+                draw_2d_renderer->set_upload_deadline(frame_budget.deadline());
                 draw_2d_renderer->render(fb_viewport_canvas, flags);
             }
         }
 
+        // Continuous rendering during an interaction (drag, slider, etc.), while the geometry changes, or while it is uploaded to the GPU
+        if (geometry_has_changed || draw_2d_renderer->uploads_pending() || ImGui::IsAnyItemActive() || ImGui::IsAnyMouseDown())
+            frames_before_idle = IDLE_MODE_FRAMES_AFTER_ACTIVITY;
+
         // ImGui rendering (always on top of the viewport rendering)
         dear_imgui_context.render();
 
+        // Frame timings, not including the wait for the vertical sync
+        if (windows.performance)
+        {
+            perf_frame.main_loop_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frame_start).count();
+            perf_frame.renderer = draw_2d_renderer->frame_stats();
+            perf_frame.nb_triangulation_jobs = windows.shape_control ? windows.shape_control->nb_triangulation_jobs() : 0;
+            perf_frame.cbp_segmentation_job = cbp_segmentation.has_pending_job();
+            perf_frame.draw_list_job = async_draw_list.has_pending_job();
+            windows.performance->record_frame(perf_frame);
+        }
+
         // End frame
         glfwSwapBuffers(glfw_context.window());
     }
 
+    // Save the session for the next run
+    if (use_session)
+    {
+        if (windows.shape_control)
+        {
+            session::Snapshot snapshot;
+            snapshot.name = windows.shape_control->get_name();
+            snapshot.input = windows.shape_control->get_triangulation_input_aggregate();
+            snapshot.triangulations = windows.shape_control->get_triangulations_aggregate();
+            session::save(session::default_dir(), snapshot, settings, err_handler);
+        }
+        else
+        {
+            session::clear(session::default_dir());
+        }
+    }
+
+    if (args["profile"])
+    {
+        stdutils::profiler::save_chrome_trace_file(args["profile"].as<std::string>(), err_handler);
+    }
     return EXIT_SUCCESS;
 }
 
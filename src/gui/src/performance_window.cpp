@@ -0,0 +1,87 @@
+#include "performance_window.h"
+
+#include <imgui/imgui.h>
+#include <stdutils/memory.h>
+
+#include <algorithm>
+#include <sstream>
+
+
+namespace {
+
+// The scale of a graph is the maximum of its values, so that the spikes stand out
+void plot_history(const char* label, const char* name, const float* values, std::size_t nb_values, std::size_t offset)
+{
+    const float max_value = nb_values > 0 ? *std::max_element(values, values + nb_values) : 0.f;
+    std::stringstream overlay;
+    overlay.precision(2);
+    overlay << name << " (max " << std::fixed << max_value << " ms)";
+    ImGui::PlotLines(label, values, static_cast<int>(nb_values), static_cast<int>(offset), overlay.str().c_str(), 0.f, std::max(max_value, 1.f), ImVec2(-1.f, 60.f));
+}
+
+} // namespace
+
+PerformanceWindow::PerformanceWindow()
+    : m_title("Performance")
+    , m_latest_frame()
+    , m_main_loop_ms_history()
+    , m_gpu_ms_history()
+    , m_history_next{0}
+    , m_nb_frames{0}
+{ }
+
+void PerformanceWindow::record_frame(const Frame& frame)
+{
+    m_latest_frame = frame;
+    m_main_loop_ms_history[m_history_next] = frame.main_loop_ms;
+    m_gpu_ms_history[m_history_next] = std::max(frame.renderer.gpu_ms, 0.f);
+    m_history_next = (m_history_next + 1) % HISTORY_SIZE;
+    m_nb_frames = std::min(m_nb_frames + 1, HISTORY_SIZE);
+}
+
+void PerformanceWindow::visit(bool& can_be_erased, const WindowLayout& win_pos_sz)
+{
+    ImGui::SetNextWindowPosAndSize(win_pos_sz);
+    constexpr ImGuiWindowFlags win_flags = ImGuiWindowFlags_NoCollapse
+                                         | ImGuiWindowFlags_NoMove
+                                         | ImGuiWindowFlags_NoResize
+                                         | ImGuiWindowFlags_NoSavedSettings;
+
+    bool is_window_open = true;
+    if (!ImGui::Begin(m_title.c_str(), &is_window_open, win_flags))
+    {
+        // Collapsed
+        can_be_erased = !is_window_open;
+        ImGui::End();
+        return;
+    }
+    can_be_erased = !is_window_open;
+
+    using stdutils::memory::HumanReadable;
+    const Frame& frame = m_latest_frame;
+    const auto& renderer_stats = frame.renderer;
+    ImGui::Text("Frame rate: %.1f FPS", static_cast<double>(ImGui::GetIO().Framerate));
+    ImGui::Text("Main loop: %.2f ms", static_cast<double>(frame.main_loop_ms));
+    ImGui::Indent();
+    ImGui::Text("CBP segmentation: %.2f ms", static_cast<double>(frame.convert_cbps_ms));
+    ImGui::Text("Draw list update: %.2f ms", static_cast<double>(frame.draw_list_ms));
+    ImGui::Text("Buffer uploads: %.2f ms (%s)", static_cast<double>(renderer_stats.update_buffers_ms), stdutils::memory::to_string(HumanReadable{ renderer_stats.upload_bytes }).c_str());
+    ImGui::Text("Draw calls: %.2f ms (%u calls)", static_cast<double>(renderer_stats.render_assets_ms), renderer_stats.draw_calls);
+    ImGui::Unindent();
+    if (renderer_stats.gpu_ms >= 0.f)
+        ImGui::Text("GPU: %.2f ms", static_cast<double>(renderer_stats.gpu_ms));
+    else
+        ImGui::TextUnformatted("GPU: n/a");
+
+    ImGui::Separator();
+    ImGui::Text("Triangulation jobs: %zu", frame.nb_triangulation_jobs);
+    ImGui::Text("CBP segmentation job: %s", frame.cbp_segmentation_job ? "running" : "none");
+    ImGui::Text("Draw list job: %s", frame.draw_list_job ? "running" : "none");
+
+    ImGui::Separator();
+    const std::size_t offset = m_nb_frames < HISTORY_SIZE ? 0 : m_history_next;
+    plot_history("##main_loop", "Main loop", m_main_loop_ms_history.data(), m_nb_frames, offset);
+    plot_history("##gpu", "GPU", m_gpu_ms_history.data(), m_nb_frames, offset);
+
+    ImGui::End();
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "renderer.h"
+
+#include <base/window_layout.h>
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+// Timings of the latest frames, to spot the costly steps of the main loop. With the idle mode, a frame is only rendered after an event.
+class PerformanceWindow
+{
+public:
+    struct Frame
+    {
+        float main_loop_ms{0.f};                                // CPU time of the frame, not including the wait for events
+        float convert_cbps_ms{0.f};                             // Segmentation of the cubic Bezier paths
+        float draw_list_ms{0.f};                                // Update of the draw list
+        renderer::Draw2D::FrameStats renderer{};
+        std::size_t nb_triangulation_jobs{0};
+        bool cbp_segmentation_job{false};
+        bool draw_list_job{false};
+    };
+
+    PerformanceWindow();
+    PerformanceWindow(const PerformanceWindow&) = delete;
+    PerformanceWindow& operator=(const PerformanceWindow&) = delete;
+
+    void record_frame(const Frame& frame);
+
+    void visit(bool& can_be_erased, const WindowLayout& win_pos_sz);
+
+private:
+    static constexpr std::size_t HISTORY_SIZE = 240;
+
+    std::string m_title;
+    Frame m_latest_frame;
+    std::array<float, HISTORY_SIZE> m_main_loop_ms_history;     // Ring buffers
+    std::array<float, HISTORY_SIZE> m_gpu_ms_history;
+    std::size_t m_history_next;                                 // Index of the next frame in the ring buffers
+    std::size_t m_nb_frames;
+};
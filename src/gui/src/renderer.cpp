@@ -4,12 +4,20 @@
 
 #include <base/opengl_and_glfw.h>
 #include <lin/mat.h>
+#include <stdutils/chrono.h>
 #include <stdutils/enum.h>
+#include <stdutils/memory.h>
+#include <stdutils/profiler.h>
 
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <type_traits>
+#include <vector>
 
 namespace renderer {
 
@@ -18,29 +26,186 @@ namespace {
 struct VertexShaderSource
 {
     static const char* main;
+    static const char* point_sprites;
+    static const char* wide_lines;
+    static const char* static_layer;
+    static const char* face_quality;
 };
 
 // The GLSL version number is added by our driver
 const char* VertexShaderSource::main = R"SRC(
 
-layout (location = 0) in vec3 v_pos;
+layout (location = 0) in vec2 v_pos;
 uniform mat4 mat_proj;
+uniform vec4 model;
 uniform vec4 uni_color;
 uniform float pt_size;
 out vec4 color;
 
 void main()
 {
-    gl_Position = mat_proj * vec4(v_pos, 1.0);
+    gl_Position = mat_proj * vec4(model.xy * v_pos + model.zw, 0.0, 1.0);
     gl_PointSize = pt_size;
     color = uni_color;
 }
 
 )SRC";
 
+// The point sprites and the wide lines are geometry-free: The vertex shader reads the indices and the vertices from texture buffers,
+// and expands each point, or each segment, into a quad of two triangles (6 vertices) of a constant size in screen space.
+const char* VertexShaderSource::point_sprites = R"SRC(
+
+uniform mat4 mat_proj;
+uniform vec4 model;
+uniform vec4 uni_color;
+uniform vec2 viewport_size;
+uniform float width;
+uniform samplerBuffer positions;
+uniform usamplerBuffer indices;
+out vec4 color;
+
+const vec2 corners[6] = vec2[6](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(-1.0, 1.0), vec2(-1.0, 1.0), vec2(1.0, -1.0), vec2(1.0, 1.0));
+
+void main()
+{
+    int vertex_idx = int(texelFetch(indices, gl_VertexID / 6).r);
+    vec4 center = mat_proj * vec4(model.xy * texelFetch(positions, vertex_idx).xy + model.zw, 0.0, 1.0);
+    gl_Position = vec4(center.xy + corners[gl_VertexID % 6] * width / viewport_size, center.zw);
+    color = uni_color;
+}
+
+)SRC";
+
+const char* VertexShaderSource::wide_lines = R"SRC(
+
+uniform mat4 mat_proj;
+uniform vec4 model;
+uniform vec4 uni_color;
+uniform vec2 viewport_size;
+uniform float width;
+uniform float smooth_edges;
+uniform samplerBuffer positions;
+uniform usamplerBuffer indices;
+out vec4 color;
+out float across;
+
+const vec2 corners[6] = vec2[6](vec2(0.0, -1.0), vec2(1.0, -1.0), vec2(0.0, 1.0), vec2(0.0, 1.0), vec2(1.0, -1.0), vec2(1.0, 1.0));
+
+void main()
+{
+    int segment_idx = gl_VertexID / 6;
+    vec2 corner = corners[gl_VertexID % 6];
+    vec4 p0 = mat_proj * vec4(model.xy * texelFetch(positions, int(texelFetch(indices, 2 * segment_idx).r)).xy + model.zw, 0.0, 1.0);
+    vec4 p1 = mat_proj * vec4(model.xy * texelFetch(positions, int(texelFetch(indices, 2 * segment_idx + 1).r)).xy + model.zw, 0.0, 1.0);
+    vec2 dir = (p1.xy - p0.xy) * viewport_size;
+    dir = dot(dir, dir) > 0.0 ? normalize(dir) : vec2(1.0, 0.0);
+    float half_width = 0.5 * width + 0.5 * smooth_edges;
+    vec4 p = mix(p0, p1, corner.x);
+    gl_Position = vec4(p.xy + vec2(-dir.y, dir.x) * corner.y * 2.0 * half_width / viewport_size, p.zw);
+    color = uni_color;
+    across = corner.y * half_width;
+}
+
+)SRC";
+
+// The image of the static layer is mapped on the viewport with the projection it was rendered with
+const char* VertexShaderSource::static_layer = R"SRC(
+
+layout (location = 0) in vec2 v_pos;
+uniform mat4 mat_proj;
+uniform mat4 mat_image_proj;
+out vec2 tex_coord;
+
+void main()
+{
+    gl_Position = mat_proj * vec4(v_pos, 0.0, 1.0);
+    tex_coord = 0.5 * (mat_image_proj * vec4(v_pos, 0.0, 1.0)).xy + 0.5;
+}
+
+)SRC";
+
+// The quality of each triangle is computed by the geometry shader, from the world and the clip coordinates of its vertices
+const char* VertexShaderSource::face_quality = R"SRC(
+
+layout (location = 0) in vec2 v_pos;
+uniform mat4 mat_proj;
+uniform vec4 model;
+out vec2 world_pos;
+
+void main()
+{
+    world_pos = model.xy * v_pos + model.zw;
+    gl_Position = mat_proj * vec4(world_pos, 0.0, 1.0);
+}
+
+)SRC";
+
+struct GeometryShaderSource
+{
+    static const char* face_quality;
+};
+
+// The GLSL version number is added by our driver. The metric is the value of FaceColor.
+const char* GeometryShaderSource::face_quality = R"SRC(
+
+layout (triangles) in;
+layout (triangle_strip, max_vertices = 3) out;
+uniform int metric;
+uniform vec2 viewport_size;
+uniform vec4 uni_color;
+uniform vec4 ramp_low;
+uniform vec4 ramp_high;
+in vec2 world_pos[];
+out vec4 color;
+
+const float PI = 3.14159265;
+
+float quality()
+{
+    vec2 a = world_pos[1] - world_pos[0];
+    vec2 b = world_pos[2] - world_pos[1];
+    vec2 c = world_pos[0] - world_pos[2];
+    float twice_area = abs(a.x * c.y - a.y * c.x);
+    if (metric == 1)
+    {
+        float min_angle = min(atan(twice_area, -dot(a, c)), min(atan(twice_area, -dot(b, a)), atan(twice_area, -dot(c, b))));
+        return min_angle * 3.0 / PI;
+    }
+    else if (metric == 2)
+    {
+        float la = length(a);
+        float lb = length(b);
+        float lc = length(c);
+        float denom = (la + lb + lc) * la * lb * lc;
+        return denom > 0.0 ? 4.0 * twice_area * twice_area / denom : 0.0;
+    }
+    vec2 sa = (gl_in[1].gl_Position.xy - gl_in[0].gl_Position.xy) * viewport_size;
+    vec2 sc = (gl_in[0].gl_Position.xy - gl_in[2].gl_Position.xy) * viewport_size;
+    float area_in_pixels = 0.125 * abs(sa.x * sc.y - sa.y * sc.x);
+    return log2(max(area_in_pixels, 1.0)) / 16.0;
+}
+
+void main()
+{
+    vec4 face_color = mix(ramp_low, ramp_high, clamp(quality(), 0.0, 1.0));
+    face_color.a *= uni_color.a;
+    for (int i = 0; i < 3; i++)
+    {
+        gl_Position = gl_in[i].gl_Position;
+        color = face_color;
+        EmitVertex();
+    }
+    EndPrimitive();
+}
+
+)SRC";
+
 struct FragmentShaderSource
 {
     static const char* main;
+    static const char* wide_lines;
+    static const char* static_layer;
+    static const char* point_density;
 };
 
 // The GLSL version number is added by our driver
@@ -56,30 +221,324 @@ void main()
 
 )SRC";
 
+// The edges of the lines are antialiased over one pixel if smooth_edges is 1.0
+const char* FragmentShaderSource::wide_lines = R"SRC(
+
+uniform float width;
+uniform float smooth_edges;
+in vec4 color;
+in float across;
+layout (location = 0) out vec4 out_color;
+
+void main()
+{
+    float coverage = mix(1.0, clamp(0.5 * width + 0.5 - abs(across), 0.0, 1.0), smooth_edges);
+    out_color = vec4(color.rgb, color.a * coverage);
+}
+
+)SRC";
+
+// Outside of the image, the viewport background is left visible
+const char* FragmentShaderSource::static_layer = R"SRC(
+
+uniform sampler2D image;
+in vec2 tex_coord;
+layout (location = 0) out vec4 out_color;
+
+void main()
+{
+    if (any(lessThan(tex_coord, vec2(0.0))) || any(greaterThan(tex_coord, vec2(1.0))))
+        discard;
+    out_color = texture(image, tex_coord);
+}
+
+)SRC";
+
+// The number of points per pixel is mapped on a heat ramp, on a log scale up to the saturation count. The empty pixels are left transparent.
+const char* FragmentShaderSource::point_density = R"SRC(
+
+uniform sampler2D density;
+uniform float saturation;
+uniform vec4 uni_color;
+in vec2 tex_coord;
+layout (location = 0) out vec4 out_color;
+
+void main()
+{
+    float count = texture(density, tex_coord).r;
+    if (count <= 0.0)
+        discard;
+    float t = clamp(log2(1.0 + count) / log2(1.0 + saturation), 0.0, 1.0);
+    vec3 heat = clamp(vec3(3.0 * t, 3.0 * t - 1.0, 3.0 * t - 2.0), 0.0, 1.0);
+    out_color = vec4(mix(vec3(0.25, 0.0, 0.0), vec3(1.0), heat), uni_color.a);
+}
+
+)SRC";
+
 const std::array<GLenum, stdutils::enum_size<DrawCmd>()> lookup_gl_draw_cmd {
     /* DrawCmd::Point */                GL_POINTS,
     /* DrawCmd::Lines */                GL_LINES,
     /* DrawCmd::Triangles */            GL_TRIANGLES
 };
 
+const std::array<std::size_t, stdutils::enum_size<DrawCmd>()> lookup_indices_per_primitive {
+    /* DrawCmd::Point */                1,
+    /* DrawCmd::Lines */                2,
+    /* DrawCmd::Triangles */            3
+};
+
+struct GPUBufferSize
+{
+    std::size_t uploaded{0};                // Number of elements
+    std::size_t capacity_in_bytes{0};
+};
+
+// The GPU buffer (already bound) is only reallocated if it is too small. In that case its content is lost and must be uploaded again.
+void reserve_gpu_buffer(GLenum target, std::size_t size_in_bytes, GPUBufferSize& gpu_size)
+{
+    if (size_in_bytes <= gpu_size.capacity_in_bytes)
+        return;
+    gpu_size.capacity_in_bytes = size_in_bytes + size_in_bytes / 2;     // Room for the next blocks
+    glBufferData(target, static_cast<GLsizeiptr>(gpu_size.capacity_in_bytes), nullptr, GL_DYNAMIC_DRAW);
+    gpu_size.uploaded = 0;
+}
+
+// Upload the part of the buffer that the GPU does not have yet, up to max_bytes, converted to type T if needed. Return the number of bytes
+// uploaded. The tail is written to a mapped range of the GPU buffer without synchronization, since the GPU does not read it yet.
+template <typename T, typename S>
+std::size_t upload_buffer_tail(GLenum target, GLuint gl_buffer, const LockedBuffer<S>& buffer, GPUBufferSize& gpu_size, std::size_t max_bytes, std::vector<T>* conversion_buffer)
+{
+    assert(gpu_size.uploaded <= buffer.size());
+    if (gpu_size.uploaded == buffer.size() || max_bytes < sizeof(T))
+        return 0;
+    glBindBuffer(target, gl_buffer);
+    reserve_gpu_buffer(target, buffer.size() * sizeof(T), gpu_size);
+    const std::size_t chunk_size = std::min(buffer.size() - gpu_size.uploaded, max_bytes / sizeof(T));
+    const S* chunk_data = buffer.data() + gpu_size.uploaded;
+    const auto gl_offset = static_cast<GLintptr>(gpu_size.uploaded * sizeof(T));
+    const auto gl_length = static_cast<GLsizeiptr>(chunk_size * sizeof(T));
+    void* gpu_data = glMapBufferRange(target, gl_offset, gl_length, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (gpu_data != nullptr)
+    {
+        if constexpr (std::is_same_v<T, S>)
+            std::memcpy(gpu_data, static_cast<const void*>(chunk_data), chunk_size * sizeof(T));
+        else
+            std::transform(chunk_data, chunk_data + chunk_size, static_cast<T*>(gpu_data), [](const S& s) { return static_cast<T>(s); });
+        if (glUnmapBuffer(target) == GL_FALSE)
+        {
+            // The content of the buffer was lost (e.g. a change of the screen mode): Upload it again
+            glBindBuffer(target, 0);
+            gpu_size.uploaded = 0;
+            return 0;
+        }
+    }
+    else
+    {
+        // Fall back to a copy by the driver
+        const void* tail_data = nullptr;
+        if constexpr (std::is_same_v<T, S>)
+        {
+            tail_data = static_cast<const void*>(chunk_data);
+        }
+        else
+        {
+            assert(conversion_buffer);
+            conversion_buffer->resize(chunk_size);
+            std::transform(chunk_data, chunk_data + chunk_size, conversion_buffer->begin(), [](const S& s) { return static_cast<T>(s); });
+            tail_data = static_cast<const void*>(conversion_buffer->data());
+        }
+        glBufferSubData(target, gl_offset, gl_length, tail_data);
+    }
+    glBindBuffer(target, 0);
+    gpu_size.uploaded += chunk_size;
+    return chunk_size * sizeof(T);
+}
+
+// The part of an index range that was uploaded to the GPU, in whole primitives
+DrawList::IndexRange uploaded_range(const DrawList::IndexRange& range, std::size_t nb_uploaded_indices, std::size_t indices_per_primitive)
+{
+    const std::size_t end = std::min(range.second, nb_uploaded_indices);
+    if (end <= range.first)
+        return DrawList::IndexRange(range.first, range.first);
+    return DrawList::IndexRange(range.first, range.first + (end - range.first) / indices_per_primitive * indices_per_primitive);
+}
+
+// Below that screen area per face, the wireframe of a tile is a solid blot of the edge color: The faces of the tile are drawn instead (LOD)
+constexpr float lod_min_pixels_per_face = 2.f;
+
+// Below that number of indices, the assets are cheap enough to be drawn at each frame: The static layer is not cached
+constexpr std::size_t static_layer_min_indices = std::size_t{1} << 18;
+
+// With a frame deadline, the uploads are done in slices of that size, the deadline being checked between two slices
+constexpr std::size_t upload_slice_bytes = std::size_t{1} << 20;
+
+// Saturation of the heat ramp of the point density, relative to the average number of points per pixel of the viewport
+constexpr float point_density_saturation_ratio = 8.f;
+constexpr float point_density_min_saturation = 4.f;
+
+// Number of vertices emitted by the geometry-free shaders for each index: A quad per point, and a quad per segment (two indices)
+constexpr GLint point_sprite_vertices_per_index = 6;
+constexpr GLint wide_line_vertices_per_index = 3;
+
+// The index ranges of a multi-draw. Contiguous ranges are merged.
+class MultiDraw
+{
+public:
+    void clear() { m_firsts.clear(); m_counts.clear(); m_ranges_end = 0; }
+    bool empty() const { return m_counts.empty(); }
+    std::size_t nb_indices() const;
+    void add(const DrawList::IndexRange& range);
+    // The draw functions return the number of GL draw calls issued (zero or one)
+    unsigned int draw_elements(GLenum mode, bool short_indices);
+    // Each index is expanded by the vertex shader into vertices_per_index vertices
+    unsigned int draw_arrays(GLenum mode, GLint vertices_per_index);
+private:
+    std::vector<std::size_t> m_firsts;
+    std::vector<GLsizei> m_counts;
+    std::size_t m_ranges_end{0};
+    // Arguments of the GL calls, reused from frame to frame
+    std::vector<const void*> m_gl_offsets;
+    std::vector<GLint> m_gl_firsts;
+    std::vector<GLsizei> m_gl_counts;
+};
+
+void MultiDraw::add(const DrawList::IndexRange& range)
+{
+    assert(range.first <= range.second);
+    if (range.first == range.second)
+        return;
+    if (!m_counts.empty() && m_ranges_end == range.first)
+    {
+        m_counts.back() += static_cast<GLsizei>(range.second - range.first);
+    }
+    else
+    {
+        m_firsts.push_back(range.first);
+        m_counts.push_back(static_cast<GLsizei>(range.second - range.first));
+    }
+    m_ranges_end = range.second;
+}
+
+std::size_t MultiDraw::nb_indices() const
+{
+    std::size_t result = 0;
+    for (const auto count : m_counts) { result += static_cast<std::size_t>(count); }
+    return result;
+}
+
+unsigned int MultiDraw::draw_elements(GLenum mode, bool short_indices)
+{
+    if (m_counts.empty())
+        return 0;
+    const GLenum index_type = short_indices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    m_gl_offsets.clear();
+    for (const auto first : m_firsts)
+    {
+        m_gl_offsets.push_back(short_indices ? static_cast<const void*>(GLoffset<std::uint16_t>(first)) : static_cast<const void*>(GLoffsetui(first)));
+    }
+    if (m_counts.size() == 1)
+        glDrawElements(mode, m_counts.front(), index_type, m_gl_offsets.front());
+    else
+        glMultiDrawElements(mode, m_counts.data(), index_type, m_gl_offsets.data(), static_cast<GLsizei>(m_counts.size()));
+    return 1;
+}
+
+unsigned int MultiDraw::draw_arrays(GLenum mode, GLint vertices_per_index)
+{
+    if (m_counts.empty())
+        return 0;
+    m_gl_firsts.clear();
+    m_gl_counts.clear();
+    for (std::size_t idx = 0; idx < m_counts.size(); idx++)
+    {
+        m_gl_firsts.push_back(static_cast<GLint>(m_firsts[idx]) * vertices_per_index);
+        m_gl_counts.push_back(m_counts[idx] * vertices_per_index);
+    }
+    if (m_gl_counts.size() == 1)
+        glDrawArrays(mode, m_gl_firsts.front(), m_gl_counts.front());
+    else
+        glMultiDrawArrays(mode, m_gl_firsts.data(), m_gl_counts.data(), static_cast<GLsizei>(m_gl_counts.size()));
+    return 1;
+}
+
+bool same_batch(const DrawList::DrawCall& lhs, const DrawList::DrawCall& rhs)
+{
+    return lhs.m_cmd == rhs.m_cmd
+        && lhs.m_uniform_color == rhs.m_uniform_color
+        && (lhs.m_cmd != DrawCmd::Points || (lhs.m_uniform_point_size == rhs.m_uniform_point_size && lhs.m_point_color == rhs.m_point_color))
+        && (lhs.m_cmd != DrawCmd::Lines || lhs.m_uniform_line_width == rhs.m_uniform_line_width)
+        && (lhs.m_cmd != DrawCmd::Triangles || lhs.m_face_color == rhs.m_face_color)
+        && lhs.m_model == rhs.m_model;
+}
+
+// The uniform vec4 model of the shaders
+void set_model_uniform(GLuint location, const ModelTransform& model)
+{
+    glUniform4f(static_cast<GLint>(location), model.scale[0], model.scale[1], model.offset[0], model.offset[1]);
+}
+
+shapes::BoundingBox2d<float> transform_bounding_box(const shapes::BoundingBox2d<float>& bb, const ModelTransform& model)
+{
+    shapes::BoundingBox2d<float> result;
+    if (!bb.is_populated())
+        return result;
+    result.add(model.scale[0] * bb.min().x + model.offset[0], model.scale[1] * bb.min().y + model.offset[1]);
+    result.add(model.scale[0] * bb.max().x + model.offset[0], model.scale[1] * bb.max().y + model.offset[1]);
+    return result;
+}
+
+// A locked buffer can only be locked with its index at the end
+template <typename T>
+LockedBuffer<T> clone_locked_buffer(const LockedBuffer<T>& buffer)
+{
+    LockedBuffer<T> result(std::vector<T>(buffer.container()));
+    if (buffer.is_locked())
+    {
+        result.consume(result.size());
+        result.lock();
+        result.index_reset();
+    }
+    result.consume(buffer.consumed());
+    return result;
+}
+
 } // namespace
 
 DrawList::DrawCall::DrawCall()
     : m_range(0, 0)
+    , m_tiles(0, 0)
     , m_uniform_color({1.f, 0.f, 0.f, 1.f})
     , m_uniform_point_size(1.f)
+    , m_uniform_line_width(1.f)
+    , m_face_color(renderer::FaceColor::Uniform)
+    , m_point_color(renderer::PointColor::Uniform)
+    , m_model()
     , m_cmd(renderer::DrawCmd::Lines)
 {}
 
+DrawList::Tile::Tile()
+    : m_bounding_box()
+    , m_faces(0, 0)
+    , m_edges(0, 0)
+{}
+
+DrawList::Block::Block()
+    : m_vertices(0, 0)
+    , m_indices(0, 0)
+    , m_tiles(0, 0)
+{}
 
 void DrawList::clear_all()
 {
     // Clear draw calls
     m_draw_calls.clear();
 
-    // Clear the buffers
+    // Clear the buffers and the blocks
     m_vertices.clear();
     m_indices.clear();
+    m_tiles.clear();
+    m_blocks.clear();
+    m_layout.clear();
 
     // Increment buffer version number
     m_buffer_version++;
@@ -94,8 +553,80 @@ void DrawList::clear_draw_calls()
     // Reset the buffers indices but keep the data
     m_vertices.index_reset();
     m_indices.index_reset();
-    assert(m_vertices.is_locked());
-    assert(m_indices.is_locked());
+    m_tiles.index_reset();
+    assert(buffers_are_locked());
+}
+
+void DrawList::lock_buffers()
+{
+    m_vertices.lock();
+    m_indices.lock();
+    m_tiles.lock();
+}
+
+void DrawList::unlock_buffers()
+{
+    m_vertices.unlock();
+    m_indices.unlock();
+    m_tiles.unlock();
+}
+
+bool DrawList::buffers_are_locked() const
+{
+    assert(m_vertices.is_locked() == m_indices.is_locked());
+    assert(m_vertices.is_locked() == m_tiles.is_locked());
+    return m_vertices.is_locked();
+}
+
+void DrawList::seek(const Block& block)
+{
+    m_vertices.index_reset();
+    m_vertices.consume(block.m_vertices.first);
+    m_indices.index_reset();
+    m_indices.consume(block.m_indices.first);
+    m_tiles.index_reset();
+    m_tiles.consume(block.m_tiles.first);
+}
+
+void DrawList::seek_end()
+{
+    m_vertices.index_reset();
+    m_vertices.consume(m_vertices.size());
+    m_indices.index_reset();
+    m_indices.consume(m_indices.size());
+    m_tiles.index_reset();
+    m_tiles.consume(m_tiles.size());
+}
+
+std::size_t DrawList::wasted_vertices() const
+{
+    std::size_t used_vertices = 0;
+    for (const auto& [key, block] : m_blocks) { used_vertices += block.m_vertices.second - block.m_vertices.first; }
+    assert(used_vertices <= m_vertices.size());
+    return m_vertices.size() - used_vertices;
+}
+
+std::size_t DrawList::byte_size() const noexcept
+{
+    return stdutils::memory::byte_size(m_draw_calls)
+         + stdutils::memory::byte_size(m_vertices.container())
+         + stdutils::memory::byte_size(m_indices.container())
+         + stdutils::memory::byte_size(m_tiles.container())
+         + stdutils::memory::byte_size(m_blocks)
+         + stdutils::memory::byte_size(m_layout);
+}
+
+DrawList DrawList::clone() const
+{
+    DrawList result;
+    result.m_draw_calls = m_draw_calls;
+    result.m_vertices = clone_locked_buffer(m_vertices);
+    result.m_indices = clone_locked_buffer(m_indices);
+    result.m_tiles = clone_locked_buffer(m_tiles);
+    result.m_blocks = m_blocks;
+    result.m_layout = m_layout;
+    result.m_buffer_version = m_buffer_version;
+    return result;
 }
 
 void stable_sort_draw_commands(DrawList& draw_list)
@@ -109,51 +640,157 @@ struct Draw2D::Impl
 {
     static inline constexpr unsigned int N_VAOS = 2u;
     static inline constexpr unsigned int N_BUFFERS = 3u;
+    static inline constexpr unsigned int N_TEXTURES = 4u;
+    static inline constexpr unsigned int N_QUERIES = 4u;        // GPU timers in flight
 
     struct GLLocations
     {
         GLuint mat_proj{0u};
+        GLuint model{0u};
         GLuint uni_color{0u};
         GLuint pt_size{0u};
         GLuint v_pos{0u};
     };
 
+    // The point sprites and wide lines programs
+    struct GLSpriteLocations
+    {
+        GLuint mat_proj{0u};
+        GLuint model{0u};
+        GLuint uni_color{0u};
+        GLuint viewport_size{0u};
+        GLuint width{0u};
+        GLuint smooth_edges{0u};            // Wide lines only
+        GLuint positions{0u};
+        GLuint indices{0u};
+    };
+
+    struct GLStaticLayerLocations
+    {
+        GLuint mat_proj{0u};
+        GLuint mat_image_proj{0u};
+        GLuint image{0u};
+    };
+
+    struct GLPointDensityLocations
+    {
+        GLuint mat_proj{0u};
+        GLuint mat_image_proj{0u};
+        GLuint density{0u};
+        GLuint saturation{0u};
+        GLuint uni_color{0u};
+    };
+
+    struct GLFaceQualityLocations
+    {
+        GLuint mat_proj{0u};
+        GLuint model{0u};
+        GLuint metric{0u};
+        GLuint viewport_size{0u};
+        GLuint uni_color{0u};
+        GLuint ramp_low{0u};
+        GLuint ramp_high{0u};
+    };
+
     struct Background
     {
         bool enabled{false};
-        std::array<float, 12> corner_vertices{};
+        std::array<float, 8> corner_vertices{};
         ColorData color{ 0.f, 0.f, 0.f, 1.f };
     };
 
+    // The image of the latest frame rendered at full quality, reprojected instead of drawing the assets while the view moves
+    struct StaticLayer
+    {
+        bool enabled{false};
+        bool valid{false};
+        lin::mat4f mat_proj{};                              // Projection of the image
+        std::pair<GLsizei, GLsizei> size{0, 0};             // Pixels
+    };
+
+    // The float texture of the number of points per pixel, of the size of the viewport
+    struct PointDensity
+    {
+        bool enabled{true};
+        std::pair<GLsizei, GLsizei> size{0, 0};             // Pixels
+    };
+
     Impl(const Settings& settings, const stdutils::io::ErrorHandler* err_handler);
     ~Impl();
 
+    bool compile_sprite_program(const char* vertex_shader, const char* fragment_shader, bool smooth_edges, GLuint& program_id, GLSpriteLocations& locations);
     bool initialize_pipeline(const Settings& settings);
     bool init_framebuffer(int width, int height);
     void clear_framebuffer(ColorData clear_color);
+    std::array<GLint, 4> viewport_rect(const Canvas<float>& canvas) const;
     void set_opengl_viewport(const Canvas<float>& canvas);
     void update_corner_vertices(const Canvas<float>& canvas);
     void update_assets_buffers();
+    std::size_t upload_assets_slice(std::size_t max_bytes);
     void render_background();
+    void use_program(GLuint program_id);
     void render_assets();
+    bool prepare_point_density();
+    void render_point_density(const DrawList::DrawCall& draw_call);
+    void capture_static_layer(const Canvas<float>& viewport_canvas);
+    void render_static_layer();
     void render(const Canvas<float>& viewport_canvas, Flag::type flags);
     void render_viewport_background(const Canvas<float>& viewport_canvas);
+    void start_frame_stats();
+    void begin_gpu_timer();
+    void end_gpu_timer();
 
     bool initialized;
     DrawList draw_list;
     DrawList::Version draw_list_last_buffer_version;
+    GPUBufferSize gpu_vertices_size;
+    GPUBufferSize gpu_indices_size;
+    bool gpu_short_indices;                                 // 16-bit indices on the GPU
+    std::vector<std::uint16_t> short_indices_conversion;
+    std::size_t upload_bytes_per_frame;                     // Zero for no limit
+    std::chrono::steady_clock::time_point upload_deadline;  // Of the current frame
+    MultiDraw multi_draw;                                   // Reused from frame to frame
+    MultiDraw lod_multi_draw;
+    shapes::BoundingBox2d<float> view_bounding_box;         // World coordinates
+    float world_to_pixels;
+    std::array<float, 2> viewport_size;                     // Pixels
+    bool line_smooth;
+    std::size_t max_texture_buffer_size;                    // Above that size, the points and lines are drawn with GL_POINTS and GL_LINES
+    GLuint current_program_id;
     struct {
         GLuint main{0};
+        GLuint point_sprites{0};
+        GLuint wide_lines{0};
+        GLuint static_layer{0};
+        GLuint face_quality{0};
+        GLuint point_density{0};
     } gl_program_ids;
     struct {
         GLLocations main{};
+        GLSpriteLocations point_sprites{};
+        GLSpriteLocations wide_lines{};
+        GLStaticLayerLocations static_layer{};
+        GLFaceQualityLocations face_quality{};
+        GLPointDensityLocations point_density{};
     } gl_locations;
     GLuint gl_back_framebuffer_id;
+    GLuint gl_static_layer_framebuffer_id;
+    GLuint gl_point_density_framebuffer_id;
+    std::array<GLint, 4> gl_viewport_rect;                  // Of the current frame: x, y, width, height
     std::pair<int, int> framebuffer_size;
     std::array<GLuint, N_VAOS> gl_vaos;
     std::array<GLuint, N_BUFFERS> gl_buffers;
+    std::array<GLuint, N_TEXTURES> gl_textures;
+    std::array<GLuint, N_QUERIES> gl_queries;
+    std::array<bool, N_QUERIES> gl_query_pending;           // The query was issued and its result was not read yet
+    unsigned int gl_query_idx;
+    bool gpu_timer_active;
     lin::mat4f mat_proj;
     Background background;
+    std::array<ColorData, 2> face_color_ramp;               // Low and high quality
+    StaticLayer static_layer;
+    PointDensity point_density;
+    FrameStats frame_stats;
     const stdutils::io::ErrorHandler* err_handler;
 };
 
@@ -161,14 +798,40 @@ Draw2D::Impl::Impl(const Settings& settings, const stdutils::io::ErrorHandler* e
     : initialized{false}
     , draw_list()
     , draw_list_last_buffer_version{0u}
+    , gpu_vertices_size{}
+    , gpu_indices_size{}
+    , gpu_short_indices{false}
+    , short_indices_conversion()
+    , upload_bytes_per_frame{settings.upload_bytes_per_frame}
+    , upload_deadline{std::chrono::steady_clock::time_point::max()}
+    , multi_draw()
+    , lod_multi_draw()
+    , view_bounding_box()
+    , world_to_pixels{1.f}
+    , viewport_size{1.f, 1.f}
+    , line_smooth{settings.line_smooth}
+    , max_texture_buffer_size{0}
+    , current_program_id{0u}
     , gl_program_ids{}
     , gl_locations{}
     , gl_back_framebuffer_id{settings.back_framebuffer_id}
+    , gl_static_layer_framebuffer_id{0u}
+    , gl_point_density_framebuffer_id{0u}
+    , gl_viewport_rect{0, 0, 0, 0}
     , framebuffer_size(0, 0)
     , gl_vaos()
     , gl_buffers()
+    , gl_textures()
+    , gl_queries()
+    , gl_query_pending()
+    , gl_query_idx{0u}
+    , gpu_timer_active{false}
     , mat_proj(lin::mat4f::identity())
     , background{}
+    , face_color_ramp{ ColorData{ 0.85f, 0.15f, 0.1f, 1.f }, ColorData{ 0.1f, 0.6f, 0.85f, 1.f } }
+    , static_layer{}
+    , point_density{}
+    , frame_stats{}
     , err_handler(err_handler)
 {
     // Programs
@@ -179,9 +842,48 @@ Draw2D::Impl::Impl(const Settings& settings, const stdutils::io::ErrorHandler* e
             return;
 
         success &= gl_get_uniform_location(gl_program_ids.main, "mat_proj",  &gl_locations.main.mat_proj, err_handler);
+        success &= gl_get_uniform_location(gl_program_ids.main, "model",     &gl_locations.main.model, err_handler);
         success &= gl_get_uniform_location(gl_program_ids.main, "uni_color", &gl_locations.main.uni_color, err_handler);
         success &= gl_get_uniform_location(gl_program_ids.main, "pt_size",   &gl_locations.main.pt_size, err_handler);
         success &= gl_get_attrib_location (gl_program_ids.main, "v_pos",     &gl_locations.main.v_pos, err_handler);
+
+        success &= compile_sprite_program(VertexShaderSource::point_sprites, FragmentShaderSource::main, false, gl_program_ids.point_sprites, gl_locations.point_sprites);
+        success &= compile_sprite_program(VertexShaderSource::wide_lines, FragmentShaderSource::wide_lines, true, gl_program_ids.wide_lines, gl_locations.wide_lines);
+
+        gl_program_ids.static_layer = gl_compile_shaders(VertexShaderSource::static_layer, FragmentShaderSource::static_layer, err_handler);
+        if (gl_program_ids.static_layer == 0u)
+            return;
+        success &= gl_get_uniform_location(gl_program_ids.static_layer, "mat_proj",       &gl_locations.static_layer.mat_proj, err_handler);
+        success &= gl_get_uniform_location(gl_program_ids.static_layer, "mat_image_proj", &gl_locations.static_layer.mat_image_proj, err_handler);
+        success &= gl_get_uniform_location(gl_program_ids.static_layer, "image",          &gl_locations.static_layer.image, err_handler);
+        glUseProgram(gl_program_ids.static_layer);
+        glUniform1i(static_cast<GLint>(gl_locations.static_layer.image), 0);
+        glUseProgram(0);
+
+        gl_program_ids.face_quality = gl_compile_shaders(VertexShaderSource::face_quality, GeometryShaderSource::face_quality, FragmentShaderSource::main, err_handler);
+        if (gl_program_ids.face_quality == 0u)
+            return;
+        success &= gl_get_uniform_location(gl_program_ids.face_quality, "mat_proj",      &gl_locations.face_quality.mat_proj, err_handler);
+        success &= gl_get_uniform_location(gl_program_ids.face_quality, "model",         &gl_locations.face_quality.model, err_handler);
+        success &= gl_get_uniform_location(gl_program_ids.face_quality, "metric",        &gl_locations.face_quality.metric, err_handler);
+        success &= gl_get_uniform_location(gl_program_ids.face_quality, "viewport_size", &gl_locations.face_quality.viewport_size, err_handler);
+        success &= gl_get_uniform_location(gl_program_ids.face_quality, "uni_color",     &gl_locations.face_quality.uni_color, err_handler);
+        success &= gl_get_uniform_location(gl_program_ids.face_quality, "ramp_low",      &gl_locations.face_quality.ramp_low, err_handler);
+        success &= gl_get_uniform_location(gl_program_ids.face_quality, "ramp_high",     &gl_locations.face_quality.ramp_high, err_handler);
+
+        gl_program_ids.point_density = gl_compile_shaders(VertexShaderSource::static_layer, FragmentShaderSource::point_density, err_handler);
+        if (gl_program_ids.point_density == 0u)
+            return;
+        success &= gl_get_uniform_location(gl_program_ids.point_density, "mat_proj",       &gl_locations.point_density.mat_proj, err_handler);
+        success &= gl_get_uniform_location(gl_program_ids.point_density, "mat_image_proj", &gl_locations.point_density.mat_image_proj, err_handler);
+        success &= gl_get_uniform_location(gl_program_ids.point_density, "density",        &gl_locations.point_density.density, err_handler);
+        success &= gl_get_uniform_location(gl_program_ids.point_density, "saturation",     &gl_locations.point_density.saturation, err_handler);
+        success &= gl_get_uniform_location(gl_program_ids.point_density, "uni_color",      &gl_locations.point_density.uni_color, err_handler);
+        glUseProgram(gl_program_ids.point_density);
+        glUniform1i(static_cast<GLint>(gl_locations.point_density.density), 2);
+        glUseProgram(0);
+        if (!success)
+            return;
     }
 
     success &= initialize_pipeline(settings);
@@ -193,7 +895,42 @@ Draw2D::Impl::~Impl()
 {
     glDeleteVertexArrays(N_VAOS, &gl_vaos[0]);
     glDeleteBuffers(N_BUFFERS, &gl_buffers[0]);
+    glDeleteTextures(N_TEXTURES, &gl_textures[0]);
+    glDeleteQueries(N_QUERIES, &gl_queries[0]);
+    glDeleteFramebuffers(1, &gl_static_layer_framebuffer_id);
+    glDeleteFramebuffers(1, &gl_point_density_framebuffer_id);
     if (gl_program_ids.main != 0u) { glDeleteProgram(gl_program_ids.main); }
+    if (gl_program_ids.point_sprites != 0u) { glDeleteProgram(gl_program_ids.point_sprites); }
+    if (gl_program_ids.wide_lines != 0u) { glDeleteProgram(gl_program_ids.wide_lines); }
+    if (gl_program_ids.static_layer != 0u) { glDeleteProgram(gl_program_ids.static_layer); }
+    if (gl_program_ids.face_quality != 0u) { glDeleteProgram(gl_program_ids.face_quality); }
+    if (gl_program_ids.point_density != 0u) { glDeleteProgram(gl_program_ids.point_density); }
+}
+
+bool Draw2D::Impl::compile_sprite_program(const char* vertex_shader, const char* fragment_shader, bool smooth_edges, GLuint& program_id, GLSpriteLocations& locations)
+{
+    program_id = gl_compile_shaders(vertex_shader, fragment_shader, err_handler);
+    if (program_id == 0u)
+        return false;
+
+    bool success = true;
+    success &= gl_get_uniform_location(program_id, "mat_proj",      &locations.mat_proj, err_handler);
+    success &= gl_get_uniform_location(program_id, "model",         &locations.model, err_handler);
+    success &= gl_get_uniform_location(program_id, "uni_color",     &locations.uni_color, err_handler);
+    success &= gl_get_uniform_location(program_id, "viewport_size", &locations.viewport_size, err_handler);
+    success &= gl_get_uniform_location(program_id, "width",         &locations.width, err_handler);
+    success &= gl_get_uniform_location(program_id, "positions",     &locations.positions, err_handler);
+    success &= gl_get_uniform_location(program_id, "indices",       &locations.indices, err_handler);
+    if (smooth_edges)
+        success &= gl_get_uniform_location(program_id, "smooth_edges", &locations.smooth_edges, err_handler);
+
+    // Texture units of the vertices and of the indices
+    glUseProgram(program_id);
+    glUniform1i(static_cast<GLint>(locations.positions), 0);
+    glUniform1i(static_cast<GLint>(locations.indices), 1);
+    glUseProgram(0);
+
+    return success;
 }
 
 bool Draw2D::Impl::initialize_pipeline(const Settings& settings)
@@ -219,6 +956,46 @@ bool Draw2D::Impl::initialize_pipeline(const Settings& settings)
     // VBO 2: assets indices
     glGenBuffers(N_BUFFERS, &gl_buffers[0]);
 
+    // Texture buffers, read by the point sprites and wide lines programs
+    // TEX 0: assets vertices (VBO 1)
+    // TEX 1: assets indices (VBO 2). The internal format is updated with the type of the indices.
+    // TEX 2: image of the static layer, allocated on the first capture
+    // TEX 3: number of points per pixel of the viewport, allocated on the first draw call of points colored by density
+    glGenTextures(N_TEXTURES, &gl_textures[0]);
+    glBindTexture(GL_TEXTURE_BUFFER, gl_textures[0]);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32F, gl_buffers[1]);
+    glBindTexture(GL_TEXTURE_BUFFER, gl_textures[1]);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, gl_buffers[2]);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    GLint max_texels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &max_texels);
+    max_texture_buffer_size = static_cast<std::size_t>(std::max(max_texels, 0));
+    glBindTexture(GL_TEXTURE_2D, gl_textures[2]);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, gl_textures[3]);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Framebuffer of the point density, whose color attachment is TEX 3
+    glGenFramebuffers(1, &gl_point_density_framebuffer_id);
+
+    // Framebuffer of the static layer, whose color attachment is TEX 2
+    // The copy from a multisampled back framebuffer would have to keep the position of the viewport: Not supported.
+    glGenFramebuffers(1, &gl_static_layer_framebuffer_id);
+    GLint sample_buffers = 0;
+    glGetIntegerv(GL_SAMPLE_BUFFERS, &sample_buffers);
+    static_layer.enabled = settings.static_layer_cache && sample_buffers == 0;
+
+    // Timer queries, to measure the GPU time of the rendering
+    glGenQueries(N_QUERIES, &gl_queries[0]);
+    gl_query_pending.fill(false);
+
     // Vertex Arrays
     glGenVertexArrays(N_VAOS, &gl_vaos[0]);
 
@@ -226,13 +1003,13 @@ bool Draw2D::Impl::initialize_pipeline(const Settings& settings)
     glBindVertexArray(gl_vaos[0]);
     glBindBuffer(GL_ARRAY_BUFFER, gl_buffers[0]);
     glEnableVertexAttribArray(gl_locations.main.v_pos);
-    glVertexAttribPointer(gl_locations.main.v_pos, 3, GL_FLOAT, /* normalized */ GL_FALSE, /* stride */ 0, GLoffsetf(0));
+    glVertexAttribPointer(gl_locations.main.v_pos, 2, GL_FLOAT, /* normalized */ GL_FALSE, /* stride */ 0, GLoffsetf(0));
 
     // VAO 1: main renderer
     glBindVertexArray(gl_vaos[1]);
     glBindBuffer(GL_ARRAY_BUFFER, gl_buffers[1]);
     glEnableVertexAttribArray(gl_locations.main.v_pos);
-    glVertexAttribPointer(gl_locations.main.v_pos, 3, GL_FLOAT, /* normalized */ GL_FALSE, /* stride */ 0, GLoffsetf{0});
+    glVertexAttribPointer(gl_locations.main.v_pos, 2, GL_FLOAT, /* normalized */ GL_FALSE, /* stride */ 0, GLoffsetf{0});
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gl_buffers[2]);
 
     glBindVertexArray(0);
@@ -258,48 +1035,102 @@ void Draw2D::Impl::clear_framebuffer(ColorData clear_color)
     glClear(GL_COLOR_BUFFER_BIT);           // No depth buffer to clear
 }
 
-void Draw2D::Impl::set_opengl_viewport(const Canvas<float>& canvas)
+// The viewport in the framebuffer: x, y, width, height
+std::array<GLint, 4> Draw2D::Impl::viewport_rect(const Canvas<float>& canvas) const
 {
-    assert(initialized);
-    // Set the viewport (coordinates transformation from clip space to window space)
     // NB: The (0, 0) position in OpenGL is the bottom-left corner of the window, and the Y-axis is in the "up" direction.
     // For that reason we need to transform the y value of the bottom-left corner of our canvas.
     const ScreenPos canvas_bl(canvas.get_tl_corner().x, canvas.get_br_corner().y);
     const auto canvas_sz = canvas.get_size();
     const float window_height = static_cast<float>(framebuffer_size.second);
-    glViewport(static_cast<GLint>(canvas_bl.x), static_cast<GLint>(window_height - canvas_bl.y), static_cast<GLsizei>(canvas_sz.x), static_cast<GLsizei>(canvas_sz.y));
+    return { static_cast<GLint>(canvas_bl.x), static_cast<GLint>(window_height - canvas_bl.y), static_cast<GLsizei>(canvas_sz.x), static_cast<GLsizei>(canvas_sz.y) };
+}
+
+void Draw2D::Impl::set_opengl_viewport(const Canvas<float>& canvas)
+{
+    assert(initialized);
+    // Set the viewport (coordinates transformation from clip space to window space)
+    gl_viewport_rect = viewport_rect(canvas);
+    glViewport(gl_viewport_rect[0], gl_viewport_rect[1], gl_viewport_rect[2], gl_viewport_rect[3]);
 }
 
 void Draw2D::Impl::update_corner_vertices(const Canvas<float>& canvas) {
     assert(initialized);
     const auto bb = canvas.actual_bounding_box();
     background.corner_vertices = {
-        bb.min().x, bb.min().y, 0.f,
-        bb.min().x, bb.max().y, 0.f,
-        bb.max().x, bb.min().y, 0.f,
-        bb.max().x, bb.max().y, 0.f
+        bb.min().x, bb.min().y,
+        bb.min().x, bb.max().y,
+        bb.max().x, bb.min().y,
+        bb.max().x, bb.max().y
     };
     glBindBuffer(GL_ARRAY_BUFFER, gl_buffers[0]);
     glBufferData(GL_ARRAY_BUFFER, gl_container_size_in_bytes(background.corner_vertices), static_cast<const void*>(background.corner_vertices.data()), GL_STATIC_DRAW);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
+    frame_stats.upload_bytes += sizeof(background.corner_vertices);
+}
+
+// The vertices are uploaded first, so that the indices uploaded to the GPU always refer to uploaded vertices: The assets are drawn
+// progressively as their indices land. Return the number of bytes uploaded.
+std::size_t Draw2D::Impl::upload_assets_slice(std::size_t max_bytes)
+{
+    const GPUBufferSize vertices_size_before = gpu_vertices_size;
+    std::size_t upload_bytes = upload_buffer_tail<DrawList::VertexData>(GL_ARRAY_BUFFER, gl_buffers[1], draw_list.m_vertices, gpu_vertices_size, max_bytes, nullptr);
+    if (gpu_vertices_size.capacity_in_bytes != vertices_size_before.capacity_in_bytes || gpu_vertices_size.uploaded < vertices_size_before.uploaded)
+    {
+        // The vertices are uploaded again from the start
+        gpu_indices_size.uploaded = 0;
+    }
+
+    // The indices are sent in 16-bit as long as the vertices can be addressed that way
+    const bool short_indices = draw_list.m_vertices.size() <= std::size_t{std::numeric_limits<std::uint16_t>::max()} + 1;
+    if (short_indices != gpu_short_indices)
+    {
+        gpu_indices_size.uploaded = 0;
+        gpu_short_indices = short_indices;
+        glBindTexture(GL_TEXTURE_BUFFER, gl_textures[1]);
+        glTexBuffer(GL_TEXTURE_BUFFER, short_indices ? GL_R16UI : GL_R32UI, gl_buffers[2]);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+    if (gpu_vertices_size.uploaded == draw_list.m_vertices.size())
+    {
+        if (short_indices)
+            upload_bytes += upload_buffer_tail(GL_ELEMENT_ARRAY_BUFFER, gl_buffers[2], draw_list.m_indices, gpu_indices_size, max_bytes - upload_bytes, &short_indices_conversion);
+        else
+            upload_bytes += upload_buffer_tail<DrawList::HWindex>(GL_ELEMENT_ARRAY_BUFFER, gl_buffers[2], draw_list.m_indices, gpu_indices_size, max_bytes - upload_bytes, nullptr);
+    }
+    return upload_bytes;
 }
 
 void Draw2D::Impl::update_assets_buffers()
 {
     assert(initialized);
     assert(draw_list_last_buffer_version <= draw_list.buffer_version());
+    if (draw_list.buffer_version() == 0)
+        return;
+    assert(draw_list.buffers_are_locked());
     if (draw_list_last_buffer_version != draw_list.buffer_version())
     {
-        assert(draw_list.m_vertices.is_locked());
-        assert(draw_list.m_indices.is_locked());
-        glBindBuffer(GL_ARRAY_BUFFER, gl_buffers[1]);
-        glBufferData(GL_ARRAY_BUFFER, gl_container_size_in_bytes<DrawList::VertexData>(draw_list.m_vertices), static_cast<const void*>(draw_list.m_vertices.data()), GL_STATIC_DRAW);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gl_buffers[2]);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, gl_container_size_in_bytes<DrawList::HWindex>(draw_list.m_indices), static_cast<const void*>(draw_list.m_indices.data()), GL_STATIC_DRAW);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        // The buffers were rebuilt from scratch
+        gpu_vertices_size.uploaded = 0;
+        gpu_indices_size.uploaded = 0;
+        static_layer.valid = false;
     }
+
+    // The large uploads are spread over several frames, within the byte budget and the deadline of the frame, which is checked between two
+    // slices. At least one slice is uploaded per frame.
+    const std::size_t budget = upload_bytes_per_frame > 0 ? upload_bytes_per_frame : std::numeric_limits<std::size_t>::max();
+    const bool has_deadline = upload_deadline != std::chrono::steady_clock::time_point::max();
+    std::size_t upload_bytes = 0;
+    std::size_t slice_bytes = 0;
+    do
+    {
+        const std::size_t slice_budget = has_deadline ? std::min(upload_slice_bytes, budget - upload_bytes) : budget - upload_bytes;
+        slice_bytes = upload_assets_slice(slice_budget);
+        upload_bytes += slice_bytes;
+    } while (slice_bytes > 0 && upload_bytes < budget && std::chrono::steady_clock::now() < upload_deadline);
     draw_list_last_buffer_version = draw_list.buffer_version();
+    frame_stats.upload_bytes += upload_bytes;
+    if (upload_bytes > 0) { static_layer.valid = false; }
 }
 
 void Draw2D::Impl::render_background()
@@ -308,11 +1139,21 @@ void Draw2D::Impl::render_background()
     glBindVertexArray(gl_vaos[0]);
     glUseProgram(gl_program_ids.main);
     glUniformMatrix4fv(static_cast<GLint>(gl_locations.main.mat_proj), 1, GL_TRUE, mat_proj.data());
+    set_model_uniform(gl_locations.main.model, ModelTransform());
     glUniform4fv(static_cast<GLint>(gl_locations.main.uni_color), 1, background.color.data());
     glUniform1f(static_cast<GLint>(gl_locations.main.pt_size), 1.f);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     glUseProgram(0);
     glBindVertexArray(0);
+    frame_stats.draw_calls++;
+}
+
+void Draw2D::Impl::use_program(GLuint program_id)
+{
+    if (program_id == current_program_id)
+        return;
+    glUseProgram(program_id);
+    current_program_id = program_id;
 }
 
 void Draw2D::Impl::render_assets()
@@ -321,21 +1162,242 @@ void Draw2D::Impl::render_assets()
     if (draw_list.m_draw_calls.empty()) { return; }
     if (draw_list.buffer_version() == 0) { return; }
 
-    // Run main program
-    glBindVertexArray(gl_vaos[1]);
+    // The point sprites and the wide lines read the buffers through texture buffers, which are limited in size
+    const bool use_sprites = draw_list.m_vertices.size() <= max_texture_buffer_size && draw_list.m_indices.size() <= max_texture_buffer_size;
+
+    // Uniforms constant over the frame
     glUseProgram(gl_program_ids.main);
     glUniformMatrix4fv(static_cast<GLint>(gl_locations.main.mat_proj), 1, GL_TRUE, mat_proj.data());
-    for (const auto& draw_call : draw_list.m_draw_calls)
-    {
-        assert(draw_call.m_range.first <= draw_call.m_range.second);
-        const auto count = static_cast<GLsizei>(draw_call.m_range.second - draw_call.m_range.first);
-        glUniform4fv(static_cast<GLint>(gl_locations.main.uni_color), 1, draw_call.m_uniform_color.data());
-        glUniform1f(static_cast<GLint>(gl_locations.main.pt_size), draw_call.m_uniform_point_size);
-        const auto draw_cmd = static_cast<std::size_t>(draw_call.m_cmd);                                                                    assert(draw_cmd < stdutils::enum_size<DrawCmd>());
-        glDrawElements(lookup_gl_draw_cmd[draw_cmd], count, GL_UNSIGNED_INT, GLoffsetui(draw_call.m_range.first));
+    glUseProgram(gl_program_ids.face_quality);
+    glUniformMatrix4fv(static_cast<GLint>(gl_locations.face_quality.mat_proj), 1, GL_TRUE, mat_proj.data());
+    glUniform2f(static_cast<GLint>(gl_locations.face_quality.viewport_size), viewport_size[0], viewport_size[1]);
+    glUniform4fv(static_cast<GLint>(gl_locations.face_quality.ramp_low), 1, face_color_ramp[0].data());
+    glUniform4fv(static_cast<GLint>(gl_locations.face_quality.ramp_high), 1, face_color_ramp[1].data());
+    if (use_sprites)
+    {
+        for (const auto& [program_id, locations] : { std::make_pair(gl_program_ids.point_sprites, &gl_locations.point_sprites), std::make_pair(gl_program_ids.wide_lines, &gl_locations.wide_lines) })
+        {
+            glUseProgram(program_id);
+            glUniformMatrix4fv(static_cast<GLint>(locations->mat_proj), 1, GL_TRUE, mat_proj.data());
+            glUniform2f(static_cast<GLint>(locations->viewport_size), viewport_size[0], viewport_size[1]);
+        }
+        glUniform1f(static_cast<GLint>(gl_locations.wide_lines.smooth_edges), line_smooth ? 1.f : 0.f);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_BUFFER, gl_textures[0]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_BUFFER, gl_textures[1]);
+    }
+    glUseProgram(0);
+    current_program_id = 0u;
+
+    // Run the programs. Only the indices already uploaded are drawn.
+    glBindVertexArray(gl_vaos[1]);
+    const std::size_t nb_indices = gpu_indices_size.uploaded;
+    const auto& draw_calls = draw_list.m_draw_calls;
+    for (auto batch_begin = draw_calls.cbegin(); batch_begin != draw_calls.cend();)
+    {
+        // Consecutive draw calls with the same primitive and uniforms are batched into one multi-draw
+        const auto batch_end = std::find_if_not(batch_begin, draw_calls.cend(), [&batch_begin](const auto& draw_call) { return same_batch(*batch_begin, draw_call); });
+        multi_draw.clear();
+        lod_multi_draw.clear();
+        for (auto draw_call_it = batch_begin; draw_call_it != batch_end; ++draw_call_it)
+        {
+            const auto& tiles_range = draw_call_it->m_tiles;
+            if (tiles_range.first == tiles_range.second)
+            {
+                const auto draw_cmd_idx = static_cast<std::size_t>(draw_call_it->m_cmd);                                        assert(draw_cmd_idx < stdutils::enum_size<DrawCmd>());
+                multi_draw.add(uploaded_range(draw_call_it->m_range, nb_indices, lookup_indices_per_primitive[draw_cmd_idx]));
+                continue;
+            }
+            assert(tiles_range.second <= draw_list.m_tiles.size());
+            const auto& model = draw_call_it->m_model;
+            for (auto tile_idx = tiles_range.first; tile_idx < tiles_range.second; tile_idx++)
+            {
+                const auto& tile = draw_list.m_tiles.data()[tile_idx];
+                const auto tile_bounding_box = transform_bounding_box(tile.m_bounding_box, model);
+                if (!tile_bounding_box.is_populated() || !tile_bounding_box.intersect(view_bounding_box)) { continue; }          // Culling
+                if (draw_call_it->m_cmd == DrawCmd::Triangles) { multi_draw.add(uploaded_range(tile.m_faces, nb_indices, 3)); continue; }
+                assert(draw_call_it->m_cmd == DrawCmd::Lines);
+                const float nb_faces = static_cast<float>(tile.m_faces.second - tile.m_faces.first) / 3.f;
+                const float tile_area_in_pixels = (tile_bounding_box.width() * world_to_pixels) * (tile_bounding_box.height() * world_to_pixels);
+                if (tile_area_in_pixels < lod_min_pixels_per_face * nb_faces)
+                    lod_multi_draw.add(uploaded_range(tile.m_faces, nb_indices, 3));
+                else
+                    multi_draw.add(uploaded_range(tile.m_edges, nb_indices, 2));
+            }
+        }
+        if (!multi_draw.empty())
+        {
+            const auto draw_cmd = batch_begin->m_cmd;
+            if (draw_cmd == DrawCmd::Points && batch_begin->m_point_color == PointColor::Density && prepare_point_density())
+            {
+                render_point_density(*batch_begin);
+            }
+            else if (use_sprites && draw_cmd == DrawCmd::Points)
+            {
+                use_program(gl_program_ids.point_sprites);
+                set_model_uniform(gl_locations.point_sprites.model, batch_begin->m_model);
+                glUniform4fv(static_cast<GLint>(gl_locations.point_sprites.uni_color), 1, batch_begin->m_uniform_color.data());
+                glUniform1f(static_cast<GLint>(gl_locations.point_sprites.width), batch_begin->m_uniform_point_size);
+                frame_stats.draw_calls += multi_draw.draw_arrays(GL_TRIANGLES, point_sprite_vertices_per_index);
+            }
+            else if (use_sprites && draw_cmd == DrawCmd::Lines)
+            {
+                use_program(gl_program_ids.wide_lines);
+                set_model_uniform(gl_locations.wide_lines.model, batch_begin->m_model);
+                glUniform4fv(static_cast<GLint>(gl_locations.wide_lines.uni_color), 1, batch_begin->m_uniform_color.data());
+                glUniform1f(static_cast<GLint>(gl_locations.wide_lines.width), batch_begin->m_uniform_line_width);
+                frame_stats.draw_calls += multi_draw.draw_arrays(GL_TRIANGLES, wide_line_vertices_per_index);
+            }
+            else if (draw_cmd == DrawCmd::Triangles && batch_begin->m_face_color != FaceColor::Uniform)
+            {
+                use_program(gl_program_ids.face_quality);
+                set_model_uniform(gl_locations.face_quality.model, batch_begin->m_model);
+                glUniform1i(static_cast<GLint>(gl_locations.face_quality.metric), static_cast<GLint>(batch_begin->m_face_color));
+                glUniform4fv(static_cast<GLint>(gl_locations.face_quality.uni_color), 1, batch_begin->m_uniform_color.data());
+                frame_stats.draw_calls += multi_draw.draw_elements(GL_TRIANGLES, gpu_short_indices);
+            }
+            else
+            {
+                use_program(gl_program_ids.main);
+                set_model_uniform(gl_locations.main.model, batch_begin->m_model);
+                glUniform4fv(static_cast<GLint>(gl_locations.main.uni_color), 1, batch_begin->m_uniform_color.data());
+                glUniform1f(static_cast<GLint>(gl_locations.main.pt_size), batch_begin->m_uniform_point_size);
+                const auto gl_draw_cmd_idx = static_cast<std::size_t>(draw_cmd);                                                                assert(gl_draw_cmd_idx < stdutils::enum_size<DrawCmd>());
+                frame_stats.draw_calls += multi_draw.draw_elements(lookup_gl_draw_cmd[gl_draw_cmd_idx], gpu_short_indices);
+            }
+        }
+        if (!lod_multi_draw.empty())
+        {
+            use_program(gl_program_ids.main);
+            set_model_uniform(gl_locations.main.model, batch_begin->m_model);
+            glUniform4fv(static_cast<GLint>(gl_locations.main.uni_color), 1, batch_begin->m_uniform_color.data());
+            frame_stats.draw_calls += lod_multi_draw.draw_elements(GL_TRIANGLES, gpu_short_indices);
+        }
+        batch_begin = batch_end;
+    }
+    use_program(0u);
+    if (use_sprites)
+    {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+    glBindVertexArray(0);
+}
+
+// Bind and clear the framebuffer of the point density, (re)allocating its texture to the size of the viewport. Return false if the point
+// density is not supported, in which case the framebuffer is not changed and the points are drawn with a uniform color.
+bool Draw2D::Impl::prepare_point_density()
+{
+    const auto& rect = gl_viewport_rect;
+    if (!point_density.enabled || rect[2] <= 0 || rect[3] <= 0)
+        return false;
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gl_point_density_framebuffer_id);
+    if (point_density.size != std::pair<GLsizei, GLsizei>(rect[2], rect[3]))
+    {
+        point_density.size = std::pair<GLsizei, GLsizei>(rect[2], rect[3]);
+        glBindTexture(GL_TEXTURE_2D, gl_textures[3]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, rect[2], rect[3], 0, GL_RED, GL_FLOAT, nullptr);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, gl_textures[3], 0);
+        if (glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            if (err_handler) { (*err_handler)(stdutils::io::Severity::WARN, "Incomplete framebuffer: The points are not colored by density"); }
+            point_density.enabled = false;
+            glBindFramebuffer(GL_FRAMEBUFFER, gl_back_framebuffer_id);
+            return false;
+        }
+    }
+    glViewport(0, 0, rect[2], rect[3]);
+    glClearColor(0.f, 0.f, 0.f, 0.f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    return true;
+}
+
+// The points of the multi-draw are accumulated in the density texture, one pixel per point with an additive blending, then the texture is
+// mapped on the viewport. The cost per point is that of a single pixel whatever the point size, and no color is uploaded per point.
+void Draw2D::Impl::render_point_density(const DrawList::DrawCall& draw_call)
+{
+    static const ColorData one_count{ 1.f, 0.f, 0.f, 0.f };
+    use_program(gl_program_ids.main);
+    set_model_uniform(gl_locations.main.model, draw_call.m_model);
+    glUniform4fv(static_cast<GLint>(gl_locations.main.uni_color), 1, one_count.data());
+    glUniform1f(static_cast<GLint>(gl_locations.main.pt_size), 1.f);
+    glBlendFunc(GL_ONE, GL_ONE);
+    frame_stats.draw_calls += multi_draw.draw_elements(GL_POINTS, gpu_short_indices);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
+
+    // Tone mapping, over the viewport of the back framebuffer
+    glBindFramebuffer(GL_FRAMEBUFFER, gl_back_framebuffer_id);
+    glViewport(gl_viewport_rect[0], gl_viewport_rect[1], gl_viewport_rect[2], gl_viewport_rect[3]);
+    const float nb_pixels = static_cast<float>(point_density.size.first) * static_cast<float>(point_density.size.second);
+    const float saturation = std::max(point_density_min_saturation, point_density_saturation_ratio * static_cast<float>(multi_draw.nb_indices()) / nb_pixels);
+    glBindVertexArray(gl_vaos[0]);
+    use_program(gl_program_ids.point_density);
+    glUniformMatrix4fv(static_cast<GLint>(gl_locations.point_density.mat_proj), 1, GL_TRUE, mat_proj.data());
+    glUniformMatrix4fv(static_cast<GLint>(gl_locations.point_density.mat_image_proj), 1, GL_TRUE, mat_proj.data());
+    glUniform1f(static_cast<GLint>(gl_locations.point_density.saturation), saturation);
+    glUniform4fv(static_cast<GLint>(gl_locations.point_density.uni_color), 1, draw_call.m_uniform_color.data());
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, gl_textures[3]);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(gl_vaos[1]);
+    frame_stats.draw_calls++;
+}
+
+// Copy the viewport from the back framebuffer: The image holds the background and the assets, and nothing else since the GUI is drawn later
+void Draw2D::Impl::capture_static_layer(const Canvas<float>& viewport_canvas)
+{
+    static_layer.valid = false;
+    if (!static_layer.enabled || draw_list.m_indices.size() < static_layer_min_indices)
+        return;
+    const auto rect = viewport_rect(viewport_canvas);
+    if (rect[2] <= 0 || rect[3] <= 0)
+        return;
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gl_static_layer_framebuffer_id);
+    if (static_layer.size != std::pair<GLsizei, GLsizei>(rect[2], rect[3]))
+    {
+        static_layer.size = std::pair<GLsizei, GLsizei>(rect[2], rect[3]);
+        glBindTexture(GL_TEXTURE_2D, gl_textures[2]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, rect[2], rect[3], 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, gl_textures[2], 0);
+        if (glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            if (err_handler) { (*err_handler)(stdutils::io::Severity::WARN, "Incomplete framebuffer: The static layer is not cached"); }
+            static_layer.enabled = false;
+            glBindFramebuffer(GL_FRAMEBUFFER, gl_back_framebuffer_id);
+            return;
+        }
     }
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, gl_back_framebuffer_id);
+    glBlitFramebuffer(rect[0], rect[1], rect[0] + rect[2], rect[1] + rect[3], 0, 0, rect[2], rect[3], GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, gl_back_framebuffer_id);
+    static_layer.mat_proj = mat_proj;
+    static_layer.valid = true;
+}
+
+// The image is drawn over the viewport background, without blending since it already holds the background
+void Draw2D::Impl::render_static_layer()
+{
+    assert(static_layer.valid);
+    glBindVertexArray(gl_vaos[0]);
+    glUseProgram(gl_program_ids.static_layer);
+    glUniformMatrix4fv(static_cast<GLint>(gl_locations.static_layer.mat_proj), 1, GL_TRUE, mat_proj.data());
+    glUniformMatrix4fv(static_cast<GLint>(gl_locations.static_layer.mat_image_proj), 1, GL_TRUE, static_layer.mat_proj.data());
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, gl_textures[2]);
+    glDisable(GL_BLEND);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glEnable(GL_BLEND);
+    glBindTexture(GL_TEXTURE_2D, 0);
     glUseProgram(0);
     glBindVertexArray(0);
+    frame_stats.draw_calls++;
 }
 
 void Draw2D::Impl::render(const Canvas<float>& viewport_canvas, Flag::type flags)
@@ -344,23 +1406,51 @@ void Draw2D::Impl::render(const Canvas<float>& viewport_canvas, Flag::type flags
     if (framebuffer_size.first == 0 || framebuffer_size.second == 0)
         return;
 
+    start_frame_stats();
+
     // Set OpenGL viewport
     set_opengl_viewport(viewport_canvas);
 
     // Vertex buffers
     update_corner_vertices(viewport_canvas);
-    update_assets_buffers();
+    {
+        std::chrono::duration<float, std::milli> duration{0};
+        stdutils::chrono::DurationMeas meas(duration);
+        update_assets_buffers();
+        frame_stats.update_buffers_ms = duration.count();
+    }
 
     // Projection matrix
     const bool flip_y = flags & Flag::FlipYAxis;
     const auto bb = viewport_canvas.actual_bounding_box();
     mat_proj = gl_orth_proj_mat(bb, flip_y);
+    view_bounding_box = bb;
+    world_to_pixels = viewport_canvas.to_screen(1.f);
+    const auto viewport_canvas_size = viewport_canvas.get_size();
+    viewport_size = { std::max(viewport_canvas_size.x, 1.f), std::max(viewport_canvas_size.y, 1.f) };
+
+    begin_gpu_timer();
 
     // Render background
     if ((flags & Flag::ViewportBackground) && background.enabled) { render_background(); }
 
-    // Render assets
-    render_assets();
+    // Render assets, or reproject the static layer while the view moves
+    {
+        std::chrono::duration<float, std::milli> duration{0};
+        stdutils::chrono::DurationMeas meas(duration);
+        if ((flags & Flag::Interactive) && static_layer.valid)
+        {
+            render_static_layer();
+        }
+        else
+        {
+            render_assets();
+            capture_static_layer(viewport_canvas);
+        }
+        frame_stats.render_assets_ms = duration.count();
+    }
+
+    end_gpu_timer();
 }
 
 void Draw2D::Impl::render_viewport_background(const Canvas<float>& viewport_canvas)
@@ -369,6 +1459,8 @@ void Draw2D::Impl::render_viewport_background(const Canvas<float>& viewport_canv
     if (framebuffer_size.first == 0 || framebuffer_size.second == 0)
         return;
 
+    start_frame_stats();
+    static_layer.valid = false;
     if (!background.enabled)
         return;
 
@@ -383,7 +1475,48 @@ void Draw2D::Impl::render_viewport_background(const Canvas<float>& viewport_canv
     mat_proj = gl_orth_proj_mat(bb);
 
     // Render background
+    begin_gpu_timer();
     render_background();
+    end_gpu_timer();
+}
+
+// The GPU time is not reset: It is only updated once a timer query is available
+void Draw2D::Impl::start_frame_stats()
+{
+    const float gpu_ms = frame_stats.gpu_ms;
+    frame_stats = FrameStats();
+    frame_stats.gpu_ms = gpu_ms;
+}
+
+// The result of a timer query is read N_QUERIES frames later, so that the CPU does not wait for the GPU. If the GPU is even more behind,
+// the frame is not timed.
+void Draw2D::Impl::begin_gpu_timer()
+{
+    assert(!gpu_timer_active);
+    gl_query_idx = (gl_query_idx + 1) % N_QUERIES;
+    const GLuint query = gl_queries[gl_query_idx];
+    if (gl_query_pending[gl_query_idx])
+    {
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == 0)
+            return;
+        GLuint64 elapsed_ns = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed_ns);
+        frame_stats.gpu_ms = static_cast<float>(elapsed_ns) * 1.e-6f;
+        gl_query_pending[gl_query_idx] = false;
+    }
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    gl_query_pending[gl_query_idx] = true;
+    gpu_timer_active = true;
+}
+
+void Draw2D::Impl::end_gpu_timer()
+{
+    if (!gpu_timer_active)
+        return;
+    glEndQuery(GL_TIME_ELAPSED);
+    gpu_timer_active = false;
 }
 
 Draw2D::Draw2D(const Settings& settings, const stdutils::io::ErrorHandler* err_handler)
@@ -428,6 +1561,12 @@ void Draw2D::no_viewport_background()
     p_impl->background.enabled = false;
 }
 
+void Draw2D::set_face_color_ramp(const ColorData& low, const ColorData& high)
+{
+    p_impl->face_color_ramp = { low, high };
+    p_impl->static_layer.valid = false;
+}
+
 DrawList& Draw2D::draw_list()
 {
     return p_impl->draw_list;
@@ -435,6 +1574,7 @@ DrawList& Draw2D::draw_list()
 
 void Draw2D::render(const Canvas<float>& viewport_canvas, Flag::type flags)
 {
+    STDUTILS_PROFILE_ZONE("Draw2D::render");
     p_impl->render(viewport_canvas, flags);
 }
 
@@ -443,4 +1583,23 @@ void Draw2D::render_viewport_background(const Canvas<float>& viewport_canvas)
     p_impl->render_viewport_background(viewport_canvas);
 }
 
+const Draw2D::FrameStats& Draw2D::frame_stats() const
+{
+    return p_impl->frame_stats;
+}
+
+void Draw2D::set_upload_deadline(std::chrono::steady_clock::time_point deadline)
+{
+    p_impl->upload_deadline = deadline;
+}
+
+bool Draw2D::uploads_pending() const
+{
+    const auto& draw_list = p_impl->draw_list;
+    return draw_list.buffer_version() != 0
+        && (p_impl->draw_list_last_buffer_version != draw_list.buffer_version()
+            || p_impl->gpu_vertices_size.uploaded < draw_list.m_vertices.size()
+            || p_impl->gpu_indices_size.uploaded < draw_list.m_indices.size());
+}
+
 } // namespace renderer
@@ -4,12 +4,15 @@
 
 #include <base/canvas.h>
 #include <base/color_data.h>
+#include <shapes/bounding_box.h>
 #include <stdutils/io.h>
 #include <stdutils/locked_buffer.h>
 
 #include <array>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -24,40 +27,114 @@ enum class DrawCmd
     _ENUM_SIZE_
 };
 
+// Color of the faces: Uniform, or by a quality metric of each triangle, computed on the fly by the GPU and mapped on a color ramp
+enum class FaceColor
+{
+    Uniform = 0,
+    MinAngle,                                                   // Smallest angle, relative to 60 degrees
+    AspectRatio,                                                // Inradius over circumradius, relative to that of the equilateral triangle
+    Area,                                                       // Area on screen, on a log scale from 1 to 2^16 pixels
+    _ENUM_SIZE_
+};
+
+// Color of the points: Uniform, or by the number of points per pixel, accumulated in a float texture and mapped on a heat ramp. The cost of
+// the density mode does not depend on the point size, and it stays readable when there are many more points than pixels.
+enum class PointColor
+{
+    Uniform = 0,
+    Density,
+    _ENUM_SIZE_
+};
+
+// Transform of a shape in world coordinates, applied by the vertex shaders: p' = scale * p + offset
+struct ModelTransform
+{
+    std::array<float, 2> scale{ 1.f, 1.f };
+    std::array<float, 2> offset{ 0.f, 0.f };
+    bool operator==(const ModelTransform& o) const { return scale == o.scale && offset == o.offset; }
+};
+
 template <typename T>
 using LockedBuffer = stdutils::LockedBuffer<T, std::vector>;
 
 class DrawList
 {
 public:
-    using HWindex = std::uint32_t;
+    using HWindex = std::uint32_t;                              // Sent to the GPU as 16-bit indices if there are few enough vertices
     using IndexRange = std::pair<std::size_t, std::size_t>;
-    using VertexData = std::array<float, 3>;                    // x, y, z
+    using VertexData = std::array<float, 2>;                    // x, y
     using Version = unsigned int;
+    using BlockKey = std::uint64_t;
     struct DrawCall
     {
         DrawCall();
         IndexRange  m_range;
+        IndexRange  m_tiles;                                    // If not empty, the renderer draws the visible tiles instead of m_range
         ColorData   m_uniform_color;
-        float       m_uniform_point_size;
+        float       m_uniform_point_size;                       // Pixels
+        float       m_uniform_line_width;                       // Pixels
+        FaceColor   m_face_color;                               // Triangles only. The alpha of the uniform color still applies.
+        PointColor  m_point_color;                              // Points only. The alpha of the uniform color still applies.
+        ModelTransform m_model;
         DrawCmd     m_cmd;
     };
 
+    // A tile of a large triangulation. The indices of its faces and of its edges are contiguous, so that the tiles out of view are skipped.
+    struct Tile
+    {
+        Tile();
+        shapes::BoundingBox2d<float> m_bounding_box;
+        IndexRange  m_faces;
+        IndexRange  m_edges;
+    };
+
+    // The vertices and indices of one shape. The block of a shape stays in place as long as the shape is drawn, and the blocks of the
+    // new shapes are appended at the end of the buffers, so that the renderer only has to upload the tail of the buffers.
+    struct Block
+    {
+        Block();
+        IndexRange  m_vertices;
+        IndexRange  m_indices;
+        IndexRange  m_tiles;
+    };
+
     // Initially zero (for an empty draw list)
     Version buffer_version() const { return m_buffer_version; }
 
-    // Clear the draw calls and the buffers and increase the buffer version. Call this function before sending the first DrawList to the renderer.
+    // Clear the draw calls, the buffers and the blocks, and increase the buffer version. Call this function before sending the first DrawList to the renderer.
     void clear_all();
 
     // Clear the draw calls but keep the vertices and indices buffers. The buffer version must be > 0 and will remain the same.
     void clear_draw_calls();
 
+    void lock_buffers();
+    void unlock_buffers();
+    bool buffers_are_locked() const;
+
+    // Move the buffers indices to the beginning of a block, or to the end of the buffers
+    void seek(const Block& block);
+    void seek_end();
+
+    // Size of the buffers that is not part of a block anymore
+    std::size_t wasted_vertices() const;
+
+    // Heap memory held by the draw list, in bytes. This is the CPU side only, the copy of the buffers on the GPU is not included.
+    std::size_t byte_size() const noexcept;
+
+    // Deep copy, with the same buffer version: The renderer only uploads the tail of the buffers if the copy replaces this draw list
+    DrawList clone() const;
+
 public:
     std::vector<DrawCall>       m_draw_calls;
 
     // Locked buffers are used to store the data copied to the GPU
     LockedBuffer<VertexData>    m_vertices;
     LockedBuffer<HWindex>       m_indices;
+    LockedBuffer<Tile>          m_tiles;                        // Not copied to the GPU
+
+    // The blocks of the latest update of the buffers: By key (the shape version), and in the order of the draw commands.
+    std::map<BlockKey, Block>   m_blocks;
+    std::vector<Block>          m_layout;
 
 private:
     Version                     m_buffer_version{0u};           // Used to knwow when to call glBufferData
@@ -72,6 +149,7 @@ struct Flag
     static constexpr type None = 0;
     static constexpr type ViewportBackground = 1 << 0;
     static constexpr type FlipYAxis = 1 << 1;
+    static constexpr type Interactive = 1 << 2;                 // The view moves but not the geometry: A cached image may be reprojected
 };
 
 /**
@@ -89,7 +167,19 @@ public:
     struct Settings
     {
         unsigned int back_framebuffer_id{0};
-        bool line_smooth{false};
+        bool line_smooth{false};                                // Antialiased edges of the lines
+        bool static_layer_cache{true};                          // Reproject the latest image of a large scene while the view moves
+        std::size_t upload_bytes_per_frame{std::size_t{64} << 20};  // The larger uploads are spread over several frames. Zero for no limit.
+    };
+
+    // Measurements of the latest frame
+    struct FrameStats
+    {
+        float update_buffers_ms{0.f};                           // CPU time of the uploads to the GPU buffers
+        float render_assets_ms{0.f};                            // CPU time to issue the draw calls
+        float gpu_ms{-1.f};                                     // GPU time of the rendering of a recent frame. Negative if not available.
+        std::size_t upload_bytes{0};
+        unsigned int draw_calls{0};
     };
 
     Draw2D(const Settings& settings, const stdutils::io::ErrorHandler* err_handler = nullptr);
@@ -113,6 +203,9 @@ public:
     void set_viewport_background_color(float r, float g, float b, float a = 1.f);
     void no_viewport_background();
 
+    // Color ramp of the faces colored by quality (see FaceColor), from the worst to the best triangles
+    void set_face_color_ramp(const ColorData& low, const ColorData& high);
+
     // The current draw list
     DrawList& draw_list();
 
@@ -122,6 +215,15 @@ public:
     // Render only the viewport background
     void render_viewport_background(const Canvas<float>& viewport_canvas);
 
+    const FrameStats& frame_stats() const;
+
+    // Deadline of the uploads of the next calls to render(), e.g. the end of the time budget of the frame. The uploads left are carried
+    // over to the next frames. (Default: None)
+    void set_upload_deadline(std::chrono::steady_clock::time_point deadline);
+
+    // True while the buffers of the draw list are being uploaded to the GPU, over several frames
+    bool uploads_pending() const;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> p_impl;
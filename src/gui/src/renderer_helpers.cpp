@@ -4,134 +4,615 @@
 
 #include "draw_shapes.h"
 
+#include <base/opengl_and_glfw.h>
+#include <shapes/bounding_box_algos.h>
 #include <shapes/sampling.h>
 
 #include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <algorithm>
+#include <chrono>
+#include <future>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <utility>
 #include <variant>
+#include <vector>
 
+namespace {
+
+// Proportion of the buffers that can be lost to the blocks of the shapes that are not drawn anymore, before the buffers are rebuilt
+constexpr double max_wasted_vertices_ratio = 0.5;
+
+// Below that number of vertices, the new shapes are appended to the front draw list on the main thread (see is_small_append)
+constexpr std::size_t max_inline_append_vertices = std::size_t{1} << 16;
+
+// The block of the vertices shared by several shapes. It is drawn at the current position of the buffers the first time it is needed,
+// then it is kept as long as one of the shapes is drawn (see update_blocks). Return nullptr if the shape has no shared vertices.
 template <typename F>
-void update_opengl_draw_list(renderer::DrawList& draw_list, const DrawCommands<F>& draw_commands, bool update_buffers, const DrawingOptions& options)
+const renderer::DrawList::Block* shared_vertex_block(const DrawCommand<F>& draw_command, renderer::DrawList& draw_list)
+{
+    if (draw_command.shared_vertices == nullptr)
+        return nullptr;
+    const auto key = draw_command.shared_vertices->version;
+    const auto block_it = draw_list.m_blocks.find(key);
+    if (block_it != draw_list.m_blocks.end())
+        return &block_it->second;
+    return &draw_list.m_blocks.emplace(key, draw_shared_vertices(draw_command.shared_vertices->vertices, draw_list)).first->second;
+}
+
+template <typename F>
+void draw_shape(const DrawCommand<F>& draw_command, renderer::DrawList& draw_list, DrawingOptions& local_options, const renderer::DrawList::Block* vertex_block)
 {
-    if (update_buffers || draw_list.buffer_version() == 0) { draw_list.clear_all(); } else { draw_list.clear_draw_calls(); }
-    assert(draw_list.m_vertices.consumed() == 0);
-    assert(draw_list.m_indices.consumed() == 0);
+    assert(draw_command.shape != nullptr);
+    assert((vertex_block != nullptr) == (draw_command.shared_vertices != nullptr));
+    local_options.vertices = draw_command.vertices;
+    local_options.edges = draw_command.edges;
+    local_options.faces = draw_command.faces;
+    const std::size_t first_draw_call = draw_list.m_draw_calls.size();
+    std::visit(stdutils::Overloaded {
+        [&draw_list, &local_options](const shapes::PointCloud2d<F>& pc)     { draw_point_cloud(pc, draw_list, local_options); },
+        [&draw_list, &local_options](const shapes::PointPath2d<F>& pp)      { draw_point_path(pp, draw_list, local_options); },
+        [&draw_list, &local_options, vertex_block](const shapes::Edges2d<F>& es) {
+            if (vertex_block) { draw_edge_soup(es, *vertex_block, draw_list, local_options); }
+            else { draw_edge_soup(es, draw_list, local_options); }
+        },
+        [&draw_list, &local_options](const shapes::Triangles2d<F>& tri)     { draw_triangles(tri, draw_list, local_options); },
+        []                          (const shapes::CubicBezierPath2d<F>&)   { assert(0); /* CBP should be converted to point paths first */ },
+        [](const auto&) { assert(0); }
+    }, *draw_command.shape);
+    for (std::size_t idx = first_draw_call; idx < draw_list.m_draw_calls.size(); idx++) { draw_list.m_draw_calls[idx].m_model = draw_command.model; }
+}
 
-    DrawingOptions local_options = options;
+// Draw a shape at the current position of the buffers indices, and return its block. Its shared vertices, if any, are not part of the block.
+template <typename F>
+renderer::DrawList::Block draw_shape_block(const DrawCommand<F>& draw_command, renderer::DrawList& draw_list, DrawingOptions& local_options)
+{
+    const auto* vertex_block = shared_vertex_block(draw_command, draw_list);
+    renderer::DrawList::Block block;
+    block.m_vertices.first = draw_list.m_vertices.consumed();
+    block.m_indices.first = draw_list.m_indices.consumed();
+    block.m_tiles.first = draw_list.m_tiles.consumed();
+    draw_shape(draw_command, draw_list, local_options, vertex_block);
+    block.m_vertices.second = draw_list.m_vertices.consumed();
+    block.m_indices.second = draw_list.m_indices.consumed();
+    block.m_tiles.second = draw_list.m_tiles.consumed();
+    return block;
+}
+
+template <typename F>
+void rebuild_all_blocks(renderer::DrawList& draw_list, const DrawCommands<F>& draw_commands, DrawingOptions& local_options)
+{
+    draw_list.clear_all();
+    draw_list.m_layout.reserve(draw_commands.size());
+    for (const auto& draw_command : draw_commands)
+    {
+        const auto& block = draw_list.m_layout.emplace_back(draw_shape_block(draw_command, draw_list, local_options));
+        if (draw_command.shape_version != 0) { draw_list.m_blocks.emplace(draw_command.shape_version, block); }
+    }
+    draw_list.lock_buffers();
+}
+
+// Keep the blocks of the shapes that are still drawn, and append the blocks of the new ones. Return false if the buffers should be rebuilt.
+template <typename F>
+bool update_blocks(renderer::DrawList& draw_list, const DrawCommands<F>& draw_commands, DrawingOptions& local_options)
+{
+    using Block = renderer::DrawList::Block;
+    const std::size_t nb_commands = draw_commands.size();
+    std::vector<Block> layout(nb_commands);
+    std::vector<std::pair<std::size_t, std::size_t>> draw_calls_ranges(nb_commands);
+    std::vector<bool> is_new_block(nb_commands, false);
+    std::map<renderer::DrawList::BlockKey, Block> blocks;
+    draw_list.clear_draw_calls();
+
+    // Draw calls of the existing blocks (the buffers are locked)
+    for (std::size_t cmd_idx = 0; cmd_idx < nb_commands; cmd_idx++)
+    {
+        const auto& draw_command = draw_commands[cmd_idx];
+        assert(draw_command.shape_version != 0);
+        const auto block_it = draw_list.m_blocks.find(draw_command.shape_version);
+        if (block_it == draw_list.m_blocks.end()) { is_new_block[cmd_idx] = true; continue; }
+        draw_calls_ranges[cmd_idx].first = draw_list.m_draw_calls.size();
+        draw_list.seek(block_it->second);
+        layout[cmd_idx] = draw_shape_block(draw_command, draw_list, local_options);
+        draw_calls_ranges[cmd_idx].second = draw_list.m_draw_calls.size();
+        blocks.emplace(block_it->first, block_it->second);
+    }
+
+    // New blocks, appended at the end of the buffers
+    const bool any_new_block = std::find(is_new_block.cbegin(), is_new_block.cend(), true) != is_new_block.cend();
+    if (any_new_block)
+    {
+        draw_list.unlock_buffers();
+        draw_list.seek_end();
+        for (std::size_t cmd_idx = 0; cmd_idx < nb_commands; cmd_idx++)
+        {
+            if (!is_new_block[cmd_idx]) { continue; }
+            const auto& draw_command = draw_commands[cmd_idx];
+            draw_calls_ranges[cmd_idx].first = draw_list.m_draw_calls.size();
+            layout[cmd_idx] = draw_shape_block(draw_command, draw_list, local_options);
+            draw_calls_ranges[cmd_idx].second = draw_list.m_draw_calls.size();
+            blocks.emplace(draw_command.shape_version, layout[cmd_idx]);
+        }
+        draw_list.lock_buffers();
+    }
+    for (const auto& draw_command : draw_commands)
+    {
+        if (draw_command.shared_vertices == nullptr) { continue; }
+        const auto key = draw_command.shared_vertices->version;
+        assert(draw_list.m_blocks.count(key) == 1);
+        blocks.emplace(key, draw_list.m_blocks.at(key));
+    }
+    draw_list.m_blocks = std::move(blocks);
+    draw_list.m_layout = std::move(layout);
+
+    // The draw calls are issued in the order of the draw commands
+    std::vector<renderer::DrawList::DrawCall> draw_calls;
+    draw_calls.reserve(draw_list.m_draw_calls.size());
+    for (const auto& [begin_idx, end_idx] : draw_calls_ranges)
+    {
+        draw_calls.insert(draw_calls.end(), draw_list.m_draw_calls.cbegin() + static_cast<std::ptrdiff_t>(begin_idx), draw_list.m_draw_calls.cbegin() + static_cast<std::ptrdiff_t>(end_idx));
+    }
+    draw_list.m_draw_calls = std::move(draw_calls);
+
+    return static_cast<double>(draw_list.wasted_vertices()) <= max_wasted_vertices_ratio * static_cast<double>(draw_list.m_vertices.size());
+}
+
+// True if the draw commands are those of the draw list plus a few new shapes, e.g. the shapes of a file as they are parsed: Their blocks
+// are appended at the end of the buffers, and the renderer only uploads them.
+template <typename F>
+bool is_small_append(const renderer::DrawList& draw_list, const DrawCommands<F>& draw_commands)
+{
+    if (draw_list.buffer_version() == 0 || !draw_list.buffers_are_locked() || draw_commands.size() <= draw_list.m_layout.size())
+        return false;
+    std::size_t nb_kept_blocks = 0;
+    std::size_t nb_new_vertices = 0;
     for (const auto& draw_command : draw_commands)
+    {
+        if (draw_command.shape_version == 0)
+            return false;
+        if (draw_list.m_blocks.count(draw_command.shape_version) != 0) { nb_kept_blocks++; }
+        else { nb_new_vertices += shapes::nb_vertices(*draw_command.shape); }
+        if (draw_command.shared_vertices != nullptr && draw_list.m_blocks.count(draw_command.shared_vertices->version) == 0)
+            nb_new_vertices += draw_command.shared_vertices->vertices.size();
+        if (nb_new_vertices > max_inline_append_vertices)
+            return false;
+    }
+    return nb_kept_blocks == draw_list.m_layout.size();     // No block is dropped, therefore the buffers are not rebuilt
+}
+
+} // namespace
+
+template <typename F>
+void update_opengl_draw_list(renderer::DrawList& draw_list, const DrawCommands<F>& draw_commands, bool update_buffers, const DrawingOptions& options)
+{
+    DrawingOptions local_options = options;
+    const bool all_versioned = std::all_of(draw_commands.cbegin(), draw_commands.cend(), [](const auto& draw_command) { return draw_command.shape_version != 0; });
+    const bool same_shapes = !update_buffers && draw_list.m_layout.size() == draw_commands.size();
+    if (draw_list.buffer_version() == 0 || !draw_list.buffers_are_locked() || (!same_shapes && !all_versioned))
+    {
+        rebuild_all_blocks(draw_list, draw_commands, local_options);
+    }
+    else if (!same_shapes)
+    {
+        if (!update_blocks(draw_list, draw_commands, local_options))
+            rebuild_all_blocks(draw_list, draw_commands, local_options);
+    }
+    else
+    {
+        // Same shapes as the previous frame: Only the draw calls are updated
+        draw_list.clear_draw_calls();
+        for (std::size_t cmd_idx = 0; cmd_idx < draw_commands.size(); cmd_idx++)
+        {
+            draw_list.seek(draw_list.m_layout[cmd_idx]);
+            draw_shape(draw_commands[cmd_idx], draw_list, local_options, shared_vertex_block(draw_commands[cmd_idx], draw_list));
+        }
+    }
+    assert(draw_list.buffers_are_locked());
+}
+
+template <typename F>
+RetainedDrawList<F>::RetainedDrawList()
+    : m_buffer_version{0u}
+    , m_draw_commands()
+    , m_options()
+{ }
+
+template <typename F>
+bool RetainedDrawList<F>::update(renderer::DrawList& draw_list, const DrawCommands<F>& draw_commands, bool update_buffers, const DrawingOptions& options)
+{
+    const bool same_input = !update_buffers
+        && m_buffer_version != 0
+        && m_buffer_version == draw_list.buffer_version()
+        && m_draw_commands == draw_commands
+        && m_options == options;
+    if (same_input)
+        return false;
+    update_opengl_draw_list(draw_list, draw_commands, update_buffers, options);
+    renderer::stable_sort_draw_commands(draw_list);
+    m_buffer_version = draw_list.buffer_version();
+    m_draw_commands = draw_commands;
+    for (auto& draw_command : m_draw_commands) { draw_command.release_owners(); }  // Only compared: Do not keep the shapes alive
+    m_options = options;
+    return true;
+}
+
+// The main thread may modify or delete the shapes of the draw commands while the job is running: The job holds a reference on the shapes
+// that are shared (see DrawCommand::shape_owner), and copies the other ones. The copy is much faster than the conversion of the shapes to
+// the draw list, but it is not free on a large input.
+template <typename F>
+struct AsyncDrawList<F>::Job
+{
+    Job(const DrawCommands<F>& draw_commands);
+
+    std::vector<shapes::AllShapes<F>> shapes;
+    std::vector<std::unique_ptr<SharedVertices<F>>> shared_vertices;
+    DrawCommands<F> draw_commands;                      // Point to the shared shapes or to the copies. The retained draw list compares them to
+                                                        // the next draw commands, hence the draw calls of the copies are rebuilt once on the main
+                                                        // thread, from the original shapes.
+    std::future<renderer::DrawList> result;             // Its destructor waits for the worker thread
+};
+
+template <typename F>
+AsyncDrawList<F>::Job::Job(const DrawCommands<F>& draw_commands)
+    : shapes()
+    , shared_vertices()
+    , draw_commands(draw_commands)
+    , result()
+{
+    const auto nb_copies = std::count_if(draw_commands.cbegin(), draw_commands.cend(), [](const auto& draw_command) { return !draw_command.shape_owner; });
+    shapes.reserve(static_cast<std::size_t>(nb_copies));    // The addresses of the shapes are stable
+    std::map<const SharedVertices<F>*, const SharedVertices<F>*> shared_vertices_copies;
+    for (auto& draw_command : this->draw_commands)
     {
         assert(draw_command.shape != nullptr);
-        local_options.vertices = draw_command.vertices;
-        local_options.edges = draw_command.edges;
-        local_options.faces = draw_command.faces;
-        std::visit(stdutils::Overloaded {
-            [&draw_list, &local_options](const shapes::PointCloud2d<F>& pc)     { draw_point_cloud(pc, draw_list, local_options); },
-            [&draw_list, &local_options](const shapes::PointPath2d<F>& pp)      { draw_point_path(pp, draw_list, local_options); },
-            [&draw_list, &local_options](const shapes::Edges2d<F>& es)          { draw_edge_soup(es, draw_list, local_options); },
-            [&draw_list, &local_options](const shapes::Triangles2d<F>& tri)     { draw_triangles(tri, draw_list, local_options); },
-            []                          (const shapes::CubicBezierPath2d<F>&)   { assert(0); /* CBP should be converted to point paths first */ },
-            [](const auto&) { assert(0); }
-        }, *draw_command.shape);
+        if (!draw_command.shape_owner) { draw_command.shape = &shapes.emplace_back(*draw_command.shape); }
+        if (draw_command.shared_vertices == nullptr || draw_command.shared_vertices_owner) { continue; }
+        auto [it, inserted] = shared_vertices_copies.try_emplace(draw_command.shared_vertices, nullptr);
+        if (inserted) { it->second = shared_vertices.emplace_back(std::make_unique<SharedVertices<F>>(*draw_command.shared_vertices)).get(); }
+        draw_command.shared_vertices = it->second;
     }
+}
 
-    // Ensure the buffers are locked
-    assert(draw_list.m_vertices.index_is_aligned());
-    assert(draw_list.m_indices.index_is_aligned());
-    if (draw_list.m_vertices.is_unlocked())
+template <typename F>
+AsyncDrawList<F>::AsyncDrawList()
+    : m_retained_draw_list()
+    , m_update_buffers{false}
+    , m_job()
+{ }
+
+template <typename F>
+AsyncDrawList<F>::~AsyncDrawList() = default;
+
+template <typename F>
+void AsyncDrawList<F>::clear_all()
+{
+    m_job.reset();
+    m_retained_draw_list = RetainedDrawList<F>();
+    m_update_buffers = false;
+}
+
+template <typename F>
+bool AsyncDrawList<F>::update(renderer::DrawList& front_draw_list, const DrawCommands<F>& draw_commands, bool update_buffers, const DrawingOptions& options)
+{
+    m_update_buffers |= update_buffers;
+    bool front_was_updated = false;
+    if (m_job)
+    {
+        if (m_job->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return false;
+        front_draw_list = m_job->result.get();
+        m_job.reset();
+        front_was_updated = true;
+    }
+
+    // Same shapes as the front draw list: Only the draw calls may change
+    const bool same_shapes = !m_update_buffers
+        && front_draw_list.buffer_version() != 0
+        && front_draw_list.buffers_are_locked()
+        && front_draw_list.m_layout.size() == draw_commands.size();
+    if (same_shapes)
+        return m_retained_draw_list.update(front_draw_list, draw_commands, false, options) || front_was_updated;
+
+    // Append-only update of the front draw list: The new shapes are drawn on the main thread, without a copy of the buffers
+    if (is_small_append(front_draw_list, draw_commands))
     {
-        assert(draw_list.m_indices.is_unlocked());
-        draw_list.m_vertices.lock();
-        draw_list.m_indices.lock();
+        m_update_buffers = false;
+        return m_retained_draw_list.update(front_draw_list, draw_commands, true, options) || front_was_updated;
     }
+
+    m_job = std::make_unique<Job>(draw_commands);
+    const bool job_update_buffers = m_update_buffers;
+    m_update_buffers = false;
+    m_job->result = std::async(std::launch::async, [this, &front_draw_list, job_update_buffers, options, job_draw_commands = &m_job->draw_commands]() {
+        renderer::DrawList draw_list = front_draw_list.clone();
+        m_retained_draw_list.update(draw_list, *job_draw_commands, job_update_buffers, options);
+        GLFWWindowContext::post_empty_event();          // Wake up the idle main loop
+        return draw_list;
+    });
+    return front_was_updated;
+}
+
+template <typename F>
+bool AsyncDrawList<F>::has_pending_job() const
+{
+    return static_cast<bool>(m_job);
 }
 
 template <typename F>
 struct CBPSegmentation<F>::Impl
 {
     static constexpr float casteljau_length_resolution_in_screen_space = 1.5f;
-    static constexpr F resolution_relative_delta_threshold = static_cast<F>(1.0E-2);
+    static constexpr int levels_per_octave = 2;                 // Resolution pyramid: The resolution of two consecutive levels differ by sqrt(2)
+    static constexpr int max_level_distance = 4;                // The levels more than two octaves away from the current one are dropped
+
+    // The segmentation of one CBP at the resolution of a level of the pyramid
+    struct Level
+    {
+        std::shared_ptr<const shapes::AllShapes<F>> contour;   // Shared with the draw commands
+        std::uint64_t contour_version;
+    };
+
+    struct Segmentation
+    {
+        explicit Segmentation(const shapes::CubicBezierPath2d<F>& cbp);
+        const Level* nearest_level(int level) const;
+
+        shapes::BoundingBox2d<float> bounding_box;              // Of the control points, hence it contains the CBP
+        std::shared_ptr<const shapes::AllShapes<F>> endpoints;
+        std::uint64_t endpoints_version;
+        std::map<int, Level> levels;                            // The map does not move its elements
+        bool in_use;
+    };
+
+    // The visible CBPs whose level is not cached yet are segmented on a worker thread. Meanwhile, the nearest cached level is drawn.
+    struct Job
+    {
+        struct Input
+        {
+            std::uint64_t version;
+            int level;
+            std::shared_ptr<const shapes::AllShapes<F>> cbp;    // Shared, or a copy: The main thread may modify or delete the shape
+        };
+        struct Output
+        {
+            std::uint64_t version;
+            int level;
+            shapes::PointPath2d<F> contour;
+        };
+        std::future<std::vector<Output>> result;                // Its destructor waits for the worker thread
+    };
 
     Impl();
 
-    const DrawCommands<F>& convert_cbps(const DrawCommands<F>& draw_commands, const Canvas<float>& viewport_canvas, bool geometry_has_changed, bool& new_segmentation);
+    static int resolution_level(F resolution);
+    static F level_resolution(int level);
+
+    bool merge_job_result();
+    void launch_job(std::vector<typename Job::Input>&& inputs);
+    const DrawCommands<F>& convert_cbps(const DrawCommands<F>& draw_commands, const Canvas<float>& viewport_canvas, bool geometry_has_changed, const FrameBudget& frame_budget, bool& new_segmentation);
 
-    F last_segmentation_resolution;
     shapes::CasteljauSamplingCubicBezier2d<F> casteljau_sampler;
-    std::vector<shapes::AllShapes<F>> cbps_endpoints;
-    std::vector<shapes::AllShapes<F>> cbps_contour_segmentation;
+    std::map<std::uint64_t, Segmentation> versioned_segmentations;      // Kept until the shape changes. The map does not move its elements.
+    std::vector<Segmentation> unversioned_segmentations;                // Recomputed each time the geometry changes
+    int unversioned_level;
     DrawCommands<F> result_draw_commands;
+    Job job;                                                            // Last member, so that it is destroyed first
 };
 
+template <typename F>
+CBPSegmentation<F>::Impl::Segmentation::Segmentation(const shapes::CubicBezierPath2d<F>& cbp)
+    : bounding_box()
+    , endpoints(std::make_shared<const shapes::AllShapes<F>>(shapes::extract_endpoints(cbp)))
+    , endpoints_version(new_shape_version())
+    , levels()
+    , in_use(true)
+{
+    const auto bb = shapes::fast_bounding_box(cbp);
+    if (bb.is_populated())
+    {
+        bounding_box.add(static_cast<float>(bb.min().x), static_cast<float>(bb.min().y));
+        bounding_box.add(static_cast<float>(bb.max().x), static_cast<float>(bb.max().y));
+    }
+}
+
+template <typename F>
+const typename CBPSegmentation<F>::Impl::Level* CBPSegmentation<F>::Impl::Segmentation::nearest_level(int level) const
+{
+    if (levels.empty())
+        return nullptr;
+    const auto next_it = levels.lower_bound(level);
+    if (next_it == levels.end())
+        return &std::prev(next_it)->second;
+    if (next_it == levels.begin() || next_it->first == level)
+        return &next_it->second;
+    const auto prev_it = std::prev(next_it);
+    return (level - prev_it->first) <= (next_it->first - level) ? &prev_it->second : &next_it->second;
+}
+
 template <typename F>
 CBPSegmentation<F>::Impl::Impl()
-    : last_segmentation_resolution{1}
-    , casteljau_sampler()
-    , cbps_endpoints()
-    , cbps_contour_segmentation()
+    : casteljau_sampler()
+    , versioned_segmentations()
+    , unversioned_segmentations()
+    , unversioned_level{0}
     , result_draw_commands()
+    , job()
 { }
 
+// The level of a resolution is rounded down, so that the segmentation is at least as fine as required
 template <typename F>
-const DrawCommands<F>& CBPSegmentation<F>::Impl::convert_cbps(const DrawCommands<F>& draw_commands, const Canvas<float>& viewport_canvas, bool geometry_has_changed, bool& new_segmentation)
+int CBPSegmentation<F>::Impl::resolution_level(F resolution)
 {
-    const F resolution = static_cast<F>(viewport_canvas.to_world(casteljau_length_resolution_in_screen_space));
     assert(resolution > 0);
+    return static_cast<int>(std::floor(std::log2(resolution) * static_cast<F>(levels_per_octave)));
+}
 
-    const auto nb_cbps = static_cast<std::size_t>(std::count_if(draw_commands.cbegin(), draw_commands.cend(), [](const auto& draw_cmd) { return shapes::is_bezier_path(*draw_cmd.shape); }));
+template <typename F>
+F CBPSegmentation<F>::Impl::level_resolution(int level)
+{
+    return std::exp2(static_cast<F>(level) / static_cast<F>(levels_per_octave));
+}
+
+// Return true if new segmentations were added to the cache
+template <typename F>
+bool CBPSegmentation<F>::Impl::merge_job_result()
+{
+    if (!job.result.valid() || job.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return false;
+    bool merged = false;
+    for (auto& output : job.result.get())
+    {
+        // The shape may have been modified or deleted in the meantime
+        const auto segmentation_it = versioned_segmentations.find(output.version);
+        if (segmentation_it == versioned_segmentations.end()) { continue; }
+        segmentation_it->second.levels.insert_or_assign(output.level, Level{ std::make_shared<const shapes::AllShapes<F>>(std::move(output.contour)), new_shape_version() });
+        merged = true;
+    }
+    return merged;
+}
+
+template <typename F>
+void CBPSegmentation<F>::Impl::launch_job(std::vector<typename Job::Input>&& inputs)
+{
+    assert(!job.result.valid());
+    job.result = std::async(std::launch::async, [inputs = std::move(inputs)]() {
+        const shapes::CasteljauSamplingCubicBezier2d<F> sampler;
+        std::vector<typename Job::Output> outputs;
+        outputs.reserve(inputs.size());
+        for (const auto& input : inputs)
+        {
+            const auto& cbp = std::get<shapes::CubicBezierPath2d<F>>(*input.cbp);
+            outputs.push_back(typename Job::Output{ input.version, input.level, sampler.sample(cbp, level_resolution(input.level)) });
+        }
+        GLFWWindowContext::post_empty_event();      // Wake up the idle main loop
+        return outputs;
+    });
+}
+
+template <typename F>
+const DrawCommands<F>& CBPSegmentation<F>::Impl::convert_cbps(const DrawCommands<F>& draw_commands, const Canvas<float>& viewport_canvas, bool geometry_has_changed, const FrameBudget& frame_budget, bool& new_segmentation)
+{
+    const int level = resolution_level(static_cast<F>(viewport_canvas.to_world(casteljau_length_resolution_in_screen_space)));
+    const auto view_bounding_box = viewport_canvas.actual_bounding_box();
 
-    const F resolution_relative_delta = std::abs(resolution - last_segmentation_resolution) / last_segmentation_resolution;
+    const auto nb_cbps = static_cast<std::size_t>(std::count_if(draw_commands.cbegin(), draw_commands.cend(), [](const auto& draw_cmd) { return shapes::is_bezier_path(*draw_cmd.shape); }));
+    const auto nb_unversioned_cbps = static_cast<std::size_t>(std::count_if(draw_commands.cbegin(), draw_commands.cend(), [](const auto& draw_cmd) { return draw_cmd.shape_version == 0 && shapes::is_bezier_path(*draw_cmd.shape); }));
 
-    new_segmentation =
+    // The CBPs without a version are all segmented again if anything changed
+    const bool new_unversioned_segmentation =
         geometry_has_changed ||
-        nb_cbps != cbps_contour_segmentation.size() ||
-        resolution_relative_delta > resolution_relative_delta_threshold;
+        nb_unversioned_cbps != unversioned_segmentations.size() ||
+        unversioned_level != level;
+    if (new_unversioned_segmentation)
+    {
+        unversioned_segmentations.clear();
+        unversioned_segmentations.reserve(nb_unversioned_cbps);     // Essential to prevent reallocation and therefore shape pointer invalidation
+        unversioned_level = level;
+    }
+    new_segmentation = new_unversioned_segmentation && nb_unversioned_cbps > 0;
 
-    if (new_segmentation)
+    // The other CBPs are segmented again only if their version changed, or if their level is not cached and they are visible.
+    new_segmentation |= merge_job_result();
+    const bool job_is_running = job.result.valid();
+    std::vector<typename Job::Input> job_inputs;
+    for (auto& [version, segmentation] : versioned_segmentations)
     {
-        // Trigger a new segmentation of all CBPs
-        last_segmentation_resolution = resolution;
-        cbps_endpoints.clear();
-        cbps_contour_segmentation.clear();
-        cbps_endpoints.reserve(nb_cbps);            // Essential to prevent reallocation and therefore shape pointer invalidation
-        cbps_contour_segmentation.reserve(nb_cbps);
+        segmentation.in_use = false;
+        auto& levels = segmentation.levels;
+        for (auto level_it = levels.begin(); level_it != levels.end();)
+        {
+            if (std::abs(level_it->first - level) <= max_level_distance) { ++level_it; }
+            else { level_it = levels.erase(level_it); }
+        }
     }
 
     result_draw_commands.clear();
     result_draw_commands.reserve(draw_commands.size() + nb_cbps);       // Each CBP command spawns an additional draw command for the endpoint vertices
-    std::size_t cbp_idx = 0;
+    std::size_t unversioned_cbp_idx = 0;
     for (const auto& draw_command : draw_commands)
     {
         assert(draw_command.shape != nullptr);
         auto& cpy_draw_cmd = result_draw_commands.emplace_back(draw_command);
         std::visit(stdutils::Overloaded {
-            [this, resolution, new_segmentation, &cpy_draw_cmd, &cbp_idx](const shapes::CubicBezierPath2d<F>& cbp) {
-                if (new_segmentation)
+            [this, level, &view_bounding_box, &frame_budget, new_unversioned_segmentation, job_is_running, &cpy_draw_cmd, &unversioned_cbp_idx, &job_inputs, &new_segmentation](const shapes::CubicBezierPath2d<F>& cbp) {
+                const Segmentation* segmentation = nullptr;
+                const Level* contour_level = nullptr;
+                const auto version = cpy_draw_cmd.shape_version;
+                if (version == 0)
+                {
+                    if (new_unversioned_segmentation)
+                    {
+                        auto& new_unversioned = unversioned_segmentations.emplace_back(cbp);
+                        new_unversioned.levels.emplace(level, Level{ std::make_shared<const shapes::AllShapes<F>>(casteljau_sampler.sample(cbp, level_resolution(level))), new_shape_version() });
+                    }
+                    assert(unversioned_cbp_idx < unversioned_segmentations.size());
+                    segmentation = &unversioned_segmentations[unversioned_cbp_idx++];
+                    contour_level = segmentation->nearest_level(level);
+                }
+                else
+                {
+                    auto segmentation_it = versioned_segmentations.find(version);
+                    if (segmentation_it == versioned_segmentations.end())
+                        segmentation_it = versioned_segmentations.emplace(version, Segmentation(cbp)).first;
+                    auto& versioned = segmentation_it->second;
+                    versioned.in_use = true;
+                    const bool visible = versioned.bounding_box.is_populated() && versioned.bounding_box.intersect(view_bounding_box);
+                    if (visible && versioned.levels.count(level) == 0)
+                    {
+                        if (versioned.levels.empty() && !frame_budget.is_spent())
+                        {
+                            // Nothing to draw in the meantime
+                            versioned.levels.emplace(level, Level{ std::make_shared<const shapes::AllShapes<F>>(casteljau_sampler.sample(cbp, level_resolution(level))), new_shape_version() });
+                            new_segmentation = true;
+                        }
+                        else if (!job_is_running)
+                        {
+                            auto shared_cbp = cpy_draw_cmd.shape_owner ? cpy_draw_cmd.shape_owner : std::make_shared<const shapes::AllShapes<F>>(cbp);
+                            job_inputs.push_back(typename Job::Input{ version, level, std::move(shared_cbp) });
+                        }
+                    }
+                    segmentation = &versioned;
+                    contour_level = versioned.nearest_level(level);         // Null if the CBP was never visible
+                }
+                assert(segmentation);
+                const auto vertices_properties = cpy_draw_cmd.vertices;
+                if (contour_level)
+                {
+                    // Contour draw command
+                    cpy_draw_cmd.shape = contour_level->contour.get();
+                    cpy_draw_cmd.shape_owner = contour_level->contour;
+                    cpy_draw_cmd.shape_version = contour_level->contour_version;
+                    cpy_draw_cmd.vertices.draw = false;
+                }
+                else
                 {
-                    cbps_contour_segmentation.emplace_back(casteljau_sampler.sample(cbp, resolution));
-                    cbps_endpoints.emplace_back(shapes::extract_endpoints(cbp));
+                    result_draw_commands.pop_back();
                 }
-                // Contour draw command
-                assert(cbp_idx < cbps_contour_segmentation.size());
-                cpy_draw_cmd.shape = &cbps_contour_segmentation[cbp_idx];
-                const bool backup_vertices_draw = cpy_draw_cmd.vertices.draw;
-                cpy_draw_cmd.vertices.draw = false;
                 // Endpoints draw command
-                assert(cbp_idx < cbps_endpoints.size());
-                auto& endpoints_draw_cmd = result_draw_commands.emplace_back(cbps_endpoints[cbp_idx]);
-                endpoints_draw_cmd.vertices = cpy_draw_cmd.vertices;
-                endpoints_draw_cmd.vertices.draw = backup_vertices_draw;
+                auto& endpoints_draw_cmd = result_draw_commands.emplace_back(segmentation->endpoints, segmentation->endpoints_version);
+                endpoints_draw_cmd.vertices = vertices_properties;
                 endpoints_draw_cmd.edges.draw = false;
-                cbp_idx++;
             },
             [](const auto&) { /* For non-CBP shapes, leave the copy of the draw command as it is */ }
         }, *draw_command.shape);
     }
-    assert(cbp_idx == nb_cbps);
-    assert(cbps_endpoints.size() == nb_cbps);
-    assert(cbps_contour_segmentation.size() == nb_cbps);
+    assert(unversioned_cbp_idx == nb_unversioned_cbps);
+    assert(unversioned_segmentations.size() == nb_unversioned_cbps);
+
+    // Drop the segmentations of the shapes that were modified or are not drawn anymore
+    for (auto segmentation_it = versioned_segmentations.begin(); segmentation_it != versioned_segmentations.end();)
+    {
+        if (segmentation_it->second.in_use) { ++segmentation_it; }
+        else { segmentation_it = versioned_segmentations.erase(segmentation_it); }
+    }
+
+    if (!job_inputs.empty()) { launch_job(std::move(job_inputs)); }
 
-    assert(result_draw_commands.size() == draw_commands.size() + nb_cbps);
+    assert(result_draw_commands.size() <= draw_commands.size() + nb_cbps);
     return result_draw_commands;
 }
 
@@ -150,11 +631,19 @@ void CBPSegmentation<F>::clear_all()
 }
 
 template <typename F>
-const DrawCommands<F>& CBPSegmentation<F>::convert_cbps(const DrawCommands<F>& draw_commands, const Canvas<float>& viewport_canvas, bool geometry_has_changed, bool& new_segmentation)
+const DrawCommands<F>& CBPSegmentation<F>::convert_cbps(const DrawCommands<F>& draw_commands, const Canvas<float>& viewport_canvas, bool geometry_has_changed, const FrameBudget& frame_budget, bool& new_segmentation)
+{
+    return p_impl->convert_cbps(draw_commands, viewport_canvas, geometry_has_changed, frame_budget, new_segmentation);
+}
+
+template <typename F>
+bool CBPSegmentation<F>::has_pending_job() const
 {
-    return p_impl->convert_cbps(draw_commands, viewport_canvas, geometry_has_changed, new_segmentation);
+    return p_impl->job.result.valid();
 }
 
 // Explicit template instantiations
 template void update_opengl_draw_list<double>(renderer::DrawList&, const DrawCommands<double>&, bool, const DrawingOptions&);
+template class RetainedDrawList<double>;
+template class AsyncDrawList<double>;
 template class CBPSegmentation<double>;
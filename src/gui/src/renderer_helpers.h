@@ -5,6 +5,7 @@
 #include "renderer.h"
 #include "draw_command.h"
 #include "drawing_options.h"
+#include "frame_budget.h"
 
 #include <base/canvas.h>
 
@@ -13,6 +14,47 @@
 template <typename F>
 void update_opengl_draw_list(renderer::DrawList& draw_list, const DrawCommands<F>& draw_commands, bool update_buffers, const DrawingOptions& options);
 
+// Retained mode: The draw list is left untouched as long as its buffers, the draw commands and the drawing options are the same as in the
+// previous frame. Otherwise it is updated and its draw calls are sorted. Return true if the draw list was updated.
+template <typename F>
+class RetainedDrawList {
+public:
+    RetainedDrawList();
+
+    bool update(renderer::DrawList& draw_list, const DrawCommands<F>& draw_commands, bool update_buffers, const DrawingOptions& options);
+
+private:
+    renderer::DrawList::Version m_buffer_version;
+    DrawCommands<F> m_draw_commands;
+    DrawingOptions m_options;
+};
+
+// Double-buffered draw list: The changes of the geometry are applied by a worker thread to a copy of the renderer's draw list (the front
+// one), swapped with it once complete, so that the frame is never blocked by the conversion of the shapes. Meanwhile, the renderer draws
+// the previous geometry. The changes of the draw calls only (colors, visibility) are fast, therefore they are applied on the main thread,
+// and so are the appends of a few small shapes, e.g. those of a file being loaded: The renderer draws them as soon as they are uploaded.
+// The front draw list must not be modified or deleted by anyone else while a job is running: Call clear_all() first.
+template <typename F>
+class AsyncDrawList {
+public:
+    AsyncDrawList();
+    ~AsyncDrawList();
+
+    // Wait for the running job, and discard its result
+    void clear_all();
+
+    // Return true if the front draw list was updated. The geometry changes that arrive while a job is running are applied by the next one.
+    bool update(renderer::DrawList& front_draw_list, const DrawCommands<F>& draw_commands, bool update_buffers, const DrawingOptions& options);
+
+    bool has_pending_job() const;
+
+private:
+    struct Job;
+    RetainedDrawList<F> m_retained_draw_list;           // Accessed by the worker thread while a job is running
+    bool m_update_buffers;                              // A geometry change is waiting for the end of the running job
+    std::unique_ptr<Job> m_job;                         // Last member, so that it is destroyed first
+};
+
 template <typename F>
 class CBPSegmentation {
 public:
@@ -21,7 +63,12 @@ public:
 
     void clear_all();
 
-    const DrawCommands<F>& convert_cbps(const DrawCommands<F>& draw_commands, const Canvas<float>& viewport_canvas, bool geometry_has_changed, bool& new_cbp_segmentation);
+    // The visible CBPs that were never segmented are done synchronously as long as the time budget of the frame is not spent, the other
+    // ones are left to the worker thread. Meanwhile, only their endpoints are drawn.
+    const DrawCommands<F>& convert_cbps(const DrawCommands<F>& draw_commands, const Canvas<float>& viewport_canvas, bool geometry_has_changed, const FrameBudget& frame_budget, bool& new_cbp_segmentation);
+
+    // True if a segmentation job was launched and its result is not merged yet
+    bool has_pending_job() const;
 
 private:
     struct Impl;
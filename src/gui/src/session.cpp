@@ -0,0 +1,185 @@
+#include "session.h"
+
+#include "project.h"
+
+#include <stdutils/parameter.h>
+
+#include <istream>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <system_error>
+
+namespace session {
+
+namespace {
+
+constexpr std::string_view INPUT_FILENAME = "input.shb";
+constexpr std::string_view TRIANGULATIONS_FILENAME = "triangulations.shb";
+constexpr std::string_view SETTINGS_FILENAME = "session.txt";
+constexpr std::string_view SETTINGS_HEADER = "delaunay_viewer_session 1";
+
+// One "key value" line per setting, the name of the shape window first
+void write_settings(std::ostream& out, const Snapshot& snapshot, const Settings& settings, const stdutils::io::ErrorHandler&)
+{
+    const auto& general = settings.read_general_settings();
+    const auto& point = settings.read_point_settings();
+    const auto& path = settings.read_path_settings();
+    const auto& surface = settings.read_surface_settings();
+    out << SETTINGS_HEADER << '\n';
+    out << "name " << snapshot.name << '\n';
+    out << "general.flip_y " << general.flip_y << '\n';
+    out << "general.line_smooth " << general.line_smooth << '\n';
+    out << "general.cdt " << general.cdt << '\n';
+    out << "general.proximity_graphs " << general.proximity_graphs << '\n';
+    out << "general.concurrent_triangulations " << general.concurrent_triangulations << '\n';
+    out << "general.bezier_flatness " << general.bezier_flatness << '\n';
+    out << "general.simplify_paths " << general.simplify_paths << '\n';
+    out << "general.simplification_tolerance " << general.simplification_tolerance << '\n';
+    out << "general.idle_mode " << general.idle_mode << '\n';
+    out << "point.show " << point.show << '\n';
+    out << "point.size " << point.size << '\n';
+    out << "point.color " << point.color << '\n';
+    out << "path.show " << path.show << '\n';
+    out << "path.width " << path.width << '\n';
+    out << "surface.show " << surface.show << '\n';
+    out << "surface.alpha " << surface.alpha << '\n';
+    out << "surface.color " << surface.color << '\n';
+}
+
+using KeyValues = std::map<std::string, std::string>;
+
+KeyValues read_settings(std::istream& in, const stdutils::io::ErrorHandler& err_handler)
+{
+    KeyValues result;
+    std::string line;
+    if (!std::getline(in, line) || line != SETTINGS_HEADER)
+    {
+        err_handler(stdutils::io::Severity::ERR, "Not a session file");
+        return result;
+    }
+    while (std::getline(in, line))
+    {
+        const auto sep = line.find(' ');
+        if (sep == std::string::npos) { continue; }
+        result[line.substr(0, sep)] = line.substr(sep + 1);
+    }
+    return result;
+}
+
+// The values missing from the file, or out of their limits, are left to the current settings or clamped
+template <typename T>
+void read_value(const KeyValues& key_values, const std::string& key, const stdutils::parameter::Limits<T>& limits, T& value)
+{
+    const auto it = key_values.find(key);
+    if (it == key_values.end())
+        return;
+    std::istringstream in(it->second);
+    T read{};
+    if (!(in >> read))
+        return;
+    value = read;
+    limits.clamp(value);
+}
+
+void apply_settings(const KeyValues& key_values, Settings& settings)
+{
+    auto& general = *settings.get_general_settings();
+    const auto& general_limits = Settings::read_general_limits();
+    read_value(key_values, "general.flip_y", general_limits.flip_y, general.flip_y);
+    read_value(key_values, "general.line_smooth", general_limits.line_smooth, general.line_smooth);
+    read_value(key_values, "general.cdt", general_limits.cdt, general.cdt);
+    read_value(key_values, "general.proximity_graphs", general_limits.proximity_graphs, general.proximity_graphs);
+    read_value(key_values, "general.concurrent_triangulations", general_limits.concurrent_triangulations, general.concurrent_triangulations);
+    read_value(key_values, "general.bezier_flatness", general_limits.bezier_flatness, general.bezier_flatness);
+    read_value(key_values, "general.simplify_paths", general_limits.simplify_paths, general.simplify_paths);
+    read_value(key_values, "general.simplification_tolerance", general_limits.simplification_tolerance, general.simplification_tolerance);
+    read_value(key_values, "general.idle_mode", general_limits.idle_mode, general.idle_mode);
+    auto& point = *settings.get_point_settings();
+    read_value(key_values, "point.show", Settings::read_point_limits().show, point.show);
+    read_value(key_values, "point.size", Settings::read_point_limits().size, point.size);
+    read_value(key_values, "point.color", Settings::read_point_limits().color, point.color);
+    auto& path = *settings.get_path_settings();
+    read_value(key_values, "path.show", Settings::read_path_limits().show, path.show);
+    read_value(key_values, "path.width", Settings::read_path_limits().width, path.width);
+    auto& surface = *settings.get_surface_settings();
+    read_value(key_values, "surface.show", Settings::read_surface_limits().show, surface.show);
+    read_value(key_values, "surface.alpha", Settings::read_surface_limits().alpha, surface.alpha);
+    read_value(key_values, "surface.color", Settings::read_surface_limits().color, surface.color);
+}
+
+} // namespace
+
+const std::filesystem::path& default_dir()
+{
+    static const std::filesystem::path session_dir = []() {
+        std::error_code err_code;
+        const auto tmp_dir = std::filesystem::temp_directory_path(err_code);
+        return err_code ? std::filesystem::path() : tmp_dir / project::get_name() / "session";
+    }();
+    return session_dir;
+}
+
+void save(const std::filesystem::path& dir, const Snapshot& snapshot, const Settings& settings, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    std::error_code err_code;
+    std::filesystem::create_directories(dir, err_code);
+    if (err_code)
+    {
+        std::stringstream out;
+        out << "Could not create the session directory " << dir << ": " << err_code.message();
+        err_handler(stdutils::io::Severity::ERR, out.str());
+        return;
+    }
+    // The settings of the previous snapshot are removed first, and the new ones are written last: A snapshot without them is ignored on
+    // load, therefore an interrupted save never pairs settings with the shapes of another snapshot.
+    std::filesystem::remove(dir / SETTINGS_FILENAME, err_code);
+    if (err_code)
+    {
+        std::stringstream out;
+        out << "Could not remove the previous session in " << dir << ": " << err_code.message();
+        err_handler(stdutils::io::Severity::ERR, out.str());
+        return;
+    }
+    bool has_error = false;
+    const stdutils::io::ErrorHandler shapes_err_handler = [&err_handler, &has_error](stdutils::io::SeverityCode code, stdutils::io::ErrorMessage msg) {
+        if (code <= stdutils::io::Severity::ERR) { has_error = true; }
+        err_handler(code, msg);
+    };
+    shapes::io::shb::save_shapes_as_file(dir / INPUT_FILENAME, snapshot.input, shapes_err_handler);
+    shapes::io::shb::save_shapes_as_file(dir / TRIANGULATIONS_FILENAME, snapshot.triangulations, shapes_err_handler);
+    if (has_error)
+        return;
+    stdutils::io::save_txt_file<Snapshot, char>(dir / SETTINGS_FILENAME, [&settings](std::ostream& out, const Snapshot& obj, const stdutils::io::ErrorHandler& handler) {
+        write_settings(out, obj, settings, handler);
+    }, snapshot, err_handler);
+}
+
+bool load(const std::filesystem::path& dir, Snapshot& snapshot, Settings& settings, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    std::error_code err_code;
+    if (!std::filesystem::exists(dir / SETTINGS_FILENAME, err_code) || !std::filesystem::exists(dir / INPUT_FILENAME, err_code))
+        return false;
+    const auto key_values = stdutils::io::open_and_parse_txt_file<KeyValues, char>(dir / SETTINGS_FILENAME, &read_settings, err_handler);
+    const auto name_it = key_values.find("name");
+    if (name_it == key_values.end())
+        return false;
+    snapshot.name = name_it->second;
+    snapshot.input = shapes::io::shb::parse_shapes_from_file(dir / INPUT_FILENAME, err_handler);
+    if (snapshot.input.empty())
+        return false;
+    if (std::filesystem::exists(dir / TRIANGULATIONS_FILENAME, err_code))
+        snapshot.triangulations = shapes::io::shb::parse_shapes_from_file(dir / TRIANGULATIONS_FILENAME, err_handler);
+    apply_settings(key_values, settings);
+    return true;
+}
+
+void clear(const std::filesystem::path& dir) noexcept
+{
+    std::error_code err_code;
+    std::filesystem::remove(dir / SETTINGS_FILENAME, err_code);
+    std::filesystem::remove(dir / INPUT_FILENAME, err_code);
+    std::filesystem::remove(dir / TRIANGULATIONS_FILENAME, err_code);
+}
+
+} // namespace session
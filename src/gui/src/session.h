@@ -0,0 +1,39 @@
+#pragma once
+
+#include "settings.h"
+
+#include <shapes/io.h>
+#include <stdutils/io.h>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+/**
+ * Snapshot of the session, saved on exit and restored on the next startup
+ *
+ * The snapshot is a directory with the input shapes and the triangulations in two SHB files, therefore they are memory-mapped on
+ * startup, and the settings in a text file. The triangulations are restored in place of the first ones computed by the ShapeWindow,
+ * the proximity graphs and the draw lists are computed again.
+ */
+namespace session {
+
+struct Snapshot
+{
+    std::string name;                                   // Name of the shape window
+    shapes::io::ShapeAggregate<double> input;
+    shapes::io::ShapeAggregate<double> triangulations;  // The description of each triangulation is the name of its algorithm
+};
+
+// Return an empty path if there is no temporary directory
+const std::filesystem::path& default_dir();
+
+void save(const std::filesystem::path& dir, const Snapshot& snapshot, const Settings& settings, const stdutils::io::ErrorHandler& err_handler) noexcept;
+
+// Return false if there is no snapshot in the directory, or if it could not be read, in which case the settings are left unchanged
+bool load(const std::filesystem::path& dir, Snapshot& snapshot, Settings& settings, const stdutils::io::ErrorHandler& err_handler) noexcept;
+
+// Remove the snapshot, e.g. once the shape window is closed
+void clear(const std::filesystem::path& dir) noexcept;
+
+} // namespace session
@@ -14,6 +14,19 @@ namespace {
         result.line_smooth = stdutils::parameter::limits_true;
         result.cdt = stdutils::parameter::limits_true;
         result.proximity_graphs = stdutils::parameter::limits_false;
+        result.concurrent_triangulations = stdutils::parameter::limits_true;
+
+        result.bezier_flatness.def = 0.001f;
+        result.bezier_flatness.min = 0.00001f;
+        result.bezier_flatness.max = 0.1f;
+
+        result.simplify_paths = stdutils::parameter::limits_false;
+
+        result.simplification_tolerance.def = 0.001f;
+        result.simplification_tolerance.min = 0.00001f;
+        result.simplification_tolerance.max = 0.05f;
+
+        result.idle_mode = stdutils::parameter::limits_true;
 
         return result;
     }
@@ -28,6 +41,10 @@ namespace {
         result.size.min = 1.f;
         result.size.max = 32.f;
 
+        result.color.def = 0;
+        result.color.min = 0;
+        result.color.max = 1;
+
         return result;
     }
 
@@ -54,6 +71,10 @@ namespace {
         result.alpha.min = 0.0f;
         result.alpha.max = 1.f;
 
+        result.color.def = 0;
+        result.color.min = 0;
+        result.color.max = 3;
+
         return result;
     }
 
@@ -63,7 +84,7 @@ Settings::Settings()
 {
     read_general_settings();
     read_point_settings();
-    read_surface_settings();
+    read_path_settings();
     read_surface_settings();
 }
 
@@ -83,6 +104,11 @@ const Settings::General& Settings::read_general_settings() const
         general_settings->line_smooth = read_general_limits().line_smooth.def;
         general_settings->cdt = read_general_limits().cdt.def;
         general_settings->proximity_graphs = read_general_limits().proximity_graphs.def;
+        general_settings->concurrent_triangulations = read_general_limits().concurrent_triangulations.def;
+        general_settings->bezier_flatness = read_general_limits().bezier_flatness.def;
+        general_settings->simplify_paths = read_general_limits().simplify_paths.def;
+        general_settings->simplification_tolerance = read_general_limits().simplification_tolerance.def;
+        general_settings->idle_mode = read_general_limits().idle_mode.def;
     }
     assert(general_settings);
     return *general_settings;
@@ -107,6 +133,7 @@ const Settings::Point& Settings::read_point_settings() const
         point_settings = std::make_unique<Point>();
         point_settings->show = read_point_limits().show.def;
         point_settings->size = read_point_limits().size.def;
+        point_settings->color = read_point_limits().color.def;
     }
     assert(point_settings);
     return *point_settings;
@@ -155,6 +182,7 @@ const Settings::Surface& Settings::read_surface_settings() const
         surface_settings = std::make_unique<Surface>();
         surface_settings->show = read_surface_limits().show.def;
         surface_settings->alpha = read_surface_limits().alpha.def;
+        surface_settings->color = read_surface_limits().color.def;
     }
     assert(surface_settings);
     return *surface_settings;
@@ -14,6 +14,11 @@ public:
         stdutils::parameter::Limits<bool> line_smooth;
         stdutils::parameter::Limits<bool> cdt;
         stdutils::parameter::Limits<bool> proximity_graphs;
+        stdutils::parameter::Limits<bool> concurrent_triangulations;
+        stdutils::parameter::Limits<float> bezier_flatness;
+        stdutils::parameter::Limits<bool> simplify_paths;
+        stdutils::parameter::Limits<float> simplification_tolerance;
+        stdutils::parameter::Limits<bool> idle_mode;
     };
     struct General
     {
@@ -22,16 +27,23 @@ public:
         bool line_smooth;
         bool cdt;
         bool proximity_graphs;
+        bool concurrent_triangulations;     // If false, the triangulations run one at a time, for a fair comparison of the computation times.
+        float bezier_flatness;              // Tolerance of the sampling of the Bezier paths for the triangulation, relative to the diameter of the geometry.
+        bool simplify_paths;                // Simplify the paths before the triangulation (Douglas-Peucker), preserving their topology.
+        float simplification_tolerance;     // Relative to the diameter of the geometry.
+        bool idle_mode;                     // Only redraw on events, and continuously during an interaction.
     };
     struct PointLimits
     {
         stdutils::parameter::Limits<bool> show;
         stdutils::parameter::Limits<float> size;
+        stdutils::parameter::Limits<int> color;
     };
     struct Point
     {
         bool show;
         float size;
+        int color;                      // renderer::PointColor
     };
     struct PathLimits
     {
@@ -47,11 +59,13 @@ public:
     {
         stdutils::parameter::Limits<bool> show;
         stdutils::parameter::Limits<float> alpha;
+        stdutils::parameter::Limits<int> color;
     };
     struct Surface
     {
         bool show;
         float alpha;
+        int color;                      // renderer::FaceColor
     };
 
 public:
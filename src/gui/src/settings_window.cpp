@@ -34,7 +34,7 @@ void SettingsWindow::visit(bool& can_be_erased, const WindowLayout& win_pos_sz)
     Settings::General* general_settings = m_settings.get_general_settings();
     if (general_settings)
     {
-        //const auto& limits = m_settings.read_general_limits();
+        const auto& limits = m_settings.read_general_limits();
         //ImGui::Dummy(spacing); First section, so no spacing required
         ImGui::BulletTextUnformatted("General");
         ImGui::Indent();
@@ -42,6 +42,12 @@ void SettingsWindow::visit(bool& can_be_erased, const WindowLayout& win_pos_sz)
         ImGui::Checkbox("Line smooth", &(general_settings->line_smooth));
         ImGui::Checkbox("Constrained Delaunay", &(general_settings->cdt));
         ImGui::Checkbox("Proximity Graphs", &(general_settings->proximity_graphs));
+        ImGui::Checkbox("Concurrent triangulations", &(general_settings->concurrent_triangulations));
+        ImGui::SliderFloat("Bezier flatness", &general_settings->bezier_flatness, limits.bezier_flatness.min, limits.bezier_flatness.max, "%.5f", ImGuiSliderFlags_AlwaysClamp | ImGuiSliderFlags_Logarithmic);
+        ImGui::Checkbox("Simplify paths", &(general_settings->simplify_paths));
+        if (general_settings->simplify_paths)
+            ImGui::SliderFloat("Simplification tolerance", &general_settings->simplification_tolerance, limits.simplification_tolerance.min, limits.simplification_tolerance.max, "%.5f", ImGuiSliderFlags_AlwaysClamp | ImGuiSliderFlags_Logarithmic);
+        ImGui::Checkbox("Idle mode", &(general_settings->idle_mode));
         ImGui::Unindent();
     }
 
@@ -67,16 +73,23 @@ void SettingsWindow::visit(bool& can_be_erased, const WindowLayout& win_pos_sz)
         ImGui::Checkbox("Show##Point", &(point_settings->show));
         ImGui::SameLine();
         ImGui::SliderFloat("Size##Point", &point_settings->size, limits.size.min, limits.size.max, "%.3f", ImGuiSliderFlags_AlwaysClamp);
+        ImGui::Combo("Color##Point", &point_settings->color, "Uniform\0Density\0");
+        ImGui::SameLine();
+        ImGui::HelpMarker("Color the pixels by the number of points they hold, from dark red to white, instead of drawing each point. For very large point clouds.");
         ImGui::Unindent();
     }
 
     Settings::Path* path_settings = m_settings.get_path_settings();
     if (path_settings)
     {
+        const auto& limits = m_settings.read_path_limits();
+
         ImGui::Dummy(spacing);
         ImGui::BulletTextUnformatted("Lines");
         ImGui::Indent();
         ImGui::Checkbox("Show##Path", &(path_settings->show));
+        ImGui::SameLine();
+        ImGui::SliderFloat("Width##Path", &path_settings->width, limits.width.min, limits.width.max, "%.3f", ImGuiSliderFlags_AlwaysClamp);
         ImGui::Unindent();
     }
 
@@ -90,6 +103,9 @@ void SettingsWindow::visit(bool& can_be_erased, const WindowLayout& win_pos_sz)
         ImGui::Checkbox("Show##Surface", &(surface_settings->show));
         ImGui::SameLine();
         ImGui::SliderFloat("Alpha##Surface", &surface_settings->alpha, limits.alpha.min, limits.alpha.max, "%.3f", ImGuiSliderFlags_AlwaysClamp);
+        ImGui::Combo("Color##Surface", &surface_settings->color, "Uniform\0Min angle\0Aspect ratio\0Area on screen\0");
+        ImGui::SameLine();
+        ImGui::HelpMarker("Color the faces by the quality of each triangle, computed by the GPU. From red (worst) to blue (best).");
         ImGui::Unindent();
     }
 
@@ -2,27 +2,43 @@
 
 #include "settings.h"
 
+#include <base/opengl_and_glfw.h>
 #include <dt/dt_impl.h>
 #include <dt/dt_interface.h>
 #include <dt/proximity_graphs.h>
+#include <graphs/index.h>
 #include <imgui/imgui.h>
 #include <shapes/bounding_box_algos.h>
+#include <shapes/hash.h>
+#include <shapes/memory.h>
+#include <shapes/path_algos.h>
 #include <shapes/sampling.h>
+#include <shapes/voronoi.h>
 #include <stdutils/chrono.h>
 #include <stdutils/io.h>
 #include <stdutils/macros.h>
+#include <stdutils/memory.h>
+#include <stdutils/parallel.h>
+#include <stdutils/span.h>
 #include <stdutils/visit.h>
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <future>
 #include <iostream>
+#include <iterator>
 #include <sstream>
+#include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
 
 namespace {
     const char* INPUT_TAB_NAME = "Input";
     const char* PROXIMITY_TAB_NAME = "Proximity Graphs";
+    const char* SIDE_BY_SIDE_TAB_NAME = "Side by side";
 
     constexpr ImU32 VertexColor_Default     = IM_COL32(20, 90, 116, 255);
     constexpr ImU32 VertexColor_EdgeSoup    = IM_COL32(105, 116, 20, 255);
@@ -33,6 +49,7 @@ namespace {
     constexpr ImU32 EdgeColor_Constraint    = IM_COL32(222, 91, 94, 255);
     constexpr ImU32 EdgeColor_Highlighted   = IM_COL32(190, 230, 255, 255);
     constexpr ImU32 EdgeColor_Proximity     = IM_COL32(160, 170, 255, 255);
+    constexpr ImU32 EdgeColor_AlphaShape    = IM_COL32(255, 160, 60, 255);
 
     constexpr ImU32 FaceColor_Default       = IM_COL32(80, 82, 105, 255);
     constexpr ImU32 FaceColor_Highlighted   = IM_COL32(170, 210, 255, 255);
@@ -91,6 +108,22 @@ namespace {
         return result;
     }
 
+    template <typename F>
+    const std::vector<shapes::Point2d<F>>& shape_2d_vertices(const shapes::AllShapes<F>& shape)
+    {
+        static const std::vector<shapes::Point2d<F>> no_vertices;
+        const std::vector<shapes::Point2d<F>>* result = &no_vertices;
+        std::visit(stdutils::Overloaded {
+            [&result](const shapes::PointCloud2d<F>& pc)        { result = &pc.vertices; },
+            [&result](const shapes::PointPath2d<F>& pp)         { result = &pp.vertices; },
+            [&result](const shapes::CubicBezierPath2d<F>& cbp)  { result = &cbp.vertices; },
+            [&result](const shapes::Edges2d<F>& es)             { result = &es.vertices; },
+            [&result](const shapes::Triangles2d<F>& tri)        { result = &tri.vertices; },
+            [](const auto&)                                     { /* 3D shapes */ }
+        }, shape);
+        return *result;
+    }
+
     const stdutils::io::ErrorHandler& control_window_error_handler()
     {
         static const stdutils::io::ErrorHandler err_handler = [](stdutils::io::SeverityCode code, std::string_view msg) { std::cout << stdutils::io::str_severity_code(code) << ": " << msg << std::endl; };
@@ -99,19 +132,28 @@ namespace {
 
 } // namespace
 
-ShapeWindow::ShapeControl::ShapeControl(shapes::AllShapes<scalar>&& shape)
+ShapeWindow::ShapeControl::ShapeControl(shapes::AllShapes<scalar>&& shape, std::shared_ptr<const SharedVertices<scalar>> shared_vertices)
     : active(true)
     , force_inactive(false)
     , highlight(false)
     , latest_computation_time_ms(0.f)
-    , vertices(shapes::nb_vertices(shape), VertexColor_Float_Default)
+    , latest_timing_report()
+    , latest_backend_bytes(0)
+    , latest_peak_rss(0)
+    , latest_triangulation_stats()
+    , vertices(shared_vertices ? shared_vertices->vertices.size() : shapes::nb_vertices(shape), VertexColor_Float_Default)
     , edges(   shapes::nb_edges(shape),    EdgeColor_Float_Default)
     , faces(   shapes::nb_faces(shape),    FaceColor_Float_Default)
-    , shape(std::move(shape))
+    , shape_ptr(std::make_shared<shapes::AllShapes<scalar>>(std::move(shape)))
+    , shared_vertices(std::move(shared_vertices))
+    , version(new_shape_version())
     , descr()
     , sampler()
     , req_sampling_length(1.f)
     , sampled_shape(nullptr)
+    , cached_bounding_box()
+    , cached_spatial_index()
+    , cached_content_hash()
 { }
 
 ShapeWindow::ShapeControl::ShapeControl(const ShapeControl& shape_control)
@@ -119,14 +161,23 @@ ShapeWindow::ShapeControl::ShapeControl(const ShapeControl& shape_control)
     , force_inactive(false)
     , highlight(false)
     , latest_computation_time_ms(0.f)
+    , latest_timing_report()
+    , latest_backend_bytes(0)
+    , latest_peak_rss(0)
+    , latest_triangulation_stats()
     , vertices(shape_control.vertices)
     , edges(shape_control.edges)
     , faces(shape_control.faces)
-    , shape(shape_control.shape)
+    , shape_ptr(shape_control.shape_ptr)
+    , shared_vertices(shape_control.shared_vertices)
+    , version(shape_control.version)
     , descr(shape_control.descr)
     , sampler()
     , req_sampling_length(1.f)
     , sampled_shape(nullptr)
+    , cached_bounding_box(shape_control.cached_bounding_box)
+    , cached_spatial_index(shape_control.cached_spatial_index)
+    , cached_content_hash(shape_control.cached_content_hash)
 { }
 
 ShapeWindow::ShapeControl& ShapeWindow::ShapeControl::operator=(const ShapeControl& shape_control)
@@ -135,29 +186,122 @@ ShapeWindow::ShapeControl& ShapeWindow::ShapeControl::operator=(const ShapeContr
     force_inactive = false;
     highlight = false;
     latest_computation_time_ms = 0.f;
+    latest_timing_report = delaunay::TimingReport();
+    latest_backend_bytes = 0;
+    latest_peak_rss = 0;
+    latest_triangulation_stats = shapes::TriangulationStats<scalar>();
     vertices = shape_control.vertices;
     edges = shape_control.edges;
     faces = shape_control.faces;
-    shape = shape_control.shape;
+    shape_ptr = shape_control.shape_ptr;
+    shared_vertices = shape_control.shared_vertices;
+    version = shape_control.version;
     descr = shape_control.descr;
     sampler.reset();
     req_sampling_length = 1.f;
     sampled_shape = nullptr;
+    cached_bounding_box = shape_control.cached_bounding_box;
+    cached_spatial_index = shape_control.cached_spatial_index;
+    cached_content_hash = shape_control.cached_content_hash;
     return *this;
 }
 
-void ShapeWindow::ShapeControl::update(shapes::AllShapes<scalar>&& rep_shape)
+void ShapeWindow::ShapeControl::update(shapes::AllShapes<scalar>&& rep_shape, std::shared_ptr<const SharedVertices<scalar>> rep_shared_vertices)
+{
+    shape_ptr = std::make_shared<shapes::AllShapes<scalar>>(std::move(rep_shape));
+    shared_vertices = std::move(rep_shared_vertices);
+    update();
+}
+
+void ShapeWindow::ShapeControl::update()
 {
-    shape = std::move(rep_shape);
-    vertices.nb = shapes::nb_vertices(shape);
-    edges.nb = shapes::nb_edges(shape);
-    faces.nb = shapes::nb_faces(shape);
+    version = new_shape_version();
+    vertices.nb = shared_vertices ? shared_vertices->vertices.size() : shapes::nb_vertices(shape());
+    edges.nb = shapes::nb_edges(shape());
+    faces.nb = shapes::nb_faces(shape());
+    cached_bounding_box.reset();
+    cached_spatial_index.reset();
+    cached_content_hash.reset();
     // 'active', 'hightlight' remain as-is
 }
 
+const shapes::AllShapes<ShapeWindow::scalar>& ShapeWindow::ShapeControl::shape() const
+{
+    assert(shape_ptr);
+    return *shape_ptr;
+}
+
+std::shared_ptr<const shapes::AllShapes<ShapeWindow::scalar>> ShapeWindow::ShapeControl::shared_shape() const
+{
+    return shape_ptr;
+}
+
+// The copies of the shape control and the draw commands still see the previous shape. Followed by a call to update().
+shapes::AllShapes<ShapeWindow::scalar>& ShapeWindow::ShapeControl::edit_shape()
+{
+    assert(shape_ptr);
+    if (shape_ptr.use_count() > 1) { shape_ptr = std::make_shared<shapes::AllShapes<scalar>>(*shape_ptr); }
+    return *shape_ptr;
+}
+
+const shapes::BoundingBox2d<ShapeWindow::scalar>& ShapeWindow::ShapeControl::bounding_box() const
+{
+    if (!cached_bounding_box && shared_vertices)
+    {
+        cached_bounding_box = shapes::fast_bounding_box(stdutils::parallel::Policy(), *shared_vertices);
+    }
+    if (!cached_bounding_box)
+    {
+        cached_bounding_box = std::visit(stdutils::Overloaded {
+            [](const shapes::PointCloud2d<scalar>& s) { return shapes::fast_bounding_box(stdutils::parallel::Policy(), s); },
+            [](const shapes::PointPath2d<scalar>& s) { return shapes::fast_bounding_box(stdutils::parallel::Policy(), s); },
+            [](const shapes::CubicBezierPath2d<scalar>& s) { return shapes::fast_bounding_box(stdutils::parallel::Policy(), s); },
+            [](const shapes::Edges2d<scalar>& s) { return shapes::fast_bounding_box(stdutils::parallel::Policy(), s); },
+            [](const shapes::Triangles2d<scalar>& s) { return shapes::fast_bounding_box(stdutils::parallel::Policy(), s); },
+            [](const auto&) { assert(0); return shapes::BoundingBox2d<scalar>(); }
+        }, shape());
+    }
+    return *cached_bounding_box;
+}
+
+const shapes::KdTree<ShapeWindow::scalar>& ShapeWindow::ShapeControl::spatial_index() const
+{
+    if (!cached_spatial_index)
+    {
+        cached_spatial_index = std::make_shared<const shapes::KdTree<scalar>>(stdutils::parallel::Policy(), stdutils::make_const_span(shape_vertices()));
+    }
+    return *cached_spatial_index;
+}
+
+std::uint64_t ShapeWindow::ShapeControl::content_hash() const
+{
+    if (!cached_content_hash)
+    {
+        cached_content_hash = shared_vertices ? shapes::content_hash(copy_shape()) : shapes::content_hash(shape());
+    }
+    return *cached_content_hash;
+}
+
+const std::vector<shapes::Point2d<ShapeWindow::scalar>>& ShapeWindow::ShapeControl::shape_vertices() const
+{
+    return shared_vertices ? shared_vertices->vertices : shape_2d_vertices(shape());
+}
+
+shapes::AllShapes<ShapeWindow::scalar> ShapeWindow::ShapeControl::copy_shape() const
+{
+    shapes::AllShapes<scalar> result = shape();
+    if (shared_vertices)
+    {
+        auto* edges_ptr = std::get_if<shapes::Edges2d<scalar>>(&result);
+        assert(edges_ptr != nullptr);
+        if (edges_ptr) { edges_ptr->vertices = shared_vertices->vertices; }
+    }
+    return result;
+}
+
 DrawCommand<ShapeWindow::scalar> ShapeWindow::ShapeControl::to_draw_command(const Settings& settings) const
 {
-    DrawCommand<ShapeWindow::scalar> result(shape);
+    DrawCommand<ShapeWindow::scalar> result(shared_shape(), version, shared_vertices);
     const float surface_alpha = std::clamp(settings.read_surface_settings().alpha, 0.f, 1.f);
     result.vertices.color = get_vertices_color(vertices.color, highlight);
     result.edges.color = get_edges_color(edges.color, highlight);
@@ -173,7 +317,8 @@ ShapeWindow::ShapeWindow(
         shapes::io::ShapeAggregate<scalar>&& shapes,
         const DtTracker<scalar>& dt_tracker,
         ViewportWindow& viewport_window)
-    : m_title(std::string(name) + " Controls")
+    : m_name(name)
+    , m_title(std::string(name) + " Controls")
     , m_dt_tracker(dt_tracker)
     , m_prev_dt_tracker_signature(dt_tracker.state_signature())
     , m_input_shape_controls()
@@ -182,56 +327,137 @@ ShapeWindow::ShapeWindow(
     , m_new_steiner_pt()
     , m_triangulation_policy(delaunay::TriangulationPolicy::PointCloud)
     , m_triangulation_shape_controls()
+    , m_sequential_triangulation_mutex()
+    , m_triangulation_jobs()
+    , m_cancelled_triangulation_jobs()
+    , m_incremental_triangulations()
+    , m_triangulation_cache(TRIANGULATION_CACHE_BYTE_BUDGET)
+    , m_restored_triangulations()
     , m_triangulation_constraint_edges()
     , m_proximity_graphs_controls()
     , m_geometry_bounding_box()
     , m_shape_control_lists()
     , m_draw_command_lists()
     , m_prev_general_settings()
-    , m_first_visit(true)
+    , m_input_has_changed(true)
 {
     m_steiner_shape_control.descr = "Steiner points";
 
+    add_input_shape_controls(std::move(shapes));
+    init_bounding_box();
+    viewport_window.set_geometry_bounding_box(m_geometry_bounding_box);
+}
+
+ShapeWindow::~ShapeWindow()
+{
+    // The destruction of the jobs waits for the worker threads
+    for (auto& [algo_name, job] : m_triangulation_jobs) { job.cancellation->cancel(); }
+}
+
+void ShapeWindow::emplace_input_shape_control(std::vector<ShapeControl>& shape_controls, shapes::AllShapes<scalar>&& shape)
+{
     const auto EdgeColor_Float_EdgeSoup = to_float_color(EdgeColor_EdgeSoup);
     const auto VertexColor_Float_EdgeSoup = to_float_color(VertexColor_EdgeSoup);
-
-    m_input_shape_controls.reserve(shapes.size());
     const auto& err_handler = control_window_error_handler();
+    std::visit(stdutils::Overloaded {
+        [&shape_controls, &err_handler, EdgeColor_Float_EdgeSoup, VertexColor_Float_EdgeSoup](const shapes::Edges2d<scalar>& s) {
+            auto& shape_control = shape_controls.emplace_back(std::move(s));
+            shape_control.descr = "Ignored Input";
+            shape_control.edges.color = EdgeColor_Float_EdgeSoup;
+            shape_control.vertices.color = VertexColor_Float_EdgeSoup;
+            err_handler(stdutils::io::Severity::WARN, "Input shape of type EDGE_SOUP will not be part of the triangulation");
+        },
+        [&shape_controls, &err_handler](const shapes::Triangles2d<scalar>& s) {
+            shape_controls.emplace_back(std::move(s)).descr = "Ignored Input";
+            err_handler(stdutils::io::Severity::WARN, "Input shape of type TRIANGLE_SOUP will not be part of the triangulation");
+        },
+        [&shape_controls](const auto& s) {
+            shape_controls.emplace_back(std::move(s)).descr = INPUT_TAB_NAME;
+        }
+    }, shape);
+}
+
+void ShapeWindow::add_input_shape_controls(shapes::io::ShapeAggregate<scalar>&& shapes)
+{
+    m_input_shape_controls.reserve(m_input_shape_controls.size() + shapes.size());
     for (auto& shape_wrapper : shapes)
-        std::visit(stdutils::Overloaded {
-            [this, &err_handler, EdgeColor_Float_EdgeSoup, VertexColor_Float_EdgeSoup](const shapes::Edges2d<scalar>& s) {
-                auto& shape_control = m_input_shape_controls.emplace_back(std::move(s));
-                shape_control.descr = "Ignored Input";
-                shape_control.edges.color = EdgeColor_Float_EdgeSoup;
-                shape_control.vertices.color = VertexColor_Float_EdgeSoup;
-                err_handler(stdutils::io::Severity::WARN, "Input shape of type EDGE_SOUP will not be part of the triangulation");
-            },
-            [this, &err_handler](const shapes::Triangles2d<scalar>& s) {
-                m_input_shape_controls.emplace_back(std::move(s)).descr = "Ignored Input";
-                err_handler(stdutils::io::Severity::WARN, "Input shape of type TRIANGLE_SOUP will not be part of the triangulation");
-            },
-            [this](const auto& s) {
-                m_input_shape_controls.emplace_back(std::move(s)).descr = INPUT_TAB_NAME;
-            }
-        }, shape_wrapper.shape);
+        emplace_input_shape_control(m_input_shape_controls, std::move(shape_wrapper.shape));
     shapes.clear();
+}
+
+void ShapeWindow::add_input_shapes(shapes::io::ShapeAggregate<scalar>&& shapes, ViewportWindow& viewport_window)
+{
+    if (shapes.empty())
+        return;
+    add_input_shape_controls(std::move(shapes));
     init_bounding_box();
     viewport_window.set_geometry_bounding_box(m_geometry_bounding_box);
+    m_input_has_changed = true;
 }
 
-ShapeWindow::~ShapeWindow() = default;
+std::size_t ShapeWindow::replace_input_shapes(std::size_t first_shape_idx, std::size_t nb_replaced_shapes, shapes::io::ShapeAggregate<scalar>&& shapes, ViewportWindow& viewport_window)
+{
+    assert(first_shape_idx + nb_replaced_shapes <= m_input_shape_controls.size());
+    const auto replaced_begin = m_input_shape_controls.begin() + static_cast<std::ptrdiff_t>(first_shape_idx);
+    const auto replaced_end = replaced_begin + static_cast<std::ptrdiff_t>(nb_replaced_shapes);
+
+    // The replaced shape controls, by content hash
+    std::unordered_multimap<std::uint64_t, std::size_t> replaced_by_hash;
+    replaced_by_hash.reserve(nb_replaced_shapes);
+    for (std::size_t idx = 0; idx < nb_replaced_shapes; idx++)
+    {
+        replaced_by_hash.emplace(m_input_shape_controls[first_shape_idx + idx].content_hash(), idx);
+    }
+
+    // Match the new shapes, in order
+    std::vector<ShapeControl> new_shape_controls;
+    new_shape_controls.reserve(shapes.size());
+    std::vector<bool> is_matched(nb_replaced_shapes, false);
+    std::size_t nb_new_shapes = 0;
+    bool same_order = shapes.size() == nb_replaced_shapes;
+    for (auto& shape_wrapper : shapes)
+    {
+        const auto match_it = replaced_by_hash.find(shapes::content_hash(shape_wrapper.shape));
+        if (match_it == replaced_by_hash.end())
+        {
+            emplace_input_shape_control(new_shape_controls, std::move(shape_wrapper.shape));
+            nb_new_shapes++;
+            same_order = false;
+            continue;
+        }
+        const std::size_t idx = match_it->second;
+        replaced_by_hash.erase(match_it);
+        same_order &= (idx == new_shape_controls.size());
+        is_matched[idx] = true;
+        new_shape_controls.emplace_back(std::move(m_input_shape_controls[first_shape_idx + idx]));
+    }
+    shapes.clear();
+    if (same_order)
+    {
+        // Nothing changed: Put the shape controls back
+        std::move(new_shape_controls.begin(), new_shape_controls.end(), replaced_begin);
+        return 0;
+    }
+
+    // The samplings of the shapes that were removed or modified
+    for (std::size_t idx = 0; idx < nb_replaced_shapes; idx++)
+    {
+        auto& shape_control = m_input_shape_controls[first_shape_idx + idx];
+        if (!is_matched[idx] && shape_control.sampled_shape) { delete_sampled_shape(&shape_control.sampled_shape); }
+    }
+    const auto insert_it = m_input_shape_controls.erase(replaced_begin, replaced_end);
+    m_input_shape_controls.insert(insert_it, std::make_move_iterator(new_shape_controls.begin()), std::make_move_iterator(new_shape_controls.end()));
+    init_bounding_box();
+    viewport_window.set_geometry_bounding_box(m_geometry_bounding_box);
+    m_input_has_changed = true;
+    return nb_new_shapes;
+}
 
 void ShapeWindow::init_bounding_box()
 {
+    m_geometry_bounding_box = shapes::BoundingBox2d<scalar>();
     for (const auto& shape_control : m_input_shape_controls)
-        std::visit(stdutils::Overloaded {
-            [this](const shapes::PointCloud2d<scalar>& s) { m_geometry_bounding_box.merge(shapes::fast_bounding_box(s)); },
-            [this](const shapes::PointPath2d<scalar>& s) { m_geometry_bounding_box.merge(shapes::fast_bounding_box(s)); },
-            [this](const shapes::CubicBezierPath2d<scalar>& s) { m_geometry_bounding_box.merge(shapes::fast_bounding_box(s)); },
-            [this](const shapes::Edges2d<scalar>& s) { m_geometry_bounding_box.merge(shapes::fast_bounding_box(s)); },
-            [this](const shapes::Triangles2d<scalar>& s) { m_geometry_bounding_box.merge(shapes::fast_bounding_box(s)); },
-            [](const auto&) { assert(0); }
-        }, shape_control.shape);
+        m_geometry_bounding_box.merge(shape_control.bounding_box());
     shapes::ensure_min_extent(m_geometry_bounding_box);
 }
 
@@ -255,60 +481,177 @@ ShapeWindow::ShapeControlPtrs ShapeWindow::get_active_input_shapes() const
     return active_shapes;
 }
 
-void ShapeWindow::recompute_triangulations(delaunay::TriangulationPolicy policy, const stdutils::io::ErrorHandler& err_handler)
+void ShapeWindow::recompute_triangulations(delaunay::TriangulationPolicy policy, bool concurrent, scalar bezier_tolerance, scalar simplification_tolerance, const shapes::Point2d<scalar>* new_steiner_pt)
 {
     // Triangulation input
     const auto active_shapes = get_active_input_shapes();
+    TriangulationCacheKey cache_key;
+    cache_key.policy = policy;
+    cache_key.bezier_tolerance = bezier_tolerance;
+    cache_key.simplification_tolerance = simplification_tolerance;
+    cache_key.input_versions.reserve(active_shapes.size());
+    for (const auto* shape_control_ptr : active_shapes) { cache_key.input_versions.push_back(shape_control_ptr->version); }
+
+    // The paths of the input, in the order of the shapes. A Bezier path sampled by the user is replaced by its sampled shape, the other
+    // ones are sampled here: The flat regions get few vertices. The paths are simplified all at once, to preserve the topology between them.
+    const auto is_input_path = [](const ShapeControl* shape_control_ptr) {
+        return std::visit(stdutils::Overloaded {
+            [](const shapes::PointPath2d<scalar>&) { return true; },
+            [shape_control_ptr](const shapes::CubicBezierPath2d<scalar>& cbp) { return shape_control_ptr->sampled_shape == nullptr && !cbp.empty(); },
+            [](const auto&) { return false; }
+        }, shape_control_ptr->shape());
+    };
+    std::vector<shapes::PointPath2d<scalar>> input_paths;
+    for (const auto* shape_control_ptr : active_shapes)
+    {
+        if (!is_input_path(shape_control_ptr))
+            continue;
+        if (const auto* cbp = std::get_if<shapes::CubicBezierPath2d<scalar>>(&shape_control_ptr->shape()))
+        {
+            stdutils::parallel::Policy sampling_policy;
+            sampling_policy.min_chunk_size = 64;        // CBP segments
+            input_paths.emplace_back(shapes::CasteljauSamplingCubicBezier2d<scalar>().sample(sampling_policy, *cbp, bezier_tolerance));
+        }
+        else
+        {
+            input_paths.emplace_back(std::get<shapes::PointPath2d<scalar>>(shape_control_ptr->shape()));
+        }
+    }
+    if (simplification_tolerance > scalar{0})
+    {
+        shapes::SimplificationOptions options;
+        options.tolerance = simplification_tolerance;
+        stdutils::parallel::Policy simplification_policy;
+        simplification_policy.min_chunk_size = 1;       // Paths
+        input_paths = shapes::simplify_paths(simplification_policy, input_paths, options);
+    }
+
+    // Run triangulate(token, result) on a worker thread. All the jobs are launched at once, and each one measures its own computation time.
+    std::mutex* sequential_mutex = concurrent ? nullptr : &m_sequential_triangulation_mutex;
+    const auto launch_job = [sequential_mutex](const delaunay::CancellationToken* token, auto triangulate) {
+        return std::async(std::launch::async, [sequential_mutex, token, triangulate = std::move(triangulate)]() {
+            TriangulationJob::Result result;
+            std::chrono::duration<float, std::milli> duration{0};
+            std::unique_lock<std::mutex> lock;
+            if (sequential_mutex) { lock = std::unique_lock<std::mutex>(*sequential_mutex); }
+            if (!token->is_cancelled())
+            {
+                stdutils::chrono::DurationMeas meas(duration);
+                triangulate(token, result);
+            }
+            if (!token->is_cancelled()) { result.triangulation_stats = shapes::triangulation_stats(stdutils::parallel::Policy(), result.triangulation); }
+            result.computation_time_ms = duration.count();
+            result.peak_rss = stdutils::memory::get_peak_rss();
+            // Wake up the idle main loop. The result is ready right after, well before the few frames rendered after an event.
+            GLFWWindowContext::post_empty_event();
+            return result;
+        });
+    };
 
     // Triangulate
     for (const auto& algo : m_dt_tracker.list_algos())
     {
-        std::chrono::duration<float, std::milli> duration{0};
-        shapes::Triangles2d<scalar> triangulation;
+        // The jobs running on a previous version of the input are stale
+        const bool had_pending_job = m_triangulation_jobs.count(algo.impl.name) > 0;
+        cancel_triangulation_job(algo.impl.name);
 
-        if (algo.active)
+        if (!algo.active)
         {
-            // Setup triangulation
-            auto triangulation_algo = delaunay::get_impl(algo.impl, &err_handler);
-            assert(triangulation_algo);
-            bool first_path = true;
-            for (const auto* shape_control_ptr : active_shapes)
-            {
-                std::visit(stdutils::Overloaded {
-                    [&triangulation_algo](const shapes::PointCloud2d<scalar>& pc) { triangulation_algo->add_steiner(pc); },
-                    [&triangulation_algo, &first_path](const shapes::PointPath2d<scalar>& pp) {
-                        if (first_path) { triangulation_algo->add_path(pp); first_path = false; }
-                        else { triangulation_algo->add_hole(pp); }
-                    },
-                    [](const shapes::CubicBezierPath2d<scalar>&) { /* Skip */ },
-                    [](const shapes::Edges2d<scalar>&) { /* TODO */ },
-                    [](const shapes::Triangles2d<scalar>&) { /* Skip */ },
-                    [](const auto&) { assert(0); }
-                }, shape_control_ptr->shape);
-            }
+            m_incremental_triangulations.erase(algo.impl.name);
+            update_triangulation_output(algo.impl.name, TriangulationJob::Result());
+            continue;
+        }
+
+        TriangulationJob job;
+        job.cancellation = std::make_unique<delaunay::CancellationToken>();
+        job.cache_key = cache_key;
+        job.cache_key.algo_name = algo.impl.name;
+        const auto incremental_it = m_incremental_triangulations.find(algo.impl.name);
+
+        // Only one Steiner point was added to the input: Insert it in the triangulation kept alive by the previous job.
+        // This is not possible if the previous job was still running, since the cancelled job might still be using the algorithm.
+        if (new_steiner_pt && !had_pending_job && incremental_it != m_incremental_triangulations.end())
+        {
+            job.err_log = incremental_it->second.err_log;
+            job.result = launch_job(job.cancellation.get(), [algo_ptr = incremental_it->second.algo, pt = *new_steiner_pt, policy](const delaunay::CancellationToken* token, TriangulationJob::Result& result) {
+                result.triangulation = algo_ptr->triangulate_incremental(policy, stdutils::Span<const shapes::Point2d<scalar>>(&pt, 1), token);
+                result.timing_report = algo_ptr->timing_report();
+                result.backend_bytes = algo_ptr->byte_size();
+            });
+            m_triangulation_jobs.emplace(algo.impl.name, std::move(job));
+            continue;
+        }
+        if (incremental_it != m_incremental_triangulations.end()) { m_incremental_triangulations.erase(incremental_it); }
+
+        // The same input was triangulated before
+        if (const auto* cached_result = m_triangulation_cache.find(job.cache_key))
+        {
+            update_triangulation_output(algo.impl.name, TriangulationJob::Result(*cached_result));
+            continue;
+        }
+        const auto restored_it = m_restored_triangulations.find(algo.impl.name);
+        if (restored_it != m_restored_triangulations.end())
+        {
+            TriangulationJob::Result result;
+            result.triangulation = std::move(restored_it->second);
+            result.triangulation_stats = shapes::triangulation_stats(stdutils::parallel::Policy(), result.triangulation);
+            m_triangulation_cache.insert(std::move(job.cache_key), result, shapes::byte_size(result.triangulation));
+            update_triangulation_output(algo.impl.name, std::move(result));
+            continue;
+        }
 
-            // Triangulate
+        // Setup triangulation. The algorithm holds a copy of the input, so that the input shapes can be edited while the job is running.
+        job.err_log = std::make_shared<stdutils::io::ErrorLog>();
+        const auto job_err_handler = job.err_log->handler();
+        auto triangulation_algo = delaunay::get_impl(algo.impl, &job_err_handler);
+        assert(triangulation_algo);
+        std::size_t path_idx = 0;
+        for (const auto* shape_control_ptr : active_shapes)
+        {
+            if (is_input_path(shape_control_ptr))
             {
-                stdutils::chrono::DurationMeas meas(duration);
-                triangulation = triangulation_algo->triangulate(policy);
+                // The first path is the outer boundary, the next ones are holes
+                if (path_idx == 0) { triangulation_algo->add_path(input_paths[path_idx]); }
+                else { triangulation_algo->add_hole(input_paths[path_idx]); }
+                path_idx++;
+                continue;
             }
+            std::visit(stdutils::Overloaded {
+                [&triangulation_algo](const shapes::PointCloud2d<scalar>& pc) { triangulation_algo->add_steiner(pc); },
+                [](const shapes::PointPath2d<scalar>&) { assert(0); },
+                [](const shapes::CubicBezierPath2d<scalar>&) { /* Sampled by the user, or empty */ },
+                [&triangulation_algo](const shapes::Edges2d<scalar>& edges) { triangulation_algo->add_edges(edges); },
+                [](const shapes::Triangles2d<scalar>&) { /* Skip */ },
+                [](const auto&) { assert(0); }
+            }, shape_control_ptr->shape());
         }
 
-        // Update or create the output shape controls
-        if (m_triangulation_shape_controls[algo.impl.name].delaunay_triangulation)
+        // Triangulate. The algorithms that support it are kept alive after the job, for the next Steiner point.
+        if (triangulation_algo->supports_incremental())
         {
-            m_triangulation_shape_controls[algo.impl.name].delaunay_triangulation->update(std::move(triangulation));
-            m_triangulation_shape_controls[algo.impl.name].delaunay_triangulation->latest_computation_time_ms = duration.count();
+            auto& incremental = m_incremental_triangulations[algo.impl.name];
+            incremental.err_log = job.err_log;
+            incremental.algo = std::move(triangulation_algo);
+            job.result = launch_job(job.cancellation.get(), [algo_ptr = incremental.algo, policy](const delaunay::CancellationToken* token, TriangulationJob::Result& result) {
+                result.triangulation = algo_ptr->triangulate_incremental(policy, stdutils::Span<const shapes::Point2d<scalar>>(), token);
+                result.timing_report = algo_ptr->timing_report();
+                result.backend_bytes = algo_ptr->byte_size();
+            });
         }
-        else if (!triangulation.vertices.empty())
+        else
         {
-            m_triangulation_shape_controls[algo.impl.name].delaunay_triangulation = std::make_unique<ShapeControl>(std::move(triangulation));
-            m_triangulation_shape_controls[algo.impl.name].delaunay_triangulation->descr = std::string("Triangulation from algo: ") + algo.impl.name;
-            m_triangulation_shape_controls[algo.impl.name].delaunay_triangulation->latest_computation_time_ms = duration.count();
+            job.result = launch_job(job.cancellation.get(), [algo_ptr = std::move(triangulation_algo), policy](const delaunay::CancellationToken* token, TriangulationJob::Result& result) {
+                result.backend_bytes = algo_ptr->byte_size();           // Before the input is released
+                result.triangulation = algo_ptr->triangulate_and_release(policy, token);
+                result.timing_report = algo_ptr->timing_report();
+            });
         }
+        m_triangulation_jobs.emplace(algo.impl.name, std::move(job));
     }
 
-    // Constrained edges (those are just the copy of the input shape controls, with a different color)
+    m_restored_triangulations.clear();
+
+    // Constrained edges (those are just the copy of the input shape controls, with a different color. The shapes are shared, not copied.)
     m_triangulation_constraint_edges.clear();
     if (policy == delaunay::TriangulationPolicy::CDT)
     {
@@ -316,9 +659,9 @@ void ShapeWindow::recompute_triangulations(delaunay::TriangulationPolicy policy,
         {
             const bool copy_me = std::visit(stdutils::Overloaded {
                     [](const shapes::PointPath2d<scalar>&) { return true; },
-                    [](const shapes::Edges2d<scalar>&) { /* TODO */ return false; },
+                    [](const shapes::Edges2d<scalar>&) { return true; },
                     [](const auto&) { return false; }
-                }, shape_control_ptr->shape);
+                }, shape_control_ptr->shape());
             if (copy_me)
             {
                 auto& copy_shape_control = m_triangulation_constraint_edges.emplace_back(*shape_control_ptr);
@@ -331,6 +674,78 @@ void ShapeWindow::recompute_triangulations(delaunay::TriangulationPolicy policy,
     }
 }
 
+void ShapeWindow::collect_triangulations(const stdutils::io::ErrorHandler& err_handler, bool& geometry_has_changed)
+{
+    for (auto job_it = m_triangulation_jobs.begin(); job_it != m_triangulation_jobs.end();)
+    {
+        auto& job = job_it->second;
+        if (job.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++job_it;
+            continue;
+        }
+        auto result = job.result.get();
+        job.err_log->forward(err_handler);
+        job.err_log->clear();                               // The log might be shared with the next job
+        if (!result.triangulation.vertices.empty())
+            m_triangulation_cache.insert(std::move(job.cache_key), result, shapes::byte_size(result.triangulation) + stdutils::memory::byte_size(result.timing_report.phases));
+        update_triangulation_output(job_it->first, std::move(result));
+        geometry_has_changed = true;
+        job_it = m_triangulation_jobs.erase(job_it);
+    }
+
+    // Drop the cancelled jobs once they are done, the results are discarded
+    m_cancelled_triangulation_jobs.erase(std::remove_if(m_cancelled_triangulation_jobs.begin(), m_cancelled_triangulation_jobs.end(), [](const auto& job) {
+        return job.result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }), m_cancelled_triangulation_jobs.end());
+}
+
+void ShapeWindow::cancel_triangulation_job(const std::string& algo_name)
+{
+    const auto job_it = m_triangulation_jobs.find(algo_name);
+    if (job_it == m_triangulation_jobs.end())
+        return;
+    job_it->second.cancellation->cancel();
+    m_cancelled_triangulation_jobs.emplace_back(std::move(job_it->second));
+    m_triangulation_jobs.erase(job_it);
+}
+
+void ShapeWindow::update_triangulation_output(const std::string& algo_name, TriangulationJob::Result&& result)
+{
+    auto& delaunay_triangulation = m_triangulation_shape_controls[algo_name].delaunay_triangulation;
+    if (delaunay_triangulation)
+    {
+        delaunay_triangulation->update(std::move(result.triangulation));
+    }
+    else if (!result.triangulation.vertices.empty())
+    {
+        delaunay_triangulation = std::make_unique<ShapeControl>(std::move(result.triangulation));
+        delaunay_triangulation->descr = std::string("Triangulation from algo: ") + algo_name;
+    }
+    else
+    {
+        return;
+    }
+    delaunay_triangulation->latest_computation_time_ms = result.computation_time_ms;
+    delaunay_triangulation->latest_timing_report = std::move(result.timing_report);
+    delaunay_triangulation->latest_backend_bytes = result.backend_bytes;
+    delaunay_triangulation->latest_peak_rss = result.peak_rss;
+    delaunay_triangulation->latest_triangulation_stats = result.triangulation_stats;
+
+    // Keep the alpha shape in sync with the new triangulation
+    auto& triangulation_output = m_triangulation_shape_controls[algo_name];
+    if (triangulation_output.alpha_shape_outline)
+    {
+        const auto* triangles = std::get_if<shapes::Triangles2d<scalar>>(&delaunay_triangulation->shape());
+        if (triangles)
+        {
+            triangulation_output.alpha_shape = std::make_unique<shapes::AlphaShape<scalar>>(stdutils::parallel::Policy(), *triangles);
+            triangulation_output.alpha_shape_version = delaunay_triangulation->version;
+            triangulation_output.alpha_shape_outline->update(triangulation_output.alpha_shape->outline(static_cast<scalar>(triangulation_output.req_alpha)));
+        }
+    }
+}
+
 shapes::PointCloud2d<ShapeWindow::scalar> ShapeWindow::compute_input_point_cloud(const stdutils::io::ErrorHandler& err_handler)
 {
     UNUSED(err_handler);
@@ -345,85 +760,105 @@ shapes::PointCloud2d<ShapeWindow::scalar> ShapeWindow::compute_input_point_cloud
             [](const shapes::Edges2d<scalar>&) { /* Skip */ },
             [](const shapes::Triangles2d<scalar>&) { /* Skip */ },
             [](const auto&) { assert(0); }
-        }, shape_control_ptr->shape);
+        }, shape_control_ptr->shape());
     }
     return input_pc;
 }
 
-void ShapeWindow::compute_proximity_graphs(const stdutils::io::ErrorHandler& err_handler)
+void ShapeWindow::compute_proximity_graphs(const stdutils::io::ErrorHandler& err_handler, const shapes::Point2d<scalar>* new_steiner_pt)
 {
-    const auto input_pc = compute_input_point_cloud(err_handler);
+    auto& incremental = m_proximity_graphs_controls.incremental;
+    const bool inserted = new_steiner_pt && incremental.has_value() && incremental->insert(*new_steiner_pt);
+    if (!inserted)
+    {
+        const auto input_pc = compute_input_point_cloud(err_handler);
+        incremental.emplace(delaunay::incremental_proximity_graphs<scalar>(input_pc, err_handler));
+    }
     auto edges_color = to_float_color(EdgeColor_Proximity);
     float lum_ratio = 0.75f;
+    shapes::ProximityGraphsSelection selection;
+    selection.share_vertices = true;
+    auto graphs = incremental->graphs(selection);
+    m_proximity_graphs_controls.vertices = std::make_shared<const SharedVertices<scalar>>(std::move(graphs.vertices));
 
     // NN
-    auto nn = delaunay::nearest_neighbor(input_pc, err_handler);
     if (m_proximity_graphs_controls.nn_graph)
     {
-        m_proximity_graphs_controls.nn_graph->update(std::move(nn));
+        m_proximity_graphs_controls.nn_graph->update(std::move(graphs.nn), m_proximity_graphs_controls.vertices);
     }
     else
     {
-        m_proximity_graphs_controls.nn_graph = std::make_unique<ShapeControl>(std::move(nn));
+        m_proximity_graphs_controls.nn_graph = std::make_unique<ShapeControl>(std::move(graphs.nn), m_proximity_graphs_controls.vertices);
         m_proximity_graphs_controls.nn_graph->descr = "NN";
         m_proximity_graphs_controls.nn_graph->edges.color = edges_color;
     }
     luminosity(edges_color, lum_ratio);
 
     // MST
-    auto mst = delaunay::minimum_spanning_tree(input_pc, err_handler);
     if (m_proximity_graphs_controls.mst_graph)
     {
-        m_proximity_graphs_controls.mst_graph->update(std::move(mst));
+        m_proximity_graphs_controls.mst_graph->update(std::move(graphs.mst), m_proximity_graphs_controls.vertices);
     }
     else
     {
-        m_proximity_graphs_controls.mst_graph = std::make_unique<ShapeControl>(std::move(mst));
+        m_proximity_graphs_controls.mst_graph = std::make_unique<ShapeControl>(std::move(graphs.mst), m_proximity_graphs_controls.vertices);
         m_proximity_graphs_controls.mst_graph->descr = "MST";
         m_proximity_graphs_controls.mst_graph->edges.color = edges_color;
     }
     luminosity(edges_color, lum_ratio);
 
     // RNG
-    auto rng = delaunay::relative_neighborhood_graph(input_pc, err_handler);
     if (m_proximity_graphs_controls.rng_graph)
     {
-        m_proximity_graphs_controls.rng_graph->update(std::move(rng));
+        m_proximity_graphs_controls.rng_graph->update(std::move(graphs.rng), m_proximity_graphs_controls.vertices);
     }
     else
     {
-        m_proximity_graphs_controls.rng_graph = std::make_unique<ShapeControl>(std::move(rng));
+        m_proximity_graphs_controls.rng_graph = std::make_unique<ShapeControl>(std::move(graphs.rng), m_proximity_graphs_controls.vertices);
         m_proximity_graphs_controls.rng_graph->descr = "RNG";
         m_proximity_graphs_controls.rng_graph->edges.color = edges_color;
     }
     luminosity(edges_color, lum_ratio);
 
     // GG
-    auto gg = delaunay::gabriel_graph(input_pc, err_handler);
     if (m_proximity_graphs_controls.gg_graph)
     {
-        m_proximity_graphs_controls.gg_graph->update(std::move(gg));
+        m_proximity_graphs_controls.gg_graph->update(std::move(graphs.gg), m_proximity_graphs_controls.vertices);
     }
     else
     {
-        m_proximity_graphs_controls.gg_graph = std::make_unique<ShapeControl>(std::move(gg));
+        m_proximity_graphs_controls.gg_graph = std::make_unique<ShapeControl>(std::move(graphs.gg), m_proximity_graphs_controls.vertices);
         m_proximity_graphs_controls.gg_graph->descr = "GG";
         m_proximity_graphs_controls.gg_graph->edges.color = edges_color;
     }
     luminosity(edges_color, lum_ratio);
 
     // DT
-    auto dt = delaunay::delaunay_triangulation(input_pc, err_handler);
     if (m_proximity_graphs_controls.dt_graph)
     {
-        m_proximity_graphs_controls.dt_graph->update(std::move(dt));
+        m_proximity_graphs_controls.dt_graph->update(std::move(graphs.dt), m_proximity_graphs_controls.vertices);
     }
     else
     {
-        m_proximity_graphs_controls.dt_graph = std::make_unique<ShapeControl>(std::move(dt));
+        m_proximity_graphs_controls.dt_graph = std::make_unique<ShapeControl>(std::move(graphs.dt), m_proximity_graphs_controls.vertices);
         m_proximity_graphs_controls.dt_graph->descr = "DT";
         m_proximity_graphs_controls.dt_graph->edges.color = edges_color;
     }
+
+    // Voronoi, clipped to the geometry
+    auto voronoi = shapes::voronoi_diagram(stdutils::parallel::Policy(), incremental->triangulation(), m_geometry_bounding_box);
+    if (m_proximity_graphs_controls.voronoi_diagram)
+    {
+        m_proximity_graphs_controls.voronoi_diagram->update(std::move(voronoi.edges));
+    }
+    else
+    {
+        m_proximity_graphs_controls.voronoi_diagram = std::make_unique<ShapeControl>(std::move(voronoi.edges));
+        m_proximity_graphs_controls.voronoi_diagram->descr = "Voronoi";
+        m_proximity_graphs_controls.voronoi_diagram->edges.color = to_float_color(EdgeColor_Proximity);
+        m_proximity_graphs_controls.voronoi_diagram->vertices.draw = false;
+        m_proximity_graphs_controls.voronoi_diagram->active = false;
+    }
 }
 
 void ShapeWindow::map_shape_controls_by_tabs(bool flag_include_proximity_graphs)
@@ -440,6 +875,8 @@ void ShapeWindow::map_shape_controls_by_tabs(bool flag_include_proximity_graphs)
             continue;
         auto& shape_control_list = m_shape_control_lists.emplace_back(algo_name, ShapeControlPtrs()).second;
         shape_control_list.emplace_back(triangulation_output.delaunay_triangulation.get());
+        if (triangulation_output.alpha_shape_outline)
+            shape_control_list.emplace_back(triangulation_output.alpha_shape_outline.get());
         if(m_steiner_shape_control.active && m_steiner_shape_control.vertices.nb > 0)
             shape_control_list.emplace_back(&m_steiner_shape_control);
         for (const auto& constraint_edges_shape_control : m_triangulation_constraint_edges)
@@ -451,6 +888,7 @@ void ShapeWindow::map_shape_controls_by_tabs(bool flag_include_proximity_graphs)
     {
         auto& shape_control_list = m_shape_control_lists.emplace_back(PROXIMITY_TAB_NAME, ShapeControlPtrs()).second;
         std::vector<const ShapeControl*> proxi_graphs = {
+            m_proximity_graphs_controls.voronoi_diagram.get(),
             m_proximity_graphs_controls.dt_graph.get(),
             m_proximity_graphs_controls.gg_graph.get(),
             m_proximity_graphs_controls.rng_graph.get(),
@@ -485,6 +923,28 @@ void ShapeWindow::build_draw_lists(const Settings& settings)
             return shape_control->to_draw_command(settings);
         });
     });
+
+    // With several triangulations, one more tab shows them side by side: The renderer moves each of them along the X-axis, without
+    // another copy of their buffers
+    const auto nb_triangulations = std::count_if(m_triangulation_shape_controls.cbegin(), m_triangulation_shape_controls.cend(), [](const auto& kvp) { return static_cast<bool>(kvp.second.delaunay_triangulation); });
+    if (nb_triangulations >= 2)
+    {
+        DrawCommands<scalar> side_by_side;
+        const float step = 1.1f * static_cast<float>(m_geometry_bounding_box.width());
+        float offset = 0.f;
+        for (const auto& [key, draw_commands] : m_draw_command_lists)
+        {
+            if (m_triangulation_shape_controls.count(key) == 0)
+                continue;
+            for (const auto& draw_command : draw_commands)
+            {
+                auto& moved_draw_command = side_by_side.emplace_back(draw_command);
+                moved_draw_command.model.offset = { offset, 0.f };
+            }
+            offset += step;
+        }
+        m_draw_command_lists.emplace_back(SIDE_BY_SIDE_TAB_NAME, std::move(side_by_side));
+    }
 }
 
 shapes::io::ShapeAggregate<ShapeWindow::scalar> ShapeWindow::get_triangulation_input_aggregate() const
@@ -500,12 +960,63 @@ shapes::io::ShapeAggregate<ShapeWindow::scalar> ShapeWindow::get_tab_aggregate(c
     {
         for (const ShapeControl* shape_control_ptr : list_it->second)
         {
-            result.emplace_back(shape_control_ptr->shape, shape_control_ptr->descr);
+            result.emplace_back(shape_control_ptr->copy_shape(), shape_control_ptr->descr);
+        }
+    }
+    return result;
+}
+
+shapes::io::ShapeAggregate<ShapeWindow::scalar> ShapeWindow::get_triangulations_aggregate() const
+{
+    shapes::io::ShapeAggregate<scalar> result;
+    for (const auto& [algo_name, triangulation_output] : m_triangulation_shape_controls)
+    {
+        if (triangulation_output.delaunay_triangulation)
+        {
+            result.emplace_back(triangulation_output.delaunay_triangulation->copy_shape(), algo_name);
         }
     }
     return result;
 }
 
+void ShapeWindow::restore_triangulations(shapes::io::ShapeAggregate<scalar>&& triangulations)
+{
+    m_restored_triangulations.clear();
+    for (auto& shape_wrapper : triangulations)
+    {
+        if (auto* triangles = std::get_if<shapes::Triangles2d<scalar>>(&shape_wrapper.shape))
+        {
+            m_restored_triangulations[shape_wrapper.descr] = std::move(*triangles);
+        }
+    }
+    triangulations.clear();
+}
+
+std::size_t ShapeWindow::shapes_byte_size() const
+{
+    std::size_t result = shapes::byte_size(m_steiner_shape_control.shape());
+    for (const auto& shape_control : m_input_shape_controls) { result += shapes::byte_size(shape_control.shape()); }
+    for (const auto& shape_control : m_sampled_shape_controls) { result += shapes::byte_size(shape_control->shape()); }
+    // The constraint edges share the shapes of the input shape controls
+    for (const auto& [algo_name, triangulation_output] : m_triangulation_shape_controls)
+    {
+        if (triangulation_output.delaunay_triangulation) { result += shapes::byte_size(triangulation_output.delaunay_triangulation->shape()); }
+    }
+    for (const auto* graph : { &m_proximity_graphs_controls.nn_graph, &m_proximity_graphs_controls.mst_graph, &m_proximity_graphs_controls.rng_graph,
+                               &m_proximity_graphs_controls.gg_graph, &m_proximity_graphs_controls.dt_graph, &m_proximity_graphs_controls.voronoi_diagram })
+    {
+        if (*graph) { result += shapes::byte_size((*graph)->shape()); }
+    }
+    if (m_proximity_graphs_controls.vertices) { result += stdutils::memory::byte_size(m_proximity_graphs_controls.vertices->vertices); }
+    result += m_triangulation_cache.byte_size();
+    return result;
+}
+
+std::size_t ShapeWindow::nb_triangulation_jobs() const
+{
+    return m_triangulation_jobs.size() + m_cancelled_triangulation_jobs.size();
+}
+
 ShapeWindow::ShapeControl* ShapeWindow::allocate_new_sampled_shape(const ShapeControl& parent, shapes::AllShapes<scalar>&& shape)
 {
     const auto& new_shape = m_sampled_shape_controls.emplace_back(std::make_unique<ShapeControl>(std::move(shape)));
@@ -576,18 +1087,18 @@ void ShapeWindow::shape_list_menu(ShapeControl& shape_control, unsigned int idx,
     }
 
     // Tinker with the shape: Point Cloud <-> Point Path, Open <-> Closed
-    if (allow_tinkering && shape_control.sampled_shape == nullptr && (shapes::is_point_cloud(shape_control.shape) || shapes::is_point_path(shape_control.shape)))
+    if (allow_tinkering && shape_control.sampled_shape == nullptr && (shapes::is_point_cloud(shape_control.shape()) || shapes::is_point_path(shape_control.shape())))
     {
         ImGui::SameLine(0, 30);
         std::stringstream path_checkbox;
         path_checkbox << "Path#" << idx;
         ImGui::PushID(path_checkbox.str().c_str());
-        bool is_path = shapes::is_point_path(shape_control.shape);
+        bool is_path = shapes::is_point_path(shape_control.shape());
         const bool swap_shape_type = ImGui::Checkbox("Path", &is_path);
         ImGui::PopID();
         if (swap_shape_type)
         {
-            auto temp_shape = swap_shape_type_point_cloud_and_point_path(std::move(shape_control.shape));
+            auto temp_shape = swap_shape_type_point_cloud_and_point_path(std::move(shape_control.edit_shape()));
             shape_control.update(std::move(temp_shape));
             geometry_has_changed = true;
         }
@@ -597,13 +1108,13 @@ void ShapeWindow::shape_list_menu(ShapeControl& shape_control, unsigned int idx,
             std::stringstream topo_checkbox;
             topo_checkbox << "Closed#" << idx;
             ImGui::PushID(topo_checkbox.str().c_str());
-            bool is_closed = shapes::is_closed(shape_control.shape);
+            bool is_closed = shapes::is_closed(shape_control.shape());
             const bool swap_topo = ImGui::Checkbox("Closed", &is_closed);
             ImGui::PopID();
             if(swap_topo)
             {
-                shapes::flip_open_closed(shape_control.shape);
-                shape_control.edges.nb = shapes::nb_edges(shape_control.shape);
+                shapes::flip_open_closed(shape_control.edit_shape());
+                shape_control.update();
                 geometry_has_changed = true;
             }
         }
@@ -611,14 +1122,14 @@ void ShapeWindow::shape_list_menu(ShapeControl& shape_control, unsigned int idx,
 
     // Color pickers
     ImGui::ColorEdit4("Point color", shape_control.vertices.color.data(), ImGuiColorEditFlags_NoInputs);
-    if (shapes::has_edges(shape_control.shape)) { ImGui::SameLine(); ImGui::ColorEdit4("Edge color", shape_control.edges.color.data(), ImGuiColorEditFlags_NoInputs); }
-    if (shapes::has_faces(shape_control.shape)) { ImGui::SameLine(); ImGui::ColorEdit4("Face color", shape_control.faces.color.data(), ImGuiColorEditFlags_NoInputs); }
+    if (shapes::has_edges(shape_control.shape())) { ImGui::SameLine(); ImGui::ColorEdit4("Edge color", shape_control.edges.color.data(), ImGuiColorEditFlags_NoInputs); }
+    if (shapes::has_faces(shape_control.shape())) { ImGui::SameLine(); ImGui::ColorEdit4("Face color", shape_control.faces.color.data(), ImGuiColorEditFlags_NoInputs); }
 
     // Info
     ImGui::Text("Nb vertices: %ld, nb edges: %ld", shape_control.vertices.nb, shape_control.edges.nb);
 
     // Sampling
-    if (allow_sampling && (shapes::is_bezier_path(shape_control.shape) || shapes::is_point_path(shape_control.shape)))
+    if (allow_sampling && (shapes::is_bezier_path(shape_control.shape()) || shapes::is_point_path(shape_control.shape())))
     {
         std::stringstream sample_checkbox;
         sample_checkbox << "Sample##" << idx;
@@ -626,16 +1137,18 @@ void ShapeWindow::shape_list_menu(ShapeControl& shape_control, unsigned int idx,
         ImGui::Checkbox(sample_checkbox.str().c_str(), &is_sampled);
         if (is_sampled && !shape_control.sampled_shape)
         {
-            shape_control.sampled_shape = allocate_new_sampled_shape(shape_control, shapes::trivial_sampling(shape_control.shape));
-            if (std::holds_alternative<shapes::CubicBezierPath2d<scalar>>(shape_control.shape))
+            shape_control.sampled_shape = allocate_new_sampled_shape(shape_control, shapes::trivial_sampling(shape_control.shape()));
+            if (std::holds_alternative<shapes::CubicBezierPath2d<scalar>>(shape_control.shape()))
             {
-                const auto& cbp = std::get<shapes::CubicBezierPath2d<scalar>>(shape_control.shape);
-                shape_control.sampler = std::make_unique<shapes::UniformSamplingCubicBezier2d<scalar>>(cbp);
+                const auto& cbp = std::get<shapes::CubicBezierPath2d<scalar>>(shape_control.shape());
+                stdutils::parallel::Policy sampling_policy;
+                sampling_policy.min_chunk_size = 64;        // CBP segments
+                shape_control.sampler = std::make_unique<shapes::UniformSamplingCubicBezier2d<scalar>>(sampling_policy, cbp);
                 shape_control.req_sampling_length = static_cast<float>(shape_control.sampler->max_segment_length());
             }
-            else if (std::holds_alternative<shapes::PointPath2d<scalar>>(shape_control.shape))
+            else if (std::holds_alternative<shapes::PointPath2d<scalar>>(shape_control.shape()))
             {
-                const auto& pp = std::get<shapes::PointPath2d<scalar>>(shape_control.shape);
+                const auto& pp = std::get<shapes::PointPath2d<scalar>>(shape_control.shape());
                 shape_control.active = false;
                 shape_control.force_inactive = true;
                 shape_control.sampler = std::make_unique<shapes::UniformSamplingPointPath2d<scalar>>(pp);
@@ -670,10 +1183,69 @@ void ShapeWindow::shape_list_menu(ShapeControl& shape_control, unsigned int idx,
     ImGui::TreePop();
 }
 
+void ShapeWindow::alpha_shape_menu(TriangulationOutput& triangulation_output, bool& geometry_has_changed)
+{
+    assert(triangulation_output.delaunay_triangulation);
+    const auto& triangulation_shape_control = *triangulation_output.delaunay_triangulation;
+    const auto* triangles = std::get_if<shapes::Triangles2d<scalar>>(&triangulation_shape_control.shape());
+    if (!triangles)
+        return;
+    bool show_alpha_shape = static_cast<bool>(triangulation_output.alpha_shape_outline);
+    ImGui::Checkbox("Alpha shape", &show_alpha_shape);
+    ImGui::SameLine();
+    ImGui::HelpMarker("The outline of the triangles whose circumradius is lower or equal to alpha");
+    if (!show_alpha_shape)
+    {
+        if (triangulation_output.alpha_shape_outline)
+        {
+            triangulation_output.alpha_shape.reset();
+            triangulation_output.alpha_shape_outline.reset();
+            geometry_has_changed = true;
+        }
+        return;
+    }
+
+    // The faces are sorted by circumradius once per triangulation, then each value of alpha is a cheap query
+    bool alpha_has_changed = false;
+    if (!triangulation_output.alpha_shape || triangulation_output.alpha_shape_version != triangulation_shape_control.version)
+    {
+        triangulation_output.alpha_shape = std::make_unique<shapes::AlphaShape<scalar>>(stdutils::parallel::Policy(), *triangles);
+        triangulation_output.alpha_shape_version = triangulation_shape_control.version;
+        alpha_has_changed = true;
+    }
+    const auto& radii = triangulation_output.alpha_shape->sorted_radii();
+    const auto last_finite = std::find_if(radii.crbegin(), radii.crend(), [](scalar r) { return std::isfinite(r); });
+    if (last_finite == radii.crend())
+        return;
+    const float max = 1.05f * static_cast<float>(*last_finite);
+    const float min = std::max(static_cast<float>(radii.front()), max / 1000.f);
+    float new_alpha = triangulation_output.req_alpha > 0.f ? triangulation_output.req_alpha : max;
+    ImGui::SliderFloat("Alpha", &new_alpha, min, max, "%.3g", ImGuiSliderFlags_Logarithmic | ImGuiSliderFlags_AlwaysClamp);
+    alpha_has_changed |= (new_alpha != triangulation_output.req_alpha);
+    if (alpha_has_changed)
+    {
+        triangulation_output.req_alpha = new_alpha;
+        auto outline = triangulation_output.alpha_shape->outline(static_cast<scalar>(new_alpha));
+        if (triangulation_output.alpha_shape_outline)
+        {
+            triangulation_output.alpha_shape_outline->update(std::move(outline));
+        }
+        else
+        {
+            triangulation_output.alpha_shape_outline = std::make_unique<ShapeControl>(std::move(outline));
+            triangulation_output.alpha_shape_outline->descr = "Alpha shape";
+            triangulation_output.alpha_shape_outline->edges.color = to_float_color(EdgeColor_AlphaShape);
+            triangulation_output.alpha_shape_outline->vertices.draw = false;
+        }
+        geometry_has_changed = true;
+    }
+    ImGui::Text("Nb faces: %ld, nb border edges: %ld", triangulation_output.alpha_shape->nb_faces(static_cast<scalar>(new_alpha)), triangulation_output.alpha_shape_outline->edges.nb);
+}
+
 void ShapeWindow::visit(bool& can_be_erased, const Settings& settings, const WindowLayout& win_pos_sz, bool& geometry_has_changed)
 {
-    geometry_has_changed = m_first_visit;
-    m_first_visit = false;
+    geometry_has_changed = m_input_has_changed;
+    m_input_has_changed = false;
 
     const auto& err_handler = control_window_error_handler();
 
@@ -683,6 +1255,20 @@ void ShapeWindow::visit(bool& can_be_erased, const Settings& settings, const Win
     const bool display_proximity_graphs = settings.read_general_settings().proximity_graphs;
     if (display_proximity_graphs != m_prev_general_settings.proximity_graphs)
         geometry_has_changed = true;
+
+    const bool concurrent_triangulations = settings.read_general_settings().concurrent_triangulations;
+    if (concurrent_triangulations != m_prev_general_settings.concurrent_triangulations)
+        geometry_has_changed = true;
+
+    const float bezier_flatness = settings.read_general_settings().bezier_flatness;
+    if (bezier_flatness != m_prev_general_settings.bezier_flatness)
+        geometry_has_changed = true;
+    const scalar bezier_tolerance = static_cast<scalar>(bezier_flatness) * m_geometry_bounding_box.diameter();
+    const bool simplify_paths = settings.read_general_settings().simplify_paths;
+    const float simplification_tolerance = settings.read_general_settings().simplification_tolerance;
+    if (simplify_paths != m_prev_general_settings.simplify_paths || (simplify_paths && simplification_tolerance != m_prev_general_settings.simplification_tolerance))
+        geometry_has_changed = true;
+    const scalar path_tolerance = simplify_paths ? static_cast<scalar>(simplification_tolerance) * m_geometry_bounding_box.diameter() : scalar{0};
     m_prev_general_settings = settings.read_general_settings();
 
     const auto dt_tracker_signature = m_dt_tracker.state_signature();
@@ -778,17 +1364,21 @@ void ShapeWindow::visit(bool& can_be_erased, const Settings& settings, const Win
         }
     }
 
+    // If the only change of this frame is a new Steiner point, the triangulations are updated incrementally
+    const bool geometry_has_changed_before_steiner_pt = geometry_has_changed;
+    std::optional<shapes::Point2d<scalar>> added_steiner_pt;
     if (m_new_steiner_pt.has_value())
     {
         auto new_pt = m_new_steiner_pt.value();     // Tried to take the contained value with *std::move(m_new_steiner_pt), it didn't work.
         m_new_steiner_pt.reset();
-        auto& pc = std::get<shapes::PointCloud2d<scalar>>(m_steiner_shape_control.shape);
+        const auto& pc = std::get<shapes::PointCloud2d<scalar>>(m_steiner_shape_control.shape());
         const auto pt_it = std::find(std::cbegin(pc.vertices), std::cend(pc.vertices), new_pt);
         if (pt_it == std::cend(pc.vertices))
         {
-            pc.vertices.emplace_back(std::move(new_pt));
-            m_steiner_shape_control.vertices.nb = pc.vertices.size();
+            std::get<shapes::PointCloud2d<scalar>>(m_steiner_shape_control.edit_shape()).vertices.emplace_back(new_pt);
+            m_steiner_shape_control.update();
             geometry_has_changed = true;
+            if (m_steiner_shape_control.active) { added_steiner_pt = new_pt; }
         }
         else
         {
@@ -801,10 +1391,16 @@ void ShapeWindow::visit(bool& can_be_erased, const Settings& settings, const Win
     {
         const unsigned int shape_idx = 1;
         bool trash = true;
-        shape_list_menu(m_steiner_shape_control, shape_idx, !ALLOW_SAMPLING, !ALLOW_TINKERING, trash, geometry_has_changed);
+        bool steiner_menu_has_changed = false;
+        shape_list_menu(m_steiner_shape_control, shape_idx, !ALLOW_SAMPLING, !ALLOW_TINKERING, trash, steiner_menu_has_changed);
         if (trash)
         {
             m_steiner_shape_control.update(shapes::PointCloud2d<scalar>());
+            steiner_menu_has_changed = true;
+        }
+        if (steiner_menu_has_changed)
+        {
+            added_steiner_pt.reset();
             geometry_has_changed = true;
         }
         ImGui::TreePop();
@@ -813,10 +1409,18 @@ void ShapeWindow::visit(bool& can_be_erased, const Settings& settings, const Win
     // Triangulate
     if (geometry_has_changed)
     {
-        recompute_triangulations(triangulation_policy, err_handler);
+        const bool incremental = !geometry_has_changed_before_steiner_pt && added_steiner_pt.has_value();
+        recompute_triangulations(triangulation_policy, concurrent_triangulations, bezier_tolerance, path_tolerance, incremental ? &*added_steiner_pt : nullptr);
         m_triangulation_policy = triangulation_policy;
         if (display_proximity_graphs)
-            compute_proximity_graphs(err_handler);
+            compute_proximity_graphs(err_handler, incremental ? &*added_steiner_pt : nullptr);
+        else
+            m_proximity_graphs_controls.incremental.reset();
+    }
+    collect_triangulations(err_handler, geometry_has_changed);
+    if (!m_triangulation_jobs.empty())
+    {
+        ImGui::Text("Computing triangulations (%d pending)...", static_cast<int>(m_triangulation_jobs.size()));
     }
 
     // Triangulation shapes
@@ -842,8 +1446,33 @@ void ShapeWindow::visit(bool& can_be_erased, const Settings& settings, const Win
                 // Info
                 ImGui::Text("Nb vertices: %ld, nb edges: %ld, nb faces: %ld", triangulation_shape_control.vertices.nb, triangulation_shape_control.edges.nb, triangulation_shape_control.faces.nb);
                 ImGui::Text("Computation time: %0.3g ms", static_cast<double>(triangulation_shape_control.latest_computation_time_ms));
+                const auto& phases = triangulation_shape_control.latest_timing_report.phases;
+                if (!phases.empty() && ImGui::TreeNode("Phases"))
+                {
+                    for (const auto& phase : phases)
+                        ImGui::Text("%s: %0.3g ms", phase.name, static_cast<double>(phase.duration_ms));
+                    ImGui::TreePop();
+                }
+                const auto& quality = triangulation_shape_control.latest_triangulation_stats;
+                if (quality.min_angle.n > 0 && ImGui::TreeNode("Quality"))
+                {
+                    const auto stats_text = [](const char* name, const stdutils::stats::Result<scalar>& stats) {
+                        ImGui::Text("%s: min %0.3g, mean %0.3g, stdev %0.3g, max %0.3g", name, static_cast<double>(stats.min), static_cast<double>(stats.mean), static_cast<double>(stats.stdev), static_cast<double>(stats.max));
+                    };
+                    stats_text("Min angle (deg)", quality.min_angle);
+                    stats_text("Aspect ratio", quality.aspect_ratio);
+                    stats_text("Area", quality.area);
+                    stats_text("Edge length", quality.edge_length);
+                    ImGui::Text("Degenerate faces: %ld", quality.nb_degenerate_faces);
+                    ImGui::TreePop();
+                }
+                ImGui::Text("Memory: output %s, algorithm %s, peak RSS %s",
+                    stdutils::memory::to_string(stdutils::memory::HumanReadable{ shapes::byte_size(triangulation_shape_control.shape()) }).c_str(),
+                    stdutils::memory::to_string(stdutils::memory::HumanReadable{ triangulation_shape_control.latest_backend_bytes }).c_str(),
+                    stdutils::memory::to_string(stdutils::memory::HumanReadable{ triangulation_shape_control.latest_peak_rss }).c_str());
                 ImGui::TreePop();
             }
+            alpha_shape_menu(triangulation_output, geometry_has_changed);
 
             ImGui::TreePop();
         }
@@ -861,6 +1490,7 @@ void ShapeWindow::visit(bool& can_be_erased, const Settings& settings, const Win
             if (m_proximity_graphs_controls.rng_graph) { proxi_graphs.emplace_back("RNG", m_proximity_graphs_controls.rng_graph.get()); }
             if (m_proximity_graphs_controls.gg_graph) { proxi_graphs.emplace_back("GG", m_proximity_graphs_controls.gg_graph.get()); }
             if (m_proximity_graphs_controls.dt_graph) { proxi_graphs.emplace_back("DT", m_proximity_graphs_controls.dt_graph.get()); }
+            if (m_proximity_graphs_controls.voronoi_diagram) { proxi_graphs.emplace_back("Voronoi", m_proximity_graphs_controls.voronoi_diagram.get()); }
 
             unsigned int idx = 0;
             for (const auto& [graph_name, shape_control] : proxi_graphs)
@@ -903,3 +1533,33 @@ void ShapeWindow::add_steiner_point(const shapes::Point2d<scalar>& pt)
     assert(m_new_steiner_pt.has_value() == false);      // By design we de not receive more than one point per frame, so one optional is enough
     m_new_steiner_pt = pt;
 }
+
+std::optional<ViewportWindow::PickedVertex> ShapeWindow::pick_vertex(const Key& tab, const shapes::Point2d<scalar>& p, scalar max_distance) const
+{
+    std::optional<ViewportWindow::PickedVertex> result;
+    auto list_it = std::find_if(m_shape_control_lists.cbegin(), m_shape_control_lists.cend(), [&tab](const auto& kvp) { return kvp.first == tab; });
+    if (list_it == m_shape_control_lists.cend())
+        return result;
+    scalar best_sq_dist = max_distance * max_distance;
+    for (const ShapeControl* shape_control_ptr : list_it->second)
+    {
+        assert(shape_control_ptr);
+        if (!shape_control_ptr->vertices.draw || shape_control_ptr->vertices.nb == 0)
+            continue;
+        // The bounding box is cached as well: Skip the shapes out of reach without building their index
+        const auto& bb = shape_control_ptr->bounding_box();
+        if (p.x < bb.rx.min - max_distance || p.x > bb.rx.max + max_distance || p.y < bb.ry.min - max_distance || p.y > bb.ry.max + max_distance)
+            continue;
+        const auto vertex_idx = shape_control_ptr->spatial_index().nearest(p);
+        if (!graphs::is_defined(vertex_idx))
+            continue;
+        const auto& q = shape_control_ptr->shape_vertices()[vertex_idx];
+        const scalar sq_dist = (q.x - p.x) * (q.x - p.x) + (q.y - p.y) * (q.y - p.y);
+        if (sq_dist <= best_sq_dist)
+        {
+            best_sq_dist = sq_dist;
+            result = ViewportWindow::PickedVertex{ q, static_cast<std::size_t>(vertex_idx), shape_control_ptr->descr };
+        }
+    }
+    return result;
+}
@@ -3,20 +3,31 @@
 #include "draw_command.h"
 #include "dt_tracker.h"
 #include "settings.h"
+#include "triangulation_cache.h"
 #include "viewport_window.h"
 
 #include <base/canvas.h>
 #include <base/color_data.h>
 #include <base/window_layout.h>
+#include <dt/dt_interface.h>
+#include <shapes/alpha_shape.h>
 #include <shapes/bounding_box.h>
+#include <shapes/incremental_proximity.h>
 #include <shapes/io.h>
 #include <shapes/point.h>
 #include <shapes/point_cloud.h>
 #include <shapes/sampling_interface.h>
 #include <shapes/shapes.h>
+#include <shapes/spatial_index.h>
+#include <shapes/triangle.h>
+#include <shapes/triangle_algos.h>
+#include <stdutils/io.h>
 
+#include <cstdint>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -48,11 +59,38 @@ public:
 
     const DrawCommandLists& get_draw_command_lists() const;
 
+    const std::string& get_name() const { return m_name; }
+
     shapes::io::ShapeAggregate<scalar> get_triangulation_input_aggregate() const;
     shapes::io::ShapeAggregate<scalar> get_tab_aggregate(const Key& selected_tab) const;
 
+    // The latest triangulation of each algorithm. The description of each shape is the name of the algorithm.
+    shapes::io::ShapeAggregate<scalar> get_triangulations_aggregate() const;
+
+    // Triangulations of the same input and settings, e.g. from a session snapshot: They are used in place of the first triangulations
+    // computed by the window, if their algorithm is active. The shapes that are not triangle soups are ignored.
+    void restore_triangulations(shapes::io::ShapeAggregate<scalar>&& triangulations);
+
+    // Memory held by all the shapes of the window (input, samplings, triangulations and their cache, proximity graphs), in bytes
+    std::size_t shapes_byte_size() const;
+
+    // Number of triangulation jobs running on worker threads, including the cancelled ones that have not terminated yet
+    std::size_t nb_triangulation_jobs() const;
+
     void add_steiner_point(const shapes::Point2d<scalar>& pt);
 
+    // Append shapes to the input, e.g. those of a file loaded in the background. The triangulations are recomputed on the next visit.
+    void add_input_shapes(shapes::io::ShapeAggregate<scalar>&& shapes, ViewportWindow& viewport_window);
+
+    // Replace the input shapes [first_shape_idx, first_shape_idx + nb_replaced_shapes), e.g. those of a file that was reloaded. The shapes
+    // are matched by content hash: Those that did not change keep their shape control, therefore their version, sampling and settings.
+    // Return the number of new shapes, i.e. those that did not match. The triangulations are recomputed on the next visit only if the
+    // input changed, and the triangulation cache is looked up as usual.
+    std::size_t replace_input_shapes(std::size_t first_shape_idx, std::size_t nb_replaced_shapes, shapes::io::ShapeAggregate<scalar>&& shapes, ViewportWindow& viewport_window);
+
+    // The vertex nearest to p among the shapes of a tab whose vertices are drawn, if it lies within max_distance
+    std::optional<ViewportWindow::PickedVertex> pick_vertex(const Key& tab, const shapes::Point2d<scalar>& p, scalar max_distance) const;
+
 private:
     struct ShapeControl
     {
@@ -63,25 +101,48 @@ private:
             ColorData color;
             bool draw;
         };
-        explicit ShapeControl(shapes::AllShapes<scalar>&& shape);
+        explicit ShapeControl(shapes::AllShapes<scalar>&& shape, std::shared_ptr<const SharedVertices<scalar>> shared_vertices = nullptr);
         ShapeControl(const ShapeControl& shape_control);
         ShapeControl& operator=(const ShapeControl& shape_control);
-
-        void update(shapes::AllShapes<scalar>&& rep_shape);
+        ShapeControl(ShapeControl&&) = default;                        // Unlike a copy, keeps the sampler and the sampled shape
+        ShapeControl& operator=(ShapeControl&&) = default;
+
+        void update(shapes::AllShapes<scalar>&& rep_shape, std::shared_ptr<const SharedVertices<scalar>> rep_shared_vertices = nullptr);
+        void update();                                                  // After an in-place edit of the shape, see edit_shape()
+        const shapes::AllShapes<scalar>& shape() const;
+        std::shared_ptr<const shapes::AllShapes<scalar>> shared_shape() const;
+        shapes::AllShapes<scalar>& edit_shape();                        // Copy-on-write: The shape is copied first if it is shared
+        const std::vector<shapes::Point2d<scalar>>& shape_vertices() const;    // The shared vertices, if any, otherwise those of the shape
+        shapes::AllShapes<scalar> copy_shape() const;                   // With a copy of the shared vertices, if any
         DrawCommand<scalar> to_draw_command(const Settings& settings) const;
+        const shapes::BoundingBox2d<scalar>& bounding_box() const;     // Computed once, then cached until the next update()
+        const shapes::KdTree<scalar>& spatial_index() const;            // Idem. The index of the vertices of the shape, for picking.
+        std::uint64_t content_hash() const;                             // Idem. See shapes/hash.h
+
+        // The data derived from the shape (bounding box, CBP sampling in the renderer, etc.) is cached against the version,
+        // which is unique to the content of the shape: A new one is issued on construction and on each update(), a copy keeps it.
 
         bool active;
         bool force_inactive;
         bool highlight;
         float latest_computation_time_ms;
+        delaunay::TimingReport latest_timing_report;
+        std::size_t latest_backend_bytes;
+        std::size_t latest_peak_rss;
+        shapes::TriangulationStats<scalar> latest_triangulation_stats;
         PrimitiveData vertices;
         PrimitiveData edges;
         PrimitiveData faces;
-        shapes::AllShapes<scalar> shape;
+        std::shared_ptr<shapes::AllShapes<scalar>> shape_ptr;           // Never null. Shared by the copies of the shape control and the draw commands.
+        std::shared_ptr<const SharedVertices<scalar>> shared_vertices;  // If not null, the shape is an edge soup with no vertices of its own
+        std::uint64_t version;
         std::string descr;
         std::unique_ptr<shapes::UniformSamplingInterface2d<scalar>> sampler;
         float req_sampling_length;
         ShapeControl* sampled_shape;
+        mutable std::optional<shapes::BoundingBox2d<scalar>> cached_bounding_box;
+        mutable std::shared_ptr<const shapes::KdTree<scalar>> cached_spatial_index;     // Immutable, therefore shared by the copies
+        mutable std::optional<std::uint64_t> cached_content_hash;
     };
     using ShapeControlSmartPtr = std::unique_ptr<ShapeControl>;
     using ShapeControlPtrs = std::vector<const ShapeControl*>;
@@ -91,22 +152,62 @@ private:
     struct TriangulationOutput
     {
         ShapeControlSmartPtr delaunay_triangulation;
+        std::unique_ptr<shapes::AlphaShape<scalar>> alpha_shape;       // Built on demand, then cached against the version of the triangulation
+        std::uint64_t alpha_shape_version{0};
+        float req_alpha{0.f};
+        ShapeControlSmartPtr alpha_shape_outline;
+    };
+
+    // A triangulation running on a worker thread
+    struct TriangulationJob
+    {
+        struct Result
+        {
+            shapes::Triangles2d<scalar> triangulation;
+            float computation_time_ms{0.f};
+            delaunay::TimingReport timing_report;
+            std::size_t backend_bytes{0};                   // Memory held by the algorithm, see delaunay::Interface::byte_size()
+            std::size_t peak_rss{0};                        // Peak RSS of the process at the end of the job
+            shapes::TriangulationStats<scalar> triangulation_stats;     // Computed by the job, after the triangulation is measured
+        };
+        std::unique_ptr<delaunay::CancellationToken> cancellation;
+        std::shared_ptr<stdutils::io::ErrorLog> err_log;
+        TriangulationCacheKey cache_key;                    // The result is cached under that key once collected
+        std::future<Result> result;                         // Must be destroyed first: Its destructor waits for the worker thread
+    };
+
+    // A triangulation algorithm kept alive between two jobs, to insert the new Steiner points incrementally
+    struct IncrementalTriangulation
+    {
+        std::shared_ptr<stdutils::io::ErrorLog> err_log;    // Shared with the jobs. The algorithm's error handler writes into it.
+        std::shared_ptr<delaunay::Interface<scalar, std::uint32_t>> algo;
     };
 
     struct ProximityGraphs
     {
+        std::shared_ptr<const SharedVertices<scalar>> vertices;        // The vertices of all the graphs but the Voronoi diagram
         ShapeControlSmartPtr nn_graph;
         ShapeControlSmartPtr mst_graph;
         ShapeControlSmartPtr rng_graph;
         ShapeControlSmartPtr gg_graph;
         ShapeControlSmartPtr dt_graph;
+        ShapeControlSmartPtr voronoi_diagram;
+        std::optional<shapes::IncrementalProximityGraphs<scalar>> incremental;     // The new Steiner points are inserted locally
     };
 
+    void add_input_shape_controls(shapes::io::ShapeAggregate<scalar>&& shapes);
+    static void emplace_input_shape_control(std::vector<ShapeControl>& shape_controls, shapes::AllShapes<scalar>&& shape);
     void init_bounding_box();
     ShapeControlPtrs get_active_input_shapes() const;
-    void recompute_triangulations(delaunay::TriangulationPolicy policy, const stdutils::io::ErrorHandler& err_handler);
+    // The Bezier paths that have no sampled shape are sampled with the Casteljau algorithm, within bezier_tolerance of the curve.
+    // If simplification_tolerance is positive, the paths are simplified within that tolerance before the triangulation.
+    void recompute_triangulations(delaunay::TriangulationPolicy policy, bool concurrent, scalar bezier_tolerance, scalar simplification_tolerance, const shapes::Point2d<scalar>* new_steiner_pt = nullptr);
+    void collect_triangulations(const stdutils::io::ErrorHandler& err_handler, bool& geometry_has_changed);
+    void cancel_triangulation_job(const std::string& algo_name);
+    void update_triangulation_output(const std::string& algo_name, TriangulationJob::Result&& result);
     shapes::PointCloud2d<scalar> compute_input_point_cloud(const stdutils::io::ErrorHandler& err_handler);
-    void compute_proximity_graphs(const stdutils::io::ErrorHandler& err_handler);
+    // Insert new_steiner_pt in the current graphs if possible, otherwise compute the graphs from scratch
+    void compute_proximity_graphs(const stdutils::io::ErrorHandler& err_handler, const shapes::Point2d<scalar>* new_steiner_pt = nullptr);
     void map_shape_controls_by_tabs(bool flag_include_proxiity_graphs);
     void build_draw_lists(const Settings& settings);
     ShapeControl* allocate_new_sampled_shape(const ShapeControl& parent, shapes::AllShapes<scalar>&& shape);
@@ -114,8 +215,11 @@ private:
     static bool active_button(std::string_view subid, unsigned int idx, ShapeControl& shape_control);
     static constexpr bool ALLOW_SAMPLING = true;
     static constexpr bool ALLOW_TINKERING = true;
+    static constexpr std::size_t TRIANGULATION_CACHE_BYTE_BUDGET = 256u << 20;
+    static void alpha_shape_menu(TriangulationOutput& triangulation_output, bool& geometry_has_changed);
     void shape_list_menu(ShapeControl& shape_control, unsigned int idx, bool allow_sampling, bool allow_tinkering, bool& in_out_trash, bool& input_has_changed);
 
+    const std::string m_name;
     const std::string m_title;
     const DtTracker<scalar>& m_dt_tracker;
     std::size_t m_prev_dt_tracker_signature;
@@ -125,11 +229,17 @@ private:
     std::optional<shapes::Point2d<scalar>> m_new_steiner_pt;
     delaunay::TriangulationPolicy m_triangulation_policy;
     std::map<std::string, TriangulationOutput> m_triangulation_shape_controls;
+    std::mutex m_sequential_triangulation_mutex;            // Held by the jobs for the duration of the triangulation if they do not run concurrently
+    std::map<std::string, TriangulationJob> m_triangulation_jobs;
+    std::vector<TriangulationJob> m_cancelled_triangulation_jobs;
+    std::map<std::string, IncrementalTriangulation> m_incremental_triangulations;
+    TriangulationCache<TriangulationJob::Result> m_triangulation_cache;
+    std::map<std::string, shapes::Triangles2d<scalar>> m_restored_triangulations;   // Consumed by the first recompute_triangulations()
     std::vector<ShapeControl> m_triangulation_constraint_edges;
     ProximityGraphs m_proximity_graphs_controls;
     shapes::BoundingBox2d<scalar> m_geometry_bounding_box;
     ShapeControlLists m_shape_control_lists;
     DrawCommandLists m_draw_command_lists;
     Settings::General m_prev_general_settings;
-    bool m_first_visit;
+    bool m_input_has_changed;                               // On construction, and once shapes are added to the input
 };
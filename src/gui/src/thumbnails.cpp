@@ -0,0 +1,328 @@
+#include "thumbnails.h"
+
+#include "draw_command.h"
+#include "drawing_settings.h"
+#include "renderer.h"
+#include "renderer_helpers.h"
+
+#include <base/canvas.h>
+#include <base/color_data.h>
+#include <base/offscreen_framebuffer.h>
+#include <base/opengl_and_glfw.h>
+#include <dt/dt_impl.h>
+#include <shapes/bounding_box.h>
+#include <shapes/bounding_box_algos.h>
+#include <shapes/sampling.h>
+#include <stdutils/chrono.h>
+#include <stdutils/macros.h>
+#include <stdutils/parallel.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <variant>
+
+namespace {
+
+using scalar = double;
+
+// Same colors as the defaults of the GUI
+constexpr ColorData BackgroundColor = { 40.f / 255.f, 40.f / 255.f, 40.f / 255.f, 1.f };
+constexpr ColorData VertexColor = { 20.f / 255.f, 90.f / 255.f, 116.f / 255.f, 1.f };
+constexpr ColorData EdgeColor = { 91.f / 255.f, 94.f / 255.f, 137.f / 255.f, 1.f };
+constexpr ColorData FaceColor = { 80.f / 255.f, 82.f / 255.f, 105.f / 255.f, 1.f };
+constexpr ColorData ConstraintEdgeColor = { 222.f / 255.f, 91.f / 255.f, 94.f / 255.f, 1.f };
+
+// The scenes are loaded by batches, so that only a few of them are held in memory while they wait for the renderer
+constexpr std::size_t SCENES_PER_BATCH = 64;
+
+//
+// PNG output. The image data is stored without compression (deflate blocks of type 0), so that the encoding is as fast as a copy.
+//
+std::uint32_t crc32(const std::uint8_t* data, std::size_t size, std::uint32_t crc = 0)
+{
+    static const auto table = []() {
+        std::array<std::uint32_t, 256> result{};
+        for (std::uint32_t n = 0; n < 256; n++)
+        {
+            std::uint32_t c = n;
+            for (int k = 0; k < 8; k++) { c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1; }
+            result[n] = c;
+        }
+        return result;
+    }();
+    crc = ~crc;
+    for (std::size_t idx = 0; idx < size; idx++) { crc = table[(crc ^ data[idx]) & 0xff] ^ (crc >> 8); }
+    return ~crc;
+}
+
+void put_be32(std::string& out, std::uint32_t value)
+{
+    for (int shift = 24; shift >= 0; shift -= 8) { out.push_back(static_cast<char>((value >> shift) & 0xff)); }
+}
+
+void put_chunk(std::string& out, const char* type, const std::string& data)
+{
+    put_be32(out, static_cast<std::uint32_t>(data.size()));
+    const std::size_t type_pos = out.size();
+    out.append(type, 4);
+    out.append(data);
+    const auto* crc_data = reinterpret_cast<const std::uint8_t*>(out.data() + type_pos);
+    put_be32(out, crc32(crc_data, 4 + data.size()));
+}
+
+// The rows of the RGBA pixels are read from the bottom to the top, as returned by glReadPixels()
+bool write_png(const std::filesystem::path& path, int width, int height, const std::vector<std::uint8_t>& pixels, const stdutils::io::ErrorHandler& err_handler)
+{
+    assert(width > 0 && height > 0);
+    const auto row_size = 4 * static_cast<std::size_t>(width);
+    assert(pixels.size() == row_size * static_cast<std::size_t>(height));
+
+    // Scanlines, each one with the filter type "None"
+    std::string raw;
+    raw.reserve((row_size + 1) * static_cast<std::size_t>(height));
+    for (int row = height - 1; row >= 0; row--)
+    {
+        raw.push_back('\0');
+        raw.append(reinterpret_cast<const char*>(pixels.data() + row_size * static_cast<std::size_t>(row)), row_size);
+    }
+
+    // zlib stream of stored blocks
+    constexpr std::size_t MAX_BLOCK_SIZE = 65535;
+    std::string zlib;
+    zlib.reserve(raw.size() + 5 * (raw.size() / MAX_BLOCK_SIZE + 1) + 6);
+    zlib.push_back(static_cast<char>(0x78));
+    zlib.push_back(static_cast<char>(0x01));
+    std::uint32_t adler_a = 1;
+    std::uint32_t adler_b = 0;
+    for (std::size_t pos = 0; pos < raw.size(); pos += MAX_BLOCK_SIZE)
+    {
+        const std::size_t block_size = std::min(MAX_BLOCK_SIZE, raw.size() - pos);
+        const auto len = static_cast<std::uint16_t>(block_size);
+        zlib.push_back(pos + block_size == raw.size() ? '\1' : '\0');
+        zlib.push_back(static_cast<char>(len & 0xff));
+        zlib.push_back(static_cast<char>(len >> 8));
+        zlib.push_back(static_cast<char>(~len & 0xff));
+        zlib.push_back(static_cast<char>((~len >> 8) & 0xff));
+        zlib.append(raw, pos, block_size);
+        for (std::size_t idx = pos; idx < pos + block_size; idx++)
+        {
+            adler_a = (adler_a + static_cast<std::uint8_t>(raw[idx])) % 65521;
+            adler_b = (adler_b + adler_a) % 65521;
+        }
+    }
+    put_be32(zlib, (adler_b << 16) | adler_a);
+
+    std::string header;
+    put_be32(header, static_cast<std::uint32_t>(width));
+    put_be32(header, static_cast<std::uint32_t>(height));
+    header.append({ '\x08', '\x06', '\0', '\0', '\0' });        // 8 bits per channel, RGBA, no interlace
+    std::string png("\x89PNG\r\n\x1a\n", 8);
+    put_chunk(png, "IHDR", header);
+    put_chunk(png, "IDAT", zlib);
+    put_chunk(png, "IEND", std::string());
+
+    std::ofstream out(path, std::ios::binary);
+    out.write(png.data(), static_cast<std::streamsize>(png.size()));
+    if (!out)
+    {
+        std::stringstream msg;
+        msg << "Could not write the image " << path;
+        err_handler(stdutils::io::Severity::ERR, msg.str());
+        return false;
+    }
+    return true;
+}
+
+//
+// Scenes
+//
+struct Scene
+{
+    shapes::io::ShapeAggregate<scalar> input;           // The Bezier paths replaced by their sampling
+    shapes::Triangles2d<scalar> triangulation;
+    shapes::BoundingBox2d<scalar> bounding_box;
+    stdutils::io::ErrorLog log;
+};
+
+// Same convention as batch::setup_triangulation()
+void build_scene(const std::filesystem::path& path, const Settings& settings, const SceneLoader& scene_loader, Scene& scene)
+{
+    const auto err_handler = scene.log.handler();
+    auto shapes = scene_loader(path, err_handler);
+    for (const auto& shape_wrapper : shapes)
+    {
+        std::visit(stdutils::Overloaded {
+            [&scene](const shapes::PointCloud2d<scalar>& s) { scene.bounding_box.merge(shapes::fast_bounding_box(s)); },
+            [&scene](const shapes::PointPath2d<scalar>& s) { scene.bounding_box.merge(shapes::fast_bounding_box(s)); },
+            [&scene](const shapes::CubicBezierPath2d<scalar>& s) { scene.bounding_box.merge(shapes::fast_bounding_box(s)); },
+            [&scene](const shapes::Edges2d<scalar>& s) { scene.bounding_box.merge(shapes::fast_bounding_box(s)); },
+            [](const auto&) { /* Skip */ }
+        }, shape_wrapper.shape);
+    }
+    shapes::ensure_min_extent(scene.bounding_box);
+
+    const scalar tolerance = static_cast<scalar>(settings.read_general_settings().bezier_flatness) * scene.bounding_box.diameter();
+    scene.input.reserve(shapes.size());
+    for (auto& shape_wrapper : shapes)
+    {
+        const auto* cbp = std::get_if<shapes::CubicBezierPath2d<scalar>>(&shape_wrapper.shape);
+        if (cbp && !cbp->empty())
+            scene.input.emplace_back(shapes::CasteljauSamplingCubicBezier2d<scalar>().sample(*cbp, tolerance), shape_wrapper.descr);
+        else if (!cbp)
+            scene.input.emplace_back(std::move(shape_wrapper));
+    }
+    shapes.clear();
+
+    auto [algo_name, triangulation_algo] = delaunay::get_ref_impl<scalar>(&err_handler);
+    if (!triangulation_algo)
+        return;
+    bool first_path = true;
+    for (const auto& shape_wrapper : scene.input)
+    {
+        std::visit(stdutils::Overloaded {
+            [&triangulation_algo](const shapes::PointCloud2d<scalar>& pc) { triangulation_algo->add_steiner(pc); },
+            [&triangulation_algo, &first_path](const shapes::PointPath2d<scalar>& pp) {
+                if (first_path) { triangulation_algo->add_path(pp); first_path = false; }
+                else { triangulation_algo->add_hole(pp); }
+            },
+            [&triangulation_algo](const shapes::Edges2d<scalar>& edges) { triangulation_algo->add_edges(edges); },
+            [](const auto&) { /* Skip */ }
+        }, shape_wrapper.shape);
+    }
+    const auto policy = settings.read_general_settings().cdt ? delaunay::TriangulationPolicy::CDT : delaunay::TriangulationPolicy::PointCloud;
+    scene.triangulation = triangulation_algo->triangulate(policy);
+}
+
+} // namespace
+
+std::size_t render_thumbnails(const std::vector<std::filesystem::path>& input_paths, const std::filesystem::path& output_dir, const Settings& settings, const ThumbnailOptions& options, const SceneLoader& scene_loader, const stdutils::io::ErrorHandler& err_handler)
+{
+    if (options.width <= 0 || options.height <= 0)
+    {
+        err_handler(stdutils::io::Severity::ERR, "Invalid size of the images");
+        return 0;
+    }
+    std::error_code err_code;
+    std::filesystem::create_directories(output_dir, err_code);
+    if (err_code)
+    {
+        std::stringstream out;
+        out << "Could not create the output directory " << output_dir << ": " << err_code.message();
+        err_handler(stdutils::io::Severity::ERR, out.str());
+        return 0;
+    }
+
+    // Hidden window, only for its OpenGL context
+    GLFWOptions glfw_options;
+    glfw_options.title = "thumbnails";
+    glfw_options.enable_vsync = false;
+    glfw_options.visible = false;
+    bool any_fatal_err = false;
+    unsigned int back_framebuffer_id = 0;
+    GLFWWindowContext glfw_context = create_glfw_window_load_opengl(options.width, options.height, glfw_options, any_fatal_err, back_framebuffer_id, &err_handler);
+    if (any_fatal_err || glfw_context.window() == nullptr)
+        return 0;
+    const OffscreenFramebuffer framebuffer(options.width, options.height);
+    if (!framebuffer.complete())
+    {
+        err_handler(stdutils::io::Severity::FATAL, "Failed to create the offscreen framebuffer");
+        return 0;
+    }
+
+    // The whole draw list is uploaded at once, and there is no interaction
+    renderer::Draw2D::Settings renderer_settings;
+    renderer_settings.back_framebuffer_id = framebuffer.id();
+    renderer_settings.line_smooth = settings.read_general_settings().line_smooth;
+    renderer_settings.static_layer_cache = false;
+    renderer_settings.upload_bytes_per_frame = 0;
+    renderer::Draw2D draw_2d(renderer_settings, &err_handler);
+    if (!draw_2d.initialized())
+    {
+        err_handler(stdutils::io::Severity::FATAL, "Failed to initialize the renderer");
+        return 0;
+    }
+    draw_2d.set_viewport_background_color(BackgroundColor);
+    const auto drawing_options = drawing_options_from_settings(settings);
+    const bool flip_y = settings.read_general_settings().flip_y;
+    renderer::Flag::type flags = renderer::Flag::ViewportBackground;
+    if (flip_y) { flags |= renderer::Flag::FlipYAxis; }
+    const float surface_alpha = std::clamp(settings.read_surface_settings().alpha, 0.f, 1.f);
+    ColorData face_color = FaceColor;
+    face_color[3] *= surface_alpha;
+
+    std::size_t nb_images = 0;
+    std::vector<std::uint8_t> pixels;
+    std::chrono::duration<float> duration{0};
+    {
+        stdutils::chrono::DurationMeas meas(duration);
+        for (std::size_t batch_begin = 0; batch_begin < input_paths.size(); batch_begin += SCENES_PER_BATCH)
+        {
+            const std::size_t batch_size = std::min(SCENES_PER_BATCH, input_paths.size() - batch_begin);
+            std::vector<Scene> scenes(batch_size);
+            try
+            {
+                // The scenes are built on worker threads, and rendered in order on the calling thread, which holds the OpenGL context
+                stdutils::parallel::for_each_ordered(stdutils::parallel::Policy(), batch_size, [&](std::size_t idx) {
+                    build_scene(input_paths[batch_begin + idx], settings, scene_loader, scenes[idx]);
+                }, [&](std::size_t idx) {
+                    Scene& scene = scenes[idx];
+                    const auto& path = input_paths[batch_begin + idx];
+                    scene.log.forward(err_handler);
+
+                    DrawCommands<scalar> draw_commands;
+                    draw_commands.reserve(scene.input.size() + 1);
+                    const shapes::AllShapes<scalar> triangulation_shape(std::move(scene.triangulation));
+                    if (!std::get<shapes::Triangles2d<scalar>>(triangulation_shape).faces.empty())
+                    {
+                        auto& draw_command = draw_commands.emplace_back(triangulation_shape);
+                        draw_command.vertices.draw = false;
+                        draw_command.edges.color = EdgeColor;
+                        draw_command.faces.color = face_color;
+                    }
+                    for (const auto& shape_wrapper : scene.input)
+                    {
+                        auto& draw_command = draw_commands.emplace_back(shape_wrapper.shape);
+                        draw_command.vertices.color = VertexColor;
+                        draw_command.edges.color = ConstraintEdgeColor;
+                    }
+                    update_opengl_draw_list(draw_2d.draw_list(), draw_commands, true, drawing_options);
+
+                    auto bounding_box = scene.bounding_box;
+                    shapes::scale_around_center_in_place(bounding_box, scalar{1} + static_cast<scalar>(2.f * options.margin));
+                    const auto world_bb = shapes::BoundingBox2d<float>()
+                        .add(static_cast<float>(bounding_box.min().x), static_cast<float>(bounding_box.min().y))
+                        .add(static_cast<float>(bounding_box.max().x), static_cast<float>(bounding_box.max().y));
+                    const Canvas<float> canvas(0.f, 0.f, static_cast<float>(options.width), static_cast<float>(options.height), world_bb, flip_y);
+                    draw_2d.init_framebuffer(options.width, options.height);
+                    draw_2d.clear_framebuffer(BackgroundColor);
+                    draw_2d.render(canvas, flags);
+                    framebuffer.read_pixels(options.width, options.height, pixels);
+
+                    auto image_path = output_dir / path.filename();
+                    image_path.replace_extension(".png");
+                    if (write_png(image_path, options.width, options.height, pixels, err_handler)) { nb_images++; }
+                    scene = Scene();
+                });
+            }
+            catch (const std::exception& e)
+            {
+                std::stringstream out;
+                out << "While rendering the thumbnails: " << e.what();
+                err_handler(stdutils::io::Severity::EXCPT, out.str());
+                break;
+            }
+        }
+    }
+    std::stringstream out;
+    out << "Rendered " << nb_images << " image(s) in " << duration.count() << " s";
+    if (duration.count() > 0.f) { out << " (" << static_cast<float>(nb_images) / duration.count() << " images/s)"; }
+    err_handler(stdutils::io::Severity::INFO, out.str());
+    return nb_images;
+}
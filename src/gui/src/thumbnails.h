@@ -0,0 +1,31 @@
+#pragma once
+
+#include "settings.h"
+
+#include <shapes/io.h>
+#include <stdutils/io.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+/**
+ * Headless rendering of the triangulations of input files to PNG images, e.g. to generate previews
+ *
+ * A hidden window provides the OpenGL context, and renderer::Draw2D renders each scene into an offscreen framebuffer with the settings of
+ * the GUI, which is read back and saved. All the scenes go through the same context and renderer, while the next scenes are loaded and
+ * triangulated on worker threads. The reference triangulation algorithm is used.
+ */
+struct ThumbnailOptions
+{
+    int width{512};
+    int height{512};
+    float margin{0.05f};                                // Around the geometry, relative to its size
+};
+
+using SceneLoader = std::function<shapes::io::ShapeAggregate<double>(const std::filesystem::path&, const stdutils::io::ErrorHandler&)>;
+
+// Each input file is rendered to the image of the same name with the extension ".png" in the output directory. Return the number of
+// images written. The throughput in images per second is reported to the error handler.
+std::size_t render_thumbnails(const std::vector<std::filesystem::path>& input_paths, const std::filesystem::path& output_dir, const Settings& settings, const ThumbnailOptions& options, const SceneLoader& scene_loader, const stdutils::io::ErrorHandler& err_handler);
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <dt/dt_interface.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Identify the input of a triangulation: The versions of the active input shapes, in order, the algorithm, the policy and the sampling
+ * tolerance of the Bezier paths.
+ *
+ * The version of a shape control is unique to the content of the shape (see ShapeWindow::ShapeControl), therefore hashing the versions is
+ * as good as hashing the content of the shapes, and much faster.
+ */
+struct TriangulationCacheKey
+{
+    std::vector<std::uint64_t> input_versions;
+    std::string algo_name;
+    delaunay::TriangulationPolicy policy;
+    double bezier_tolerance = 0.0;
+    double simplification_tolerance = 0.0;          // Zero if the paths are not simplified
+
+    bool operator==(const TriangulationCacheKey& other) const { return input_versions == other.input_versions && algo_name == other.algo_name && policy == other.policy && bezier_tolerance == other.bezier_tolerance && simplification_tolerance == other.simplification_tolerance; }
+};
+
+struct TriangulationCacheKeyHash
+{
+    std::size_t operator()(const TriangulationCacheKey& key) const
+    {
+        std::size_t result = std::hash<std::string>{}(key.algo_name);
+        const auto combine = [&result](std::size_t h) { result ^= h + 0x9e3779b97f4a7c15ull + (result << 6) + (result >> 2); };
+        for (const auto version : key.input_versions) { combine(std::hash<std::uint64_t>{}(version)); }
+        combine(static_cast<std::size_t>(key.policy));
+        combine(std::hash<double>{}(key.bezier_tolerance));
+        combine(std::hash<double>{}(key.simplification_tolerance));
+        return result;
+    }
+};
+
+/**
+ * Memoization of the triangulations, so that switching back to a previous configuration of the input, of the algorithms or of the policy
+ * does not run the triangulations again.
+ *
+ * The least recently used results are evicted once the byte size of the cache exceeds its budget. A result larger than the budget is not cached.
+ */
+template <typename Result>
+class TriangulationCache
+{
+public:
+    explicit TriangulationCache(std::size_t byte_budget) : m_byte_budget(byte_budget), m_byte_size(0), m_lru(), m_map() {}
+
+    // Return nullptr if the key is not in the cache. The pointer is valid until the next call to insert() or clear().
+    const Result* find(const TriangulationCacheKey& key)
+    {
+        const auto it = m_map.find(key);
+        if (it == m_map.end())
+            return nullptr;
+        m_lru.splice(m_lru.begin(), m_lru, it->second);     // Most recently used
+        return &it->second->result;
+    }
+
+    void insert(TriangulationCacheKey&& key, const Result& result, std::size_t result_bytes)
+    {
+        if (result_bytes > m_byte_budget)
+            return;
+        const auto it = m_map.find(key);
+        if (it != m_map.end()) { erase(it->second); }
+        m_lru.push_front(Entry{ key, result, result_bytes });
+        m_map.emplace(std::move(key), m_lru.begin());
+        m_byte_size += result_bytes;
+        while (m_byte_size > m_byte_budget)
+        {
+            assert(!m_lru.empty());
+            erase(std::prev(m_lru.end()));
+        }
+    }
+
+    void clear()
+    {
+        m_map.clear();
+        m_lru.clear();
+        m_byte_size = 0;
+    }
+
+    std::size_t size() const { return m_lru.size(); }
+    std::size_t byte_size() const { return m_byte_size; }
+
+private:
+    struct Entry
+    {
+        TriangulationCacheKey key;
+        Result result;
+        std::size_t bytes;
+    };
+    using EntryList = std::list<Entry>;
+
+    void erase(typename EntryList::iterator entry_it)
+    {
+        assert(m_byte_size >= entry_it->bytes);
+        m_byte_size -= entry_it->bytes;
+        m_map.erase(entry_it->key);
+        m_lru.erase(entry_it);
+    }
+
+    std::size_t m_byte_budget;
+    std::size_t m_byte_size;
+    EntryList m_lru;                                        // Most recently used first
+    std::unordered_map<TriangulationCacheKey, typename EntryList::iterator, TriangulationCacheKeyHash> m_map;
+};
@@ -5,8 +5,10 @@
 #include <imgui/imgui.h>
 #include <shapes/bounding_box_algos.h>
 #include <stdutils/macros.h>
+#include <stdutils/span.h>
 #include <stdutils/visit.h>
 
+#include <array>
 #include <cassert>
 #include <variant>
 
@@ -15,6 +17,9 @@ constexpr ViewportWindow::scalar DEFAULT_ZOOM = 1.1;
 
 constexpr ImU32 CanvasBackgroundColor_Default = IM_COL32(40, 40, 40, 255);
 constexpr ImU32 CanvasBorderColor_Default =     IM_COL32(250, 250, 250, 255);
+constexpr ImU32 PickedVertexColor_Default =     IM_COL32(255, 200, 0, 255);
+
+constexpr float PICK_RADIUS_IN_PIXELS = 6.f;
 
 void draw_canvas_foreground(ImDrawList* draw_list, ImVec2 tl_corner, ImVec2 br_corner)
 {
@@ -28,6 +33,16 @@ enum class LeftMouseButtonUse
     AddSteinerPoint
 };
 
+// World space box of two corners on the screen, converted at once
+template <typename F>
+shapes::BoundingBox2d<F> to_world_box(const Canvas<F>& canvas, const ScreenPos& corner_0, const ScreenPos& corner_1)
+{
+    const std::array<ScreenPos, 2> screen_corners = { corner_0, corner_1 };
+    std::array<shapes::Point2d<F>, 2> world_corners;
+    canvas.to_world(stdutils::make_const_span(screen_corners), stdutils::make_span(world_corners));
+    return shapes::BoundingBox2d<F>().add(world_corners[0]).add(world_corners[1]);
+}
+
 }
 
 ViewportWindow::TabList ViewportWindow::s_default_tabs = { "<empty>" };
@@ -41,6 +56,7 @@ ViewportWindow::ViewportWindow()
     , m_latest_selected_tab()
     , m_background_color(to_float_color(CanvasBackgroundColor_Default))
     , m_steiner_tool{}
+    , m_pick_tool{}
 {
     reset();
 }
@@ -53,6 +69,7 @@ void ViewportWindow::reset()
 
     // Misc
     m_steiner_tool.checked = false;
+    m_pick_tool.checked = false;
 }
 
 void ViewportWindow::set_geometry_bounding_box(const GeometryBB& bounding_box)
@@ -76,6 +93,12 @@ void ViewportWindow::set_steiner_callback(const ViewportWindow::WorldCoordinates
     details::set_generic_callback(m_steiner_tool, callback);
 }
 
+void ViewportWindow::set_pick_callback(const ViewportWindow::PickCallback& callback)
+{
+    m_pick_tool.callback = callback;
+    if (!static_cast<bool>(m_pick_tool.callback)) { m_pick_tool.checked = false; }
+}
+
 void ViewportWindow::signal_scroll_event(ScrollEvent scroll_event)
 {
     m_scroll_event = scroll_event;
@@ -172,12 +195,11 @@ void ViewportWindow::visit(bool& can_be_erased, const TabList& tab_list, const S
                 if (m_zoom_selection_box.is_ongoing && m_zoom_selection_box.is_positive_box())
                 {
                     assert(is_valid(m_prev_mouse_in_canvas.canvas));
-                    const auto corner_0 = m_prev_mouse_in_canvas.canvas.to_world(m_zoom_selection_box.corner_0);
-                    const auto corner_1 = m_prev_mouse_in_canvas.canvas.to_world(m_zoom_selection_box.corner_1);
+                    const auto selection_box = to_world_box(m_prev_mouse_in_canvas.canvas, m_zoom_selection_box.corner_0, m_zoom_selection_box.corner_1);
                     ImGui::TableNextColumn();
-                    ImGui::Text("%0.3g", std::abs(corner_1.x - corner_0.x));
+                    ImGui::Text("%0.3g", selection_box.width());
                     ImGui::TableNextColumn();
-                    ImGui::Text("%0.3g", std::abs(corner_1.y - corner_0.y));
+                    ImGui::Text("%0.3g", selection_box.height());
                 }
             }
             ImGui::EndTable();
@@ -198,6 +220,15 @@ void ViewportWindow::visit(bool& can_be_erased, const TabList& tab_list, const S
     }
     assert(static_cast<bool>(m_steiner_tool.callback) || !m_steiner_tool.checked);
 
+    if (m_pick_tool.callback)
+    {
+        ImGui::SameLine(0, 30);
+        ImGui::Checkbox("Pick vertex", &m_pick_tool.checked);
+        ImGui::SameLine(0);
+        ImGui::HelpMarker("Hover the canvas to highlight the nearest vertex");
+    }
+    assert(static_cast<bool>(m_pick_tool.callback) || !m_pick_tool.checked);
+
     // Left mouse button use during this frame
     const auto left_mouse_button_use = [this]() {
         if (!m_zoom_selection_box.is_ongoing)
@@ -283,7 +314,7 @@ void ViewportWindow::visit(bool& can_be_erased, const TabList& tab_list, const S
                             const auto& z_br_corner = m_zoom_selection_box.corner_1;
                             if (z_br_corner.x - z_tl_corner.x > 3.f && z_br_corner.y - z_tl_corner.y > 3.f)
                             {
-                                zoom_in(shapes::BoundingBox2d<scalar>().add(canvas.to_world(z_tl_corner)).add(canvas.to_world(z_br_corner)));
+                                zoom_in(to_world_box(canvas, z_tl_corner, z_br_corner));
                             }
                         }
                     }
@@ -311,6 +342,20 @@ void ViewportWindow::visit(bool& can_be_erased, const TabList& tab_list, const S
 
                 // TODO : highlight bounding box
 
+                // Vertex under the mouse pointer
+                if (m_pick_tool.checked && mouse_in_canvas.is_hovered && !m_zoom_selection_box.is_ongoing)
+                {
+                    assert(m_pick_tool.callback);
+                    const auto p = canvas.to_world(mouse_in_canvas.mouse_pos);
+                    const auto max_distance = canvas.to_world(PICK_RADIUS_IN_PIXELS);
+                    if (const auto picked = m_pick_tool.callback(tab_name, p, max_distance))
+                    {
+                        const auto screen_pos = canvas.to_screen(picked->point);
+                        draw_list->AddCircle(to_imgui_vec2(screen_pos), PICK_RADIUS_IN_PIXELS, PickedVertexColor_Default, 0, 2.f);
+                        ImGui::SetTooltip("%s\nVertex #%zu\n(%0.6g, %0.6g)", picked->descr.c_str(), picked->vertex_idx, picked->point.x, picked->point.y);
+                    }
+                }
+
                 // Zoom rectangle
                 if (m_zoom_selection_box.is_ongoing && m_zoom_selection_box.is_positive_box())
                 {
@@ -10,8 +10,10 @@
 #include <shapes/shapes.h>
 #include <shapes/vect.h>
 
+#include <cstddef>
 #include <functional>
 #include <map>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -35,6 +37,19 @@ public:
         bool checked{false};
         WorldCoordinatesCallback callback{};
     };
+    // The vertex under the mouse pointer, see set_pick_callback()
+    struct PickedVertex
+    {
+        shapes::Point2d<scalar> point;
+        std::size_t vertex_idx{0};
+        std::string descr;
+    };
+    using PickCallback = std::function<std::optional<PickedVertex>(const Key& tab, const shapes::Point2d<scalar>& p, scalar max_distance)>;
+    struct PickTool
+    {
+        bool checked{false};
+        PickCallback callback{};
+    };
     using ScrollEvent = ScreenVect;
 
     ViewportWindow();
@@ -49,6 +64,9 @@ public:
 
     void set_steiner_callback(const WorldCoordinatesCallback& callback);
 
+    // Called on each frame the mouse hovers the canvas, with the tab displayed and the picking tolerance in world coordinates
+    void set_pick_callback(const PickCallback& callback);
+
     const Key& get_latest_selected_tab() const;
 
     GeometryBB get_canvas_bounding_box() const;
@@ -83,5 +101,6 @@ private:
     Key m_latest_selected_tab;
     ColorData m_background_color;
     MouseClickTool m_steiner_tool;
+    PickTool m_pick_tool;
     ScrollEvent m_scroll_event;
 };
@@ -2,11 +2,14 @@
 // This code is distributed under the terms of the MIT License
 #pragma once
 
+#include <lin/simd.h>
 #include <lin/vect.h>
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <initializer_list>
+#include <type_traits>
 
 namespace lin {
 
@@ -24,11 +27,15 @@ public:
     constexpr mat();
     constexpr mat(std::initializer_list<F> init_list);
 
-    container& values() { return m_values; }
-    const container& values() const { return m_values; }
+    constexpr container& values() { return m_values; }
+    constexpr const container& values() const { return m_values; }
 
-    F* data() { return m_values.data(); }
-    const F* data() const { return m_values.data(); }
+    constexpr F* data() { return m_values.data(); }
+    constexpr const F* data() const { return m_values.data(); }
+
+    // Element access usable in constant expressions
+    constexpr F& operator()(dim_t row_idx, dim_t col_idx)             { assert(row_idx < N && col_idx < M); return m_values[row_idx * M + col_idx]; }
+    constexpr const F& operator()(dim_t row_idx, dim_t col_idx) const { assert(row_idx < N && col_idx < M); return m_values[row_idx * M + col_idx]; }
 
     vect_map<F, M> operator[](dim_t row_idx)             { assert(row_idx < N); return vect_map<F, M>(m_values.data() + row_idx * M); }
     vect_map<const F, M> operator[](dim_t row_idx) const { assert(row_idx < N); return vect_map<const F, M>(m_values.data() + row_idx * M); }
@@ -60,7 +67,10 @@ constexpr mat<F, N, N> identity();
 
 // Compute the determinant
 template <typename F>
-F determinant(const mat2<F>& m);
+constexpr F determinant(const mat2<F>& m);
+
+template <typename F>
+constexpr F determinant(const mat3<F>& m);
 
 // Matrix inverse. Check the determinant: If zero, then the inverse matrix is irrelevant and should not be used.
 template <typename F>
@@ -71,7 +81,17 @@ template <typename F>
 mat2<F>& inverse(mat2<F>& m, F* det_ptr = nullptr);
 
 template <typename F, dim_t N>
-vect<F, N> operator*(const mat<F, N, N>& m, const vect<F, N>& x);
+constexpr vect<F, N> operator*(const mat<F, N, N>& m, const vect<F, N>& x);
+
+// Matrix product
+template <typename F, dim_t N, dim_t K, dim_t M>
+constexpr mat<F, N, M> operator*(const mat<F, N, K>& a, const mat<F, K, M>& b);
+
+// Batched matrix-vector product: in[] holds count contiguous vectors of size M, and out[] receives the count products, of size N.
+// The product can be in place (in == out) if N == M, otherwise the arrays must not overlap. The products of mat4f and mat2d run on SSE2
+// or NEON if available (see lin/simd.h), the other sizes on the portable loop.
+template <typename F, dim_t N, dim_t M>
+void mul_batch(const mat<F, N, M>& m, const F* in, F* out, std::size_t count);
 
 
 //
@@ -115,9 +135,17 @@ constexpr mat<F, N, N> identity()
 }
 
 template <typename F>
-F determinant(const mat2<F>& m)
+constexpr F determinant(const mat2<F>& m)
 {
-    return m[0][0] * m[1][1] - m[0][1] * m[1][0];
+    return m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0);
+}
+
+template <typename F>
+constexpr F determinant(const mat3<F>& m)
+{
+    return m(0, 0) * (m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1))
+         - m(0, 1) * (m(1, 0) * m(2, 2) - m(1, 2) * m(2, 0))
+         + m(0, 2) * (m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0));
 }
 
 template <typename F>
@@ -149,16 +177,123 @@ mat2<F>& inverse(mat2<F>& m, F* det_ptr)
 }
 
 template <typename F, dim_t N>
-vect<F, N> operator*(const mat<F, N, N>& m, const vect<F, N>& x)
+constexpr vect<F, N> operator*(const mat<F, N, N>& m, const vect<F, N>& x)
 {
-    vect<F, N> y;
+    vect<F, N> y{};
     for (dim_t i = 0; i < N; i++)
     {
         y[i] = F{0};
         for (dim_t j = 0; j < N; j++)
-            y[i] += m[i][j] * x[j];
+            y[i] += m(i, j) * x[j];
     }
     return y;
 }
 
+template <typename F, dim_t N, dim_t K, dim_t M>
+constexpr mat<F, N, M> operator*(const mat<F, N, K>& a, const mat<F, K, M>& b)
+{
+    mat<F, N, M> c;
+    for (dim_t i = 0; i < N; i++)
+        for (dim_t k = 0; k < K; k++)
+            for (dim_t j = 0; j < M; j++)
+                c(i, j) += a(i, k) * b(k, j);
+    return c;
+}
+
+namespace details {
+namespace simd {
+
+// The matrices are row-major: The kernels load their columns, then accumulate the columns scaled by the coordinates of each vector
+
+#if LIN_SIMD_SSE2
+inline void mul_batch_4x4(const float* m, const float* in, float* out, std::size_t count)
+{
+    __m128 c0 = _mm_loadu_ps(m);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+    __m128 c3 = _mm_loadu_ps(m + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    for (std::size_t idx = 0; idx < 4 * count; idx += 4)
+    {
+        const __m128 x = _mm_loadu_ps(in + idx);
+        __m128 y = _mm_mul_ps(c0, _mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 0, 0, 0)));
+        y = _mm_add_ps(y, _mm_mul_ps(c1, _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 1, 1, 1))));
+        y = _mm_add_ps(y, _mm_mul_ps(c2, _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 2, 2, 2))));
+        y = _mm_add_ps(y, _mm_mul_ps(c3, _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3))));
+        _mm_storeu_ps(out + idx, y);
+    }
+}
+
+inline void mul_batch_2x2(const double* m, const double* in, double* out, std::size_t count)
+{
+    const __m128d c0 = _mm_set_pd(m[2], m[0]);
+    const __m128d c1 = _mm_set_pd(m[3], m[1]);
+    for (std::size_t idx = 0; idx < 2 * count; idx += 2)
+    {
+        const __m128d x = _mm_loadu_pd(in + idx);
+        const __m128d y = _mm_add_pd(_mm_mul_pd(c0, _mm_unpacklo_pd(x, x)), _mm_mul_pd(c1, _mm_unpackhi_pd(x, x)));
+        _mm_storeu_pd(out + idx, y);
+    }
+}
+#elif LIN_SIMD_NEON
+inline void mul_batch_4x4(const float* m, const float* in, float* out, std::size_t count)
+{
+    const float32x4x4_t rows = vld4q_f32(m);     // De-interleaving load: rows.val[j] is column j
+    for (std::size_t idx = 0; idx < 4 * count; idx += 4)
+    {
+        const float32x4_t x = vld1q_f32(in + idx);
+        float32x4_t y = vmulq_laneq_f32(rows.val[0], x, 0);
+        y = vfmaq_laneq_f32(y, rows.val[1], x, 1);
+        y = vfmaq_laneq_f32(y, rows.val[2], x, 2);
+        y = vfmaq_laneq_f32(y, rows.val[3], x, 3);
+        vst1q_f32(out + idx, y);
+    }
+}
+
+inline void mul_batch_2x2(const double* m, const double* in, double* out, std::size_t count)
+{
+    const float64x2x2_t rows = vld2q_f64(m);     // rows.val[j] is column j
+    for (std::size_t idx = 0; idx < 2 * count; idx += 2)
+    {
+        const float64x2_t x = vld1q_f64(in + idx);
+        const float64x2_t y = vfmaq_laneq_f64(vmulq_laneq_f64(rows.val[0], x, 0), rows.val[1], x, 1);
+        vst1q_f64(out + idx, y);
+    }
+}
+#endif
+
+} // namespace simd
+} // namespace details
+
+template <typename F, dim_t N, dim_t M>
+void mul_batch(const mat<F, N, M>& m, const F* in, F* out, std::size_t count)
+{
+    assert(count == 0 || (in != nullptr && out != nullptr));
+#if LIN_SIMD_SSE2 || LIN_SIMD_NEON
+    if constexpr (std::is_same_v<F, float> && N == 4 && M == 4)
+    {
+        details::simd::mul_batch_4x4(m.data(), in, out, count);
+        return;
+    }
+    else if constexpr (std::is_same_v<F, double> && N == 2 && M == 2)
+    {
+        details::simd::mul_batch_2x2(m.data(), in, out, count);
+        return;
+    }
+#endif
+    for (std::size_t idx = 0; idx < count; idx++)
+    {
+        // Through a temporary, in case in == out
+        vect<F, M> x;
+        std::copy(in + idx * M, in + (idx + 1) * M, x.begin());
+        for (dim_t i = 0; i < N; i++)
+        {
+            F y = F{0};
+            for (dim_t j = 0; j < M; j++)
+                y += m(i, j) * x[j];
+            out[idx * N + i] = y;
+        }
+    }
+}
+
 } // namespace lin
@@ -0,0 +1,26 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+//
+// SIMD instruction sets of the small matrix kernels (see lin/mat.h and lin/transform.h)
+//
+// SSE2 is part of the x86-64 baseline, and NEON of the AArch64 one, therefore the kernels need no compiler flag on those targets.
+// Define LIN_NO_SIMD to only build the portable implementation, e.g. to compare the results.
+//
+#if !defined(LIN_NO_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LIN_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define LIN_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
+#if !defined(LIN_SIMD_SSE2)
+#define LIN_SIMD_SSE2 0
+#endif
+#if !defined(LIN_SIMD_NEON)
+#define LIN_SIMD_NEON 0
+#endif
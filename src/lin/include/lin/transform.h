@@ -0,0 +1,174 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <lin/mat.h>
+#include <lin/simd.h>
+#include <lin/vect.h>
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+namespace lin {
+
+/**
+ * 2D affine transformations
+ *
+ * An affine transformation of the plane is a 3x3 matrix in homogeneous coordinates, whose last row is (0, 0, 1):
+ *
+ *  ( a  c  e )
+ *  ( b  d  f )
+ *  ( 0  0  1 )
+ *
+ * The arguments of affine2() follow the order { a, b, c, d, e, f } of the SVG transformation matrices. The composition of two
+ * transformations is the matrix product (see lin/mat.h), the right-hand side being applied first.
+ */
+template <typename F>
+constexpr mat3<F> affine2(F a, F b, F c, F d, F e, F f);
+
+template <typename F>
+constexpr mat3<F> translation2(F tx, F ty);
+
+template <typename F>
+constexpr mat3<F> scaling2(F sx, F sy);
+
+template <typename F>
+constexpr bool is_affine2(const mat3<F>& m);
+
+template <typename F>
+constexpr vect2<F> transform_point(const mat3<F>& m, const vect2<F>& p);
+
+// Only the linear part of the transformation applies to a vector, e.g. the difference of two points
+template <typename F>
+constexpr vect2<F> transform_vector(const mat3<F>& m, const vect2<F>& v);
+
+// Batched transformation of nb_points points: in[] and out[] hold the interleaved coordinates (x, y) of each point. The computation is
+// done in precision F, whatever the precision of the input and the output. The transformation can be in place (in == out).
+// The float version (F, FIn and FOut all float) runs on SSE2 or NEON if available (see lin/simd.h). The compiler already vectorizes the
+// portable loop as well as a kernel would in double precision, with a single point per vector.
+template <typename F, typename FIn, typename FOut>
+void transform_points(const mat3<F>& m, const FIn* in, FOut* out, std::size_t nb_points);
+
+
+//
+//
+// Implementation
+//
+//
+
+
+template <typename F>
+constexpr mat3<F> affine2(F a, F b, F c, F d, F e, F f)
+{
+    return mat3<F> {
+        a,    c,    e,
+        b,    d,    f,
+        F{0}, F{0}, F{1}
+    };
+}
+
+template <typename F>
+constexpr mat3<F> translation2(F tx, F ty)
+{
+    return affine2(F{1}, F{0}, F{0}, F{1}, tx, ty);
+}
+
+template <typename F>
+constexpr mat3<F> scaling2(F sx, F sy)
+{
+    return affine2(sx, F{0}, F{0}, sy, F{0}, F{0});
+}
+
+template <typename F>
+constexpr bool is_affine2(const mat3<F>& m)
+{
+    return m(2, 0) == F{0} && m(2, 1) == F{0} && m(2, 2) == F{1};
+}
+
+template <typename F>
+constexpr vect2<F> transform_point(const mat3<F>& m, const vect2<F>& p)
+{
+    assert(is_affine2(m));
+    return vect2<F> {
+        m(0, 0) * p[0] + m(0, 1) * p[1] + m(0, 2),
+        m(1, 0) * p[0] + m(1, 1) * p[1] + m(1, 2)
+    };
+}
+
+template <typename F>
+constexpr vect2<F> transform_vector(const mat3<F>& m, const vect2<F>& v)
+{
+    return vect2<F> {
+        m(0, 0) * v[0] + m(0, 1) * v[1],
+        m(1, 0) * v[0] + m(1, 1) * v[1]
+    };
+}
+
+namespace details {
+namespace simd {
+
+// The kernel processes the affine transformation ( a c e ; b d f ) as (a, b) * x + (c, d) * y + (e, f), on two points per vector.
+// It returns the number of points processed, the caller completes the last one if nb_points is odd.
+
+#if LIN_SIMD_SSE2
+inline std::size_t transform_point_pairs(float a, float b, float c, float d, float e, float f, const float* in, float* out, std::size_t nb_points)
+{
+    const __m128 c0 = _mm_set_ps(b, a, b, a);
+    const __m128 c1 = _mm_set_ps(d, c, d, c);
+    const __m128 c2 = _mm_set_ps(f, e, f, e);
+    const std::size_t nb_pairs = nb_points / 2;
+    for (std::size_t idx = 0; idx < 4 * nb_pairs; idx += 4)
+    {
+        const __m128 p = _mm_loadu_ps(in + idx);
+        const __m128 px = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+        const __m128 py = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+        _mm_storeu_ps(out + idx, _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, px), _mm_mul_ps(c1, py)), c2));
+    }
+    return 2 * nb_pairs;
+}
+#elif LIN_SIMD_NEON
+inline std::size_t transform_point_pairs(float a, float b, float c, float d, float e, float f, const float* in, float* out, std::size_t nb_points)
+{
+    const float coefs[12] = { a, b, a, b, c, d, c, d, e, f, e, f };
+    const float32x4_t c0 = vld1q_f32(coefs);
+    const float32x4_t c1 = vld1q_f32(coefs + 4);
+    const float32x4_t c2 = vld1q_f32(coefs + 8);
+    const std::size_t nb_pairs = nb_points / 2;
+    for (std::size_t idx = 0; idx < 4 * nb_pairs; idx += 4)
+    {
+        const float32x4_t p = vld1q_f32(in + idx);
+        vst1q_f32(out + idx, vfmaq_f32(vfmaq_f32(c2, c0, vtrn1q_f32(p, p)), c1, vtrn2q_f32(p, p)));
+    }
+    return 2 * nb_pairs;
+}
+#endif
+
+} // namespace simd
+} // namespace details
+
+template <typename F, typename FIn, typename FOut>
+void transform_points(const mat3<F>& m, const FIn* in, FOut* out, std::size_t nb_points)
+{
+    assert(is_affine2(m));
+    assert(nb_points == 0 || (in != nullptr && out != nullptr));
+    const F a = m(0, 0), c = m(0, 1), e = m(0, 2);
+    const F b = m(1, 0), d = m(1, 1), f = m(1, 2);
+    std::size_t first_point = 0;
+#if LIN_SIMD_SSE2 || LIN_SIMD_NEON
+    if constexpr (std::is_same_v<FIn, float> && std::is_same_v<FOut, float> && std::is_same_v<F, float>)
+    {
+        first_point = details::simd::transform_point_pairs(a, b, c, d, e, f, in, out, nb_points);
+    }
+#endif
+    // Portable version, and the last point of the float kernel
+    for (std::size_t idx = 2 * first_point; idx < 2 * nb_points; idx += 2)
+    {
+        const F x = static_cast<F>(in[idx]);
+        const F y = static_cast<F>(in[idx + 1]);
+        out[idx] = static_cast<FOut>(a * x + c * y + e);
+        out[idx + 1] = static_cast<FOut>(b * x + d * y + f);
+    }
+}
+
+} // namespace lin
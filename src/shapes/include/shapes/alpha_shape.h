@@ -0,0 +1,197 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <graphs/graph.h>
+#include <graphs/index.h>
+#include <graphs/triangulation.h>
+#include <shapes/edge.h>
+#include <shapes/point.h>
+#include <shapes/triangle.h>
+#include <stdutils/parallel.h>
+#include <stdutils/profiler.h>
+#include <stdutils/span.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace shapes {
+
+/**
+ * Alpha shapes of a Delaunay triangulation
+ *
+ * The alpha complex is the set of the faces whose circumradius is lower or equal to alpha, and its outline is the alpha shape: A concave hull,
+ * which tends to the convex hull as alpha grows, and splits in components then vanishes as alpha decreases.
+ *
+ * The faces are sorted by circumradius once, on construction, so that the alpha complex is a prefix of the sorted faces for any alpha. A query
+ * is a binary search followed by a pass on the faces of the complex only, i.e. in O(log n + output). The degenerate faces are never part of the
+ * complex. The adjacency of the triangles is computed if it is not available.
+ */
+template <typename F, typename I = std::uint32_t>
+class AlphaShape
+{
+public:
+    AlphaShape() = default;
+    explicit AlphaShape(const Triangles2d<F, I>& triangles);
+    AlphaShape(const stdutils::parallel::Policy& policy, const Triangles2d<F, I>& triangles);
+
+    // The circumradii of the faces in increasing order, which are the critical values of alpha
+    const std::vector<F>& sorted_radii() const noexcept { return m_sorted_radii; }
+
+    // The faces of the alpha complex
+    std::size_t nb_faces(F alpha) const;
+    stdutils::Span<const graphs::Triangle<I>> faces(F alpha) const;
+    Triangles2d<F, I> triangles(F alpha) const;
+
+    // The outline of the alpha complex, i.e. the edges of its faces that are not shared with another face of the complex. The edges are
+    // oriented like in their face.
+    graphs::EdgeSoup<I> border_edges(F alpha) const;
+    Edges2d<F, I> outline(F alpha) const;                      // With a copy of all the vertices
+
+private:
+    std::vector<Point2d<F>> m_vertices;
+    graphs::TriangleSoup<I> m_sorted_faces;
+    graphs::TriangleAdjacency<I> m_sorted_adjacency;        // The neighbors are indices in m_sorted_faces
+    std::vector<F> m_sorted_radii;
+};
+
+
+//
+//
+// Implementation
+//
+//
+
+
+namespace details {
+namespace alpha {
+
+// Infinite for a degenerate triangle
+template <typename F>
+F circumradius(const Point2d<F>& a, const Point2d<F>& b, const Point2d<F>& c)
+{
+    const F abx = b.x - a.x, aby = b.y - a.y;
+    const F bcx = c.x - b.x, bcy = c.y - b.y;
+    const F cax = a.x - c.x, cay = a.y - c.y;
+    const F cross = abx * (c.y - a.y) - aby * (c.x - a.x);
+    if (cross == F{0})
+        return std::numeric_limits<F>::infinity();
+    const F ab = std::sqrt(abx * abx + aby * aby);
+    const F bc = std::sqrt(bcx * bcx + bcy * bcy);
+    const F ca = std::sqrt(cax * cax + cay * cay);
+    return ab * bc * ca / (F{2} * std::abs(cross));
+}
+
+} // namespace alpha
+} // namespace details
+
+template <typename F, typename I>
+AlphaShape<F, I>::AlphaShape(const Triangles2d<F, I>& triangles)
+    : AlphaShape(stdutils::parallel::Policy{ 1 }, triangles)
+{ }
+
+template <typename F, typename I>
+AlphaShape<F, I>::AlphaShape(const stdutils::parallel::Policy& policy, const Triangles2d<F, I>& triangles)
+    : m_vertices(triangles.vertices)
+    , m_sorted_faces()
+    , m_sorted_adjacency()
+    , m_sorted_radii()
+{
+    STDUTILS_PROFILE_ZONE("alpha::alpha_shape");
+    assert(is_valid(triangles));
+    const auto& faces = triangles.faces;
+    const std::size_t nb_faces = faces.size();
+    std::vector<F> radii(nb_faces);
+    stdutils::parallel::for_each_chunk(policy, nb_faces, [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t f = begin_idx; f < end_idx; f++)
+        {
+            const auto& t = faces[f];
+            radii[f] = details::alpha::circumradius(m_vertices[t[0]], m_vertices[t[1]], m_vertices[t[2]]);
+        }
+    });
+
+    // Sort the faces, ties broken by index for a deterministic order
+    std::vector<I> order(nb_faces);
+    std::iota(order.begin(), order.end(), I{0});
+    stdutils::parallel::sort(policy, order.begin(), order.end(), [&radii](I lhs, I rhs) { return radii[lhs] < radii[rhs] || (radii[lhs] == radii[rhs] && lhs < rhs); });
+    std::vector<I> rank(nb_faces);
+    for (std::size_t idx = 0; idx < nb_faces; idx++) { rank[order[idx]] = static_cast<I>(idx); }
+
+    const graphs::TriangleAdjacency<I> computed_adjacency = has_adjacency(triangles) ? graphs::TriangleAdjacency<I>() : graphs::triangle_adjacency(faces);
+    const auto& adjacency = has_adjacency(triangles) ? triangles.adjacency : computed_adjacency;
+    m_sorted_faces.resize(nb_faces);
+    m_sorted_adjacency.resize(nb_faces);
+    m_sorted_radii.resize(nb_faces);
+    stdutils::parallel::for_each_chunk(policy, nb_faces, [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++)
+        {
+            const I f = order[idx];
+            m_sorted_faces[idx] = faces[f];
+            m_sorted_radii[idx] = radii[f];
+            for (std::size_t k = 0; k < 3; k++)
+            {
+                const I n = adjacency[f][k];
+                m_sorted_adjacency[idx][k] = graphs::is_defined(n) ? rank[n] : graphs::IndexTraits<I>::undef();
+            }
+        }
+    });
+}
+
+template <typename F, typename I>
+std::size_t AlphaShape<F, I>::nb_faces(F alpha) const
+{
+    // The degenerate faces have an infinite radius
+    const F max_alpha = std::min(alpha, std::numeric_limits<F>::max());
+    return static_cast<std::size_t>(std::upper_bound(m_sorted_radii.cbegin(), m_sorted_radii.cend(), max_alpha) - m_sorted_radii.cbegin());
+}
+
+template <typename F, typename I>
+stdutils::Span<const graphs::Triangle<I>> AlphaShape<F, I>::faces(F alpha) const
+{
+    const std::size_t nb = nb_faces(alpha);
+    return nb == 0 ? stdutils::Span<const graphs::Triangle<I>>() : stdutils::Span<const graphs::Triangle<I>>(m_sorted_faces.data(), nb);
+}
+
+template <typename F, typename I>
+Triangles2d<F, I> AlphaShape<F, I>::triangles(F alpha) const
+{
+    const std::size_t nb = nb_faces(alpha);
+    Triangles2d<F, I> result;
+    result.vertices = m_vertices;
+    result.faces.assign(m_sorted_faces.cbegin(), m_sorted_faces.cbegin() + static_cast<std::ptrdiff_t>(nb));
+    return result;
+}
+
+template <typename F, typename I>
+graphs::EdgeSoup<I> AlphaShape<F, I>::border_edges(F alpha) const
+{
+    const std::size_t nb = nb_faces(alpha);
+    graphs::EdgeSoup<I> result;
+    for (std::size_t f = 0; f < nb; f++)
+    {
+        const auto edges = m_sorted_faces[f].edges();
+        for (std::size_t k = 0; k < 3; k++)
+        {
+            const I n = m_sorted_adjacency[f][k];
+            if (!graphs::is_defined(n) || static_cast<std::size_t>(n) >= nb) { result.push_back(edges[k]); }
+        }
+    }
+    return result;
+}
+
+template <typename F, typename I>
+Edges2d<F, I> AlphaShape<F, I>::outline(F alpha) const
+{
+    Edges2d<F, I> result;
+    result.vertices = m_vertices;
+    result.indices = border_edges(alpha);
+    return result;
+}
+
+} // namespace shapes
@@ -4,7 +4,9 @@
 
 #include <shapes/vect.h>
 
+#include <array>
 #include <cassert>
+#include <cstddef>
 #include <cstdlib>
 #include <cstring>
 
@@ -98,6 +100,37 @@ private:
     std::array<F, 7 * dim> split_cps;
 };
 
+/**
+ * Power basis form of a 2D Bezier curve, for the evaluation of many points on the same curve
+ *
+ * The coefficients are computed once, then each point costs a Horner's scheme: B(t) = ((c3 * t + c2) * t + c1) * t + c0.
+ * Unlike the maps above, the evaluation is done in the precision of F, including the parameter t.
+ */
+template <typename F>
+class QuadraticBezierPolynomial2d
+{
+public:
+    explicit QuadraticBezierPolynomial2d(const QuadraticBezierMap2d<F>& bezier);
+    Vect2d<F> at(F t) const;
+
+private:
+    std::array<F, 6> c;                     // c0, c1, c2 (x, y)
+};
+
+template <typename F>
+class CubicBezierPolynomial2d
+{
+public:
+    explicit CubicBezierPolynomial2d(const CubicBezierMap2d<F>& bezier);
+    Vect2d<F> at(F t) const;
+
+    // The n + 1 points at t = i / n, i = 0..n, by forward differencing: Three additions per point. The last point is evaluated at t = 1 directly.
+    void uniform_samples(std::size_t n, Vect2d<F>* out) const;
+
+private:
+    std::array<F, 8> c;                     // c0, c1, c2, c3 (x, y)
+};
+
 
 //
 //
@@ -318,4 +351,84 @@ Vect2d<F> CasteljauCubicBezier2d<F>::split_point() const
     return Vect2d<F>(s[0], s[1]);
 }
 
+template <typename F>
+QuadraticBezierPolynomial2d<F>::QuadraticBezierPolynomial2d(const QuadraticBezierMap2d<F>& bezier)
+    : c()
+{
+    const F* p = bezier.cps();
+    assert(p);
+    for (std::size_t i = 0; i < 2; i++)
+    {
+        c[i]     = p[i];
+        c[2 + i] = F{2} * (p[2 + i] - p[i]);
+        c[4 + i] = p[i] - F{2} * p[2 + i] + p[4 + i];
+    }
+}
+
+template <typename F>
+Vect2d<F> QuadraticBezierPolynomial2d<F>::at(F t) const
+{
+    return Vect2d<F>(
+        (c[4] * t + c[2]) * t + c[0],
+        (c[5] * t + c[3]) * t + c[1]
+    );
+}
+
+template <typename F>
+CubicBezierPolynomial2d<F>::CubicBezierPolynomial2d(const CubicBezierMap2d<F>& bezier)
+    : c()
+{
+    const F* p = bezier.cps();
+    assert(p);
+    for (std::size_t i = 0; i < 2; i++)
+    {
+        c[i]     = p[i];
+        c[2 + i] = F{3} * (p[2 + i] - p[i]);
+        c[4 + i] = F{3} * (p[i] - F{2} * p[2 + i] + p[4 + i]);
+        c[6 + i] = p[6 + i] - p[i] + F{3} * (p[2 + i] - p[4 + i]);
+    }
+}
+
+template <typename F>
+Vect2d<F> CubicBezierPolynomial2d<F>::at(F t) const
+{
+    return Vect2d<F>(
+        ((c[6] * t + c[4]) * t + c[2]) * t + c[0],
+        ((c[7] * t + c[5]) * t + c[3]) * t + c[1]
+    );
+}
+
+template <typename F>
+void CubicBezierPolynomial2d<F>::uniform_samples(std::size_t n, Vect2d<F>* out) const
+{
+    assert(n > 0);
+    assert(out);
+    const F h = F{1} / static_cast<F>(n);
+    const F h2 = h * h;
+    const F h3 = h2 * h;
+    std::array<F, 2> f;
+    std::array<F, 2> d1;
+    std::array<F, 2> d2;
+    std::array<F, 2> d3;
+    for (std::size_t i = 0; i < 2; i++)
+    {
+        f[i]  = c[i];
+        d1[i] = c[6 + i] * h3 + c[4 + i] * h2 + c[2 + i] * h;
+        d2[i] = F{6} * c[6 + i] * h3 + F{2} * c[4 + i] * h2;
+        d3[i] = F{6} * c[6 + i] * h3;
+    }
+    for (std::size_t k = 0; k < n; k++)
+    {
+        out[k] = Vect2d<F>(f[0], f[1]);
+        for (std::size_t i = 0; i < 2; i++)
+        {
+            f[i] += d1[i];
+            d1[i] += d2[i];
+            d2[i] += d3[i];
+        }
+    }
+    // B(1) = c0 + c1 + c2 + c3, without the error accumulated by the differences
+    out[n] = Vect2d<F>(c[0] + c[2] + c[4] + c[6], c[1] + c[3] + c[5] + c[7]);
+}
+
 } // namespace shapes
@@ -3,19 +3,29 @@
 #pragma once
 
 #include <shapes/bounding_box.h>
+#include <shapes/point_soa.h>
 #include <shapes/traits.h>
+#include <shapes/vect_batch.h>
+#include <stdutils/parallel.h>
+#include <stdutils/span.h>
 
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <limits>
 #include <type_traits>
+#include <vector>
 
 namespace shapes {
 
-// A rough, fast to compute bounding box of any shape with vertices
+// A rough, fast to compute bounding box of any shape with vertices (AoS or SoA, see point_soa.h)
 template <typename S>
 auto fast_bounding_box(const S& s);
 
+// Same, with a parallel reduction over chunks of the vertices. Small shapes are processed on the calling thread.
+template <typename S>
+auto fast_bounding_box(const stdutils::parallel::Policy& policy, const S& s);
+
 // Utility functions to fix a degenerated bounding box
 template <typename F>
 void ensure_min_extent(stdutils::Range<F>& range);
@@ -49,17 +59,64 @@ BoundingBox3d<T> conservative_rounding(const BoundingBox3d<F>& bb_f);
 //
 
 
-template <typename S>
-auto fast_bounding_box(const S& s)
+namespace details {
+
+// Bounding box of the vertices in range [begin_idx, end_idx)
+template <typename F>
+BoundingBox2d<F> vertices_bounding_box(const std::vector<Point2d<F>>& vertices, std::size_t begin_idx, std::size_t end_idx)
 {
-    typename Traits<typename S::scalar, S::dim>::BoundingBox bb;
-    for (const auto& p: s.vertices)
+    assert(begin_idx <= end_idx && end_idx <= vertices.size());
+    if (begin_idx == end_idx)
+        return BoundingBox2d<F>();
+    return bounding_box(stdutils::Span<const Point2d<F>>(vertices.data() + begin_idx, end_idx - begin_idx));
+}
+
+template <typename F>
+BoundingBox2d<F> vertices_bounding_box(const Points2dSoA<F>& vertices, std::size_t begin_idx, std::size_t end_idx)
+{
+    assert(begin_idx <= end_idx && end_idx <= vertices.size());
+    if (begin_idx == end_idx)
+        return BoundingBox2d<F>();
+    Points2dSoAView<F> sub_view;
+    sub_view.x = stdutils::Span<const F>(vertices.x.data() + begin_idx, end_idx - begin_idx);
+    sub_view.y = stdutils::Span<const F>(vertices.y.data() + begin_idx, end_idx - begin_idx);
+    return bounding_box(sub_view);
+}
+
+template <typename F>
+BoundingBox3d<F> vertices_bounding_box(const std::vector<Point3d<F>>& vertices, std::size_t begin_idx, std::size_t end_idx)
+{
+    assert(begin_idx <= end_idx && end_idx <= vertices.size());
+    BoundingBox3d<F> bb;
+    for (std::size_t idx = begin_idx; idx < end_idx; idx++)
     {
-        bb.add(p);
+        bb.add(vertices[idx]);
     }
     return bb;
 }
 
+} // namespace details
+
+template <typename S>
+auto fast_bounding_box(const S& s)
+{
+    return details::vertices_bounding_box(s.vertices, 0, s.vertices.size());
+}
+
+template <typename S>
+auto fast_bounding_box(const stdutils::parallel::Policy& policy, const S& s)
+{
+    using BoundingBox = typename Traits<typename S::scalar, S::dim>::BoundingBox;
+    const std::size_t nb_vertices = s.vertices.size();
+    std::vector<BoundingBox> chunk_bbs(stdutils::parallel::nb_chunks(policy, nb_vertices));
+    stdutils::parallel::for_each_chunk(policy, nb_vertices, [&s, &chunk_bbs](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+        chunk_bbs[chunk_idx] = details::vertices_bounding_box(s.vertices, begin_idx, end_idx);
+    });
+    BoundingBox bb;
+    for (const auto& chunk_bb : chunk_bbs) { bb.merge(chunk_bb); }
+    return bb;
+}
+
 template <typename F>
 void ensure_min_extent(Range<F>& range)
 {
@@ -0,0 +1,246 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <graphs/graph.h>
+#include <graphs/index.h>
+#include <graphs/triangulation.h>
+#include <shapes/bounding_box.h>
+#include <shapes/point.h>
+#include <shapes/triangle.h>
+#include <stdutils/memory.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace shapes {
+
+/**
+ * Compressed triangulation, to keep many triangulations in memory, e.g. the outputs of several implementations for comparison
+ *
+ * The vertices are quantized on a regular grid of 2^quantization_bits values per axis spanning the bounding box of the triangulation,
+ * then delta-coded in their order. The faces are delta-coded too: The first vertex of each face relative to the first vertex of the
+ * previous face, and the two other vertices relative to the first one. The deltas are zigzag-coded in LEB128 varints, therefore the
+ * encoding is compact when the consecutive vertices and faces are close, e.g. after renumber_along_hilbert_curve(). The adjacency is
+ * not stored: decode() recomputes it if the input had one.
+ *
+ * The faces are encoded without loss, and so is their order, hence two triangulations encoded from the same vertices can be compared
+ * without decoding (see same_faces()), or face by face with for_each_face(), which decodes on the fly.
+ */
+template <typename F, typename I = std::uint32_t>
+class CompressedTriangles
+{
+public:
+    static constexpr unsigned int default_quantization_bits = 24;
+
+    CompressedTriangles() = default;
+
+    // Require 1 <= quantization_bits <= 31
+    explicit CompressedTriangles(const Triangles2d<F, I>& triangles, unsigned int quantization_bits = default_quantization_bits);
+
+    std::size_t nb_vertices() const noexcept { return m_nb_vertices; }
+    std::size_t nb_faces() const noexcept { return m_nb_faces; }
+    bool has_adjacency() const noexcept { return m_has_adjacency; }
+
+    // Heap memory of the encoding, in bytes
+    std::size_t byte_size() const noexcept;
+
+    // Largest distance, on each axis, between a decoded vertex and the original one (up to the rounding of F)
+    F max_quantization_error() const noexcept;
+
+    Triangles2d<F, I> decode() const;
+
+    // func(const Point2d<F>& p), in the order of the vertices
+    template <typename Func>
+    void for_each_vertex(Func func) const;
+
+    // func(const graphs::Triangle<I>& face), in the order of the faces
+    template <typename Func>
+    void for_each_face(Func func) const;
+
+    bool same_faces(const CompressedTriangles& other) const noexcept { return m_nb_faces == other.m_nb_faces && m_faces == other.m_faces; }
+
+private:
+    F dequantize(std::int64_t q, F min, F length) const noexcept;
+
+    BoundingBox2d<F> m_bounding_box{};
+    unsigned int m_quantization_bits{default_quantization_bits};
+    std::size_t m_nb_vertices{0};
+    std::size_t m_nb_faces{0};
+    bool m_has_adjacency{false};
+    std::vector<std::uint8_t> m_vertices;
+    std::vector<std::uint8_t> m_faces;
+};
+
+
+//
+//
+// Implementation
+//
+//
+
+
+namespace details {
+namespace compressed_mesh {
+
+inline void put_varint(std::vector<std::uint8_t>& out, std::int64_t value)
+{
+    auto zigzag = (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    while (zigzag >= 0x80)
+    {
+        out.push_back(static_cast<std::uint8_t>(zigzag | 0x80));
+        zigzag >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(zigzag));
+}
+
+inline std::int64_t get_varint(const std::uint8_t*& in)
+{
+    std::uint64_t zigzag = 0;
+    unsigned int shift = 0;
+    std::uint8_t byte = 0;
+    do
+    {
+        byte = *in++;
+        zigzag |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1);
+}
+
+template <typename F>
+std::int64_t quantize(F val, F min, F length, unsigned int bits)
+{
+    if (!(length > F{0}))
+        return 0;
+    const double grid_max = static_cast<double>((std::int64_t{1} << bits) - 1);
+    const double q = std::round(grid_max * static_cast<double>(val - min) / static_cast<double>(length));
+    return static_cast<std::int64_t>(std::min(std::max(q, 0.0), grid_max));
+}
+
+} // namespace compressed_mesh
+} // namespace details
+
+template <typename F, typename I>
+CompressedTriangles<F, I>::CompressedTriangles(const Triangles2d<F, I>& triangles, unsigned int quantization_bits)
+    : m_bounding_box()
+    , m_quantization_bits(quantization_bits)
+    , m_nb_vertices(triangles.vertices.size())
+    , m_nb_faces(triangles.faces.size())
+    , m_has_adjacency(!triangles.adjacency.empty())
+    , m_vertices()
+    , m_faces()
+{
+    namespace cm = details::compressed_mesh;
+    if (quantization_bits < 1 || quantization_bits > 31)
+        throw std::invalid_argument("CompressedTriangles: The quantization must be in range [1, 31] bits");
+    for (const auto& p : triangles.vertices) { m_bounding_box.add(p); }
+
+    // Each delta usually fits in a couple of bytes
+    m_vertices.reserve(4 * m_nb_vertices);
+    std::int64_t prev_x = 0;
+    std::int64_t prev_y = 0;
+    const Point2d<F> min = m_nb_vertices > 0 ? m_bounding_box.min() : Point2d<F>(F{0}, F{0});
+    const F width = m_nb_vertices > 0 ? m_bounding_box.width() : F{0};
+    const F height = m_nb_vertices > 0 ? m_bounding_box.height() : F{0};
+    for (const auto& p : triangles.vertices)
+    {
+        const std::int64_t x = cm::quantize(p.x, min.x, width, quantization_bits);
+        const std::int64_t y = cm::quantize(p.y, min.y, height, quantization_bits);
+        cm::put_varint(m_vertices, x - prev_x);
+        cm::put_varint(m_vertices, y - prev_y);
+        prev_x = x;
+        prev_y = y;
+    }
+    m_vertices.shrink_to_fit();
+
+    m_faces.reserve(4 * m_nb_faces);
+    std::int64_t prev_first = 0;
+    for (const auto& face : triangles.faces)
+    {
+        const auto first = static_cast<std::int64_t>(face[0]);
+        cm::put_varint(m_faces, first - prev_first);
+        cm::put_varint(m_faces, static_cast<std::int64_t>(face[1]) - first);
+        cm::put_varint(m_faces, static_cast<std::int64_t>(face[2]) - first);
+        prev_first = first;
+    }
+    m_faces.shrink_to_fit();
+}
+
+template <typename F, typename I>
+std::size_t CompressedTriangles<F, I>::byte_size() const noexcept
+{
+    return stdutils::memory::byte_size(m_vertices) + stdutils::memory::byte_size(m_faces);
+}
+
+template <typename F, typename I>
+F CompressedTriangles<F, I>::max_quantization_error() const noexcept
+{
+    if (m_nb_vertices == 0)
+        return F{0};
+    const F grid_max = static_cast<F>((std::int64_t{1} << m_quantization_bits) - 1);
+    return std::max(m_bounding_box.width(), m_bounding_box.height()) / (F{2} * grid_max);
+}
+
+template <typename F, typename I>
+F CompressedTriangles<F, I>::dequantize(std::int64_t q, F min, F length) const noexcept
+{
+    const double grid_max = static_cast<double>((std::int64_t{1} << m_quantization_bits) - 1);
+    return min + static_cast<F>(static_cast<double>(length) * static_cast<double>(q) / grid_max);
+}
+
+template <typename F, typename I>
+template <typename Func>
+void CompressedTriangles<F, I>::for_each_vertex(Func func) const
+{
+    if (m_nb_vertices == 0)
+        return;
+    const Point2d<F> min = m_bounding_box.min();
+    const F width = m_bounding_box.width();
+    const F height = m_bounding_box.height();
+    const std::uint8_t* in = m_vertices.data();
+    std::int64_t x = 0;
+    std::int64_t y = 0;
+    for (std::size_t idx = 0; idx < m_nb_vertices; idx++)
+    {
+        x += details::compressed_mesh::get_varint(in);
+        y += details::compressed_mesh::get_varint(in);
+        func(Point2d<F>(dequantize(x, min.x, width), dequantize(y, min.y, height)));
+    }
+    assert(in == m_vertices.data() + m_vertices.size());
+}
+
+template <typename F, typename I>
+template <typename Func>
+void CompressedTriangles<F, I>::for_each_face(Func func) const
+{
+    const std::uint8_t* in = m_faces.data();
+    std::int64_t first = 0;
+    for (std::size_t idx = 0; idx < m_nb_faces; idx++)
+    {
+        first += details::compressed_mesh::get_varint(in);
+        const std::int64_t second = first + details::compressed_mesh::get_varint(in);
+        const std::int64_t third = first + details::compressed_mesh::get_varint(in);
+        func(graphs::Triangle<I>(static_cast<I>(first), static_cast<I>(second), static_cast<I>(third)));
+    }
+    assert(in == m_faces.data() + m_faces.size());
+}
+
+template <typename F, typename I>
+Triangles2d<F, I> CompressedTriangles<F, I>::decode() const
+{
+    Triangles2d<F, I> result;
+    result.vertices.reserve(m_nb_vertices);
+    for_each_vertex([&result](const Point2d<F>& p) { result.vertices.push_back(p); });
+    result.faces.reserve(m_nb_faces);
+    for_each_face([&result](const graphs::Triangle<I>& face) { result.faces.push_back(face); });
+    if (m_has_adjacency) { result.adjacency = graphs::triangle_adjacency(result.faces); }
+    return result;
+}
+
+} // namespace shapes
@@ -0,0 +1,191 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <shapes/path.h>
+#include <shapes/point.h>
+#include <stdutils/parallel.h>
+#include <stdutils/profiler.h>
+#include <stdutils/span.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace shapes {
+
+/**
+ * Convex hull of a set of points, by Andrew's monotone chain in O(n log n)
+ *
+ * The hull is a closed path in counter-clockwise order, starting from the lowest-leftmost point, without duplicated nor collinear vertices.
+ * A single point gives an open path of one vertex, and aligned points a closed path of the two extreme points.
+ *
+ * With a parallel policy, the points are first filtered with akl_toussaint_filter(), then the hulls of chunks of the remaining points are
+ * computed concurrently and merged. The orientation tests are not exact: Nearly collinear vertices may be kept or dropped.
+ */
+template <typename F>
+PointPath2d<F> convex_hull(stdutils::Span<const Point2d<F>> points);
+template <typename F>
+PointPath2d<F> convex_hull(const stdutils::parallel::Policy& policy, stdutils::Span<const Point2d<F>> points);
+
+/**
+ * Akl-Toussaint heuristic
+ *
+ * Discard the points strictly inside the octagon of the extreme points along x, y, x + y and x - y, which cannot be vertices of the convex
+ * hull. On uniformly distributed points most of them are discarded in a single linear pass, which is a cheap reduction of the input of any
+ * hull algorithm. The points kept are in the input order. The extreme points and the filter are computed concurrently.
+ */
+template <typename F>
+std::vector<Point2d<F>> akl_toussaint_filter(const stdutils::parallel::Policy& policy, stdutils::Span<const Point2d<F>> points);
+
+
+//
+//
+// Implementation
+//
+//
+
+
+namespace details {
+namespace hull {
+
+template <typename F>
+F orient(const Point2d<F>& a, const Point2d<F>& b, const Point2d<F>& c)
+{
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+template <typename F>
+bool lexicographic_less(const Point2d<F>& a, const Point2d<F>& b)
+{
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+// Monotone chain of points sorted in place. Return the hull as a CCW sequence of vertices.
+template <typename F>
+std::vector<Point2d<F>> monotone_chain(std::vector<Point2d<F>>& points)
+{
+    std::sort(points.begin(), points.end(), &lexicographic_less<F>);
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    if (points.size() < 3)
+        return points;
+    std::vector<Point2d<F>> result(2 * points.size());
+    std::size_t k = 0;
+    for (std::size_t idx = 0; idx < points.size(); idx++)
+    {
+        while (k >= 2 && orient(result[k - 2], result[k - 1], points[idx]) <= F{0}) { k--; }
+        result[k++] = points[idx];
+    }
+    const std::size_t lower_size = k + 1;
+    for (std::size_t idx = points.size() - 1; idx > 0; idx--)
+    {
+        while (k >= lower_size && orient(result[k - 2], result[k - 1], points[idx - 1]) <= F{0}) { k--; }
+        result[k++] = points[idx - 1];
+    }
+    result.resize(k - 1);               // The last point is the first one
+    return result;
+}
+
+template <typename F>
+PointPath2d<F> to_path(std::vector<Point2d<F>>&& vertices)
+{
+    PointPath2d<F> result;
+    result.closed = vertices.size() > 1;
+    result.vertices = std::move(vertices);
+    return result;
+}
+
+// The extreme points along x, y, x + y and x - y, in CCW order: min x, min x + y, min y, max x - y, max x, max x + y, max y, min x - y
+template <typename F>
+using Octagon = std::array<Point2d<F>, 8>;
+
+template <typename F>
+void merge_octagon(Octagon<F>& octagon, const Point2d<F>& p)
+{
+    if (p.x < octagon[0].x) { octagon[0] = p; }
+    if (p.x + p.y < octagon[1].x + octagon[1].y) { octagon[1] = p; }
+    if (p.y < octagon[2].y) { octagon[2] = p; }
+    if (p.x - p.y > octagon[3].x - octagon[3].y) { octagon[3] = p; }
+    if (p.x > octagon[4].x) { octagon[4] = p; }
+    if (p.x + p.y > octagon[5].x + octagon[5].y) { octagon[5] = p; }
+    if (p.y > octagon[6].y) { octagon[6] = p; }
+    if (p.x - p.y < octagon[7].x - octagon[7].y) { octagon[7] = p; }
+}
+
+} // namespace hull
+} // namespace details
+
+template <typename F>
+std::vector<Point2d<F>> akl_toussaint_filter(const stdutils::parallel::Policy& policy, stdutils::Span<const Point2d<F>> points)
+{
+    STDUTILS_PROFILE_ZONE("hull::akl_toussaint_filter");
+    using Octagon = details::hull::Octagon<F>;
+    const std::size_t nb_points = points.size();
+    if (nb_points == 0)
+        return std::vector<Point2d<F>>();
+
+    // Extreme points
+    const std::size_t nb_chunks = stdutils::parallel::nb_chunks(policy, nb_points);
+    std::vector<Octagon> chunk_octagons(nb_chunks);
+    stdutils::parallel::for_each_chunk(policy, nb_points, [&points, &chunk_octagons](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+        auto& octagon = chunk_octagons[chunk_idx];
+        octagon.fill(points[begin_idx]);
+        for (std::size_t idx = begin_idx + 1; idx < end_idx; idx++) { details::hull::merge_octagon(octagon, points[idx]); }
+    });
+    Octagon octagon = chunk_octagons.front();
+    for (const auto& chunk_octagon : chunk_octagons)
+        for (const auto& p : chunk_octagon)
+            details::hull::merge_octagon(octagon, p);
+    std::vector<Point2d<F>> polygon(octagon.cbegin(), octagon.cend());
+    polygon.erase(std::unique(polygon.begin(), polygon.end()), polygon.end());
+    while (polygon.size() > 1 && polygon.back() == polygon.front()) { polygon.pop_back(); }
+    if (polygon.size() < 3)
+        return std::vector<Point2d<F>>(points.begin(), points.end());
+
+    // Filter
+    const auto is_strictly_inside = [&polygon](const Point2d<F>& p) {
+        for (std::size_t idx = 0; idx < polygon.size(); idx++)
+        {
+            if (details::hull::orient(polygon[idx], polygon[(idx + 1) % polygon.size()], p) <= F{0}) { return false; }
+        }
+        return true;
+    };
+    std::vector<std::vector<Point2d<F>>> chunk_kept(nb_chunks);
+    stdutils::parallel::for_each_chunk(policy, nb_points, [&points, &chunk_kept, &is_strictly_inside](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+        auto& kept = chunk_kept[chunk_idx];
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++) { if (!is_strictly_inside(points[idx])) { kept.push_back(points[idx]); } }
+    });
+    std::vector<Point2d<F>> result;
+    for (const auto& kept : chunk_kept) { result.insert(result.end(), kept.cbegin(), kept.cend()); }
+    return result;
+}
+
+template <typename F>
+PointPath2d<F> convex_hull(stdutils::Span<const Point2d<F>> points)
+{
+    STDUTILS_PROFILE_ZONE("hull::convex_hull");
+    std::vector<Point2d<F>> sorted_points(points.begin(), points.end());
+    return details::hull::to_path<F>(details::hull::monotone_chain(sorted_points));
+}
+
+template <typename F>
+PointPath2d<F> convex_hull(const stdutils::parallel::Policy& policy, stdutils::Span<const Point2d<F>> points)
+{
+    STDUTILS_PROFILE_ZONE("hull::convex_hull");
+    auto candidates = akl_toussaint_filter(policy, points);
+
+    // Hulls of the chunks, then hull of their vertices
+    const std::size_t nb_chunks = stdutils::parallel::nb_chunks(policy, candidates.size());
+    std::vector<std::vector<Point2d<F>>> chunk_hulls(nb_chunks);
+    stdutils::parallel::for_each_chunk(policy, candidates.size(), [&candidates, &chunk_hulls](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+        std::vector<Point2d<F>> chunk(candidates.cbegin() + static_cast<std::ptrdiff_t>(begin_idx), candidates.cbegin() + static_cast<std::ptrdiff_t>(end_idx));
+        chunk_hulls[chunk_idx] = details::hull::monotone_chain(chunk);
+    });
+    candidates.clear();
+    for (const auto& chunk_hull : chunk_hulls) { candidates.insert(candidates.end(), chunk_hull.cbegin(), chunk_hull.cend()); }
+    return details::hull::to_path<F>(details::hull::monotone_chain(candidates));
+}
+
+} // namespace shapes
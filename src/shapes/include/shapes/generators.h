@@ -0,0 +1,341 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <shapes/path.h>
+#include <shapes/point.h>
+#include <shapes/point_cloud.h>
+#include <stdutils/numbers.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace shapes {
+namespace generators {
+
+/**
+ * Synthetic inputs for the tests and the benchmarks
+ *
+ * All the generators are deterministic for a given seed. Unless stated otherwise, the shapes lie within the unit square [0, 1] x [0, 1].
+ * The output can be saved to a file with shapes::io, e.g. shapes::io::save_shapes_as_file or shapes::io::shb::save_shapes_as_file.
+ */
+
+// Uniform distribution in the unit square
+template <typename F>
+PointCloud2d<F> uniform_point_cloud(std::size_t n, std::uint32_t seed = 0);
+
+// Normal distribution centered on (0.5, 0.5), with a standard deviation of 0.125. The points are not clipped to the unit square.
+template <typename F>
+PointCloud2d<F> gaussian_point_cloud(std::size_t n, std::uint32_t seed = 0);
+
+// Gaussian clusters with uniformly distributed centers. If nb_clusters is zero, it is set to sqrt(n) / 4.
+template <typename F>
+PointCloud2d<F> clustered_point_cloud(std::size_t n, std::uint32_t seed = 0, std::size_t nb_clusters = 0);
+
+// Poisson-disk sampling (Bridson's algorithm): No two points are closer than min_distance. The number of points is about 0.7 / min_distance^2.
+template <typename F>
+PointCloud2d<F> poisson_disk_point_cloud(F min_distance, std::uint32_t seed = 0);
+
+// Regular grid with a unit step, row by row. The first n points of a square grid of side ceil(sqrt(n)). Degenerate case: Co-circular points.
+template <typename F>
+PointCloud2d<F> grid_point_cloud(std::size_t n);
+
+// Points on the circle of center (0.5, 0.5) and radius 0.5, at random angles. The radius of each point is perturbed by a relative
+// amount in [-epsilon, epsilon]: With a small epsilon, the set is nearly degenerate for the Delaunay triangulation.
+template <typename F>
+PointCloud2d<F> cocircular_point_cloud(std::size_t n, F epsilon = F{0}, std::uint32_t seed = 0);
+
+// Random simple polygon with n >= 3 vertices, counter-clockwise. If n >= 4, the polygon is star-shaped around (0.5, 0.5).
+template <typename F>
+PointPath2d<F> random_polygon(std::size_t n, std::uint32_t seed = 0);
+
+// Random simple polygon with holes: The first path is the outer boundary, the next ones are the holes. The holes do not intersect each other
+// nor the outer boundary. About half of the n vertices are on the outer boundary, the other half is split between the holes.
+template <typename F>
+std::vector<PointPath2d<F>> random_polygon_with_holes(std::size_t n, std::size_t nb_holes, std::uint32_t seed = 0);
+
+// Fractal coastline: A closed path with n >= 3 vertices, star-shaped around (0.5, 0.5), whose radius is a periodic midpoint displacement
+// noise. The roughness in (0, 1) is the attenuation of the displacements at each octave: The higher, the more jagged.
+template <typename F>
+PointPath2d<F> fractal_coastline(std::size_t n, F roughness = F{0.5}, std::uint32_t seed = 0);
+
+
+//
+//
+// Implementation
+//
+//
+
+
+namespace details {
+
+// Star-shaped polygon: n sorted random angles, and a random radius in [min_radius, max_radius] for each vertex
+template <typename F>
+PointPath2d<F> star_shaped_polygon(std::size_t n, const Point2d<F>& center, F min_radius, F max_radius, std::mt19937& rng)
+{
+    assert(n >= 3);
+    assert(F{0} < min_radius && min_radius <= max_radius);
+    constexpr F two_pi = F{2} * stdutils::numbers::pi_v<F>;
+
+    // Jittered angles: The angle between two consecutive vertices is less than 2 * pi * 1.9 / n, which is less than pi if n >= 4.
+    // The polygon is then star-shaped around its center.
+    std::uniform_real_distribution<F> jitter(F{0}, F{1});
+    std::uniform_real_distribution<F> radius(min_radius, max_radius);
+    PointPath2d<F> result;
+    result.closed = true;
+    result.vertices.reserve(n);
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        const F theta = two_pi * (static_cast<F>(idx) + static_cast<F>(0.9) * jitter(rng)) / static_cast<F>(n);
+        const F r = radius(rng);
+        result.vertices.emplace_back(center.x + r * std::cos(theta), center.y + r * std::sin(theta));
+    }
+    return result;
+}
+
+} // namespace details
+
+template <typename F>
+PointCloud2d<F> uniform_point_cloud(std::size_t n, std::uint32_t seed)
+{
+    PointCloud2d<F> result;
+    result.vertices.reserve(n);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<F> coord(F{0}, F{1});
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        const F x = coord(rng);
+        const F y = coord(rng);
+        result.vertices.emplace_back(x, y);
+    }
+    return result;
+}
+
+template <typename F>
+PointCloud2d<F> gaussian_point_cloud(std::size_t n, std::uint32_t seed)
+{
+    PointCloud2d<F> result;
+    result.vertices.reserve(n);
+    std::mt19937 rng(seed);
+    std::normal_distribution<F> coord(F{0.5}, F{0.125});
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        const F x = coord(rng);
+        const F y = coord(rng);
+        result.vertices.emplace_back(x, y);
+    }
+    return result;
+}
+
+template <typename F>
+PointCloud2d<F> clustered_point_cloud(std::size_t n, std::uint32_t seed, std::size_t nb_clusters)
+{
+    if (nb_clusters == 0)
+        nb_clusters = std::max<std::size_t>(1, static_cast<std::size_t>(std::sqrt(static_cast<double>(n)) / 4.0));
+    PointCloud2d<F> result;
+    result.vertices.reserve(n);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<F> center_coord(F{0}, F{1});
+    std::uniform_int_distribution<std::size_t> cluster_idx(0, nb_clusters - 1);
+    std::normal_distribution<F> offset(F{0}, F{1} / static_cast<F>(8 * nb_clusters));
+    std::vector<Point2d<F>> centers;
+    centers.reserve(nb_clusters);
+    for (std::size_t idx = 0; idx < nb_clusters; idx++)
+    {
+        const F x = center_coord(rng);
+        const F y = center_coord(rng);
+        centers.emplace_back(x, y);
+    }
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        const auto& c = centers[cluster_idx(rng)];
+        const F dx = offset(rng);
+        const F dy = offset(rng);
+        result.vertices.emplace_back(c.x + dx, c.y + dy);
+    }
+    return result;
+}
+
+template <typename F>
+PointCloud2d<F> poisson_disk_point_cloud(F min_distance, std::uint32_t seed)
+{
+    assert(min_distance > F{0});
+    constexpr unsigned int max_attempts = 30;
+    constexpr F two_pi = F{2} * stdutils::numbers::pi_v<F>;
+    constexpr std::size_t empty_cell = std::numeric_limits<std::size_t>::max();
+
+    // Background grid: A cell contains at most one point
+    const F cell_size = min_distance / std::sqrt(F{2});
+    const auto grid_side = static_cast<std::size_t>(std::ceil(F{1} / cell_size));
+    std::vector<std::size_t> grid(grid_side * grid_side, empty_cell);
+    const auto cell_coord = [cell_size, grid_side](F x) { return std::min(static_cast<std::size_t>(x / cell_size), grid_side - 1); };
+    const F sq_min_distance = min_distance * min_distance;
+
+    PointCloud2d<F> result;
+    std::vector<std::size_t> active;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<F> unit(F{0}, F{1});
+    const auto add_point = [&](F x, F y) {
+        grid[cell_coord(y) * grid_side + cell_coord(x)] = result.vertices.size();
+        active.push_back(result.vertices.size());
+        result.vertices.emplace_back(x, y);
+    };
+    const auto is_far_enough = [&](F x, F y) {
+        const std::size_t cx = cell_coord(x);
+        const std::size_t cy = cell_coord(y);
+        for (std::size_t j = (cy < 2 ? 0 : cy - 2); j <= std::min(cy + 2, grid_side - 1); j++)
+            for (std::size_t i = (cx < 2 ? 0 : cx - 2); i <= std::min(cx + 2, grid_side - 1); i++)
+            {
+                const std::size_t p_idx = grid[j * grid_side + i];
+                if (p_idx == empty_cell) { continue; }
+                const auto& p = result.vertices[p_idx];
+                if ((p.x - x) * (p.x - x) + (p.y - y) * (p.y - y) < sq_min_distance) { return false; }
+            }
+        return true;
+    };
+
+    {
+        const F x = unit(rng);
+        const F y = unit(rng);
+        add_point(x, y);
+    }
+    while (!active.empty())
+    {
+        const std::size_t active_idx = std::uniform_int_distribution<std::size_t>(0, active.size() - 1)(rng);
+        const auto p = result.vertices[active[active_idx]];
+        bool found = false;
+        for (unsigned int attempt = 0; attempt < max_attempts && !found; attempt++)
+        {
+            // Candidate in the annulus [min_distance, 2 * min_distance] around p
+            const F theta = two_pi * unit(rng);
+            const F r = min_distance * (F{1} + unit(rng));
+            const F x = p.x + r * std::cos(theta);
+            const F y = p.y + r * std::sin(theta);
+            if (x < F{0} || x >= F{1} || y < F{0} || y >= F{1} || !is_far_enough(x, y)) { continue; }
+            add_point(x, y);
+            found = true;
+        }
+        if (!found)
+        {
+            active[active_idx] = active.back();
+            active.pop_back();
+        }
+    }
+    return result;
+}
+
+template <typename F>
+PointCloud2d<F> grid_point_cloud(std::size_t n)
+{
+    PointCloud2d<F> result;
+    result.vertices.reserve(n);
+    const auto side = std::max<std::size_t>(2, static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(n)))));
+    for (std::size_t idx = 0; idx < n; idx++)
+        result.vertices.emplace_back(static_cast<F>(idx % side), static_cast<F>(idx / side));
+    return result;
+}
+
+template <typename F>
+PointCloud2d<F> cocircular_point_cloud(std::size_t n, F epsilon, std::uint32_t seed)
+{
+    assert(F{0} <= epsilon && epsilon < F{1});
+    constexpr F two_pi = F{2} * stdutils::numbers::pi_v<F>;
+    PointCloud2d<F> result;
+    result.vertices.reserve(n);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<F> angle(F{0}, two_pi);
+    std::uniform_real_distribution<F> perturbation(-epsilon, epsilon);
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        const F theta = angle(rng);
+        const F r = F{0.5} * (F{1} + (epsilon > F{0} ? perturbation(rng) : F{0}));
+        result.vertices.emplace_back(F{0.5} + r * std::cos(theta), F{0.5} + r * std::sin(theta));
+    }
+    return result;
+}
+
+template <typename F>
+PointPath2d<F> random_polygon(std::size_t n, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    return details::star_shaped_polygon(n, Point2d<F>(F{0.5}, F{0.5}), F{0.25}, F{0.5}, rng);
+}
+
+template <typename F>
+std::vector<PointPath2d<F>> random_polygon_with_holes(std::size_t n, std::size_t nb_holes, std::uint32_t seed)
+{
+    assert(n >= 4 + 3 * nb_holes);
+    std::vector<PointPath2d<F>> result;
+    result.reserve(nb_holes + 1);
+    std::mt19937 rng(seed);
+
+    // The vertices of the outer boundary are outside of the disk of radius 0.3 around the center. Its edges are outside of the disk
+    // of radius 0.3 * cos(max_angle / 2), where max_angle is the largest angle between two consecutive vertices.
+    const std::size_t nb_outer_vertices = nb_holes == 0 ? n : std::max<std::size_t>(4, n / 2);
+    const Point2d<F> center(F{0.5}, F{0.5});
+    result.emplace_back(details::star_shaped_polygon(nb_outer_vertices, center, static_cast<F>(0.3), F{0.5}, rng));
+    if (nb_holes == 0)
+        return result;
+    const F max_angle = F{2} * stdutils::numbers::pi_v<F> * static_cast<F>(1.9) / static_cast<F>(nb_outer_vertices);
+    const F inner_radius = static_cast<F>(0.3) * std::cos(F{0.5} * max_angle);
+
+    // The holes are in the cells of a regular grid on the square inscribed in the inner disk, one hole per cell
+    const auto grid_side = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(nb_holes))));
+    const F square_side = inner_radius * std::sqrt(F{2});
+    const F cell_size = square_side / static_cast<F>(grid_side);
+    const F square_min = F{0.5} - F{0.5} * square_side;
+    const std::size_t nb_hole_vertices = std::max<std::size_t>(3, (n - nb_outer_vertices) / nb_holes);
+    for (std::size_t hole_idx = 0; hole_idx < nb_holes; hole_idx++)
+    {
+        const Point2d<F> hole_center(
+            square_min + (static_cast<F>(hole_idx % grid_side) + F{0.5}) * cell_size,
+            square_min + (static_cast<F>(hole_idx / grid_side) + F{0.5}) * cell_size);
+        result.emplace_back(details::star_shaped_polygon(nb_hole_vertices, hole_center, static_cast<F>(0.2) * cell_size, static_cast<F>(0.45) * cell_size, rng));
+    }
+    return result;
+}
+
+template <typename F>
+PointPath2d<F> fractal_coastline(std::size_t n, F roughness, std::uint32_t seed)
+{
+    assert(n >= 3);
+    assert(F{0} < roughness && roughness < F{1});
+    constexpr F two_pi = F{2} * stdutils::numbers::pi_v<F>;
+
+    // Periodic midpoint displacement on a power of two number of samples
+    std::size_t nb_samples = 4;
+    while (nb_samples < n) { nb_samples *= 2; }
+    std::vector<F> noise(nb_samples, F{0});
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<F> displacement(F{-1}, F{1});
+    F amplitude{1};
+    for (std::size_t step = nb_samples / 2; step > 0; step /= 2)
+    {
+        for (std::size_t idx = step; idx < nb_samples; idx += 2 * step)
+            noise[idx] = F{0.5} * (noise[idx - step] + noise[(idx + step) % nb_samples]) + amplitude * displacement(rng);
+        amplitude *= roughness;
+    }
+
+    // Radius in [0.2, 0.5]
+    const auto [min_it, max_it] = std::minmax_element(noise.cbegin(), noise.cend());
+    const F noise_range = std::max(*max_it - *min_it, std::numeric_limits<F>::epsilon());
+    PointPath2d<F> result;
+    result.closed = true;
+    result.vertices.reserve(n);
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        const F theta = two_pi * static_cast<F>(idx) / static_cast<F>(n);
+        const F r = static_cast<F>(0.2) + static_cast<F>(0.3) * (noise[idx * nb_samples / n] - *min_it) / noise_range;
+        result.vertices.emplace_back(F{0.5} + r * std::cos(theta), F{0.5} + r * std::sin(theta));
+    }
+    return result;
+}
+
+} // namespace generators
+} // namespace shapes
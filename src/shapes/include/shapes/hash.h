@@ -0,0 +1,135 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <shapes/edge.h>
+#include <shapes/path.h>
+#include <shapes/point_cloud.h>
+#include <shapes/shapes.h>
+#include <shapes/triangle.h>
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace shapes {
+
+/**
+ * Content hash of the shapes: Two shapes with the same type, vertices, indices and closed flag have the same hash, e.g. to find the shapes
+ * that did not change when a file is reloaded. The coordinates are hashed by value, therefore -0.0 and +0.0 have the same hash.
+ */
+template <typename P>
+std::uint64_t content_hash(const PointCloud<P>& pc) noexcept;
+
+template <typename P>
+std::uint64_t content_hash(const PointPath<P>& pp) noexcept;
+
+template <typename P>
+std::uint64_t content_hash(const CubicBezierPath<P>& cbp) noexcept;
+
+template <typename P, typename I>
+std::uint64_t content_hash(const Edges<P, I>& edges) noexcept;
+
+template <typename P, typename I>
+std::uint64_t content_hash(const Triangles<P, I>& triangles) noexcept;
+
+// Also hashes the type of the shape
+template <typename F>
+std::uint64_t content_hash(const AllShapes<F>& shape) noexcept;
+
+
+//
+//
+// Implementation
+//
+//
+
+
+namespace details {
+
+// Mixer of splitmix64
+inline std::uint64_t hash_combine(std::uint64_t seed, std::uint64_t bits) noexcept
+{
+    std::uint64_t z = seed ^ (bits + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+template <typename F>
+std::uint64_t hash_combine_coord(std::uint64_t seed, F coord) noexcept
+{
+    static_assert(std::is_floating_point_v<F>);
+    coord += F{0};                              // -0.0 + 0.0 == +0.0
+    std::uint64_t bits = 0;
+    static_assert(sizeof(coord) <= sizeof(bits));
+    std::memcpy(&bits, &coord, sizeof(coord));
+    return hash_combine(seed, bits);
+}
+
+template <typename P>
+std::uint64_t hash_combine_vertices(std::uint64_t seed, const std::vector<P>& vertices) noexcept
+{
+    std::uint64_t h = hash_combine(seed, static_cast<std::uint64_t>(vertices.size()));
+    for (const auto& p : vertices)
+    {
+        h = hash_combine_coord(h, p.x);
+        h = hash_combine_coord(h, p.y);
+        if constexpr (P::dim == 3) { h = hash_combine_coord(h, p.z); }
+    }
+    return h;
+}
+
+} // namespace details
+
+template <typename P>
+std::uint64_t content_hash(const PointCloud<P>& pc) noexcept
+{
+    return details::hash_combine_vertices(0, pc.vertices);
+}
+
+template <typename P>
+std::uint64_t content_hash(const PointPath<P>& pp) noexcept
+{
+    return details::hash_combine_vertices(pp.closed ? 1 : 0, pp.vertices);
+}
+
+template <typename P>
+std::uint64_t content_hash(const CubicBezierPath<P>& cbp) noexcept
+{
+    return details::hash_combine_vertices(cbp.closed ? 1 : 0, cbp.vertices);
+}
+
+template <typename P, typename I>
+std::uint64_t content_hash(const Edges<P, I>& edges) noexcept
+{
+    std::uint64_t h = details::hash_combine_vertices(0, edges.vertices);
+    h = details::hash_combine(h, static_cast<std::uint64_t>(edges.indices.size()));
+    for (const auto& edge : edges.indices)
+    {
+        h = details::hash_combine(h, static_cast<std::uint64_t>(edge.orig()));
+        h = details::hash_combine(h, static_cast<std::uint64_t>(edge.dest()));
+    }
+    return h;
+}
+
+template <typename P, typename I>
+std::uint64_t content_hash(const Triangles<P, I>& triangles) noexcept
+{
+    std::uint64_t h = details::hash_combine_vertices(0, triangles.vertices);
+    h = details::hash_combine(h, static_cast<std::uint64_t>(triangles.faces.size()));
+    for (const auto& face : triangles.faces)
+        for (std::uint8_t idx = 0; idx < 3; idx++)
+            h = details::hash_combine(h, static_cast<std::uint64_t>(face[idx]));
+    return h;
+}
+
+template <typename F>
+std::uint64_t content_hash(const AllShapes<F>& shape) noexcept
+{
+    return details::hash_combine(std::visit([](const auto& s) { return content_hash(s); }, shape), static_cast<std::uint64_t>(shape.index()));
+}
+
+} // namespace shapes
@@ -0,0 +1,594 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <graphs/graph.h>
+#include <graphs/index.h>
+#include <graphs/triangulation.h>
+#include <shapes/point.h>
+#include <shapes/predicates.h>
+#include <shapes/proximity_graphs.h>
+#include <shapes/triangle.h>
+#include <shapes/vect.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace shapes {
+
+/**
+ * Proximity graphs updated incrementally, one new point at a time
+ *
+ * A Delaunay triangulation and its NN, MST, RNG and GG (see graphs/proximity.h) are maintained under the insertion of points, e.g. the Steiner
+ * points added one by one in an interactive editor. Each point is inserted in the triangulation with the Bowyer-Watson algorithm: The faces
+ * whose circumcircle contains the new point p (the cavity) are replaced by a star of faces around p. The graphs only change around p:
+ *
+ *  - DT:  The inner edges of the cavity are removed, the edges of p to the vertices of the cavity are added.
+ *  - NN:  The nearest neighbor of p is one of its Delaunay neighbors, and only those may have p as their new nearest neighbor.
+ *  - GG:  The diametral circle of a Gabriel edge is covered by the circumcircles of its adjacent faces, therefore an edge that p excludes from the
+ *         GG is an edge of the cavity. The new edges of p are tested with their opposite vertices.
+ *  - RNG: The edges whose lune contains p are found by visiting the vertices around p by increasing distance, up to the length of the longest
+ *         RNG edge. The new edges of p are tested like in graphs::relative_neighborhood_graph().
+ *  - MST: The new MST is a subset of the former MST and of the edges of p. Each edge of p, by increasing length, closes a cycle whose longest
+ *         edge is removed (the cycle check).
+ *
+ * The cost of an insertion is proportional to the size of the cavity and of the neighborhood of p. The cycle check of the MST searches the tree
+ * breadth-first from both ends of the new edge, so that it stops at the distance in the tree of the two ends.
+ *
+ * The point is not inserted if it is outside of the convex hull of the triangulation, on its boundary, or a duplicate of a vertex: insert()
+ * returns false and the caller recomputes the graphs from scratch (see proximity_graphs()).
+ */
+template <typename F, typename I = std::uint32_t>
+class IncrementalProximityGraphs
+{
+public:
+    using P = Point2d<F>;
+
+    struct Stats
+    {
+        std::size_t nb_cavity_faces{0};             // Faces of the triangulation replaced by the insertion
+        std::size_t nb_rng_vertices{0};             // Vertices visited by the update of the RNG
+        std::size_t nb_mst_vertices{0};             // Vertices visited by the cycle checks of the MST
+    };
+
+    // The input must be a Delaunay triangulation of its vertices. The vertices of the triangulation that are not referenced by a face (e.g.
+    // duplicated points) have no edges.
+    explicit IncrementalProximityGraphs(const Triangles2d<F, I>& delaunay);
+
+    // Return false if the point was not inserted, in which case nothing is modified
+    bool insert(const P& p);
+
+    std::size_t nb_vertices() const { return m_vertices.size(); }
+    const std::vector<P>& vertices() const { return m_vertices; }
+    const Stats& latest_stats() const { return m_stats; }
+
+    // The current triangulation, with its adjacency
+    Triangles2d<F, I> triangulation() const;
+
+    // The current graphs. With share_vertices, the graphs refer to ProximityGraphs::vertices like in proximity_graphs().
+    ProximityGraphs<P, I> graphs(const ProximityGraphsSelection& selection = ProximityGraphsSelection()) const;
+
+private:
+    // The edges of a graph, as the list of neighbors of each vertex
+    class AdjacencyLists
+    {
+    public:
+        void resize(std::size_t nb_vertices) { m_neighbors.resize(nb_vertices); }
+        bool contains(I i, I j) const { return std::find(m_neighbors[i].cbegin(), m_neighbors[i].cend(), j) != m_neighbors[i].cend(); }
+        void add(I i, I j) { assert(!contains(i, j)); m_neighbors[i].push_back(j); m_neighbors[j].push_back(i); }
+        bool remove(I i, I j);
+        const std::vector<I>& neighbors(I i) const { return m_neighbors[i]; }
+        graphs::EdgeSoup<I> edges() const;
+    private:
+        std::vector<std::vector<I>> m_neighbors;
+    };
+
+    F sq_distance(I i, I j) const { return sq_norm(m_vertices[j] - m_vertices[i]); }
+    template <typename Func>
+    void for_each_face_of_vertex(I v, Func func) const;
+    template <typename Func>
+    void for_each_delaunay_neighbor(I v, Func func) const;
+    I locate(const P& p) const;
+    bool is_gabriel_edge(I i, I j) const;
+    bool is_rng_edge(I i, I j);
+    void update_nearest_neighbors(I p_idx, const std::vector<I>& star);
+    void update_rng(I p_idx, const std::vector<I>& star);
+    void update_mst(I p_idx, const std::vector<I>& star);
+    std::size_t next_stamp();
+
+    std::vector<P> m_vertices;
+    graphs::TriangleSoup<I> m_faces;                // Counterclockwise
+    graphs::TriangleAdjacency<I> m_adjacency;
+    std::vector<I> m_vertex_face;                   // One face of each vertex, or undef
+    std::vector<I> m_nearest;                       // Nearest neighbor of each vertex, or undef
+    AdjacencyLists m_mst;
+    AdjacencyLists m_rng;
+    AdjacencyLists m_gg;
+    F m_max_sq_rng_length;                          // An upper bound of the squared length of the RNG edges
+    I m_last_face;                                  // Start of the point location
+    std::vector<std::size_t> m_stamps;              // Traversal support: The stamp of the latest traversal that visited each vertex
+    std::vector<I> m_parents;                       // Traversal support: The parent of each vertex visited by the latest traversal of the MST
+    std::size_t m_stamp;
+    Stats m_stats;
+};
+
+
+//
+//
+// Implementation
+//
+//
+
+
+template <typename F, typename I>
+bool IncrementalProximityGraphs<F, I>::AdjacencyLists::remove(I i, I j)
+{
+    const auto remove_one = [](std::vector<I>& neighbors, I n) {
+        const auto it = std::find(neighbors.begin(), neighbors.end(), n);
+        if (it == neighbors.end()) { return false; }
+        *it = neighbors.back();
+        neighbors.pop_back();
+        return true;
+    };
+    const bool removed = remove_one(m_neighbors[i], j);
+    if (removed) { remove_one(m_neighbors[j], i); }
+    return removed;
+}
+
+template <typename F, typename I>
+graphs::EdgeSoup<I> IncrementalProximityGraphs<F, I>::AdjacencyLists::edges() const
+{
+    graphs::EdgeSoup<I> result;
+    for (std::size_t i = 0; i < m_neighbors.size(); i++)
+        for (const I j : m_neighbors[i])
+            if (static_cast<std::size_t>(j) > i) { result.emplace_back(static_cast<I>(i), j); }
+    return result;
+}
+
+template <typename F, typename I>
+IncrementalProximityGraphs<F, I>::IncrementalProximityGraphs(const Triangles2d<F, I>& delaunay)
+    : m_vertices(delaunay.vertices)
+    , m_faces(delaunay.faces)
+    , m_adjacency()
+    , m_vertex_face(delaunay.vertices.size(), graphs::IndexTraits<I>::undef())
+    , m_nearest(delaunay.vertices.size(), graphs::IndexTraits<I>::undef())
+    , m_mst()
+    , m_rng()
+    , m_gg()
+    , m_max_sq_rng_length{0}
+    , m_last_face{0}
+    , m_stamps(delaunay.vertices.size(), 0u)
+    , m_parents(delaunay.vertices.size(), graphs::IndexTraits<I>::undef())
+    , m_stamp{0}
+    , m_stats()
+{
+    for (auto& face : m_faces)
+    {
+        if (orient2d(m_vertices[face[0]], m_vertices[face[1]], m_vertices[face[2]]) < 0.0) { face = graphs::Triangle<I>(face[0], face[2], face[1]); }
+    }
+    m_adjacency = graphs::triangle_adjacency(m_faces);
+    for (std::size_t f = 0; f < m_faces.size(); f++)
+        for (std::size_t k = 0; k < 3; k++) { m_vertex_face[m_faces[f][k]] = static_cast<I>(f); }
+
+    // The initial graphs are computed from scratch, and the nearest neighbors directly from the Delaunay edges
+    Triangles2d<F, I> oriented;
+    oriented.vertices = m_vertices;
+    oriented.faces = m_faces;
+    oriented.adjacency = m_adjacency;
+    ProximityGraphsSelection selection;
+    selection.nn = false;
+    selection.dt = false;
+    selection.share_vertices = true;
+    const auto initial = proximity_graphs(oriented, selection);
+    for (auto* lists : { &m_mst, &m_rng, &m_gg }) { lists->resize(m_vertices.size()); }
+    for (const auto& e : initial.mst.indices) { m_mst.add(e.orig(), e.dest()); }
+    for (const auto& e : initial.gg.indices) { m_gg.add(e.orig(), e.dest()); }
+    for (const auto& e : initial.rng.indices)
+    {
+        m_rng.add(e.orig(), e.dest());
+        m_max_sq_rng_length = std::max(m_max_sq_rng_length, sq_distance(e.orig(), e.dest()));
+    }
+    graphs::for_each_edge(m_faces, m_adjacency, [this](const graphs::Edge<I>& e, I, I) {
+        const F sq_length = sq_distance(e.orig(), e.dest());
+        for (const auto& [v, n] : { std::make_pair(e.orig(), e.dest()), std::make_pair(e.dest(), e.orig()) })
+        {
+            if (!graphs::is_defined(m_nearest[v]) || sq_length < sq_distance(v, m_nearest[v])) { m_nearest[v] = n; }
+        }
+    });
+}
+
+// Visit the faces of vertex v: func(I f, std::size_t k) with v == face[f][k]. Counterclockwise from a face of v, then clockwise if v is on
+// the convex hull.
+template <typename F, typename I>
+template <typename Func>
+void IncrementalProximityGraphs<F, I>::for_each_face_of_vertex(I v, Func func) const
+{
+    const I start = m_vertex_face[v];
+    if (!graphs::is_defined(start)) { return; }
+    const auto index_of_v = [this, v](I f) { return static_cast<std::size_t>(m_faces[f][0] == v ? 0 : (m_faces[f][1] == v ? 1 : 2)); };
+    I f = start;
+    do
+    {
+        const auto k = index_of_v(f);
+        func(f, k);
+        f = m_adjacency[f][(k + 2) % 3];
+    } while (graphs::is_defined(f) && f != start);
+    if (graphs::is_defined(f)) { return; }
+    f = m_adjacency[start][index_of_v(start)];
+    while (graphs::is_defined(f))
+    {
+        const auto k = index_of_v(f);
+        func(f, k);
+        f = m_adjacency[f][k];
+    }
+}
+
+// Visit the Delaunay neighbors of vertex v once each
+template <typename F, typename I>
+template <typename Func>
+void IncrementalProximityGraphs<F, I>::for_each_delaunay_neighbor(I v, Func func) const
+{
+    for_each_face_of_vertex(v, [this, &func](I f, std::size_t k) {
+        func(m_faces[f][(k + 1) % 3]);
+        // The last neighbor counterclockwise, on the convex hull
+        if (!graphs::is_defined(m_adjacency[f][(k + 2) % 3])) { func(m_faces[f][(k + 2) % 3]); }
+    });
+}
+
+// Visibility walk from the latest face. Return the face that contains p (possibly on one of its edges), or undef if p is outside of the convex hull.
+template <typename F, typename I>
+I IncrementalProximityGraphs<F, I>::locate(const P& p) const
+{
+    constexpr I Undef = graphs::IndexTraits<I>::undef();
+    if (m_faces.empty()) { return Undef; }
+    I f = m_last_face < m_faces.size() ? m_last_face : I{0};
+    for (std::size_t step = 0; step <= m_faces.size(); step++)
+    {
+        bool inside = true;
+        for (std::size_t k = 0; k < 3 && inside; k++)
+        {
+            if (orient2d(m_vertices[m_faces[f][k]], m_vertices[m_faces[f][(k + 1) % 3]], p) < 0.0)
+            {
+                f = m_adjacency[f][k];
+                if (!graphs::is_defined(f)) { return Undef; }
+                inside = false;
+            }
+        }
+        if (inside) { return f; }
+    }
+    return Undef;
+}
+
+// Like graphs::details::is_gabriel_edge(): The opposite vertices of edge ij lie outside of its diametral circle
+template <typename F, typename I>
+bool IncrementalProximityGraphs<F, I>::is_gabriel_edge(I i, I j) const
+{
+    const F sq_ij = sq_distance(i, j);
+    bool result = true;
+    for_each_face_of_vertex(i, [&](I f, std::size_t k) {
+        const auto& face = m_faces[f];
+        const I opposite = face[(k + 1) % 3] == j ? face[(k + 2) % 3] : (face[(k + 2) % 3] == j ? face[(k + 1) % 3] : graphs::IndexTraits<I>::undef());
+        if (graphs::is_defined(opposite) && sq_distance(i, opposite) + sq_distance(j, opposite) < sq_ij) { result = false; }
+    });
+    return result;
+}
+
+// Like graphs::details::is_rng_edge(): The lune of edge ij is searched by a traversal of the triangulation from i
+template <typename F, typename I>
+bool IncrementalProximityGraphs<F, I>::is_rng_edge(I i, I j)
+{
+    const F sq_ij = sq_distance(i, j);
+    const std::size_t stamp = next_stamp();
+    bool exclusion_zone_is_empty = true;
+    std::vector<I> to_visit(1, i);
+    m_stamps[i] = stamp;
+    while (exclusion_zone_is_empty && !to_visit.empty())
+    {
+        const I from = to_visit.back();
+        to_visit.pop_back();
+        for_each_delaunay_neighbor(from, [&](I k) {
+            if (m_stamps[k] == stamp) { return; }
+            m_stamps[k] = stamp;
+            m_stats.nb_rng_vertices++;
+            if (k == j || !(sq_distance(i, k) < sq_ij)) { return; }
+            exclusion_zone_is_empty &= !(sq_distance(j, k) < sq_ij);
+            to_visit.push_back(k);
+        });
+    }
+    return exclusion_zone_is_empty;
+}
+
+template <typename F, typename I>
+std::size_t IncrementalProximityGraphs<F, I>::next_stamp()
+{
+    m_stamps.resize(m_vertices.size(), 0u);
+    return ++m_stamp;
+}
+
+template <typename F, typename I>
+void IncrementalProximityGraphs<F, I>::update_nearest_neighbors(I p_idx, const std::vector<I>& star)
+{
+    for (const I s : star)
+    {
+        const F sq_length = sq_distance(p_idx, s);
+        if (!graphs::is_defined(m_nearest[p_idx]) || sq_length < sq_distance(p_idx, m_nearest[p_idx])) { m_nearest[p_idx] = s; }
+        if (!graphs::is_defined(m_nearest[s]) || sq_length < sq_distance(s, m_nearest[s])) { m_nearest[s] = p_idx; }
+    }
+}
+
+template <typename F, typename I>
+void IncrementalProximityGraphs<F, I>::update_rng(I p_idx, const std::vector<I>& star)
+{
+    // The former RNG edges whose lune contains p. The vertices are visited by increasing distance to p: The vertices closer to p than some
+    // radius are connected in the triangulation.
+    const auto lune_contains_p = [this, p_idx](I u, I v) {
+        const F sq_uv = sq_distance(u, v);
+        return sq_distance(p_idx, u) < sq_uv && sq_distance(p_idx, v) < sq_uv;
+    };
+    using Candidate = std::pair<F, I>;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> by_distance;
+    const std::size_t stamp = next_stamp();
+    m_stamps[p_idx] = stamp;
+    for (const I s : star) { m_stamps[s] = stamp; by_distance.emplace(sq_distance(p_idx, s), s); }
+    std::vector<graphs::Edge<I>> excluded;
+    while (!by_distance.empty() && by_distance.top().first < m_max_sq_rng_length)
+    {
+        const I u = by_distance.top().second;
+        by_distance.pop();
+        m_stats.nb_rng_vertices++;
+        for (const I v : m_rng.neighbors(u))
+        {
+            if (lune_contains_p(u, v)) { excluded.emplace_back(u, v); }
+        }
+        for_each_delaunay_neighbor(u, [&](I k) {
+            if (m_stamps[k] == stamp) { return; }
+            m_stamps[k] = stamp;
+            by_distance.emplace(sq_distance(p_idx, k), k);
+        });
+    }
+    for (const auto& e : excluded) { m_rng.remove(e.orig(), e.dest()); }
+
+    // The new edges
+    for (const I s : star)
+    {
+        if (m_gg.contains(p_idx, s) && is_rng_edge(p_idx, s))
+        {
+            m_rng.add(p_idx, s);
+            m_max_sq_rng_length = std::max(m_max_sq_rng_length, sq_distance(p_idx, s));
+        }
+    }
+}
+
+template <typename F, typename I>
+void IncrementalProximityGraphs<F, I>::update_mst(I p_idx, const std::vector<I>& star)
+{
+    std::vector<I> by_length(star);
+    std::sort(by_length.begin(), by_length.end(), [this, p_idx](I a, I b) { return sq_distance(p_idx, a) < sq_distance(p_idx, b); });
+    constexpr I Undef = graphs::IndexTraits<I>::undef();
+    std::array<std::vector<I>, 2> to_visit;         // Breadth-first, from s and from p
+    for (const I s : by_length)
+    {
+        if (m_mst.neighbors(p_idx).empty()) { m_mst.add(p_idx, s); continue; }
+
+        // Path from s to p in the tree, searched from both ends until the two searches meet on an edge (u_s, u_p)
+        const std::array<std::size_t, 2> stamps = { next_stamp(), next_stamp() };
+        const std::array<I, 2> ends = { s, p_idx };
+        m_parents.resize(m_vertices.size(), Undef);
+        std::array<std::size_t, 2> heads = { 0, 0 };
+        for (std::size_t side = 0; side < 2; side++)
+        {
+            to_visit[side].assign(1, ends[side]);
+            m_stamps[ends[side]] = stamps[side];
+            m_parents[ends[side]] = Undef;
+        }
+        std::array<I, 2> meeting = { Undef, Undef };
+        while (!graphs::is_defined(meeting[0]) && heads[0] < to_visit[0].size() && heads[1] < to_visit[1].size())
+        {
+            // Expand the smaller frontier
+            const std::size_t side = (to_visit[0].size() - heads[0]) <= (to_visit[1].size() - heads[1]) ? 0 : 1;
+            const I current = to_visit[side][heads[side]++];
+            m_stats.nb_mst_vertices++;
+            for (const I n : m_mst.neighbors(current))
+            {
+                if (m_stamps[n] == stamps[1 - side]) { meeting[side] = current; meeting[1 - side] = n; break; }
+                if (m_stamps[n] == stamps[side]) { continue; }
+                m_stamps[n] = stamps[side];
+                m_parents[n] = current;
+                to_visit[side].push_back(n);
+            }
+        }
+        if (!graphs::is_defined(meeting[0]))
+        {
+            // s is not connected to p yet (e.g. a vertex without edges)
+            m_mst.add(p_idx, s);
+            continue;
+        }
+
+        // The longest edge of the cycle closed by ps
+        graphs::Edge<I> longest(p_idx, s);
+        F longest_sq_length = sq_distance(p_idx, s);
+        const auto check_edge = [this, &longest, &longest_sq_length](I u, I v) {
+            const F sq_length = sq_distance(u, v);
+            if (sq_length > longest_sq_length) { longest = graphs::Edge<I>(u, v); longest_sq_length = sq_length; }
+        };
+        check_edge(meeting[0], meeting[1]);
+        for (std::size_t side = 0; side < 2; side++)
+        {
+            for (I v = meeting[side]; v != ends[side]; v = m_parents[v]) { check_edge(m_parents[v], v); }
+        }
+        if (longest.orig() != p_idx || longest.dest() != s)
+        {
+            m_mst.remove(longest.orig(), longest.dest());
+            m_mst.add(p_idx, s);
+        }
+    }
+}
+
+template <typename F, typename I>
+bool IncrementalProximityGraphs<F, I>::insert(const P& p)
+{
+    constexpr I Undef = graphs::IndexTraits<I>::undef();
+    m_stats = Stats();
+    if (m_vertices.size() >= static_cast<std::size_t>(graphs::IndexTraits<I>::max_valid_index())) { return false; }
+    const I containing_face = locate(p);
+    if (!graphs::is_defined(containing_face)) { return false; }
+    for (std::size_t k = 0; k < 3; k++)
+    {
+        const auto& a = m_vertices[m_faces[containing_face][k]];
+        const auto& b = m_vertices[m_faces[containing_face][(k + 1) % 3]];
+        if (a == p) { return false; }
+        if (!graphs::is_defined(m_adjacency[containing_face][k]) && orient2d(a, b, p) == 0.0) { return false; }     // On the convex hull
+    }
+
+    // The cavity: The faces whose circumcircle contains p, connected to the face that contains p
+    std::vector<I> cavity(1, containing_face);
+    std::vector<std::uint8_t> in_cavity(m_faces.size(), 0u);
+    in_cavity[containing_face] = 1u;
+    for (std::size_t idx = 0; idx < cavity.size(); idx++)
+    {
+        for (const I n : m_adjacency[cavity[idx]])
+        {
+            if (!graphs::is_defined(n) || in_cavity[n]) { continue; }
+            const auto& face = m_faces[n];
+            if (incircle(m_vertices[face[0]], m_vertices[face[1]], m_vertices[face[2]], p) > 0.0)
+            {
+                in_cavity[n] = 1u;
+                cavity.push_back(n);
+            }
+        }
+    }
+
+    // The boundary of the cavity, seen from p counterclockwise, and its inner edges
+    struct BoundaryEdge
+    {
+        I a, b;
+        I outside_face;
+    };
+    std::vector<BoundaryEdge> boundary;
+    std::vector<graphs::Edge<I>> inner_edges;
+    for (const I f : cavity)
+    {
+        for (std::size_t k = 0; k < 3; k++)
+        {
+            const I a = m_faces[f][k];
+            const I b = m_faces[f][(k + 1) % 3];
+            const I n = m_adjacency[f][k];
+            if (graphs::is_defined(n) && in_cavity[n])
+            {
+                if (f < n) { inner_edges.emplace_back(a, b); }
+                continue;
+            }
+            if (!(orient2d(m_vertices[a], m_vertices[b], p) > 0.0)) { return false; }    // Not star-shaped, which exact predicates prevent
+            boundary.push_back(BoundaryEdge{ a, b, n });
+        }
+    }
+    assert(boundary.size() == cavity.size() + 2);
+    m_stats.nb_cavity_faces = cavity.size();
+
+    // The new vertex
+    const auto p_idx = static_cast<I>(m_vertices.size());
+    m_vertices.push_back(p);
+    m_vertex_face.push_back(Undef);
+    m_nearest.push_back(Undef);
+    for (auto* lists : { &m_mst, &m_rng, &m_gg }) { lists->resize(m_vertices.size()); }
+
+    // The star of faces around p. The slots of the cavity are reused.
+    std::vector<I> new_faces(cavity);
+    while (new_faces.size() < boundary.size())
+    {
+        new_faces.push_back(static_cast<I>(m_faces.size()));
+        m_faces.emplace_back();
+        m_adjacency.push_back({ Undef, Undef, Undef });
+    }
+    for (std::size_t idx = 0; idx < boundary.size(); idx++)
+    {
+        const auto& edge = boundary[idx];
+        const I f = new_faces[idx];
+        m_faces[f] = graphs::Triangle<I>(edge.a, edge.b, p_idx);
+        m_adjacency[f][0] = edge.outside_face;
+        if (graphs::is_defined(edge.outside_face))
+        {
+            const auto n_k = graphs::edge_index(m_faces[edge.outside_face], edge.a, edge.b);
+            assert(n_k < 3);
+            m_adjacency[edge.outside_face][n_k] = f;
+        }
+        m_vertex_face[edge.a] = f;
+    }
+    for (std::size_t idx = 0; idx < boundary.size(); idx++)
+    {
+        // The edge b -> p of a face is shared with the face of the boundary edge that starts at b
+        const auto next_it = std::find_if(boundary.cbegin(), boundary.cend(), [b = boundary[idx].b](const BoundaryEdge& e) { return e.a == b; });
+        assert(next_it != boundary.cend());
+        const I f = new_faces[idx];
+        const I next_f = new_faces[static_cast<std::size_t>(std::distance(boundary.cbegin(), next_it))];
+        m_adjacency[f][1] = next_f;
+        m_adjacency[next_f][2] = f;
+    }
+    m_vertex_face[p_idx] = new_faces.front();
+    m_last_face = new_faces.front();
+
+    // Update the graphs
+    std::vector<I> star;
+    star.reserve(boundary.size());
+    for (const auto& edge : boundary) { star.push_back(edge.a); }
+    for (const auto& e : inner_edges) { m_gg.remove(e.orig(), e.dest()); m_rng.remove(e.orig(), e.dest()); }
+    for (const auto& edge : boundary)
+    {
+        if (m_gg.contains(edge.a, edge.b) && !is_gabriel_edge(edge.a, edge.b)) { m_gg.remove(edge.a, edge.b); m_rng.remove(edge.a, edge.b); }
+    }
+    for (const I s : star)
+    {
+        if (is_gabriel_edge(p_idx, s)) { m_gg.add(p_idx, s); }
+    }
+    update_nearest_neighbors(p_idx, star);
+    update_rng(p_idx, star);
+    update_mst(p_idx, star);
+    return true;
+}
+
+template <typename F, typename I>
+Triangles2d<F, I> IncrementalProximityGraphs<F, I>::triangulation() const
+{
+    Triangles2d<F, I> result;
+    result.vertices = m_vertices;
+    result.faces = m_faces;
+    result.adjacency = m_adjacency;
+    return result;
+}
+
+template <typename F, typename I>
+ProximityGraphs<typename IncrementalProximityGraphs<F, I>::P, I> IncrementalProximityGraphs<F, I>::graphs(const ProximityGraphsSelection& selection) const
+{
+    ProximityGraphs<P, I> result;
+    if (selection.nn)
+    {
+        for (std::size_t v = 0; v < m_nearest.size(); v++)
+        {
+            const I n = m_nearest[v];
+            // An edge is only listed once, when both vertices are the nearest neighbor of the other
+            if (graphs::is_defined(n) && (m_nearest[n] != static_cast<I>(v) || static_cast<std::size_t>(n) > v)) { result.nn.indices.emplace_back(static_cast<I>(v), n); }
+        }
+    }
+    if (selection.mst) { result.mst.indices = m_mst.edges(); }
+    if (selection.rng) { result.rng.indices = m_rng.edges(); }
+    if (selection.gg) { result.gg.indices = m_gg.edges(); }
+    if (selection.dt) { result.dt.indices = graphs::to_edge_soup(m_faces, m_adjacency); }
+    if (selection.share_vertices)
+    {
+        result.vertices = m_vertices;
+    }
+    else
+    {
+        for (auto* graph : { &result.nn, &result.mst, &result.rng, &result.gg, &result.dt }) { graph->vertices = m_vertices; }
+    }
+    return result;
+}
+
+} // namespace shapes
@@ -3,17 +3,22 @@
 #pragma once
 
 #include <shapes/path.h>
+#include <shapes/point.h>
 #include <shapes/point_cloud.h>
 #include <shapes/shapes.h>
 #include <shapes/soup.h>
+#include <shapes/vect.h>
 #include <stdutils/io.h>
+#include <stdutils/span.h>
 
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <variant>
 #include <vector>
 
@@ -25,9 +30,9 @@ struct ShapeWrapper
 {
     ShapeWrapper(shapes::AllShapes<F>&& shape, std::string descr = "") : shape(std::move(shape)), descr(descr) {}
 
-    // TODO: Fix properly. This ctor might move the geometry if T is resolved into a reference type
-    //template <typename T>
-    //ShapeWrapper(T&& geom, std::string descr = "") : shape(std::move(geom)), descr(descr) {}
+    // Move the geometry of an rvalue, e.g. a parsed point cloud. Disabled for the lvalues, which are copied by the overload below.
+    template <typename T, typename = std::enable_if_t<!std::is_lvalue_reference_v<T>>>
+    ShapeWrapper(T&& geom, std::string descr = "") : shape(std::move(geom)), descr(descr) {}
 
     template <typename T>
     ShapeWrapper(const T& geom, std::string descr = "") : shape(geom), descr(descr) {}
@@ -46,6 +51,12 @@ namespace dat {
     ShapeAggregate<double> parse_shapes_from_stream(std::istream& inputstream, const stdutils::io::ErrorHandler& err_handler) noexcept;
     ShapeAggregate<double> parse_shapes_from_file(std::filesystem::path filepath, const stdutils::io::ErrorHandler& err_handler) noexcept;
 
+    // Incremental parsing: The callback is called on each shape as soon as it is parsed, so that only one shape at a time is held in memory.
+    // The callback returns false to stop the parsing. Return false if the file could not be parsed.
+    using ShapeCallback = std::function<bool(ShapeWrapper<double>&&)>;
+    bool parse_shapes_from_stream(std::istream& inputstream, const ShapeCallback& callback, const stdutils::io::ErrorHandler& err_handler) noexcept;
+    bool parse_shapes_from_file(std::filesystem::path filepath, const ShapeCallback& callback, const stdutils::io::ErrorHandler& err_handler) noexcept;
+
     void save_shapes_as_stream(std::ostream& outputstream, const ShapeAggregate<double>& shapes, const stdutils::io::ErrorHandler& err_handler) noexcept;
     void save_shapes_as_file(std::filesystem::path filepath, const ShapeAggregate<double>& shapes, const stdutils::io::ErrorHandler& err_handler, std::string_view head_comment = "") noexcept;
 
@@ -63,6 +74,68 @@ namespace cdt {
     shapes::Soup2d<double> parse_2d_shapes_from_file(std::filesystem::path filepath, const stdutils::io::ErrorHandler& err_handler) noexcept;
     shapes::Soup3d<double> parse_3d_shapes_from_stream(std::istream& inputstream, const stdutils::io::ErrorHandler& err_handler) noexcept;
     shapes::Soup3d<double> parse_3d_shapes_from_file(std::filesystem::path filepath, const stdutils::io::ErrorHandler& err_handler) noexcept;
+
+    // Projection of the 3D points on a plane: The 2D coordinates of point p are (dot(p - origin, u), dot(p - origin, v)) and its height is
+    // dot(p - origin, cross_product(u, v)). The basis (u, v) is expected to be orthonormal. The default projection drops the z coordinate.
+    struct Projection
+    {
+        shapes::Point3d<double> origin{0.0, 0.0, 0.0};
+        shapes::Vect3d<double> u{1.0, 0.0, 0.0};
+        shapes::Vect3d<double> v{0.0, 1.0, 0.0};
+
+        static Projection drop_axis(unsigned int axis);                                                 // 0: x, 1: y, 2: z
+        static Projection plane(const shapes::Point3d<double>& origin, shapes::Vect3d<double> normal);  // The normal needs not be normalized
+    };
+
+    // The heights of the vertices of a projected soup, parallel to the vertices of its point cloud, its edges and its triangles
+    struct SoupHeights
+    {
+        std::vector<float> point_cloud;
+        std::vector<float> edges;
+        std::vector<float> triangles;
+    };
+
+    // Parse a 3D file directly into a 2D soup: Each vertex is projected as soon as it is parsed, so that the 3D soup is never held in memory.
+    // If heights is not null, it receives the heights of the vertices in single precision, e.g. to keep the elevation of a terrain.
+    shapes::Soup2d<double> parse_3d_shapes_projected_from_stream(std::istream& inputstream, const Projection& projection, const stdutils::io::ErrorHandler& err_handler, SoupHeights* heights = nullptr) noexcept;
+    shapes::Soup2d<double> parse_3d_shapes_projected_from_file(std::filesystem::path filepath, const Projection& projection, const stdutils::io::ErrorHandler& err_handler, SoupHeights* heights = nullptr) noexcept;
+
+    // The vertices are written in the order of the point cloud, the edges and the triangles of the soup
+    void save_2d_shapes_as_stream(std::ostream& outputstream, const shapes::Soup2d<double>& soup, const stdutils::io::ErrorHandler& err_handler) noexcept;
+    void save_2d_shapes_as_file(std::filesystem::path filepath, const shapes::Soup2d<double>& soup, const stdutils::io::ErrorHandler& err_handler, std::string_view head_comment = "") noexcept;
+    void save_3d_shapes_as_stream(std::ostream& outputstream, const shapes::Soup3d<double>& soup, const stdutils::io::ErrorHandler& err_handler) noexcept;
+    void save_3d_shapes_as_file(std::filesystem::path filepath, const shapes::Soup3d<double>& soup, const stdutils::io::ErrorHandler& err_handler, std::string_view head_comment = "") noexcept;
+}
+
+//
+// SHB format (binary)
+//
+namespace shb {
+    constexpr std::string_view FILE_EXTENSION = ".shb";
+
+    // A chunk of a SHB buffer. The coordinates and indices point directly into the buffer.
+    struct ChunkView
+    {
+        std::size_t shape_type;                         // Index of the shape type in shapes::AllShapes<double>
+        bool closed;                                    // For point paths and cubic bezier paths
+        std::string_view descr;
+        stdutils::Span<const double> coordinates;       // Size: dim * nb_vertices
+        stdutils::Span<const std::uint32_t> indices;    // Size: 2 * nb_edges, or 3 * nb_triangles, or 0
+    };
+
+    // Zero-copy access to the content of a SHB buffer.
+    // The buffer must be 8-byte aligned (e.g. a memory-mapped file), and the host little-endian.
+    bool view_chunks(std::string_view buffer, std::vector<ChunkView>& chunks, const stdutils::io::ErrorHandler& err_handler) noexcept;
+
+    ShapeAggregate<double> parse_shapes_from_buffer(std::string_view buffer, const stdutils::io::ErrorHandler& err_handler) noexcept;
+    ShapeAggregate<double> parse_shapes_from_file(std::filesystem::path filepath, const stdutils::io::ErrorHandler& err_handler) noexcept;
+    shapes::Soup2d<double> parse_2d_shapes_from_file(std::filesystem::path filepath, const stdutils::io::ErrorHandler& err_handler) noexcept;
+    shapes::Soup3d<double> parse_3d_shapes_from_file(std::filesystem::path filepath, const stdutils::io::ErrorHandler& err_handler) noexcept;
+
+    void save_shapes_as_stream(std::ostream& outputstream, const ShapeAggregate<double>& shapes, const stdutils::io::ErrorHandler& err_handler) noexcept;
+    void save_shapes_as_file(std::filesystem::path filepath, const ShapeAggregate<double>& shapes, const stdutils::io::ErrorHandler& err_handler) noexcept;
+    void save_shapes_as_file(std::filesystem::path filepath, const shapes::Soup2d<double>& soup, const stdutils::io::ErrorHandler& err_handler) noexcept;
+    void save_shapes_as_file(std::filesystem::path filepath, const shapes::Soup3d<double>& soup, const stdutils::io::ErrorHandler& err_handler) noexcept;
 }
 
 } // namespace io
@@ -0,0 +1,94 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <shapes/edge.h>
+#include <shapes/path.h>
+#include <shapes/point_cloud.h>
+#include <shapes/shapes.h>
+#include <shapes/soup.h>
+#include <shapes/triangle.h>
+#include <stdutils/memory.h>
+
+#include <cstddef>
+#include <variant>
+
+namespace shapes {
+
+/**
+ * Byte size of the shapes: The heap memory held by their vertices and indices. See stdutils/memory.h
+ */
+template <typename P>
+std::size_t byte_size(const PointCloud<P>& pc) noexcept;
+
+template <typename P>
+std::size_t byte_size(const PointPath<P>& pp) noexcept;
+
+template <typename P>
+std::size_t byte_size(const CubicBezierPath<P>& cbp) noexcept;
+
+template <typename P, typename I>
+std::size_t byte_size(const Edges<P, I>& edges) noexcept;
+
+template <typename P, typename I>
+std::size_t byte_size(const Triangles<P, I>& triangles) noexcept;
+
+template <typename P, typename I>
+std::size_t byte_size(const Soup<P, I>& soup) noexcept;
+
+template <typename F>
+std::size_t byte_size(const AllShapes<F>& shape) noexcept;
+
+
+//
+//
+// Implementation
+//
+//
+
+
+template <typename P>
+std::size_t byte_size(const PointCloud<P>& pc) noexcept
+{
+    return stdutils::memory::byte_size(pc.vertices);
+}
+
+template <typename P>
+std::size_t byte_size(const PointPath<P>& pp) noexcept
+{
+    return stdutils::memory::byte_size(pp.vertices);
+}
+
+template <typename P>
+std::size_t byte_size(const CubicBezierPath<P>& cbp) noexcept
+{
+    return stdutils::memory::byte_size(cbp.vertices);
+}
+
+template <typename P, typename I>
+std::size_t byte_size(const Edges<P, I>& edges) noexcept
+{
+    return stdutils::memory::byte_size(edges.vertices) + stdutils::memory::byte_size(edges.indices);
+}
+
+template <typename P, typename I>
+std::size_t byte_size(const Triangles<P, I>& triangles) noexcept
+{
+    return stdutils::memory::byte_size(triangles.vertices)
+         + stdutils::memory::byte_size(triangles.faces)
+         + stdutils::memory::byte_size(triangles.adjacency);
+}
+
+template <typename P, typename I>
+std::size_t byte_size(const Soup<P, I>& soup) noexcept
+{
+    return byte_size(soup.point_cloud) + byte_size(soup.edges) + byte_size(soup.triangles);
+}
+
+template <typename F>
+std::size_t byte_size(const AllShapes<F>& shape) noexcept
+{
+    return std::visit([](const auto& s) { return byte_size(s); }, shape);
+}
+
+} // namespace shapes
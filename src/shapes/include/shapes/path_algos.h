@@ -5,8 +5,19 @@
 #include <graphs/graph_algos.h>
 #include <shapes/edge.h>
 #include <shapes/path.h>
+#include <shapes/point.h>
+#include <shapes/predicates.h>
+#include <stdutils/parallel.h>
 
 #include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
 #include <vector>
 
 namespace shapes {
@@ -22,6 +33,36 @@ std::vector<PointPath<P>> extract_paths(const Edges<P, I>& edges);
 template <typename P>
 bool flip_open_closed(PointPath<P>& pp);
 
+/**
+ * Simplification of 2D polylines
+ *
+ *  - Douglas-Peucker: The vertices removed are within the tolerance of the simplified path
+ *  - Visvalingam-Whyatt: The vertices are removed by increasing effective area, while that area is lower than tolerance^2
+ *
+ * The endpoints of an open path are kept, and a closed path keeps at least 3 vertices. If preserve_topology is true, the segments of the
+ * simplified paths do not cross or touch each other unless the original segments did: The vertices needed to separate them are restored.
+ * Only the segments are tested, therefore a path that lies entirely behind a simplified segment of another one is not detected.
+ */
+enum class SimplificationMethod
+{
+    DouglasPeucker,
+    VisvalingamWhyatt,
+};
+
+struct SimplificationOptions
+{
+    SimplificationMethod method{SimplificationMethod::DouglasPeucker};
+    double tolerance{0.0};                  // Distance. Zero keeps all the vertices.
+    bool preserve_topology{true};
+};
+
+template <typename F>
+PointPath2d<F> simplify_path(const PointPath2d<F>& pp, const SimplificationOptions& options);
+
+// The paths are simplified concurrently. The topology is preserved between all the paths.
+template <typename F>
+std::vector<PointPath2d<F>> simplify_paths(const stdutils::parallel::Policy& policy, const std::vector<PointPath2d<F>>& paths, const SimplificationOptions& options);
+
 
 //
 //
@@ -74,4 +115,332 @@ bool flip_open_closed(PointPath<P>& pp)
     return pp.closed != pre_closed;
 }
 
+namespace details {
+namespace simplification {
+
+// One flag per vertex of a path, non-zero if the vertex is kept
+using Mask = std::vector<std::uint8_t>;
+
+template <typename F>
+F sq_distance_to_segment(const Point2d<F>& p, const Point2d<F>& a, const Point2d<F>& b)
+{
+    const F abx = b.x - a.x;
+    const F aby = b.y - a.y;
+    const F apx = p.x - a.x;
+    const F apy = p.y - a.y;
+    const F sq_len = abx * abx + aby * aby;
+    F t = sq_len > F{0} ? (apx * abx + apy * aby) / sq_len : F{0};
+    t = std::clamp(t, F{0}, F{1});
+    const F dx = apx - t * abx;
+    const F dy = apy - t * aby;
+    return dx * dx + dy * dy;
+}
+
+// The vertex farthest from the segment (vertices[first], vertices[last % n]) among those strictly in between, or first if there is none
+template <typename F>
+std::size_t farthest_vertex(const std::vector<Point2d<F>>& vertices, std::size_t first, std::size_t last, F& sq_dist)
+{
+    const std::size_t n = vertices.size();
+    std::size_t result = first;
+    sq_dist = F{0};
+    for (std::size_t idx = first + 1; idx < last; idx++)
+    {
+        const F d = sq_distance_to_segment(vertices[idx % n], vertices[first % n], vertices[last % n]);
+        if (d > sq_dist || result == first)
+        {
+            sq_dist = d;
+            result = idx;
+        }
+    }
+    return result;
+}
+
+// The indices of a closed path are taken modulo n: The range [first, last] may end with n, the first vertex
+template <typename F>
+void douglas_peucker(const std::vector<Point2d<F>>& vertices, std::size_t first, std::size_t last, F sq_tolerance, Mask& mask)
+{
+    std::vector<std::pair<std::size_t, std::size_t>> stack;
+    stack.emplace_back(first, last);
+    while (!stack.empty())
+    {
+        const auto [begin_idx, end_idx] = stack.back();
+        stack.pop_back();
+        F sq_dist{0};
+        const std::size_t idx = farthest_vertex(vertices, begin_idx, end_idx, sq_dist);
+        if (idx == begin_idx || !(sq_dist > sq_tolerance))
+            continue;
+        mask[idx] = 1;
+        stack.emplace_back(begin_idx, idx);
+        stack.emplace_back(idx, end_idx);
+    }
+}
+
+template <typename F>
+Mask douglas_peucker_mask(const PointPath2d<F>& pp, F tolerance)
+{
+    const auto& vertices = pp.vertices;
+    const std::size_t n = vertices.size();
+    const std::size_t min_size = pp.closed ? 3 : 2;
+    Mask mask(n, n <= min_size ? 1 : 0);
+    if (n <= min_size)
+        return mask;
+    const F sq_tolerance = tolerance * tolerance;
+    mask[0] = 1;
+    if (!pp.closed)
+    {
+        mask[n - 1] = 1;
+        douglas_peucker(vertices, 0, n - 1, sq_tolerance, mask);
+        return mask;
+    }
+    // Closed path: Split it at the vertex farthest from the first one, which the two halves then share
+    std::size_t split = 1;
+    F max_sq_dist{0};
+    for (std::size_t idx = 1; idx < n; idx++)
+    {
+        const F d = sq_distance_to_segment(vertices[idx], vertices[0], vertices[0]);
+        if (d > max_sq_dist) { max_sq_dist = d; split = idx; }
+    }
+    mask[split] = 1;
+    douglas_peucker(vertices, 0, split, sq_tolerance, mask);
+    douglas_peucker(vertices, split, n, sq_tolerance, mask);
+    if (std::count(mask.cbegin(), mask.cend(), std::uint8_t{1}) < 3)
+    {
+        F d0{0};
+        F d1{0};
+        const std::size_t idx0 = farthest_vertex(vertices, 0, split, d0);
+        const std::size_t idx1 = farthest_vertex(vertices, split, n, d1);
+        mask[(idx0 != 0 && (d0 >= d1 || idx1 == split)) ? idx0 : idx1] = 1;
+    }
+    return mask;
+}
+
+template <typename F>
+Mask visvalingam_whyatt_mask(const PointPath2d<F>& pp, F tolerance)
+{
+    const auto& vertices = pp.vertices;
+    const std::size_t n = vertices.size();
+    const std::size_t min_size = pp.closed ? 3 : 2;
+    Mask mask(n, 1);
+    if (n <= min_size)
+        return mask;
+    const F max_area = tolerance * tolerance;
+
+    // Doubly linked list of the remaining vertices, and a min-heap of their (effective area, index). The stale entries are skipped.
+    constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> prev(n);
+    std::vector<std::size_t> next(n);
+    std::vector<F> area(n, F{0});
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        prev[idx] = idx > 0 ? idx - 1 : (pp.closed ? n - 1 : none);
+        next[idx] = idx + 1 < n ? idx + 1 : (pp.closed ? 0 : none);
+    }
+    const auto triangle_area = [&](std::size_t idx) {
+        const auto& a = vertices[prev[idx]];
+        const auto& b = vertices[idx];
+        const auto& c = vertices[next[idx]];
+        return std::abs((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)) / F{2};
+    };
+    using Entry = std::pair<F, std::size_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        if (prev[idx] == none || next[idx] == none)
+            continue;
+        area[idx] = triangle_area(idx);
+        heap.emplace(area[idx], idx);
+    }
+    std::size_t remaining = n;
+    while (!heap.empty() && remaining > min_size)
+    {
+        const auto [a, idx] = heap.top();
+        heap.pop();
+        if (mask[idx] == 0 || a != area[idx])
+            continue;
+        if (!(a < max_area))
+            break;
+        mask[idx] = 0;
+        remaining--;
+        next[prev[idx]] = next[idx];
+        prev[next[idx]] = prev[idx];
+        for (const std::size_t neighbor : { prev[idx], next[idx] })
+        {
+            if (prev[neighbor] == none || next[neighbor] == none)
+                continue;
+            // The effective area does not decrease, so that a vertex is not removed before a more significant one
+            area[neighbor] = std::max(triangle_area(neighbor), a);
+            heap.emplace(area[neighbor], neighbor);
+        }
+    }
+    return mask;
+}
+
+// A segment of a simplified path: Its endpoints are the kept vertices from and to % n of the original path
+struct Segment
+{
+    std::size_t path_idx;
+    std::size_t from;
+    std::size_t to;
+};
+
+template <typename F>
+bool on_segment(const Point2d<F>& p, const Point2d<F>& a, const Point2d<F>& b)
+{
+    // p is collinear with (a, b)
+    return std::min(a.x, b.x) <= p.x && p.x <= std::max(a.x, b.x) && std::min(a.y, b.y) <= p.y && p.y <= std::max(a.y, b.y);
+}
+
+// Exact test. The segments sharing an endpoint are not reported.
+template <typename F>
+bool segments_intersect(const Point2d<F>& a, const Point2d<F>& b, const Point2d<F>& c, const Point2d<F>& d)
+{
+    if (a == c || a == d || b == c || b == d)
+        return false;
+    const double o1 = orient2d(a, b, c);
+    const double o2 = orient2d(a, b, d);
+    const double o3 = orient2d(c, d, a);
+    const double o4 = orient2d(c, d, b);
+    if (((o1 > 0.0 && o2 < 0.0) || (o1 < 0.0 && o2 > 0.0)) && ((o3 > 0.0 && o4 < 0.0) || (o3 < 0.0 && o4 > 0.0)))
+        return true;
+    return (o1 == 0.0 && on_segment(c, a, b)) || (o2 == 0.0 && on_segment(d, a, b))
+        || (o3 == 0.0 && on_segment(a, c, d)) || (o4 == 0.0 && on_segment(b, c, d));
+}
+
+// Restore vertices until the simplified segments that intersect each other cannot be refined anymore. The refinement of a segment keeps
+// the vertex of the original path that is the farthest from it.
+template <typename F>
+void restore_topology(const std::vector<PointPath2d<F>>& paths, std::vector<Mask>& masks)
+{
+    assert(paths.size() == masks.size());
+    std::vector<Segment> segments;
+    std::vector<std::uint8_t> refine;
+    while (true)
+    {
+        segments.clear();
+        for (std::size_t path_idx = 0; path_idx < paths.size(); path_idx++)
+        {
+            const auto& mask = masks[path_idx];
+            const std::size_t n = mask.size();
+            std::size_t first_kept = n;
+            std::size_t prev_kept = n;
+            for (std::size_t idx = 0; idx < n; idx++)
+            {
+                if (mask[idx] == 0)
+                    continue;
+                if (prev_kept < n) { segments.push_back(Segment{ path_idx, prev_kept, idx }); }
+                else { first_kept = idx; }
+                prev_kept = idx;
+            }
+            if (paths[path_idx].closed && prev_kept < n && prev_kept != first_kept)
+                segments.push_back(Segment{ path_idx, prev_kept, first_kept + n });
+        }
+        const auto endpoint = [&paths](const Segment& s, bool to) -> const Point2d<F>& {
+            const auto& vertices = paths[s.path_idx].vertices;
+            return vertices[(to ? s.to : s.from) % vertices.size()];
+        };
+        const auto min_x = [&endpoint](const Segment& s) { return std::min(endpoint(s, false).x, endpoint(s, true).x); };
+        const auto max_x = [&endpoint](const Segment& s) { return std::max(endpoint(s, false).x, endpoint(s, true).x); };
+        std::sort(segments.begin(), segments.end(), [&min_x](const Segment& lhs, const Segment& rhs) { return min_x(lhs) < min_x(rhs); });
+
+        // Sweep along the X axis
+        refine.assign(segments.size(), 0);
+        bool has_refinement = false;
+        const auto mark = [&](std::size_t s_idx) {
+            const auto& s = segments[s_idx];
+            if (s.to > s.from + 1) { refine[s_idx] = 1; has_refinement = true; }
+        };
+        for (std::size_t i = 0; i < segments.size(); i++)
+        {
+            const F i_max_x = max_x(segments[i]);
+            for (std::size_t j = i + 1; j < segments.size() && min_x(segments[j]) <= i_max_x; j++)
+            {
+                if (refine[i] && refine[j])
+                    continue;
+                if (segments_intersect(endpoint(segments[i], false), endpoint(segments[i], true), endpoint(segments[j], false), endpoint(segments[j], true)))
+                {
+                    mark(i);
+                    mark(j);
+                }
+            }
+        }
+        if (!has_refinement)
+            break;
+        for (std::size_t s_idx = 0; s_idx < segments.size(); s_idx++)
+        {
+            if (!refine[s_idx])
+                continue;
+            const auto& s = segments[s_idx];
+            F sq_dist{0};
+            const std::size_t idx = farthest_vertex(paths[s.path_idx].vertices, s.from, s.to, sq_dist);
+            masks[s.path_idx][idx % masks[s.path_idx].size()] = 1;
+        }
+    }
+}
+
+template <typename F>
+Mask simplification_mask(const PointPath2d<F>& pp, const SimplificationOptions& options)
+{
+    const F tolerance = static_cast<F>(options.tolerance);
+    if (!(tolerance > F{0}))
+        return Mask(pp.vertices.size(), 1);
+    switch (options.method)
+    {
+        case SimplificationMethod::DouglasPeucker:
+            return douglas_peucker_mask(pp, tolerance);
+
+        case SimplificationMethod::VisvalingamWhyatt:
+            return visvalingam_whyatt_mask(pp, tolerance);
+
+        default:
+            assert(0);
+            return Mask(pp.vertices.size(), 1);
+    }
+}
+
+template <typename F>
+PointPath2d<F> apply_mask(const PointPath2d<F>& pp, const Mask& mask)
+{
+    assert(mask.size() == pp.vertices.size());
+    PointPath2d<F> result;
+    result.closed = pp.closed;
+    result.vertices.reserve(static_cast<std::size_t>(std::count(mask.cbegin(), mask.cend(), std::uint8_t{1})));
+    for (std::size_t idx = 0; idx < mask.size(); idx++)
+    {
+        if (mask[idx]) { result.vertices.push_back(pp.vertices[idx]); }
+    }
+    return result;
+}
+
+} // namespace simplification
+} // namespace details
+
+template <typename F>
+PointPath2d<F> simplify_path(const PointPath2d<F>& pp, const SimplificationOptions& options)
+{
+    std::vector<details::simplification::Mask> masks;
+    masks.emplace_back(details::simplification::simplification_mask(pp, options));
+    if (options.preserve_topology)
+    {
+        const std::vector<PointPath2d<F>> paths = { pp };
+        details::simplification::restore_topology(paths, masks);
+    }
+    return details::simplification::apply_mask(pp, masks.front());
+}
+
+template <typename F>
+std::vector<PointPath2d<F>> simplify_paths(const stdutils::parallel::Policy& policy, const std::vector<PointPath2d<F>>& paths, const SimplificationOptions& options)
+{
+    std::vector<details::simplification::Mask> masks(paths.size());
+    stdutils::parallel::for_each_dynamic(policy, paths.size(), [&paths, &masks, &options](std::size_t, std::size_t idx) {
+        masks[idx] = details::simplification::simplification_mask(paths[idx], options);
+    });
+    if (options.preserve_topology)
+        details::simplification::restore_topology(paths, masks);
+    std::vector<PointPath2d<F>> result(paths.size());
+    stdutils::parallel::for_each_dynamic(policy, paths.size(), [&paths, &masks, &result](std::size_t, std::size_t idx) {
+        result[idx] = details::simplification::apply_mask(paths[idx], masks[idx]);
+    });
+    return result;
+}
+
 } // namespace shapes
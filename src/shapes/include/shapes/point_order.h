@@ -0,0 +1,138 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <shapes/bounding_box.h>
+#include <shapes/point.h>
+#include <stdutils/span.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace shapes {
+
+/**
+ * Spatial orders of a point set
+ *
+ * The functions return a permutation of the indices of the input points: The k-th point in the order is points[order[k]].
+ * Points that are close in the order are close in the plane, which improves the locality of the algorithms that process the
+ * points in sequence, like the incremental Delaunay triangulation.
+ */
+
+// Position of the cell (x, y) of the grid [0, 2^order)^2 along the Hilbert curve of the same order. Require order <= 16.
+std::uint32_t hilbert_index(std::uint32_t x, std::uint32_t y, unsigned int order = 16) noexcept;
+
+// Order the points along a Hilbert curve covering their bounding box
+template <typename I, typename F>
+std::vector<I> hilbert_order(stdutils::Span<const Point2d<F>> points);
+
+// Biased Randomized Insertion Order: Shuffle the points and split them in rounds of doubling size, the last round holding half the points.
+// Each round is ordered along the Hilbert curve. The order is deterministic for a given seed.
+template <typename I, typename F>
+std::vector<I> brio_order(stdutils::Span<const Point2d<F>> points, std::uint32_t seed = 0);
+
+
+//
+//
+// Implementation
+//
+//
+
+
+inline std::uint32_t hilbert_index(std::uint32_t x, std::uint32_t y, unsigned int order) noexcept
+{
+    assert(order <= 16);
+    std::uint32_t d = 0;
+    for (std::uint32_t s = (1u << order) >> 1; s > 0; s >>= 1)
+    {
+        const std::uint32_t rx = (x & s) ? 1 : 0;
+        const std::uint32_t ry = (y & s) ? 1 : 0;
+        d += s * s * ((3 * rx) ^ ry);
+        // Rotate the quadrant so that the curve is in canonical position in the sub-square
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                x = s - 1 - (x & (s - 1));
+                y = s - 1 - (y & (s - 1));
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+namespace details {
+
+    // Hilbert index of each point, on a grid of order 16 fitted to the bounding box of the points
+    template <typename F>
+    std::vector<std::uint32_t> hilbert_keys(stdutils::Span<const Point2d<F>> points)
+    {
+        BoundingBox2d<F> bb;
+        for (const auto& p : points) { bb.add(p); }
+        constexpr unsigned int order = 16;
+        constexpr double grid_max = static_cast<double>((1u << order) - 1);
+        const auto cell = [grid_max](F v, const Range<F>& r) -> std::uint32_t {
+            const double length = static_cast<double>(r.length());
+            if (!(length > 0.0)) { return 0; }
+            const double t = grid_max * (static_cast<double>(v) - static_cast<double>(r.min)) / length;
+            return static_cast<std::uint32_t>(std::clamp(t, 0.0, grid_max));
+        };
+        std::vector<std::uint32_t> keys;
+        keys.reserve(points.size());
+        for (const auto& p : points) { keys.push_back(hilbert_index(cell(p.x, bb.rx), cell(p.y, bb.ry), order)); }
+        return keys;
+    }
+
+    template <typename I, typename It>
+    void sort_by_key(It first, It last, const std::vector<std::uint32_t>& keys)
+    {
+        std::sort(first, last, [&keys](I a, I b) { return keys[static_cast<std::size_t>(a)] < keys[static_cast<std::size_t>(b)]; });
+    }
+
+} // namespace details
+
+template <typename I, typename F>
+std::vector<I> hilbert_order(stdutils::Span<const Point2d<F>> points)
+{
+    std::vector<I> result(points.size());
+    std::iota(result.begin(), result.end(), I{0});
+    if (points.size() < 2) { return result; }
+    const auto keys = details::hilbert_keys(points);
+    details::sort_by_key<I>(result.begin(), result.end(), keys);
+    return result;
+}
+
+template <typename I, typename F>
+std::vector<I> brio_order(stdutils::Span<const Point2d<F>> points, std::uint32_t seed)
+{
+    std::vector<I> result(points.size());
+    std::iota(result.begin(), result.end(), I{0});
+    if (points.size() < 2) { return result; }
+    const auto keys = details::hilbert_keys(points);
+    std::mt19937 rng(seed);
+    std::shuffle(result.begin(), result.end(), rng);
+
+    // Rounds [bounds[k], bounds[k+1]), the last one being [n/2, n)
+    constexpr std::size_t min_round_size = 64;
+    std::vector<std::size_t> bounds;
+    for (std::size_t b = points.size(); b > min_round_size; b /= 2) { bounds.push_back(b); }
+    bounds.push_back(0);
+    std::reverse(bounds.begin(), bounds.end());
+    if (bounds.back() != points.size()) { bounds.push_back(points.size()); }
+    for (std::size_t k = 0; k + 1 < bounds.size(); k++)
+    {
+        const auto first = result.begin() + static_cast<std::ptrdiff_t>(bounds[k]);
+        const auto last = result.begin() + static_cast<std::ptrdiff_t>(bounds[k + 1]);
+        details::sort_by_key<I>(first, last, keys);
+    }
+    return result;
+}
+
+} // namespace shapes
@@ -0,0 +1,279 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <graphs/graph.h>
+#include <shapes/bounding_box.h>
+#include <shapes/path.h>
+#include <shapes/point.h>
+#include <shapes/point_cloud.h>
+#include <shapes/triangle.h>
+#include <stdutils/aligned_allocator.h>
+#include <stdutils/span.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace shapes {
+
+/**
+ * Structure-of-arrays storage of 2D points
+ *
+ * The x and y coordinates are stored in two separate arrays, aligned on a cache line, so that the loops on the coordinates run at the full
+ * width of the SIMD registers, and each array can be uploaded as is to the GPU. The shapes below are the SoA counterparts of PointCloud2d,
+ * PointPath2d and Triangles2d, with the same members except for the vertices, and conversions from and to the AoS shapes.
+ */
+template <typename F>
+struct Points2dSoA
+{
+    static constexpr std::size_t Alignment = 64;
+    using scalar = F;
+    using Array = std::vector<F, stdutils::AlignedAllocator<F, Alignment>>;
+
+    std::size_t size() const { assert(x.size() == y.size()); return x.size(); }
+    bool empty() const { return x.empty(); }
+    void reserve(std::size_t n) { x.reserve(n); y.reserve(n); }
+    void resize(std::size_t n) { x.resize(n); y.resize(n); }
+    void clear() { x.clear(); y.clear(); }
+    void push_back(const Point2d<F>& p) { x.push_back(p.x); y.push_back(p.y); }
+    Point2d<F> operator[](std::size_t idx) const { return Point2d<F>(x[idx], y[idx]); }
+    void set(std::size_t idx, const Point2d<F>& p) { x[idx] = p.x; y[idx] = p.y; }
+
+    Array x;
+    Array y;
+};
+
+// Read-only view of the coordinates of SoA points
+template <typename F>
+struct Points2dSoAView
+{
+    std::size_t size() const { assert(x.size() == y.size()); return x.size(); }
+    bool empty() const { return x.empty(); }
+    Point2d<F> operator[](std::size_t idx) const { return Point2d<F>(x[idx], y[idx]); }
+
+    stdutils::Span<const F> x;
+    stdutils::Span<const F> y;
+};
+
+template <typename F>
+struct PointCloud2dSoA
+{
+    static constexpr int dim = 2;
+    using scalar = F;
+    Points2dSoA<F> vertices;
+};
+
+template <typename F>
+struct PointPath2dSoA
+{
+    static constexpr int dim = 2;
+    using scalar = F;
+    bool closed = false;
+    Points2dSoA<F> vertices;
+};
+
+template <typename F, typename I = std::uint32_t>
+struct Triangles2dSoA
+{
+    static constexpr int dim = 2;
+    using scalar = F;
+    using index = I;
+    using face = graphs::Triangle<I>;
+    Points2dSoA<F> vertices;
+    graphs::TriangleSoup<I> faces;
+    graphs::TriangleAdjacency<I> adjacency;
+};
+
+template <typename F>
+Points2dSoAView<F> view(const Points2dSoA<F>& points);
+
+// Conversions
+template <typename F>
+Points2dSoA<F> to_soa(const std::vector<Point2d<F>>& points);
+template <typename F>
+PointCloud2dSoA<F> to_soa(const PointCloud2d<F>& pc);
+template <typename F>
+PointPath2dSoA<F> to_soa(const PointPath2d<F>& pp);
+template <typename F, typename I>
+Triangles2dSoA<F, I> to_soa(const Triangles2d<F, I>& triangles);
+
+template <typename F>
+std::vector<Point2d<F>> to_aos(const Points2dSoAView<F>& points);
+template <typename F>
+PointCloud2d<F> to_aos(const PointCloud2dSoA<F>& pc);
+template <typename F>
+PointPath2d<F> to_aos(const PointPath2dSoA<F>& pp);
+template <typename F, typename I>
+Triangles2d<F, I> to_aos(const Triangles2dSoA<F, I>& triangles);
+
+// Kernels
+template <typename F>
+BoundingBox2d<F> bounding_box(const Points2dSoAView<F>& points);
+
+// Squared length of each edge. The output span must have the same size as the edges.
+template <typename F, typename I>
+void sq_distances(const Points2dSoAView<F>& points, stdutils::Span<const graphs::Edge<I>> edges, stdutils::Span<F> out);
+
+
+//
+//
+// Implementation
+//
+//
+
+
+template <typename F>
+Points2dSoAView<F> view(const Points2dSoA<F>& points)
+{
+    Points2dSoAView<F> result;
+    if (!points.empty())
+    {
+        result.x = stdutils::Span<const F>(points.x.data(), points.x.size());
+        result.y = stdutils::Span<const F>(points.y.data(), points.y.size());
+    }
+    return result;
+}
+
+template <typename F>
+Points2dSoA<F> to_soa(const std::vector<Point2d<F>>& points)
+{
+    Points2dSoA<F> result;
+    result.resize(points.size());
+    const std::size_t n = points.size();
+    const Point2d<F>* in_ptr = points.data();
+    F* x_ptr = result.x.data();
+    F* y_ptr = result.y.data();
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        x_ptr[idx] = in_ptr[idx].x;
+        y_ptr[idx] = in_ptr[idx].y;
+    }
+    return result;
+}
+
+template <typename F>
+PointCloud2dSoA<F> to_soa(const PointCloud2d<F>& pc)
+{
+    PointCloud2dSoA<F> result;
+    result.vertices = to_soa(pc.vertices);
+    return result;
+}
+
+template <typename F>
+PointPath2dSoA<F> to_soa(const PointPath2d<F>& pp)
+{
+    PointPath2dSoA<F> result;
+    result.closed = pp.closed;
+    result.vertices = to_soa(pp.vertices);
+    return result;
+}
+
+template <typename F, typename I>
+Triangles2dSoA<F, I> to_soa(const Triangles2d<F, I>& triangles)
+{
+    Triangles2dSoA<F, I> result;
+    result.vertices = to_soa(triangles.vertices);
+    result.faces = triangles.faces;
+    result.adjacency = triangles.adjacency;
+    return result;
+}
+
+template <typename F>
+std::vector<Point2d<F>> to_aos(const Points2dSoAView<F>& points)
+{
+    std::vector<Point2d<F>> result(points.size());
+    const std::size_t n = points.size();
+    const F* x_ptr = points.x.data();
+    const F* y_ptr = points.y.data();
+    Point2d<F>* out_ptr = result.data();
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        out_ptr[idx].x = x_ptr[idx];
+        out_ptr[idx].y = y_ptr[idx];
+    }
+    return result;
+}
+
+template <typename F>
+PointCloud2d<F> to_aos(const PointCloud2dSoA<F>& pc)
+{
+    PointCloud2d<F> result;
+    result.vertices = to_aos(view(pc.vertices));
+    return result;
+}
+
+template <typename F>
+PointPath2d<F> to_aos(const PointPath2dSoA<F>& pp)
+{
+    PointPath2d<F> result;
+    result.closed = pp.closed;
+    result.vertices = to_aos(view(pp.vertices));
+    return result;
+}
+
+template <typename F, typename I>
+Triangles2d<F, I> to_aos(const Triangles2dSoA<F, I>& triangles)
+{
+    Triangles2d<F, I> result;
+    result.vertices = to_aos(view(triangles.vertices));
+    result.faces = triangles.faces;
+    result.adjacency = triangles.adjacency;
+    return result;
+}
+
+namespace details {
+
+template <typename F>
+Range<F> soa_range(const F* ptr, std::size_t n)
+{
+    // See the note on the vectorization of the min/max reductions in vect_batch.h
+    F min = std::numeric_limits<F>::infinity();
+    F max = -std::numeric_limits<F>::infinity();
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        min = ptr[idx] < min ? ptr[idx] : min;
+        max = ptr[idx] > max ? ptr[idx] : max;
+    }
+    Range<F> result;
+    if (n > 0)
+    {
+        result.add(min);
+        result.add(max);
+    }
+    return result;
+}
+
+} // namespace details
+
+template <typename F>
+BoundingBox2d<F> bounding_box(const Points2dSoAView<F>& points)
+{
+    BoundingBox2d<F> result;
+    result.rx = details::soa_range(points.x.data(), points.size());
+    result.ry = details::soa_range(points.y.data(), points.size());
+    return result;
+}
+
+template <typename F, typename I>
+void sq_distances(const Points2dSoAView<F>& points, stdutils::Span<const graphs::Edge<I>> edges, stdutils::Span<F> out)
+{
+    assert(out.size() == edges.size());
+    const std::size_t n = edges.size();
+    const F* x_ptr = points.x.data();
+    const F* y_ptr = points.y.data();
+    const graphs::Edge<I>* edge_ptr = edges.data();
+    F* out_ptr = out.data();
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        const auto i = edge_ptr[idx].orig();
+        const auto j = edge_ptr[idx].dest();
+        const F dx = x_ptr[j] - x_ptr[i];
+        const F dy = y_ptr[j] - y_ptr[i];
+        out_ptr[idx] = dx * dx + dy * dy;
+    }
+}
+
+} // namespace shapes
@@ -0,0 +1,311 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <graphs/graph.h>
+#include <shapes/point.h>
+#include <stdutils/span.h>
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace shapes {
+
+/**
+ * Robust geometric predicates
+ *
+ * The determinants are first evaluated in double precision, with the static error bounds of J.R. Shewchuk's "Adaptive Precision
+ * Floating-Point Arithmetic and Fast Robust Geometric Predicates". If the sign is uncertain, the determinant is recomputed exactly
+ * with floating-point expansions, which is slow but seldom needed, except for degenerate inputs (e.g. co-circular points on a grid).
+ * The coordinates are float or double; the float coordinates are converted to double, which is exact.
+ */
+
+// Positive if a, b, c are in counterclockwise order, negative if clockwise, zero if collinear
+template <typename F>
+double orient2d(const Point2d<F>& a, const Point2d<F>& b, const Point2d<F>& c);
+
+// Positive if d is inside the circle through a, b, c (in counterclockwise order), negative if outside, zero if co-circular
+template <typename F>
+double incircle(const Point2d<F>& a, const Point2d<F>& b, const Point2d<F>& c, const Point2d<F>& d);
+
+/**
+ * Batches of predicates
+ *
+ * The output is the sign of each predicate: 1, -1 or 0. The filtered determinants of the whole batch are computed first, in a loop
+ * without branches nor calls that the compiler vectorizes (see shapes/vect_batch.h); then the few predicates whose sign is uncertain
+ * are recomputed exactly. The output spans must have the same size as the triangles.
+ */
+
+// Orientation of each triangle
+template <typename F, typename I>
+void orient2d_signs(stdutils::Span<const Point2d<F>> points, stdutils::Span<const graphs::Triangle<I>> triangles, stdutils::Span<std::int8_t> out);
+
+// In-circle test of opposite[i] against triangles[i], which must be in counterclockwise order
+template <typename F, typename I>
+void incircle_signs(stdutils::Span<const Point2d<F>> points, stdutils::Span<const graphs::Triangle<I>> triangles, stdutils::Span<const I> opposite, stdutils::Span<std::int8_t> out);
+
+
+//
+//
+// Implementation
+//
+//
+
+
+namespace details {
+namespace predicates {
+
+namespace expansion {
+
+    // A floating-point expansion: The exact value is the sum of the components, which are non-overlapping and sorted by increasing magnitude
+    using Expansion = std::vector<double>;
+
+    inline void two_sum(double a, double b, double& x, double& y)
+    {
+        x = a + b;
+        const double b_virtual = x - a;
+        const double a_virtual = x - b_virtual;
+        y = (a - a_virtual) + (b - b_virtual);
+    }
+
+    inline Expansion diff(double a, double b)
+    {
+        double x, y;
+        two_sum(a, -b, x, y);
+        Expansion result;
+        if (y != 0.0) { result.push_back(y); }
+        if (x != 0.0) { result.push_back(x); }
+        return result;
+    }
+
+    // Shewchuk's Grow-Expansion applied to each component of f, with zero elimination
+    inline Expansion sum(const Expansion& e, const Expansion& f)
+    {
+        Expansion result = e;
+        Expansion tmp;
+        for (const double b : f)
+        {
+            tmp.clear();
+            double q = b;
+            for (const double c : result)
+            {
+                double h;
+                two_sum(q, c, q, h);
+                if (h != 0.0) { tmp.push_back(h); }
+            }
+            if (q != 0.0) { tmp.push_back(q); }
+            result.swap(tmp);
+        }
+        return result;
+    }
+
+    inline Expansion negate(Expansion e)
+    {
+        for (auto& c : e) { c = -c; }
+        return e;
+    }
+
+    // Shewchuk's Scale-Expansion, with zero elimination
+    inline Expansion scale(const Expansion& e, double b)
+    {
+        Expansion result;
+        double q = 0.0;
+        for (const double c : e)
+        {
+            const double p = c * b;
+            const double p_err = std::fma(c, b, -p);
+            double h;
+            two_sum(q, p_err, q, h);
+            if (h != 0.0) { result.push_back(h); }
+            two_sum(p, q, q, h);
+            if (h != 0.0) { result.push_back(h); }
+        }
+        if (q != 0.0) { result.push_back(q); }
+        return result;
+    }
+
+    inline Expansion product(const Expansion& e, const Expansion& f)
+    {
+        Expansion result;
+        for (const double b : f) { result = sum(result, scale(e, b)); }
+        return result;
+    }
+
+    // The sign of an expansion is the sign of its largest component, which is the last one
+    inline double estimate(const Expansion& e)
+    {
+        return e.empty() ? 0.0 : e.back();
+    }
+
+} // namespace expansion
+
+constexpr double epsilon = std::numeric_limits<double>::epsilon() / 2.0;
+constexpr double orient2d_err_bound = (3.0 + 16.0 * epsilon) * epsilon;
+constexpr double incircle_err_bound = (10.0 + 96.0 * epsilon) * epsilon;
+
+template <typename F>
+Point2d<double> to_double(const Point2d<F>& p)
+{
+    static_assert(std::is_same_v<F, float> || std::is_same_v<F, double>);
+    return Point2d<double>(static_cast<double>(p.x), static_cast<double>(p.y));
+}
+
+inline std::int8_t sign(double det, double bound)
+{
+    return static_cast<std::int8_t>(static_cast<int>(det > bound) - static_cast<int>(det < -bound));
+}
+
+// The floating-point determinant, and the bound of its rounding error
+inline double orient2d_filter(const Point2d<double>& a, const Point2d<double>& b, const Point2d<double>& c, double& err_bound)
+{
+    const double det_left = (a.x - c.x) * (b.y - c.y);
+    const double det_right = (a.y - c.y) * (b.x - c.x);
+    err_bound = orient2d_err_bound * (std::abs(det_left) + std::abs(det_right));
+    return det_left - det_right;
+}
+
+inline double incircle_filter(const Point2d<double>& a, const Point2d<double>& b, const Point2d<double>& c, const Point2d<double>& d, double& err_bound)
+{
+    const double adx = a.x - d.x;
+    const double ady = a.y - d.y;
+    const double bdx = b.x - d.x;
+    const double bdy = b.y - d.y;
+    const double cdx = c.x - d.x;
+    const double cdy = c.y - d.y;
+    const double bdxcdy = bdx * cdy;
+    const double cdxbdy = cdx * bdy;
+    const double cdxady = cdx * ady;
+    const double adxcdy = adx * cdy;
+    const double adxbdy = adx * bdy;
+    const double bdxady = bdx * ady;
+    const double alift = adx * adx + ady * ady;
+    const double blift = bdx * bdx + bdy * bdy;
+    const double clift = cdx * cdx + cdy * cdy;
+    const double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift
+                           + (std::abs(cdxady) + std::abs(adxcdy)) * blift
+                           + (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+    err_bound = incircle_err_bound * permanent;
+    return alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+}
+
+inline double orient2d_exact(const Point2d<double>& a, const Point2d<double>& b, const Point2d<double>& c)
+{
+    using namespace expansion;
+    const auto acx = diff(a.x, c.x);
+    const auto bcy = diff(b.y, c.y);
+    const auto acy = diff(a.y, c.y);
+    const auto bcx = diff(b.x, c.x);
+    return estimate(sum(product(acx, bcy), negate(product(acy, bcx))));
+}
+
+inline double incircle_exact(const Point2d<double>& a, const Point2d<double>& b, const Point2d<double>& c, const Point2d<double>& d)
+{
+    using namespace expansion;
+    const auto adx_e = diff(a.x, d.x);
+    const auto ady_e = diff(a.y, d.y);
+    const auto bdx_e = diff(b.x, d.x);
+    const auto bdy_e = diff(b.y, d.y);
+    const auto cdx_e = diff(c.x, d.x);
+    const auto cdy_e = diff(c.y, d.y);
+    const auto lift = [](const Expansion& dx, const Expansion& dy) { return sum(product(dx, dx), product(dy, dy)); };
+    const auto cross = [](const Expansion& ux, const Expansion& uy, const Expansion& vx, const Expansion& vy) { return sum(product(ux, vy), negate(product(vx, uy))); };
+    const auto a_term = product(lift(adx_e, ady_e), cross(bdx_e, bdy_e, cdx_e, cdy_e));
+    const auto b_term = product(lift(bdx_e, bdy_e), cross(cdx_e, cdy_e, adx_e, ady_e));
+    const auto c_term = product(lift(cdx_e, cdy_e), cross(adx_e, ady_e, bdx_e, bdy_e));
+    return estimate(sum(sum(a_term, b_term), c_term));
+}
+
+} // namespace predicates
+} // namespace details
+
+template <typename F>
+double orient2d(const Point2d<F>& a, const Point2d<F>& b, const Point2d<F>& c)
+{
+    using namespace details::predicates;
+    const auto pa = to_double(a);
+    const auto pb = to_double(b);
+    const auto pc = to_double(c);
+    double err_bound;
+    const double det = orient2d_filter(pa, pb, pc, err_bound);
+    if (std::abs(det) > err_bound)
+        return det;
+    return orient2d_exact(pa, pb, pc);
+}
+
+template <typename F>
+double incircle(const Point2d<F>& a, const Point2d<F>& b, const Point2d<F>& c, const Point2d<F>& d)
+{
+    using namespace details::predicates;
+    const auto pa = to_double(a);
+    const auto pb = to_double(b);
+    const auto pc = to_double(c);
+    const auto pd = to_double(d);
+    double err_bound;
+    const double det = incircle_filter(pa, pb, pc, pd, err_bound);
+    if (std::abs(det) > err_bound)
+        return det;
+    return incircle_exact(pa, pb, pc, pd);
+}
+
+template <typename F, typename I>
+void orient2d_signs(stdutils::Span<const Point2d<F>> points, stdutils::Span<const graphs::Triangle<I>> triangles, stdutils::Span<std::int8_t> out)
+{
+    using namespace details::predicates;
+    assert(out.size() == triangles.size());
+    const std::size_t n = triangles.size();
+    const Point2d<F>* pts = points.data();
+    const graphs::Triangle<I>* tri = triangles.data();
+    std::int8_t* out_ptr = out.data();
+
+    // Filtered pass: Zero if the sign is uncertain
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        double err_bound;
+        const double det = orient2d_filter(to_double(pts[tri[idx][0]]), to_double(pts[tri[idx][1]]), to_double(pts[tri[idx][2]]), err_bound);
+        out_ptr[idx] = sign(det, err_bound);
+    }
+
+    // Exact pass
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        if (out_ptr[idx] != 0)
+            continue;
+        out_ptr[idx] = sign(orient2d_exact(to_double(pts[tri[idx][0]]), to_double(pts[tri[idx][1]]), to_double(pts[tri[idx][2]])), 0.0);
+    }
+}
+
+template <typename F, typename I>
+void incircle_signs(stdutils::Span<const Point2d<F>> points, stdutils::Span<const graphs::Triangle<I>> triangles, stdutils::Span<const I> opposite, stdutils::Span<std::int8_t> out)
+{
+    using namespace details::predicates;
+    assert(opposite.size() == triangles.size());
+    assert(out.size() == triangles.size());
+    const std::size_t n = triangles.size();
+    const Point2d<F>* pts = points.data();
+    const graphs::Triangle<I>* tri = triangles.data();
+    const I* opp = opposite.data();
+    std::int8_t* out_ptr = out.data();
+
+    // Filtered pass: Zero if the sign is uncertain
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        double err_bound;
+        const double det = incircle_filter(to_double(pts[tri[idx][0]]), to_double(pts[tri[idx][1]]), to_double(pts[tri[idx][2]]), to_double(pts[opp[idx]]), err_bound);
+        out_ptr[idx] = sign(det, err_bound);
+    }
+
+    // Exact pass
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        if (out_ptr[idx] != 0)
+            continue;
+        out_ptr[idx] = sign(incircle_exact(to_double(pts[tri[idx][0]]), to_double(pts[tri[idx][1]]), to_double(pts[tri[idx][2]]), to_double(pts[opp[idx]])), 0.0);
+    }
+}
+
+} // namespace shapes
@@ -6,28 +6,103 @@
 #include <graphs/proximity.h>
 #include <shapes/edge.h>
 #include <shapes/triangle.h>
+#include <shapes/vect_batch.h>
+#include <stdutils/arena.h>
+#include <stdutils/parallel.h>
+#include <stdutils/profiler.h>
+#include <stdutils/span.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <functional>
+#include <iterator>
 #include <vector>
 
 namespace shapes {
 
 /**
  * See graphs/proximity.h for more information regarding the proximity graphs
+ *
+ * The input triangulation must be a Delaunay triangulation of the point set: The RNG and GG only test the neighborhood of each edge
+ * in the triangulation.
  */
 
 template <typename P, typename I = std::uint32_t>
 Edges<P, I> nearest_neighbor(const Triangles<P, I>& triangles);
+template <typename P, typename I = std::uint32_t>
+Edges<P, I> nearest_neighbor(const stdutils::parallel::Policy& policy, const Triangles<P, I>& triangles);
 
 template <typename P, typename I = std::uint32_t>
 Edges<P, I> minimum_spanning_tree(const Triangles<P, I>& triangles);
+template <typename P, typename I = std::uint32_t>
+Edges<P, I> minimum_spanning_tree(const stdutils::parallel::Policy& policy, const Triangles<P, I>& triangles);
 
 template <typename P, typename I = std::uint32_t>
 Edges<P, I> relative_neighborhood_graph(const Triangles<P, I>& triangles);
+template <typename P, typename I = std::uint32_t>
+Edges<P, I> relative_neighborhood_graph(const stdutils::parallel::Policy& policy, const Triangles<P, I>& triangles);
 
 template <typename P, typename I = std::uint32_t>
 Edges<P, I> gabriel_graph(const Triangles<P, I>& triangles);
+template <typename P, typename I = std::uint32_t>
+Edges<P, I> gabriel_graph(const stdutils::parallel::Policy& policy, const Triangles<P, I>& triangles);
+
+/**
+ * Compute several proximity graphs at once
+ *
+ * The weighted edges are extracted from the triangulation only once, then each selected graph is derived from a copy of them.
+ * With a parallel policy, the graphs are computed concurrently. The graphs that are not selected are left empty.
+ *
+ * By default each graph holds a copy of the vertices of the triangulation. With share_vertices, the graphs have no vertices of their own:
+ * Their indices refer to the single copy in ProximityGraphs::vertices, which the caller may share between them, e.g. to upload it once
+ * to the GPU.
+ */
+struct ProximityGraphsSelection
+{
+    bool nn = true;
+    bool mst = true;
+    bool rng = true;
+    bool gg = true;
+    bool dt = true;
+    bool share_vertices = false;
+};
+
+template <typename P, typename I = std::uint32_t>
+struct ProximityGraphs
+{
+    std::vector<P> vertices;                    // Only with ProximityGraphsSelection::share_vertices
+    Edges<P, I> nn;
+    Edges<P, I> mst;
+    Edges<P, I> rng;
+    Edges<P, I> gg;
+    Edges<P, I> dt;
+};
+
+// Compute the selected graphs from the same weighted edges. The transient buffers are allocated in the arena, if there is one.
+template <typename P, typename I = std::uint32_t>
+ProximityGraphs<P, I> proximity_graphs(const Triangles<P, I>& triangles, const ProximityGraphsSelection& selection = ProximityGraphsSelection(), stdutils::Arena* arena = nullptr);
+template <typename P, typename I = std::uint32_t>
+ProximityGraphs<P, I> proximity_graphs(const stdutils::parallel::Policy& policy, const Triangles<P, I>& triangles, const ProximityGraphsSelection& selection = ProximityGraphsSelection(), stdutils::Arena* arena = nullptr);
+
+/**
+ * Compute all the proximity graphs at once, as nested prefixes of one array of edges
+ *
+ * Since NN ⊆ MST ⊆ RNG ⊆ GG ⊆ DT, each graph is computed from the edges of the next one (see graphs::proximity_hierarchy).
+ * The NN is made of the first nb_nn_edges of edges.indices, the MST of the first nb_mst_edges, and so on. The DT is the whole array.
+ */
+template <typename P, typename I = std::uint32_t>
+struct ProximityHierarchy
+{
+    Edges<P, I> edges;
+    std::size_t nb_nn_edges = 0;
+    std::size_t nb_mst_edges = 0;
+    std::size_t nb_rng_edges = 0;
+    std::size_t nb_gg_edges = 0;
+};
+
+template <typename P, typename I = std::uint32_t>
+ProximityHierarchy<P, I> proximity_hierarchy(const Triangles<P, I>& triangles);
 
 
 //
@@ -44,44 +119,104 @@ struct WeightEdge
 {
     using index = I;
 
-    WeightEdge() : m_edge{0, 0}, m_length{0} {}
+    WeightEdge() : m_edge{0, 0}, m_sq_length{0} {}
 
     const graphs::Edge<I> edge() const { return m_edge; }
-    F weight() const { return m_length; }
+    F weight() const { return m_sq_length; }
 
     graphs::Edge<I> m_edge;
-    F m_length;
+    F m_sq_length;      // See WeightMode below
 };
 
 template <typename F, typename I>
-using WeightEdges = std::vector<WeightEdge<F, I>>;
+using WeightEdges = stdutils::ArenaVector<WeightEdge<F, I>>;
 
-template <typename P, typename I, typename Func>
-Edges<P, I> generic_proximity_graph(const Triangles<P, I>& triangles, Func func)
+// The weights are the squared lengths of the edges, which avoids a square root per edge and per candidate vertex of the RNG and GG tests
+constexpr graphs::EdgeWeight WeightMode = graphs::EdgeWeight::SquaredLength;
+
+template <typename I, typename P>
+auto squared_distance(const std::vector<P>& vertices)
 {
-    using F = typename P::scalar;
+    return [&vertices](const I p, const I q) { return shapes::sq_norm(vertices[q] - vertices[p]); };
+}
 
-    // Extract the edges from the triangulation
-    WeightEdges<F, I> proxi_edges = [&triangles]() {
-        WeightEdges<F, I> result;
-        auto edge_soup = graphs::to_edge_soup<I>(triangles.faces);
-        result.reserve(edge_soup.size());
-        std::for_each(std::cbegin(edge_soup), std::cend(edge_soup), [&triangles, &result](const auto& e) {
-            auto& w_edge = result.emplace_back();
-            w_edge.m_edge = e;
-            w_edge.m_length = shapes::norm(triangles.vertices[e.dest()] - triangles.vertices[e.orig()]);
-        });
+// Extract the edges from the triangulation. The result, and the temporary buffers, are allocated in the arena if there is one.
+template <typename P, typename I>
+WeightEdges<typename P::scalar, I> weight_edges(const Triangles<P, I>& triangles, stdutils::Arena* arena = nullptr)
+{
+    STDUTILS_PROFILE_ZONE("proximity::weight_edges");
+    using F = typename P::scalar;
+    WeightEdges<F, I> result{ stdutils::ArenaAllocator<WeightEdge<F, I>>(arena) };
+    const auto edge_soup = has_adjacency(triangles) ? graphs::to_edge_soup<I>(triangles.faces, triangles.adjacency) : graphs::to_edge_soup<I>(triangles.faces);
+    if (edge_soup.empty())
         return result;
-    }();
+    stdutils::ArenaVector<F> sq_lengths(edge_soup.size(), F{0}, stdutils::ArenaAllocator<F>(arena));
+    if constexpr (P::dim == 2)
+    {
+        sq_distances(stdutils::make_const_span(triangles.vertices), stdutils::make_const_span(edge_soup), stdutils::make_span(sq_lengths));
+    }
+    else
+    {
+        for (std::size_t idx = 0; idx < edge_soup.size(); idx++) { sq_lengths[idx] = shapes::sq_norm(triangles.vertices[edge_soup[idx].dest()] - triangles.vertices[edge_soup[idx].orig()]); }
+    }
+    result.resize(edge_soup.size());
+    for (std::size_t idx = 0; idx < edge_soup.size(); idx++)
+    {
+        result[idx].m_edge = edge_soup[idx];
+        result[idx].m_sq_length = sq_lengths[idx];
+    }
+    return result;
+}
 
-    // Compute the proximity graph
+// Compute the proximity graph and return the edge soup, with a copy of the vertices of the triangulation unless they are shared
+template <typename P, typename I, typename Func>
+Edges<P, I> proximity_graph(const Triangles<P, I>& triangles, WeightEdges<typename P::scalar, I>& proxi_edges, Func func, bool copy_vertices = true)
+{
     const auto graph_end = func(proxi_edges.begin(), proxi_edges.end());
-
-    // Return edge soup
     Edges<P, I> result;
     result.indices.reserve(static_cast<std::size_t>(std::distance(proxi_edges.begin(), graph_end)));
     std::transform(proxi_edges.begin(), graph_end, std::back_inserter(result.indices), [](const auto& proxi_edge) { return proxi_edge.edge(); });
-    result.vertices = triangles.vertices;
+    if (copy_vertices) { result.vertices = triangles.vertices; }
+    return result;
+}
+
+template <typename P, typename I, typename Func>
+Edges<P, I> generic_proximity_graph(const Triangles<P, I>& triangles, Func func)
+{
+    auto proxi_edges = weight_edges(triangles);
+    return proximity_graph(triangles, proxi_edges, func);
+}
+
+template <typename P, typename I>
+ProximityGraphs<P, I> proximity_graphs(const stdutils::parallel::Policy& policy, const Triangles<P, I>& triangles, const ProximityGraphsSelection& selection, stdutils::Arena* arena)
+{
+    STDUTILS_PROFILE_ZONE("proximity::proximity_graphs");
+    using F = typename P::scalar;
+    using WeightEdgeIt = typename WeightEdges<F, I>::iterator;
+    const WeightEdges<F, I> proxi_edges = weight_edges(triangles, arena);
+    const auto& vertices = triangles.vertices;
+    const auto weight = squared_distance<I>(vertices);
+
+    // One task per selected graph, each working on its own copy of the weighted edges, in the same arena
+    ProximityGraphs<P, I> result;
+    const bool copy_vertices = !selection.share_vertices;
+    if (selection.share_vertices) { result.vertices = vertices; }
+    std::vector<std::function<void()>> tasks;
+    const auto add_task = [&tasks, &triangles, &proxi_edges, copy_vertices](bool selected, const char* zone_name, Edges<P, I>& graph, auto func) {
+        if (!selected)
+            return;
+        tasks.emplace_back([&triangles, &proxi_edges, zone_name, &graph, func, copy_vertices]() {
+            STDUTILS_PROFILE_ZONE(zone_name);
+            auto edges = proxi_edges;
+            graph = proximity_graph(triangles, edges, func, copy_vertices);
+        });
+    };
+    add_task(selection.nn, "proximity::nearest_neighbor", result.nn, [](WeightEdgeIt begin, WeightEdgeIt end) { return graphs::nearest_neighbor(begin, end); });
+    add_task(selection.mst, "proximity::minimum_spanning_tree", result.mst, [](WeightEdgeIt begin, WeightEdgeIt end) { return graphs::minimum_spanning_tree(begin, end); });
+    add_task(selection.rng, "proximity::relative_neighborhood_graph", result.rng, [&policy, &triangles, &weight](WeightEdgeIt begin, WeightEdgeIt end) { return graphs::relative_neighborhood_graph(policy, begin, end, triangles.faces, weight); });
+    add_task(selection.gg, "proximity::gabriel_graph", result.gg, [&policy, &triangles, &weight](WeightEdgeIt begin, WeightEdgeIt end) { return graphs::gabriel_graph(policy, begin, end, triangles.faces, weight, WeightMode); });
+    add_task(selection.dt, "proximity::delaunay_triangulation", result.dt, [](WeightEdgeIt, WeightEdgeIt end) { return end; });
+    stdutils::parallel::for_each_ordered(policy, tasks.size(), [&tasks](std::size_t idx) { tasks[idx](); }, [](std::size_t) {});
     return result;
 }
 
@@ -90,25 +225,73 @@ Edges<P, I> generic_proximity_graph(const Triangles<P, I>& triangles, Func func)
 template <typename P, typename I>
 Edges<P, I> nearest_neighbor(const Triangles<P, I>& triangles)
 {
+    STDUTILS_PROFILE_ZONE("proximity::nearest_neighbor");
     using F = typename P::scalar;
-    return details::generic_proximity_graph<P, I>(triangles, &graphs::nearest_neighbor<typename details::WeightEdges<F, I>::iterator>);
+    using WeightEdgeIt = typename details::WeightEdges<F, I>::iterator;
+    const auto nn_gen = [](WeightEdgeIt begin, WeightEdgeIt end) {
+        return graphs::nearest_neighbor(begin, end);
+    };
+    return details::generic_proximity_graph<P, I>(triangles, nn_gen);
+}
+
+template <typename P, typename I>
+Edges<P, I> nearest_neighbor(const stdutils::parallel::Policy& policy, const Triangles<P, I>& triangles)
+{
+    STDUTILS_PROFILE_ZONE("proximity::nearest_neighbor");
+    using F = typename P::scalar;
+    using WeightEdgeIt = typename details::WeightEdges<F, I>::iterator;
+    const auto nn_gen = [&policy](WeightEdgeIt begin, WeightEdgeIt end) {
+        return graphs::nearest_neighbor(policy, begin, end);
+    };
+    return details::generic_proximity_graph<P, I>(triangles, nn_gen);
 }
 
 template <typename P, typename I>
 Edges<P, I> minimum_spanning_tree(const Triangles<P, I>& triangles)
 {
+    STDUTILS_PROFILE_ZONE("proximity::minimum_spanning_tree");
+    using F = typename P::scalar;
+    using WeightEdgeIt = typename details::WeightEdges<F, I>::iterator;
+    const auto mst_gen = [](WeightEdgeIt begin, WeightEdgeIt end) {
+        return graphs::minimum_spanning_tree(begin, end);
+    };
+    return details::generic_proximity_graph<P, I>(triangles, mst_gen);
+}
+
+template <typename P, typename I>
+Edges<P, I> minimum_spanning_tree(const stdutils::parallel::Policy& policy, const Triangles<P, I>& triangles)
+{
+    STDUTILS_PROFILE_ZONE("proximity::minimum_spanning_tree");
     using F = typename P::scalar;
-    return details::generic_proximity_graph<P, I>(triangles, &graphs::minimum_spanning_tree<typename details::WeightEdges<F, I>::iterator>);
+    using WeightEdgeIt = typename details::WeightEdges<F, I>::iterator;
+    const auto mst_gen = [&policy](WeightEdgeIt begin, WeightEdgeIt end) {
+        return graphs::minimum_spanning_tree(policy, begin, end);
+    };
+    return details::generic_proximity_graph<P, I>(triangles, mst_gen);
 }
 
 template <typename P, typename I>
 Edges<P, I> relative_neighborhood_graph(const Triangles<P, I>& triangles)
 {
+    STDUTILS_PROFILE_ZONE("proximity::relative_neighborhood_graph");
+    using F = typename P::scalar;
+    using WeightEdgeIt = typename details::WeightEdges<F, I>::iterator;
+    const auto& vertices = triangles.vertices;
+    const auto rng_gen = [&triangles, &vertices](WeightEdgeIt begin, WeightEdgeIt end) {
+        return graphs::relative_neighborhood_graph(begin, end, triangles.faces, details::squared_distance<I>(vertices));
+    };
+    return details::generic_proximity_graph<P, I>(triangles, rng_gen);
+}
+
+template <typename P, typename I>
+Edges<P, I> relative_neighborhood_graph(const stdutils::parallel::Policy& policy, const Triangles<P, I>& triangles)
+{
+    STDUTILS_PROFILE_ZONE("proximity::relative_neighborhood_graph");
     using F = typename P::scalar;
     using WeightEdgeIt = typename details::WeightEdges<F, I>::iterator;
     const auto& vertices = triangles.vertices;
-    const auto rng_gen = [&vertices](WeightEdgeIt begin, WeightEdgeIt end) {
-        return graphs::relative_neighborhood_graph(begin, end, [&vertices](const I p, const I q) { return shapes::norm(vertices[q] - vertices[p]); });
+    const auto rng_gen = [&policy, &triangles, &vertices](WeightEdgeIt begin, WeightEdgeIt end) {
+        return graphs::relative_neighborhood_graph(policy, begin, end, triangles.faces, details::squared_distance<I>(vertices));
     };
     return details::generic_proximity_graph<P, I>(triangles, rng_gen);
 }
@@ -116,13 +299,59 @@ Edges<P, I> relative_neighborhood_graph(const Triangles<P, I>& triangles)
 template <typename P, typename I>
 Edges<P, I> gabriel_graph(const Triangles<P, I>& triangles)
 {
+    STDUTILS_PROFILE_ZONE("proximity::gabriel_graph");
     using F = typename P::scalar;
     using WeightEdgeIt = typename details::WeightEdges<F, I>::iterator;
     const auto& vertices = triangles.vertices;
-    const auto gg_gen = [&vertices](WeightEdgeIt begin, WeightEdgeIt end) {
-        return graphs::gabriel_graph(begin, end, [&vertices](const I p, const I q) { return shapes::norm(vertices[q] - vertices[p]); });
+    const auto gg_gen = [&triangles, &vertices](WeightEdgeIt begin, WeightEdgeIt end) {
+        return graphs::gabriel_graph(begin, end, triangles.faces, details::squared_distance<I>(vertices), details::WeightMode);
     };
     return details::generic_proximity_graph<P, I>(triangles, gg_gen);
 }
 
+template <typename P, typename I>
+Edges<P, I> gabriel_graph(const stdutils::parallel::Policy& policy, const Triangles<P, I>& triangles)
+{
+    STDUTILS_PROFILE_ZONE("proximity::gabriel_graph");
+    using F = typename P::scalar;
+    using WeightEdgeIt = typename details::WeightEdges<F, I>::iterator;
+    const auto& vertices = triangles.vertices;
+    const auto gg_gen = [&policy, &triangles, &vertices](WeightEdgeIt begin, WeightEdgeIt end) {
+        return graphs::gabriel_graph(policy, begin, end, triangles.faces, details::squared_distance<I>(vertices), details::WeightMode);
+    };
+    return details::generic_proximity_graph<P, I>(triangles, gg_gen);
+}
+
+template <typename P, typename I>
+ProximityGraphs<P, I> proximity_graphs(const Triangles<P, I>& triangles, const ProximityGraphsSelection& selection, stdutils::Arena* arena)
+{
+    return details::proximity_graphs<P, I>(stdutils::parallel::Policy{ 1 }, triangles, selection, arena);
+}
+
+template <typename P, typename I>
+ProximityGraphs<P, I> proximity_graphs(const stdutils::parallel::Policy& policy, const Triangles<P, I>& triangles, const ProximityGraphsSelection& selection, stdutils::Arena* arena)
+{
+    return details::proximity_graphs<P, I>(policy, triangles, selection, arena);
+}
+
+template <typename P, typename I>
+ProximityHierarchy<P, I> proximity_hierarchy(const Triangles<P, I>& triangles)
+{
+    STDUTILS_PROFILE_ZONE("proximity::proximity_hierarchy");
+    auto proxi_edges = details::weight_edges(triangles);
+    const auto& vertices = triangles.vertices;
+    const auto begin = proxi_edges.begin();
+    const auto hierarchy = graphs::proximity_hierarchy(begin, proxi_edges.end(), triangles.faces, details::squared_distance<I>(vertices), details::WeightMode);
+
+    ProximityHierarchy<P, I> result;
+    result.edges.indices.reserve(proxi_edges.size());
+    std::transform(proxi_edges.cbegin(), proxi_edges.cend(), std::back_inserter(result.edges.indices), [](const auto& proxi_edge) { return proxi_edge.edge(); });
+    result.edges.vertices = vertices;
+    result.nb_nn_edges = static_cast<std::size_t>(std::distance(begin, hierarchy.nn_end));
+    result.nb_mst_edges = static_cast<std::size_t>(std::distance(begin, hierarchy.mst_end));
+    result.nb_rng_edges = static_cast<std::size_t>(std::distance(begin, hierarchy.rng_end));
+    result.nb_gg_edges = static_cast<std::size_t>(std::distance(begin, hierarchy.gg_end));
+    return result;
+}
+
 } // namespace shapes
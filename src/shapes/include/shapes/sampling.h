@@ -3,17 +3,23 @@
 #pragma once
 
 #include <shapes/bezier.h>
+#include <shapes/io.h>
 #include <shapes/path_algos.h>
 #include <shapes/sampling_interface.h>
 #include <shapes/shapes.h>
 #include <stdutils/algorithm.h>
+#include <stdutils/parallel.h>
+#include <stdutils/profiler.h>
 #include <stdutils/stats.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
+#include <cstddef>
 #include <execution>
 #include <iterator>
-#include <stack>
+#include <vector>
 
 namespace shapes {
 
@@ -25,17 +31,26 @@ AllShapes<F> trivial_sampling(const AllShapes<F>& shape);
 
 /**
  * Uniform sampling of point paths
+ *
+ * The segments of the path are independent: The initialization and the sampling process them in parallel according to the policy,
+ * whose min_chunk_size is a number of segments. The sampling counts the samples of each segment first, then writes them directly to
+ * their range of the output. The result does not depend on the policy.
  */
 template <typename F, template<typename> typename P>
 class UniformSamplingPointPath : public UniformSamplingInterface<F, P>
 {
 public:
     UniformSamplingPointPath(const PointPath<P<F>>& pp);
+    UniformSamplingPointPath(const stdutils::parallel::Policy& policy, const PointPath<P<F>>& pp);
     ~UniformSamplingPointPath() = default;
     F max_segment_length() const override;
     PointPath<P<F>> sample(F max_sampling_length) const override;
 
 private:
+    std::size_t nb_sampling_edges(std::size_t seg, F max_sampling_length) const;
+    void sample_segment(std::size_t seg, F max_sampling_length, P<F>* out) const;
+
+    stdutils::parallel::Policy m_policy;
     PointPath<P<F>> m_point_path;
     std::vector<F> m_segment_length;
     F m_max_segment_length;
@@ -46,6 +61,12 @@ using UniformSamplingPointPath2d = UniformSamplingPointPath<F, Point2d>;
 
 /**
  * Uniform sampling of cubic bezier paths
+ *
+ * The segments of the CBP are independent: The initialization and the sampling process them in parallel according to the policy,
+ * whose min_chunk_size is a number of segments. The initialization with a trace_info is sequential. The result does not depend on the policy.
+ *
+ * After the edition of some segments of the CBP, update_segments() initializes those segments again and resample_segments() splices their new
+ * samples in a former sampling of the path: The result is the same as a new sampler on the edited CBP, at the cost of the edited segments only.
  */
 template <typename F, template<typename> typename P>
 class UniformSamplingCubicBezier : public UniformSamplingInterface<F, P>
@@ -69,10 +90,18 @@ public:
     };
 
     UniformSamplingCubicBezier(const CubicBezierPath<Point2d<F>>& cbp, InitTraceInfo* trace_info = nullptr);
+    UniformSamplingCubicBezier(const stdutils::parallel::Policy& policy, const CubicBezierPath<Point2d<F>>& cbp, InitTraceInfo* trace_info = nullptr);
     ~UniformSamplingCubicBezier() = default;
     F max_segment_length() const override;
     PointPath<Point2d<F>> sample(F max_sampling_length) const override;
 
+    // The control points of the segments [begin_seg, end_seg) of cbp were edited: The CBP has the same number of segments and the same control
+    // points outside of those segments. An endpoint shared by two segments belongs to both of them.
+    void update_segments(const CubicBezierPath<Point2d<F>>& cbp, std::size_t begin_seg, std::size_t end_seg);
+
+    // pp is the sampling with max_sampling_length before update_segments(begin_seg, end_seg)
+    void resample_segments(F max_sampling_length, std::size_t begin_seg, std::size_t end_seg, PointPath<Point2d<F>>& pp) const;
+
 private:
     static constexpr unsigned int SAMPLING_BASE_N = 100;
     static constexpr unsigned int SAMPLING_ITERATIONS = 6;
@@ -80,9 +109,15 @@ private:
     static constexpr float QUADRATIC_ARC_MODEL_RELATIVE_LENGTH_ERROR = 0.04f;
 
     void initialization_prepare_data_structures();
+    void initialization_uniform_sample_t(std::size_t seg);
     void initialization_one_iteration(InitIterationTraceInfo* iter_trace_info);
+    void initialization_one_iteration(std::size_t begin_seg, std::size_t end_seg, InitIterationTraceInfo* iter_trace_info);
     void initialization_finalize(InitTraceInfo* trace_info);
+    void initialization_finalize(std::size_t begin_seg, std::size_t end_seg, InitTraceInfo* trace_info);
+    unsigned int nb_sampling_edges(std::size_t seg, F max_sampling_length) const;
+    void sample_segment(std::size_t seg, F max_sampling_length, Point2d<F>* out) const;
 
+    stdutils::parallel::Policy m_policy;
     bool m_closed_path;
     std::vector<F> m_control_points;
     std::vector<F> m_derivate_control_points;
@@ -102,8 +137,20 @@ using UniformSamplingCubicBezier2d = UniformSamplingCubicBezier<F, Point2d>;
 template <typename F, template<typename> typename P>
 stdutils::stats::Result<F> path_normalized_uniformity_stats(const shapes::PointPath<P<F>>& pp);
 
+// Same, with the edge lengths accumulated concurrently in chunks, whose partial statistics are then merged
+template <typename F, template<typename> typename P>
+stdutils::stats::Result<F> path_normalized_uniformity_stats(const stdutils::parallel::Policy& policy, const shapes::PointPath<P<F>>& pp);
+
+// The statistics of all the point paths of an aggregate, e.g. for the QA of the sampling of a vector file. One result per shape of the
+// aggregate, and an empty result (n == 0) for the shapes that are not point paths. The paths are processed concurrently.
+template <typename F>
+std::vector<stdutils::stats::Result<F>> paths_normalized_uniformity_stats(const stdutils::parallel::Policy& policy, const io::ShapeAggregate<F>& shapes);
+
 /**
  * Casteljau sampling of a CBP
+ *
+ * The segments are split in halves until their control points are within resolution_length of their chord, therefore resolution_length
+ * is a flatness tolerance rather than a distance between the samples: The flat regions get few vertices, the curved ones get many.
  */
 template <typename F, template<typename> typename P>
 class CasteljauSamplingCubicBezier
@@ -115,6 +162,15 @@ class CasteljauSamplingCubicBezier<F, Point2d>
 public:
     CasteljauSamplingCubicBezier();
     PointPath<Point2d<F>> sample(const CubicBezierPath<Point2d<F>>& cbp, F resolution_length) const;
+    // Same result, the segments are processed in parallel. The min_chunk_size of the policy is a number of segments.
+    PointPath<Point2d<F>> sample(const stdutils::parallel::Policy& policy, const CubicBezierPath<Point2d<F>>& cbp, F resolution_length) const;
+
+    // Same result. The samples of segment seg are the vertices [segment_offsets[seg], segment_offsets[seg + 1]) of the output.
+    PointPath<Point2d<F>> sample(const CubicBezierPath<Point2d<F>>& cbp, F resolution_length, std::vector<std::size_t>& segment_offsets) const;
+
+    // The segments [begin_seg, end_seg) of cbp were edited (see UniformSamplingCubicBezier::update_segments()). pp and segment_offsets are
+    // the sampling with resolution_length before the edition: The new samples of those segments are spliced in pp, and the offsets updated.
+    void resample_segments(const CubicBezierPath<Point2d<F>>& cbp, F resolution_length, std::size_t begin_seg, std::size_t end_seg, PointPath<Point2d<F>>& pp, std::vector<std::size_t>& segment_offsets) const;
 };
 
 template <typename F>
@@ -130,21 +186,32 @@ using CasteljauSamplingCubicBezier2d = CasteljauSamplingCubicBezier<F, Point2d>;
 
 template <typename F, template<typename> typename P>
 UniformSamplingPointPath<F, P>::UniformSamplingPointPath(const PointPath<P<F>>& pp)
-    : m_point_path(pp)
+    : UniformSamplingPointPath(stdutils::parallel::Policy{1u}, pp)
+{ }
+
+template <typename F, template<typename> typename P>
+UniformSamplingPointPath<F, P>::UniformSamplingPointPath(const stdutils::parallel::Policy& policy, const PointPath<P<F>>& pp)
+    : m_policy(policy)
+    , m_point_path(pp)
     , m_segment_length()
     , m_max_segment_length(F{0})
 {
-    m_segment_length.reserve(nb_edges(pp));
-    const auto sz = pp.vertices.size();
-    for (std::size_t idx = 0; idx < sz; idx++)
-    {
-        if (!pp.closed && idx == sz - 1)
-            break;
-        const P<F>& p0 = pp.vertices[idx];
-        const P<F>& p1 = pp.vertices[(idx + 1) % sz];
-        const auto& length = m_segment_length.emplace_back(shapes::norm(p1 - p0));
-        stdutils::max_update(m_max_segment_length, length);
-    }
+    const std::size_t nb_segs = nb_edges(pp);
+    const std::size_t sz = pp.vertices.size();
+    m_segment_length.resize(nb_segs);
+    std::vector<F> chunk_max_length(stdutils::parallel::nb_chunks(m_policy, nb_segs), F{0});
+    stdutils::parallel::for_each_chunk(m_policy, nb_segs, [this, &pp, &chunk_max_length, sz](std::size_t chunk_idx, std::size_t begin_seg, std::size_t end_seg) {
+        F max_length{0};
+        for (std::size_t seg = begin_seg; seg < end_seg; seg++)
+        {
+            const P<F>& p0 = pp.vertices[seg];
+            const P<F>& p1 = pp.vertices[(seg + 1) % sz];
+            m_segment_length[seg] = shapes::norm(p1 - p0);
+            stdutils::max_update(max_length, m_segment_length[seg]);
+        }
+        chunk_max_length[chunk_idx] = max_length;
+    });
+    for (const F& length : chunk_max_length) { stdutils::max_update(m_max_segment_length, length); }
 }
 
 template <typename F, template<typename> typename P>
@@ -153,35 +220,55 @@ F UniformSamplingPointPath<F, P>::max_segment_length() const
     return m_max_segment_length;
 }
 
+// Excluding the sample t = 1
+template <typename F, template<typename> typename P>
+std::size_t UniformSamplingPointPath<F, P>::nb_sampling_edges(std::size_t seg, F max_sampling_length) const
+{
+    return static_cast<std::size_t>(std::ceil(m_segment_length[seg] / max_sampling_length));
+}
+
+template <typename F, template<typename> typename P>
+void UniformSamplingPointPath<F, P>::sample_segment(std::size_t seg, F max_sampling_length, P<F>* out) const
+{
+    const auto sz = m_point_path.vertices.size();
+    const P<F>& p0 = m_point_path.vertices[seg];
+    const P<F>& p1 = m_point_path.vertices[(seg + 1) % sz];
+    const std::size_t nb_seg_edges = nb_sampling_edges(seg, max_sampling_length);
+    const F dt = F{1} / static_cast<F>(nb_seg_edges);
+    F t{0};
+    for (std::size_t s = 0; s < nb_seg_edges; s++, t += dt)
+    {
+        out[s] = (F{1} - t) * p0 + t * p1;
+    }
+}
+
 template <typename F, template<typename> typename P>
 PointPath<P<F>> UniformSamplingPointPath<F, P>::sample(F max_sampling_length) const
 {
     PointPath<P<F>> result;
     result.closed = m_point_path.closed;
 
-    // TODO result.vertices.reserve( ? );
-    const auto sz = m_point_path.vertices.size();
-    for (std::size_t idx = 0; idx < sz; idx++)
-    {
-        if (!m_point_path.closed && idx == sz - 1)
-            break;
-        const P<F>& p0 = m_point_path.vertices[idx];
-        const P<F>& p1 = m_point_path.vertices[(idx + 1) % sz];
-        const F seg_length = m_segment_length[idx];
-        const unsigned int nb_sampling_edges = static_cast<unsigned int>(std::ceil(seg_length / max_sampling_length)) ;    // excluding sample t = 1.f
-        const F dt = F{1} / static_cast<F>(nb_sampling_edges);
-        F t{0};
-        for (std::size_t s = 0; s < nb_sampling_edges; s++, t += dt)
-        {
-            result.vertices.emplace_back((F{1} - t) * p0 + t * p1);
-        }
+    const std::size_t nb_segs = m_segment_length.size();
+
+    // The output range of each segment
+    std::vector<std::size_t> begin_vertex_idx(nb_segs + 1, 0);
+    for (std::size_t seg = 0; seg < nb_segs; seg++)
+    {
+        begin_vertex_idx[seg + 1] = begin_vertex_idx[seg] + nb_sampling_edges(seg, max_sampling_length);
     }
-    if (!m_point_path.closed)
+    const bool copy_last_vertex = !m_point_path.closed && !m_point_path.vertices.empty();
+    result.vertices.resize(begin_vertex_idx[nb_segs] + (copy_last_vertex ? 1 : 0));
+
+    P<F>* const out = result.vertices.data();
+    stdutils::parallel::for_each_chunk(m_policy, nb_segs, [this, max_sampling_length, &begin_vertex_idx, out](std::size_t, std::size_t begin_seg, std::size_t end_seg) {
+        for (std::size_t seg = begin_seg; seg < end_seg; seg++) { sample_segment(seg, max_sampling_length, out + begin_vertex_idx[seg]); }
+    });
+
+    if (copy_last_vertex)
     {
         // If the curve is not a closed one, we need to copy the last control point
-        result.vertices.emplace_back(m_point_path.vertices.back());
+        result.vertices.back() = m_point_path.vertices.back();
     }
-
     return result;
 }
 
@@ -207,7 +294,13 @@ AllShapes<F> trivial_sampling(const AllShapes<F>& shape)
 
 template <typename F>
 UniformSamplingCubicBezier<F, Point2d>::UniformSamplingCubicBezier(const CubicBezierPath<Point2d<F>>& cbp, InitTraceInfo* trace_info)
-    : m_closed_path(cbp.closed)
+    : UniformSamplingCubicBezier(stdutils::parallel::Policy{1u}, cbp, trace_info)
+{ }
+
+template <typename F>
+UniformSamplingCubicBezier<F, Point2d>::UniformSamplingCubicBezier(const stdutils::parallel::Policy& policy, const CubicBezierPath<Point2d<F>>& cbp, InitTraceInfo* trace_info)
+    : m_policy(policy)
+    , m_closed_path(cbp.closed)
     , m_control_points()
     , m_derivate_control_points()
     , m_sample_t()
@@ -265,16 +358,9 @@ void UniformSamplingCubicBezier<F, Point2d>::initialization_prepare_data_structu
     const std::size_t nb_segs = m_derivate_control_points.size() / 6;
 
     m_sample_t.resize(nb_segs * (SAMPLING_BASE_N + 1));
-    float dt = 1.f / static_cast<float>(SAMPLING_BASE_N);
     for (std::size_t seg = 0; seg < nb_segs; seg++)
     {
-        float* begin_sample_t = &m_sample_t[seg * (SAMPLING_BASE_N + 1)];
-        float t = 0.f;
-        for (std::size_t idx = 0; idx < SAMPLING_BASE_N; idx++, t += dt)
-        {
-            *begin_sample_t++ = t;
-        }
-        *begin_sample_t = 1.f;
+        initialization_uniform_sample_t(seg);
     }
 
     m_norm_v_at_sample.resize(nb_segs * (SAMPLING_BASE_N + 1));
@@ -283,25 +369,54 @@ void UniformSamplingCubicBezier<F, Point2d>::initialization_prepare_data_structu
     m_max_segment_length = F{1};
 }
 
+template <typename F>
+void UniformSamplingCubicBezier<F, Point2d>::initialization_uniform_sample_t(std::size_t seg)
+{
+    const float dt = 1.f / static_cast<float>(SAMPLING_BASE_N);
+    float* begin_sample_t = &m_sample_t[seg * (SAMPLING_BASE_N + 1)];
+    float t = 0.f;
+    for (std::size_t idx = 0; idx < SAMPLING_BASE_N; idx++, t += dt)
+    {
+        *begin_sample_t++ = t;
+    }
+    *begin_sample_t = 1.f;
+}
+
 template <typename F>
 void UniformSamplingCubicBezier<F, Point2d>::initialization_one_iteration(InitIterationTraceInfo* iter_trace_info)
 {
     const std::size_t nb_segs = m_derivate_control_points.size() / 6;
+    if (iter_trace_info)
+    {
+        // The trace info is filled in the order of the segments
+        initialization_one_iteration(0, nb_segs, iter_trace_info);
+    }
+    else
+    {
+        stdutils::parallel::for_each_chunk(m_policy, nb_segs, [this](std::size_t, std::size_t begin_seg, std::size_t end_seg) {
+            initialization_one_iteration(begin_seg, end_seg, nullptr);
+        });
+    }
+    m_max_segment_length = *std::max_element(std::cbegin(m_segment_total_length), std::cend(m_segment_total_length));
+}
 
+template <typename F>
+void UniformSamplingCubicBezier<F, Point2d>::initialization_one_iteration(std::size_t begin_seg, std::size_t end_seg, InitIterationTraceInfo* iter_trace_info)
+{
     std::vector<F> sample_v_norm(SAMPLING_BASE_N + 1, 0);
     std::vector<F> sample_v_norm_avg(SAMPLING_BASE_N, 0);
     std::vector<F> sample_dl(SAMPLING_BASE_N, 0);
     std::vector<float> new_sample_t(SAMPLING_BASE_N, 0);
 
-    for (std::size_t seg = 0; seg < nb_segs; seg++)
+    for (std::size_t seg = begin_seg; seg < end_seg; seg++)
     {
         float* const begin_sample_t = &m_sample_t[seg * (SAMPLING_BASE_N + 1)];
-        QuadraticBezierMap2d<F> derivate_bezier(&m_derivate_control_points[seg * 6]);
+        const QuadraticBezierPolynomial2d<F> derivate_bezier(QuadraticBezierMap2d<F>(&m_derivate_control_points[seg * 6]));
 
         // 1. Compute norm(v) and norm(v) average
         std::size_t idx = 0;
         for(idx = 0; idx <= SAMPLING_BASE_N; idx++)
-            sample_v_norm[idx] = norm(derivate_bezier.at(begin_sample_t[idx]));
+            sample_v_norm[idx] = norm(derivate_bezier.at(static_cast<F>(begin_sample_t[idx])));
         for(idx = 0; idx < SAMPLING_BASE_N; idx++)
             sample_v_norm_avg[idx] = F(0.5) * (sample_v_norm[idx] + sample_v_norm[idx + 1]);
         // Although the derivate of the cubic bezier can be zero, it only happens on a singular point (aka a cusp).
@@ -357,31 +472,44 @@ void UniformSamplingCubicBezier<F, Point2d>::initialization_one_iteration(InitIt
             shapes::PointPath2d<F> pp;
             pp.closed = false;
             pp.vertices.reserve(SAMPLING_BASE_N + 1);
-            CubicBezierMap2d<F> bezier(&m_control_points[6 * seg]);
-            std::transform(&begin_sample_t[0], &begin_sample_t[0] + SAMPLING_BASE_N + 1, std::back_insert_iterator(pp.vertices), [&bezier](const float t) { return bezier.at(t); });
+            const CubicBezierPolynomial2d<F> bezier(CubicBezierMap2d<F>(&m_control_points[6 * seg]));
+            std::transform(&begin_sample_t[0], &begin_sample_t[0] + SAMPLING_BASE_N + 1, std::back_insert_iterator(pp.vertices), [&bezier](const float t) { return bezier.at(static_cast<F>(t)); });
             const auto normalized_stats = path_normalized_uniformity_stats(pp);
             iter_trace_info->edge_length_relative_range.emplace_back(normalized_stats.range);
         }
     }
-
-    m_max_segment_length = *std::max_element(std::cbegin(m_segment_total_length), std::cend(m_segment_total_length));
 }
 
 template <typename F>
 void UniformSamplingCubicBezier<F, Point2d>::initialization_finalize(InitTraceInfo* trace_info)
 {
     const std::size_t nb_segs = m_derivate_control_points.size() / 6;
-    for (std::size_t seg = 0; seg < nb_segs; seg++)
+    if (trace_info)
+    {
+        initialization_finalize(0, nb_segs, trace_info);
+    }
+    else
+    {
+        stdutils::parallel::for_each_chunk(m_policy, nb_segs, [this](std::size_t, std::size_t begin_seg, std::size_t end_seg) {
+            initialization_finalize(begin_seg, end_seg, nullptr);
+        });
+    }
+}
+
+template <typename F>
+void UniformSamplingCubicBezier<F, Point2d>::initialization_finalize(std::size_t begin_seg, std::size_t end_seg, InitTraceInfo* trace_info)
+{
+    for (std::size_t seg = begin_seg; seg < end_seg; seg++)
     {
         float* const begin_sample_t = &m_sample_t[seg * (SAMPLING_BASE_N + 1)];
         F* const begin_norm_v = &m_norm_v_at_sample[seg * (SAMPLING_BASE_N + 1)];
         float* const begin_max_rel_err = &m_max_relative_length_error[seg * SAMPLING_BASE_N];
-        QuadraticBezierMap2d<F> derivate_bezier(&m_derivate_control_points[seg * 6]);
+        const QuadraticBezierPolynomial2d<F> derivate_bezier(QuadraticBezierMap2d<F>(&m_derivate_control_points[seg * 6]));
 
         // 1. Compute norm(v) at each sample point
         std::size_t idx = 0;
         for(idx = 0; idx <= SAMPLING_BASE_N; idx++)
-            begin_norm_v[idx] = norm(derivate_bezier.at(begin_sample_t[idx]));
+            begin_norm_v[idx] = norm(derivate_bezier.at(static_cast<F>(begin_sample_t[idx])));
 
         // 2. Evaluate the max error made on the arc length between two consecutive samples if we assume a constant average v_norm between those
         for(idx = 0; idx < SAMPLING_BASE_N; idx++)
@@ -426,6 +554,46 @@ F precise_time_ratio(F v0, F v1, F length_ratio)
 
 } // namespace
 
+// Number of sampling edges of a segment, excluding the sample t = 1.f
+template <typename F>
+unsigned int UniformSamplingCubicBezier<F, Point2d>::nb_sampling_edges(std::size_t seg, F max_sampling_length) const
+{
+    return static_cast<unsigned int>(std::ceil(m_segment_total_length[seg] / max_sampling_length));
+}
+
+template <typename F>
+void UniformSamplingCubicBezier<F, Point2d>::sample_segment(std::size_t seg, F max_sampling_length, Point2d<F>* out) const
+{
+    const float* const begin_sample_t = &m_sample_t[seg * (SAMPLING_BASE_N + 1)];
+    const F* const begin_norm_v = &m_norm_v_at_sample[seg * (SAMPLING_BASE_N + 1)];
+    const float* const begin_max_rel_err = &m_max_relative_length_error[seg * SAMPLING_BASE_N];
+    assert(begin_sample_t[0] == 0.f);
+    const F seg_length = m_segment_total_length[seg];
+    const unsigned int nb_edges = nb_sampling_edges(seg, max_sampling_length);
+    const F sampling_length = seg_length / static_cast<F>(nb_edges);
+    const F dl = seg_length / static_cast<F>(SAMPLING_BASE_N);
+    const CubicBezierPolynomial2d<F> bezier(CubicBezierMap2d<F>(&m_control_points[6 * seg]));
+    F cumul_l = F{0};
+    for (std::size_t s = 0; s < nb_edges; s++)
+    {
+        float ratio_int = 0.f;
+        const float ratio_frac = std::modf(static_cast<float>(cumul_l / dl), &ratio_int);
+        const unsigned int idx = static_cast<unsigned int>(ratio_int);
+        assert(idx < SAMPLING_BASE_N);
+        // The vertex is between samples idx and (idx + 1)
+        float time_ratio = ratio_frac;      // Linear model
+        if (begin_max_rel_err[idx] > QUADRATIC_ARC_MODEL_RELATIVE_LENGTH_ERROR)
+        {
+            // Use the more precise quadratic model
+            time_ratio = static_cast<float>(precise_time_ratio(begin_norm_v[idx], begin_norm_v[idx + 1], static_cast<F>(ratio_frac)));
+        }
+        assert(0.f <= time_ratio && time_ratio <= 1.f);
+        const F t = (F{1} - static_cast<F>(time_ratio)) * static_cast<F>(begin_sample_t[idx]) + static_cast<F>(time_ratio) * static_cast<F>(begin_sample_t[idx + 1]);
+        out[s] = bezier.at(t);
+        cumul_l += sampling_length;
+    }
+}
+
 template <typename F>
 PointPath<Point2d<F>> UniformSamplingCubicBezier<F, Point2d>::sample(F max_sampling_length) const
 {
@@ -434,49 +602,111 @@ PointPath<Point2d<F>> UniformSamplingCubicBezier<F, Point2d>::sample(F max_sampl
 
     const std::size_t nb_segs = m_derivate_control_points.size() / 6;
 
-    // TODO result.vertices.reserve( ? );
-
+    // The output range of each segment
+    std::vector<std::size_t> begin_vertex_idx(nb_segs + 1, 0);
     for (std::size_t seg = 0; seg < nb_segs; seg++)
     {
-        const float* const begin_sample_t = &m_sample_t[seg * (SAMPLING_BASE_N + 1)];
-        const F* const begin_norm_v = &m_norm_v_at_sample[seg * (SAMPLING_BASE_N + 1)];
-        const float* const begin_max_rel_err = &m_max_relative_length_error[seg * SAMPLING_BASE_N];
-        assert(begin_sample_t[0] == 0.f);
-        const F seg_length = m_segment_total_length[seg];
-        const unsigned int nb_sampling_edges = static_cast<unsigned int>(std::ceil(seg_length / max_sampling_length)) ;    // excluding sample t = 1.f
-        const F sampling_length = seg_length / static_cast<F>(nb_sampling_edges);
-        const F dl = seg_length / static_cast<F>(SAMPLING_BASE_N);
-        CubicBezierMap2d<F> bezier(&m_control_points[6 * seg]);
-        F cumul_l = F{0};
-        for (std::size_t s = 0; s < nb_sampling_edges; s++)
-        {
-            float ratio_int = 0.f;
-            const float ratio_frac = std::modf(static_cast<float>(cumul_l / dl), &ratio_int);
-            const unsigned int idx = static_cast<unsigned int>(ratio_int);
-            assert(idx < SAMPLING_BASE_N);
-            // The vertex is between samples idx and (idx + 1)
-            float time_ratio = ratio_frac;      // Linear model
-            if (begin_max_rel_err[idx] > QUADRATIC_ARC_MODEL_RELATIVE_LENGTH_ERROR)
-            {
-                // Use the more precise quadratic model
-                time_ratio = static_cast<float>(precise_time_ratio(begin_norm_v[idx], begin_norm_v[idx + 1], static_cast<F>(ratio_frac)));
-            }
-            assert(0.f <= time_ratio && time_ratio <= 1.f);
-            result.vertices.emplace_back(bezier.at((1.f - time_ratio) * begin_sample_t[idx] + time_ratio * begin_sample_t[idx + 1]));
-            cumul_l += sampling_length;
-        }
-        if (seg == nb_segs - 1 && !m_closed_path)
-        {
-            // Last sample of the last curve segment
-            // If the curve is not a closed one, we only need to copy the last control point
-            const auto last_idx = 6 * nb_segs;
-            assert(m_control_points.size() == last_idx + 2);
-            result.vertices.emplace_back(Vect2d<F>(m_control_points[last_idx], m_control_points[last_idx + 1]));
-        }
+        begin_vertex_idx[seg + 1] = begin_vertex_idx[seg] + nb_sampling_edges(seg, max_sampling_length);
+    }
+    const std::size_t nb_vertices = begin_vertex_idx[nb_segs] + (m_closed_path || nb_segs == 0 ? 0 : 1);
+    result.vertices.resize(nb_vertices);
+
+    Point2d<F>* const out = result.vertices.data();
+    stdutils::parallel::for_each_chunk(m_policy, nb_segs, [this, max_sampling_length, &begin_vertex_idx, out](std::size_t, std::size_t begin_seg, std::size_t end_seg) {
+        for (std::size_t seg = begin_seg; seg < end_seg; seg++) { sample_segment(seg, max_sampling_length, out + begin_vertex_idx[seg]); }
+    });
+
+    if (!m_closed_path && nb_segs > 0)
+    {
+        // Last sample of the last curve segment
+        // If the curve is not a closed one, we only need to copy the last control point
+        const auto last_idx = 6 * nb_segs;
+        assert(m_control_points.size() == last_idx + 2);
+        result.vertices.back() = Vect2d<F>(m_control_points[last_idx], m_control_points[last_idx + 1]);
     }
     return result;
 }
 
+template <typename F>
+void UniformSamplingCubicBezier<F, Point2d>::update_segments(const CubicBezierPath<Point2d<F>>& cbp, std::size_t begin_seg, std::size_t end_seg)
+{
+    const std::size_t nb_segs = m_derivate_control_points.size() / 6;
+    assert(valid_size(cbp));
+    assert(nb_segments(cbp) == nb_segs && cbp.closed == m_closed_path);
+    assert(begin_seg <= end_seg && end_seg <= nb_segs);
+    if (begin_seg == end_seg)
+        return;
+
+    // Control points, including the duplicated first vertex of a closed path
+    const std::size_t nb_vertices = cbp.vertices.size();
+    for (std::size_t idx = 3 * begin_seg; idx <= 3 * end_seg; idx++)
+    {
+        const auto& p = cbp.vertices[idx % nb_vertices];
+        m_control_points[2 * idx] = p.x;
+        m_control_points[2 * idx + 1] = p.y;
+    }
+
+    // Derivate control points
+    const F* p = m_control_points.data();
+    F* v = m_derivate_control_points.data();
+    for (std::size_t idx = 6 * begin_seg; idx < 6 * end_seg; idx++)
+    {
+        v[idx] = F{3} * (p[idx + 2] - p[idx]);
+    }
+
+    // Same initialization as in the constructor, restricted to the edited segments
+    stdutils::parallel::for_each_chunk(m_policy, end_seg - begin_seg, [this, begin_seg](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        const std::size_t chunk_begin_seg = begin_seg + begin_idx;
+        const std::size_t chunk_end_seg = begin_seg + end_idx;
+        for (std::size_t seg = chunk_begin_seg; seg < chunk_end_seg; seg++) { initialization_uniform_sample_t(seg); }
+        for (unsigned int iter = 0; iter < SAMPLING_ITERATIONS; iter++) { initialization_one_iteration(chunk_begin_seg, chunk_end_seg, nullptr); }
+        initialization_finalize(chunk_begin_seg, chunk_end_seg, nullptr);
+    });
+    m_max_segment_length = *std::max_element(std::cbegin(m_segment_total_length), std::cend(m_segment_total_length));
+}
+
+template <typename F>
+void UniformSamplingCubicBezier<F, Point2d>::resample_segments(F max_sampling_length, std::size_t begin_seg, std::size_t end_seg, PointPath<Point2d<F>>& pp) const
+{
+    const std::size_t nb_segs = m_derivate_control_points.size() / 6;
+    assert(begin_seg <= end_seg && end_seg <= nb_segs);
+    assert(pp.closed == m_closed_path);
+    if (begin_seg == end_seg)
+        return;
+
+    // The segments outside of the range were not edited: Their number of samples did not change
+    std::size_t begin_vertex_idx = 0;
+    for (std::size_t seg = 0; seg < begin_seg; seg++) { begin_vertex_idx += nb_sampling_edges(seg, max_sampling_length); }
+    std::size_t nb_tail_vertices = m_closed_path ? 0 : 1;
+    for (std::size_t seg = end_seg; seg < nb_segs; seg++) { nb_tail_vertices += nb_sampling_edges(seg, max_sampling_length); }
+    assert(pp.vertices.size() >= begin_vertex_idx + nb_tail_vertices);
+    const std::size_t old_nb_range_vertices = pp.vertices.size() - begin_vertex_idx - nb_tail_vertices;
+
+    // The output range of each edited segment
+    std::vector<std::size_t> range_vertex_idx(end_seg - begin_seg + 1, begin_vertex_idx);
+    for (std::size_t seg = begin_seg; seg < end_seg; seg++)
+    {
+        range_vertex_idx[seg - begin_seg + 1] = range_vertex_idx[seg - begin_seg] + nb_sampling_edges(seg, max_sampling_length);
+    }
+    const std::size_t new_nb_range_vertices = range_vertex_idx.back() - begin_vertex_idx;
+    const auto range_end_it = pp.vertices.begin() + static_cast<std::ptrdiff_t>(begin_vertex_idx + old_nb_range_vertices);
+    if (new_nb_range_vertices > old_nb_range_vertices)
+        pp.vertices.insert(range_end_it, new_nb_range_vertices - old_nb_range_vertices, Point2d<F>());
+    else
+        pp.vertices.erase(range_end_it - static_cast<std::ptrdiff_t>(old_nb_range_vertices - new_nb_range_vertices), range_end_it);
+
+    Point2d<F>* const out = pp.vertices.data();
+    stdutils::parallel::for_each_chunk(m_policy, end_seg - begin_seg, [this, max_sampling_length, begin_seg, &range_vertex_idx, out](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++) { sample_segment(begin_seg + idx, max_sampling_length, out + range_vertex_idx[idx]); }
+    });
+
+    if (!m_closed_path && end_seg == nb_segs)
+    {
+        const auto last_idx = 6 * nb_segs;
+        pp.vertices.back() = Vect2d<F>(m_control_points[last_idx], m_control_points[last_idx + 1]);
+    }
+}
+
 template <typename F, template<typename> typename P>
 stdutils::stats::Result<F> path_normalized_uniformity_stats(const shapes::PointPath<P<F>>& pp)
 {
@@ -498,25 +728,61 @@ stdutils::stats::Result<F> path_normalized_uniformity_stats(const shapes::PointP
     return stats.get_result().normalize_to_mean();
 }
 
+template <typename F, template<typename> typename P>
+stdutils::stats::Result<F> path_normalized_uniformity_stats(const stdutils::parallel::Policy& policy, const shapes::PointPath<P<F>>& pp)
+{
+    STDUTILS_PROFILE_ZONE("sampling::path_normalized_uniformity_stats");
+    if (pp.vertices.empty())
+        return stdutils::stats::Result<F>{};
 
-namespace details {
+    const auto nb_vertices = pp.vertices.size();
+    const auto nb_edges = shapes::nb_edges(pp);
+    std::vector<stdutils::stats::CumulSamples<F>> chunk_stats(stdutils::parallel::nb_chunks(policy, nb_edges));
+    stdutils::parallel::for_each_chunk(policy, nb_edges, [&pp, &chunk_stats, nb_vertices](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+        auto& stats = chunk_stats[chunk_idx];
+        for (std::size_t v_idx = begin_idx; v_idx < end_idx; v_idx++)
+        {
+            const auto p0 = pp.vertices[v_idx];
+            const auto p1 = pp.vertices[(v_idx + 1) % nb_vertices];
+            stats.add_sample(shapes::norm(p1 - p0));
+        }
+    });
+    stdutils::stats::CumulSamples<F> stats;
+    for (const auto& partial_stats : chunk_stats) { stats += partial_stats; }
+    return stats.get_result().normalize_to_mean();
+}
 
-enum class CasteljauState
+template <typename F>
+std::vector<stdutils::stats::Result<F>> paths_normalized_uniformity_stats(const stdutils::parallel::Policy& policy, const io::ShapeAggregate<F>& shapes)
 {
-    First,
-    Mid,
-    Last,
-};
+    STDUTILS_PROFILE_ZONE("sampling::paths_normalized_uniformity_stats");
+    std::vector<stdutils::stats::Result<F>> result(shapes.size());
+    stdutils::parallel::for_each_dynamic(policy, shapes.size(), [&shapes, &result](std::size_t, std::size_t idx) {
+        if (const auto* pp = std::get_if<PointPath2d<F>>(&shapes[idx].shape))
+            result[idx] = path_normalized_uniformity_stats(*pp);
+        else if (const auto* pp3 = std::get_if<PointPath3d<F>>(&shapes[idx].shape))
+            result[idx] = path_normalized_uniformity_stats(*pp3);
+    });
+    return result;
+}
+
+
+namespace details {
 
+// Beyond that depth, a sub-curve is accepted without further subdivision. It is never reached in practice (2^32 sub-curves per segment).
+constexpr std::size_t casteljau_max_depth = 32;
+
+// Upper limit on the number of vertices reserved upfront
+constexpr std::size_t casteljau_max_reserved_vertices = std::size_t{1} << 20;
+
+// The control points P0, P1, P2, P3 of a cubic Bezier curve: x0, y0, x1, y1, ...
 template <typename F>
-using CasteljauStackElement = CasteljauCubicBezier2d<F>;
+using CasteljauControlPoints = std::array<F, 8>;
 
 template <typename F>
-bool casteljau_split_predicate(const CasteljauCubicBezier2d<F>& casteljau, F resolution_sq)
+bool casteljau_split_predicate(const F* p, F resolution_sq)
 {
     assert(resolution_sq);
-    const auto bezier = casteljau.bezier();
-    const F* p = bezier.cps();
     assert(p);
     const Point2d<F> p0(p[0], p[1]);
     const Point2d<F> p1(p[2], p[3]);
@@ -528,6 +794,89 @@ bool casteljau_split_predicate(const CasteljauCubicBezier2d<F>& casteljau, F res
     return (a0 + a1) * (a0 + a1) > resolution_sq * sq_norm(q);
 }
 
+// Split a curve at t = 0.5. The output can be the same as the input.
+template <typename F>
+void casteljau_split_half(const CasteljauControlPoints<F>& p, CasteljauControlPoints<F>& first_half, CasteljauControlPoints<F>& second_half)
+{
+    const F h = F{0.5};
+    CasteljauControlPoints<F> first;
+    CasteljauControlPoints<F> second;
+    for (std::size_t i = 0; i < 2; i++)
+    {
+        const F q0 = h * p[i]     + h * p[2 + i];
+        const F q1 = h * p[2 + i] + h * p[4 + i];
+        const F q2 = h * p[4 + i] + h * p[6 + i];
+        const F r0 = h * q0 + h * q1;
+        const F r1 = h * q1 + h * q2;
+        const F s0 = h * r0 + h * r1;
+        first[i] = p[i];      first[2 + i] = q0;  first[4 + i] = r0;  first[6 + i] = s0;
+        second[i] = s0;       second[2 + i] = r1; second[4 + i] = q2; second[6 + i] = p[6 + i];
+    }
+    first_half = first;
+    second_half = second;
+}
+
+// The length of the control polygon over resolution_length: An estimate of the number of vertices of the sampling, which avoids the reallocations
+template <typename F>
+std::size_t casteljau_estimated_nb_vertices(const CubicBezierPath<Point2d<F>>& cbp, std::size_t begin_seg, std::size_t end_seg, F resolution_length)
+{
+    const std::size_t nb_vertices = cbp.vertices.size();
+    F polygon_length = F{0};
+    for (std::size_t idx = 3 * begin_seg; idx < 3 * end_seg; idx++)
+    {
+        polygon_length += norm(cbp.vertices[(idx + 1) % nb_vertices] - cbp.vertices[idx]);
+    }
+    const F estimate = polygon_length / resolution_length + static_cast<F>(end_seg - begin_seg + 1);
+    return estimate < static_cast<F>(casteljau_max_reserved_vertices) ? static_cast<std::size_t>(estimate) : casteljau_max_reserved_vertices;
+}
+
+// Append the Casteljau sampling of the segments [begin_seg, end_seg) of the CBP, excluding their last endpoint.
+// The subdivision is depth-first with a fixed size stack: Once the output is reserved, there are no allocations.
+// If segment_offsets is not null, it receives the position in out of the first sample of each segment.
+template <typename F>
+void casteljau_sample_segments(const CubicBezierPath<Point2d<F>>& cbp, std::size_t begin_seg, std::size_t end_seg, F resolution_length, std::vector<Point2d<F>>& out, std::size_t* segment_offsets = nullptr)
+{
+    assert(end_seg <= nb_segments(cbp));
+    const F resolution_sq = resolution_length * resolution_length;
+    const std::size_t nb_vertices = cbp.vertices.size();
+    out.reserve(out.size() + casteljau_estimated_nb_vertices(cbp, begin_seg, end_seg, resolution_length));
+
+    std::array<CasteljauControlPoints<F>, casteljau_max_depth + 1> stack;
+    std::array<std::size_t, casteljau_max_depth + 1> depth;
+    for (std::size_t seg_idx = begin_seg; seg_idx < end_seg; seg_idx++)
+    {
+        if (segment_offsets) { segment_offsets[seg_idx - begin_seg] = out.size(); }
+
+        // The last segment of a closed CBP ends on the first vertex
+        for (std::size_t i = 0; i < 4; i++)
+        {
+            const auto& p = cbp.vertices[(3 * seg_idx + i) % nb_vertices];
+            stack[0][2 * i] = p.x;
+            stack[0][2 * i + 1] = p.y;
+        }
+        depth[0] = 0;
+        std::size_t stack_size = 1;
+
+        // Casteljau algo: The first half of a split is on top of the stack, so the vertices are output in order
+        while (stack_size > 0)
+        {
+            const std::size_t top = stack_size - 1;
+            if (depth[top] < casteljau_max_depth && casteljau_split_predicate(stack[top].data(), resolution_sq))
+            {
+                assert(stack_size < stack.size());
+                casteljau_split_half(stack[top], stack[top + 1], stack[top]);
+                depth[top + 1] = ++depth[top];
+                stack_size++;
+            }
+            else
+            {
+                out.emplace_back(stack[top][0], stack[top][1]);
+                stack_size--;
+            }
+        }
+    }
+}
+
 } // namespace details
 
 template <typename F>
@@ -535,68 +884,58 @@ CasteljauSamplingCubicBezier<F, Point2d>::CasteljauSamplingCubicBezier() = defau
 
 template <typename F>
 PointPath<Point2d<F>> CasteljauSamplingCubicBezier<F, Point2d>::sample(const CubicBezierPath<Point2d<F>>& cbp, F resolution_length) const
+{
+    return sample(stdutils::parallel::Policy{1u}, cbp, resolution_length);
+}
+
+template <typename F>
+PointPath<Point2d<F>> CasteljauSamplingCubicBezier<F, Point2d>::sample(const stdutils::parallel::Policy& policy, const CubicBezierPath<Point2d<F>>& cbp, F resolution_length) const
 {
     assert(resolution_length > F{0});
     assert(!cbp.empty());
 
-    const F resolution_sq = resolution_length * resolution_length;
-    std::stack<details::CasteljauStackElement<F>> split_stack;
+    const auto nb_segs = nb_segments(cbp);
 
-    // Initialize the split stack with one element per CBP segment
-    if (cbp.closed)
+    // The number of vertices of each segment is not known in advance: Each chunk has its own output, then the outputs are concatenated
+    PointPath2d<F> pp;
+    const std::size_t nb_chunks = stdutils::parallel::nb_chunks(policy, nb_segs);
+    if (nb_chunks == 1)
     {
-        const std::size_t N = cbp.vertices.size();
-        assert(N % 3 == 0);
-        // In the case of a closed CBP we're missing the last vertex and cannot directly map the last segment with a CubicBezierMap
-        std::array<Vect2d<F>, 4> last_segment;
-        last_segment[0] = cbp.vertices[N-3];
-        last_segment[1] = cbp.vertices[N-2];
-        last_segment[2] = cbp.vertices[N-1];
-        last_segment[3] = cbp.vertices[0];
-        split_stack.emplace(CasteljauCubicBezier2d<F>(CubicBezierMap2d<F>(&last_segment[0])));
-        const auto nb_segs = nb_segments(cbp);
-        // Skip the last segment which is already inserted onto the stack
-        for (std::size_t seg_idx_incr = nb_segs - 1; seg_idx_incr > 0; seg_idx_incr--)
-        {
-            const auto seg_idx = seg_idx_incr - 1;
-            split_stack.emplace(CasteljauCubicBezier2d<F>(CubicBezierMap2d<F>(&cbp.vertices[3 * seg_idx])));
-        }
+        details::casteljau_sample_segments(cbp, 0, nb_segs, resolution_length, pp.vertices);
     }
     else
     {
-        const auto nb_segs = nb_segments(cbp);
-        for (std::size_t seg_idx_incr = nb_segs; seg_idx_incr > 0; seg_idx_incr--)
-        {
-            const auto seg_idx = seg_idx_incr - 1;
-            split_stack.emplace(CasteljauCubicBezier2d<F>(CubicBezierMap2d<F>(&cbp.vertices[3 * seg_idx])));
-        }
+        std::vector<std::vector<Point2d<F>>> chunk_vertices(nb_chunks);
+        stdutils::parallel::for_each_chunk(policy, nb_segs, [&cbp, resolution_length, &chunk_vertices](std::size_t chunk_idx, std::size_t begin_seg, std::size_t end_seg) {
+            details::casteljau_sample_segments(cbp, begin_seg, end_seg, resolution_length, chunk_vertices[chunk_idx]);
+        });
+        std::size_t nb_vertices = 0;
+        for (const auto& vertices : chunk_vertices) { nb_vertices += vertices.size(); }
+        pp.vertices.reserve(nb_vertices + 1);
+        for (const auto& vertices : chunk_vertices) { pp.vertices.insert(pp.vertices.end(), vertices.cbegin(), vertices.cend()); }
     }
-    assert(split_stack.size() == nb_segments(cbp));
 
-    // Casteljau algo
-    PointPath2d<F> pp;
-    while (!split_stack.empty())
+    // Finalize the point path
+    if (!cbp.closed)
     {
-        auto& casteljau = split_stack.top();
+        pp.vertices.emplace_back(cbp.vertices.back());
+    }
+    pp.closed = cbp.closed;
 
-        const bool must_split = details::casteljau_split_predicate<F>(casteljau, resolution_sq);
+    return pp;
+}
 
-        if (must_split)
-        {
-            // Split
-            CasteljauCubicBezier2d<F> casteljau_split0(casteljau.split0());
-            CasteljauCubicBezier2d<F> casteljau_split1(casteljau.split1());
-            std::swap(casteljau, casteljau_split1);
-            split_stack.emplace(std::move(casteljau_split0));
-        }
-        else
-        {
-            pp.vertices.emplace_back(casteljau.bezier().first());
-            split_stack.pop();
-        }
-    }
+template <typename F>
+PointPath<Point2d<F>> CasteljauSamplingCubicBezier<F, Point2d>::sample(const CubicBezierPath<Point2d<F>>& cbp, F resolution_length, std::vector<std::size_t>& segment_offsets) const
+{
+    assert(resolution_length > F{0});
+    assert(!cbp.empty());
 
-    // Finalize the point path
+    const auto nb_segs = nb_segments(cbp);
+    PointPath2d<F> pp;
+    segment_offsets.resize(nb_segs + 1);
+    details::casteljau_sample_segments(cbp, 0, nb_segs, resolution_length, pp.vertices, segment_offsets.data());
+    segment_offsets.back() = pp.vertices.size();
     if (!cbp.closed)
     {
         pp.vertices.emplace_back(cbp.vertices.back());
@@ -606,4 +945,44 @@ PointPath<Point2d<F>> CasteljauSamplingCubicBezier<F, Point2d>::sample(const Cub
     return pp;
 }
 
+template <typename F>
+void CasteljauSamplingCubicBezier<F, Point2d>::resample_segments(const CubicBezierPath<Point2d<F>>& cbp, F resolution_length, std::size_t begin_seg, std::size_t end_seg, PointPath<Point2d<F>>& pp, std::vector<std::size_t>& segment_offsets) const
+{
+    assert(resolution_length > F{0});
+    const auto nb_segs = nb_segments(cbp);
+    assert(begin_seg <= end_seg && end_seg <= nb_segs);
+    assert(segment_offsets.size() == nb_segs + 1);
+    assert(pp.closed == cbp.closed);
+    if (begin_seg == end_seg)
+        return;
+
+    std::vector<Point2d<F>> range_vertices;
+    std::vector<std::size_t> range_offsets(end_seg - begin_seg);
+    details::casteljau_sample_segments(cbp, begin_seg, end_seg, resolution_length, range_vertices, range_offsets.data());
+
+    // Splice the new samples in place of the former ones, and shift the offsets of the following segments
+    const std::size_t begin_vertex_idx = segment_offsets[begin_seg];
+    const std::size_t old_nb_range_vertices = segment_offsets[end_seg] - begin_vertex_idx;
+    const auto range_begin_it = pp.vertices.begin() + static_cast<std::ptrdiff_t>(begin_vertex_idx);
+    if (range_vertices.size() >= old_nb_range_vertices)
+    {
+        std::copy(range_vertices.cbegin(), range_vertices.cbegin() + static_cast<std::ptrdiff_t>(old_nb_range_vertices), range_begin_it);
+        pp.vertices.insert(range_begin_it + static_cast<std::ptrdiff_t>(old_nb_range_vertices), range_vertices.cbegin() + static_cast<std::ptrdiff_t>(old_nb_range_vertices), range_vertices.cend());
+    }
+    else
+    {
+        std::copy(range_vertices.cbegin(), range_vertices.cend(), range_begin_it);
+        pp.vertices.erase(range_begin_it + static_cast<std::ptrdiff_t>(range_vertices.size()), range_begin_it + static_cast<std::ptrdiff_t>(old_nb_range_vertices));
+    }
+    for (std::size_t seg = begin_seg; seg < end_seg; seg++) { segment_offsets[seg] = begin_vertex_idx + range_offsets[seg - begin_seg]; }
+    const std::size_t old_end_vertex_idx = segment_offsets[end_seg];
+    const std::size_t new_end_vertex_idx = begin_vertex_idx + range_vertices.size();
+    for (std::size_t seg = end_seg; seg <= nb_segs; seg++) { segment_offsets[seg] = segment_offsets[seg] - old_end_vertex_idx + new_end_vertex_idx; }
+
+    if (!cbp.closed && end_seg == nb_segs)
+    {
+        pp.vertices.back() = cbp.vertices.back();
+    }
+}
+
 } // namespace shapes
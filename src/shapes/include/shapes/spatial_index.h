@@ -0,0 +1,578 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <graphs/index.h>
+#include <shapes/bounding_box.h>
+#include <shapes/point.h>
+#include <stdutils/parallel.h>
+#include <stdutils/span.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace shapes {
+
+/**
+ * Static spatial indices of a 2D point set
+ *
+ * The indices copy the points in their own order, for the locality of the queries, and answer with the indices of the input points.
+ * The queries are const and can be run concurrently.
+ *
+ *  - nearest(q):           The index of the point nearest to q, or IndexTraits<I>::undef() if the index is empty
+ *  - k_nearest(q, k):      The indices of the k points nearest to q, sorted by increasing distance
+ *  - range(bb):            The indices of the points inside the bounding box bb (boundary included), in no particular order
+ *  - radius(q, r):         The indices of the points at a distance to q lower or equal to r, in no particular order
+ *
+ * The distances are compared squared, and the ties are broken by the order of the index.
+ */
+
+/**
+ * Balanced k-d tree
+ *
+ * The tree is implicit: A node is a range of the points, whose median along x or y (alternately) is the pivot, in the middle of the range.
+ * The points before the pivot are the left subtree, and those after it the right subtree, down to buckets of LeafSize points.
+ * Its depth is O(log n) whatever the distribution of the points. With a parallel policy, the subtrees below the first levels are built concurrently.
+ */
+template <typename F, typename I = std::uint32_t>
+class KdTree
+{
+public:
+    using scalar = F;
+    using index = I;
+
+    static constexpr std::size_t LeafSize = 8;
+
+    KdTree() = default;
+    explicit KdTree(stdutils::Span<const Point2d<F>> points);
+    KdTree(const stdutils::parallel::Policy& policy, stdutils::Span<const Point2d<F>> points);
+
+    std::size_t size() const noexcept { return m_points.size(); }
+    bool empty() const noexcept { return m_points.empty(); }
+
+    I nearest(const Point2d<F>& q) const;
+    void k_nearest(const Point2d<F>& q, std::size_t k, std::vector<I>& result) const;
+    void range(const BoundingBox2d<F>& bb, std::vector<I>& result) const;
+    void radius(const Point2d<F>& q, F r, std::vector<I>& result) const;
+
+private:
+    template <typename Func>
+    void visit(const Point2d<F>& q, F& max_sq_dist, std::size_t begin, std::size_t end, unsigned int depth, Func& func) const;
+    void range(const BoundingBox2d<F>& bb, std::size_t begin, std::size_t end, unsigned int depth, std::vector<I>& result) const;
+
+    std::vector<Point2d<F>> m_points;                       // In the order of the tree
+    std::vector<I> m_indices;                               // Input index of m_points[k]
+};
+
+/**
+ * Uniform grid
+ *
+ * The bounding box of the points is split in square cells holding CellOccupancy points on average, stored contiguously cell by cell.
+ * The build is in O(n) and the queries only visit the cells around q, which makes the grid faster than the k-d tree on evenly distributed
+ * points. On strongly clustered points most of the cells are empty and a few are crowded: Prefer the k-d tree.
+ * With a parallel policy, the bounding box and the cells of the points are computed concurrently.
+ */
+template <typename F, typename I = std::uint32_t>
+class UniformGrid
+{
+public:
+    using scalar = F;
+    using index = I;
+
+    static constexpr std::size_t CellOccupancy = 2;
+
+    UniformGrid() = default;
+    explicit UniformGrid(stdutils::Span<const Point2d<F>> points);
+    UniformGrid(const stdutils::parallel::Policy& policy, stdutils::Span<const Point2d<F>> points);
+
+    std::size_t size() const noexcept { return m_points.size(); }
+    bool empty() const noexcept { return m_points.empty(); }
+    std::size_t nb_cells_x() const noexcept { return m_nb_cells_x; }
+    std::size_t nb_cells_y() const noexcept { return m_nb_cells_y; }
+
+    I nearest(const Point2d<F>& q) const;
+    void k_nearest(const Point2d<F>& q, std::size_t k, std::vector<I>& result) const;
+    void range(const BoundingBox2d<F>& bb, std::vector<I>& result) const;
+    void radius(const Point2d<F>& q, F r, std::vector<I>& result) const;
+
+private:
+    std::size_t cell_x(F x) const noexcept;
+    std::size_t cell_y(F y) const noexcept;
+
+    // Call func(point_idx) for the points of the cells at a Chebyshev distance ring of the cell (cx, cy). The cells out of the grid are skipped.
+    template <typename Func>
+    void for_each_in_ring(std::size_t cx, std::size_t cy, std::size_t ring, Func func) const;
+
+    // Visit the rings of cells around q until func's bound is below the distance to the next ring
+    template <typename Func>
+    void visit_rings(const Point2d<F>& q, F& max_sq_dist, Func func) const;
+
+    Point2d<F> m_origin{ F{0}, F{0} };
+    F m_cell_size{1};
+    std::size_t m_nb_cells_x{0};
+    std::size_t m_nb_cells_y{0};
+    std::vector<std::size_t> m_cell_offsets;                // The points of cell (cx, cy) are in range [m_cell_offsets[c], m_cell_offsets[c+1]), c = cy * m_nb_cells_x + cx
+    std::vector<Point2d<F>> m_points;                       // In the order of the cells
+    std::vector<I> m_indices;                               // Input index of m_points[k]
+};
+
+
+//
+//
+// Implementation
+//
+//
+
+
+namespace details {
+namespace spatial_index {
+
+    template <typename F>
+    F coord(const Point2d<F>& p, unsigned int axis) { return axis == 0 ? p.x : p.y; }
+
+    template <typename F>
+    F sq_dist(const Point2d<F>& p, const Point2d<F>& q) { const F dx = p.x - q.x; const F dy = p.y - q.y; return dx * dx + dy * dy; }
+
+    template <typename F, typename I>
+    struct Entry
+    {
+        Point2d<F> p;
+        I idx;
+    };
+
+    // Bounded max-heap of the k best candidates, ordered by (squared distance, index)
+    template <typename F, typename I>
+    class KBest
+    {
+    public:
+        explicit KBest(std::size_t k) : m_k(k), m_heap() { m_heap.reserve(k); }
+
+        F bound() const { return m_k == 0 || m_heap.size() < m_k ? std::numeric_limits<F>::max() : m_heap.front().first; }
+
+        void push(F sq_dist, I idx)
+        {
+            if (m_heap.size() < m_k)
+            {
+                m_heap.emplace_back(sq_dist, idx);
+                std::push_heap(m_heap.begin(), m_heap.end());
+            }
+            else if (std::make_pair(sq_dist, idx) < m_heap.front())
+            {
+                std::pop_heap(m_heap.begin(), m_heap.end());
+                m_heap.back() = std::make_pair(sq_dist, idx);
+                std::push_heap(m_heap.begin(), m_heap.end());
+            }
+        }
+
+        void sorted_indices(std::vector<I>& result)
+        {
+            std::sort_heap(m_heap.begin(), m_heap.end());
+            result.clear();
+            result.reserve(m_heap.size());
+            for (const auto& candidate : m_heap) { result.push_back(candidate.second); }
+        }
+
+    private:
+        std::size_t m_k;
+        std::vector<std::pair<F, I>> m_heap;
+    };
+
+    template <typename F, typename I>
+    void split_entries(std::vector<Entry<F, I>>& entries, std::vector<Point2d<F>>& points, std::vector<I>& indices)
+    {
+        points.resize(entries.size());
+        indices.resize(entries.size());
+        for (std::size_t idx = 0; idx < entries.size(); idx++)
+        {
+            points[idx] = entries[idx].p;
+            indices[idx] = entries[idx].idx;
+        }
+    }
+
+    template <typename F, typename I>
+    std::vector<Entry<F, I>> make_entries(const stdutils::parallel::Policy& policy, stdutils::Span<const Point2d<F>> points)
+    {
+        assert(points.size() <= graphs::IndexTraits<I>::max_valid_index());
+        std::vector<Entry<F, I>> entries(points.size());
+        stdutils::parallel::for_each_chunk(policy, points.size(), [&entries, &points](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+            for (std::size_t idx = begin_idx; idx < end_idx; idx++) { entries[idx] = Entry<F, I>{ points[idx], static_cast<I>(idx) }; }
+        });
+        return entries;
+    }
+
+    // Median split of the entries in range [begin, end) around the pivot at mid, recursively down to the buckets, or to the given depth
+    template <typename F, typename I>
+    void kd_split(std::vector<Entry<F, I>>& entries, std::size_t begin, std::size_t end, unsigned int depth, unsigned int max_depth, std::size_t leaf_size, std::vector<std::pair<std::size_t, unsigned int>>* subtrees)
+    {
+        if (end - begin <= leaf_size)
+            return;
+        if (depth == max_depth)
+        {
+            assert(subtrees);
+            subtrees->emplace_back(begin, depth);
+            return;
+        }
+        const std::size_t mid = begin + (end - begin) / 2;
+        const unsigned int axis = depth % 2;
+        const auto first = entries.begin() + static_cast<std::ptrdiff_t>(begin);
+        std::nth_element(first, entries.begin() + static_cast<std::ptrdiff_t>(mid), entries.begin() + static_cast<std::ptrdiff_t>(end), [axis](const Entry<F, I>& lhs, const Entry<F, I>& rhs) {
+            return coord(lhs.p, axis) < coord(rhs.p, axis);
+        });
+        kd_split(entries, begin, mid, depth + 1, max_depth, leaf_size, subtrees);
+        kd_split(entries, mid + 1, end, depth + 1, max_depth, leaf_size, subtrees);
+    }
+
+} // namespace spatial_index
+} // namespace details
+
+template <typename F, typename I>
+KdTree<F, I>::KdTree(stdutils::Span<const Point2d<F>> points)
+    : KdTree(stdutils::parallel::Policy{ 1 }, points)
+{
+}
+
+template <typename F, typename I>
+KdTree<F, I>::KdTree(const stdutils::parallel::Policy& policy, stdutils::Span<const Point2d<F>> points)
+    : m_points()
+    , m_indices()
+{
+    using namespace details::spatial_index;
+    auto entries = make_entries<F, I>(policy, points);
+    const std::size_t n = entries.size();
+
+    // The first levels are split on the calling thread, until there are enough subtrees to balance the workers
+    unsigned int max_depth = 0;
+    const std::size_t nb_subtrees = 4 * stdutils::parallel::nb_chunks(policy, n);
+    while (nb_subtrees > 1 && (std::size_t{1} << max_depth) < nb_subtrees) { max_depth++; }
+    std::vector<std::pair<std::size_t, unsigned int>> subtrees;
+    kd_split(entries, 0, n, 0, max_depth, LeafSize, &subtrees);
+
+    // The range of a subtree is that of its node in the implicit tree: Its end is the beginning of the next subtree, or of the next node
+    std::vector<std::size_t> subtree_ends(subtrees.size());
+    for (std::size_t idx = 0; idx < subtrees.size(); idx++)
+    {
+        std::size_t begin = 0;
+        std::size_t end = n;
+        const std::size_t target = subtrees[idx].first;
+        for (unsigned int depth = 0; depth < subtrees[idx].second; depth++)
+        {
+            const std::size_t mid = begin + (end - begin) / 2;
+            if (target < mid) { end = mid; } else { begin = mid + 1; }
+        }
+        assert(begin == target);
+        subtree_ends[idx] = end;
+    }
+    stdutils::parallel::for_each_dynamic(policy, subtrees.size(), [&entries, &subtrees, &subtree_ends](std::size_t, std::size_t idx) {
+        constexpr unsigned int NoMaxDepth = std::numeric_limits<unsigned int>::max();
+        kd_split<F, I>(entries, subtrees[idx].first, subtree_ends[idx], subtrees[idx].second, NoMaxDepth, LeafSize, nullptr);
+    });
+    split_entries(entries, m_points, m_indices);
+}
+
+template <typename F, typename I>
+template <typename Func>
+void KdTree<F, I>::visit(const Point2d<F>& q, F& max_sq_dist, std::size_t begin, std::size_t end, unsigned int depth, Func& func) const
+{
+    if (end - begin <= LeafSize)
+    {
+        for (std::size_t idx = begin; idx < end; idx++) { func(idx); }
+        return;
+    }
+    const std::size_t mid = begin + (end - begin) / 2;
+    const unsigned int axis = depth % 2;
+    const F diff = details::spatial_index::coord(q, axis) - details::spatial_index::coord(m_points[mid], axis);
+
+    // The left subtree holds the coordinates <= the pivot's, and the right subtree those >= the pivot's
+    func(mid);
+    if (diff < F{0})
+    {
+        visit(q, max_sq_dist, begin, mid, depth + 1, func);
+        if (diff * diff <= max_sq_dist) { visit(q, max_sq_dist, mid + 1, end, depth + 1, func); }
+    }
+    else
+    {
+        visit(q, max_sq_dist, mid + 1, end, depth + 1, func);
+        if (diff * diff <= max_sq_dist) { visit(q, max_sq_dist, begin, mid, depth + 1, func); }
+    }
+}
+
+template <typename F, typename I>
+I KdTree<F, I>::nearest(const Point2d<F>& q) const
+{
+    I best = graphs::IndexTraits<I>::undef();
+    F best_sq_dist = std::numeric_limits<F>::max();
+    auto func = [this, &q, &best, &best_sq_dist](std::size_t idx) {
+        const F sq_dist = details::spatial_index::sq_dist(q, m_points[idx]);
+        if (sq_dist < best_sq_dist || (sq_dist == best_sq_dist && m_indices[idx] < best))
+        {
+            best = m_indices[idx];
+            best_sq_dist = sq_dist;
+        }
+    };
+    if (!empty()) { visit(q, best_sq_dist, 0, m_points.size(), 0, func); }
+    return best;
+}
+
+template <typename F, typename I>
+void KdTree<F, I>::k_nearest(const Point2d<F>& q, std::size_t k, std::vector<I>& result) const
+{
+    details::spatial_index::KBest<F, I> k_best(std::min(k, m_points.size()));
+    F bound = k_best.bound();
+    auto func = [this, &q, &k_best, &bound](std::size_t idx) {
+        k_best.push(details::spatial_index::sq_dist(q, m_points[idx]), m_indices[idx]);
+        bound = k_best.bound();
+    };
+    if (!empty() && k > 0) { visit(q, bound, 0, m_points.size(), 0, func); }
+    k_best.sorted_indices(result);
+}
+
+template <typename F, typename I>
+void KdTree<F, I>::range(const BoundingBox2d<F>& bb, std::vector<I>& result) const
+{
+    result.clear();
+    if (!empty() && bb.is_populated()) { range(bb, 0, m_points.size(), 0, result); }
+}
+
+template <typename F, typename I>
+void KdTree<F, I>::range(const BoundingBox2d<F>& bb, std::size_t begin, std::size_t end, unsigned int depth, std::vector<I>& result) const
+{
+    const auto test_point = [this, &bb, &result](std::size_t idx) {
+        const auto& p = m_points[idx];
+        if (bb.rx.min <= p.x && p.x <= bb.rx.max && bb.ry.min <= p.y && p.y <= bb.ry.max) { result.push_back(m_indices[idx]); }
+    };
+    if (end - begin <= LeafSize)
+    {
+        for (std::size_t idx = begin; idx < end; idx++) { test_point(idx); }
+        return;
+    }
+    const std::size_t mid = begin + (end - begin) / 2;
+    const unsigned int axis = depth % 2;
+    const F split = details::spatial_index::coord(m_points[mid], axis);
+    const auto& bb_range = axis == 0 ? bb.rx : bb.ry;
+    test_point(mid);
+    if (bb_range.min <= split) { range(bb, begin, mid, depth + 1, result); }
+    if (split <= bb_range.max) { range(bb, mid + 1, end, depth + 1, result); }
+}
+
+template <typename F, typename I>
+void KdTree<F, I>::radius(const Point2d<F>& q, F r, std::vector<I>& result) const
+{
+    result.clear();
+    if (empty() || r < F{0})
+        return;
+    F sq_radius = r * r;
+    auto func = [this, &q, &sq_radius, &result](std::size_t idx) {
+        if (details::spatial_index::sq_dist(q, m_points[idx]) <= sq_radius) { result.push_back(m_indices[idx]); }
+    };
+    visit(q, sq_radius, 0, m_points.size(), 0, func);
+}
+
+template <typename F, typename I>
+UniformGrid<F, I>::UniformGrid(stdutils::Span<const Point2d<F>> points)
+    : UniformGrid(stdutils::parallel::Policy{ 1 }, points)
+{
+}
+
+template <typename F, typename I>
+UniformGrid<F, I>::UniformGrid(const stdutils::parallel::Policy& policy, stdutils::Span<const Point2d<F>> points)
+    : m_origin(F{0}, F{0})
+    , m_cell_size(F{1})
+    , m_nb_cells_x(0)
+    , m_nb_cells_y(0)
+    , m_cell_offsets()
+    , m_points()
+    , m_indices()
+{
+    const std::size_t n = points.size();
+    if (n == 0)
+        return;
+    assert(n <= graphs::IndexTraits<I>::max_valid_index());
+
+    // Bounding box
+    std::vector<BoundingBox2d<F>> chunk_bbs(stdutils::parallel::nb_chunks(policy, n));
+    stdutils::parallel::for_each_chunk(policy, n, [&chunk_bbs, &points](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++) { chunk_bbs[chunk_idx].add(points[idx]); }
+    });
+    BoundingBox2d<F> bb;
+    for (const auto& chunk_bb : chunk_bbs) { bb.merge(chunk_bb); }
+
+    // Cells of CellOccupancy points on average. The grid degenerates to a row or a column if the points are aligned.
+    m_origin = bb.min();
+    const double width = static_cast<double>(bb.width());
+    const double height = static_cast<double>(bb.height());
+    const double nb_cells = std::max(1.0, static_cast<double>(n) / static_cast<double>(CellOccupancy));
+    double cell_size = std::max(width, height) / nb_cells;
+    if (width > 0.0 && height > 0.0)
+        cell_size = std::max(cell_size, std::sqrt(width * height / nb_cells));
+    if (!(cell_size > 0.0))
+        cell_size = 1.0;
+    m_cell_size = static_cast<F>(cell_size);
+    const auto axis_cells = [cell_size, nb_cells](double length) {
+        return static_cast<std::size_t>(std::min(std::floor(length / cell_size), nb_cells)) + 1;
+    };
+    m_nb_cells_x = axis_cells(width);
+    m_nb_cells_y = axis_cells(height);
+
+    // Counting sort of the points by cell
+    std::vector<std::size_t> cells(n);
+    stdutils::parallel::for_each_chunk(policy, n, [this, &cells, &points](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++) { cells[idx] = cell_y(points[idx].y) * m_nb_cells_x + cell_x(points[idx].x); }
+    });
+    m_cell_offsets.assign(m_nb_cells_x * m_nb_cells_y + 1, 0);
+    for (const auto c : cells) { m_cell_offsets[c + 1]++; }
+    for (std::size_t c = 1; c < m_cell_offsets.size(); c++) { m_cell_offsets[c] += m_cell_offsets[c - 1]; }
+    std::vector<std::size_t> cursor(m_cell_offsets.cbegin(), m_cell_offsets.cend() - 1);
+    m_points.resize(n);
+    m_indices.resize(n);
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        const std::size_t pos = cursor[cells[idx]]++;
+        m_points[pos] = points[idx];
+        m_indices[pos] = static_cast<I>(idx);
+    }
+}
+
+template <typename F, typename I>
+std::size_t UniformGrid<F, I>::cell_x(F x) const noexcept
+{
+    const F pos = std::floor((x - m_origin.x) / m_cell_size);
+    return pos <= F{0} ? 0 : std::min(static_cast<std::size_t>(pos), m_nb_cells_x - 1);
+}
+
+template <typename F, typename I>
+std::size_t UniformGrid<F, I>::cell_y(F y) const noexcept
+{
+    const F pos = std::floor((y - m_origin.y) / m_cell_size);
+    return pos <= F{0} ? 0 : std::min(static_cast<std::size_t>(pos), m_nb_cells_y - 1);
+}
+
+template <typename F, typename I>
+template <typename Func>
+void UniformGrid<F, I>::for_each_in_ring(std::size_t cx, std::size_t cy, std::size_t ring, Func func) const
+{
+    const auto visit_cell = [this, &func](std::size_t x, std::size_t y) {
+        const std::size_t c = y * m_nb_cells_x + x;
+        for (std::size_t idx = m_cell_offsets[c]; idx < m_cell_offsets[c + 1]; idx++) { func(idx); }
+    };
+    const std::size_t x_min = cx >= ring ? cx - ring : 0;
+    const std::size_t x_max = std::min(cx + ring, m_nb_cells_x - 1);
+    const std::size_t y_min = cy >= ring ? cy - ring : 0;
+    const std::size_t y_max = std::min(cy + ring, m_nb_cells_y - 1);
+    if (ring == 0)
+    {
+        visit_cell(cx, cy);
+        return;
+    }
+    // Bottom and top rows, then the left and right columns without the corners
+    for (std::size_t x = x_min; x <= x_max; x++)
+    {
+        if (cy >= ring) { visit_cell(x, cy - ring); }
+        if (cy + ring < m_nb_cells_y) { visit_cell(x, cy + ring); }
+    }
+    for (std::size_t y = y_min; y <= y_max; y++)
+    {
+        if ((cy >= ring && y == cy - ring) || y == cy + ring)
+            continue;
+        if (cx >= ring) { visit_cell(cx - ring, y); }
+        if (cx + ring < m_nb_cells_x) { visit_cell(cx + ring, y); }
+    }
+}
+
+template <typename F, typename I>
+template <typename Func>
+void UniformGrid<F, I>::visit_rings(const Point2d<F>& q, F& max_sq_dist, Func func) const
+{
+    // The points beyond ring r are at a distance of at least r * m_cell_size of q, even if q is outside of the grid
+    const std::size_t cx = cell_x(q.x);
+    const std::size_t cy = cell_y(q.y);
+    const std::size_t max_ring = std::max(m_nb_cells_x, m_nb_cells_y);
+    for (std::size_t ring = 0; ring < max_ring; ring++)
+    {
+        for_each_in_ring(cx, cy, ring, func);
+        const F ring_dist = static_cast<F>(ring) * m_cell_size;
+        if (max_sq_dist < ring_dist * ring_dist)
+            break;
+    }
+}
+
+template <typename F, typename I>
+I UniformGrid<F, I>::nearest(const Point2d<F>& q) const
+{
+    I best = graphs::IndexTraits<I>::undef();
+    F best_sq_dist = std::numeric_limits<F>::max();
+    if (!empty())
+    {
+        visit_rings(q, best_sq_dist, [this, &q, &best, &best_sq_dist](std::size_t idx) {
+            const F sq_dist = details::spatial_index::sq_dist(q, m_points[idx]);
+            if (sq_dist < best_sq_dist || (sq_dist == best_sq_dist && m_indices[idx] < best))
+            {
+                best = m_indices[idx];
+                best_sq_dist = sq_dist;
+            }
+        });
+    }
+    return best;
+}
+
+template <typename F, typename I>
+void UniformGrid<F, I>::k_nearest(const Point2d<F>& q, std::size_t k, std::vector<I>& result) const
+{
+    details::spatial_index::KBest<F, I> k_best(std::min(k, m_points.size()));
+    F bound = k_best.bound();
+    if (!empty() && k > 0)
+    {
+        visit_rings(q, bound, [this, &q, &k_best, &bound](std::size_t idx) {
+            k_best.push(details::spatial_index::sq_dist(q, m_points[idx]), m_indices[idx]);
+            bound = k_best.bound();
+        });
+    }
+    k_best.sorted_indices(result);
+}
+
+template <typename F, typename I>
+void UniformGrid<F, I>::range(const BoundingBox2d<F>& bb, std::vector<I>& result) const
+{
+    result.clear();
+    if (empty() || !bb.is_populated())
+        return;
+    const std::size_t x_max = cell_x(bb.rx.max);
+    const std::size_t y_max = cell_y(bb.ry.max);
+    for (std::size_t y = cell_y(bb.ry.min); y <= y_max; y++)
+    {
+        const std::size_t row = y * m_nb_cells_x;
+        for (std::size_t idx = m_cell_offsets[row + cell_x(bb.rx.min)]; idx < m_cell_offsets[row + x_max + 1]; idx++)
+        {
+            const auto& p = m_points[idx];
+            if (bb.rx.min <= p.x && p.x <= bb.rx.max && bb.ry.min <= p.y && p.y <= bb.ry.max) { result.push_back(m_indices[idx]); }
+        }
+    }
+}
+
+template <typename F, typename I>
+void UniformGrid<F, I>::radius(const Point2d<F>& q, F r, std::vector<I>& result) const
+{
+    result.clear();
+    if (empty() || r < F{0})
+        return;
+    BoundingBox2d<F> bb;
+    bb.add(q).add_border(r);
+    const F sq_radius = r * r;
+    const std::size_t x_max = cell_x(bb.rx.max);
+    const std::size_t y_max = cell_y(bb.ry.max);
+    for (std::size_t y = cell_y(bb.ry.min); y <= y_max; y++)
+    {
+        const std::size_t row = y * m_nb_cells_x;
+        for (std::size_t idx = m_cell_offsets[row + cell_x(bb.rx.min)]; idx < m_cell_offsets[row + x_max + 1]; idx++)
+        {
+            if (details::spatial_index::sq_dist(q, m_points[idx]) <= sq_radius) { result.push_back(m_indices[idx]); }
+        }
+    }
+}
+
+} // namespace shapes
@@ -5,6 +5,7 @@
 #include <graphs/index.h>
 #include <graphs/graph.h>
 #include <graphs/graph_algos.h>
+#include <graphs/triangulation.h>
 #include <shapes/point.h>
 
 #include <algorithm>
@@ -17,7 +18,7 @@ namespace shapes {
 /**
  * Triangles
  *
- * A triangle soup
+ * A triangle soup, with an optional adjacency array (empty if not available). See graphs/triangulation.h
  */
 template <typename P, typename I = std::uint32_t>
 struct Triangles
@@ -29,6 +30,7 @@ struct Triangles
     using face = graphs::Triangle<I>;
     std::vector<P> vertices;
     graphs::TriangleSoup<I> faces;
+    graphs::TriangleAdjacency<I> adjacency;
 };
 
 template <typename F, typename I = std::uint32_t>
@@ -41,15 +43,28 @@ template <typename P, typename I>
 bool is_valid(const Triangles<P, I>& triangles)
 {
     const I nb_vertices = static_cast<I>(triangles.vertices.size());
-    return std::all_of(std::cbegin(triangles.faces), std::cend(triangles.faces), [nb_vertices](const typename Triangles<P>::face& f) {
+    if (!triangles.adjacency.empty() && triangles.adjacency.size() != triangles.faces.size()) { return false; }
+    return std::all_of(std::cbegin(triangles.faces), std::cend(triangles.faces), [nb_vertices](const typename Triangles<P, I>::face& f) {
         return graphs::is_valid(f) && f[0] < nb_vertices && f[1] < nb_vertices && f[2] < nb_vertices;
     });
 }
 
+template <typename P, typename I>
+bool has_adjacency(const Triangles<P, I>& triangles)
+{
+    return !triangles.faces.empty() && triangles.adjacency.size() == triangles.faces.size();
+}
+
 template <typename P, typename I>
 std::size_t nb_edges(const Triangles<P, I>& triangles)
 {
     assert(is_valid(triangles));
+    if (has_adjacency(triangles))
+    {
+        std::size_t result = 0;
+        graphs::for_each_edge(triangles.faces, triangles.adjacency, [&result](const auto&, I, I) { result++; });
+        return result;
+    }
     return graphs::nb_edges(triangles.faces);
 }
 
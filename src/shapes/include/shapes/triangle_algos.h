@@ -3,13 +3,27 @@
 #pragma once
 
 #include <graphs/graph_algos.h>
+#include <graphs/index.h>
 #include <graphs/triangulation.h>
 #include <shapes/edge.h>
 #include <shapes/path.h>
+#include <shapes/point.h>
+#include <shapes/point_order.h>
 #include <shapes/triangle.h>
+#include <shapes/vect.h>
+#include <stdutils/parallel.h>
+#include <stdutils/profiler.h>
+#include <stdutils/span.h>
+#include <stdutils/stats.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
 #include <vector>
 
 namespace shapes {
@@ -20,6 +34,87 @@ std::vector<PointPath<P>> extract_borders(const Triangles<P, I>& triangles);
 template <typename P, typename I>
 Edges<P, I> extract_edges(const Triangles<P, I>& triangles);
 
+/**
+ * Renumbering of a triangulation along a space-filling curve
+ *
+ * The vertices are sorted along a Hilbert curve covering their bounding box (see hilbert_order), then the faces by their smallest vertex
+ * in that order, so that the passes over the faces that access their vertices, or their neighbors, have a good memory locality. The
+ * orientation of the faces and the order of their vertices are preserved, and so is the adjacency, if any, which is remapped.
+ *
+ * The permutations follow the convention of the spatial orders: The k-th vertex of the output is vertex_order[k] in the input, and
+ * the k-th face of the output is face_order[k] in the input.
+ */
+template <typename I = std::uint32_t>
+struct MeshPermutation
+{
+    std::vector<I> vertex_order;
+    std::vector<I> face_order;
+};
+
+template <typename F, typename I>
+MeshPermutation<I> renumber_along_hilbert_curve(Triangles2d<F, I>& triangles);
+
+/**
+ * Quality and size statistics of a triangulation, e.g. to compare the outputs of several algorithms
+ *
+ * The faces are processed in parallel chunks, whose cumulative statistics are then merged: The results have no median nor quantiles.
+ * If the triangulation has its adjacency, an edge shared by two faces is sampled once, otherwise once per face.
+ */
+template <typename F>
+struct TriangulationStats
+{
+    stdutils::stats::Result<F> min_angle;           // The smallest angle of each face, in degrees, in [0, 60]
+    stdutils::stats::Result<F> aspect_ratio;        // The circumradius over twice the inradius of each face: 1 for an equilateral triangle. Not sampled on the degenerate faces.
+    stdutils::stats::Result<F> area;
+    stdutils::stats::Result<F> edge_length;
+    std::size_t nb_degenerate_faces{0};             // Faces of zero area
+};
+
+template <typename F, typename I>
+TriangulationStats<F> triangulation_stats(const stdutils::parallel::Policy& policy, const Triangles2d<F, I>& triangles);
+
+/**
+ * Point location in a 2D triangulation, by jump-and-walk
+ *
+ * A query starts from the latest face found, or from the nearest of a sample of about n^(1/3) faces if it is closer to the point (the jump),
+ * then walks across the edges that separate the current face from the point, up to the face containing it (the visibility walk). The expected
+ * cost is O(n^(1/3)) on a Delaunay triangulation of evenly distributed points, and a few steps if the queries are close to each other.
+ *
+ * The walk needs the adjacency of the triangles. If the walk cannot reach the point, e.g. on a domain with holes or on a triangulation that
+ * is not Delaunay, the locator falls back to a linear scan of the faces. The faces may be oriented either way.
+ *
+ * The locator keeps a reference to the triangles, which must outlive it and not be modified.
+ */
+template <typename F, typename I = std::uint32_t>
+class TriangleLocator
+{
+public:
+    explicit TriangleLocator(const Triangles2d<F, I>& triangles);
+
+    // The index of a face containing p (boundary included), or IndexTraits<I>::undef() if p is outside of the triangulation
+    I locate(const Point2d<F>& p);
+
+    // The latest face found, or undef
+    I latest_face() const noexcept { return m_latest_face; }
+
+    // The number of faces visited by the latest query
+    std::size_t latest_nb_steps() const noexcept { return m_latest_nb_steps; }
+
+private:
+    F orientation(I f, std::uint8_t k, const Point2d<F>& p) const;
+    bool contains(I f, const Point2d<F>& p) const;
+    I jump(const Point2d<F>& p);
+    I walk(I f, const Point2d<F>& p);
+    I linear_scan(const Point2d<F>& p) const;
+
+    const Triangles2d<F, I>& m_triangles;
+    std::vector<F> m_face_orientation;                      // Sign of the area of each face, in {-1, 0, 1}
+    std::size_t m_nb_samples;
+    std::uint64_t m_rng_state;
+    I m_latest_face;
+    std::size_t m_latest_nb_steps;
+};
+
 
 //
 //
@@ -31,7 +126,7 @@ Edges<P, I> extract_edges(const Triangles<P, I>& triangles);
 template <typename P, typename I>
 std::vector<PointPath<P>> extract_borders(const Triangles<P, I>& triangles)
 {
-    const graphs::BordersAndInnerEdges<I> edges = graphs::extract_borders(triangles.faces);
+    const graphs::BordersAndInnerEdges<I> edges = has_adjacency(triangles) ? graphs::extract_borders(triangles.faces, triangles.adjacency) : graphs::extract_borders(triangles.faces);
 
     // EdgeSoup -> Paths
     const auto paths = graphs::extract_paths(edges.borders);
@@ -53,9 +148,296 @@ template <typename P, typename I>
 Edges<P, I> extract_edges(const Triangles<P, I>& triangles)
 {
     Edges<P, I> result;
-    result.indices = graphs::to_edge_soup<I>(triangles.faces);
+    result.indices = has_adjacency(triangles) ? graphs::to_edge_soup<I>(triangles.faces, triangles.adjacency) : graphs::to_edge_soup<I>(triangles.faces);
     result.vertices = triangles.vertices;
     return result;
 }
 
+template <typename F, typename I>
+MeshPermutation<I> renumber_along_hilbert_curve(Triangles2d<F, I>& triangles)
+{
+    assert(is_valid(triangles));
+    MeshPermutation<I> result;
+    const std::size_t nb_vertices = triangles.vertices.size();
+    const std::size_t nb_faces = triangles.faces.size();
+    if (nb_vertices == 0)
+        return result;
+
+    // Vertices
+    result.vertex_order = hilbert_order<I>(stdutils::make_const_span(triangles.vertices));
+    assert(result.vertex_order.size() == nb_vertices);
+    std::vector<I> new_vertex_index(nb_vertices);
+    Points2d<F> vertices;
+    vertices.reserve(nb_vertices);
+    for (std::size_t idx = 0; idx < nb_vertices; idx++)
+    {
+        const auto old_idx = static_cast<std::size_t>(result.vertex_order[idx]);
+        new_vertex_index[old_idx] = static_cast<I>(idx);
+        vertices.push_back(triangles.vertices[old_idx]);
+    }
+    triangles.vertices = std::move(vertices);
+    for (auto& face : triangles.faces)
+    {
+        for (std::size_t k = 0; k < 3; k++) { face[k] = new_vertex_index[static_cast<std::size_t>(face[k])]; }
+    }
+
+    // Faces: Counting sort by smallest vertex
+    std::vector<std::size_t> bucket_begin(nb_vertices + 1, 0);
+    const auto min_vertex = [](const graphs::Triangle<I>& face) { return static_cast<std::size_t>(std::min({ face[0], face[1], face[2] })); };
+    for (const auto& face : triangles.faces) { bucket_begin[min_vertex(face) + 1]++; }
+    std::partial_sum(bucket_begin.cbegin(), bucket_begin.cend(), bucket_begin.begin());
+    result.face_order.resize(nb_faces);
+    for (std::size_t face_idx = 0; face_idx < nb_faces; face_idx++)
+    {
+        result.face_order[bucket_begin[min_vertex(triangles.faces[face_idx])]++] = static_cast<I>(face_idx);
+    }
+    graphs::TriangleSoup<I> faces;
+    faces.reserve(nb_faces);
+    for (const I old_face : result.face_order) { faces.push_back(triangles.faces[static_cast<std::size_t>(old_face)]); }
+    triangles.faces = std::move(faces);
+
+    // Adjacency
+    if (!triangles.adjacency.empty())
+    {
+        assert(triangles.adjacency.size() == nb_faces);
+        std::vector<I> new_face_index(nb_faces);
+        for (std::size_t idx = 0; idx < nb_faces; idx++) { new_face_index[static_cast<std::size_t>(result.face_order[idx])] = static_cast<I>(idx); }
+        graphs::TriangleAdjacency<I> adjacency;
+        adjacency.reserve(nb_faces);
+        for (const I old_face : result.face_order)
+        {
+            auto& neighbors = adjacency.emplace_back(triangles.adjacency[static_cast<std::size_t>(old_face)]);
+            for (auto& neighbor : neighbors)
+            {
+                if (graphs::is_defined(neighbor)) { neighbor = new_face_index[static_cast<std::size_t>(neighbor)]; }
+            }
+        }
+        triangles.adjacency = std::move(adjacency);
+    }
+    return result;
+}
+
+namespace details {
+namespace stats {
+
+template <typename F>
+struct CumulTriangulationStats
+{
+    stdutils::stats::CumulSamples<F> min_angle;
+    stdutils::stats::CumulSamples<F> aspect_ratio;
+    stdutils::stats::CumulSamples<F> area;
+    stdutils::stats::CumulSamples<F> edge_length;
+    std::size_t nb_degenerate_faces{0};
+};
+
+} // namespace stats
+} // namespace details
+
+template <typename F, typename I>
+TriangulationStats<F> triangulation_stats(const stdutils::parallel::Policy& policy, const Triangles2d<F, I>& triangles)
+{
+    STDUTILS_PROFILE_ZONE("triangle_algos::triangulation_stats");
+    constexpr F rad_to_deg = F{180} / static_cast<F>(3.14159265358979323846);
+    const std::size_t nb_faces = triangles.faces.size();
+    const bool with_adjacency = has_adjacency(triangles);
+    std::vector<details::stats::CumulTriangulationStats<F>> chunk_stats(stdutils::parallel::nb_chunks(policy, nb_faces));
+    stdutils::parallel::for_each_chunk(policy, nb_faces, [&triangles, &chunk_stats, with_adjacency, rad_to_deg](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+        auto& stats = chunk_stats[chunk_idx];
+        for (std::size_t f = begin_idx; f < end_idx; f++)
+        {
+            const auto& face = triangles.faces[f];
+            std::array<Vect2d<F>, 3> edges;         // Edge k goes from face[k] to face[(k+1)%3]
+            std::array<F, 3> lengths;
+            for (std::uint8_t k = 0; k < 3; k++)
+            {
+                edges[k] = triangles.vertices[face[static_cast<std::size_t>((k + 1) % 3)]] - triangles.vertices[face[k]];
+                lengths[k] = norm(edges[k]);
+            }
+            const F twice_area = std::abs(cross_product(edges[0], edges[2]));
+            stats.area.add_sample(twice_area / F{2});
+            if (twice_area > F{0})
+            {
+                // The angle at vertex k is between the edges k and k-1
+                F min_angle = std::atan2(twice_area, -dot(edges[0], edges[2]));
+                min_angle = std::min(min_angle, std::atan2(twice_area, -dot(edges[1], edges[0])));
+                min_angle = std::min(min_angle, std::atan2(twice_area, -dot(edges[2], edges[1])));
+                stats.min_angle.add_sample(min_angle * rad_to_deg);
+                const F perimeter = lengths[0] + lengths[1] + lengths[2];
+                stats.aspect_ratio.add_sample(lengths[0] * lengths[1] * lengths[2] * perimeter / (F{4} * twice_area * twice_area));
+            }
+            else
+            {
+                stats.min_angle.add_sample(F{0});
+                stats.nb_degenerate_faces++;
+            }
+            for (std::uint8_t k = 0; k < 3; k++)
+            {
+                // Same convention as graphs::for_each_edge(): An interior edge is sampled from the face with the lowest index
+                const I n = with_adjacency ? triangles.adjacency[f][k] : graphs::IndexTraits<I>::undef();
+                if (!graphs::is_defined(n) || f < static_cast<std::size_t>(n)) { stats.edge_length.add_sample(lengths[k]); }
+            }
+        }
+    });
+    details::stats::CumulTriangulationStats<F> stats;
+    for (const auto& partial_stats : chunk_stats)
+    {
+        stats.min_angle += partial_stats.min_angle;
+        stats.aspect_ratio += partial_stats.aspect_ratio;
+        stats.area += partial_stats.area;
+        stats.edge_length += partial_stats.edge_length;
+        stats.nb_degenerate_faces += partial_stats.nb_degenerate_faces;
+    }
+    TriangulationStats<F> result;
+    result.min_angle = stats.min_angle.get_result();
+    result.aspect_ratio = stats.aspect_ratio.get_result();
+    result.area = stats.area.get_result();
+    result.edge_length = stats.edge_length.get_result();
+    result.nb_degenerate_faces = stats.nb_degenerate_faces;
+    return result;
+}
+
+namespace details {
+namespace locator {
+
+template <typename F>
+F orient(const Point2d<F>& a, const Point2d<F>& b, const Point2d<F>& c)
+{
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+template <typename F>
+F sq_dist(const Point2d<F>& a, const Point2d<F>& b)
+{
+    return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y);
+}
+
+// SplitMix64
+inline std::uint64_t next_random(std::uint64_t& state)
+{
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+} // namespace locator
+} // namespace details
+
+template <typename F, typename I>
+TriangleLocator<F, I>::TriangleLocator(const Triangles2d<F, I>& triangles)
+    : m_triangles(triangles)
+    , m_face_orientation()
+    , m_nb_samples(0)
+    , m_rng_state(0x2545f4914f6cdd1dull)
+    , m_latest_face(graphs::IndexTraits<I>::undef())
+    , m_latest_nb_steps(0)
+{
+    assert(is_valid(triangles));
+    assert(triangles.faces.empty() || has_adjacency(triangles));
+    const auto& faces = triangles.faces;
+    m_face_orientation.reserve(faces.size());
+    for (const auto& t : faces)
+    {
+        const F o = details::locator::orient(triangles.vertices[t[0]], triangles.vertices[t[1]], triangles.vertices[t[2]]);
+        m_face_orientation.push_back(o > F{0} ? F{1} : (o < F{0} ? F{-1} : F{0}));
+    }
+    m_nb_samples = static_cast<std::size_t>(std::cbrt(static_cast<double>(faces.size())));
+}
+
+template <typename F, typename I>
+F TriangleLocator<F, I>::orientation(I f, std::uint8_t k, const Point2d<F>& p) const
+{
+    // Positive if p is on the inner side of edge k of face f
+    const auto& t = m_triangles.faces[f];
+    const auto& a = m_triangles.vertices[t[k]];
+    const auto& b = m_triangles.vertices[t[(k + 1u) % 3u]];
+    return m_face_orientation[f] * details::locator::orient(a, b, p);
+}
+
+template <typename F, typename I>
+bool TriangleLocator<F, I>::contains(I f, const Point2d<F>& p) const
+{
+    return m_face_orientation[f] != F{0} && orientation(f, 0, p) >= F{0} && orientation(f, 1, p) >= F{0} && orientation(f, 2, p) >= F{0};
+}
+
+template <typename F, typename I>
+I TriangleLocator<F, I>::jump(const Point2d<F>& p)
+{
+    const auto& faces = m_triangles.faces;
+    const auto& vertices = m_triangles.vertices;
+    I best_face = m_latest_face;
+    F best_sq_dist = graphs::is_defined(best_face) ? details::locator::sq_dist(vertices[faces[best_face][0]], p) : F{0};
+    for (std::size_t sample = 0; sample < m_nb_samples; sample++)
+    {
+        const auto f = static_cast<I>(details::locator::next_random(m_rng_state) % faces.size());
+        const F sq_dist = details::locator::sq_dist(vertices[faces[f][0]], p);
+        if (!graphs::is_defined(best_face) || sq_dist < best_sq_dist)
+        {
+            best_face = f;
+            best_sq_dist = sq_dist;
+        }
+    }
+    return graphs::is_defined(best_face) ? best_face : I{0};
+}
+
+template <typename F, typename I>
+I TriangleLocator<F, I>::walk(I f, const Point2d<F>& p)
+{
+    // The visibility walk may cycle on a triangulation that is not Delaunay: The edges are tested from a random one, and the walk is bounded
+    const std::size_t max_nb_steps = 3 * m_triangles.faces.size() + 3;
+    I prev = graphs::IndexTraits<I>::undef();
+    for (m_latest_nb_steps = 1; m_latest_nb_steps <= max_nb_steps; m_latest_nb_steps++)
+    {
+        if (m_face_orientation[f] == F{0})
+            return graphs::IndexTraits<I>::undef();
+        const auto first_k = static_cast<std::uint8_t>(details::locator::next_random(m_rng_state) % 3);
+        I next = f;
+        for (std::uint8_t i = 0; i < 3; i++)
+        {
+            const auto k = static_cast<std::uint8_t>((first_k + i) % 3);
+            const I n = m_triangles.adjacency[f][k];
+            if ((graphs::is_defined(n) && n == prev) || orientation(f, k, p) >= F{0})
+                continue;
+            next = n;
+            break;
+        }
+        if (next == f)
+        {
+            // No edge separates f from p, except maybe the one we came from
+            return contains(f, p) ? f : graphs::IndexTraits<I>::undef();
+        }
+        if (!graphs::is_defined(next))
+            return graphs::IndexTraits<I>::undef();         // Crossing a border of the triangulation
+        prev = f;
+        f = next;
+    }
+    return graphs::IndexTraits<I>::undef();
+}
+
+template <typename F, typename I>
+I TriangleLocator<F, I>::linear_scan(const Point2d<F>& p) const
+{
+    for (std::size_t f = 0; f < m_triangles.faces.size(); f++)
+    {
+        if (contains(static_cast<I>(f), p)) { return static_cast<I>(f); }
+    }
+    return graphs::IndexTraits<I>::undef();
+}
+
+template <typename F, typename I>
+I TriangleLocator<F, I>::locate(const Point2d<F>& p)
+{
+    m_latest_nb_steps = 0;
+    if (m_triangles.faces.empty())
+        return graphs::IndexTraits<I>::undef();
+    I f = walk(jump(p), p);
+    if (!graphs::is_defined(f))
+    {
+        m_latest_nb_steps += m_triangles.faces.size();
+        f = linear_scan(p);
+    }
+    if (graphs::is_defined(f)) { m_latest_face = f; }
+    return f;
+}
+
 } // namespace shapes
@@ -0,0 +1,143 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <graphs/graph.h>
+#include <shapes/bounding_box.h>
+#include <shapes/point.h>
+#include <stdutils/span.h>
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace shapes {
+
+/**
+ * Batch operations on arrays of 2D vectors
+ *
+ * The loops run over contiguous memory, without branches nor calls, so that the compiler vectorizes them for the target instruction set
+ * (SSE/AVX on x86-64, NEON on ARM) with the usual optimization flags. There are no intrinsics, hence no scalar fallback to maintain.
+ * The output spans must have the same size as the input.
+ */
+
+template <typename F>
+void sq_norms(stdutils::Span<const Vect2d<F>> vects, stdutils::Span<F> out);
+
+template <typename F>
+void norms(stdutils::Span<const Vect2d<F>> vects, stdutils::Span<F> out);
+
+// Squared length of each edge
+template <typename F, typename I>
+void sq_distances(stdutils::Span<const Point2d<F>> points, stdutils::Span<const graphs::Edge<I>> edges, stdutils::Span<F> out);
+
+template <typename F>
+BoundingBox2d<F> bounding_box(stdutils::Span<const Point2d<F>> points);
+
+// out[i] = (scale.x * points[i].x + translation.x, scale.y * points[i].y + translation.y), converted to type T. In-place is allowed.
+template <typename F, typename T = F>
+void affine_transform(stdutils::Span<const Point2d<F>> points, const Vect2d<F>& scale, const Vect2d<F>& translation, stdutils::Span<Point2d<T>> out);
+
+
+//
+//
+// Implementation
+//
+//
+
+
+template <typename F>
+void sq_norms(stdutils::Span<const Vect2d<F>> vects, stdutils::Span<F> out)
+{
+    assert(out.size() == vects.size());
+    const std::size_t n = vects.size();
+    const Vect2d<F>* in_ptr = vects.data();
+    F* out_ptr = out.data();
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        out_ptr[idx] = in_ptr[idx].x * in_ptr[idx].x + in_ptr[idx].y * in_ptr[idx].y;
+    }
+}
+
+template <typename F>
+void norms(stdutils::Span<const Vect2d<F>> vects, stdutils::Span<F> out)
+{
+    sq_norms(vects, out);
+    const std::size_t n = out.size();
+    F* out_ptr = out.data();
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        out_ptr[idx] = std::sqrt(out_ptr[idx]);
+    }
+}
+
+template <typename F, typename I>
+void sq_distances(stdutils::Span<const Point2d<F>> points, stdutils::Span<const graphs::Edge<I>> edges, stdutils::Span<F> out)
+{
+    assert(out.size() == edges.size());
+    const std::size_t n = edges.size();
+    const Point2d<F>* pts = points.data();
+    const graphs::Edge<I>* edge_ptr = edges.data();
+    F* out_ptr = out.data();
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        const auto& p = pts[edge_ptr[idx].orig()];
+        const auto& q = pts[edge_ptr[idx].dest()];
+        const F dx = q.x - p.x;
+        const F dy = q.y - p.y;
+        out_ptr[idx] = dx * dx + dy * dy;
+    }
+}
+
+template <typename F>
+BoundingBox2d<F> bounding_box(stdutils::Span<const Point2d<F>> points)
+{
+    // One pass with four independent accumulators. NB: The compilers only turn these min/max reductions into packed instructions
+    // if they are allowed to ignore NaNs (e.g. GCC with -ffinite-math-only and -fno-signed-zeros), otherwise the loop remains scalar.
+    constexpr F inf = std::numeric_limits<F>::infinity();
+    F min_x = inf;
+    F min_y = inf;
+    F max_x = -inf;
+    F max_y = -inf;
+    const std::size_t n = points.size();
+    const Point2d<F>* pts = points.data();
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        const F x = pts[idx].x;
+        const F y = pts[idx].y;
+        min_x = x < min_x ? x : min_x;
+        min_y = y < min_y ? y : min_y;
+        max_x = x > max_x ? x : max_x;
+        max_y = y > max_y ? y : max_y;
+    }
+    BoundingBox2d<F> result;
+    if (n > 0)
+    {
+        result.add(min_x, min_y);
+        result.add(max_x, max_y);
+    }
+    return result;
+}
+
+template <typename F, typename T>
+void affine_transform(stdutils::Span<const Point2d<F>> points, const Vect2d<F>& scale, const Vect2d<F>& translation, stdutils::Span<Point2d<T>> out)
+{
+    assert(out.size() == points.size());
+    const std::size_t n = points.size();
+    const Point2d<F>* in_ptr = points.data();
+    Point2d<T>* out_ptr = out.data();
+    const F sx = scale.x;
+    const F sy = scale.y;
+    const F tx = translation.x;
+    const F ty = translation.y;
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        const F x = sx * in_ptr[idx].x + tx;
+        const F y = sy * in_ptr[idx].y + ty;
+        out_ptr[idx].x = static_cast<T>(x);
+        out_ptr[idx].y = static_cast<T>(y);
+    }
+}
+
+} // namespace shapes
@@ -0,0 +1,240 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <graphs/graph.h>
+#include <graphs/index.h>
+#include <shapes/bounding_box.h>
+#include <shapes/edge.h>
+#include <shapes/point.h>
+#include <shapes/triangle.h>
+#include <stdutils/parallel.h>
+#include <stdutils/profiler.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace shapes {
+
+/**
+ * Voronoi diagram, the dual of a Delaunay triangulation
+ *
+ * The Voronoi vertices are the circumcenters of the faces, and there is one Voronoi edge per edge of the triangulation: It joins the
+ * circumcenters of the two faces sharing the edge, or it is a ray from the circumcenter of a face on the convex hull, cast outwards and
+ * perpendicularly to the border edge. The diagram is clipped to a bounding box, which cuts the rays and the edges crossing its border.
+ *
+ * The edges are listed with the two sites they separate, i.e. the Voronoi cells of sites[e].orig() and sites[e].dest() are adjacent along
+ * the edge edges.indices[e]. The vertices are those inside the clipping box, followed by the points where the edges are clipped.
+ *
+ * The diagram is derived in O(n) from the adjacency of the triangles, and the circumcenters and the clipping are computed concurrently.
+ * The input should be a Delaunay triangulation of the sites: On any other triangulation the result is the dual graph, not a Voronoi diagram.
+ * The degenerate faces are skipped.
+ */
+template <typename F, typename I = std::uint32_t>
+struct VoronoiDiagram
+{
+    Edges2d<F, I> edges;
+    graphs::EdgeSoup<I> sites;
+};
+
+template <typename F, typename I = std::uint32_t>
+VoronoiDiagram<F, I> voronoi_diagram(const Triangles2d<F, I>& triangles, const BoundingBox2d<F>& clip_box);
+template <typename F, typename I = std::uint32_t>
+VoronoiDiagram<F, I> voronoi_diagram(const stdutils::parallel::Policy& policy, const Triangles2d<F, I>& triangles, const BoundingBox2d<F>& clip_box);
+
+
+//
+//
+// Implementation
+//
+//
+
+
+namespace details {
+namespace voronoi {
+
+// Return false if the triangle is degenerate
+template <typename F>
+bool circumcenter(const Point2d<F>& a, const Point2d<F>& b, const Point2d<F>& c, Point2d<F>& center)
+{
+    const F bx = b.x - a.x, by = b.y - a.y;
+    const F cx = c.x - a.x, cy = c.y - a.y;
+    const F d = F{2} * (bx * cy - by * cx);
+    if (d == F{0})
+        return false;
+    const F b_sq = bx * bx + by * by;
+    const F c_sq = cx * cx + cy * cy;
+    center.x = a.x + (cy * b_sq - by * c_sq) / d;
+    center.y = a.y + (bx * c_sq - cx * b_sq) / d;
+    return true;
+}
+
+// Liang-Barsky: Clip the parameter range [t0, t1] of p + t * dir to the box. Return false if the clipped range is empty.
+template <typename F>
+bool clip(const BoundingBox2d<F>& box, const Point2d<F>& p, const Vect2d<F>& dir, F& t0, F& t1)
+{
+    const auto clip_1d = [&t0, &t1](F q, F d, F min, F max) {
+        if (d == F{0})
+            return min <= q && q <= max;
+        F ta = (min - q) / d;
+        F tb = (max - q) / d;
+        if (ta > tb) { std::swap(ta, tb); }
+        t0 = std::max(t0, ta);
+        t1 = std::min(t1, tb);
+        return t0 <= t1;
+    };
+    return clip_1d(p.x, dir.x, box.rx.min, box.rx.max) && clip_1d(p.y, dir.y, box.ry.min, box.ry.max);
+}
+
+// The point at parameter t of a clipped line, which is on the border of the box up to the rounding errors
+template <typename F>
+Point2d<F> clamp(const BoundingBox2d<F>& box, const Point2d<F>& p, const Vect2d<F>& dir, F t)
+{
+    return Point2d<F>(std::clamp(p.x + t * dir.x, box.rx.min, box.rx.max), std::clamp(p.y + t * dir.y, box.ry.min, box.ry.max));
+}
+
+template <typename F, typename I>
+struct ClippedEdge
+{
+    Point2d<F> a;
+    Point2d<F> b;
+    I face_a;               // The face whose circumcenter is endpoint a, or undef if a was clipped
+    I face_b;               // Idem for b
+    graphs::Edge<I> sites;
+    bool is_empty;          // Out of the clipping box
+};
+
+} // namespace voronoi
+} // namespace details
+
+template <typename F, typename I>
+VoronoiDiagram<F, I> voronoi_diagram(const Triangles2d<F, I>& triangles, const BoundingBox2d<F>& clip_box)
+{
+    return voronoi_diagram<F, I>(stdutils::parallel::Policy{ 1 }, triangles, clip_box);
+}
+
+template <typename F, typename I>
+VoronoiDiagram<F, I> voronoi_diagram(const stdutils::parallel::Policy& policy, const Triangles2d<F, I>& triangles, const BoundingBox2d<F>& clip_box)
+{
+    STDUTILS_PROFILE_ZONE("voronoi::voronoi_diagram");
+    using ClippedEdge = details::voronoi::ClippedEdge<F, I>;
+    constexpr I Undef = graphs::IndexTraits<I>::undef();
+    assert(is_valid(triangles));
+    VoronoiDiagram<F, I> result;
+    if (!has_adjacency(triangles) || !clip_box.is_populated())
+        return result;
+    const auto& faces = triangles.faces;
+    const auto& vertices = triangles.vertices;
+    const std::size_t nb_faces = faces.size();
+
+    // Voronoi vertices
+    std::vector<Point2d<F>> centers(nb_faces);
+    std::vector<std::uint8_t> is_valid_center(nb_faces, 0);
+    stdutils::parallel::for_each_chunk(policy, nb_faces, [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t f = begin_idx; f < end_idx; f++)
+        {
+            const auto& t = faces[f];
+            is_valid_center[f] = details::voronoi::circumcenter(vertices[t[0]], vertices[t[1]], vertices[t[2]], centers[f]) ? 1 : 0;
+        }
+    });
+
+    // Voronoi edges: Each edge of the triangulation is owned by the face with the lower index, or by its only face on the border
+    const auto is_owner = [&triangles](std::size_t f, std::uint8_t k) {
+        const I n = triangles.adjacency[f][k];
+        return !graphs::is_defined(n) || static_cast<std::size_t>(n) > f;
+    };
+    std::vector<std::size_t> offsets(nb_faces + 1, 0);
+    for (std::size_t f = 0; f < nb_faces; f++)
+    {
+        std::size_t nb = 0;
+        for (std::uint8_t k = 0; k < 3; k++) { if (is_owner(f, k)) { nb++; } }
+        offsets[f + 1] = offsets[f] + nb;
+    }
+    std::vector<ClippedEdge> clipped_edges(offsets.back());
+    stdutils::parallel::for_each_chunk(policy, nb_faces, [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t f = begin_idx; f < end_idx; f++)
+        {
+            std::size_t out_idx = offsets[f];
+            for (std::uint8_t k = 0; k < 3; k++)
+            {
+                if (!is_owner(f, k))
+                    continue;
+                auto& edge = clipped_edges[out_idx++];
+                const auto& t = faces[f];
+                const I n = triangles.adjacency[f][k];
+                edge.sites = graphs::Edge<I>(t[k], t[(k + 1u) % 3u]);
+                edge.is_empty = true;
+                if (!is_valid_center[f] || (graphs::is_defined(n) && !is_valid_center[n]))
+                    continue;
+                const Point2d<F>& p = centers[f];
+                Vect2d<F> dir;
+                F t0 = F{0};
+                F t1 = F{1};
+                if (graphs::is_defined(n))
+                {
+                    dir = centers[n] - p;
+                }
+                else
+                {
+                    // Ray perpendicular to the border edge, away from the opposite vertex
+                    const auto& a = vertices[t[k]];
+                    const auto& b = vertices[t[(k + 1u) % 3u]];
+                    const auto& c = vertices[t[(k + 2u) % 3u]];
+                    dir = Vect2d<F>(b.y - a.y, a.x - b.x);
+                    if (dir.x * (c.x - a.x) + dir.y * (c.y - a.y) > F{0}) { dir = Vect2d<F>(-dir.x, -dir.y); }
+                    t1 = std::numeric_limits<F>::max();
+                }
+                if (!details::voronoi::clip(clip_box, p, dir, t0, t1))
+                    continue;
+                edge.is_empty = false;
+                edge.a = t0 == F{0} ? p : details::voronoi::clamp(clip_box, p, dir, t0);
+                edge.b = graphs::is_defined(n) && t1 == F{1} ? centers[n] : details::voronoi::clamp(clip_box, p, dir, t1);
+                edge.face_a = t0 == F{0} ? static_cast<I>(f) : Undef;
+                edge.face_b = graphs::is_defined(n) && t1 == F{1} ? n : Undef;
+            }
+        }
+    });
+
+    // Number the vertices inside the clipping box first, then the clipped endpoints
+    std::vector<I> vertex_of_face(nb_faces, Undef);
+    auto& out_vertices = result.edges.vertices;
+    for (const auto& edge : clipped_edges)
+    {
+        if (edge.is_empty)
+            continue;
+        for (const I f : { edge.face_a, edge.face_b })
+        {
+            if (graphs::is_defined(f) && !graphs::is_defined(vertex_of_face[f]))
+            {
+                vertex_of_face[f] = static_cast<I>(out_vertices.size());
+                out_vertices.push_back(centers[f]);
+            }
+        }
+    }
+    result.edges.indices.reserve(clipped_edges.size());
+    result.sites.reserve(clipped_edges.size());
+    for (const auto& edge : clipped_edges)
+    {
+        if (edge.is_empty)
+            continue;
+        const auto endpoint = [&out_vertices, &vertex_of_face](I f, const Point2d<F>& p) {
+            if (graphs::is_defined(f))
+                return vertex_of_face[f];
+            out_vertices.push_back(p);
+            return static_cast<I>(out_vertices.size() - 1);
+        };
+        const I a = endpoint(edge.face_a, edge.a);
+        const I b = endpoint(edge.face_b, edge.b);
+        if (a == b)
+            continue;                                       // Two neighbor faces sharing the same circumcenter
+        result.edges.indices.emplace_back(a, b);
+        result.sites.push_back(edge.sites);
+    }
+    return result;
+}
+
+} // namespace shapes
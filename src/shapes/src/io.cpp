@@ -4,24 +4,49 @@
 
 #include <shapes/traits.h>
 #include <stdutils/io.h>
+#include <stdutils/mapped_file.h>
 #include <stdutils/macros.h>
+#include <stdutils/profiler.h>
 #include <stdutils/string.h>
 
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <charconv>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iterator>
 #include <istream>
-#include <map>
+#include <limits>
 #include <numeric>
+#include <ostream>
 #include <set>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
 #include <type_traits>
 #include <vector>
 
+// Floating-point std::from_chars is not available on all the supported platforms (e.g. macOS 10.15)
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define SHAPES_IO_FP_FROM_CHARS 1
+#else
+#define SHAPES_IO_FP_FROM_CHARS 0
+#endif
+
+// Idem for the floating-point std::to_chars
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define SHAPES_IO_FP_TO_CHARS 1
+#else
+#define SHAPES_IO_FP_TO_CHARS 0
+#include <cstdio>
+#endif
+
 namespace shapes {
 namespace io {
 
@@ -51,19 +76,59 @@ typename shapes::Traits<F, POINT_DIM>::Point to_point(const typename NumericLine
     }
 }
 
+const char* skip_spaces(const char* first, const char* last)
+{
+    while (first != last && stdutils::ascii::isspace(*first)) { first++; }
+    return first;
+}
+
+// Parse a number at the beginning of the range [first, last). On success, first is advanced past the number.
+// Like std::istream, accept a leading '+'.
+template <typename T>
+bool parse_number(const char*& first, const char* last, T& value)
+{
+    static_assert(std::is_arithmetic_v<T>);
+    const char* ptr = first;
+    if (ptr != last && *ptr == '+') { ptr++; }
+    if constexpr (std::is_integral_v<T> || SHAPES_IO_FP_FROM_CHARS)
+    {
+        const auto [end_ptr, ec] = std::from_chars(ptr, last, value);
+        if (ec != std::errc()) { return false; }
+        first = end_ptr;
+        return true;
+    }
+    else
+    {
+        // std::strtod needs a null-terminated string
+        constexpr std::size_t MAX_TOKEN_LEN = 63;
+        std::array<char, MAX_TOKEN_LEN + 1> token;
+        std::size_t len = 0;
+        while (ptr + len != last && len < MAX_TOKEN_LEN && !stdutils::ascii::isspace(ptr[len])) { token[len] = ptr[len]; len++; }
+        token[len] = '\0';
+        char* end_ptr = nullptr;
+        const auto parsed = std::strtod(token.data(), &end_ptr);
+        if (end_ptr == token.data()) { return false; }
+        value = static_cast<T>(parsed);
+        first = ptr + (end_ptr - token.data());
+        return true;
+    }
+}
+
+// Parse up to MAX_DIM whitespace-separated numbers, stopping at the first token that is not a number
 template <typename T, std::size_t MAX_DIM>
-bool parse_numeric_line(const std::string& line, NumericLineBuffer<T, MAX_DIM>& buffer, T default_val = T{0})
+bool parse_numeric_line(std::string_view line, NumericLineBuffer<T, MAX_DIM>& buffer, T default_val = T{0})
 {
-    std::istringstream line_stream(line);
-    std::istream_iterator<T> numeric_stream(line_stream);
-    const std::istream_iterator<T> stream_end;
     typename NumericLineBuffer<T, MAX_DIM>::Entry entry;
     entry.fill(default_val);
     unsigned int idx = 0;
-    while(numeric_stream != stream_end && idx < MAX_DIM)
+    const char* ptr = line.data();
+    const char* const last = line.data() + line.size();
+    while (idx < MAX_DIM)
     {
-        entry[idx] = *numeric_stream++;
-        idx++;      // postincrement outside of the previous expression due to a warning C28020 false positive
+        ptr = skip_spaces(ptr, last);
+        if (!parse_number(ptr, last, entry[idx])) { break; }
+        idx++;
+        if (ptr != last && !stdutils::ascii::isspace(*ptr)) { break; }     // The number is followed by garbage
     }
     if (idx > 0)
     {
@@ -77,20 +142,21 @@ bool parse_numeric_line(const std::string& line, NumericLineBuffer<T, MAX_DIM>&
 class TokenIterator
 {
 public:
-    using str_iterator = std::istream_iterator<std::string>;
-    TokenIterator(const std::string& line)
-        : m_str_stream(line)
-        , m_str_iterator(m_str_stream)
+    TokenIterator(std::string_view line)
+        : m_ptr(line.data())
+        , m_last(line.data() + line.size())
     {}
 
     std::string next_token()
     {
-        static const str_iterator stream_end;
-        return (m_str_iterator != stream_end) ? *m_str_iterator++ : "";
+        m_ptr = skip_spaces(m_ptr, m_last);
+        const char* token_begin = m_ptr;
+        while (m_ptr != m_last && !stdutils::ascii::isspace(*m_ptr)) { m_ptr++; }
+        return std::string(token_begin, m_ptr);
     }
 private:
-    std::istringstream  m_str_stream;
-    str_iterator        m_str_iterator;
+    const char* m_ptr;
+    const char* m_last;
 };
 
 enum class ShapeType
@@ -128,29 +194,187 @@ void append_vertices(Points3d<F>& target, const NumericLineBuffer<F, MAX_DIM>& s
     for (const auto& arr: source.lines) { target.emplace_back(arr[0], arr[1], arr[2]); }
 }
 
+// Deduplicate points with an open addressing hash table (linear probing) of their indices, keyed on the coordinates.
+// Like the comparison with shapes::less, -0.0 and +0.0 are considered equal. The first occurrence is kept.
 template <typename P, typename I>
 class UniquePoints
 {
 public:
+    // The expected size is a hint of the number of points that will be added
+    explicit UniquePoints(std::size_t expected_size = 0)
+        : m_points()
+        , m_slots()
+        , m_mask(0)
+    {
+        m_points.reserve(expected_size);
+        rehash(slot_count(expected_size));
+    }
+
     I add(const P& point)
     {
-        const I next_idx = static_cast<I>(m_unique_points.size());
-        const auto [elt_it, inserted] = m_unique_points.try_emplace(point, next_idx);
-        UNUSED(inserted);
-        assert(elt_it != m_unique_points.end());
-        return elt_it->second;
+        std::size_t slot = hash(point) & m_mask;
+        while (m_slots[slot] != EMPTY_SLOT)
+        {
+            if (m_points[m_slots[slot]] == point) { return m_slots[slot]; }
+            slot = (slot + 1) & m_mask;
+        }
+        const I next_idx = static_cast<I>(m_points.size());
+        assert(next_idx != EMPTY_SLOT);
+        m_slots[slot] = next_idx;
+        m_points.push_back(point);
+        if (2 * m_points.size() > m_slots.size()) { rehash(2 * m_slots.size()); }
+        return next_idx;
     }
 
     // Dump all points in insertion order
-    std::vector<P> dump_points() const {
-        std::vector<P> result(m_unique_points.size());
-        for (const auto& [point, idx] : m_unique_points) { result[idx] = point; }
-        return result;
+    std::vector<P> dump_points()
+    {
+        m_slots.clear();
+        return std::move(m_points);
+    }
+
+private:
+    static constexpr I EMPTY_SLOT = graphs::IndexTraits<I>::undef();
+
+    // Power of two, with a max load factor of 1/2
+    static std::size_t slot_count(std::size_t nb_points)
+    {
+        std::size_t count = 16;
+        while (count < 2 * nb_points) { count *= 2; }
+        return count;
+    }
+
+    static std::uint64_t hash_combine(std::uint64_t seed, typename P::scalar coord)
+    {
+        coord += typename P::scalar{0};         // -0.0 + 0.0 == +0.0, so that both have the same hash
+        std::uint64_t bits = 0;
+        static_assert(sizeof(coord) <= sizeof(bits));
+        std::memcpy(&bits, &coord, sizeof(coord));
+        // Mixer of splitmix64
+        std::uint64_t z = seed ^ (bits + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    static std::size_t hash(const P& point)
+    {
+        std::uint64_t h = hash_combine(0, point.x);
+        h = hash_combine(h, point.y);
+        if constexpr (P::dim == 3) { h = hash_combine(h, point.z); }
+#if SIZE_MAX < UINT64_MAX
+        return static_cast<std::size_t>(h);         // Narrowing on the 32-bit platforms
+#else
+        return h;                                   // Same type, the cast would be flagged by -Wuseless-cast
+#endif
     }
+
+    void rehash(std::size_t new_slot_count)
+    {
+        assert((new_slot_count & (new_slot_count - 1)) == 0);
+        m_slots.assign(new_slot_count, EMPTY_SLOT);
+        m_mask = new_slot_count - 1;
+        for (std::size_t idx = 0; idx < m_points.size(); idx++)
+        {
+            std::size_t slot = hash(m_points[idx]) & m_mask;
+            while (m_slots[slot] != EMPTY_SLOT) { slot = (slot + 1) & m_mask; }
+            m_slots[slot] = static_cast<I>(idx);
+        }
+    }
+
+    std::vector<P> m_points;
+    std::vector<I> m_slots;
+    std::size_t m_mask;
+};
+
+// Text output of the writers, formatted into a large buffer which is written to the stream in blocks. The floating-point numbers are
+// formatted with std::to_chars, i.e. the shortest representation that parses back to the same value.
+class BufferedWriter
+{
+public:
+    explicit BufferedWriter(std::ostream& out) : m_out(out), m_buffer(BUFFER_SIZE, '\0'), m_size(0) {}
+    ~BufferedWriter() { flush(); }
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    BufferedWriter& operator<<(char c)
+    {
+        reserve(1);
+        m_buffer[m_size++] = c;
+        return *this;
+    }
+
+    BufferedWriter& operator<<(std::string_view str)
+    {
+        if (str.size() > BUFFER_SIZE)
+        {
+            flush();
+            m_out.write(str.data(), static_cast<std::streamsize>(str.size()));
+            return *this;
+        }
+        reserve(str.size());
+        std::memcpy(m_buffer.data() + m_size, str.data(), str.size());
+        m_size += str.size();
+        return *this;
+    }
+
+    template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    BufferedWriter& operator<<(T value)
+    {
+        reserve(MAX_NUMBER_SIZE);
+        char* const first = m_buffer.data() + m_size;
+        char* const last = first + MAX_NUMBER_SIZE;
+#if !SHAPES_IO_FP_TO_CHARS
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            const int len = std::snprintf(first, MAX_NUMBER_SIZE, "%.*g", std::numeric_limits<T>::max_digits10, static_cast<double>(value));
+            assert(0 < len && static_cast<std::size_t>(len) < MAX_NUMBER_SIZE);
+            m_size += static_cast<std::size_t>(len);
+            return *this;
+        }
+#endif
+        const auto [ptr, ec] = std::to_chars(first, last, value);
+        assert(ec == std::errc());
+        UNUSED(ec);
+        m_size += static_cast<std::size_t>(ptr - first);
+        return *this;
+    }
+
+    void flush()
+    {
+        if (m_size == 0)
+            return;
+        m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_size));
+        m_size = 0;
+    }
+
 private:
-    std::map<P, I, shapes::less<P>> m_unique_points;
+    static constexpr std::size_t BUFFER_SIZE = std::size_t{1} << 20;
+    static constexpr std::size_t MAX_NUMBER_SIZE = 32;
+
+    void reserve(std::size_t sz)
+    {
+        assert(sz <= BUFFER_SIZE);
+        if (m_size + sz > BUFFER_SIZE) { flush(); }
+    }
+
+    std::ostream& m_out;
+    std::string m_buffer;
+    std::size_t m_size;
 };
 
+template <typename F>
+BufferedWriter& operator<<(BufferedWriter& out, const Point2d<F>& p)
+{
+    return out << p.x << ' ' << p.y;
+}
+
+template <typename F>
+BufferedWriter& operator<<(BufferedWriter& out, const Point3d<F>& p)
+{
+    return out << p.x << ' ' << p.y << ' ' << p.z;
+}
+
 } // namespace
 
 
@@ -177,8 +401,38 @@ namespace dat {
 
 namespace {
 
-template <typename F, int POINT_DIM, std::size_t MAX_DIM>
-void append_new_shape(const ShapeBuffer<F, MAX_DIM>& buffer, ShapeAggregate<F>& shapes, const stdutils::io::ErrorHandler& err_handler) noexcept
+// Store the parsed shapes in a ShapeAggregate
+template <typename F>
+struct ShapeAggregateSink
+{
+    template <typename Shape>
+    void emplace_back(Shape&& shape) { shapes.emplace_back(shapes::AllShapes<F>(std::forward<Shape>(shape))); }
+    bool stopped() const { return false; }
+
+    ShapeAggregate<F> shapes;
+};
+
+// Pass the parsed shapes to a callback, one at a time
+class ShapeCallbackSink
+{
+public:
+    explicit ShapeCallbackSink(const ShapeCallback& callback) : m_callback(callback), m_stopped(false) {}
+
+    template <typename Shape>
+    void emplace_back(Shape&& shape)
+    {
+        if (!m_stopped) { m_stopped = !m_callback(ShapeWrapper<double>(shapes::AllShapes<double>(std::forward<Shape>(shape)))); }
+    }
+    bool stopped() const { return m_stopped; }
+
+private:
+    const ShapeCallback& m_callback;
+    bool m_stopped;
+};
+
+// ShapeSink is either ShapeAggregateSink or ShapeCallbackSink
+template <typename F, int POINT_DIM, std::size_t MAX_DIM, typename ShapeSink>
+void append_new_shape(const ShapeBuffer<F, MAX_DIM>& buffer, ShapeSink& shapes, const stdutils::io::ErrorHandler& err_handler)
 {
     static_assert(static_cast<std::size_t>(POINT_DIM) <= MAX_DIM);
     using P = typename shapes::Traits<F, POINT_DIM>::Point;
@@ -222,7 +476,7 @@ void append_new_shape(const ShapeBuffer<F, MAX_DIM>& buffer, ShapeAggregate<F>&
             if (nb_vertices % 2 != 0 && err_handler) { err_handler(stdutils::io::Severity::WARN, "Invalid number of vertices in shape of type EDGE_SOUP. Last ones will be ignored."); }
             shapes::Edges<P> edges;
             using I = typename decltype(edges)::index;
-            UniquePoints<P, I> unique_vertices;
+            UniquePoints<P, I> unique_vertices(nb_vertices);
             edges.indices.reserve(nb_vertices / 2);
             for (std::size_t idx = 0; idx + 1 < nb_vertices; idx += 2)
             {
@@ -240,7 +494,7 @@ void append_new_shape(const ShapeBuffer<F, MAX_DIM>& buffer, ShapeAggregate<F>&
             if (nb_vertices % 3 != 0 && err_handler) { err_handler(stdutils::io::Severity::WARN, "Invalid number of vertices in shape of type TRIANGLE_SOUP. Last ones will be ignored."); }
             shapes::Triangles<P> triangles;
             using I = typename decltype(triangles)::index;
-            UniquePoints<P, I> unique_vertices;
+            UniquePoints<P, I> unique_vertices(nb_vertices);
             triangles.faces.reserve(nb_vertices / 3);
             for (std::size_t idx = 0; idx + 2 < nb_vertices; idx += 3)
             {
@@ -259,15 +513,15 @@ void append_new_shape(const ShapeBuffer<F, MAX_DIM>& buffer, ShapeAggregate<F>&
     }
 }
 
-template <typename F>
-ShapeAggregate<F> parse_shapes_from_stream_gen(std::istream& inputstream, const stdutils::io::ErrorHandler& err_handler)
+// LineReader is either stdutils::io::SkipLineStream or stdutils::io::SkipLineView
+template <typename F, typename LineReader, typename ShapeSink>
+void parse_shapes_gen(LineReader& linestream, ShapeSink& result, const stdutils::io::ErrorHandler& err_handler)
 {
-    ShapeAggregate<F> result;
-    std::string line;
+    STDUTILS_PROFILE_ZONE("dat::parse_shapes");
+    typename LineReader::line_t line;
     std::size_t line_nb{0u};
     ShapeBuffer<F, 3> buffer;
-    auto linestream = stdutils::io::SkipLineStream(inputstream).skip_blank_lines().skip_comment_lines("#");
-    while (linestream.stream().good())
+    while (linestream.good() && !result.stopped())
     {
         // Read point series
         while (linestream.getline(line, line_nb) && parse_numeric_line(line, buffer.vertices)) {}
@@ -298,7 +552,40 @@ ShapeAggregate<F> parse_shapes_from_stream_gen(std::istream& inputstream, const
         const auto topo_str = stdutils::string::tolower(token_iterator.next_token());
         buffer.closed = (topo_str != "open");
     }
-    return result;
+}
+
+template <typename F>
+ShapeAggregate<F> parse_shapes_from_stream_gen(std::istream& inputstream, const stdutils::io::ErrorHandler& err_handler)
+{
+    auto linestream = stdutils::io::SkipLineStream(inputstream).skip_blank_lines().skip_comment_lines("#");
+    ShapeAggregateSink<F> sink;
+    parse_shapes_gen<F>(linestream, sink, err_handler);
+    return std::move(sink.shapes);
+}
+
+template <typename F>
+ShapeAggregate<F> parse_shapes_from_buffer_gen(std::string_view buffer, const stdutils::io::ErrorHandler& err_handler)
+{
+    auto linestream = stdutils::io::SkipLineView(buffer).skip_blank_lines().skip_comment_lines("#");
+    ShapeAggregateSink<F> sink;
+    parse_shapes_gen<F>(linestream, sink, err_handler);
+    return std::move(sink.shapes);
+}
+
+bool parse_shapes_from_stream_with_callback(std::istream& inputstream, const ShapeCallback& callback, const stdutils::io::ErrorHandler& err_handler)
+{
+    auto linestream = stdutils::io::SkipLineStream(inputstream).skip_blank_lines().skip_comment_lines("#");
+    ShapeCallbackSink sink(callback);
+    parse_shapes_gen<double>(linestream, sink, err_handler);
+    return true;
+}
+
+bool parse_shapes_from_buffer_with_callback(std::string_view buffer, const ShapeCallback& callback, const stdutils::io::ErrorHandler& err_handler)
+{
+    auto linestream = stdutils::io::SkipLineView(buffer).skip_blank_lines().skip_comment_lines("#");
+    ShapeCallbackSink sink(callback);
+    parse_shapes_gen<double>(linestream, sink, err_handler);
+    return true;
 }
 
 template <typename F>
@@ -316,95 +603,88 @@ struct StreamWriterInput
 };
 
 template <typename F>
-void save_shapes_as_stream_gen(std::ostream& out, const StreamWriterInput<F>& input, const stdutils::io::ErrorHandler& err_handler)
+void save_shapes_as_stream_gen(std::ostream& stream, const StreamWriterInput<F>& input, const stdutils::io::ErrorHandler& err_handler)
 {
+    STDUTILS_PROFILE_ZONE("dat::save_shapes");
     UNUSED(err_handler);
-    const auto initial_fp_digits = stdutils::io::accurate_fp_precision<F>(out);
+    BufferedWriter out(stream);
     const char sep = input.sep;
     if (!input.head_comment.empty())
     {
         // TODO Add support for multiline head comment
         out << "# " << input.head_comment << sep;
     }
+    const auto write_vertices = [&out, sep](const auto& vertices) {
+        for (const auto& p : vertices) { out << p << sep; }
+    };
     for (const auto& shape_wrapper : input.shapes)
     {
         if (!shape_wrapper.descr.empty())
         {
-            out << "# " << shape_wrapper.descr << sep;
+            out << "# " << std::string_view(shape_wrapper.descr) << sep;
         }
         std::visit(stdutils::Overloaded {
-            [&out, sep](const shapes::PointCloud2d<F>& pc) {
+            [&out, &write_vertices](const shapes::PointCloud2d<F>& pc) {
                 out << "POINT_CLOUD\n";
-                for (const auto& p : pc.vertices) { out << p.x << ' ' << p.y << sep; }
+                write_vertices(pc.vertices);
             },
-            [&out, sep](const shapes::PointCloud3d<F>& pc) {
+            [&out, &write_vertices](const shapes::PointCloud3d<F>& pc) {
                 out << "POINT_CLOUD\n";
-                for (const auto& p : pc.vertices) { out << p.x << ' ' << p.y << ' ' << p.z << sep; }
+                write_vertices(pc.vertices);
             },
-            [&out, sep](const shapes::PointPath2d<F>& pp) {
+            [&out, &write_vertices, sep](const shapes::PointPath2d<F>& pp) {
                 out << "POINT_PATH " << (pp.closed ? "CLOSED" : "OPEN") << sep;
-                for (const auto& p : pp.vertices) { out << p.x << ' ' << p.y << sep; }
+                write_vertices(pp.vertices);
             },
-            [&out, sep](const shapes::PointPath3d<F>& pp) {
+            [&out, &write_vertices, sep](const shapes::PointPath3d<F>& pp) {
                 out << "POINT_PATH " << (pp.closed ? "CLOSED" : "OPEN") << sep;
-                for (const auto& p : pp.vertices) { out << p.x << ' ' << p.y << ' ' << p.z << sep; }
+                write_vertices(pp.vertices);
             },
-            [&out, sep](const shapes::CubicBezierPath2d<F>& cbp) {
+            [&out, &write_vertices, sep](const shapes::CubicBezierPath2d<F>& cbp) {
                 out << "CUBIC_BEZIER_PATH " << (cbp.closed ? "CLOSED" : "OPEN") << sep;
-                for (const auto& p : cbp.vertices) { out << p.x << ' ' << p.y << sep; }
+                write_vertices(cbp.vertices);
             },
-            [&out, sep](const shapes::CubicBezierPath3d<F>& cbp) {
+            [&out, &write_vertices, sep](const shapes::CubicBezierPath3d<F>& cbp) {
                 out << "CUBIC_BEZIER_PATH " << (cbp.closed ? "CLOSED" : "OPEN") << sep;
-                for (const auto& p : cbp.vertices) { out << p.x << ' ' << p.y << ' ' << p.z << sep; }
+                write_vertices(cbp.vertices);
             },
             [&out, sep](const shapes::Edges2d<F>& edges) {
                 out << "EDGE_SOUP" << sep;
                 for (const auto& e : edges.indices)
                 {
-                    const auto& p0 = edges.vertices[e[0]];
-                    const auto& p1 = edges.vertices[e[1]];
-                    out << p0.x << ' ' << p0.y << sep;
-                    out << p1.x << ' ' << p1.y << sep;
+                    out << edges.vertices[e[0]] << sep;
+                    out << edges.vertices[e[1]] << sep;
                 }
             },
             [&out, sep](const shapes::Edges3d<F>& edges) {
                 out << "EDGE_SOUP" << sep;
                 for (const auto& e : edges.indices)
                 {
-                    const auto& p0 = edges.vertices[e[0]];
-                    const auto& p1 = edges.vertices[e[1]];
-                    out << p0.x << ' ' << p0.y << ' ' << p0.z << sep;
-                    out << p1.x << ' ' << p1.y << ' ' << p1.z << sep;
+                    out << edges.vertices[e[0]] << sep;
+                    out << edges.vertices[e[1]] << sep;
                 }
             },
             [&out, sep](const shapes::Triangles2d<F>& triangles) {
                 out << "TRIANGLE_SOUP" << sep;
                 for (const auto& t : triangles.faces)
                 {
-                    const auto& p0 = triangles.vertices[t[0]];
-                    const auto& p1 = triangles.vertices[t[1]];
-                    const auto& p2 = triangles.vertices[t[2]];
-                    out << p0.x << ' ' << p0.y << sep;
-                    out << p1.x << ' ' << p1.y << sep;
-                    out << p2.x << ' ' << p2.y << sep;
+                    out << triangles.vertices[t[0]] << sep;
+                    out << triangles.vertices[t[1]] << sep;
+                    out << triangles.vertices[t[2]] << sep;
                 }
             },
             [&out, sep](const shapes::Triangles3d<F>& triangles) {
                 out << "TRIANGLE_SOUP" << sep;
                 for (const auto& t : triangles.faces)
                 {
-                    const auto& p0 = triangles.vertices[t[0]];
-                    const auto& p1 = triangles.vertices[t[1]];
-                    const auto& p2 = triangles.vertices[t[2]];
-                    out << p0.x << ' ' << p0.y << ' ' << p0.z << sep;
-                    out << p1.x << ' ' << p1.y << ' ' << p1.z << sep;
-                    out << p2.x << ' ' << p2.y << ' ' << p2.z << sep;
+                    out << triangles.vertices[t[0]] << sep;
+                    out << triangles.vertices[t[1]] << sep;
+                    out << triangles.vertices[t[2]] << sep;
                 }
             },
             [](const auto&) { assert(0); }
         }, shape_wrapper.shape);
     }
-    out << std::setprecision(initial_fp_digits);
 }
 
 } // namespace
@@ -426,7 +706,30 @@ ShapeAggregate<double> parse_shapes_from_stream(std::istream& inputstream, const
 
 ShapeAggregate<double> parse_shapes_from_file(std::filesystem::path filepath, const stdutils::io::ErrorHandler& err_handler) noexcept
 {
-    return stdutils::io::open_and_parse_txt_file<ShapeAggregate<double>, char>(filepath, parse_shapes_from_stream_gen<double>, err_handler);
+    return stdutils::io::open_and_parse_mapped_file<ShapeAggregate<double>>(filepath, parse_shapes_from_buffer_gen<double>, err_handler);
+}
+
+bool parse_shapes_from_stream(std::istream& inputstream, const ShapeCallback& callback, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    try
+    {
+        return parse_shapes_from_stream_with_callback(inputstream, callback, err_handler);
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream oss;
+        oss << "Exception: " << e.what();
+        err_handler(stdutils::io::Severity::EXCPT, oss.str());
+    }
+    return false;
+}
+
+bool parse_shapes_from_file(std::filesystem::path filepath, const ShapeCallback& callback, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    const auto buffer_parser = [&callback](std::string_view buffer, const stdutils::io::ErrorHandler& err_handler) {
+        return parse_shapes_from_buffer_with_callback(buffer, callback, err_handler);
+    };
+    return stdutils::io::open_and_parse_mapped_file<bool>(filepath, buffer_parser, err_handler);
 }
 
 void save_shapes_as_stream(std::ostream& outputstream, const ShapeAggregate<double>& shapes, const stdutils::io::ErrorHandler& err_handler) noexcept
@@ -509,19 +812,15 @@ bool check_expected_size(std::string_view id, std::size_t sz0, std::size_t sz1,
 }
 
 template <typename I>
-void warn_eliminated_edge(const graphs::Edge<I>& edge, std::string_view reason, const stdutils::io::ErrorHandler& err_handler)
+void warn_eliminated_edge(const graphs::Edge<I>& edge, std::string_view reason, stdutils::io::RepeatedMessage& warning)
 {
-    std::stringstream out;
-    out << "Eliminated invalid edge [ " << edge[0] << ", " << edge[1] << " ]: " << reason;
-    err_handler(stdutils::io::Severity::WARN, out.str());
+    warning([&edge, reason](std::ostream& out) { out << "Eliminated invalid edge [ " << edge[0] << ", " << edge[1] << " ]: " << reason; });
 }
 
 template <typename I>
-void warn_eliminated_triangle(const graphs::Triangle<I>& tri, std::string_view reason, const stdutils::io::ErrorHandler& err_handler)
+void warn_eliminated_triangle(const graphs::Triangle<I>& tri, std::string_view reason, stdutils::io::RepeatedMessage& warning)
 {
-    std::stringstream out;
-    out << "Eliminated invalid triangle [ " << tri[0] << ", " << tri[1] << ", " << tri[2] << " ]: " << reason;
-    err_handler(stdutils::io::Severity::WARN, out.str());
+    warning([&tri, reason](std::ostream& out) { out << "Eliminated invalid triangle [ " << tri[0] << ", " << tri[1] << ", " << tri[2] << " ]: " << reason; });
 }
 
 enum class CDT_State
@@ -533,26 +832,25 @@ enum class CDT_State
     Done
 };
 
-template <typename F, typename I>
-unsigned int peek_point_dimension_gen(std::istream& inputstream, const stdutils::io::ErrorHandler& err_handler)
+// LineReader is either stdutils::io::SkipLineStream or stdutils::io::SkipLineView
+template <typename F, typename I, typename LineReader>
+unsigned int peek_point_dimension_gen(LineReader& linestream, const stdutils::io::ErrorHandler& err_handler)
 {
     unsigned int result = 0;
     CDT_State cdt_state = CDT_State::HeaderLine;
-    auto linestream = stdutils::io::SkipLineStream(inputstream).skip_blank_lines().skip_comment_lines("#");
-    while (linestream.stream().good() && cdt_state != CDT_State::Done)
+    while (linestream.good() && cdt_state != CDT_State::Done)
     {
-        std::string line;
+        typename LineReader::line_t line;
         std::size_t line_nb{0u};
         switch (cdt_state)
         {
             case CDT_State::HeaderLine:
             {
                 NumericLineBuffer<I, 3> count_buffer;
+                stdutils::io::RepeatedMessage warning(err_handler, stdutils::io::Severity::WARN, "CDT_State: HeaderLine. Invalid lines skipped");
                 while (linestream.getline(line, line_nb) && !parse_numeric_line(line, count_buffer))
                 {
-                    std::stringstream out;
-                    out << "CDT_State: HeaderLine. Invalid line (" << line_nb << ") was skipped.";
-                    err_handler(stdutils::io::Severity::WARN, out.str());
+                    warning([line_nb](std::ostream& out) { out << "CDT_State: HeaderLine. Invalid line (" << line_nb << ") was skipped."; });
                 }
                 if (count_buffer.lines.size() == 1)
                 {
@@ -594,35 +892,96 @@ unsigned int peek_point_dimension_gen(std::istream& inputstream, const stdutils:
     return result;
 }
 
-template <typename P, typename I>
-shapes::Soup<P, I> parse_shapes_from_stream_gen(std::istream& inputstream, const stdutils::io::ErrorHandler& err_handler)
+template <typename F, typename I>
+unsigned int peek_point_dimension_from_stream_gen(std::istream& inputstream, const stdutils::io::ErrorHandler& err_handler)
+{
+    auto linestream = stdutils::io::SkipLineStream(inputstream).skip_blank_lines().skip_comment_lines("#");
+    return peek_point_dimension_gen<F, I>(linestream, err_handler);
+}
+
+template <typename F, typename I>
+unsigned int peek_point_dimension_from_buffer_gen(std::string_view buffer, const stdutils::io::ErrorHandler& err_handler)
+{
+    auto linestream = stdutils::io::SkipLineView(buffer).skip_blank_lines().skip_comment_lines("#");
+    return peek_point_dimension_gen<F, I>(linestream, err_handler);
+}
+
+// The vertex lines are parsed by blocks, each block being mapped to the points of the soup before the next one is parsed
+constexpr std::size_t VERTEX_BLOCK_SIZE = 4096;
+
+// Map the coordinates of a vertex line to a point of the same dimension
+template <typename P>
+struct SameDimVertex
+{
+    using Point = P;
+    static constexpr std::size_t INPUT_DIM = static_cast<std::size_t>(P::dim);
+    using Entry = typename NumericLineBuffer<typename P::scalar, INPUT_DIM>::Entry;
+
+    P operator()(const Entry& entry, std::vector<float>*) const
+    {
+        return to_point<typename P::scalar, P::dim, INPUT_DIM>(entry);
+    }
+};
+
+// Project the coordinates of a 3D vertex line on a plane
+struct ProjectedVertex
+{
+    using Point = shapes::Point2d<double>;
+    static constexpr std::size_t INPUT_DIM = 3;
+    using Entry = typename NumericLineBuffer<double, INPUT_DIM>::Entry;
+
+    explicit ProjectedVertex(const Projection& projection)
+        : origin(projection.origin)
+        , u(projection.u)
+        , v(projection.v)
+        , w(shapes::cross_product(projection.u, projection.v))
+    {}
+
+    Point operator()(const Entry& entry, std::vector<float>* heights) const
+    {
+        const shapes::Vect3d<double> d(entry[0] - origin.x, entry[1] - origin.y, entry[2] - origin.z);
+        if (heights) { heights->push_back(static_cast<float>(shapes::dot(d, w))); }
+        return Point(shapes::dot(d, u), shapes::dot(d, v));
+    }
+
+    shapes::Point3d<double> origin;
+    shapes::Vect3d<double> u;
+    shapes::Vect3d<double> v;
+    shapes::Vect3d<double> w;
+};
+
+// LineReader is either stdutils::io::SkipLineStream or stdutils::io::SkipLineView
+// VertexMap is either SameDimVertex or ProjectedVertex. The heights are only filled by the latter.
+template <typename I, typename LineReader, typename VertexMap>
+shapes::Soup<typename VertexMap::Point, I> parse_shapes_gen(LineReader& linestream, const VertexMap& vertex_map, SoupHeights* heights, const stdutils::io::ErrorHandler& err_handler)
 {
+    STDUTILS_PROFILE_ZONE("cdt::parse_shapes");
+    using P = typename VertexMap::Point;
     using F = typename P::scalar;
-    constexpr auto POINT_DIM = static_cast<std::size_t>(P::dim);
     shapes::Soup<P, I> result;
     CDT_State cdt_state = CDT_State::HeaderLine;
     I nb_vertices = 0;
     I nb_edges = 0;
     I nb_triangles = 0;
     std::vector<P> vertices;
+    std::vector<float> vertex_heights;
     graphs::EdgeSoup<I> edges;
     graphs::TriangleSoup<I> triangles;
     constexpr I undef = graphs::IndexTraits<I>::undef();
-    auto linestream = stdutils::io::SkipLineStream(inputstream).skip_blank_lines().skip_comment_lines("#");
-    while (linestream.stream().good() && cdt_state != CDT_State::Done)
+    if (heights) { *heights = SoupHeights(); }
+    while (linestream.good() && cdt_state != CDT_State::Done)
     {
-        std::string line;
+        typename LineReader::line_t line;
         std::size_t line_nb{0u};
         switch (cdt_state)
         {
             case CDT_State::HeaderLine:
             {
                 NumericLineBuffer<I, 3> count_buffer;
+                stdutils::io::RepeatedMessage warning(err_handler, stdutils::io::Severity::WARN, "CDT_State: HeaderLine. Invalid lines skipped");
                 while (linestream.getline(line, line_nb) && !parse_numeric_line(line, count_buffer))
                 {
-                    std::stringstream out;
-                    out << "CDT_State: HeaderLine. Invalid line (" << line_nb << ") was skipped.";
-                    err_handler(stdutils::io::Severity::WARN, out.str());
+                    warning([line_nb](std::ostream& out) { out << "CDT_State: HeaderLine. Invalid line (" << line_nb << ") was skipped."; });
                 }
                 if (count_buffer.lines.size() == 1)
                 {
@@ -640,9 +999,19 @@ shapes::Soup<P, I> parse_shapes_from_stream_gen(std::istream& inputstream, const
             }
             case CDT_State::ParseVertices:
             {
-                NumericLineBuffer<F, POINT_DIM> vertex_buffer;
-                while (vertex_buffer.lines.size() < nb_vertices && linestream.getline(line, line_nb) && parse_numeric_line(line, vertex_buffer)) { }
-                append_vertices(vertices, vertex_buffer);
+                NumericLineBuffer<F, VertexMap::INPUT_DIM> vertex_buffer;
+                vertex_buffer.lines.reserve(std::min(VERTEX_BLOCK_SIZE, static_cast<std::size_t>(nb_vertices)));
+                vertices.reserve(nb_vertices);
+                if (heights) { vertex_heights.reserve(nb_vertices); }
+                bool parsed = true;
+                while (parsed && vertices.size() < nb_vertices)
+                {
+                    const std::size_t block_size = std::min(VERTEX_BLOCK_SIZE, static_cast<std::size_t>(nb_vertices) - vertices.size());
+                    vertex_buffer.lines.clear();
+                    while (vertex_buffer.lines.size() < block_size && linestream.getline(line, line_nb) && parse_numeric_line(line, vertex_buffer)) { }
+                    parsed = vertex_buffer.lines.size() == block_size;     // Else the vertex lines ended before the block
+                    for (const auto& entry : vertex_buffer.lines) { vertices.push_back(vertex_map(entry, heights ? &vertex_heights : nullptr)); }
+                }
                 cdt_state = CDT_State::ParseEdgeIndices;
                 break;
             }
@@ -679,19 +1048,21 @@ shapes::Soup<P, I> parse_shapes_from_stream_gen(std::istream& inputstream, const
     {
         result.edges.indices.reserve(edges.size());
         std::set<graphs::Edge<I>> ordered_edges;
-        std::copy_if(edges.cbegin(), edges.cend(), std::back_inserter(result.edges.indices), [&err_handler, &ordered_edges, nb_vertices](const auto& e) {
-            if (e[0] == e[1]) { warn_eliminated_edge(e, "loop edge", err_handler); return false; }
-            if (e[0] >= nb_vertices || e[1] >= nb_vertices) { warn_eliminated_edge(e, "out of bound index", err_handler); return false; }
-            if (!ordered_edges.insert(graphs::ordered_edge(e)).second) { warn_eliminated_edge(e, "duplicated edge", err_handler); return false; }
+        stdutils::io::RepeatedMessage warning(err_handler, stdutils::io::Severity::WARN, "Eliminated invalid edges");
+        std::copy_if(edges.cbegin(), edges.cend(), std::back_inserter(result.edges.indices), [&warning, &ordered_edges, nb_vertices](const auto& e) {
+            if (e[0] == e[1]) { warn_eliminated_edge(e, "loop edge", warning); return false; }
+            if (e[0] >= nb_vertices || e[1] >= nb_vertices) { warn_eliminated_edge(e, "out of bound index", warning); return false; }
+            if (!ordered_edges.insert(graphs::ordered_edge(e)).second) { warn_eliminated_edge(e, "duplicated edge", warning); return false; }
             return true;
         });
         assert(graphs::is_valid(result.edges.indices));
     }
     {
         result.triangles.faces.reserve(triangles.size());
-        std::copy_if(triangles.cbegin(), triangles.cend(), std::back_inserter(result.triangles.faces), [&err_handler, nb_vertices](const auto& t) {
-            if (!graphs::is_valid(t)) { warn_eliminated_triangle(t, "repeat index", err_handler); return false; }
-            if (t[0] >= nb_vertices || t[1] >= nb_vertices || t[2] >= nb_vertices) { warn_eliminated_triangle(t, "out of bound index", err_handler); return false; }
+        stdutils::io::RepeatedMessage warning(err_handler, stdutils::io::Severity::WARN, "Eliminated invalid triangles");
+        std::copy_if(triangles.cbegin(), triangles.cend(), std::back_inserter(result.triangles.faces), [&warning, nb_vertices](const auto& t) {
+            if (!graphs::is_valid(t)) { warn_eliminated_triangle(t, "repeat index", warning); return false; }
+            if (t[0] >= nb_vertices || t[1] >= nb_vertices || t[2] >= nb_vertices) { warn_eliminated_triangle(t, "out of bound index", warning); return false; }
             return true;
         });
         assert(graphs::is_valid(result.triangles.faces));
@@ -722,6 +1093,23 @@ shapes::Soup<P, I> parse_shapes_from_stream_gen(std::istream& inputstream, const
         if (p_in_triangles)
             result.triangles.vertices.emplace_back(p);
     }
+    if (heights)
+    {
+        // Same split as the vertices
+        assert(vertex_heights.size() == vertices.size());
+        for (std::size_t idx = 0; idx < nb_vertices; idx++)
+        {
+            const float h = vertex_heights[idx];
+            const bool p_in_edges = vertices_in_edges[idx + 1];
+            const bool p_in_triangles = vertices_in_triangles[idx + 1];
+            if (!p_in_edges && !p_in_triangles)
+                heights->point_cloud.push_back(h);
+            if (p_in_edges)
+                heights->edges.push_back(h);
+            if (p_in_triangles)
+                heights->triangles.push_back(h);
+        }
+    }
 
     // Finally, remap the indices of the edges and the triangles
     std::partial_sum(vertices_in_edges.cbegin(), vertices_in_edges.cend(), vertices_in_edges.begin());
@@ -743,13 +1131,87 @@ shapes::Soup<P, I> parse_shapes_from_stream_gen(std::istream& inputstream, const
     return result;
 }
 
+template <typename P, typename I>
+shapes::Soup<P, I> parse_shapes_from_stream_gen(std::istream& inputstream, const stdutils::io::ErrorHandler& err_handler)
+{
+    auto linestream = stdutils::io::SkipLineStream(inputstream).skip_blank_lines().skip_comment_lines("#");
+    return parse_shapes_gen<I>(linestream, SameDimVertex<P>(), nullptr, err_handler);
+}
+
+template <typename P, typename I>
+shapes::Soup<P, I> parse_shapes_from_buffer_gen(std::string_view buffer, const stdutils::io::ErrorHandler& err_handler)
+{
+    auto linestream = stdutils::io::SkipLineView(buffer).skip_blank_lines().skip_comment_lines("#");
+    return parse_shapes_gen<I>(linestream, SameDimVertex<P>(), nullptr, err_handler);
+}
+
+template <typename I>
+shapes::Soup2d<double, I> parse_projected_shapes_from_stream_gen(std::istream& inputstream, const Projection& projection, SoupHeights* heights, const stdutils::io::ErrorHandler& err_handler)
+{
+    auto linestream = stdutils::io::SkipLineStream(inputstream).skip_blank_lines().skip_comment_lines("#");
+    return parse_shapes_gen<I>(linestream, ProjectedVertex(projection), heights, err_handler);
+}
+
+template <typename I>
+shapes::Soup2d<double, I> parse_projected_shapes_from_buffer_gen(std::string_view buffer, const Projection& projection, SoupHeights* heights, const stdutils::io::ErrorHandler& err_handler)
+{
+    auto linestream = stdutils::io::SkipLineView(buffer).skip_blank_lines().skip_comment_lines("#");
+    return parse_shapes_gen<I>(linestream, ProjectedVertex(projection), heights, err_handler);
+}
+
+template <typename P, typename I>
+struct StreamWriterInput
+{
+    StreamWriterInput(const shapes::Soup<P, I>& soup, std::string_view head_comment = std::string_view())
+        : soup(soup)
+        , head_comment(head_comment)
+    {}
+
+    const shapes::Soup<P, I>& soup;
+    std::string_view head_comment;
+};
+
+// The vertices of the point cloud, then those of the edges and those of the triangles, whose indices are offset accordingly
+template <typename P, typename I>
+void save_shapes_as_stream_gen(std::ostream& stream, const StreamWriterInput<P, I>& input, const stdutils::io::ErrorHandler& err_handler)
+{
+    STDUTILS_PROFILE_ZONE("cdt::save_shapes");
+    const auto& soup = input.soup;
+    const std::size_t edges_offset = soup.point_cloud.vertices.size();
+    const std::size_t triangles_offset = edges_offset + soup.edges.vertices.size();
+    const std::size_t nb_vertices = triangles_offset + soup.triangles.vertices.size();
+    if (nb_vertices > static_cast<std::size_t>(graphs::IndexTraits<I>::max_valid_index()) + 1)
+    {
+        err_handler(stdutils::io::Severity::ERR, "Too many vertices for the index type of the CDT format");
+        return;
+    }
+    BufferedWriter out(stream);
+    if (!input.head_comment.empty())
+    {
+        out << "# " << input.head_comment << '\n';
+    }
+    out << nb_vertices << ' ' << soup.edges.indices.size() << ' ' << soup.triangles.faces.size() << '\n';
+    for (const auto* vertices : { &soup.point_cloud.vertices, &soup.edges.vertices, &soup.triangles.vertices })
+    {
+        for (const auto& p : *vertices) { out << p << '\n'; }
+    }
+    for (const auto& e : soup.edges.indices)
+    {
+        out << edges_offset + static_cast<std::size_t>(e[0]) << ' ' << edges_offset + static_cast<std::size_t>(e[1]) << '\n';
+    }
+    for (const auto& t : soup.triangles.faces)
+    {
+        out << triangles_offset + static_cast<std::size_t>(t[0]) << ' ' << triangles_offset + static_cast<std::size_t>(t[1]) << ' ' << triangles_offset + static_cast<std::size_t>(t[2]) << '\n';
+    }
+}
+
 } // namespace
 
 unsigned int peek_point_dimension(std::istream& inputstream, const stdutils::io::ErrorHandler& err_handler) noexcept
 {
     try
     {
-        return peek_point_dimension_gen<double, std::uint32_t>(inputstream, err_handler);
+        return peek_point_dimension_from_stream_gen<double, std::uint32_t>(inputstream, err_handler);
     }
     catch (const std::exception& e)
     {
@@ -762,7 +1224,7 @@ unsigned int peek_point_dimension(std::istream& inputstream, const stdutils::io:
 
 unsigned int peek_point_dimension(std::filesystem::path filepath, const stdutils::io::ErrorHandler& err_handler) noexcept
 {
-    return stdutils::io::open_and_parse_txt_file<unsigned int, char>(filepath, peek_point_dimension_gen<double, std::uint32_t>, err_handler);
+    return stdutils::io::open_and_parse_mapped_file<unsigned int>(filepath, peek_point_dimension_from_buffer_gen<double, std::uint32_t>, err_handler);
 }
 
 shapes::Soup2d<double> parse_2d_shapes_from_stream(std::istream& inputstream, const stdutils::io::ErrorHandler& err_handler) noexcept
@@ -786,7 +1248,7 @@ shapes::Soup2d<double> parse_2d_shapes_from_file(std::filesystem::path filepath,
 {
     using P = shapes::Point2d<double>;
     using I = std::uint32_t;
-    return stdutils::io::open_and_parse_txt_file<shapes::Soup<P,I>, char>(filepath, parse_shapes_from_stream_gen<P, I>, err_handler);
+    return stdutils::io::open_and_parse_mapped_file<shapes::Soup<P,I>>(filepath, parse_shapes_from_buffer_gen<P, I>, err_handler);
 }
 
 shapes::Soup3d<double> parse_3d_shapes_from_stream(std::istream& inputstream, const stdutils::io::ErrorHandler& err_handler) noexcept
@@ -810,7 +1272,112 @@ shapes::Soup3d<double> parse_3d_shapes_from_file(std::filesystem::path filepath,
 {
     using P = shapes::Point3d<double>;
     using I = std::uint32_t;
-    return stdutils::io::open_and_parse_txt_file<shapes::Soup<P,I>, char>(filepath, parse_shapes_from_stream_gen<P, I>, err_handler);
+    return stdutils::io::open_and_parse_mapped_file<shapes::Soup<P,I>>(filepath, parse_shapes_from_buffer_gen<P, I>, err_handler);
+}
+
+Projection Projection::drop_axis(unsigned int axis)
+{
+    assert(axis < 3);
+    Projection result;
+    switch (axis)
+    {
+        case 0:
+            result.u = shapes::Vect3d<double>(0.0, 1.0, 0.0);
+            result.v = shapes::Vect3d<double>(0.0, 0.0, 1.0);
+            break;
+        case 1:
+            result.u = shapes::Vect3d<double>(0.0, 0.0, 1.0);
+            result.v = shapes::Vect3d<double>(1.0, 0.0, 0.0);
+            break;
+        default:
+            break;
+    }
+    return result;
+}
+
+Projection Projection::plane(const shapes::Point3d<double>& origin, shapes::Vect3d<double> normal)
+{
+    Projection result;
+    result.origin = origin;
+    if (!shapes::normalize(normal))
+        return result;
+    // u is orthogonal to the normal and to the axis the least aligned with it, v completes the direct orthonormal basis (u, v, normal)
+    const auto abs_x = std::abs(normal.x);
+    const auto abs_y = std::abs(normal.y);
+    const auto abs_z = std::abs(normal.z);
+    shapes::Vect3d<double> axis(0.0, 0.0, 1.0);
+    if (abs_x <= abs_y && abs_x <= abs_z) { axis = shapes::Vect3d<double>(1.0, 0.0, 0.0); }
+    else if (abs_y <= abs_z) { axis = shapes::Vect3d<double>(0.0, 1.0, 0.0); }
+    result.u = shapes::cross_product(axis, normal);
+    [[maybe_unused]] const bool normalized = shapes::normalize(result.u);
+    assert(normalized);
+    result.v = shapes::cross_product(normal, result.u);
+    return result;
+}
+
+shapes::Soup2d<double> parse_3d_shapes_projected_from_stream(std::istream& inputstream, const Projection& projection, const stdutils::io::ErrorHandler& err_handler, SoupHeights* heights) noexcept
+{
+    using I = std::uint32_t;
+    try
+    {
+        return parse_projected_shapes_from_stream_gen<I>(inputstream, projection, heights, err_handler);
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream oss;
+        oss << "Exception: " << e.what();
+        err_handler(stdutils::io::Severity::EXCPT, oss.str());
+    }
+    return shapes::Soup2d<double>();
+}
+
+shapes::Soup2d<double> parse_3d_shapes_projected_from_file(std::filesystem::path filepath, const Projection& projection, const stdutils::io::ErrorHandler& err_handler, SoupHeights* heights) noexcept
+{
+    using I = std::uint32_t;
+    const auto parse_fn = [&projection, heights](std::string_view buffer, const stdutils::io::ErrorHandler& err_handler_) {
+        return parse_projected_shapes_from_buffer_gen<I>(buffer, projection, heights, err_handler_);
+    };
+    return stdutils::io::open_and_parse_mapped_file<shapes::Soup2d<double, I>>(filepath, parse_fn, err_handler);
+}
+
+void save_2d_shapes_as_stream(std::ostream& outputstream, const shapes::Soup2d<double>& soup, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    try
+    {
+        save_shapes_as_stream_gen(outputstream, StreamWriterInput(soup), err_handler);
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream oss;
+        oss << "Exception: " << e.what();
+        err_handler(stdutils::io::Severity::EXCPT, oss.str());
+    }
+}
+
+void save_2d_shapes_as_file(std::filesystem::path filepath, const shapes::Soup2d<double>& soup, const stdutils::io::ErrorHandler& err_handler, std::string_view head_comment) noexcept
+{
+    using Input = StreamWriterInput<shapes::Point2d<double>, std::uint32_t>;
+    stdutils::io::save_txt_file<Input, char>(filepath, save_shapes_as_stream_gen<shapes::Point2d<double>, std::uint32_t>, Input(soup, head_comment), err_handler);
+}
+
+void save_3d_shapes_as_stream(std::ostream& outputstream, const shapes::Soup3d<double>& soup, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    try
+    {
+        save_shapes_as_stream_gen(outputstream, StreamWriterInput(soup), err_handler);
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream oss;
+        oss << "Exception: " << e.what();
+        err_handler(stdutils::io::Severity::EXCPT, oss.str());
+    }
+}
+
+void save_3d_shapes_as_file(std::filesystem::path filepath, const shapes::Soup3d<double>& soup, const stdutils::io::ErrorHandler& err_handler, std::string_view head_comment) noexcept
+{
+    using Input = StreamWriterInput<shapes::Point3d<double>, std::uint32_t>;
+    stdutils::io::save_txt_file<Input, char>(filepath, save_shapes_as_stream_gen<shapes::Point3d<double>, std::uint32_t>, Input(soup, head_comment), err_handler);
 }
 
 } // namespace cdt
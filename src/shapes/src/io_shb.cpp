@@ -0,0 +1,530 @@
+// Copyright (c) 2023 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <shapes/io.h>
+
+#include <stdutils/io.h>
+#include <stdutils/macros.h>
+#include <stdutils/mapped_file.h>
+#include <stdutils/profiler.h>
+#include <stdutils/visit.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <type_traits>
+#include <utility>
+
+namespace shapes {
+namespace io {
+
+/**
+ * SHB format description
+ *
+ * The SHB format is a binary container for a ShapeAggregate<double>. All values are stored little-endian, and all
+ * the sections are 8-byte aligned so that the content of a memory-mapped file can be accessed in place.
+ *
+ * - A FILE HEADER (24 bytes):
+ *      - char[8]   magic "SHAPEBIN"
+ *      - uint16    version (currently 1)
+ *      - uint16    flags, reserved (0)
+ *      - uint32    compression (0: none. Other values are reserved for future use)
+ *      - uint64    nb of chunks
+ * - One CHUNK per shape, comprising of:
+ *      - A CHUNK HEADER (32 bytes):
+ *          - uint32    shape type: Index of the type in shapes::AllShapes<double> (e.g. 0 for PointCloud2d, 8 for Triangles2d)
+ *          - uint32    flags: bit 0 is set if the path is closed
+ *          - uint64    size of the description in bytes
+ *          - uint64    nb of coordinates (i.e. dim * nb of vertices)
+ *          - uint64    nb of indices (i.e. 2 * nb of edges, 3 * nb of triangles, or 0)
+ *      - The description (UTF-8, not null-terminated), padded to 8 bytes
+ *      - The coordinates (fp64), x, y[, z] for each vertex
+ *      - The indices (uint32), padded to 8 bytes
+ *
+ * A Soup2d (resp. Soup3d) is stored as three chunks: A point cloud, an edge soup and a triangle soup.
+ */
+namespace shb {
+
+namespace {
+
+constexpr std::array<char, 8> SHB_MAGIC = { 'S', 'H', 'A', 'P', 'E', 'B', 'I', 'N' };
+constexpr std::uint16_t SHB_VERSION = 1;
+constexpr std::uint32_t SHB_NO_COMPRESSION = 0;
+constexpr std::size_t FILE_HEADER_SIZE = 24;
+constexpr std::size_t CHUNK_HEADER_SIZE = 32;
+constexpr std::size_t SHB_ALIGNMENT = 8;
+constexpr std::uint32_t CHUNK_FLAG_CLOSED = 1;
+
+using AllShapesDouble = shapes::AllShapes<double>;
+
+bool host_is_little_endian() noexcept
+{
+    const std::uint16_t one = 1;
+    unsigned char first_byte = 0;
+    std::memcpy(&first_byte, &one, 1);
+    return first_byte == 1;
+}
+
+constexpr std::size_t padded_size(std::size_t sz)
+{
+    return (sz + SHB_ALIGNMENT - 1) / SHB_ALIGNMENT * SHB_ALIGNMENT;
+}
+
+template <typename T>
+T load_le(const char* ptr) noexcept
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::array<char, sizeof(T)> bytes;
+    std::memcpy(bytes.data(), ptr, sizeof(T));
+    if (!host_is_little_endian()) { std::reverse(bytes.begin(), bytes.end()); }
+    T value;
+    std::memcpy(&value, bytes.data(), sizeof(T));
+    return value;
+}
+
+template <typename T>
+void write_le(std::ostream& out, T value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::array<char, sizeof(T)> bytes;
+    std::memcpy(bytes.data(), &value, sizeof(T));
+    if (!host_is_little_endian()) { std::reverse(bytes.begin(), bytes.end()); }
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+void write_padding(std::ostream& out, std::size_t sz)
+{
+    static constexpr std::array<char, SHB_ALIGNMENT> zeros{};
+    const std::size_t padding = padded_size(sz) - sz;
+    out.write(zeros.data(), static_cast<std::streamsize>(padding));
+}
+
+// Dimension of the points and number of indices per element (edge or triangle) of each type of shape
+template <typename Shape>
+struct ShapeLayout
+{
+    static constexpr std::size_t dim = static_cast<std::size_t>(Shape::dim);
+    static constexpr std::size_t arity = 0;
+};
+
+template <typename P, typename I>
+struct ShapeLayout<shapes::Edges<P, I>>
+{
+    static constexpr std::size_t dim = static_cast<std::size_t>(P::dim);
+    static constexpr std::size_t arity = 2;
+};
+
+template <typename P, typename I>
+struct ShapeLayout<shapes::Triangles<P, I>>
+{
+    static constexpr std::size_t dim = static_cast<std::size_t>(P::dim);
+    static constexpr std::size_t arity = 3;
+};
+
+template <typename Shape, typename = void>
+struct HasClosedFlag : std::false_type {};
+
+template <typename Shape>
+struct HasClosedFlag<Shape, std::void_t<decltype(std::declval<Shape>().closed)>> : std::true_type {};
+
+template <typename Shape, std::size_t Idx = 0>
+constexpr std::size_t shape_type_index()
+{
+    static_assert(Idx < std::variant_size_v<AllShapesDouble>);
+    if constexpr (std::is_same_v<Shape, std::variant_alternative_t<Idx, AllShapesDouble>>)
+        return Idx;
+    else
+        return shape_type_index<Shape, Idx + 1>();
+}
+
+template <std::size_t... Is>
+constexpr std::array<std::pair<std::size_t, std::size_t>, sizeof...(Is)> all_shape_layouts(std::index_sequence<Is...>)
+{
+    return { std::make_pair(ShapeLayout<std::variant_alternative_t<Is, AllShapesDouble>>::dim, ShapeLayout<std::variant_alternative_t<Is, AllShapesDouble>>::arity)... };
+}
+
+// Indexed by shape type: (dim, arity)
+constexpr auto SHAPE_LAYOUTS = all_shape_layouts(std::make_index_sequence<std::variant_size_v<AllShapesDouble>>{});
+
+// Location of a chunk in a SHB buffer
+struct ChunkLayout
+{
+    std::size_t shape_type;
+    bool closed;
+    std::size_t descr_offset;
+    std::size_t descr_size;
+    std::size_t coordinates_offset;
+    std::size_t nb_coordinates;
+    std::size_t indices_offset;
+    std::size_t nb_indices;
+};
+
+bool read_layout(std::string_view buffer, std::vector<ChunkLayout>& layout, const stdutils::io::ErrorHandler& err_handler)
+{
+    layout.clear();
+    if (buffer.size() < FILE_HEADER_SIZE || std::memcmp(buffer.data(), SHB_MAGIC.data(), SHB_MAGIC.size()) != 0)
+    {
+        err_handler(stdutils::io::Severity::ERR, "Not a SHB buffer");
+        return false;
+    }
+    const char* const data = buffer.data();
+    const auto version = load_le<std::uint16_t>(data + 8);
+    const auto compression = load_le<std::uint32_t>(data + 12);
+    const auto nb_chunks = load_le<std::uint64_t>(data + 16);
+    if (version != SHB_VERSION)
+    {
+        std::stringstream out;
+        out << "Unsupported SHB version: " << version;
+        err_handler(stdutils::io::Severity::ERR, out.str());
+        return false;
+    }
+    if (compression != SHB_NO_COMPRESSION)
+    {
+        std::stringstream out;
+        out << "Unsupported SHB compression: " << compression;
+        err_handler(stdutils::io::Severity::ERR, out.str());
+        return false;
+    }
+    std::size_t offset = FILE_HEADER_SIZE;
+    const auto remaining = [&buffer, &offset]() { return buffer.size() - offset; };
+    for (std::uint64_t chunk_idx = 0; chunk_idx < nb_chunks; chunk_idx++)
+    {
+        if (remaining() < CHUNK_HEADER_SIZE)
+        {
+            err_handler(stdutils::io::Severity::ERR, "Truncated SHB buffer");
+            return false;
+        }
+        ChunkLayout chunk;
+        chunk.shape_type = load_le<std::uint32_t>(data + offset);
+        chunk.closed = (load_le<std::uint32_t>(data + offset + 4) & CHUNK_FLAG_CLOSED) != 0;
+        const auto descr_size = load_le<std::uint64_t>(data + offset + 8);
+        const auto nb_coordinates = load_le<std::uint64_t>(data + offset + 16);
+        const auto nb_indices = load_le<std::uint64_t>(data + offset + 24);
+        offset += CHUNK_HEADER_SIZE;
+        if (chunk.shape_type >= SHAPE_LAYOUTS.size())
+        {
+            std::stringstream out;
+            out << "Unknown shape type in SHB chunk " << chunk_idx << ": " << chunk.shape_type;
+            err_handler(stdutils::io::Severity::ERR, out.str());
+            return false;
+        }
+        const auto [dim, arity] = SHAPE_LAYOUTS[chunk.shape_type];
+        const std::uint64_t max_count = remaining() / sizeof(std::uint32_t);     // Prevents overflows below
+        if (descr_size > remaining() || nb_coordinates > max_count || nb_indices > max_count
+            || nb_coordinates % dim != 0 || (arity == 0 ? nb_indices != 0 : nb_indices % arity != 0))
+        {
+            std::stringstream out;
+            out << "Invalid header of SHB chunk " << chunk_idx;
+            err_handler(stdutils::io::Severity::ERR, out.str());
+            return false;
+        }
+        chunk.descr_offset = offset;
+        chunk.descr_size = static_cast<std::size_t>(descr_size);
+        chunk.coordinates_offset = chunk.descr_offset + padded_size(chunk.descr_size);
+        chunk.nb_coordinates = static_cast<std::size_t>(nb_coordinates);
+        chunk.indices_offset = chunk.coordinates_offset + chunk.nb_coordinates * sizeof(double);
+        chunk.nb_indices = static_cast<std::size_t>(nb_indices);
+        offset = chunk.indices_offset + padded_size(chunk.nb_indices * sizeof(std::uint32_t));
+        if (offset > buffer.size())
+        {
+            err_handler(stdutils::io::Severity::ERR, "Truncated SHB buffer");
+            return false;
+        }
+        layout.push_back(chunk);
+    }
+    if (offset != buffer.size())
+    {
+        err_handler(stdutils::io::Severity::WARN, "Trailing bytes at the end of the SHB buffer were ignored");
+    }
+    return true;
+}
+
+template <typename P>
+void load_vertices(const char* data, const ChunkLayout& chunk, std::vector<P>& vertices)
+{
+    constexpr auto dim = static_cast<std::size_t>(P::dim);
+    static_assert(dim == 2 || dim == 3);
+    const std::size_t nb_vertices = chunk.nb_coordinates / dim;
+    vertices.clear();
+    vertices.reserve(nb_vertices);
+    const char* ptr = data + chunk.coordinates_offset;
+    for (std::size_t idx = 0; idx < nb_vertices; idx++, ptr += dim * sizeof(double))
+    {
+        if constexpr (dim == 2)
+            vertices.emplace_back(load_le<double>(ptr), load_le<double>(ptr + 8));
+        else
+            vertices.emplace_back(load_le<double>(ptr), load_le<double>(ptr + 8), load_le<double>(ptr + 16));
+    }
+}
+
+template <typename Shape>
+bool load_shape(const char* data, const ChunkLayout& chunk, Shape& shape)
+{
+    load_vertices(data, chunk, shape.vertices);
+    const char* ptr = data + chunk.indices_offset;
+    using Layout = ShapeLayout<Shape>;
+    if constexpr (Layout::arity == 2)
+    {
+        shape.indices.reserve(chunk.nb_indices / 2);
+        for (std::size_t idx = 0; idx < chunk.nb_indices; idx += 2, ptr += 8)
+            shape.indices.emplace_back(load_le<std::uint32_t>(ptr), load_le<std::uint32_t>(ptr + 4));
+        return shapes::is_valid(shape);
+    }
+    else if constexpr (Layout::arity == 3)
+    {
+        shape.faces.reserve(chunk.nb_indices / 3);
+        for (std::size_t idx = 0; idx < chunk.nb_indices; idx += 3, ptr += 12)
+            shape.faces.emplace_back(load_le<std::uint32_t>(ptr), load_le<std::uint32_t>(ptr + 4), load_le<std::uint32_t>(ptr + 8));
+        return shapes::is_valid(shape);
+    }
+    else
+    {
+        UNUSED(ptr);
+        if constexpr (HasClosedFlag<Shape>::value) { shape.closed = chunk.closed; }
+        return true;
+    }
+}
+
+template <std::size_t Idx = 0>
+bool load_shape_of_type(const char* data, const ChunkLayout& chunk, AllShapesDouble& shape)
+{
+    if constexpr (Idx < std::variant_size_v<AllShapesDouble>)
+    {
+        if (chunk.shape_type == Idx)
+        {
+            return load_shape(data, chunk, shape.template emplace<Idx>());
+        }
+        return load_shape_of_type<Idx + 1>(data, chunk, shape);
+    }
+    else
+    {
+        assert(0);
+        return false;
+    }
+}
+
+ShapeAggregate<double> parse_shapes_from_buffer_gen(std::string_view buffer, const stdutils::io::ErrorHandler& err_handler)
+{
+    STDUTILS_PROFILE_ZONE("shb::parse_shapes");
+    ShapeAggregate<double> result;
+    std::vector<ChunkLayout> layout;
+    if (!read_layout(buffer, layout, err_handler)) { return result; }
+    result.reserve(layout.size());
+    for (std::size_t chunk_idx = 0; chunk_idx < layout.size(); chunk_idx++)
+    {
+        const auto& chunk = layout[chunk_idx];
+        AllShapesDouble shape;
+        if (!load_shape_of_type(buffer.data(), chunk, shape))
+        {
+            std::stringstream out;
+            out << "Invalid indices in SHB chunk " << chunk_idx << ". The shape was ignored.";
+            err_handler(stdutils::io::Severity::WARN, out.str());
+            continue;
+        }
+        result.emplace_back(std::move(shape), std::string(buffer.substr(chunk.descr_offset, chunk.descr_size)));
+    }
+    return result;
+}
+
+template <typename P, typename I>
+shapes::Soup<P, I> parse_soup_from_buffer_gen(std::string_view buffer, const stdutils::io::ErrorHandler& err_handler)
+{
+    shapes::Soup<P, I> result;
+    auto shapes = parse_shapes_from_buffer_gen(buffer, err_handler);
+    for (auto& shape_wrapper : shapes)
+    {
+        std::visit(stdutils::Overloaded {
+            [&result](PointCloud<P>& pc) { result.point_cloud.vertices.insert(result.point_cloud.vertices.end(), pc.vertices.cbegin(), pc.vertices.cend()); },
+            [&result](Edges<P, I>& edges) { if (result.edges.vertices.empty()) { result.edges = std::move(edges); } },
+            [&result](Triangles<P, I>& triangles) { if (result.triangles.vertices.empty()) { result.triangles = std::move(triangles); } },
+            [&err_handler, &shape_wrapper](const auto&) {
+                std::stringstream out;
+                out << "Input shape of type " << shapes::get_type_str(shape_wrapper.shape) << " is not supported and was filtered out";
+                err_handler(stdutils::io::Severity::WARN, out.str());
+            }
+        }, shape_wrapper.shape);
+    }
+    return result;
+}
+
+void write_file_header(std::ostream& out, std::size_t nb_chunks)
+{
+    out.write(SHB_MAGIC.data(), static_cast<std::streamsize>(SHB_MAGIC.size()));
+    write_le<std::uint16_t>(out, SHB_VERSION);
+    write_le<std::uint16_t>(out, 0);
+    write_le<std::uint32_t>(out, SHB_NO_COMPRESSION);
+    write_le<std::uint64_t>(out, nb_chunks);
+}
+
+template <typename Shape>
+void write_chunk(std::ostream& out, const Shape& shape, std::string_view descr)
+{
+    using Layout = ShapeLayout<Shape>;
+    constexpr auto shape_type = static_cast<std::uint32_t>(shape_type_index<Shape>());
+    std::uint32_t flags = 0;
+    std::size_t nb_indices = 0;
+    if constexpr (Layout::arity == 2) { nb_indices = 2 * shape.indices.size(); }
+    else if constexpr (Layout::arity == 3) { nb_indices = 3 * shape.faces.size(); }
+    else if constexpr (HasClosedFlag<Shape>::value) { if (shape.closed) { flags |= CHUNK_FLAG_CLOSED; } }
+    write_le<std::uint32_t>(out, shape_type);
+    write_le<std::uint32_t>(out, flags);
+    write_le<std::uint64_t>(out, descr.size());
+    write_le<std::uint64_t>(out, Layout::dim * shape.vertices.size());
+    write_le<std::uint64_t>(out, nb_indices);
+    out.write(descr.data(), static_cast<std::streamsize>(descr.size()));
+    write_padding(out, descr.size());
+    for (const auto& p : shape.vertices)
+    {
+        write_le<double>(out, p.x);
+        write_le<double>(out, p.y);
+        if constexpr (Layout::dim == 3) { write_le<double>(out, p.z); }
+    }
+    if constexpr (Layout::arity == 2)
+    {
+        for (const auto& e : shape.indices) { write_le<std::uint32_t>(out, e[0]); write_le<std::uint32_t>(out, e[1]); }
+    }
+    else if constexpr (Layout::arity == 3)
+    {
+        for (const auto& f : shape.faces) { write_le<std::uint32_t>(out, f[0]); write_le<std::uint32_t>(out, f[1]); write_le<std::uint32_t>(out, f[2]); }
+    }
+    write_padding(out, nb_indices * sizeof(std::uint32_t));
+}
+
+void save_shapes_as_stream_gen(std::ostream& out, const ShapeAggregate<double>& shapes, const stdutils::io::ErrorHandler& err_handler)
+{
+    UNUSED(err_handler);
+    write_file_header(out, shapes.size());
+    for (const auto& shape_wrapper : shapes)
+    {
+        std::visit([&out, &shape_wrapper](const auto& shape) { write_chunk(out, shape, shape_wrapper.descr); }, shape_wrapper.shape);
+    }
+}
+
+template <typename P, typename I>
+void save_soup_as_stream_gen(std::ostream& out, const shapes::Soup<P, I>& soup, const stdutils::io::ErrorHandler& err_handler)
+{
+    static_assert(std::is_same_v<typename P::scalar, double> && std::is_same_v<I, std::uint32_t>);
+    UNUSED(err_handler);
+    write_file_header(out, 3);
+    write_chunk(out, soup.point_cloud, "");
+    write_chunk(out, soup.edges, "");
+    write_chunk(out, soup.triangles, "");
+}
+
+} // namespace
+
+bool view_chunks(std::string_view buffer, std::vector<ChunkView>& chunks, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    chunks.clear();
+    try
+    {
+        if (!host_is_little_endian())
+        {
+            err_handler(stdutils::io::Severity::ERR, "A SHB buffer cannot be accessed in place on a big-endian host");
+            return false;
+        }
+        if (reinterpret_cast<std::uintptr_t>(buffer.data()) % SHB_ALIGNMENT != 0)
+        {
+            err_handler(stdutils::io::Severity::ERR, "A SHB buffer must be 8-byte aligned to be accessed in place");
+            return false;
+        }
+        std::vector<ChunkLayout> layout;
+        if (!read_layout(buffer, layout, err_handler)) { return false; }
+        chunks.reserve(layout.size());
+        for (const auto& chunk : layout)
+        {
+            ChunkView& view = chunks.emplace_back();
+            view.shape_type = chunk.shape_type;
+            view.closed = chunk.closed;
+            view.descr = buffer.substr(chunk.descr_offset, chunk.descr_size);
+            if (chunk.nb_coordinates > 0)
+                view.coordinates = stdutils::Span<const double>(reinterpret_cast<const double*>(buffer.data() + chunk.coordinates_offset), chunk.nb_coordinates);
+            if (chunk.nb_indices > 0)
+                view.indices = stdutils::Span<const std::uint32_t>(reinterpret_cast<const std::uint32_t*>(buffer.data() + chunk.indices_offset), chunk.nb_indices);
+        }
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream oss;
+        oss << "Exception: " << e.what();
+        err_handler(stdutils::io::Severity::EXCPT, oss.str());
+    }
+    chunks.clear();
+    return false;
+}
+
+ShapeAggregate<double> parse_shapes_from_buffer(std::string_view buffer, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    try
+    {
+        return parse_shapes_from_buffer_gen(buffer, err_handler);
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream oss;
+        oss << "Exception: " << e.what();
+        err_handler(stdutils::io::Severity::EXCPT, oss.str());
+    }
+    return ShapeAggregate<double>();
+}
+
+ShapeAggregate<double> parse_shapes_from_file(std::filesystem::path filepath, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    return stdutils::io::open_and_parse_mapped_file<ShapeAggregate<double>>(filepath, parse_shapes_from_buffer_gen, err_handler);
+}
+
+shapes::Soup2d<double> parse_2d_shapes_from_file(std::filesystem::path filepath, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    using P = shapes::Point2d<double>;
+    using I = std::uint32_t;
+    return stdutils::io::open_and_parse_mapped_file<shapes::Soup<P, I>>(filepath, parse_soup_from_buffer_gen<P, I>, err_handler);
+}
+
+shapes::Soup3d<double> parse_3d_shapes_from_file(std::filesystem::path filepath, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    using P = shapes::Point3d<double>;
+    using I = std::uint32_t;
+    return stdutils::io::open_and_parse_mapped_file<shapes::Soup<P, I>>(filepath, parse_soup_from_buffer_gen<P, I>, err_handler);
+}
+
+void save_shapes_as_stream(std::ostream& outputstream, const ShapeAggregate<double>& shapes, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    try
+    {
+        save_shapes_as_stream_gen(outputstream, shapes, err_handler);
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream oss;
+        oss << "Exception: " << e.what();
+        err_handler(stdutils::io::Severity::EXCPT, oss.str());
+    }
+}
+
+void save_shapes_as_file(std::filesystem::path filepath, const ShapeAggregate<double>& shapes, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    stdutils::io::save_bin_file<ShapeAggregate<double>, char>(filepath, save_shapes_as_stream_gen, shapes, err_handler);
+}
+
+void save_shapes_as_file(std::filesystem::path filepath, const shapes::Soup2d<double>& soup, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    using P = shapes::Point2d<double>;
+    using I = std::uint32_t;
+    stdutils::io::save_bin_file<shapes::Soup<P, I>, char>(filepath, save_soup_as_stream_gen<P, I>, soup, err_handler);
+}
+
+void save_shapes_as_file(std::filesystem::path filepath, const shapes::Soup3d<double>& soup, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    using P = shapes::Point3d<double>;
+    using I = std::uint32_t;
+    stdutils::io::save_bin_file<shapes::Soup<P, I>, char>(filepath, save_soup_as_stream_gen<P, I>, soup, err_handler);
+}
+
+} // namespace shb
+
+} // namespace io
+} // namespace shapes
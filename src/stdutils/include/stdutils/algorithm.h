@@ -3,14 +3,28 @@
 #pragma once
 
 #include <stdutils/enum.h>
+#include <stdutils/parallel.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <limits>
+#include <numeric>
 #include <queue>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
+#include <vector>
+
+// The standard parallel algorithms, if the standard library implements them. Define STDUTILS_NO_STD_EXECUTION to opt out, e.g. with
+// libstdc++ when TBB, its parallel backend, is not linked.
+#if defined(__cpp_lib_parallel_algorithm) && !defined(STDUTILS_NO_STD_EXECUTION)
+#define STDUTILS_STD_EXECUTION 1
+#include <execution>
+#endif
 
 namespace stdutils {
 
@@ -84,6 +98,26 @@ void merge(C<T>& dst, const C<T>& src, Compare comp);
 template <typename Func>
 void repeat_n_times(std::size_t n, Func f);
 
+// Stable LSD radix sort of a range by a floating-point key, float or double, returned by key(elt).
+// The pairs (key bits, index) are sorted one byte at a time, with the histograms and the scatter of each pass computed concurrently on
+// the chunks of the policy, then the elements are permuted once. The order is that of operator< on the keys, except that -0.0 is sorted
+// before +0.0, and the NaNs are sorted at both ends depending on their sign. The passes on a byte that is the same for all the keys are skipped.
+template <typename RandomIt, typename KeyFunc>
+void radix_sort_by_key(const parallel::Policy& policy, RandomIt first, RandomIt last, KeyFunc key);
+
+// Parallel algorithms, with std::execution::par if STDUTILS_STD_EXECUTION is defined, otherwise with the chunks of stdutils/parallel.h.
+// The inputs that fit in a single chunk of the policy are processed sequentially, by the standard algorithm.
+//  - parallel_reduce: op must be associative and commutative, as for std::reduce. init is only used once.
+//  - parallel_partition: Not stable.
+template <typename RandomIt, typename Compare>
+void parallel_sort(const parallel::Policy& policy, RandomIt first, RandomIt last, Compare comp);
+template <typename RandomIt1, typename RandomIt2, typename UnaryOp>
+RandomIt2 parallel_transform(const parallel::Policy& policy, RandomIt1 first, RandomIt1 last, RandomIt2 d_first, UnaryOp op);
+template <typename RandomIt, typename T, typename BinaryOp>
+T parallel_reduce(const parallel::Policy& policy, RandomIt first, RandomIt last, T init, BinaryOp op);
+template <typename RandomIt, typename UnaryPred>
+RandomIt parallel_partition(const parallel::Policy& policy, RandomIt first, RandomIt last, UnaryPred pred);
+
 
 //
 //
@@ -223,4 +257,230 @@ void repeat_n_times(std::size_t n, Func f)
     while (n--) { f(); }
 }
 
+namespace details {
+namespace radix {
+
+// Map the bits of a floating-point number to an unsigned integer with the same order
+template <typename F>
+auto ordered_bits(F f)
+{
+    static_assert(std::is_floating_point_v<F> && std::numeric_limits<F>::is_iec559);
+    static_assert(sizeof(F) == 4 || sizeof(F) == 8);
+    using U = std::conditional_t<sizeof(F) == 4, std::uint32_t, std::uint64_t>;
+    constexpr U sign_mask = U{1} << (8 * sizeof(U) - 1);
+    U bits;
+    std::memcpy(&bits, &f, sizeof(U));
+    return (bits & sign_mask) ? static_cast<U>(~bits) : static_cast<U>(bits | sign_mask);
+}
+
+template <typename U, typename Idx>
+void sort_pairs(const parallel::Policy& policy, std::vector<std::pair<U, Idx>>& pairs)
+{
+    constexpr std::size_t nb_buckets = 256;
+    using Histogram = std::array<std::size_t, nb_buckets>;
+    const std::size_t n = pairs.size();
+    const std::size_t chunks = parallel::nb_chunks(policy, n);
+    std::vector<std::pair<U, Idx>> buffer(n);
+    std::vector<Histogram> histograms(chunks);
+    for (unsigned int shift = 0; shift < 8 * sizeof(U); shift += 8)
+    {
+        const auto digit = [shift](U k) { return static_cast<std::size_t>((k >> shift) & U{0xff}); };
+        parallel::for_each_chunk(policy, n, [&](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+            auto& histogram = histograms[chunk_idx];
+            histogram.fill(0);
+            for (std::size_t idx = begin_idx; idx < end_idx; idx++) { histogram[digit(pairs[idx].first)]++; }
+        });
+
+        // Offsets of each chunk in each bucket, in the order of the chunks for the sort to be stable
+        std::size_t offset = 0;
+        bool single_bucket = false;
+        for (std::size_t b = 0; b < nb_buckets; b++)
+        {
+            const std::size_t bucket_begin = offset;
+            for (auto& histogram : histograms)
+            {
+                const std::size_t count = histogram[b];
+                histogram[b] = offset;
+                offset += count;
+            }
+            single_bucket |= (offset - bucket_begin == n);
+        }
+        if (single_bucket)
+            continue;
+        parallel::for_each_chunk(policy, n, [&](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+            auto& offsets = histograms[chunk_idx];
+            for (std::size_t idx = begin_idx; idx < end_idx; idx++) { buffer[offsets[digit(pairs[idx].first)]++] = pairs[idx]; }
+        });
+        pairs.swap(buffer);
+    }
+}
+
+template <typename Idx, typename RandomIt, typename KeyFunc>
+void radix_sort_by_key(const parallel::Policy& policy, RandomIt first, RandomIt last, KeyFunc key)
+{
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    using U = decltype(ordered_bits(key(*first)));
+    const auto n = static_cast<std::size_t>(std::distance(first, last));
+    const auto it = [first](std::size_t idx) { return first + static_cast<typename std::iterator_traits<RandomIt>::difference_type>(idx); };
+    std::vector<std::pair<U, Idx>> pairs(n);
+    parallel::for_each_chunk(policy, n, [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++) { pairs[idx] = std::make_pair(ordered_bits(key(*it(idx))), static_cast<Idx>(idx)); }
+    });
+    sort_pairs(policy, pairs);
+
+    // Permute the elements
+    std::vector<T> sorted;
+    sorted.reserve(n);
+    for (const auto& p : pairs) { sorted.push_back(std::move(*it(static_cast<std::size_t>(p.second)))); }
+    parallel::for_each_chunk(policy, n, [&](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        std::move(sorted.begin() + static_cast<std::ptrdiff_t>(begin_idx), sorted.begin() + static_cast<std::ptrdiff_t>(end_idx), it(begin_idx));
+    });
+}
+
+} // namespace radix
+} // namespace details
+
+template <typename RandomIt, typename KeyFunc>
+void radix_sort_by_key(const parallel::Policy& policy, RandomIt first, RandomIt last, KeyFunc key)
+{
+    static_assert(std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<RandomIt>::iterator_category>);
+    assert(first <= last);
+    const auto n = static_cast<std::size_t>(std::distance(first, last));
+    if (n < 2)
+        return;
+    if (n <= std::numeric_limits<std::uint32_t>::max())
+        details::radix::radix_sort_by_key<std::uint32_t>(policy, first, last, key);
+    else
+        details::radix::radix_sort_by_key<std::size_t>(policy, first, last, key);
+}
+
+namespace details {
+
+template <typename RandomIt>
+bool is_sequential(const parallel::Policy& policy, RandomIt first, RandomIt last)
+{
+    static_assert(std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<RandomIt>::iterator_category>);
+    assert(first <= last);
+    return parallel::nb_chunks(policy, static_cast<std::size_t>(std::distance(first, last))) == 1;
+}
+
+template <typename RandomIt>
+RandomIt iter_at(RandomIt it, std::size_t idx)
+{
+    return it + static_cast<typename std::iterator_traits<RandomIt>::difference_type>(idx);
+}
+
+// The chunks are partitioned concurrently, then the elements that do not satisfy pred in [first, first + nb_true) are swapped
+// concurrently, in order, with the elements that satisfy pred in [first + nb_true, last).
+template <typename RandomIt, typename UnaryPred>
+RandomIt chunked_partition(const parallel::Policy& policy, RandomIt first, RandomIt last, UnaryPred pred)
+{
+    using Segment = std::pair<std::size_t, std::size_t>;
+    const auto n = static_cast<std::size_t>(std::distance(first, last));
+    const std::size_t chunks = parallel::nb_chunks(policy, n);
+    std::vector<Segment> chunk_bounds(chunks);
+    std::vector<std::size_t> chunk_mid(chunks);
+    parallel::for_each_chunk(policy, n, [&](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+        chunk_bounds[chunk_idx] = std::make_pair(begin_idx, end_idx);
+        chunk_mid[chunk_idx] = static_cast<std::size_t>(std::distance(first, std::partition(iter_at(first, begin_idx), iter_at(first, end_idx), pred)));
+    });
+    std::size_t nb_true = 0;
+    for (std::size_t chunk_idx = 0; chunk_idx < chunks; chunk_idx++) { nb_true += chunk_mid[chunk_idx] - chunk_bounds[chunk_idx].first; }
+
+    // The misplaced segments, and the prefix sums of their sizes
+    std::vector<Segment> false_segments;
+    std::vector<Segment> true_segments;
+    for (std::size_t chunk_idx = 0; chunk_idx < chunks; chunk_idx++)
+    {
+        const auto [begin_idx, end_idx] = chunk_bounds[chunk_idx];
+        const std::size_t mid_idx = chunk_mid[chunk_idx];
+        if (mid_idx < nb_true && mid_idx < end_idx) { false_segments.emplace_back(mid_idx, std::min(end_idx, nb_true)); }
+        if (nb_true < mid_idx && begin_idx < mid_idx) { true_segments.emplace_back(std::max(begin_idx, nb_true), mid_idx); }
+    }
+    const auto prefix_sums = [](const std::vector<Segment>& segments) {
+        std::vector<std::size_t> result(1, 0);
+        for (const auto& [begin_idx, end_idx] : segments) { result.push_back(result.back() + end_idx - begin_idx); }
+        return result;
+    };
+    const auto false_offsets = prefix_sums(false_segments);
+    const auto true_offsets = prefix_sums(true_segments);
+    assert(false_offsets.back() == true_offsets.back());
+    const auto position = [](const std::vector<Segment>& segments, const std::vector<std::size_t>& offsets, std::size_t k) {
+        const auto seg_idx = static_cast<std::size_t>(std::distance(offsets.cbegin(), std::upper_bound(offsets.cbegin(), offsets.cend(), k))) - 1;
+        return segments[seg_idx].first + (k - offsets[seg_idx]);
+    };
+    parallel::for_each_chunk(policy, false_offsets.back(), [&](std::size_t, std::size_t begin_k, std::size_t end_k) {
+        for (std::size_t k = begin_k; k < end_k; k++)
+        {
+            std::iter_swap(iter_at(first, position(false_segments, false_offsets, k)), iter_at(first, position(true_segments, true_offsets, k)));
+        }
+    });
+    return iter_at(first, nb_true);
+}
+
+} // namespace details
+
+template <typename RandomIt, typename Compare>
+void parallel_sort(const parallel::Policy& policy, RandomIt first, RandomIt last, Compare comp)
+{
+    if (details::is_sequential(policy, first, last))
+    {
+        std::sort(first, last, comp);
+        return;
+    }
+#if defined(STDUTILS_STD_EXECUTION)
+    std::sort(std::execution::par, first, last, comp);
+#else
+    parallel::sort(policy, first, last, comp);
+#endif
+}
+
+template <typename RandomIt1, typename RandomIt2, typename UnaryOp>
+RandomIt2 parallel_transform(const parallel::Policy& policy, RandomIt1 first, RandomIt1 last, RandomIt2 d_first, UnaryOp op)
+{
+    if (details::is_sequential(policy, first, last))
+        return std::transform(first, last, d_first, op);
+#if defined(STDUTILS_STD_EXECUTION)
+    return std::transform(std::execution::par, first, last, d_first, op);
+#else
+    static_assert(std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<RandomIt2>::iterator_category>);
+    const auto n = static_cast<std::size_t>(std::distance(first, last));
+    parallel::for_each_chunk(policy, n, [first, d_first, &op](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        std::transform(details::iter_at(first, begin_idx), details::iter_at(first, end_idx), details::iter_at(d_first, begin_idx), op);
+    });
+    return details::iter_at(d_first, n);
+#endif
+}
+
+template <typename RandomIt, typename T, typename BinaryOp>
+T parallel_reduce(const parallel::Policy& policy, RandomIt first, RandomIt last, T init, BinaryOp op)
+{
+    if (details::is_sequential(policy, first, last))
+        return std::accumulate(first, last, std::move(init), op);
+#if defined(STDUTILS_STD_EXECUTION)
+    return std::reduce(std::execution::par, first, last, std::move(init), op);
+#else
+    // The chunks are not empty, see parallel::nb_chunks()
+    const auto n = static_cast<std::size_t>(std::distance(first, last));
+    std::vector<T> partials(parallel::nb_chunks(policy, n), init);
+    parallel::for_each_chunk(policy, n, [first, &op, &partials](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+        const auto chunk_first = details::iter_at(first, begin_idx);
+        partials[chunk_idx] = std::accumulate(std::next(chunk_first), details::iter_at(first, end_idx), T(*chunk_first), op);
+    });
+    return std::accumulate(partials.begin(), partials.end(), std::move(init), op);
+#endif
+}
+
+template <typename RandomIt, typename UnaryPred>
+RandomIt parallel_partition(const parallel::Policy& policy, RandomIt first, RandomIt last, UnaryPred pred)
+{
+    if (details::is_sequential(policy, first, last))
+        return std::partition(first, last, pred);
+#if defined(STDUTILS_STD_EXECUTION)
+    return std::partition(std::execution::par, first, last, pred);
+#else
+    return details::chunked_partition(policy, first, last, pred);
+#endif
+}
+
 } // namespace stdutils
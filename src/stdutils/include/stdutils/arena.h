@@ -0,0 +1,162 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
+namespace stdutils {
+
+/**
+ * Monotonic arena for the transient buffers of a job
+ *
+ * The allocations are served from one buffer by bumping a pointer, deallocating is a no-op, and all the memory is released at once by reset().
+ * When a job overflows the buffer, the extra memory is taken from the global heap, and the next reset() grows the buffer to the high-water
+ * mark of that job: In the steady state of a service running similar jobs, the transient buffers do not allocate at all.
+ *
+ * There is no bookkeeping per allocation, so an arena is meant for a few large buffers (vectors), not for node-based containers.
+ * The allocations are serialized by a mutex, so that the concurrent subtasks of a job can share its arena.
+ *
+ * Usage:
+ *
+ *  stdutils::Arena arena;
+ *  for (const auto& job : jobs)
+ *  {
+ *      stdutils::ArenaVector<int> buffer(stdutils::ArenaAllocator<int>(&arena));
+ *      ...
+ *      arena.reset();              // Once the buffers of the job are destroyed
+ *  }
+ */
+class Arena
+{
+public:
+    explicit Arena(std::size_t initial_capacity = 0);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // The alignment must be a power of two
+    void* allocate(std::size_t bytes, std::size_t alignment);
+
+    // Release all the allocations. None of them must be in use.
+    void reset();
+
+    std::size_t capacity() const noexcept;                  // Size of the buffer, in bytes
+    std::size_t high_water_mark() const noexcept;           // Largest number of bytes allocated between two resets, padding included
+    std::size_t nb_overflows() const noexcept;              // Number of allocations served by the heap since the latest reset
+
+private:
+    struct Overflow
+    {
+        void* ptr;
+        std::size_t alignment;
+    };
+
+    void release_overflows() noexcept;
+
+    mutable std::mutex m_mutex;
+    std::byte* m_buffer;
+    std::size_t m_capacity;
+    std::size_t m_offset;
+    std::size_t m_allocated;                                // Since the latest reset, including the overflows
+    std::size_t m_high_water_mark;
+    std::vector<Overflow> m_overflows;
+};
+
+/**
+ * Allocator of the STL containers in an arena
+ *
+ * A default-constructed allocator, or one with a null arena, allocates on the global heap: The same container type serves both cases.
+ */
+template <typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = ArenaAllocator<U>; };
+
+    ArenaAllocator() noexcept : m_arena(nullptr) {}
+    explicit ArenaAllocator(Arena* arena) noexcept : m_arena(arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_arena(other.arena()) {}
+
+    T* allocate(std::size_t n);
+    void deallocate(T* ptr, std::size_t n) noexcept;
+
+    Arena* arena() const noexcept { return m_arena; }
+
+private:
+    Arena* m_arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept { return lhs.arena() == rhs.arena(); }
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept { return lhs.arena() != rhs.arena(); }
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#if defined(__cpp_lib_memory_resource)
+/**
+ * Adapter of an arena to the std::pmr containers
+ */
+class ArenaResource : public std::pmr::memory_resource
+{
+public:
+    explicit ArenaResource(Arena& arena) noexcept : m_arena(arena) {}
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override { return m_arena.allocate(bytes, alignment); }
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        const auto* other_arena = dynamic_cast<const ArenaResource*>(&other);
+        return other_arena != nullptr && &other_arena->m_arena == &m_arena;
+    }
+
+    Arena& m_arena;
+};
+#endif
+
+
+//
+//
+// Implementation
+//
+//
+
+
+template <typename T>
+T* ArenaAllocator<T>::allocate(std::size_t n)
+{
+    if (m_arena)
+        return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+    else
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+}
+
+template <typename T>
+void ArenaAllocator<T>::deallocate(T* ptr, std::size_t) noexcept
+{
+    if (m_arena)
+        return;
+    if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        ::operator delete(ptr, std::align_val_t{alignof(T)});
+    else
+        ::operator delete(ptr);
+}
+
+} // namespace stdutils
@@ -0,0 +1,139 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <stdutils/stats.h>
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+namespace stdutils {
+namespace benchmark {
+
+/**
+ * Statistical benchmark harness
+ *
+ * The function under test runs a few times to warm up the caches, then it is repeated until the 95% confidence interval of the mean
+ * duration is narrow enough, or the limits on the number of runs or on the time budget are reached. The outliers, e.g. the runs
+ * interrupted by the OS, are rejected with the median absolute deviation (MAD) before the statistics are computed.
+ *
+ * Usage:
+ *
+ *  const auto report = stdutils::benchmark::run([&]() { return algo(input); });
+ *  std::cout << report << std::endl;
+ *
+ * The setup of each run may be excluded from the measurement:
+ *
+ *  const auto report = stdutils::benchmark::run_with_setup([&]() { return input; }, [](auto& input_cpy) { return algo(input_cpy); });
+ */
+struct Settings
+{
+    unsigned int warmup_runs{1};
+    unsigned int min_runs{5};
+    unsigned int max_runs{100};
+    double target_ci_ratio{0.02};               // Target half width of the confidence interval, relative to the mean
+    double outlier_threshold{3.0};              // Threshold on |sample - median|, in number of MADs scaled to a standard deviation
+    std::chrono::milliseconds time_budget{10000};   // Checked after each run, once min_runs is reached
+};
+
+struct Report
+{
+    stats::Result<double> result;               // Durations in milliseconds, outliers excluded. With the median.
+    double ci_half_width{0.0};                  // Half width of the 95% confidence interval of the mean, in milliseconds
+    std::size_t nb_outliers{0};
+    bool converged{false};                      // The target width of the confidence interval was reached
+    std::vector<double> samples_ms;             // All the measured samples, outliers included, in the order of the runs
+};
+
+// Compute the statistics of the samples, without the outliers
+Report analyze(std::vector<double> samples_ms, const Settings& settings = Settings());
+
+// Same format as the output of stats::Result, followed by the confidence interval and the number of outliers
+std::ostream& operator<<(std::ostream& out, const Report& report);
+
+// Prevent the compiler from optimizing away a result that is otherwise unused
+template <typename T>
+void do_not_optimize(const T& value);
+
+// Measure func()
+template <typename Func>
+Report run(Func&& func, const Settings& settings = Settings());
+
+// Measure func(setup()): The call to setup() is not measured
+template <typename Setup, typename Func>
+Report run_with_setup(Setup&& setup, Func&& func, const Settings& settings = Settings());
+
+
+//
+//
+// Implementation
+//
+//
+
+
+namespace details {
+
+// Defined in a separate translation unit, so that the compiler cannot see through it
+void use_char_pointer(const volatile char* ptr);
+
+template <typename Func, typename State>
+void call_and_sink(Func& func, State& state)
+{
+    if constexpr (std::is_void_v<decltype(func(state))>)
+        func(state);
+    else
+        do_not_optimize(func(state));
+}
+
+} // namespace details
+
+template <typename T>
+void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    details::use_char_pointer(&reinterpret_cast<const volatile char&>(value));
+#endif
+}
+
+template <typename Func>
+Report run(Func&& func, const Settings& settings)
+{
+    return run_with_setup([]() { return 0; }, [&func](int) { return func(); }, settings);
+}
+
+template <typename Setup, typename Func>
+Report run_with_setup(Setup&& setup, Func&& func, const Settings& settings)
+{
+    for (unsigned int warmup = 0; warmup < settings.warmup_runs; warmup++)
+    {
+        auto state = setup();
+        details::call_and_sink(func, state);
+    }
+    std::vector<double> samples_ms;
+    samples_ms.reserve(settings.max_runs);
+    Report report;
+    const auto deadline = std::chrono::steady_clock::now() + settings.time_budget;
+    while (samples_ms.size() < settings.max_runs)
+    {
+        auto state = setup();
+        const auto start = std::chrono::steady_clock::now();
+        details::call_and_sink(func, state);
+        const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+        samples_ms.push_back(duration.count());
+        if (samples_ms.size() < settings.min_runs)
+            continue;
+        report = analyze(samples_ms, settings);
+        if (report.converged || std::chrono::steady_clock::now() > deadline)
+            break;
+    }
+    if (report.samples_ms.size() != samples_ms.size()) { report = analyze(std::move(samples_ms), settings); }
+    return report;
+}
+
+} // namespace benchmark
+} // namespace stdutils
@@ -0,0 +1,58 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <stdutils/io.h>
+#include <stdutils/parallel.h>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace stdutils {
+namespace io {
+
+/**
+ * Compressed files
+ *
+ * The formats are supported if the library is built with zlib (gzip) and libzstd (zstd), see the CMake options DELAUNAY_VIEWER_GZIP
+ * and DELAUNAY_VIEWER_ZSTD. The functions open_and_parse_txt_file(), open_and_parse_bin_file() and open_and_parse_mapped_file() detect
+ * a compressed file by its magic number and decompress it in memory before passing it to the parser. The functions save_txt_file() and
+ * save_bin_file() compress the output if the extension of the file is ".gz" or ".zst".
+ *
+ * The zstd output is a sequence of independent frames of frame_size bytes of input, compressed concurrently, and which record their
+ * decompressed size. On decompression, such a sequence of frames is decompressed concurrently; any other zstd input, e.g. from the zstd
+ * command line tool, is decompressed sequentially. The gzip format does not allow that: It is compressed and decompressed sequentially.
+ * The concatenated gzip members or zstd frames are decompressed as a single stream.
+ */
+enum class Compression
+{
+    None,
+    Gzip,
+    Zstd
+};
+
+std::string_view str_compression(Compression compression) noexcept;
+
+// True if the library was built with the support of that format. Compression::None is always supported.
+bool is_supported(Compression compression) noexcept;
+
+// Detect the format from the first bytes of a buffer
+Compression compression_from_magic(std::string_view header) noexcept;
+
+// Detect the format from the extension of a file path: ".gz" or ".zst"
+Compression compression_from_extension(const std::filesystem::path& filepath);
+
+struct CompressionOptions
+{
+    int level = 0;                                      // 0: Default level of the format
+    std::size_t frame_size = std::size_t{4} << 20;      // zstd only
+    stdutils::parallel::Policy policy{};
+};
+
+// Return false on error, or if the format is not supported. The output is overwritten.
+bool compress(Compression compression, std::string_view input, std::string& output, const ErrorHandler& err_handler, const CompressionOptions& options = CompressionOptions());
+bool decompress(Compression compression, std::string_view input, std::string& output, const ErrorHandler& err_handler, const stdutils::parallel::Policy& policy = stdutils::parallel::Policy());
+
+} // namespace io
+} // namespace stdutils
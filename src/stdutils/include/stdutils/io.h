@@ -11,7 +11,11 @@
 #include <fstream>
 #include <limits>
 #include <sstream>
+#include <streambuf>
+#include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace stdutils {
@@ -43,6 +47,65 @@ using ErrorMessage = std::string_view;
 
 using ErrorHandler = std::function<void(SeverityCode, ErrorMessage)>;
 
+/**
+ * Record the messages sent to an error handler, to forward them later to another error handler
+ *
+ * E.g. to report the messages of concurrent tasks on a single thread, and in a deterministic order.
+ */
+class ErrorLog
+{
+public:
+    // The handler records the messages in this object, therefore it must not outlive it
+    ErrorHandler handler();
+
+    void forward(const ErrorHandler& err_handler) const;
+
+    bool empty() const noexcept { return m_messages.empty(); }
+    void clear() noexcept { m_messages.clear(); }
+
+private:
+    std::vector<std::pair<SeverityCode, std::string>> m_messages;
+};
+
+/**
+ * Severity threshold of the process
+ *
+ * The messages less severe than the threshold (i.e. with a greater code) are not displayed by the applications, therefore the producers
+ * of messages that are expensive to format check it first. By default, all the codes up to TRACE are enabled.
+ */
+void set_severity_threshold(SeverityCode threshold) noexcept;
+SeverityCode severity_threshold() noexcept;
+bool is_severity_enabled(SeverityCode code) noexcept;
+
+/**
+ * Aggregation of a repeated message, e.g. a warning for each invalid record of a parser
+ *
+ * The first occurrences, up to max_messages, are formatted and sent to the error handler, provided their severity is enabled. The other
+ * ones are only counted, and the destructor sends their number in a summary message: "<what>: <count> more were not reported".
+ */
+class RepeatedMessage
+{
+public:
+    RepeatedMessage(const ErrorHandler& err_handler, SeverityCode code, std::string_view what, std::size_t max_messages = 10);
+    ~RepeatedMessage();
+    RepeatedMessage(const RepeatedMessage&) = delete;
+    RepeatedMessage& operator=(const RepeatedMessage&) = delete;
+
+    // Called as format(std::ostream&), only if the message is sent
+    template <typename Format>
+    void operator()(Format&& format);
+
+    std::size_t count() const noexcept { return m_count; }
+
+private:
+    const ErrorHandler& m_err_handler;
+    const SeverityCode m_code;
+    const std::string m_what;
+    const std::size_t m_max_messages;
+    const bool m_enabled;
+    std::size_t m_count;
+};
+
 /**
  * Floating point IO precision
  *
@@ -78,6 +141,8 @@ private:
 
 /**
  * Pass a file to a parser of std::basic_istream
+ *
+ * A gzip or zstd compressed file of char is decompressed in memory, before being passed to the parser (see stdutils/compression.h).
  */
 template <typename Ret, typename CharT>
 using StreamParser = std::function<Ret(std::basic_istream<CharT, std::char_traits<CharT>>&, const stdutils::io::ErrorHandler&)>;
@@ -89,6 +154,8 @@ Ret open_and_parse_bin_file(const std::filesystem::path& filepath, const StreamP
 
 /**
  * Save a file with a writer to std::basic_ostream
+ *
+ * If the extension of the file is ".gz" or ".zst", the output of a writer of char is compressed in memory before being saved.
  */
 template <typename Obj, typename CharT>
 using StreamWriter = std::function<void(std::basic_ostream<CharT, std::char_traits<CharT>>&, const Obj&, const stdutils::io::ErrorHandler&)>;
@@ -128,6 +195,46 @@ private:
 
 using LineStream = Basic_LineStream<char>;
 
+/**
+ * LineView: Same as LineStream, reading the lines of an in-memory text buffer without copying them
+ *
+ * The line terminator ('\n' or "\r\n") is not part of the returned lines.
+ */
+class LineView
+{
+public:
+    explicit LineView(std::string_view source) noexcept;
+
+    // Same as LineStream::getline(). The returned line is a view on the source buffer.
+    bool getline(std::string_view& out_str, std::size_t& line_nb) noexcept;
+
+    // Read comments on Basic_LineStream::line_nb()
+    std::size_t line_nb() const noexcept { return m_line_nb; }
+
+    // Equivalent to stream().good() on a LineStream that would have read the same lines
+    bool good() const noexcept { return !m_eof; }
+
+private:
+    std::string_view    m_source;
+    std::size_t         m_pos;
+    std::size_t         m_line_nb;
+    bool                m_eof;
+};
+
+namespace details {
+
+// The conditions to skip a line, shared by SkipLineStream and SkipLineView
+struct SkipLineConditions
+{
+    bool skip_line(std::string_view line) const noexcept;
+
+    std::vector<std::string>    skip_tokens;
+    bool                        skip_empty_lines = false;
+    bool                        skip_blank_lines = false;
+};
+
+} // namespace details
+
 /**
  * SkipLineStream: A LineStream with a set of conditions to skip lines
  */
@@ -136,6 +243,7 @@ class Basic_SkipLineStream
 {
 public:
     using istream_t = typename Basic_LineStream<CharT>::istream_t;
+    using line_t = std::basic_string<CharT>;
 
     explicit Basic_SkipLineStream(istream_t& source);
     explicit Basic_SkipLineStream(const Basic_LineStream<CharT>& linetream);
@@ -153,17 +261,43 @@ public:
 
     const typename Basic_LineStream<CharT>::istream_t& stream() const { return m_linestream.stream(); }
 
-private:
-    bool skip_line(const std::string& line) const;
+    bool good() const { return m_linestream.stream().good(); }
 
-    Basic_LineStream<CharT>     m_linestream;
-    std::vector<std::string>    m_skip_tokens;
-    bool                        m_skip_empty_lines;
-    bool                        m_skip_blank_lines;
+private:
+    Basic_LineStream<CharT>         m_linestream;
+    details::SkipLineConditions     m_conditions;
 };
 
 using SkipLineStream = Basic_SkipLineStream<char>;
 
+/**
+ * SkipLineView: A LineView with a set of conditions to skip lines
+ */
+class SkipLineView
+{
+public:
+    using line_t = std::string_view;
+
+    explicit SkipLineView(std::string_view source);
+
+    // Skip lines
+    SkipLineView& skip_empty_lines();
+    SkipLineView& skip_blank_lines();
+    SkipLineView& skip_comment_lines(std::string_view comment_token);
+
+    // Read comments on Basic_LineStream::getline()
+    bool getline(std::string_view& out_str, std::size_t& line_nb);
+
+    // Read comments on Basic_LineStream::line_nb()
+    std::size_t line_nb() const noexcept { return m_lineview.line_nb(); }
+
+    bool good() const noexcept { return m_lineview.good(); }
+
+private:
+    LineView                        m_lineview;
+    details::SkipLineConditions     m_conditions;
+};
+
 /**
  * countlines()
  *
@@ -179,6 +313,16 @@ std::size_t countlines(std::basic_istream<CharT, std::char_traits<CharT>>& istre
 //
 //
 
+template <typename Format>
+void RepeatedMessage::operator()(Format&& format)
+{
+    if (m_count++ >= m_max_messages || !m_enabled || !m_err_handler)
+        return;
+    std::stringstream out;
+    format(out);
+    m_err_handler(m_code, out.str());
+}
+
 
 template <typename F, typename CharT>
 int accurate_fp_precision(std::basic_ostream<CharT, std::char_traits<CharT>>& out)
@@ -217,12 +361,57 @@ SaveNumericFormat<CharT>::~SaveNumericFormat()
 
 namespace details {
 
+// Defined in compression.cpp. If the content is compressed, decompress it in the output and return true. Throw on a decompression error.
+bool decompress_content(const std::filesystem::path& filepath, std::string_view content, std::string& output);
+bool read_compressed_file(const std::filesystem::path& filepath, std::string& output);
+bool is_compressed_extension(const std::filesystem::path& filepath);
+void write_compressed_file(const std::filesystem::path& filepath, std::string_view content, const stdutils::io::ErrorHandler& err_handler);
+
+// Input stream buffer on a string, without copying it
+class StringViewBuf : public std::streambuf
+{
+public:
+    explicit StringViewBuf(std::string& str)
+    {
+        setg(str.data(), str.data(), str.data() + str.size());
+    }
+
+protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+    {
+        if (!(which & std::ios_base::in))
+            return pos_type(off_type(-1));
+        const off_type size = egptr() - eback();
+        const off_type base = dir == std::ios_base::beg ? 0 : (dir == std::ios_base::cur ? gptr() - eback() : size);
+        const off_type pos = base + off;
+        if (pos < 0 || pos > size)
+            return pos_type(off_type(-1));
+        setg(eback(), eback() + pos, egptr());
+        return pos_type(pos);
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+    {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+};
+
 template <typename Ret, typename CharT>
 Ret open_and_parse_file(const std::filesystem::path& filepath, bool binary, const StreamParser<Ret, CharT>& stream_parser, const stdutils::io::ErrorHandler& err_handler) noexcept
 {
     static_assert(std::is_nothrow_default_constructible_v<Ret>);
     try
     {
+        if constexpr (std::is_same_v<CharT, char>)
+        {
+            std::string decompressed;
+            if (read_compressed_file(filepath, decompressed))
+            {
+                StringViewBuf buffer(decompressed);
+                std::istream inputstream(&buffer);
+                return stream_parser(inputstream, err_handler);
+            }
+        }
         std::ios_base::openmode mode = std::ios_base::in;
         if (binary) { mode |= std::ios_base::binary; }
         std::basic_ifstream<CharT> inputstream(filepath, mode);
@@ -251,6 +440,16 @@ void save_file(const std::filesystem::path& filepath, bool binary, const StreamW
 {
     try
     {
+        if constexpr (std::is_same_v<CharT, char>)
+        {
+            if (is_compressed_extension(filepath))
+            {
+                std::ostringstream outputstream;
+                stream_writer(outputstream, obj, err_handler);
+                write_compressed_file(filepath, outputstream.str(), err_handler);
+                return;
+            }
+        }
         std::ios_base::openmode mode = std::ios_base::out;
         if (binary) { mode |= std::ios_base::binary; }
         std::basic_ofstream<CharT> outputstream(filepath, mode);
@@ -324,64 +523,37 @@ bool Basic_LineStream<CharT>::getline(std::basic_string<CharT>& out_str, std::si
 template <typename CharT>
 Basic_SkipLineStream<CharT>::Basic_SkipLineStream(typename Basic_LineStream<CharT>::istream_t& source)
     : m_linestream(source)
-    , m_skip_tokens()
-    , m_skip_empty_lines(false)
-    , m_skip_blank_lines(false)
+    , m_conditions()
 {}
 
 template <typename CharT>
 Basic_SkipLineStream<CharT>::Basic_SkipLineStream(const Basic_LineStream<CharT>& linestream)
     : m_linestream(linestream)
-    , m_skip_tokens()
-    , m_skip_empty_lines(false)
-    , m_skip_blank_lines(false)
+    , m_conditions()
 {}
 
 template <typename CharT>
 Basic_SkipLineStream<CharT>& Basic_SkipLineStream<CharT>::skip_empty_lines()
 {
-    m_skip_empty_lines = true;
+    m_conditions.skip_empty_lines = true;
     return *this;
 }
 
 template <typename CharT>
 Basic_SkipLineStream<CharT>& Basic_SkipLineStream<CharT>::skip_blank_lines()
 {
-    m_skip_empty_lines = true;
-    m_skip_blank_lines = true;
+    m_conditions.skip_empty_lines = true;
+    m_conditions.skip_blank_lines = true;
     return *this;
 }
 
 template <typename CharT>
 Basic_SkipLineStream<CharT>& Basic_SkipLineStream<CharT>::skip_comment_lines(std::string_view comment_token)
 {
-    m_skip_tokens.emplace_back(comment_token);
+    m_conditions.skip_tokens.emplace_back(comment_token);
     return *this;
 }
 
-template <typename CharT>
-bool Basic_SkipLineStream<CharT>::skip_line(const std::string& line) const
-{
-    if (m_skip_empty_lines && line.empty())
-    {
-        return true;
-    }
-    if (m_skip_blank_lines || !m_skip_tokens.empty())
-    {
-        std::istringstream iss(line);
-        std::string token;
-        iss >> token;               // leading whitespaces are skipped
-        if (m_skip_blank_lines && token.empty())
-        {
-            return true;
-        }
-        return std::any_of(m_skip_tokens.cbegin(), m_skip_tokens.cend(), [&token](const auto& comment_token) {
-            return token.substr(0, comment_token.size()) == comment_token;
-        });
-    }
-    return false;
-}
-
 template <typename CharT>
 bool Basic_SkipLineStream<CharT>::getline(std::basic_string<CharT>& out_str, std::size_t& line_nb)
 {
@@ -390,7 +562,7 @@ bool Basic_SkipLineStream<CharT>::getline(std::basic_string<CharT>& out_str, std
     do
     {
         no_fail = m_linestream.getline(out_str, line_nb);
-        skip = no_fail && skip_line(out_str);
+        skip = no_fail && m_conditions.skip_line(out_str);
     } while (skip);
     return no_fail;
 }
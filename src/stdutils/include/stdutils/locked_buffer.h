@@ -40,6 +40,7 @@ public:
     // Buffer accessors
     const_pointer data() const noexcept;
     size_type size() const noexcept;
+    const value_container& container() const noexcept;
     value_container& buffer();                          // Throws if the buffer is LOCKED
 
     // Index modifiers
@@ -98,6 +99,12 @@ typename LockedBuffer<T, C>::size_type LockedBuffer<T, C>::size() const noexcept
     return m_buffer.size();
 }
 
+template <typename T, template <typename...> class C>
+const typename LockedBuffer<T, C>::value_container& LockedBuffer<T, C>::container() const noexcept
+{
+    return m_buffer;
+}
+
 template <typename T, template <typename...> class C>
 typename LockedBuffer<T, C>::value_container& LockedBuffer<T, C>::buffer()
 {
@@ -0,0 +1,78 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <stdutils/io.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace stdutils {
+namespace io {
+
+/**
+ * Asynchronous sink of the messages of an error handler
+ *
+ * The messages sent to the handlers of the sink are queued in a bounded lock-free ring buffer (multiple producers, a single consumer),
+ * and forwarded to the target error handler by a consumer thread, e.g. to the console of the GUI or to stderr. The worker threads can
+ * therefore log on their hot paths: A producer does not allocate, and it neither blocks nor waits for the other producers or the output.
+ *
+ * The messages longer than MAX_MESSAGE_SIZE are truncated. The messages sent while the ring buffer is full are dropped, and counted.
+ * The messages sent by a thread are forwarded in order. The target handler is only called by the consumer thread.
+ */
+class LogSink
+{
+public:
+    static constexpr std::size_t MAX_MESSAGE_SIZE = 240;
+
+    // The capacity is in number of messages, rounded up to a power of two
+    explicit LogSink(ErrorHandler target, std::size_t capacity = 1024);
+    ~LogSink();                                     // The pending messages are forwarded before the consumer thread is joined
+    LogSink(const LogSink&) = delete;
+    LogSink& operator=(const LogSink&) = delete;
+
+    // The handler sends the messages to this object, therefore it must not outlive it. It can be called concurrently by any thread.
+    ErrorHandler handler();
+
+    // Return false if the message was dropped
+    bool push(SeverityCode code, ErrorMessage msg) noexcept;
+
+    // Wait until the messages pushed before the call are forwarded
+    void flush();
+
+    std::size_t nb_dropped() const noexcept { return m_nb_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        SeverityCode code;
+        std::uint32_t size;
+        char text[MAX_MESSAGE_SIZE];
+    };
+
+    bool has_message() const noexcept;
+    std::size_t forward_messages();
+    void consume();
+
+    ErrorHandler m_target;
+    std::unique_ptr<Slot[]> m_slots;
+    const std::size_t m_mask;
+    alignas(64) std::atomic<std::size_t> m_enqueue_pos;
+    alignas(64) std::atomic<std::size_t> m_dequeue_pos;  // Only modified by the consumer thread
+    std::atomic<std::size_t> m_nb_dropped;
+    std::atomic<bool> m_consumer_idle;
+    std::mutex m_mutex;                                 // Only taken to put the consumer thread to sleep, or to wake it up
+    std::condition_variable m_wake;
+    std::condition_variable m_forwarded;
+    bool m_stop;
+    std::thread m_thread;                               // Last member, so that the consumer thread starts with the sink complete
+};
+
+} // namespace io
+} // namespace stdutils
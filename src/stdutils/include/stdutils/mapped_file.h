@@ -0,0 +1,106 @@
+// Copyright (c) 2023 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <stdutils/io.h>
+
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace stdutils {
+namespace io {
+
+/**
+ * Read-only view on the content of a file
+ *
+ * The file is memory-mapped if the platform supports it (POSIX and Windows). Otherwise, or if the mapping fails,
+ * the content of the file is read in a buffer owned by the object.
+ */
+class MappedFile
+{
+public:
+    MappedFile() noexcept = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Return false if the file could not be opened. Throw std::bad_alloc on failure of the fallback path.
+    bool open(const std::filesystem::path& filepath);
+    void close() noexcept;
+
+    bool is_open() const noexcept { return m_is_open; }
+    bool is_memory_mapped() const noexcept { return m_mapped_data != nullptr; }
+
+    // The content of the file. Valid until the file is closed.
+    std::string_view view() const noexcept;
+
+private:
+    bool map(const std::filesystem::path& filepath) noexcept;
+    void unmap() noexcept;
+
+    const char* m_mapped_data = nullptr;
+    std::size_t m_mapped_size = 0;
+    std::string m_buffer;
+    bool m_is_open = false;
+};
+
+/**
+ * Pass the content of a file (text or binary) to a parser of std::string_view
+ *
+ * A gzip or zstd compressed file is decompressed in memory, and the parser is passed the decompressed buffer (see stdutils/compression.h).
+ */
+template <typename Ret>
+using BufferParser = std::function<Ret(std::string_view, const stdutils::io::ErrorHandler&)>;
+
+template <typename Ret>
+Ret open_and_parse_mapped_file(const std::filesystem::path& filepath, const BufferParser<Ret>& buffer_parser, const stdutils::io::ErrorHandler& err_handler) noexcept;
+
+
+//
+//
+// Implementation
+//
+//
+
+
+template <typename Ret>
+Ret open_and_parse_mapped_file(const std::filesystem::path& filepath, const BufferParser<Ret>& buffer_parser, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    static_assert(std::is_nothrow_default_constructible_v<Ret>);
+    try
+    {
+        MappedFile mapped_file;
+        if (mapped_file.open(filepath))
+        {
+            std::string decompressed;
+            if (details::decompress_content(filepath, mapped_file.view(), decompressed))
+            {
+                mapped_file.close();
+                return buffer_parser(decompressed, err_handler);
+            }
+            return buffer_parser(mapped_file.view(), err_handler);
+        }
+        else
+        {
+            std::stringstream oss;
+            oss << "Cannot open file " << filepath;
+            err_handler(stdutils::io::Severity::ERR, oss.str());
+        }
+    }
+    catch(const std::exception& e)
+    {
+        std::stringstream oss;
+        oss << "stdutils::io::open_and_parse_mapped_file(" << filepath << "): " << e.what();
+        err_handler(stdutils::io::Severity::EXCPT, oss.str());
+    }
+    return Ret();
+}
+
+} // namespace io
+} // namespace stdutils
@@ -0,0 +1,75 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace stdutils {
+namespace memory {
+
+/**
+ * Memory accounting
+ *
+ * The byte sizes are those of the heap allocations of the containers, based on their capacity. The size of the container object itself
+ * is not included, so that the byte size of an aggregate is the sum of the byte sizes of its members.
+ */
+template <typename T, typename A>
+std::size_t byte_size(const std::vector<T, A>& vect) noexcept;
+
+template <typename A>
+std::size_t byte_size(const std::vector<bool, A>& vect) noexcept;
+
+// Estimate: Each node of the tree holds three pointers and the color, in addition to the value
+template <typename K, typename T, typename C, typename A>
+std::size_t byte_size(const std::map<K, T, C, A>& map) noexcept;
+
+/**
+ * Resident set size of the process, in bytes
+ *
+ * The peak is the high-water mark since the start of the process, it cannot be reset. Both functions return 0 if the information is not
+ * available on the platform.
+ */
+std::size_t get_current_rss() noexcept;
+std::size_t get_peak_rss() noexcept;
+
+// Human-readable byte size, e.g. "12.3 MB"
+struct HumanReadable
+{
+    std::size_t bytes;
+};
+std::ostream& operator<<(std::ostream& out, const HumanReadable& size);
+std::string to_string(const HumanReadable& size);
+
+
+//
+//
+// Implementation
+//
+//
+
+
+template <typename T, typename A>
+std::size_t byte_size(const std::vector<T, A>& vect) noexcept
+{
+    return vect.capacity() * sizeof(T);
+}
+
+template <typename A>
+std::size_t byte_size(const std::vector<bool, A>& vect) noexcept
+{
+    return vect.capacity() / 8u;
+}
+
+template <typename K, typename T, typename C, typename A>
+std::size_t byte_size(const std::map<K, T, C, A>& map) noexcept
+{
+    return map.size() * (sizeof(std::pair<const K, T>) + 4u * sizeof(void*));
+}
+
+} // namespace memory
+} // namespace stdutils
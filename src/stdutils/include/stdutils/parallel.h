@@ -0,0 +1,264 @@
+// Copyright (c) 2023 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <stdutils/thread_pool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace stdutils {
+namespace parallel {
+
+/**
+ * Execution policy of the algorithms that have a parallel implementation
+ *
+ * The work is split in contiguous chunks, one per thread. Inputs too small to give each thread min_chunk_size
+ * elements use fewer threads, down to a sequential execution on the calling thread.
+ *
+ * The chunks are tasks of the default thread pool (see stdutils/thread_pool.h), the calling thread taking part, so that nb_threads is the
+ * maximum parallelism of an algorithm and not a number of threads created for it.
+ */
+struct Policy
+{
+    unsigned int nb_threads = 0;            // 0: Use the hardware concurrency
+    std::size_t min_chunk_size = 4096;
+};
+
+// Number of threads allowed by the policy (at least one)
+unsigned int max_threads(const Policy& policy) noexcept;
+
+// Number of chunks used to process n elements
+std::size_t nb_chunks(const Policy& policy, std::size_t n) noexcept;
+
+// Split the range [0, n) in nb_chunks(policy, n) contiguous chunks and call func(chunk_idx, begin_idx, end_idx) on each of them concurrently.
+// If func throws, the first exception is rethrown on the calling thread once all the chunks are done.
+template <typename Func>
+void for_each_chunk(const Policy& policy, std::size_t n, Func func);
+
+// Sort each chunk concurrently, then merge the sorted chunks pairwise
+template <typename RandomIt, typename Compare>
+void sort(const Policy& policy, RandomIt first, RandomIt last, Compare comp);
+
+// Call func(idx) for each idx in [0, n) on max_threads(policy) workers run by the thread pool, each taking the next index as soon as it
+// is done with the previous one. This suits a few tasks of uneven duration, e.g. one per input file. (min_chunk_size is ignored.)
+// On the calling thread, call on_done(idx) in increasing order of idx, as soon as func(idx) is complete.
+// If func or on_done throws, no new task is started and the first exception is rethrown once the worker threads are done.
+template <typename Func, typename OnDone>
+void for_each_ordered(const Policy& policy, std::size_t n, Func func, OnDone on_done);
+
+// Call func(worker_idx, idx) for each idx in [0, n) on max_threads(policy) workers, worker_idx in [0, nb_workers), each taking the
+// next index as soon as it is done with the previous one. This balances many small tasks of uneven duration, and the worker index selects
+// the resources reused by a worker from one task to the next. (min_chunk_size is ignored.) The calling thread is one of the workers.
+// If func throws, no new task is started and the first exception is rethrown once the workers are done.
+template <typename Func>
+void for_each_dynamic(const Policy& policy, std::size_t n, Func func);
+
+// Number of workers used by for_each_dynamic() to process n elements
+std::size_t nb_workers(const Policy& policy, std::size_t n) noexcept;
+
+
+//
+//
+// Implementation
+//
+//
+
+
+inline unsigned int max_threads(const Policy& policy) noexcept
+{
+    const unsigned int nb_threads = policy.nb_threads == 0 ? std::thread::hardware_concurrency() : policy.nb_threads;
+    return std::max(nb_threads, 1u);
+}
+
+inline std::size_t nb_chunks(const Policy& policy, std::size_t n) noexcept
+{
+    const std::size_t min_chunk_size = std::max(policy.min_chunk_size, std::size_t{1});
+    return std::max(std::min(static_cast<std::size_t>(max_threads(policy)), n / min_chunk_size), std::size_t{1});
+}
+
+template <typename Func>
+void for_each_chunk(const Policy& policy, std::size_t n, Func func)
+{
+    const std::size_t chunks = nb_chunks(policy, n);
+    if (chunks == 1)
+    {
+        func(std::size_t{0}, std::size_t{0}, n);
+        return;
+    }
+    std::vector<std::exception_ptr> exceptions(chunks);
+    const auto run_chunk = [n, chunks, &func, &exceptions](std::size_t chunk_idx) {
+        try
+        {
+            func(chunk_idx, n * chunk_idx / chunks, n * (chunk_idx + 1) / chunks);
+        }
+        catch (...)
+        {
+            exceptions[chunk_idx] = std::current_exception();
+        }
+    };
+    TaskGroup group;
+    for (std::size_t chunk_idx = 1; chunk_idx < chunks; chunk_idx++) { group.run([&run_chunk, chunk_idx]() { run_chunk(chunk_idx); }); }
+    run_chunk(0);
+    group.wait();
+    for (const auto& e : exceptions) { if (e) { std::rethrow_exception(e); } }
+}
+
+template <typename RandomIt, typename Compare>
+void sort(const Policy& policy, RandomIt first, RandomIt last, Compare comp)
+{
+    assert(first <= last);
+    const auto n = static_cast<std::size_t>(std::distance(first, last));
+    const std::size_t chunks = nb_chunks(policy, n);
+    if (chunks == 1)
+    {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    // Sort the chunks
+    std::vector<std::size_t> bounds(chunks + 1);
+    for (std::size_t chunk_idx = 0; chunk_idx <= chunks; chunk_idx++) { bounds[chunk_idx] = n * chunk_idx / chunks; }
+    const auto it = [first](std::size_t idx) { return first + static_cast<typename std::iterator_traits<RandomIt>::difference_type>(idx); };
+    for_each_chunk(policy, n, [&it, &comp](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        std::sort(it(begin_idx), it(end_idx), comp);
+    });
+
+    // Merge the sorted chunks pairwise, each round halving the number of sorted chunks
+    while (bounds.size() > 2)
+    {
+        const std::size_t nb_merges = (bounds.size() - 1) / 2;
+        std::vector<std::exception_ptr> exceptions(nb_merges);
+        TaskGroup group;
+        for (std::size_t merge_idx = 0; merge_idx < nb_merges; merge_idx++)
+        {
+            group.run([&it, &comp, &bounds, &exceptions, merge_idx]() {
+                try
+                {
+                    std::inplace_merge(it(bounds[2 * merge_idx]), it(bounds[2 * merge_idx + 1]), it(bounds[2 * merge_idx + 2]), comp);
+                }
+                catch (...)
+                {
+                    exceptions[merge_idx] = std::current_exception();
+                }
+            });
+        }
+        group.wait();
+        for (const auto& e : exceptions) { if (e) { std::rethrow_exception(e); } }
+        std::vector<std::size_t> merged_bounds;
+        merged_bounds.reserve(nb_merges + 2);
+        for (std::size_t idx = 0; idx < bounds.size(); idx += 2) { merged_bounds.push_back(bounds[idx]); }
+        if (merged_bounds.back() != n) { merged_bounds.push_back(n); }
+        bounds.swap(merged_bounds);
+    }
+}
+
+template <typename Func, typename OnDone>
+void for_each_ordered(const Policy& policy, std::size_t n, Func func, OnDone on_done)
+{
+    const std::size_t nb_workers = std::min(static_cast<std::size_t>(max_threads(policy)), n);
+    if (nb_workers <= 1)
+    {
+        for (std::size_t idx = 0; idx < n; idx++) { func(idx); on_done(idx); }
+        return;
+    }
+    std::atomic<std::size_t> next_idx{0};
+    std::atomic<bool> stop{false};
+    ThreadPool& pool = default_thread_pool();
+    enum TaskStatus : char { PENDING = 0, DONE, SKIPPED };
+    const auto status = std::make_unique<std::atomic<TaskStatus>[]>(n);
+    for (std::size_t idx = 0; idx < n; idx++) { status[idx].store(PENDING, std::memory_order_relaxed); }
+    std::vector<std::exception_ptr> exceptions(n);
+    const auto worker = [&]() {
+        for (std::size_t idx = next_idx++; idx < n; idx = next_idx++)
+        {
+            const bool skip = stop;
+            if (!skip)
+            {
+                try
+                {
+                    func(idx);
+                }
+                catch (...)
+                {
+                    exceptions[idx] = std::current_exception();
+                    stop = true;
+                }
+            }
+            status[idx].store(skip ? SKIPPED : DONE, std::memory_order_release);
+            pool.notify_all();
+        }
+    };
+    TaskGroup group(pool);
+    for (std::size_t worker_idx = 0; worker_idx < nb_workers; worker_idx++) { group.run(worker); }
+
+    // The calling thread runs the pending tasks of the pool while it waits for the next task in order
+    std::exception_ptr first_exception;
+    for (std::size_t idx = 0; idx < n && !first_exception; idx++)
+    {
+        pool.wait_until([&status, idx]() { return status[idx].load(std::memory_order_acquire) != PENDING; });
+        if (status[idx].load(std::memory_order_acquire) == SKIPPED) { break; }
+        if (exceptions[idx]) { first_exception = exceptions[idx]; break; }
+        try
+        {
+            on_done(idx);
+        }
+        catch (...)
+        {
+            first_exception = std::current_exception();
+            stop = true;
+        }
+    }
+    group.wait();
+    if (!first_exception)
+    {
+        const auto it = std::find_if(exceptions.cbegin(), exceptions.cend(), [](const auto& e) { return static_cast<bool>(e); });
+        if (it != exceptions.cend()) { first_exception = *it; }
+    }
+    if (first_exception) { std::rethrow_exception(first_exception); }
+}
+
+inline std::size_t nb_workers(const Policy& policy, std::size_t n) noexcept
+{
+    return std::max(std::min(static_cast<std::size_t>(max_threads(policy)), n), std::size_t{1});
+}
+
+template <typename Func>
+void for_each_dynamic(const Policy& policy, std::size_t n, Func func)
+{
+    const std::size_t workers = nb_workers(policy, n);
+    if (workers == 1)
+    {
+        for (std::size_t idx = 0; idx < n; idx++) { func(std::size_t{0}, idx); }
+        return;
+    }
+    std::atomic<std::size_t> next_idx{0};
+    std::atomic<bool> stop{false};
+    std::vector<std::exception_ptr> exceptions(workers);
+    const auto worker = [n, &func, &next_idx, &stop, &exceptions](std::size_t worker_idx) {
+        try
+        {
+            for (std::size_t idx = next_idx++; idx < n && !stop; idx = next_idx++) { func(worker_idx, idx); }
+        }
+        catch (...)
+        {
+            exceptions[worker_idx] = std::current_exception();
+            stop = true;
+        }
+    };
+    TaskGroup group;
+    for (std::size_t worker_idx = 1; worker_idx < workers; worker_idx++) { group.run([&worker, worker_idx]() { worker(worker_idx); }); }
+    worker(0);
+    group.wait();
+    for (const auto& e : exceptions) { if (e) { std::rethrow_exception(e); } }
+}
+
+} // namespace parallel
+} // namespace stdutils
@@ -5,6 +5,7 @@
 #include <filesystem>
 #include <ostream>
 #include <string>
+#include <vector>
 
 namespace stdutils {
 namespace platform {
@@ -64,6 +65,30 @@ void print_compiler_all_info(std::ostream& out, bool endl = true);
  */
 std::filesystem::path get_local_app_data_path() noexcept;
 
+/**
+ * The logical CPUs available to the process, grouped by NUMA node
+ *
+ * The topology is only detected on Linux, from /sys/devices/system/node, and restricted to the affinity mask of the process (e.g. taskset,
+ * cgroups). On the other platforms, or in case of failure, there is a single node with the hardware concurrency. The nodes without CPU
+ * (memory only) are omitted.
+ */
+struct NumaNode
+{
+    unsigned int id{0};
+    std::vector<unsigned int> cpus;
+};
+
+std::vector<NumaNode> numa_nodes();
+void print_cpu_topology(std::ostream& out, bool endl = true);
+
+/**
+ * Restrict the calling thread to a set of logical CPUs, e.g. those of a NUMA node, so that the memory it touches first is allocated on
+ * that node.
+ *
+ * Only supported on Linux. Return false on the other platforms, or in case of failure.
+ */
+bool set_current_thread_affinity(const std::vector<unsigned int>& cpus) noexcept;
+
 
 //
 //
@@ -0,0 +1,64 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <stdutils/io.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+
+namespace stdutils {
+namespace profiler {
+
+/**
+ * Instrumentation of the hot paths with scoped zones
+ *
+ * A zone records its name, thread, start time and duration on destruction, in a buffer per thread. The recording is off by default,
+ * and the zones placed with the macro STDUTILS_PROFILE_ZONE are compiled out unless STDUTILS_PROFILING is defined (CMake option
+ * DELAUNAY_VIEWER_PROFILING). The recorded zones are exported in the Chrome trace event format, which can be opened with
+ * chrome://tracing or https://ui.perfetto.dev
+ *
+ * Usage:
+ *
+ *  void foo()
+ *  {
+ *      STDUTILS_PROFILE_ZONE("foo");       // The name must have a static storage duration, e.g. a string literal
+ *      // Do something
+ *  }
+ */
+class Zone
+{
+public:
+    explicit Zone(const char* name) noexcept;
+    ~Zone();
+
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+private:
+    const char* m_name;
+    std::int64_t m_start_ns;                // Negative if the recording was off when the zone was entered
+};
+
+void set_enabled(bool enabled) noexcept;
+bool is_enabled() noexcept;
+
+// Discard the zones recorded so far
+void clear() noexcept;
+
+// Export the zones recorded so far in the Chrome trace event format (JSON)
+void save_chrome_trace(std::ostream& out);
+void save_chrome_trace_file(const std::filesystem::path& filepath, const stdutils::io::ErrorHandler& err_handler) noexcept;
+
+} // namespace profiler
+} // namespace stdutils
+
+#define STDUTILS_PROFILE_CONCAT_IMPL(a, b) a##b
+#define STDUTILS_PROFILE_CONCAT(a, b) STDUTILS_PROFILE_CONCAT_IMPL(a, b)
+
+#if defined(STDUTILS_PROFILING) && STDUTILS_PROFILING
+#define STDUTILS_PROFILE_ZONE(name) const stdutils::profiler::Zone STDUTILS_PROFILE_CONCAT(stdutils_profile_zone_, __LINE__)(name)
+#else
+#define STDUTILS_PROFILE_ZONE(name) (void)(name)
+#endif
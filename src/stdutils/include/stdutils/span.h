@@ -30,7 +30,7 @@ public:
 
 public:
     Span() noexcept : m_ptr(nullptr), m_size(0) { }
-    Span(T* ptr, std::size_t size) noexcept : m_ptr(ptr), m_size(size) { assert(m_ptr); }
+    Span(T* ptr, std::size_t size) noexcept : m_ptr(ptr), m_size(size) { assert(m_ptr || m_size == 0); }     // e.g. the data() of an empty vector
     Span(const Span<T>&) noexcept = default;
     Span(Span<T>&&) noexcept = default;
     Span<T>& operator=(const Span<T>&) noexcept = default;
@@ -38,7 +38,7 @@ public:
 
     // For qualification conversions (e.g. non-const T to const T)
     template <typename R>
-    Span(const Span<R>& other) noexcept : m_ptr(other.data()), m_size(other.size()) { assert(m_ptr); }
+    Span(const Span<R>& other) noexcept : m_ptr(other.data()), m_size(other.size()) { assert(m_ptr || m_size == 0); }
 
     std::size_t size() const  noexcept { return m_size; }
     bool empty() const noexcept { return m_size == 0 || m_ptr == nullptr; }
@@ -0,0 +1,210 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace stdutils {
+namespace parallel {
+
+/**
+ * Work-stealing thread pool
+ *
+ * Each worker thread has its own deque of tasks: It pushes and pops the tasks it submits at the back, and steals from the front of the
+ * deques of the other workers, or of the shared queue where the tasks submitted by the other threads are queued, when its own deque is empty.
+ *
+ * A thread waiting for a condition (see wait_until() and TaskGroup::wait()) runs the pending tasks in the meantime instead of blocking,
+ * therefore nested parallel algorithms do not deadlock and do not need threads of their own.
+ *
+ * All the parallel algorithms of stdutils/parallel.h run on the default pool, so that the libraries and the applications share the same
+ * worker threads instead of oversubscribing the CPU.
+ *
+ * The workers of a pool can be restricted to a set of logical CPUs, e.g. one pool per NUMA node (see stdutils::platform::numa_nodes()),
+ * so that the memory allocated and first touched by the tasks is local to the node. The affinity is only supported on Linux and ignored
+ * on the other platforms.
+ */
+class ThreadPool
+{
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(unsigned int nb_workers, std::vector<unsigned int> cpu_affinity = {});
+    ~ThreadPool();                                  // The pending tasks are run before the worker threads are joined
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned int nb_workers() const noexcept { return static_cast<unsigned int>(m_threads.size()); }
+    const std::vector<unsigned int>& cpu_affinity() const noexcept { return m_cpu_affinity; }     // Empty: No affinity
+
+    // The task must not throw: Use a TaskGroup to propagate the exceptions.
+    void submit(Task task);
+
+    // Run one pending task on the calling thread. Return false if there is none.
+    bool run_pending_task();
+
+    // Run the pending tasks on the calling thread until done() returns true. The event that makes done() true must be followed
+    // by a call to notify_all(). done() must be thread-safe.
+    template <typename Pred>
+    void wait_until(Pred done);
+    void notify_all();
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void worker_loop(std::size_t worker_idx);
+    bool pop_task(Task& task);
+
+    const std::vector<unsigned int> m_cpu_affinity;
+    std::vector<std::unique_ptr<WorkerQueue>> m_worker_queues;
+    WorkerQueue m_shared_queue;
+    std::atomic<std::size_t> m_nb_queued;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stop;
+    std::vector<std::thread> m_threads;
+};
+
+// One less than the hardware concurrency, since the thread that waits for the tasks also runs them. At least one.
+unsigned int default_nb_workers() noexcept;
+
+// The pool shared by the process, created on first use
+ThreadPool& default_thread_pool();
+
+// Set the number of workers of the default pool. Return false if the pool has already been created.
+bool set_default_thread_pool_size(unsigned int nb_workers);
+
+/**
+ * A group of tasks submitted to a pool, which the calling thread waits for
+ *
+ * The first exception thrown by a task cancels the group, and is rethrown by wait(). Once the group is cancelled, the tasks that have not
+ * started are skipped; the running tasks can poll is_cancelled() to stop early.
+ */
+class TaskGroup
+{
+public:
+    explicit TaskGroup(ThreadPool& pool = default_thread_pool());
+    ~TaskGroup();                                   // Wait for the tasks, without rethrowing their exception
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    template <typename Func>
+    void run(Func func);
+
+    // Run the pending tasks of the pool until all the tasks of the group are done, then rethrow the first exception, if any.
+    // Must not be called from a task of the same group.
+    void wait();
+
+    void cancel() noexcept { m_cancelled = true; }
+    bool is_cancelled() const noexcept { return m_cancelled; }
+
+private:
+    ThreadPool& m_pool;
+    std::atomic<std::size_t> m_nb_pending;
+    std::atomic<bool> m_cancelled;
+    std::mutex m_mutex;
+    std::exception_ptr m_exception;
+};
+
+// Call func(begin_idx, end_idx) on sub-ranges of [0, n) of at most grain_size elements, on the pool of the group. The ranges are split in
+// halves recursively, the second half being offered to the other workers, so that an idle worker steals the largest pending range.
+// The calling thread takes part and waits for the whole range. The remaining ranges are skipped once the group is cancelled.
+template <typename Func>
+void parallel_for(TaskGroup& group, std::size_t n, std::size_t grain_size, Func func);
+template <typename Func>
+void parallel_for(std::size_t n, std::size_t grain_size, Func func);
+
+
+//
+//
+// Implementation
+//
+//
+
+
+template <typename Pred>
+void ThreadPool::wait_until(Pred done)
+{
+    while (!done())
+    {
+        if (run_pending_task())
+            continue;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait(lock, [this, &done]() { return m_nb_queued > 0 || done(); });
+    }
+}
+
+template <typename Func>
+void TaskGroup::run(Func func)
+{
+    m_nb_pending++;
+    ThreadPool* pool = &m_pool;
+    m_pool.submit([this, pool, func = std::move(func)]() mutable {
+        if (!m_cancelled)
+        {
+            try
+            {
+                func();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_exception) { m_exception = std::current_exception(); }
+                m_cancelled = true;
+            }
+        }
+        // The group may be destroyed as soon as the counter reaches zero: Only the pool is used afterwards
+        const bool last = (--m_nb_pending == 0);
+        if (last) { pool->notify_all(); }
+    });
+}
+
+namespace details {
+
+template <typename Func>
+void split_range(TaskGroup& group, std::size_t begin_idx, std::size_t end_idx, std::size_t grain_size, const Func& func)
+{
+    while (end_idx - begin_idx > grain_size && !group.is_cancelled())
+    {
+        const std::size_t mid_idx = begin_idx + (end_idx - begin_idx) / 2;
+        group.run([&group, mid_idx, end_idx, grain_size, &func]() { split_range(group, mid_idx, end_idx, grain_size, func); });
+        end_idx = mid_idx;
+    }
+    if (!group.is_cancelled()) { func(begin_idx, end_idx); }
+}
+
+} // namespace details
+
+template <typename Func>
+void parallel_for(TaskGroup& group, std::size_t n, std::size_t grain_size, Func func)
+{
+    if (n == 0)
+        return;
+    grain_size = std::max(grain_size, std::size_t{1});
+    group.run([&group, n, grain_size, &func]() { details::split_range(group, 0, n, grain_size, func); });
+    group.wait();
+}
+
+template <typename Func>
+void parallel_for(std::size_t n, std::size_t grain_size, Func func)
+{
+    TaskGroup group;
+    parallel_for(group, n, grain_size, std::move(func));
+}
+
+} // namespace parallel
+} // namespace stdutils
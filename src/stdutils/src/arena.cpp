@@ -0,0 +1,120 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <stdutils/arena.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+namespace stdutils {
+
+namespace {
+
+// Alignment of the buffer: A cache line
+constexpr std::size_t BufferAlignment = 64;
+
+std::byte* allocate_buffer(std::size_t capacity)
+{
+    return capacity > 0 ? static_cast<std::byte*>(::operator new(capacity, std::align_val_t{BufferAlignment})) : nullptr;
+}
+
+void free_buffer(std::byte* buffer) noexcept
+{
+    if (buffer != nullptr) { ::operator delete(buffer, std::align_val_t{BufferAlignment}); }
+}
+
+} // namespace
+
+Arena::Arena(std::size_t initial_capacity)
+    : m_mutex()
+    , m_buffer(allocate_buffer(initial_capacity))
+    , m_capacity(initial_capacity)
+    , m_offset(0)
+    , m_allocated(0)
+    , m_high_water_mark(0)
+    , m_overflows()
+{
+}
+
+Arena::~Arena()
+{
+    release_overflows();
+    free_buffer(m_buffer);
+}
+
+void* Arena::allocate(std::size_t bytes, std::size_t alignment)
+{
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+    bytes = std::max<std::size_t>(bytes, 1);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_buffer != nullptr)
+    {
+        const auto base = reinterpret_cast<std::uintptr_t>(m_buffer);
+        const std::uintptr_t aligned = (base + m_offset + alignment - 1) & ~(alignment - 1);
+        const std::size_t end_offset = aligned - base + bytes;
+        if (end_offset <= m_capacity)
+        {
+            m_allocated += end_offset - m_offset;
+            m_offset = end_offset;
+            m_high_water_mark = std::max(m_high_water_mark, m_allocated);
+            return reinterpret_cast<void*>(aligned);
+        }
+    }
+
+    // Overflow. The padding is accounted for, so that the buffer grown by the next reset() fits the same sequence of allocations.
+    void* ptr = ::operator new(bytes, std::align_val_t{alignment});
+    try
+    {
+        m_overflows.push_back(Overflow{ ptr, alignment });
+    }
+    catch (...)
+    {
+        ::operator delete(ptr, std::align_val_t{alignment});
+        throw;
+    }
+    m_allocated += bytes + alignment;
+    m_high_water_mark = std::max(m_high_water_mark, m_allocated);
+    return ptr;
+}
+
+void Arena::reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_overflows.empty())
+    {
+        release_overflows();
+        free_buffer(m_buffer);
+        m_buffer = nullptr;
+        m_capacity = 0;
+        m_buffer = allocate_buffer(m_high_water_mark);
+        m_capacity = m_high_water_mark;
+    }
+    m_offset = 0;
+    m_allocated = 0;
+}
+
+std::size_t Arena::capacity() const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_capacity;
+}
+
+std::size_t Arena::high_water_mark() const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_high_water_mark;
+}
+
+std::size_t Arena::nb_overflows() const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_overflows.size();
+}
+
+void Arena::release_overflows() noexcept
+{
+    for (const auto& overflow : m_overflows) { ::operator delete(overflow.ptr, std::align_val_t{overflow.alignment}); }
+    m_overflows.clear();
+}
+
+} // namespace stdutils
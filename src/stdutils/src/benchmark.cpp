@@ -0,0 +1,104 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <stdutils/benchmark.h>
+
+#include <stdutils/io.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <iomanip>
+#include <utility>
+
+namespace stdutils {
+namespace benchmark {
+
+namespace {
+
+// Two-sided 95% quantile of the Student's t-distribution, by degrees of freedom
+double student_t_95(std::size_t dof)
+{
+    static constexpr std::array<double, 30> table = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    assert(dof > 0);
+    if (dof <= table.size()) { return table[dof - 1]; }
+    return dof <= 60 ? 2.000 : (dof <= 120 ? 1.980 : 1.960);
+}
+
+double sorted_median(const std::vector<double>& sorted)
+{
+    assert(!sorted.empty());
+    const std::size_t n = sorted.size();
+    return n % 2 == 1 ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+}
+
+} // namespace
+
+namespace details {
+
+void use_char_pointer(const volatile char*)
+{
+}
+
+} // namespace details
+
+Report analyze(std::vector<double> samples_ms, const Settings& settings)
+{
+    Report report;
+    report.samples_ms = std::move(samples_ms);
+    if (report.samples_ms.empty())
+        return report;
+
+    // Outlier rejection: The MAD, scaled to be a consistent estimator of the standard deviation of a normal distribution
+    std::vector<double> sorted = report.samples_ms;
+    std::sort(sorted.begin(), sorted.end());
+    const double median = sorted_median(sorted);
+    std::vector<double> deviations;
+    deviations.reserve(sorted.size());
+    for (const double sample : sorted) { deviations.push_back(std::abs(sample - median)); }
+    std::sort(deviations.begin(), deviations.end());
+    const double mad = 1.4826 * sorted_median(deviations);
+    stats::CumulSamples<double> kept;
+    std::vector<double> kept_sorted;
+    kept_sorted.reserve(sorted.size());
+    for (const double sample : sorted)
+    {
+        if (mad > 0.0 && std::abs(sample - median) > settings.outlier_threshold * mad)
+        {
+            report.nb_outliers++;
+            continue;
+        }
+        kept.add_sample(sample);
+        kept_sorted.push_back(sample);
+    }
+    assert(!kept.empty());
+    report.result = kept.get_result().add_median(sorted_median(kept_sorted));
+
+    // Confidence interval of the mean, with the unbiased estimator of the standard deviation
+    const std::size_t n = kept.nb_samples();
+    if (n > 1)
+    {
+        const double variance = std::max(report.result.variance, 0.0) * static_cast<double>(n) / static_cast<double>(n - 1);
+        report.ci_half_width = student_t_95(n - 1) * std::sqrt(variance / static_cast<double>(n));
+        report.converged = n >= settings.min_runs && report.ci_half_width <= settings.target_ci_ratio * report.result.mean;
+    }
+    return report;
+}
+
+std::ostream& operator<<(std::ostream& out, const Report& report)
+{
+    out << report.result;
+    stdutils::io::SaveNumericFormat save_fmt(out);
+    out << std::setprecision(3) << std::scientific
+        << ", ci95: " << report.ci_half_width
+        << ", outliers: " << report.nb_outliers
+        << (report.converged ? "" : " (not converged)");
+    return out;
+}
+
+} // namespace benchmark
+} // namespace stdutils
@@ -0,0 +1,405 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <stdutils/compression.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#if defined(STDUTILS_GZIP)
+#include <zlib.h>
+#endif
+
+#if defined(STDUTILS_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace stdutils {
+namespace io {
+
+namespace {
+
+constexpr std::string_view GZIP_MAGIC("\x1f\x8b", 2);
+constexpr std::string_view ZSTD_MAGIC("\x28\xb5\x2f\xfd", 4);
+constexpr std::size_t MAX_MAGIC_SIZE = 4;
+
+void report_error(const ErrorHandler& err_handler, Compression compression, std::string_view msg)
+{
+    if (!err_handler)
+        return;
+    std::stringstream oss;
+    oss << str_compression(compression) << ": " << msg;
+    err_handler(Severity::ERR, oss.str());
+}
+
+#if defined(STDUTILS_GZIP)
+
+// The sizes passed to zlib are limited to uInt
+constexpr std::size_t ZLIB_MAX_CHUNK = std::size_t{1} << 30;
+
+uInt zlib_chunk(std::size_t size)
+{
+    return static_cast<uInt>(std::min(size, ZLIB_MAX_CHUNK));
+}
+
+bool gzip_compress(std::string_view input, std::string& output, const ErrorHandler& err_handler, const CompressionOptions& options)
+{
+    z_stream strm;
+    std::memset(&strm, 0, sizeof(z_stream));
+    const int level = options.level == 0 ? Z_DEFAULT_COMPRESSION : std::clamp(options.level, 1, 9);
+    if (deflateInit2(&strm, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)       // 15 + 16: gzip header
+    {
+        report_error(err_handler, Compression::Gzip, "Failed to initialize the compression");
+        return false;
+    }
+    output.resize(static_cast<std::size_t>(deflateBound(&strm, static_cast<uLong>(input.size()))) + 64);
+    std::size_t in_pos = 0;
+    std::size_t out_pos = 0;
+    int ret = Z_OK;
+    do
+    {
+        if (out_pos == output.size()) { output.resize(2 * output.size()); }
+        strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data() + in_pos));
+        strm.avail_in = zlib_chunk(input.size() - in_pos);
+        strm.next_out = reinterpret_cast<Bytef*>(output.data() + out_pos);
+        strm.avail_out = zlib_chunk(output.size() - out_pos);
+        const uInt avail_in = strm.avail_in;
+        const uInt avail_out = strm.avail_out;
+        const bool last_chunk = in_pos + avail_in == input.size();
+        ret = deflate(&strm, last_chunk ? Z_FINISH : Z_NO_FLUSH);
+        in_pos += avail_in - strm.avail_in;
+        out_pos += avail_out - strm.avail_out;
+    } while (ret == Z_OK || ret == Z_BUF_ERROR);
+    deflateEnd(&strm);
+    const bool success = (ret == Z_STREAM_END);
+    output.resize(success ? out_pos : 0);
+    if (!success) { report_error(err_handler, Compression::Gzip, "Compression failed"); }
+    return success;
+}
+
+// Decompress the concatenated gzip members
+bool gzip_decompress(std::string_view input, std::string& output, const ErrorHandler& err_handler)
+{
+    z_stream strm;
+    std::memset(&strm, 0, sizeof(z_stream));
+    if (inflateInit2(&strm, 15 + 32) != Z_OK)                                                   // 15 + 32: Detect the gzip header
+    {
+        report_error(err_handler, Compression::Gzip, "Failed to initialize the decompression");
+        return false;
+    }
+    output.resize(std::max(std::size_t{4} * input.size(), std::size_t{1} << 16));
+    std::size_t in_pos = 0;
+    std::size_t out_pos = 0;
+    std::string error;
+    int ret = Z_OK;
+    while (error.empty() && (in_pos < input.size() || ret != Z_STREAM_END))
+    {
+        if (out_pos == output.size()) { output.resize(2 * output.size()); }
+        if (ret == Z_STREAM_END && inflateReset(&strm) != Z_OK) { error = "Invalid input"; break; }     // Next member
+        strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data() + in_pos));
+        strm.avail_in = zlib_chunk(input.size() - in_pos);
+        strm.next_out = reinterpret_cast<Bytef*>(output.data() + out_pos);
+        strm.avail_out = zlib_chunk(output.size() - out_pos);
+        const uInt avail_in = strm.avail_in;
+        const uInt avail_out = strm.avail_out;
+        ret = inflate(&strm, Z_NO_FLUSH);
+        in_pos += avail_in - strm.avail_in;
+        out_pos += avail_out - strm.avail_out;
+        if (ret == Z_BUF_ERROR && in_pos == input.size())
+            error = "Truncated input";
+        else if (ret != Z_OK && ret != Z_BUF_ERROR && ret != Z_STREAM_END)
+            error = strm.msg != nullptr ? strm.msg : "Invalid input";
+        else if (ret == Z_OK && in_pos == input.size() && strm.avail_out != 0)
+            error = "Truncated input";
+    }
+    inflateEnd(&strm);
+    output.resize(error.empty() ? out_pos : 0);
+    if (!error.empty()) { report_error(err_handler, Compression::Gzip, error); }
+    return error.empty();
+}
+
+#endif
+
+#if defined(STDUTILS_ZSTD)
+
+// Independent frames of options.frame_size bytes of input, compressed concurrently
+bool zstd_compress(std::string_view input, std::string& output, const ErrorHandler& err_handler, const CompressionOptions& options)
+{
+    const std::size_t frame_size = std::max(options.frame_size, std::size_t{1} << 16);
+    const std::size_t nb_frames = std::max((input.size() + frame_size - 1) / frame_size, std::size_t{1});
+    const int level = options.level == 0 ? ZSTD_CLEVEL_DEFAULT : std::clamp(options.level, 1, ZSTD_maxCLevel());
+    std::vector<std::string> frames(nb_frames);
+    std::vector<const char*> errors(nb_frames, nullptr);
+    stdutils::parallel::for_each_dynamic(options.policy, nb_frames, [&](std::size_t, std::size_t frame_idx) {
+        const std::string_view src = input.substr(std::min(frame_idx * frame_size, input.size()), frame_size);
+        auto& frame = frames[frame_idx];
+        frame.resize(ZSTD_compressBound(src.size()));
+        const std::size_t ret = ZSTD_compress(frame.data(), frame.size(), src.data(), src.size(), level);
+        if (ZSTD_isError(ret)) { errors[frame_idx] = ZSTD_getErrorName(ret); }
+        else { frame.resize(ret); }
+    });
+    output.clear();
+    const auto error_it = std::find_if(errors.cbegin(), errors.cend(), [](const char* error) { return error != nullptr; });
+    if (error_it != errors.cend())
+    {
+        report_error(err_handler, Compression::Zstd, *error_it);
+        return false;
+    }
+    std::size_t total_size = 0;
+    for (const auto& frame : frames) { total_size += frame.size(); }
+    output.reserve(total_size);
+    for (const auto& frame : frames) { output.append(frame); }
+    return true;
+}
+
+bool zstd_decompress_stream(std::string_view input, std::string& output, const ErrorHandler& err_handler)
+{
+    ZSTD_DCtx* dctx = ZSTD_createDCtx();
+    if (dctx == nullptr)
+    {
+        report_error(err_handler, Compression::Zstd, "Failed to initialize the decompression");
+        return false;
+    }
+    output.resize(std::max(std::size_t{4} * input.size(), ZSTD_DStreamOutSize()));
+    ZSTD_inBuffer in_buf{ input.data(), input.size(), 0 };
+    std::size_t out_pos = 0;
+    std::size_t ret = 0;
+    const char* error = nullptr;
+    while (true)
+    {
+        if (out_pos == output.size()) { output.resize(2 * output.size()); }
+        ZSTD_outBuffer out_buf{ output.data() + out_pos, output.size() - out_pos, 0 };
+        ret = ZSTD_decompressStream(dctx, &out_buf, &in_buf);
+        out_pos += out_buf.pos;
+        if (ZSTD_isError(ret)) { error = ZSTD_getErrorName(ret); break; }
+        if (in_buf.pos == in_buf.size && out_buf.pos < out_buf.size)
+            break;                                          // All the input is consumed and flushed
+    }
+    if (error == nullptr && ret != 0) { error = "Truncated input"; }
+    ZSTD_freeDCtx(dctx);
+    output.resize(error == nullptr ? out_pos : 0);
+    if (error != nullptr) { report_error(err_handler, Compression::Zstd, error); }
+    return error == nullptr;
+}
+
+bool zstd_decompress(std::string_view input, std::string& output, const ErrorHandler& err_handler, const stdutils::parallel::Policy& policy)
+{
+    // Locate the frames. If all of them record their decompressed size, decompress them concurrently.
+    struct Frame
+    {
+        std::size_t in_pos;
+        std::size_t in_size;
+        std::size_t out_pos;
+        std::size_t out_size;
+    };
+    std::vector<Frame> frames;
+    std::size_t in_pos = 0;
+    std::size_t out_size = 0;
+    bool known_sizes = true;
+    while (in_pos < input.size() && known_sizes)
+    {
+        const std::size_t in_size = ZSTD_findFrameCompressedSize(input.data() + in_pos, input.size() - in_pos);
+        const unsigned long long frame_out_size = ZSTD_isError(in_size) ? ZSTD_CONTENTSIZE_ERROR : ZSTD_getFrameContentSize(input.data() + in_pos, in_size);
+        known_sizes = (frame_out_size != ZSTD_CONTENTSIZE_ERROR && frame_out_size != ZSTD_CONTENTSIZE_UNKNOWN);
+        if (known_sizes)
+        {
+            frames.push_back(Frame{ in_pos, in_size, out_size, static_cast<std::size_t>(frame_out_size) });
+            in_pos += in_size;
+            out_size += static_cast<std::size_t>(frame_out_size);
+        }
+    }
+    if (!known_sizes || frames.empty())
+        return zstd_decompress_stream(input, output, err_handler);
+
+    output.resize(out_size);
+    std::vector<const char*> errors(frames.size(), nullptr);
+    stdutils::parallel::for_each_dynamic(policy, frames.size(), [&](std::size_t, std::size_t frame_idx) {
+        const Frame& frame = frames[frame_idx];
+        const std::size_t ret = ZSTD_decompress(output.data() + frame.out_pos, frame.out_size, input.data() + frame.in_pos, frame.in_size);
+        if (ZSTD_isError(ret)) { errors[frame_idx] = ZSTD_getErrorName(ret); }
+        else if (ret != frame.out_size) { errors[frame_idx] = "Inconsistent frame size"; }
+    });
+    const auto error_it = std::find_if(errors.cbegin(), errors.cend(), [](const char* error) { return error != nullptr; });
+    if (error_it != errors.cend())
+    {
+        report_error(err_handler, Compression::Zstd, *error_it);
+        output.clear();
+        return false;
+    }
+    return true;
+}
+
+#endif
+
+} // namespace
+
+std::string_view str_compression(Compression compression) noexcept
+{
+    switch (compression)
+    {
+        case Compression::None:
+            return "none";
+        case Compression::Gzip:
+            return "gzip";
+        case Compression::Zstd:
+            return "zstd";
+        default:
+            assert(0);
+            return "unknown";
+    }
+}
+
+bool is_supported(Compression compression) noexcept
+{
+    switch (compression)
+    {
+        case Compression::None:
+            return true;
+#if defined(STDUTILS_GZIP)
+        case Compression::Gzip:
+            return true;
+#endif
+#if defined(STDUTILS_ZSTD)
+        case Compression::Zstd:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+Compression compression_from_magic(std::string_view header) noexcept
+{
+    if (header.substr(0, GZIP_MAGIC.size()) == GZIP_MAGIC)
+        return Compression::Gzip;
+    if (header.substr(0, ZSTD_MAGIC.size()) == ZSTD_MAGIC)
+        return Compression::Zstd;
+    return Compression::None;
+}
+
+Compression compression_from_extension(const std::filesystem::path& filepath)
+{
+    const auto extension = filepath.extension();
+    if (extension == ".gz")
+        return Compression::Gzip;
+    if (extension == ".zst")
+        return Compression::Zstd;
+    return Compression::None;
+}
+
+bool compress(Compression compression, std::string_view input, std::string& output, const ErrorHandler& err_handler, const CompressionOptions& options)
+{
+    switch (compression)
+    {
+        case Compression::None:
+            output.assign(input);
+            return true;
+#if defined(STDUTILS_GZIP)
+        case Compression::Gzip:
+            return gzip_compress(input, output, err_handler, options);
+#endif
+#if defined(STDUTILS_ZSTD)
+        case Compression::Zstd:
+            return zstd_compress(input, output, err_handler, options);
+#endif
+        default:
+            (void)options;
+            report_error(err_handler, compression, "Format not supported by this build");
+            output.clear();
+            return false;
+    }
+}
+
+bool decompress(Compression compression, std::string_view input, std::string& output, const ErrorHandler& err_handler, const stdutils::parallel::Policy& policy)
+{
+    switch (compression)
+    {
+        case Compression::None:
+            output.assign(input);
+            return true;
+#if defined(STDUTILS_GZIP)
+        case Compression::Gzip:
+            return gzip_decompress(input, output, err_handler);
+#endif
+#if defined(STDUTILS_ZSTD)
+        case Compression::Zstd:
+            return zstd_decompress(input, output, err_handler, policy);
+#endif
+        default:
+            (void)policy;
+            report_error(err_handler, compression, "Format not supported by this build");
+            output.clear();
+            return false;
+    }
+}
+
+namespace details {
+
+namespace {
+
+// Throw std::runtime_error with the message reported by the (de)compression
+ErrorHandler throwing_handler(const std::filesystem::path& filepath)
+{
+    return [filepath](SeverityCode, ErrorMessage msg) {
+        std::stringstream oss;
+        oss << "File " << filepath << ": " << msg;
+        throw std::runtime_error(oss.str());
+    };
+}
+
+} // namespace
+
+bool decompress_content(const std::filesystem::path& filepath, std::string_view content, std::string& output)
+{
+    const Compression compression = compression_from_magic(content);
+    if (compression == Compression::None)
+        return false;
+    decompress(compression, content, output, throwing_handler(filepath));
+    return true;
+}
+
+bool read_compressed_file(const std::filesystem::path& filepath, std::string& output)
+{
+    std::ifstream inputstream(filepath, std::ios_base::in | std::ios_base::binary);
+    if (!inputstream.is_open())
+        return false;
+    std::string content(MAX_MAGIC_SIZE, '\0');
+    inputstream.read(content.data(), static_cast<std::streamsize>(MAX_MAGIC_SIZE));
+    content.resize(static_cast<std::size_t>(inputstream.gcount()));
+    if (compression_from_magic(content) == Compression::None)
+        return false;
+    content.append(std::istreambuf_iterator<char>(inputstream), std::istreambuf_iterator<char>());
+    return decompress_content(filepath, content, output);
+}
+
+bool is_compressed_extension(const std::filesystem::path& filepath)
+{
+    return compression_from_extension(filepath) != Compression::None;
+}
+
+void write_compressed_file(const std::filesystem::path& filepath, std::string_view content, const ErrorHandler& err_handler)
+{
+    std::string compressed;
+    compress(compression_from_extension(filepath), content, compressed, throwing_handler(filepath));
+    std::ofstream outputstream(filepath, std::ios_base::out | std::ios_base::binary);
+    if (outputstream.is_open())
+    {
+        outputstream.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+    }
+    else
+    {
+        std::stringstream oss;
+        oss << "Cannot open file " << filepath;
+        err_handler(stdutils::io::Severity::ERR, oss.str());
+    }
+}
+
+} // namespace details
+
+} // namespace io
+} // namespace stdutils
@@ -2,8 +2,12 @@
 // This code is distributed under the terms of the MIT License
 #include <stdutils/io.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <exception>
+#include <sstream>
 
 namespace stdutils {
 namespace io {
@@ -22,6 +26,8 @@ std::array<std::string_view, SEV_CODE_MAX_IDX + 1> str_severity_code_lookup {
     "UNKNOWN"
 };
 
+std::atomic<SeverityCode> process_severity_threshold{Severity::TRACE};
+
 } // namespace
 
 std::string_view str_severity_code(SeverityCode code) noexcept
@@ -32,5 +38,154 @@ std::string_view str_severity_code(SeverityCode code) noexcept
     return str_severity_code_lookup[code_idx];
 }
 
+void set_severity_threshold(SeverityCode threshold) noexcept
+{
+    process_severity_threshold.store(threshold, std::memory_order_relaxed);
+}
+
+SeverityCode severity_threshold() noexcept
+{
+    return process_severity_threshold.load(std::memory_order_relaxed);
+}
+
+bool is_severity_enabled(SeverityCode code) noexcept
+{
+    return code <= severity_threshold();
+}
+
+RepeatedMessage::RepeatedMessage(const ErrorHandler& err_handler, SeverityCode code, std::string_view what, std::size_t max_messages)
+    : m_err_handler(err_handler)
+    , m_code(code)
+    , m_what(what)
+    , m_max_messages(max_messages)
+    , m_enabled(is_severity_enabled(code))
+    , m_count(0)
+{ }
+
+RepeatedMessage::~RepeatedMessage()
+{
+    if (m_count <= m_max_messages || !m_enabled || !m_err_handler)
+        return;
+    try
+    {
+        std::stringstream out;
+        out << m_what << ": " << (m_count - m_max_messages) << " more were not reported";
+        m_err_handler(m_code, out.str());
+    }
+    catch (const std::exception&)
+    {
+        // Destructor
+    }
+}
+
+ErrorHandler ErrorLog::handler()
+{
+    return [this](SeverityCode code, ErrorMessage msg) { m_messages.emplace_back(code, std::string(msg)); };
+}
+
+void ErrorLog::forward(const ErrorHandler& err_handler) const
+{
+    for (const auto& [code, msg] : m_messages) { err_handler(code, msg); }
+}
+
+LineView::LineView(std::string_view source) noexcept
+    : m_source(source)
+    , m_pos(0)
+    , m_line_nb(0)
+    , m_eof(false)
+{
+}
+
+bool LineView::getline(std::string_view& out_str, std::size_t& line_nb) noexcept
+{
+    out_str = std::string_view();
+    line_nb = m_line_nb;
+    if (m_pos == m_source.size())
+    {
+        // Same as std::getline: Fail if no character could be extracted
+        m_eof = true;
+        return false;
+    }
+    const std::size_t eol = m_source.find('\n', m_pos);
+    if (eol == std::string_view::npos)
+    {
+        out_str = m_source.substr(m_pos);
+        m_pos = m_source.size();
+        m_eof = true;
+    }
+    else
+    {
+        out_str = m_source.substr(m_pos, eol - m_pos);
+        m_pos = eol + 1;
+    }
+    if (!out_str.empty() && out_str.back() == '\r') { out_str.remove_suffix(1); }
+    line_nb = ++m_line_nb;
+    return true;
+}
+
+namespace details {
+
+bool SkipLineConditions::skip_line(std::string_view line) const noexcept
+{
+    if (skip_empty_lines && line.empty())
+    {
+        return true;
+    }
+    if (skip_blank_lines || !skip_tokens.empty())
+    {
+        // First token of the line, leading whitespaces are skipped
+        const auto is_space = [](char c) { return c == ' ' || (c >= '\t' && c <= '\r'); };
+        const auto token_begin = std::find_if_not(line.cbegin(), line.cend(), is_space);
+        const auto token_end = std::find_if(token_begin, line.cend(), is_space);
+        const std::string_view token = line.substr(static_cast<std::size_t>(token_begin - line.cbegin()), static_cast<std::size_t>(token_end - token_begin));
+        if (skip_blank_lines && token.empty())
+        {
+            return true;
+        }
+        return std::any_of(skip_tokens.cbegin(), skip_tokens.cend(), [&token](const auto& comment_token) {
+            return token.substr(0, comment_token.size()) == comment_token;
+        });
+    }
+    return false;
+}
+
+} // namespace details
+
+SkipLineView::SkipLineView(std::string_view source)
+    : m_lineview(source)
+    , m_conditions()
+{}
+
+SkipLineView& SkipLineView::skip_empty_lines()
+{
+    m_conditions.skip_empty_lines = true;
+    return *this;
+}
+
+SkipLineView& SkipLineView::skip_blank_lines()
+{
+    m_conditions.skip_empty_lines = true;
+    m_conditions.skip_blank_lines = true;
+    return *this;
+}
+
+SkipLineView& SkipLineView::skip_comment_lines(std::string_view comment_token)
+{
+    m_conditions.skip_tokens.emplace_back(comment_token);
+    return *this;
+}
+
+bool SkipLineView::getline(std::string_view& out_str, std::size_t& line_nb)
+{
+    bool no_fail = false;
+    bool skip = false;
+    do
+    {
+        no_fail = m_lineview.getline(out_str, line_nb);
+        skip = no_fail && m_conditions.skip_line(out_str);
+    } while (skip);
+    return no_fail;
+}
+
 } // namespace io
 } // namespace stdutils
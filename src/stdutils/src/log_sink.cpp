@@ -0,0 +1,166 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <stdutils/log_sink.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <string_view>
+#include <utility>
+
+namespace stdutils {
+namespace io {
+
+namespace {
+
+// Safety net of the wake-up of the consumer thread
+constexpr auto consumer_wait_timeout = std::chrono::milliseconds(100);
+
+std::size_t ceil_power_of_two(std::size_t n)
+{
+    std::size_t result = 1;
+    while (result < n) { result <<= 1; }
+    return result;
+}
+
+} // namespace
+
+LogSink::LogSink(ErrorHandler target, std::size_t capacity)
+    : m_target(std::move(target))
+    , m_slots(std::make_unique<Slot[]>(ceil_power_of_two(std::max(capacity, std::size_t{2}))))
+    , m_mask(ceil_power_of_two(std::max(capacity, std::size_t{2})) - 1)
+    , m_enqueue_pos(0)
+    , m_dequeue_pos(0)
+    , m_nb_dropped(0)
+    , m_consumer_idle(false)
+    , m_mutex()
+    , m_wake()
+    , m_forwarded()
+    , m_stop(false)
+    , m_thread()
+{
+    for (std::size_t idx = 0; idx <= m_mask; idx++) { m_slots[idx].sequence.store(idx, std::memory_order_relaxed); }
+    m_thread = std::thread([this]() { consume(); });
+}
+
+LogSink::~LogSink()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+ErrorHandler LogSink::handler()
+{
+    return [this](SeverityCode code, ErrorMessage msg) { push(code, msg); };
+}
+
+// Bounded queue of D. Vyukov: The sequence of a slot tells whether it is free for the producer at that position (sequence == pos), or
+// ready for the consumer (sequence == pos + 1). The producers only contend on the increment of the enqueue position.
+bool LogSink::push(SeverityCode code, ErrorMessage msg) noexcept
+{
+    Slot* slot = nullptr;
+    std::size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    while (true)
+    {
+        slot = &m_slots[pos & m_mask];
+        const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+        if (diff == 0)
+        {
+            if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+        }
+        else if (diff < 0)
+        {
+            m_nb_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    const std::size_t size = std::min(msg.size(), MAX_MESSAGE_SIZE);
+    slot->code = code;
+    slot->size = static_cast<std::uint32_t>(size);
+    std::memcpy(slot->text, msg.data(), size);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    // The consumer thread flags itself idle before it checks the queue a last time: One of the two sides sees the other's store
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_consumer_idle.load(std::memory_order_relaxed))
+    {
+        { std::lock_guard<std::mutex> lock(m_mutex); }
+        m_wake.notify_one();
+    }
+    return true;
+}
+
+void LogSink::flush()
+{
+    const std::size_t target_pos = m_enqueue_pos.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_wake.notify_one();
+    m_forwarded.wait(lock, [this, target_pos]() { return static_cast<std::ptrdiff_t>(m_dequeue_pos.load(std::memory_order_acquire) - target_pos) >= 0; });
+}
+
+bool LogSink::has_message() const noexcept
+{
+    const std::size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+    return m_slots[pos & m_mask].sequence.load(std::memory_order_acquire) == pos + 1;
+}
+
+// Return the number of messages forwarded
+std::size_t LogSink::forward_messages()
+{
+    std::size_t nb_forwarded = 0;
+    std::size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+    while (true)
+    {
+        Slot& slot = m_slots[pos & m_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1) { break; }
+        try
+        {
+            m_target(slot.code, std::string_view(slot.text, slot.size));
+        }
+        catch (const std::exception&)
+        {
+            // The message is lost, but the sink keeps consuming
+        }
+        slot.sequence.store(pos + m_mask + 1, std::memory_order_release);
+        m_dequeue_pos.store(++pos, std::memory_order_release);
+        nb_forwarded++;
+    }
+    return nb_forwarded;
+}
+
+void LogSink::consume()
+{
+    while (true)
+    {
+        if (forward_messages() > 0)
+        {
+            { std::lock_guard<std::mutex> lock(m_mutex); }
+            m_forwarded.notify_all();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_consumer_idle.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!has_message())
+        {
+            if (m_stop) { break; }
+            m_wake.wait_for(lock, consumer_wait_timeout, [this]() { return m_stop || has_message(); });
+        }
+        m_consumer_idle.store(false, std::memory_order_relaxed);
+    }
+    m_forwarded.notify_all();
+}
+
+} // namespace io
+} // namespace stdutils
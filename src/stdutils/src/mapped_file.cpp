@@ -0,0 +1,161 @@
+// Copyright (c) 2023 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <stdutils/mapped_file.h>
+
+#include <cassert>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+#if defined(__linux__) || defined(__APPLE__)
+    #define STDUTILS_MMAP_POSIX 1
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#elif defined(_WIN32)
+    #define STDUTILS_MMAP_WIN32 1
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#endif
+
+namespace stdutils {
+namespace io {
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::filesystem::path& filepath)
+{
+    close();
+    if (map(filepath))
+    {
+        m_is_open = true;
+        return true;
+    }
+
+    // Fallback: Read the file in a buffer
+    std::ifstream inputstream(filepath, std::ios_base::in | std::ios_base::binary);
+    if (!inputstream.is_open())
+    {
+        return false;
+    }
+    m_buffer.assign(std::istreambuf_iterator<char>(inputstream), std::istreambuf_iterator<char>());
+    m_is_open = true;
+    return true;
+}
+
+void MappedFile::close() noexcept
+{
+    unmap();
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
+    m_is_open = false;
+}
+
+std::string_view MappedFile::view() const noexcept
+{
+    if (m_mapped_data != nullptr)
+    {
+        return std::string_view(m_mapped_data, m_mapped_size);
+    }
+    return std::string_view(m_buffer);
+}
+
+#if defined(STDUTILS_MMAP_POSIX)
+
+bool MappedFile::map(const std::filesystem::path& filepath) noexcept
+{
+    assert(m_mapped_data == nullptr);
+    const int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) { return false; }
+    struct stat file_stat;
+    bool success = false;
+    if (::fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0
+        && static_cast<unsigned long long>(file_stat.st_size) <= std::numeric_limits<std::size_t>::max())
+    {
+        const auto size = static_cast<std::size_t>(file_stat.st_size);
+        void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED)
+        {
+            ::madvise(addr, size, MADV_SEQUENTIAL);
+            m_mapped_data = static_cast<const char*>(addr);
+            m_mapped_size = size;
+            success = true;
+        }
+    }
+    ::close(fd);            // The mapping remains valid after closing the file descriptor
+    return success;
+}
+
+void MappedFile::unmap() noexcept
+{
+    if (m_mapped_data != nullptr)
+    {
+        ::munmap(const_cast<char*>(m_mapped_data), m_mapped_size);
+        m_mapped_data = nullptr;
+        m_mapped_size = 0;
+    }
+}
+
+#elif defined(STDUTILS_MMAP_WIN32)
+
+bool MappedFile::map(const std::filesystem::path& filepath) noexcept
+{
+    assert(m_mapped_data == nullptr);
+    HANDLE file = ::CreateFileW(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) { return false; }
+    LARGE_INTEGER file_size;
+    bool success = false;
+    if (::GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0
+        && static_cast<unsigned long long>(file_size.QuadPart) <= std::numeric_limits<std::size_t>::max())
+    {
+        HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr)
+        {
+            const void* addr = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (addr != nullptr)
+            {
+                m_mapped_data = static_cast<const char*>(addr);
+                m_mapped_size = static_cast<std::size_t>(file_size.QuadPart);
+                success = true;
+            }
+            ::CloseHandle(mapping);     // The view remains valid after closing the handles
+        }
+    }
+    ::CloseHandle(file);
+    return success;
+}
+
+void MappedFile::unmap() noexcept
+{
+    if (m_mapped_data != nullptr)
+    {
+        ::UnmapViewOfFile(m_mapped_data);
+        m_mapped_data = nullptr;
+        m_mapped_size = 0;
+    }
+}
+
+#else
+
+bool MappedFile::map(const std::filesystem::path&) noexcept
+{
+    return false;
+}
+
+void MappedFile::unmap() noexcept
+{
+}
+
+#endif
+
+} // namespace io
+} // namespace stdutils
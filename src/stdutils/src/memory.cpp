@@ -0,0 +1,113 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <stdutils/memory.h>
+
+#include <stdutils/io.h>
+
+#include <array>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+namespace stdutils {
+namespace memory {
+
+std::size_t get_current_rss() noexcept
+{
+#if   defined(__linux__)
+    // The second field of /proc/self/statm is the resident set size, in pages
+    std::FILE* file = std::fopen("/proc/self/statm", "r");
+    if (file == nullptr)
+        return 0;
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    const int nb_fields = std::fscanf(file, "%lu %lu", &size, &resident);
+    std::fclose(file);
+    const long page_size = sysconf(_SC_PAGESIZE);
+    return (nb_fields == 2 && page_size > 0) ? resident * static_cast<std::size_t>(page_size) : 0;
+
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    const kern_return_t ret = task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count);
+    return ret == KERN_SUCCESS ? static_cast<std::size_t>(info.resident_size) : 0;
+
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    const BOOL success = GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return success ? static_cast<std::size_t>(counters.WorkingSetSize) : 0;
+
+#else
+    return 0;
+
+#endif
+}
+
+std::size_t get_peak_rss() noexcept
+{
+#if   defined(__linux__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0 || usage.ru_maxrss < 0)
+        return 0;
+#if defined(__APPLE__)
+    return static_cast<std::size_t>(usage.ru_maxrss);           // Bytes
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024u;   // Kilobytes
+#endif
+
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    const BOOL success = GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return success ? static_cast<std::size_t>(counters.PeakWorkingSetSize) : 0;
+
+#else
+    return 0;
+
+#endif
+}
+
+std::ostream& operator<<(std::ostream& out, const HumanReadable& size)
+{
+    static constexpr std::array<const char*, 4> units = { "kB", "MB", "GB", "TB" };
+    if (size.bytes < 1000u)
+    {
+        out << size.bytes << " B";
+        return out;
+    }
+    std::size_t unit_idx = 0;
+    double value = static_cast<double>(size.bytes) / 1000.0;
+    while (value >= 1000.0 && unit_idx + 1 < units.size())
+    {
+        value /= 1000.0;
+        unit_idx++;
+    }
+    stdutils::io::SaveNumericFormat save_fmt(out);
+    out << std::defaultfloat << std::setprecision(3) << value << ' ' << units[unit_idx];
+    return out;
+}
+
+std::string to_string(const HumanReadable& size)
+{
+    std::stringstream out;
+    out << size;
+    return out.str();
+}
+
+} // namespace memory
+} // namespace stdutils
@@ -6,10 +6,19 @@
 
 #include <stdutils/platform.h>
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstdlib>
+#include <fstream>
 #include <sstream>
+#include <system_error>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #if defined(__APPLE__)
 #include "platform_macos.h"
@@ -229,5 +238,117 @@ fs::path get_local_app_data_path() noexcept
     }
 }
 
+namespace {
+
+std::vector<unsigned int> all_cpus()
+{
+    std::vector<unsigned int> cpus(std::max(std::thread::hardware_concurrency(), 1u));
+    for (unsigned int cpu = 0; cpu < cpus.size(); cpu++) { cpus[cpu] = cpu; }
+    return cpus;
+}
+
+#if defined(__linux__)
+
+// Parse a list of CPUs in the format of the kernel, e.g. "0-3,8,10-11"
+std::vector<unsigned int> parse_cpu_list(const std::string& list)
+{
+    std::vector<unsigned int> cpus;
+    std::istringstream in(list);
+    std::string range;
+    while (std::getline(in, range, ','))
+    {
+        unsigned int first = 0;
+        unsigned int last = 0;
+        char dash = 0;
+        std::istringstream range_in(range);
+        if (!(range_in >> first))
+            continue;
+        last = (range_in >> dash >> last && dash == '-') ? last : first;
+        for (unsigned int cpu = first; cpu <= last; cpu++) { cpus.push_back(cpu); }
+    }
+    return cpus;
+}
+
+std::vector<NumaNode> linux_numa_nodes()
+{
+    std::vector<NumaNode> result;
+    cpu_set_t process_mask;
+    CPU_ZERO(&process_mask);
+    const bool has_process_mask = sched_getaffinity(0, sizeof(cpu_set_t), &process_mask) == 0;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator("/sys/devices/system/node", ec))
+    {
+        const std::string dirname = entry.path().filename().string();
+        if (dirname.rfind("node", 0) != 0 || dirname.size() == 4 || !std::all_of(dirname.cbegin() + 4, dirname.cend(), [](char c) { return '0' <= c && c <= '9'; }))
+            continue;
+        std::ifstream cpulist_file(entry.path() / "cpulist");
+        std::string cpulist;
+        if (!std::getline(cpulist_file, cpulist))
+            continue;
+        NumaNode node;
+        node.id = static_cast<unsigned int>(std::stoul(dirname.substr(4)));
+        for (const unsigned int cpu : parse_cpu_list(cpulist))
+        {
+            if (!has_process_mask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &process_mask))) { node.cpus.push_back(cpu); }
+        }
+        if (!node.cpus.empty()) { result.emplace_back(std::move(node)); }
+    }
+    std::sort(result.begin(), result.end(), [](const NumaNode& lhs, const NumaNode& rhs) { return lhs.id < rhs.id; });
+    return result;
+}
+
+#endif
+
+} // namespace
+
+std::vector<NumaNode> numa_nodes()
+{
+    std::vector<NumaNode> result;
+    try
+    {
+#if defined(__linux__)
+        result = linux_numa_nodes();
+#endif
+    }
+    catch (...)
+    {
+        result.clear();
+    }
+    if (result.empty())
+    {
+        result.emplace_back();
+        result.back().cpus = all_cpus();
+    }
+    return result;
+}
+
+void print_cpu_topology(std::ostream& out, bool endl)
+{
+    const auto nodes = numa_nodes();
+    out << "NUMA nodes: " << nodes.size();
+    for (const auto& node : nodes) { out << (endl ? "\n  " : "; ") << "Node " << node.id << ": " << node.cpus.size() << " CPUs"; }
+    if (endl) { out << '\n'; }
+}
+
+bool set_current_thread_affinity(const std::vector<unsigned int>& cpus) noexcept
+{
+#if defined(__linux__)
+    if (cpus.empty())
+        return false;
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (const unsigned int cpu : cpus)
+    {
+        if (cpu >= CPU_SETSIZE)
+            return false;
+        CPU_SET(cpu, &mask);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
 } // namespace platform
 } // namespace stdutils
@@ -0,0 +1,176 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <stdutils/profiler.h>
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace stdutils {
+namespace profiler {
+
+namespace {
+
+struct Event
+{
+    const char* name;
+    std::int64_t start_ns;
+    std::int64_t duration_ns;
+};
+
+// The buffers are owned by the registry, so that the zones of the threads that have exited can still be exported
+struct ThreadBuffer
+{
+    std::mutex mutex;                       // Only contended during an export
+    std::vector<Event> events;
+    std::size_t thread_id = 0;
+};
+
+struct Registry
+{
+    std::atomic<bool> enabled = false;
+    const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+Registry& registry()
+{
+    static Registry s_registry;
+    return s_registry;
+}
+
+ThreadBuffer& thread_buffer()
+{
+    thread_local const std::shared_ptr<ThreadBuffer> buffer = []() {
+        auto& reg = registry();
+        auto new_buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        new_buffer->thread_id = reg.buffers.size();
+        reg.buffers.push_back(new_buffer);
+        return new_buffer;
+    }();
+    return *buffer;
+}
+
+std::int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - registry().origin).count();
+}
+
+void write_json_string(std::ostream& out, const char* str)
+{
+    out << '"';
+    for (const char* c = str; *c != '\0'; c++)
+    {
+        if (*c == '"' || *c == '\\') { out << '\\'; }
+        out << *c;
+    }
+    out << '"';
+}
+
+// Microseconds, with a nanosecond precision
+void write_us(std::ostream& out, std::int64_t ns)
+{
+    out << (ns / 1000) << '.' << std::setw(3) << std::setfill('0') << (ns % 1000) << std::setfill(' ');
+}
+
+} // namespace
+
+Zone::Zone(const char* name) noexcept
+    : m_name(name)
+    , m_start_ns(is_enabled() ? now_ns() : -1)
+{
+}
+
+Zone::~Zone()
+{
+    if (m_start_ns < 0) { return; }
+    try
+    {
+        const std::int64_t end_ns = now_ns();
+        auto& buffer = thread_buffer();
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.events.push_back(Event{ m_name, m_start_ns, end_ns - m_start_ns });
+    }
+    catch (...)
+    {
+        // Drop the zone
+    }
+}
+
+void set_enabled(bool enabled) noexcept
+{
+    registry().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool is_enabled() noexcept
+{
+    return registry().enabled.load(std::memory_order_relaxed);
+}
+
+void clear() noexcept
+{
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& buffer : reg.buffers)
+    {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        buffer->events.clear();
+    }
+}
+
+void save_chrome_trace(std::ostream& out)
+{
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer : reg.buffers)
+    {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        for (const auto& event : buffer->events)
+        {
+            out << (first ? "\n" : ",\n") << "{\"name\":";
+            write_json_string(out, event.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread_id << ",\"ts\":";
+            write_us(out, event.start_ns);
+            out << ",\"dur\":";
+            write_us(out, event.duration_ns);
+            out << '}';
+            first = false;
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void save_chrome_trace_file(const std::filesystem::path& filepath, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    try
+    {
+        std::ofstream out(filepath);
+        if (!out.is_open())
+        {
+            std::stringstream oss;
+            oss << "Cannot open file " << filepath;
+            err_handler(stdutils::io::Severity::ERR, oss.str());
+            return;
+        }
+        save_chrome_trace(out);
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream oss;
+        oss << "Saving the profiler trace: " << e.what();
+        err_handler(stdutils::io::Severity::EXCPT, oss.str());
+    }
+}
+
+} // namespace profiler
+} // namespace stdutils
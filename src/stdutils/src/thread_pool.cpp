@@ -0,0 +1,192 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <stdutils/thread_pool.h>
+
+#include <stdutils/platform.h>
+
+#include <cassert>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace stdutils {
+namespace parallel {
+
+namespace {
+
+// The pool and the index of the worker running on the current thread, if any
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local std::size_t current_worker_idx = 0;
+
+struct DefaultPool
+{
+    std::mutex mutex;
+    unsigned int nb_workers = default_nb_workers();
+    std::unique_ptr<ThreadPool> pool;
+};
+
+DefaultPool& default_pool_instance()
+{
+    static DefaultPool instance;
+    return instance;
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned int nb_workers, std::vector<unsigned int> cpu_affinity)
+    : m_cpu_affinity(std::move(cpu_affinity))
+    , m_worker_queues()
+    , m_shared_queue()
+    , m_nb_queued(0)
+    , m_mutex()
+    , m_wake()
+    , m_stop(false)
+    , m_threads()
+{
+    for (unsigned int worker_idx = 0; worker_idx < nb_workers; worker_idx++) { m_worker_queues.emplace_back(std::make_unique<WorkerQueue>()); }
+    m_threads.reserve(nb_workers);
+    for (std::size_t worker_idx = 0; worker_idx < nb_workers; worker_idx++) { m_threads.emplace_back(&ThreadPool::worker_loop, this, worker_idx); }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& thread : m_threads) { thread.join(); }
+    Task task;
+    while (pop_task(task)) { task(); }      // Without workers
+}
+
+void ThreadPool::submit(Task task)
+{
+    assert(task);
+    WorkerQueue& queue = (current_pool == this) ? *m_worker_queues[current_worker_idx] : m_shared_queue;
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_nb_queued++;
+    }
+    m_wake.notify_one();
+}
+
+bool ThreadPool::pop_task(Task& task)
+{
+    if (m_nb_queued == 0)
+        return false;
+    const auto pop = [this, &task](WorkerQueue& queue, bool back) {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+            return false;
+        if (back) { task = std::move(queue.tasks.back()); queue.tasks.pop_back(); }
+        else { task = std::move(queue.tasks.front()); queue.tasks.pop_front(); }
+        m_nb_queued--;
+        return true;
+    };
+
+    // Own deque first, most recent task first, then the shared queue and the other deques, oldest task first
+    const std::size_t nb_queues = m_worker_queues.size();
+    const bool is_worker = (current_pool == this);
+    const std::size_t first_idx = is_worker ? current_worker_idx : 0;
+    if (is_worker && pop(*m_worker_queues[first_idx], true))
+        return true;
+    if (pop(m_shared_queue, false))
+        return true;
+    for (std::size_t offset = is_worker ? 1 : 0; offset < nb_queues; offset++)
+    {
+        if (pop(*m_worker_queues[(first_idx + offset) % nb_queues], false))
+            return true;
+    }
+    return false;
+}
+
+bool ThreadPool::run_pending_task()
+{
+    Task task;
+    if (!pop_task(task))
+        return false;
+    task();
+    return true;
+}
+
+void ThreadPool::notify_all()
+{
+    {
+        // Between the test of the condition and the wait of wait_until()
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_wake.notify_all();
+}
+
+void ThreadPool::worker_loop(std::size_t worker_idx)
+{
+    current_pool = this;
+    current_worker_idx = worker_idx;
+    if (!m_cpu_affinity.empty()) { platform::set_current_thread_affinity(m_cpu_affinity); }     // Best effort
+    while (true)
+    {
+        if (run_pending_task())
+            continue;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait(lock, [this]() { return m_stop || m_nb_queued > 0; });
+        if (m_stop && m_nb_queued == 0)
+            break;
+    }
+    current_pool = nullptr;
+}
+
+unsigned int default_nb_workers() noexcept
+{
+    const unsigned int hardware_concurrency = std::thread::hardware_concurrency();
+    return hardware_concurrency > 2 ? hardware_concurrency - 1 : 1;
+}
+
+ThreadPool& default_thread_pool()
+{
+    auto& instance = default_pool_instance();
+    std::lock_guard<std::mutex> lock(instance.mutex);
+    if (!instance.pool) { instance.pool = std::make_unique<ThreadPool>(instance.nb_workers); }
+    return *instance.pool;
+}
+
+bool set_default_thread_pool_size(unsigned int nb_workers)
+{
+    auto& instance = default_pool_instance();
+    std::lock_guard<std::mutex> lock(instance.mutex);
+    if (instance.pool)
+        return false;
+    instance.nb_workers = nb_workers;
+    return true;
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+    : m_pool(pool)
+    , m_nb_pending(0)
+    , m_cancelled(false)
+    , m_mutex()
+    , m_exception()
+{ }
+
+TaskGroup::~TaskGroup()
+{
+    m_pool.wait_until([this]() { return m_nb_pending == 0; });
+}
+
+void TaskGroup::wait()
+{
+    m_pool.wait_until([this]() { return m_nb_pending == 0; });
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::swap(exception, m_exception);
+    }
+    if (exception) { std::rethrow_exception(exception); }
+}
+
+} // namespace parallel
+} // namespace stdutils
@@ -18,5 +18,9 @@ struct Paths
 
 Paths<double> parse_svg_paths(std::filesystem::path filepath, const stdutils::io::ErrorHandler& err_handler) noexcept;
 
+// Same as above, with an on-disk cache of the result in the SHB format, in directory cache_dir. The cache entries are keyed by a hash
+// of the absolute path, the size and the last write time of the SVG file, so that reopening an unchanged file skips the parsing.
+Paths<double> parse_svg_paths(std::filesystem::path filepath, const std::filesystem::path& cache_dir, const stdutils::io::ErrorHandler& err_handler) noexcept;
+
 } // namespace io
 } // namespace svg
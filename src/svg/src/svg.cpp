@@ -1,19 +1,34 @@
 #include <svg/svg.h>
 
+#include <lin/mat.h>
+#include <lin/transform.h>
+#include <shapes/io.h>
 #include <shapes/vect.h>
 #include <ssvg_init.h>
 #include <ssvg/ssvg.h>
 #include <stdutils/io.h>
 #include <stdutils/macros.h>
+#include <stdutils/parallel.h>
 
 #include <algorithm>
-#include <array>
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <exception>
 #include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iterator>
+#include <random>
 #include <sstream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <variant>
+#include <vector>
 
 namespace svg {
 namespace io {
@@ -68,14 +83,20 @@ struct SSVGImageEncapsulate
 //  ( b  d  f )
 //  ( 0  0  1 )
 //
-using SVGTransformMatrix = std::array<float, 6>;
+// The transformations are composed in double precision, and applied to the whole shapes with the batched kernel of lin/transform.h.
+//
+lin::mat3d to_affine_transform(const float* svg_transform)
+{
+    assert(svg_transform);
+    return lin::affine2<double>(svg_transform[0], svg_transform[1], svg_transform[2], svg_transform[3], svg_transform[4], svg_transform[5]);
+}
 
 struct SVGImageGeometry
 {
     static constexpr float RESOLUTION_RATIO = 1e-5f;
 
     SVGImageGeometry(float width, float height)
-        : transformation { 1.f, 0.f, 0.f, 1.f, 0.f, 0.f }
+        : transformation(lin::mat3d::identity())
         , width(width)
         , height(height)
         , min_resolution(RESOLUTION_RATIO * std::max(1.f, std::max(width, height)))
@@ -84,19 +105,34 @@ struct SVGImageGeometry
     SVGImageGeometry(const float* svg_transform, float width, float height)
         : SVGImageGeometry(width, height)
     {
-        assert(svg_transform);
-        std::copy(svg_transform, svg_transform + 6, transformation.begin());
+        transformation = to_affine_transform(svg_transform);
     }
 
     SVGImageGeometry transform(const float* svg_transform) const
     {
-        assert(svg_transform);
         SVGImageGeometry result = *this;
-        ssvg::transformMultiply(result.transformation.data(), svg_transform);
+        result.transformation = transformation * to_affine_transform(svg_transform);
         return result;
     }
 
-    SVGTransformMatrix transformation;
+    // In place, points in the coordinates of the shape
+    template <typename F>
+    void transform_points(std::vector<shapes::Point2d<F>>& points) const
+    {
+        static_assert(sizeof(shapes::Point2d<F>) == 2 * sizeof(F));
+        F* const coords = reinterpret_cast<F*>(points.data());
+        lin::transform_points(transformation, coords, coords, points.size());
+    }
+
+    // Distance between two points of the shape, in the image coordinates
+    template <typename F>
+    F inf_distance(const shapes::Point2d<F>& p, const shapes::Point2d<F>& q) const
+    {
+        const auto v = lin::transform_vector(transformation, lin::vect2d { static_cast<double>(q.x - p.x), static_cast<double>(q.y - p.y) });
+        return static_cast<F>(std::max(std::abs(v[0]), std::abs(v[1])));
+    }
+
+    lin::mat3d transformation;
     float width;
     float height;
     float min_resolution;
@@ -156,7 +192,6 @@ void parse_ssvg_image_path(const ssvg::Path& path, const unsigned int idx_start,
     // Second pass to import the vertices
     if (can_import_path && count_cubicto > 0)
     {
-        std::array<float, 7> tr_data;
         auto& new_cbp = out_paths.cubic_bezier_paths.emplace_back();
         new_cbp.closed = false; // By default
         for (unsigned int idx = idx_start; idx < idx_end; idx++)
@@ -166,21 +201,19 @@ void parse_ssvg_image_path(const ssvg::Path& path, const unsigned int idx_start,
             {
                 case ssvg::PathCmdType::Enum::MoveTo:       // Data: [0] = x, [1] = y
                     assert(new_cbp.vertices.empty());
-                    ssvg::transformPoint(image_geometry.transformation.data(), &cmd.m_Data[0], &tr_data[0]);
                     new_cbp.vertices.emplace_back(
-                        static_cast<F>(tr_data[0]),
-                        static_cast<F>(tr_data[1]));
+                        static_cast<F>(cmd.m_Data[0]),
+                        static_cast<F>(cmd.m_Data[1]));
                     break;
 
                 case ssvg::PathCmdType::Enum::LineTo:       // Data: [0] = x, [1] = y
                 {
                     // Convert straight line to a cubic bezier
                     assert(!new_cbp.vertices.empty());
-                    ssvg::transformPoint(image_geometry.transformation.data(), &cmd.m_Data[0], &tr_data[0]);
                     const shapes::Point2d<F> prev_point = new_cbp.vertices.back();
                     const shapes::Point2d<F> next_point(
-                        static_cast<F>(tr_data[0]),
-                        static_cast<F>(tr_data[1]));
+                        static_cast<F>(cmd.m_Data[0]),
+                        static_cast<F>(cmd.m_Data[1]));
                     new_cbp.vertices.emplace_back(
                         (F{2} / F{3}) * prev_point.x + (F{1} / F{3}) * next_point.x,
                         (F{2} / F{3}) * prev_point.y + (F{1} / F{3}) * next_point.y);
@@ -192,33 +225,28 @@ void parse_ssvg_image_path(const ssvg::Path& path, const unsigned int idx_start,
                 }
 
                 case ssvg::PathCmdType::Enum::CubicTo:      // Data: [0] = x1, [1] = y1, [2] = x2, [3] = y2, [4] = x, [5] = y
-                    ssvg::transformPoint(image_geometry.transformation.data(), &cmd.m_Data[0], &tr_data[0]);
-                    ssvg::transformPoint(image_geometry.transformation.data(), &cmd.m_Data[2], &tr_data[2]);
-                    ssvg::transformPoint(image_geometry.transformation.data(), &cmd.m_Data[4], &tr_data[4]);
                     new_cbp.vertices.emplace_back(
-                        static_cast<F>(tr_data[0]),
-                        static_cast<F>(tr_data[1]));
+                        static_cast<F>(cmd.m_Data[0]),
+                        static_cast<F>(cmd.m_Data[1]));
                     new_cbp.vertices.emplace_back(
-                        static_cast<F>(tr_data[2]),
-                        static_cast<F>(tr_data[3]));
+                        static_cast<F>(cmd.m_Data[2]),
+                        static_cast<F>(cmd.m_Data[3]));
                     new_cbp.vertices.emplace_back(
-                        static_cast<F>(tr_data[4]),
-                        static_cast<F>(tr_data[5]));
+                        static_cast<F>(cmd.m_Data[4]),
+                        static_cast<F>(cmd.m_Data[5]));
                     break;
 
                 case ssvg::PathCmdType::Enum::QuadraticTo:  // Data: [0] = x1, [1] = y1, [2] = x, [3] = y
                 {
                     // Convert quad bezier to a cubic bezier
                     assert(!new_cbp.vertices.empty());
-                    ssvg::transformPoint(image_geometry.transformation.data(), &cmd.m_Data[0], &tr_data[0]);
-                    ssvg::transformPoint(image_geometry.transformation.data(), &cmd.m_Data[2], &tr_data[2]);
                     const shapes::Point2d<F> prev_point = new_cbp.vertices.back();
                     const shapes::Point2d<F> control_point(
-                        static_cast<F>(tr_data[0]),
-                        static_cast<F>(tr_data[1]));
+                        static_cast<F>(cmd.m_Data[0]),
+                        static_cast<F>(cmd.m_Data[1]));
                     const shapes::Point2d<F> next_point(
-                        static_cast<F>(tr_data[2]),
-                        static_cast<F>(tr_data[3]));
+                        static_cast<F>(cmd.m_Data[2]),
+                        static_cast<F>(cmd.m_Data[3]));
                     new_cbp.vertices.emplace_back(
                         (prev_point.x + F{2} * control_point.x) / F{3},
                         (prev_point.y + F{2} * control_point.y) / F{3});
@@ -235,11 +263,10 @@ void parse_ssvg_image_path(const ssvg::Path& path, const unsigned int idx_start,
                     // It generates nan on some cases (for example with test file icons8-futurama-leela.svg).
                     // For now we just convert arc to straight lines
                     // TODO implement a more sensible conversion to cubic Bezier
-                    ssvg::transformPoint(image_geometry.transformation.data(), &cmd.m_Data[5], &tr_data[5]);
                     const shapes::Point2d<F> prev_point = new_cbp.vertices.back();
                     const shapes::Point2d<F> next_point(
-                        static_cast<F>(tr_data[5]),
-                        static_cast<F>(tr_data[6]));
+                        static_cast<F>(cmd.m_Data[5]),
+                        static_cast<F>(cmd.m_Data[6]));
                     new_cbp.vertices.emplace_back(
                         (F{2} / F{3}) * prev_point.x + (F{1} / F{3}) * next_point.x,
                         (F{2} / F{3}) * prev_point.y + (F{1} / F{3}) * next_point.y);
@@ -256,7 +283,7 @@ void parse_ssvg_image_path(const ssvg::Path& path, const unsigned int idx_start,
                     {
                         const shapes::Point2d<F> first_point = new_cbp.vertices.front();
                         const shapes::Point2d<F> last_point = new_cbp.vertices.back();
-                        if (shapes::inf_norm<F>(last_point - first_point) < static_cast<F>(image_geometry.min_resolution))
+                        if (image_geometry.inf_distance(first_point, last_point) < static_cast<F>(image_geometry.min_resolution))
                         {
                             // Assume first and last points are identical and therefore drop the redundant vertex
                             new_cbp.vertices.pop_back();
@@ -281,11 +308,11 @@ void parse_ssvg_image_path(const ssvg::Path& path, const unsigned int idx_start,
                     break;
             }
         }
+        image_geometry.transform_points(new_cbp.vertices);
         assert(shapes::is_valid(new_cbp));
     }
     else if (can_import_path)
     {
-        std::array<float, 2> tr_data;
         auto& new_pp = out_paths.point_paths.emplace_back();
         new_pp.closed = false;  // by default
         for (unsigned int idx = idx_start; idx < idx_end; idx++)
@@ -295,10 +322,9 @@ void parse_ssvg_image_path(const ssvg::Path& path, const unsigned int idx_start,
             {
                 case ssvg::PathCmdType::Enum::MoveTo:       // Data: [0] = x, [1] = y
                 case ssvg::PathCmdType::Enum::LineTo:       // Data: [0] = x, [1] = y
-                    ssvg::transformPoint(image_geometry.transformation.data(), &cmd.m_Data[0], &tr_data[0]);
                     new_pp.vertices.emplace_back(
-                        static_cast<F>(tr_data[0]),
-                        static_cast<F>(tr_data[1]));
+                        static_cast<F>(cmd.m_Data[0]),
+                        static_cast<F>(cmd.m_Data[1]));
                     break;
 
                 case ssvg::PathCmdType::Enum::CubicTo:
@@ -313,7 +339,7 @@ void parse_ssvg_image_path(const ssvg::Path& path, const unsigned int idx_start,
                     {
                         const auto& first_point = new_pp.vertices.front();
                         const auto& last_point = new_pp.vertices.back();
-                        if (shapes::inf_norm<F>(last_point - first_point) < static_cast<F>(image_geometry.min_resolution))
+                        if (image_geometry.inf_distance(first_point, last_point) < static_cast<F>(image_geometry.min_resolution))
                         {
                             // Assume first and last points are identical and therefore drop the redundant vertex
                             new_pp.vertices.pop_back();
@@ -331,6 +357,7 @@ void parse_ssvg_image_path(const ssvg::Path& path, const unsigned int idx_start,
                     break;
             }
         }
+        image_geometry.transform_points(new_pp.vertices);
         assert(shapes::is_valid(new_pp));
     }
     else
@@ -384,33 +411,25 @@ void parse_ssvg_image_shape(const ssvg::Shape* shape_ptr, const SVGImageGeometry
 
         case ssvg::ShapeType::Enum::Line:
         {
-            ssvg::Line line;
-            ssvg::transformPoint(sub_image_geometry.transformation.data(), &shape_ptr->m_Line.x1, &line.x1);
-            ssvg::transformPoint(sub_image_geometry.transformation.data(), &shape_ptr->m_Line.x2, &line.x2);
             auto& new_pp = out_paths.point_paths.emplace_back();
             new_pp.closed = false;
             new_pp.vertices.emplace_back(
-                static_cast<F>(line.x1),
-                static_cast<F>(line.y1));
+                static_cast<F>(shape_ptr->m_Line.x1),
+                static_cast<F>(shape_ptr->m_Line.y1));
             new_pp.vertices.emplace_back(
-                static_cast<F>(line.x2),
-                static_cast<F>(line.y2));
+                static_cast<F>(shape_ptr->m_Line.x2),
+                static_cast<F>(shape_ptr->m_Line.y2));
+            sub_image_geometry.transform_points(new_pp.vertices);
             break;
         }
 
         case ssvg::ShapeType::Enum::Polyline:
         case ssvg::ShapeType::Enum::Polygon:
         {
-            std::array<float, 2> coord;
             auto& new_pp = out_paths.point_paths.emplace_back();
             new_pp.closed = (shape_ptr->m_Type == ssvg::ShapeType::Enum::Polygon);
-            for (unsigned int idx = 0; idx < shape_ptr->m_PointList.m_NumPoints; idx++)
-            {
-                ssvg::transformPoint(sub_image_geometry.transformation.data(), &shape_ptr->m_PointList.m_Coords[2 * idx], &coord[0]);
-                new_pp.vertices.emplace_back(
-                    static_cast<F>(coord[0]),
-                    static_cast<F>(coord[1]));
-            }
+            new_pp.vertices.resize(shape_ptr->m_PointList.m_NumPoints);
+            lin::transform_points(sub_image_geometry.transformation, shape_ptr->m_PointList.m_Coords, reinterpret_cast<F*>(new_pp.vertices.data()), new_pp.vertices.size());
             assert(std::all_of(new_pp.vertices.begin(), new_pp.vertices.end(), [](const auto& p) { return shapes::isfinite(p); }));
             break;
         }
@@ -439,8 +458,55 @@ void parse_ssvg_image_shape_list(const ssvg::ShapeList* shape_list_ptr, const SV
     }
 }
 
+// A shape of the tree other than a group, with the geometry of its parent
+struct SSVGLeafShape
+{
+    const ssvg::Shape* shape_ptr;
+    SVGImageGeometry parent_geometry;
+};
+
+void collect_ssvg_leaf_shapes(const ssvg::ShapeList* shape_list_ptr, const SVGImageGeometry& image_geometry, std::vector<SSVGLeafShape>& out_shapes)
+{
+    for (unsigned int idx = 0; idx < shape_list_ptr->m_NumShapes; idx++)
+    {
+        const ssvg::Shape* shape_ptr = &shape_list_ptr->m_Shapes[idx];
+        if (shape_ptr->m_Type == ssvg::ShapeType::Enum::Group)
+            collect_ssvg_leaf_shapes(&shape_ptr->m_ShapeList, image_geometry.transform(&shape_ptr->m_Attrs->m_Transform[0]), out_shapes);
+        else
+            out_shapes.push_back(SSVGLeafShape{ shape_ptr, image_geometry });
+    }
+}
+
+// Same output as parse_ssvg_image_shape_list(), but the shapes are converted concurrently. The groups are flattened first, since an image
+// is often a single top-level group. Each chunk of shapes has its own paths and error log, which are then merged in the order of the
+// shapes, therefore the result and the messages do not depend on the number of threads.
 template <typename F>
-Paths<F> parse_svg_paths_gen(std::filesystem::path filepath, const stdutils::io::ErrorHandler& err_handler) noexcept
+void parse_ssvg_image_shape_tree(const ssvg::ShapeList* shape_list_ptr, const SVGImageGeometry& image_geometry, Paths<F>& out_paths, const stdutils::io::ErrorHandler& err_handler)
+{
+    constexpr std::size_t min_shapes_per_chunk = 64;
+    std::vector<SSVGLeafShape> leaf_shapes;
+    collect_ssvg_leaf_shapes(shape_list_ptr, image_geometry, leaf_shapes);
+    stdutils::parallel::Policy policy;
+    policy.min_chunk_size = min_shapes_per_chunk;
+    const std::size_t nb_chunks = stdutils::parallel::nb_chunks(policy, leaf_shapes.size());
+    std::vector<Paths<F>> chunk_paths(nb_chunks);
+    std::vector<stdutils::io::ErrorLog> chunk_logs(nb_chunks);
+    stdutils::parallel::for_each_chunk(policy, leaf_shapes.size(), [&](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+        const auto chunk_err_handler = chunk_logs[chunk_idx].handler();
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++)
+            parse_ssvg_image_shape(leaf_shapes[idx].shape_ptr, leaf_shapes[idx].parent_geometry, chunk_paths[chunk_idx], chunk_err_handler);
+    });
+    for (std::size_t chunk_idx = 0; chunk_idx < nb_chunks; chunk_idx++)
+    {
+        auto& paths = chunk_paths[chunk_idx];
+        out_paths.point_paths.insert(out_paths.point_paths.end(), std::make_move_iterator(paths.point_paths.begin()), std::make_move_iterator(paths.point_paths.end()));
+        out_paths.cubic_bezier_paths.insert(out_paths.cubic_bezier_paths.end(), std::make_move_iterator(paths.cubic_bezier_paths.begin()), std::make_move_iterator(paths.cubic_bezier_paths.end()));
+        chunk_logs[chunk_idx].forward(err_handler);
+    }
+}
+
+// The source buffer only lives for the duration of the call, so that it is released before the conversion of the shape tree
+ssvg::Image* load_ssvg_image(const std::filesystem::path& filepath, const stdutils::io::ErrorHandler& err_handler)
 {
     std::error_code err_code;
     const auto sz = std::filesystem::file_size(filepath, err_code);
@@ -449,29 +515,38 @@ Paths<F> parse_svg_paths_gen(std::filesystem::path filepath, const stdutils::io:
         std::stringstream oss;
         oss << "std::filesystem::file_size(" << filepath.filename() << "): error_code=" << err_code;
         err_handler(stdutils::io::Severity::ERR, oss.str());
-        return Paths<F>();
+        return nullptr;
     }
-    const auto svg_buffer = stdutils::io::open_and_parse_txt_file<std::vector<char>, char>(filepath, [sz](auto& istream, const auto&) {
+    // Binary mode: No newline translation of the (possibly huge) file, the XML parser treats CR as a whitespace
+    const auto svg_buffer = stdutils::io::open_and_parse_bin_file<std::vector<char>, char>(filepath, [sz](auto& istream, const auto&) {
         std::vector<char> buf(sz + 1, 0u);
         istream.read(buf.data(), static_cast<std::streamsize>(sz));
         return buf;
     }, err_handler);
+    if (svg_buffer.empty())
+        return nullptr;     // The error was reported by open_and_parse_bin_file
+    constexpr std::uint32_t svg_parser_flags = 0;
+    initialize_ssvg_lib();
+    ssvg::Image* img_ptr = ssvg::imageLoad(svg_buffer.data(), svg_parser_flags, &get_default_shape_attributes());
+    if (img_ptr == nullptr)
+        err_handler(stdutils::io::Severity::ERR, "Library simple-svg failed to parse the image");
+    return img_ptr;
+}
+
+template <typename F>
+Paths<F> parse_svg_paths_gen(std::filesystem::path filepath, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
     try
     {
-        constexpr std::uint32_t svg_parser_flags = 0;
-        initialize_ssvg_lib();
-        SSVGImageEncapsulate ssvg_img(ssvg::imageLoad(svg_buffer.data(), svg_parser_flags, &get_default_shape_attributes()));
+        SSVGImageEncapsulate ssvg_img(load_ssvg_image(filepath, err_handler));
         if (ssvg_img.ptr == nullptr)
-        {
-            err_handler(stdutils::io::Severity::ERR, "Library simple-svg failed to parse the image");
             return Paths<F>();
-        }
         SVGImageGeometry src_image_geometry(
             &ssvg_img.ptr->m_BaseAttrs.m_Transform[0],
             ssvg_img.ptr->m_Width,
             ssvg_img.ptr->m_Height);
         Paths<F> result;
-        parse_ssvg_image_shape_list(&ssvg_img.ptr->m_ShapeList, src_image_geometry, result, err_handler);
+        parse_ssvg_image_shape_tree(&ssvg_img.ptr->m_ShapeList, src_image_geometry, result, err_handler);
         return result;
     }
     catch(const std::exception& e)
@@ -483,6 +558,98 @@ Paths<F> parse_svg_paths_gen(std::filesystem::path filepath, const stdutils::io:
     }
 }
 
+// FNV-1a, so that the cache keys are stable across runs and platforms
+class CacheKeyHash
+{
+public:
+    void add(const void* data, std::size_t sz)
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t idx = 0; idx < sz; idx++)
+        {
+            m_hash ^= bytes[idx];
+            m_hash *= 0x100000001b3ull;
+        }
+    }
+    std::uint64_t value() const { return m_hash; }
+
+private:
+    std::uint64_t m_hash = 0xcbf29ce484222325ull;
+};
+
+// Return an empty path if the SVG file cannot be keyed
+std::filesystem::path cache_entry_path(const std::filesystem::path& filepath, const std::filesystem::path& cache_dir)
+{
+    std::error_code err_code;
+    const auto abs_path = std::filesystem::absolute(filepath, err_code);
+    if (err_code) { return std::filesystem::path(); }
+    const std::uint64_t sz = std::filesystem::file_size(filepath, err_code);
+    if (err_code) { return std::filesystem::path(); }
+    const auto mtime = std::filesystem::last_write_time(filepath, err_code);
+    if (err_code) { return std::filesystem::path(); }
+    const auto mtime_count = mtime.time_since_epoch().count();
+    const std::string path_str = abs_path.generic_u8string();
+    CacheKeyHash hash;
+    hash.add(path_str.data(), path_str.size());
+    hash.add(&sz, sizeof(sz));
+    hash.add(&mtime_count, sizeof(mtime_count));
+    std::stringstream filename;
+    filename << "svg_" << std::hex << std::setw(16) << std::setfill('0') << hash.value() << shapes::io::shb::FILE_EXTENSION;
+    return cache_dir / filename.str();
+}
+
+shapes::io::ShapeAggregate<double> to_shape_aggregate(const Paths<double>& paths)
+{
+    shapes::io::ShapeAggregate<double> result;
+    result.reserve(paths.point_paths.size() + paths.cubic_bezier_paths.size());
+    for (const auto& pp : paths.point_paths)
+        result.emplace_back(pp);
+    for (const auto& cbp : paths.cubic_bezier_paths)
+        result.emplace_back(cbp);
+    return result;
+}
+
+// Return false if the aggregate holds other shapes than the ones produced by parse_svg_paths
+bool from_shape_aggregate(shapes::io::ShapeAggregate<double>&& shapes, Paths<double>& out_paths)
+{
+    for (auto& shape_wrapper : shapes)
+    {
+        if (auto* pp = std::get_if<shapes::PointPath2d<double>>(&shape_wrapper.shape))
+            out_paths.point_paths.emplace_back(std::move(*pp));
+        else if (auto* cbp = std::get_if<shapes::CubicBezierPath2d<double>>(&shape_wrapper.shape))
+            out_paths.cubic_bezier_paths.emplace_back(std::move(*cbp));
+        else
+            return false;
+    }
+    return true;
+}
+
+// The temporary file of an entry has a unique name, since several processes or threads may write the same entry concurrently
+std::filesystem::path temporary_entry_path(const std::filesystem::path& cache_path)
+{
+    static std::atomic<std::uint64_t> counter{0};
+    std::random_device random_device;
+    std::stringstream suffix;
+    suffix << ".tmp." << std::hex << random_device() << '.' << std::hash<std::thread::id>()(std::this_thread::get_id()) << '.' << counter++;
+    auto tmp_path = cache_path;
+    tmp_path += suffix.str();
+    return tmp_path;
+}
+
+// Record the highest severity of the messages, while forwarding them. The handler is copied, since it may be a temporary (see ErrorLog::handler).
+struct SeverityTracker
+{
+    explicit SeverityTracker(const stdutils::io::ErrorHandler& err_handler)
+        : handler([this, err_handler](stdutils::io::SeverityCode sev, stdutils::io::ErrorMessage msg) {
+            if (sev <= stdutils::io::Severity::ERR) { has_error = true; }
+            err_handler(sev, msg);
+        })
+    {}
+
+    bool has_error = false;
+    stdutils::io::ErrorHandler handler;
+};
+
 } // namespace
 
 Paths<double> parse_svg_paths(std::filesystem::path filepath, const stdutils::io::ErrorHandler& err_handler) noexcept
@@ -490,5 +657,62 @@ Paths<double> parse_svg_paths(std::filesystem::path filepath, const stdutils::io
     return parse_svg_paths_gen<double>(filepath, err_handler);
 }
 
+Paths<double> parse_svg_paths(std::filesystem::path filepath, const std::filesystem::path& cache_dir, const stdutils::io::ErrorHandler& err_handler) noexcept
+{
+    try
+    {
+        const auto cache_path = cache_entry_path(filepath, cache_dir);
+        if (cache_path.empty())
+            return parse_svg_paths(filepath, err_handler);
+
+        // Cache hit. On a corrupted or unexpected entry, fall back on the parsing of the SVG file, which overwrites the entry.
+        std::error_code err_code;
+        if (std::filesystem::is_regular_file(cache_path, err_code))
+        {
+            stdutils::io::ErrorLog cache_log;
+            SeverityTracker tracker(cache_log.handler());
+            Paths<double> result;
+            if (from_shape_aggregate(shapes::io::shb::parse_shapes_from_file(cache_path, tracker.handler), result) && !tracker.has_error)
+            {
+                err_handler(stdutils::io::Severity::INFO, "Loaded the SVG paths from the cache");
+                return result;
+            }
+            err_handler(stdutils::io::Severity::WARN, "Invalid entry in the SVG cache");
+        }
+
+        // Cache miss. The entry is written to a temporary file first, then renamed, so that it is never read in a partial state.
+        // If several writers race, each one renames its own complete file and the last one wins.
+        SeverityTracker tracker(err_handler);
+        Paths<double> result = parse_svg_paths(filepath, tracker.handler);
+        if (tracker.has_error)
+            return result;
+        std::filesystem::create_directories(cache_dir, err_code);
+        if (err_code)
+        {
+            err_handler(stdutils::io::Severity::WARN, "Could not create the SVG cache directory");
+            return result;
+        }
+        const auto tmp_path = temporary_entry_path(cache_path);
+        stdutils::io::ErrorLog save_log;
+        SeverityTracker save_tracker(save_log.handler());
+        shapes::io::shb::save_shapes_as_file(tmp_path, to_shape_aggregate(result), save_tracker.handler);
+        if (!save_tracker.has_error)
+            std::filesystem::rename(tmp_path, cache_path, err_code);
+        if (save_tracker.has_error || err_code)
+        {
+            std::filesystem::remove(tmp_path, err_code);
+            err_handler(stdutils::io::Severity::WARN, "Could not write the entry of the SVG cache");
+        }
+        return result;
+    }
+    catch(const std::exception& e)
+    {
+        std::stringstream oss;
+        oss << "SVG cache: " << e.what();
+        err_handler(stdutils::io::Severity::EXCPT, oss.str());
+        return Paths<double>();
+    }
+}
+
 } // namespace io
 } // namespace svg
@@ -0,0 +1,178 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include "triangulation_helpers.h"
+
+#include <dt/auto_select.h>
+#include <dt/dt_impl.h>
+#include <dt/dt_interface.h>
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+namespace delaunay {
+namespace test {
+
+namespace {
+
+bool is_registered(const std::string& name)
+{
+    for (const auto& impl : registered_impls())
+        if (impl.name == name) { return true; }
+    return false;
+}
+
+std::string reference_name()
+{
+    REQUIRE(!registered_impls().empty());
+    return get_impl_list<double, index>().reference;
+}
+
+// The implementation selected by a rule if it is registered, otherwise the reference
+std::string rule_or_reference(const std::string& candidate)
+{
+    return is_registered(candidate) ? candidate : reference_name();
+}
+
+SelectionProfile::Measurement measurement(const std::string& algo_name, TriangulationPolicy policy, std::size_t nb_vertices, std::size_t nb_constraint_vertices, float median_ms)
+{
+    SelectionProfile::Measurement result;
+    result.algo_name = algo_name;
+    result.features.policy = policy;
+    result.features.nb_vertices = nb_vertices;
+    result.features.nb_constraint_vertices = nb_constraint_vertices;
+    result.median_ms = median_ms;
+    return result;
+}
+
+InputFeatures features(TriangulationPolicy policy, std::size_t nb_vertices, std::size_t nb_constraint_vertices = 0)
+{
+    InputFeatures result;
+    result.policy = policy;
+    result.nb_vertices = nb_vertices;
+    result.nb_constraint_vertices = nb_constraint_vertices;
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Selection profile: Write, then parse", "[dt]")
+{
+    SelectionProfile profile;
+    profile.measurements.push_back(measurement("CDT_fp64", TriangulationPolicy::CDT, 10000, 2500, 12.5f));
+    profile.measurements.push_back(measurement("DivConq", TriangulationPolicy::PointCloud, 1000000, 0, 250.f));
+    std::stringstream buffer;
+    write_selection_profile(buffer, profile);
+    const auto parsed = parse_selection_profile(buffer, no_error_handler());
+    REQUIRE(parsed.measurements.size() == profile.measurements.size());
+    for (std::size_t idx = 0; idx < parsed.measurements.size(); idx++)
+    {
+        CAPTURE(idx);
+        const auto& expected = profile.measurements[idx];
+        const auto& actual = parsed.measurements[idx];
+        CHECK(actual.algo_name == expected.algo_name);
+        CHECK(actual.features.policy == expected.features.policy);
+        CHECK(actual.features.nb_vertices == expected.features.nb_vertices);
+        CHECK(actual.features.nb_constraint_vertices == expected.features.nb_constraint_vertices);
+        CHECK(actual.median_ms == expected.median_ms);
+    }
+}
+
+TEST_CASE("Selection profile: Invalid lines", "[dt]")
+{
+    std::stringstream buffer;
+    buffer << "# Comment\n"
+           << "\n"
+           << "CDT_fp64 cdt 100 20 1.5\n"
+           << "CDT_fp64 tin 100 20 1.5\n"            // Unknown policy
+           << "CDT_fp64 pc hundred 0 1.5\n"          // Not a number
+           << "CDT_fp64 pc 100\n"                    // Truncated
+           << "DivConq pc 100 0 0.5\n";
+    std::size_t nb_errors = 0;
+    const auto parsed = parse_selection_profile(buffer, error_counter(nb_errors));
+    CHECK(nb_errors == 3);
+    REQUIRE(parsed.measurements.size() == 2);
+    CHECK(parsed.measurements[0].algo_name == "CDT_fp64");
+    CHECK(parsed.measurements[0].features.policy == TriangulationPolicy::CDT);
+    CHECK(parsed.measurements[1].algo_name == "DivConq");
+    CHECK(parsed.measurements[1].features.policy == TriangulationPolicy::PointCloud);
+}
+
+TEST_CASE("Automatic selection: Built-in rules", "[dt]")
+{
+    const SelectionProfile empty_profile;
+    SECTION("Constraint ratio")
+    {
+        CHECK(features(TriangulationPolicy::PointCloud, 100, 50).constraint_ratio() == 0.f);      // Ignored by the PointCloud policy
+        CHECK(features(TriangulationPolicy::CDT, 100, 50).constraint_ratio() == 0.5f);
+        CHECK(features(TriangulationPolicy::CDT, 0, 0).constraint_ratio() == 0.f);
+    }
+    SECTION("Heavily constrained input")
+    {
+        CHECK(select_impl_name<double, index>(features(TriangulationPolicy::CDT, 1000000, 500000), empty_profile) == rule_or_reference("CDT_fp64"));
+        CHECK(select_impl_name<double, index>(features(TriangulationPolicy::CDT, 1000000, 1000), empty_profile) == reference_name());
+    }
+    SECTION("Small point cloud")
+    {
+        CHECK(select_impl_name<double, index>(features(TriangulationPolicy::PointCloud, 2048), empty_profile) == rule_or_reference("CDT_spec"));
+        CHECK(select_impl_name<double, index>(features(TriangulationPolicy::PointCloud, 2049), empty_profile) == reference_name());
+    }
+}
+
+TEST_CASE("Automatic selection: Profile", "[dt]")
+{
+    const auto& impls = registered_impls();
+    REQUIRE(!impls.empty());
+    const std::string& first = impls.front().name;
+    const std::string& last = impls.back().name;
+    const auto small_pc = features(TriangulationPolicy::PointCloud, 1000);
+    const auto large_pc = features(TriangulationPolicy::PointCloud, 1000000);
+
+    SECTION("Closest profiled input")
+    {
+        SelectionProfile profile;
+        profile.measurements.push_back(measurement(first, TriangulationPolicy::PointCloud, 1024, 0, 2.f));
+        profile.measurements.push_back(measurement(last, TriangulationPolicy::PointCloud, 1 << 20, 0, 500.f));
+        CHECK(select_impl_name<double, index>(small_pc, profile) == first);
+        CHECK(select_impl_name<double, index>(large_pc, profile) == last);
+    }
+    SECTION("Fastest implementation at the same distance")
+    {
+        SelectionProfile profile;
+        profile.measurements.push_back(measurement(first, TriangulationPolicy::PointCloud, 1024, 0, 3.f));
+        profile.measurements.push_back(measurement(last, TriangulationPolicy::PointCloud, 1024, 0, 2.f));
+        CHECK(select_impl_name<double, index>(small_pc, profile) == last);
+    }
+    SECTION("The implementations that are not registered are ignored")
+    {
+        SelectionProfile profile;
+        profile.measurements.push_back(measurement(first, TriangulationPolicy::PointCloud, 1 << 20, 0, 500.f));
+        profile.measurements.push_back(measurement("Unregistered", TriangulationPolicy::PointCloud, 1024, 0, 1.f));
+        CHECK(select_impl_name<double, index>(small_pc, profile) == first);
+    }
+    SECTION("No measurement for the policy: Fall back to the rules, then the reference")
+    {
+        SelectionProfile profile;
+        profile.measurements.push_back(measurement(first, TriangulationPolicy::CDT, 1024, 512, 1.f));
+        profile.measurements.push_back(measurement("Unregistered", TriangulationPolicy::PointCloud, 1024, 0, 1.f));
+        CHECK(select_impl_name<double, index>(small_pc, profile) == rule_or_reference("CDT_spec"));
+        CHECK(select_impl_name<double, index>(large_pc, profile) == reference_name());
+    }
+    SECTION("Default profile")
+    {
+        SelectionProfile profile;
+        profile.measurements.push_back(measurement(last, TriangulationPolicy::PointCloud, 1024, 0, 1.f));
+        set_default_selection_profile(profile);
+        CHECK(select_impl_name<double, index>(small_pc) == last);
+        const auto [name, algo] = get_auto_impl<double, index>(small_pc, &no_error_handler());
+        CHECK(name == last);
+        CHECK(algo != nullptr);
+        set_default_selection_profile(SelectionProfile());
+        CHECK(select_impl_name<double, index>(small_pc) == rule_or_reference("CDT_spec"));
+    }
+}
+
+} // namespace test
+} // namespace delaunay
@@ -0,0 +1,93 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include "triangulation_helpers.h"
+
+#include <dt/batch_triangulation.h>
+#include <graphs/index.h>
+#include <shapes/generators.h>
+#include <shapes/path.h>
+#include <shapes/point.h>
+#include <stdutils/parallel.h>
+#include <stdutils/span.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace delaunay {
+namespace test {
+
+namespace {
+
+shapes::Triangles2d<double, index> triangulate_group(const RegisteredImpl<double, index>& impl, const PolygonGroup<double>& group, TriangulationPolicy policy)
+{
+    auto algo = get_impl(impl, &no_error_handler());
+    REQUIRE(algo);
+    algo->add_path(group.boundary);
+    for (const auto& hole : group.holes) { algo->add_hole(hole); }
+    if (!group.steiner.empty()) { algo->add_steiner(stdutils::make_const_span(group.steiner)); }
+    return algo->triangulate(policy);
+}
+
+} // namespace
+
+TEST_CASE("Batch triangulation of independent polygons", "[dt]")
+{
+    std::vector<PolygonGroup<double>> groups(4);
+    groups[0].boundary = shapes::generators::random_polygon<double>(10, 1);
+    groups[1].boundary = shapes::generators::random_polygon<double>(50, 2);
+    // groups[2] has an empty boundary: It is skipped
+    groups[3].boundary = shapes::generators::random_polygon<double>(3, 3);
+    groups[1].steiner = { { 0.5, 0.5 } };                          // The polygon is star-shaped around that point
+
+    for (const auto policy : { TriangulationPolicy::PointCloud, TriangulationPolicy::CDT })
+    {
+        CAPTURE(policy_name(policy));
+        for (const auto& impl : registered_impls())
+        {
+            if (!supports(impl, policy)) { continue; }
+            CAPTURE(impl.name);
+            for (const unsigned int nb_threads : { 1u, 4u })
+            {
+                CAPTURE(nb_threads);
+                const stdutils::parallel::Policy parallel_policy{ nb_threads, 1 };
+                const auto result = triangulate_batch(impl, groups, policy, no_error_handler(), parallel_policy);
+                CHECK(shapes::is_valid(result));
+
+                // Same as the triangulations of the groups on their own, offset by the previous ones
+                std::size_t vertex_offset = 0;
+                std::size_t face_offset = 0;
+                bool has_adjacency = true;
+                for (const auto& group : groups)
+                {
+                    if (group.boundary.vertices.empty()) { continue; }
+                    const auto triangles = triangulate_group(impl, group, policy);
+                    REQUIRE(!triangles.faces.empty());
+                    REQUIRE(vertex_offset + triangles.vertices.size() <= result.vertices.size());
+                    REQUIRE(face_offset + triangles.faces.size() <= result.faces.size());
+                    has_adjacency &= shapes::has_adjacency(triangles);
+                    for (std::size_t idx = 0; idx < triangles.vertices.size(); idx++) { CHECK(result.vertices[vertex_offset + idx] == triangles.vertices[idx]); }
+                    for (std::size_t face_idx = 0; face_idx < triangles.faces.size(); face_idx++)
+                    {
+                        for (std::size_t k = 0; k < 3; k++)
+                        {
+                            CHECK(result.faces[face_offset + face_idx][k] == triangles.faces[face_idx][k] + vertex_offset);
+                            if (!shapes::has_adjacency(result) || !shapes::has_adjacency(triangles)) { continue; }
+                            const index adj = triangles.adjacency[face_idx][k];
+                            CHECK(result.adjacency[face_offset + face_idx][k] == (graphs::is_defined(adj) ? adj + face_offset : adj));
+                        }
+                    }
+                    vertex_offset += triangles.vertices.size();
+                    face_offset += triangles.faces.size();
+                }
+                CHECK(result.vertices.size() == vertex_offset);
+                CHECK(result.faces.size() == face_offset);
+                CHECK(shapes::has_adjacency(result) == has_adjacency);
+            }
+        }
+    }
+}
+
+} // namespace test
+} // namespace delaunay
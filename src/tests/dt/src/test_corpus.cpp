@@ -0,0 +1,168 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include "examples.h"
+#include "triangulation_helpers.h"
+
+#include <dt/dt_interface.h>
+#include <shapes/io.h>
+#include <shapes/path.h>
+#include <shapes/point_cloud.h>
+
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace delaunay {
+namespace test {
+
+namespace {
+
+const std::filesystem::path examples_folder = DT_TESTS_EXAMPLES_FOLDER;
+
+const std::vector<std::string> dat_examples = {
+    "city.dat",
+    "crocodile.dat",
+    "ermine.dat",
+    "mushroom.dat",
+    "poly2tri_dude.dat",
+    "stylized_swan.dat",
+    "two_islands.dat"
+};
+
+const std::vector<std::string> cdt_examples = {
+    "CDT-logo.cdt",
+    "Capital-A.cdt",
+    "Constrained-Sweden.cdt",
+    "bird.cdt"
+};
+
+// The paths and the point clouds of a DAT file
+Input load_dat_example(const std::string& filename)
+{
+    Input input;
+    for (auto& wrapper : shapes::io::dat::parse_shapes_from_file(examples_folder / filename, no_error_handler()))
+    {
+        if (auto* pp = std::get_if<shapes::PointPath2d<double>>(&wrapper.shape)) { input.paths.emplace_back(std::move(*pp)); }
+        else if (const auto* pc = std::get_if<shapes::PointCloud2d<double>>(&wrapper.shape)) { input.steiner.insert(input.steiner.end(), pc->vertices.cbegin(), pc->vertices.cend()); }
+    }
+    return input;
+}
+
+// The edges and the point cloud of a CDT file
+Input load_cdt_example(const std::string& filename)
+{
+    auto soup = shapes::io::cdt::parse_2d_shapes_from_file(examples_folder / filename, no_error_handler());
+    Input input;
+    input.steiner = std::move(soup.point_cloud.vertices);
+    input.edges = std::move(soup.edges);
+    return input;
+}
+
+// All the vertices of the input, as a point cloud
+Input vertices_of(const Input& input)
+{
+    Input result;
+    result.steiner = input.steiner;
+    for (const auto& pp : input.paths) { result.steiner.insert(result.steiner.end(), pp.vertices.cbegin(), pp.vertices.cend()); }
+    result.steiner.insert(result.steiner.end(), input.edges.vertices.cbegin(), input.edges.vertices.cend());
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Delaunay triangulation of the vertices of the examples", "[dt][corpus]")
+{
+    std::vector<std::string> filenames = dat_examples;
+    filenames.insert(filenames.end(), cdt_examples.cbegin(), cdt_examples.cend());
+    for (const auto& filename : filenames)
+    {
+        CAPTURE(filename);
+        const Input input = vertices_of(std::filesystem::path(filename).extension() == ".dat" ? load_dat_example(filename) : load_cdt_example(filename));
+        REQUIRE(!input.steiner.empty());
+
+        for (const auto& impl : registered_impls())
+        {
+            if (!supports(impl, TriangulationPolicy::PointCloud) || !exact_in_double(impl)) { continue; }
+            CAPTURE(impl.name);
+            const auto triangles = triangulate(impl, input, TriangulationPolicy::PointCloud);
+            CHECK(!triangles.faces.empty());
+            CHECK(validate_all(triangles, TriangulationPolicy::PointCloud).is_valid());
+        }
+    }
+}
+
+TEST_CASE("Constrained triangulation of the paths of the examples", "[dt][corpus]")
+{
+    for (const auto& filename : dat_examples)
+    {
+        CAPTURE(filename);
+        const auto example = load_dat_example(filename);
+
+        // Each closed path on its own: Not all the examples are a domain with holes (e.g. two_islands.dat)
+        for (const auto& pp : example.paths)
+        {
+            if (!pp.closed) { continue; }
+            Input input;
+            input.paths.push_back(pp);
+            for (const auto& impl : registered_impls())
+            {
+                if (!supports(impl, TriangulationPolicy::CDT)) { continue; }
+                CAPTURE(impl.name);
+                const auto triangles = triangulate(impl, input, TriangulationPolicy::CDT);
+                CHECK(!triangles.faces.empty());
+                CHECK(validate_all(triangles, TriangulationPolicy::CDT).is_valid());
+            }
+        }
+    }
+}
+
+TEST_CASE("Constrained triangulation of the edge soups of the examples", "[dt][corpus]")
+{
+    for (const auto& filename : cdt_examples)
+    {
+        CAPTURE(filename);
+        Input input;
+        input.edges = load_cdt_example(filename).edges;
+        if (input.edges.indices.empty()) { continue; }             // A point cloud, e.g. bird.cdt
+
+        for (const auto& impl : registered_impls())
+        {
+            if (!supports(impl, TriangulationPolicy::CDT)) { continue; }
+            CAPTURE(impl.name);
+            const auto triangles = triangulate(impl, input, TriangulationPolicy::CDT);
+            CHECK(!triangles.faces.empty());
+            CHECK(validate_all(triangles, TriangulationPolicy::CDT).is_valid());
+        }
+    }
+}
+
+TEST_CASE("Benchmark the triangulations of the examples", "[dt][corpus][benchmark]")
+{
+    const auto city = load_dat_example("city.dat");
+    const auto city_vertices = vertices_of(city);
+
+    for (const auto& impl : registered_impls())
+    {
+        if (supports(impl, TriangulationPolicy::PointCloud))
+        {
+            BENCHMARK(impl.name + " - " + std::string(policy_name(TriangulationPolicy::PointCloud)) + " - city.dat")
+            {
+                return triangulate(impl, city_vertices, TriangulationPolicy::PointCloud);
+            };
+        }
+        if (supports(impl, TriangulationPolicy::CDT))
+        {
+            BENCHMARK(impl.name + " - " + std::string(policy_name(TriangulationPolicy::CDT)) + " - city.dat")
+            {
+                return triangulate(impl, city, TriangulationPolicy::CDT);
+            };
+        }
+    }
+}
+
+} // namespace test
+} // namespace delaunay
@@ -0,0 +1,121 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include "triangulation_helpers.h"
+
+#include <dt/batch_triangulation.h>
+#include <dt/deduplication.h>
+#include <graphs/graph.h>
+#include <shapes/edge.h>
+#include <shapes/path.h>
+#include <shapes/point.h>
+#include <stdutils/parallel.h>
+#include <stdutils/span.h>
+
+#include <vector>
+
+namespace delaunay {
+namespace test {
+
+namespace {
+
+using P = shapes::Point2d<double>;
+
+shapes::PointPath2d<double> point_path(const std::vector<P>& vertices, bool closed)
+{
+    shapes::PointPath2d<double> result;
+    result.vertices = vertices;
+    result.closed = closed;
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Deduplication of a point cloud", "[dt]")
+{
+    for (const auto& policy : { stdutils::parallel::Policy{ 1, 1 }, stdutils::parallel::Policy{ 4, 1 } })
+    {
+        CAPTURE(policy.nb_threads);
+        SECTION("Exact duplicates")
+        {
+            const std::vector<P> points = { P(1.0, 2.0), P(0.0, 0.0), P(1.0, 2.0), P(-0.0, 0.0), P(3.0, 1.0), P(0.0, -0.0) };
+            const auto dedup = deduplicate_points<double, index>(policy, stdutils::make_const_span(points));
+            CHECK(dedup.points == std::vector<P>({ P(1.0, 2.0), P(0.0, 0.0), P(3.0, 1.0) }));       // Order of the first occurrence
+            CHECK(dedup.remap == std::vector<index>({ 0, 1, 0, 1, 2, 1 }));
+        }
+        SECTION("Snapping to a grid")
+        {
+            const std::vector<P> points = { P(0.11, 0.12), P(0.19, 0.14), P(0.21, 0.12), P(0.11, 0.12) };
+            const auto dedup = deduplicate_points<double, index>(policy, stdutils::make_const_span(points), 0.1);
+            CHECK(dedup.points == std::vector<P>({ P(0.11, 0.12), P(0.21, 0.12) }));               // Not snapped
+            CHECK(dedup.remap == std::vector<index>({ 0, 0, 1, 0 }));
+        }
+        SECTION("Empty input")
+        {
+            const auto dedup = deduplicate_points<double, index>(policy, stdutils::Span<const P>());
+            CHECK(dedup.points.empty());
+            CHECK(dedup.remap.empty());
+        }
+    }
+}
+
+TEST_CASE("Deduplication of an edge soup", "[dt]")
+{
+    const stdutils::parallel::Policy policy{ 1, 1 };
+    shapes::Edges2d<double, index> edges;
+    edges.vertices = { P(0.0, 0.0), P(1.0, 0.0), P(1.0, 1.0), P(1.0, 0.0), P(0.0, 0.0) };
+    edges.indices = { { 0, 1 }, { 3, 2 }, { 2, 4 }, { 1, 3 }, { 4, 3 } };       // Edge { 1, 3 } is a loop, { 4, 3 } duplicates { 0, 1 }
+    const auto result = deduplicate(policy, edges);
+    CHECK(result.vertices == std::vector<P>({ P(0.0, 0.0), P(1.0, 0.0), P(1.0, 1.0) }));
+    CHECK(result.indices == graphs::EdgeSoup<index>({ { 0, 1 }, { 0, 2 }, { 1, 2 } }));
+    CHECK(shapes::is_valid(result));
+}
+
+TEST_CASE("Deduplication of a polygon group", "[dt]")
+{
+    const stdutils::parallel::Policy policy{ 1, 1 };
+    SECTION("Duplicates along the paths and Steiner points")
+    {
+        PolygonGroup<double> group;
+        group.boundary = point_path({ P(0.0, 0.0), P(0.0, 0.0), P(4.0, 0.0), P(4.0, 4.0), P(0.0, 4.0), P(0.0, 0.0) }, true);
+        group.holes.push_back(point_path({ P(1.0, 1.0), P(2.0, 1.0), P(2.0, 1.0), P(2.0, 2.0) }, true));
+        group.steiner = { P(4.0, 4.0), P(3.0, 3.0), P(3.0, 3.0), P(2.0, 1.0) };
+        const auto result = deduplicate(policy, group);
+        CHECK(result.boundary.closed);
+        CHECK(result.boundary.vertices == std::vector<P>({ P(0.0, 0.0), P(4.0, 0.0), P(4.0, 4.0), P(0.0, 4.0) }));
+        REQUIRE(result.holes.size() == 1);
+        CHECK(result.holes[0].closed);
+        CHECK(result.holes[0].vertices == std::vector<P>({ P(1.0, 1.0), P(2.0, 1.0), P(2.0, 2.0) }));
+        CHECK(result.steiner == std::vector<P>({ P(3.0, 3.0) }));
+    }
+    SECTION("Degenerate holes")
+    {
+        PolygonGroup<double> group;
+        group.boundary = point_path({ P(0.0, 0.0), P(4.0, 0.0), P(4.0, 4.0), P(0.0, 4.0) }, true);
+        group.holes.push_back(point_path({ P(1.0, 1.0), P(1.0, 1.0), P(1.0, 1.0) }, true));          // Reduced to a point: Removed
+        group.holes.push_back(point_path({ P(2.0, 2.0), P(3.0, 2.0), P(3.0, 2.0), P(2.0, 2.0) }, true));  // Reduced to a segment: Open
+        group.holes.push_back(point_path({ P(1.0, 3.0) }, false));
+        group.steiner = { P(1.0, 1.0), P(1.0, 3.0) };       // The vertices of the removed holes are kept as Steiner points
+        const auto result = deduplicate(policy, group);
+        CHECK(result.boundary.vertices.size() == 4);
+        REQUIRE(result.holes.size() == 1);
+        CHECK(!result.holes[0].closed);
+        CHECK(result.holes[0].vertices == std::vector<P>({ P(2.0, 2.0), P(3.0, 2.0) }));
+        CHECK(result.steiner == std::vector<P>({ P(1.0, 1.0), P(1.0, 3.0) }));
+    }
+    SECTION("Boundary reduced to a point")
+    {
+        PolygonGroup<double> group;
+        group.boundary = point_path({ P(1.0, 1.0), P(1.0, 1.0), P(1.0, 1.0) }, true);
+        group.holes.push_back(point_path({ P(0.0, 0.0), P(1.0, 0.0) }, false));
+        group.steiner = { P(1.0, 1.0) };
+        const auto result = deduplicate(policy, group);
+        CHECK(result.boundary.vertices.empty());            // Then the group is skipped by triangulate_batch
+        CHECK(result.holes.size() == 1);
+        CHECK(result.steiner == std::vector<P>({ P(1.0, 1.0) }));
+    }
+}
+
+} // namespace test
+} // namespace delaunay
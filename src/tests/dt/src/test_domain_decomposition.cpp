@@ -0,0 +1,103 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include "triangulation_helpers.h"
+
+#include <dt/domain_decomposition.h>
+#include <shapes/path.h>
+#include <shapes/point.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace delaunay {
+namespace test {
+
+namespace {
+
+shapes::PointPath2d<double> square(double min_x, double min_y, double size)
+{
+    shapes::PointPath2d<double> pp;
+    pp.closed = true;
+    pp.vertices = { { min_x, min_y }, { min_x + size, min_y }, { min_x + size, min_y + size }, { min_x, min_y + size } };
+    return pp;
+}
+
+// A square with a hole, an island in the hole, and a separate island
+std::vector<shapes::PointPath2d<double>> nested_paths()
+{
+    return { square(0.0, 0.0, 10.0), square(2.0, 2.0, 6.0), square(4.0, 4.0, 2.0), square(20.0, 0.0, 10.0) };
+}
+
+} // namespace
+
+TEST_CASE("Domain decomposition of nested islands and holes", "[dt]")
+{
+    auto paths = nested_paths();
+    shapes::PointPath2d<double> open_path;
+    open_path.vertices = { { 1.0, 5.0 }, { 1.0, 6.0 } };
+    paths.push_back(open_path);
+    const shapes::Points2d<double> steiner_points = {
+        { 1.0, 1.0 },           // Between the outer boundary and its hole
+        { 3.0, 3.0 },           // In the hole: Dropped
+        { 5.0, 5.0 },           // In the island inside the hole
+        { 15.0, 5.0 },          // Outside of the domain: Dropped
+        { 25.0, 5.0 }           // In the separate island
+    };
+
+    std::size_t nb_errors = 0;
+    const auto groups = decompose_domain(paths, steiner_points, error_counter(nb_errors));
+    CHECK(nb_errors == 0);
+    REQUIRE(groups.size() == 3);
+
+    CHECK(groups[0].boundary.vertices == paths[0].vertices);
+    REQUIRE(groups[0].holes.size() == 2);
+    CHECK(groups[0].holes[0].vertices == paths[1].vertices);
+    CHECK(groups[0].holes[1].vertices == open_path.vertices);
+    CHECK(groups[0].steiner == shapes::Points2d<double>{ steiner_points[0] });
+
+    CHECK(groups[1].boundary.vertices == paths[2].vertices);
+    CHECK(groups[1].holes.empty());
+    CHECK(groups[1].steiner == shapes::Points2d<double>{ steiner_points[2] });
+
+    CHECK(groups[2].boundary.vertices == paths[3].vertices);
+    CHECK(groups[2].holes.empty());
+    CHECK(groups[2].steiner == shapes::Points2d<double>{ steiner_points[4] });
+}
+
+TEST_CASE("Domain decomposition of closed paths crossing each other", "[dt]")
+{
+    // The second square crosses the first one. The triangle is inside of the second square only: It is at an odd depth (a hole) but its
+    // parent, the second square, is also at an odd depth.
+    shapes::PointPath2d<double> triangle;
+    triangle.closed = true;
+    triangle.vertices = { { 12.0, 5.0 }, { 13.0, 5.0 }, { 12.0, 6.0 } };
+    const std::vector<shapes::PointPath2d<double>> paths = { square(0.0, 0.0, 10.0), square(5.0, 1.0, 8.0), triangle };
+
+    std::size_t nb_errors = 0;
+    const auto groups = decompose_domain(paths, shapes::Points2d<double>(), error_counter(nb_errors));
+    CHECK(nb_errors == 1);
+    CHECK(groups.empty());
+}
+
+TEST_CASE("Constrained triangulation of a decomposed domain", "[dt]")
+{
+    const auto paths = nested_paths();
+    const shapes::Points2d<double> steiner_points = { { 1.0, 1.0 }, { 3.0, 3.0 }, { 5.0, 5.0 }, { 25.0, 5.0 } };
+
+    // Faces of a polygon with n vertices, h holes and s Steiner points inside: n + 2s + 2h - 2
+    constexpr std::size_t expected_nb_faces = (8 + 2 + 2 - 2) + (4 + 2 - 2) + (4 + 2 - 2);
+    for (const auto& impl : registered_impls())
+    {
+        if (!supports(impl, TriangulationPolicy::CDT)) { continue; }
+        CAPTURE(impl.name);
+        const auto triangles = triangulate_decomposed_domain(impl, paths, steiner_points, no_error_handler());
+        CHECK(triangles.vertices.size() == 8 + 1 + 4 + 1 + 4 + 1);
+        CHECK(triangles.faces.size() == expected_nb_faces);
+        CHECK(validate_all(triangles, TriangulationPolicy::CDT).is_valid());
+    }
+}
+
+} // namespace test
+} // namespace delaunay
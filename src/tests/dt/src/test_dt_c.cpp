@@ -0,0 +1,170 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <dt/dt_c.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace delaunay {
+namespace test {
+
+namespace {
+
+using Handle = std::unique_ptr<dt_triangulation, decltype(&dt_destroy)>;
+
+Handle create_handle()
+{
+    REQUIRE(dt_register_all_implementations() != 0);
+    REQUIRE(dt_nb_implementations() > 0);
+    Handle handle(dt_create(nullptr), &dt_destroy);
+    REQUIRE(handle != nullptr);
+    return handle;
+}
+
+// Four points on the convex hull and one inside, not cocircular: 4 faces
+const std::vector<double> xy = { 0.0, 0.0, 2.0, 0.0, 2.1, 1.9, 0.0, 2.0, 1.0, 0.9 };
+constexpr std::size_t nb_vertices = 5;
+constexpr std::size_t nb_faces = 4;
+
+struct StridedVertex
+{
+    double x;
+    double y;
+    double z;
+};
+
+} // namespace
+
+TEST_CASE("C interface: Size query, then copy", "[dt]")
+{
+    auto handle = create_handle();
+    REQUIRE(dt_add_steiner(handle.get(), xy.data(), nb_vertices, 0) == DT_OK);
+    REQUIRE(dt_triangulate(handle.get(), DT_POLICY_POINT_CLOUD) == DT_OK);
+
+    std::size_t size = 0;
+    CHECK(dt_get_faces(handle.get(), nullptr, 0, &size) == DT_OK);
+    CHECK(size == nb_faces);
+    std::vector<std::uint32_t> faces(3 * size, 0);
+    CHECK(dt_get_faces(handle.get(), faces.data(), size, &size) == DT_OK);
+    CHECK(size == nb_faces);
+    for (const auto idx : faces) { CHECK(idx < nb_vertices); }
+
+    CHECK(dt_get_vertices(handle.get(), nullptr, 0, 0, &size) == DT_OK);
+    CHECK(size == nb_vertices);
+    std::vector<double> out_xy(2 * size, 0.0);
+    CHECK(dt_get_vertices(handle.get(), out_xy.data(), size, 0, &size) == DT_OK);
+    CHECK(out_xy == xy);
+}
+
+TEST_CASE("C interface: Buffer too small", "[dt]")
+{
+    auto handle = create_handle();
+    REQUIRE(dt_add_steiner(handle.get(), xy.data(), nb_vertices, 0) == DT_OK);
+    REQUIRE(dt_triangulate(handle.get(), DT_POLICY_POINT_CLOUD) == DT_OK);
+
+    std::size_t size = 0;
+    std::vector<std::uint32_t> faces(3 * nb_faces, 42);
+    CHECK(dt_get_faces(handle.get(), faces.data(), nb_faces - 1, &size) == DT_BUFFER_TOO_SMALL);
+    CHECK(size == nb_faces);
+    CHECK(faces == std::vector<std::uint32_t>(3 * nb_faces, 42));     // Nothing is copied
+    std::vector<double> out_xy(2 * nb_vertices, -1.0);
+    CHECK(dt_get_vertices(handle.get(), out_xy.data(), nb_vertices - 1, 0, &size) == DT_BUFFER_TOO_SMALL);
+    CHECK(size == nb_vertices);
+    CHECK(out_xy == std::vector<double>(2 * nb_vertices, -1.0));
+}
+
+TEST_CASE("C interface: Strided and misaligned input, strided output", "[dt]")
+{
+    std::vector<StridedVertex> strided;
+    for (std::size_t idx = 0; idx < nb_vertices; idx++) { strided.push_back({ xy[2 * idx], xy[2 * idx + 1], -1.0 }); }
+    std::vector<unsigned char> misaligned(xy.size() * sizeof(double) + 1);
+    std::memcpy(misaligned.data() + 1, xy.data(), xy.size() * sizeof(double));
+
+    for (const bool is_strided : { true, false })
+    {
+        CAPTURE(is_strided);
+        auto handle = create_handle();
+        if (is_strided)
+        {
+            REQUIRE(dt_add_steiner(handle.get(), &strided.front().x, nb_vertices, sizeof(StridedVertex)) == DT_OK);
+        }
+        else
+        {
+            // Tightly packed, but not aligned as a double
+            REQUIRE(dt_add_steiner(handle.get(), reinterpret_cast<const double*>(misaligned.data() + 1), nb_vertices, 0) == DT_OK);
+        }
+        REQUIRE(dt_triangulate(handle.get(), DT_POLICY_POINT_CLOUD) == DT_OK);
+
+        std::size_t size = 0;
+        std::vector<StridedVertex> out(nb_vertices, StridedVertex{ 0.0, 0.0, 7.0 });
+        CHECK(dt_get_vertices(handle.get(), &out.front().x, nb_vertices, sizeof(StridedVertex), &size) == DT_OK);
+        REQUIRE(size == nb_vertices);
+        for (std::size_t idx = 0; idx < nb_vertices; idx++)
+        {
+            CHECK(out[idx].x == xy[2 * idx]);
+            CHECK(out[idx].y == xy[2 * idx + 1]);
+            CHECK(out[idx].z == 7.0);               // Not overwritten
+        }
+    }
+}
+
+TEST_CASE("C interface: Clear and reuse the handle", "[dt]")
+{
+    auto handle = create_handle();
+    REQUIRE(dt_add_steiner(handle.get(), xy.data(), nb_vertices, 0) == DT_OK);
+    REQUIRE(dt_triangulate(handle.get(), DT_POLICY_POINT_CLOUD) == DT_OK);
+    CHECK(dt_clear(handle.get()) == DT_OK);
+
+    std::size_t size = 42;
+    CHECK(dt_get_faces(handle.get(), nullptr, 0, &size) == DT_NO_RESULT);
+    CHECK(size == 0);
+
+    // A single triangle
+    REQUIRE(dt_add_steiner(handle.get(), xy.data(), 3, 0) == DT_OK);
+    REQUIRE(dt_triangulate(handle.get(), DT_POLICY_POINT_CLOUD) == DT_OK);
+    CHECK(dt_get_faces(handle.get(), nullptr, 0, &size) == DT_OK);
+    CHECK(size == 1);
+    CHECK(dt_get_vertices(handle.get(), nullptr, 0, 0, &size) == DT_OK);
+    CHECK(size == 3);
+
+    // The next input clears the result of the previous triangulation
+    REQUIRE(dt_add_steiner(handle.get(), xy.data(), nb_vertices, 0) == DT_OK);
+    CHECK(dt_get_faces(handle.get(), nullptr, 0, &size) == DT_NO_RESULT);
+    REQUIRE(dt_triangulate(handle.get(), DT_POLICY_POINT_CLOUD) == DT_OK);
+    CHECK(dt_get_faces(handle.get(), nullptr, 0, &size) == DT_OK);
+    CHECK(size == nb_faces);
+}
+
+TEST_CASE("C interface: Errors", "[dt]")
+{
+    auto handle = create_handle();
+    CHECK(std::string(dt_last_error(handle.get())).empty());
+
+    CHECK(dt_add_steiner(handle.get(), xy.data(), nb_vertices, sizeof(double)) == DT_INVALID_ARGUMENT);
+    CHECK(!std::string(dt_last_error(handle.get())).empty());
+    CHECK(dt_add_steiner(handle.get(), nullptr, nb_vertices, 0) == DT_INVALID_ARGUMENT);
+    CHECK(!std::string(dt_last_error(handle.get())).empty());
+
+    // No vertices: The pointer may be null
+    CHECK(dt_add_steiner(handle.get(), nullptr, 0, 0) == DT_OK);
+    CHECK(dt_add_path(handle.get(), nullptr, 0, 0, 0) == DT_OK);
+    CHECK(std::string(dt_last_error(handle.get())).empty());
+
+    // A successful call resets the error
+    CHECK(dt_add_steiner(handle.get(), xy.data(), nb_vertices, 0) == DT_OK);
+    CHECK(std::string(dt_last_error(handle.get())).empty());
+
+    std::size_t size = 0;
+    CHECK(dt_get_faces(handle.get(), nullptr, 0, &size) == DT_NO_RESULT);
+    CHECK(dt_get_faces(nullptr, nullptr, 0, &size) == DT_INVALID_ARGUMENT);
+    CHECK(dt_create("Unknown implementation") == nullptr);
+}
+
+} // namespace test
+} // namespace delaunay
@@ -0,0 +1,129 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include "triangulation_helpers.h"
+
+#include <dt/dt_interface.h>
+#include <dt/streaming.h>
+#include <graphs/graph.h>
+#include <shapes/convex_hull.h>
+#include <shapes/generators.h>
+#include <stdutils/span.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace delaunay {
+namespace test {
+
+namespace {
+
+// Rotate each face so that its smallest index comes first, keeping the orientation, then sort the faces
+std::vector<std::array<index, 3>> normalized_faces(const graphs::TriangleSoup<index>& faces)
+{
+    std::vector<std::array<index, 3>> result;
+    result.reserve(faces.size());
+    for (const auto& face : faces)
+    {
+        std::array<index, 3> tri = { face[0], face[1], face[2] };
+        std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+        result.push_back(tri);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<shapes::Point2d<double>> sorted_uniform_point_cloud(std::size_t nb_points, std::uint32_t seed)
+{
+    auto points = shapes::generators::uniform_point_cloud<double>(nb_points, seed).vertices;
+    std::sort(points.begin(), points.end(), [](const auto& a, const auto& b) { return a.x < b.x; });
+    return points;
+}
+
+} // namespace
+
+TEST_CASE("Streaming triangulation of a sorted point cloud", "[dt]")
+{
+    constexpr std::size_t nb_points = 20000;
+    constexpr std::size_t chunk_size = 500;
+    const auto points = sorted_uniform_point_cloud(nb_points, 42);
+    const std::size_t nb_hull_vertices = shapes::convex_hull(stdutils::make_const_span(points)).vertices.size();
+
+    graphs::TriangleSoup<index> faces;
+    const FaceSink<index> sink = [&faces](stdutils::Span<const graphs::Triangle<index>> emitted) { faces.insert(faces.end(), emitted.begin(), emitted.end()); };
+    StreamingTriangulation<double, index> triangulation(sink, &no_error_handler());
+    std::size_t max_active_vertices = 0;
+    for (std::size_t begin_idx = 0; begin_idx < nb_points; begin_idx += chunk_size)
+    {
+        const std::size_t end_idx = std::min(begin_idx + chunk_size, nb_points);
+        const double front = end_idx < nb_points ? points[end_idx].x : points.back().x;
+        REQUIRE(triangulation.add_chunk(stdutils::Span<const shapes::Point2d<double>>(points.data() + begin_idx, end_idx - begin_idx), front));
+        max_active_vertices = std::max(max_active_vertices, triangulation.nb_active_vertices());
+    }
+    triangulation.finish();
+
+    SECTION("Face count")
+    {
+        CHECK(triangulation.nb_received_points() == nb_points);
+        CHECK(triangulation.nb_duplicates() == 0);
+        CHECK(triangulation.nb_emitted_faces() == faces.size());
+        CHECK(faces.size() == 2 * nb_points - nb_hull_vertices - 2);
+    }
+    SECTION("Same faces as the other implementations")
+    {
+        // The points are in general position, therefore the Delaunay triangulation is unique
+        const auto streamed_faces = normalized_faces(faces);
+        Input input;
+        input.steiner = points;
+        for (const auto& impl : registered_impls())
+        {
+            if (!supports(impl, TriangulationPolicy::PointCloud) || !exact_in_double(impl)) { continue; }
+            CAPTURE(impl.name);
+            const auto triangles = triangulate(impl, input, TriangulationPolicy::PointCloud);
+            REQUIRE(triangles.vertices.size() == nb_points);
+            CHECK(normalized_faces(triangles.faces) == streamed_faces);
+        }
+    }
+    SECTION("Bounded number of active vertices")
+    {
+        // Only the vertices near the front, and those of the convex hull, are kept in memory: For a uniform point cloud, that is less than
+        // a chunk of points, whatever the size of the input.
+        CHECK(max_active_vertices < 2 * chunk_size);
+        CHECK(triangulation.nb_active_vertices() == 0);
+    }
+}
+
+TEST_CASE("Streaming triangulation with duplicated points", "[dt]")
+{
+    constexpr std::size_t nb_points = 1000;
+    const auto points = sorted_uniform_point_cloud(nb_points, 7);
+    std::vector<shapes::Point2d<double>> input;
+    for (const auto& p : points)
+    {
+        input.push_back(p);
+        input.push_back(p);
+    }
+
+    graphs::TriangleSoup<index> faces;
+    const FaceSink<index> sink = [&faces](stdutils::Span<const graphs::Triangle<index>> emitted) { faces.insert(faces.end(), emitted.begin(), emitted.end()); };
+    REQUIRE(triangulate_streaming<double, index>(stdutils::make_const_span(input), 128, sink, &no_error_handler()));
+    const std::size_t nb_hull_vertices = shapes::convex_hull(stdutils::make_const_span(points)).vertices.size();
+    CHECK(faces.size() == 2 * nb_points - nb_hull_vertices - 2);
+    // Exactly one occurrence of each point is referenced by the faces
+    std::vector<bool> is_referenced(input.size(), false);
+    for (const auto& face : faces)
+        for (std::size_t k = 0; k < 3; k++)
+            is_referenced[face[k]] = true;
+    std::size_t nb_referenced_pairs = 0;
+    for (std::size_t idx = 0; idx < nb_points; idx++)
+    {
+        if (is_referenced[2 * idx] != is_referenced[2 * idx + 1]) { nb_referenced_pairs++; }
+    }
+    CHECK(nb_referenced_pairs == nb_points);
+}
+
+} // namespace test
+} // namespace delaunay
@@ -0,0 +1,120 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include "triangulation_helpers.h"
+
+#include <dt/dt_interface.h>
+#include <dt/tiling.h>
+#include <shapes/bounding_box.h>
+#include <shapes/generators.h>
+#include <shapes/point.h>
+#include <shapes/triangle.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace delaunay {
+namespace test {
+
+namespace {
+
+using Face = std::array<shapes::Point2d<double>, 3>;
+
+// The faces by the coordinates of their vertices, independently of the order of the vertices of the triangulation
+std::vector<Face> sorted_faces(const shapes::Triangles2d<double, index>& triangles)
+{
+    const shapes::less<shapes::Point2d<double>> less;
+    std::vector<Face> result;
+    result.reserve(triangles.faces.size());
+    for (const auto& face : triangles.faces)
+    {
+        Face f = { triangles.vertices[face[0]], triangles.vertices[face[1]], triangles.vertices[face[2]] };
+        std::sort(f.begin(), f.end(), less);
+        result.push_back(f);
+    }
+    std::sort(result.begin(), result.end(), [&less](const Face& lhs, const Face& rhs) { return std::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend(), less); });
+    return result;
+}
+
+shapes::BoundingBox2d<double> bounding_box(const std::vector<shapes::Point2d<double>>& points)
+{
+    shapes::BoundingBox2d<double> result;
+    for (const auto& p : points) { result.add(p); }
+    return result;
+}
+
+std::vector<shapes::Triangles2d<double, index>> triangulate_tiles(const RegisteredImpl<double, index>& impl, const std::vector<TilePoints<double>>& tiles)
+{
+    std::vector<shapes::Triangles2d<double, index>> result;
+    for (const auto& tile : tiles)
+    {
+        Input input;
+        input.steiner = tile.core;
+        input.steiner.insert(input.steiner.end(), tile.halo.cbegin(), tile.halo.cend());
+        result.push_back(input.steiner.size() >= 3 ? triangulate(impl, input, TriangulationPolicy::PointCloud) : shapes::Triangles2d<double, index>());
+    }
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Split a point cloud in tiles", "[dt][tiling]")
+{
+    const auto points = shapes::generators::uniform_point_cloud<double>(1000, 42).vertices;
+    const auto layout = make_tile_layout(bounding_box(points), 4u, 3u, 0.2);
+    REQUIRE(layout.nb_tiles() == 12);
+    CHECK(layout.halo > 0.0);
+    const auto tiles = split_in_tiles(layout, points);
+    REQUIRE(tiles.size() == 12);
+    std::size_t nb_core_points = 0;
+    for (std::size_t tile_idx = 0; tile_idx < tiles.size(); tile_idx++)
+    {
+        CAPTURE(tile_idx);
+        const auto core = layout.core(tile_idx);
+        const auto extended = layout.extended(tile_idx);
+        nb_core_points += tiles[tile_idx].core.size();
+        CHECK(!tiles[tile_idx].halo.empty());
+        CHECK(std::all_of(tiles[tile_idx].core.cbegin(), tiles[tile_idx].core.cend(), [&](const auto& p) { return layout.tile_of(p) == tile_idx && core.rx.min <= p.x && p.x <= core.rx.max; }));
+        CHECK(std::all_of(tiles[tile_idx].halo.cbegin(), tiles[tile_idx].halo.cend(), [&](const auto& p) { return layout.tile_of(p) != tile_idx && extended.rx.min <= p.x && p.x <= extended.rx.max; }));
+    }
+    CHECK(nb_core_points == points.size());
+}
+
+TEST_CASE("The merge of the tiles is the Delaunay triangulation of the point cloud", "[dt][tiling]")
+{
+    Input input;
+    input.steiner = shapes::generators::uniform_point_cloud<double>(3000, 42).vertices;
+    const auto bb = bounding_box(input.steiner);
+
+    for (const auto& impl : registered_impls())
+    {
+        if (!supports(impl, TriangulationPolicy::PointCloud) || !exact_in_double(impl)) { continue; }
+        CAPTURE(impl.name);
+        const auto expected = sorted_faces(triangulate(impl, input, TriangulationPolicy::PointCloud));
+        REQUIRE(!expected.empty());
+
+        for (const double halo_ratio : { 0.25, 0.0 })
+        {
+            CAPTURE(halo_ratio);
+            const auto layout = make_tile_layout(bb, 3u, 3u, halo_ratio);
+            auto tile_triangulations = triangulate_tiles(impl, split_in_tiles(layout, input.steiner));
+
+            const auto merge = merge_tiles(impl, layout, input.steiner, tile_triangulations, no_error_handler());
+            CHECK(merge.triangles.vertices.size() == input.steiner.size());
+            CHECK(sorted_faces(merge.triangles) == expected);
+            CHECK(merge.nb_tile_faces + merge.nb_seam_faces == expected.size());
+            if (halo_ratio > 0.0) { CHECK(merge.nb_seam_faces < expected.size() / 20); }
+            else { CHECK(merge.nb_seam_faces > 0); }
+
+            // A missing tile is filled like a seam
+            tile_triangulations[4] = shapes::Triangles2d<double, index>();
+            const auto partial_merge = merge_tiles(impl, layout, input.steiner, tile_triangulations, no_error_handler());
+            CHECK(sorted_faces(partial_merge.triangles) == expected);
+        }
+    }
+}
+
+} // namespace test
+} // namespace delaunay
@@ -0,0 +1,293 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include "triangulation_helpers.h"
+
+#include <dt/dt_interface.h>
+#include <shapes/convex_hull.h>
+#include <shapes/generators.h>
+#include <shapes/point.h>
+#include <stdutils/io.h>
+#include <stdutils/span.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace delaunay {
+namespace test {
+
+TEST_CASE("Delaunay triangulation of a uniform point cloud", "[dt]")
+{
+    constexpr std::size_t nb_points = 1000;
+    Input input;
+    input.steiner = shapes::generators::uniform_point_cloud<double>(nb_points, 42).vertices;
+    const std::size_t nb_hull_vertices = shapes::convex_hull(stdutils::make_const_span(input.steiner)).vertices.size();
+
+    for (const auto& impl : registered_impls())
+    {
+        if (!supports(impl, TriangulationPolicy::PointCloud)) { continue; }
+        CAPTURE(impl.name);
+        const auto triangles = triangulate(impl, input, TriangulationPolicy::PointCloud);
+        CHECK(triangles.vertices.size() == nb_points);
+        CHECK(triangles.faces.size() == 2 * nb_points - nb_hull_vertices - 2);
+        const auto report = validate_all(triangles, TriangulationPolicy::PointCloud);
+        CHECK(report.nb_out_of_bounds == 0);
+        CHECK(report.nb_degenerate == 0);
+        CHECK(report.nb_flipped == 0);
+        CHECK(report.nb_adjacency_errors == 0);
+        if (exact_in_double(impl)) { CHECK(report.nb_non_delaunay == 0); }
+    }
+}
+
+TEST_CASE("Delaunay triangulation of a large point cloud with a cancellation token", "[dt]")
+{
+    // More points than fit in a batch of 2^16 vertices. Sorted, so that the first points do not span the bounding box of the input.
+    constexpr std::size_t nb_points = 100000;
+    Input input;
+    input.steiner = shapes::generators::uniform_point_cloud<double>(nb_points, 7).vertices;
+    std::sort(input.steiner.begin(), input.steiner.end(), [](const auto& a, const auto& b) { return a.x < b.x; });
+    const std::size_t nb_hull_vertices = shapes::convex_hull(stdutils::make_const_span(input.steiner)).vertices.size();
+    const CancellationToken token;
+
+    for (const auto& impl : registered_impls())
+    {
+        if (!supports(impl, TriangulationPolicy::PointCloud)) { continue; }
+        CAPTURE(impl.name);
+        const auto triangles = triangulate(impl, input, TriangulationPolicy::PointCloud, &token);
+        CHECK(triangles.vertices.size() == nb_points);
+        CHECK(triangles.faces.size() == 2 * nb_points - nb_hull_vertices - 2);
+        const auto report = validate_all(triangles, TriangulationPolicy::PointCloud);
+        CHECK(report.nb_out_of_bounds == 0);
+        CHECK(report.nb_flipped == 0);
+        CHECK(report.nb_adjacency_errors == 0);
+        if (exact_in_double(impl)) { CHECK(report.nb_non_delaunay == 0); }
+    }
+}
+
+TEST_CASE("Incremental triangulation of Steiner points inside and outside of the bounding box", "[dt]")
+{
+    constexpr std::size_t nb_points = 1000;
+    auto points = shapes::generators::uniform_point_cloud<double>(nb_points, 42).vertices;
+    const std::vector<shapes::Point2d<double>> new_points = { { 0.5, 0.5 }, { 10.0, -10.0 }, { -3.0, 20.0 } };
+
+    for (const auto& impl : registered_impls())
+    {
+        if (!supports(impl, TriangulationPolicy::PointCloud)) { continue; }
+        CAPTURE(impl.name);
+        auto algo = get_impl(impl, &no_error_handler());
+        REQUIRE(algo);
+        algo->add_steiner(stdutils::make_const_span(points));
+        CHECK(algo->triangulate_incremental(TriangulationPolicy::PointCloud).faces.size() == 2 * nb_points - shapes::convex_hull(stdutils::make_const_span(points)).vertices.size() - 2);
+        std::vector<shapes::Point2d<double>> all_points = points;
+        for (const auto& p : new_points)
+        {
+            all_points.push_back(p);
+            const auto triangles = algo->triangulate_incremental(TriangulationPolicy::PointCloud, stdutils::Span<const shapes::Point2d<double>>(&p, 1));
+            const std::size_t nb_hull_vertices = shapes::convex_hull(stdutils::make_const_span(all_points)).vertices.size();
+            CHECK(triangles.vertices.size() == all_points.size());
+            CHECK(triangles.faces.size() == 2 * all_points.size() - nb_hull_vertices - 2);
+            CHECK(validate_all(triangles, TriangulationPolicy::PointCloud).nb_flipped == 0);
+        }
+    }
+}
+
+TEST_CASE("Delaunay triangulation with empty shapes", "[dt]")
+{
+    const std::vector<shapes::Point2d<double>> points = { { 0.0, 0.0 }, { 1.0, 0.0 }, { 0.0, 1.0 } };
+    const shapes::PointPath2d<double> empty_path;               // Open
+    const shapes::PointCloud2d<double> empty_point_cloud;
+
+    for (const auto& impl : registered_impls())
+    {
+        if (!supports(impl, TriangulationPolicy::PointCloud)) { continue; }
+        CAPTURE(impl.name);
+        auto algo = get_impl(impl, &no_error_handler());
+        REQUIRE(algo);
+        algo->add_steiner(empty_point_cloud);
+        algo->add_steiner(stdutils::make_const_span(points));
+        algo->add_path(empty_path);
+        algo->add_hole(empty_path);
+        algo->add_steiner(empty_point_cloud);
+        algo->add_steiner(stdutils::make_const_span(std::vector<shapes::Point2d<double>>()));
+        const auto triangles = algo->triangulate(TriangulationPolicy::PointCloud);
+        CHECK(triangles.vertices.size() == points.size());
+        CHECK(triangles.faces.size() == 1);
+    }
+}
+
+TEST_CASE("Delaunay triangulation of a grid", "[dt]")
+{
+    // Many degenerate configurations: Collinear points on the hull, four cocircular points in each cell
+    constexpr std::size_t nb_points = 400;
+    Input input;
+    input.steiner = shapes::generators::grid_point_cloud<double>(nb_points).vertices;
+
+    for (const auto& impl : registered_impls())
+    {
+        if (!supports(impl, TriangulationPolicy::PointCloud) || !exact_in_double(impl)) { continue; }
+        CAPTURE(impl.name);
+        const auto triangles = triangulate(impl, input, TriangulationPolicy::PointCloud);
+        CHECK(!triangles.faces.empty());
+        CHECK(validate_all(triangles, TriangulationPolicy::PointCloud).is_valid());
+    }
+}
+
+TEST_CASE("Constrained triangulation of a simple polygon", "[dt]")
+{
+    for (const std::size_t nb_vertices : { std::size_t{3}, std::size_t{10}, std::size_t{500} })
+    {
+        CAPTURE(nb_vertices);
+        Input input;
+        input.paths.push_back(shapes::generators::random_polygon<double>(nb_vertices, 7));
+        REQUIRE(input.paths.front().vertices.size() == nb_vertices);
+
+        for (const auto& impl : registered_impls())
+        {
+            if (!supports(impl, TriangulationPolicy::CDT)) { continue; }
+            CAPTURE(impl.name);
+            const auto triangles = triangulate(impl, input, TriangulationPolicy::CDT);
+            CHECK(triangles.faces.size() == nb_vertices - 2);
+            CHECK(validate_all(triangles, TriangulationPolicy::CDT).is_valid());
+        }
+    }
+}
+
+TEST_CASE("Reuse of an instance after clear()", "[dt]")
+{
+    // As done by the workers of delaunay_batch: One instance per thread, cleared before each input
+    const auto make_input = [](TriangulationPolicy policy, std::size_t nb_vertices, std::uint32_t seed) {
+        Input input;
+        if (policy == TriangulationPolicy::CDT) { input.paths.push_back(shapes::generators::random_polygon<double>(nb_vertices, seed)); }
+        else { input.steiner = shapes::generators::uniform_point_cloud<double>(nb_vertices, seed).vertices; }
+        return input;
+    };
+
+    for (const auto policy : { TriangulationPolicy::PointCloud, TriangulationPolicy::CDT })
+    {
+        CAPTURE(policy_name(policy));
+        const Input first_input = make_input(policy, 500, 3);
+        const Input second_input = make_input(policy, 100, 11);
+        for (const auto& impl : registered_impls())
+        {
+            if (!supports(impl, policy)) { continue; }
+            CAPTURE(impl.name);
+            const auto expected = triangulate(impl, second_input, policy);
+            REQUIRE(!expected.faces.empty());
+
+            auto algo = get_impl(impl, &no_error_handler());
+            REQUIRE(algo);
+            add_input(*algo, first_input);
+            CHECK(!algo->triangulate(policy).faces.empty());
+            for (const bool with_reserve : { false, true })
+            {
+                CAPTURE(with_reserve);
+                algo->clear();
+                if (with_reserve) { algo->reserve(100, 1); }
+                add_input(*algo, second_input);
+                const auto triangles = algo->triangulate(policy);
+                CHECK(triangles.vertices == expected.vertices);
+                REQUIRE(triangles.faces.size() == expected.faces.size());
+                for (std::size_t face_idx = 0; face_idx < expected.faces.size(); face_idx++)
+                    for (std::size_t k = 0; k < 3; k++)
+                        CHECK(triangles.faces[face_idx][k] == expected.faces[face_idx][k]);
+                CHECK(triangles.adjacency == expected.adjacency);
+            }
+        }
+    }
+}
+
+TEST_CASE("Speculative triangulation", "[dt]")
+{
+    const auto& impls = registered_impls();
+    const auto spec_impl = std::find_if(impls.cbegin(), impls.cend(), [](const auto& impl) { return impl.name == "CDT_spec"; });
+    if (spec_impl == impls.cend()) { return; }          // Built without CDT
+
+    std::vector<std::string> traces;
+    std::vector<std::string> infos;
+    const stdutils::io::ErrorHandler handler = [&traces, &infos](stdutils::io::SeverityCode code, stdutils::io::ErrorMessage msg) {
+        if (code < stdutils::io::Severity::WARN) { FAIL(std::string(msg)); }
+        if (code == stdutils::io::Severity::TRACE) { traces.emplace_back(msg); }
+        if (code == stdutils::io::Severity::INFO) { infos.emplace_back(msg); }
+    };
+    const auto has_fallen_back = [&traces]() {
+        return std::any_of(traces.cbegin(), traces.cend(), [](const auto& msg) { return msg.find("Falling back") != std::string::npos; });
+    };
+    constexpr std::size_t nb_points = 1000;
+    const auto uniform_points = shapes::generators::uniform_point_cloud<double>(nb_points, 42).vertices;
+    // Distinct in double, but rounded to a grid of step 2 in float: Most of the points are duplicated in the fp32 attempt
+    std::vector<shapes::Point2d<double>> rounded_points;
+    for (const auto& p : uniform_points) { rounded_points.emplace_back(16777216.0 + 64.0 * p.x, 16777216.0 + 64.0 * p.y); }
+    const std::size_t nb_faces = 2 * nb_points - shapes::convex_hull(stdutils::make_const_span(rounded_points)).vertices.size() - 2;
+
+    SECTION("The fp32 attempt is valid")
+    {
+        auto algo = get_impl(*spec_impl, &handler);
+        REQUIRE(algo);
+        algo->add_steiner(stdutils::make_const_span(uniform_points));
+        const auto triangles = algo->triangulate(TriangulationPolicy::PointCloud);
+        CHECK(!has_fallen_back());
+        CHECK(triangles.vertices.size() == nb_points);
+        CHECK(validate_all(triangles, TriangulationPolicy::PointCloud).nb_flipped == 0);
+    }
+    SECTION("The fp32 attempt fails, then the fp64 one is kept")
+    {
+        auto algo = get_impl(*spec_impl, &handler);
+        REQUIRE(algo);
+        algo->add_steiner(stdutils::make_const_span(rounded_points));
+        const auto triangles = algo->triangulate(TriangulationPolicy::PointCloud);
+        CHECK(has_fallen_back());
+        CHECK(triangles.vertices == rounded_points);
+        CHECK(triangles.faces.size() == nb_faces);
+        CHECK(validate_all(triangles, TriangulationPolicy::PointCloud).is_valid());
+    }
+    SECTION("Cancellation of the fp64 attempt")
+    {
+        // Cancelled once the fp32 attempt has failed: The cancellation is passed through, it is not taken for another failed attempt
+        CancellationToken token;
+        const stdutils::io::ErrorHandler cancelling_handler = [&handler, &token](stdutils::io::SeverityCode code, stdutils::io::ErrorMessage msg) {
+            handler(code, msg);
+            if (code == stdutils::io::Severity::TRACE && msg.find("Falling back") != std::string::npos) { token.cancel(); }
+        };
+        auto algo = get_impl(*spec_impl, &cancelling_handler);
+        REQUIRE(algo);
+        algo->add_steiner(stdutils::make_const_span(rounded_points));
+        CHECK(algo->triangulate(TriangulationPolicy::PointCloud, &token).faces.empty());
+        CHECK(has_fallen_back());
+        CHECK(std::any_of(infos.cbegin(), infos.cend(), [](const auto& msg) { return msg.find("cancelled") != std::string::npos; }));
+        // The input is kept
+        CHECK(algo->triangulate(TriangulationPolicy::PointCloud).faces.size() == nb_faces);
+    }
+}
+
+TEST_CASE("Benchmark the triangulations", "[dt][benchmark]")
+{
+    Input point_cloud;
+    point_cloud.steiner = shapes::generators::uniform_point_cloud<double>(100000, 42).vertices;
+    Input polygon;
+    polygon.paths.push_back(shapes::generators::random_polygon<double>(10000, 7));
+
+    for (const auto& impl : registered_impls())
+    {
+        if (supports(impl, TriangulationPolicy::PointCloud))
+        {
+            BENCHMARK(impl.name + " - point cloud of 100k points")
+            {
+                return triangulate(impl, point_cloud, TriangulationPolicy::PointCloud);
+            };
+        }
+        if (supports(impl, TriangulationPolicy::CDT))
+        {
+            BENCHMARK(impl.name + " - CDT of a polygon of 10k vertices")
+            {
+                return triangulate(impl, polygon, TriangulationPolicy::CDT);
+            };
+        }
+    }
+}
+
+} // namespace test
+} // namespace delaunay
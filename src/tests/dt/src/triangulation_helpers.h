@@ -0,0 +1,111 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#pragma once
+
+#include <catch_amalgamated.hpp>
+
+#include <dt/dt_impl.h>
+#include <dt/dt_interface.h>
+#include <dt/validation.h>
+#include <shapes/edge.h>
+#include <shapes/path.h>
+#include <shapes/point.h>
+#include <shapes/triangle.h>
+#include <stdutils/io.h>
+#include <stdutils/parallel.h>
+#include <stdutils/span.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace delaunay {
+namespace test {
+
+using index = std::uint32_t;
+
+// The implementations registered by the build, e.g. without the third-party libraries only DivConq
+inline const std::vector<RegisteredImpl<double, index>>& registered_impls()
+{
+    static const std::vector<RegisteredImpl<double, index>> impls = []() {
+        register_all_implementations();
+        return get_impl_list<double, index>().algos;
+    }();
+    return impls;
+}
+
+// Some libraries only implement one of the policies. They warn and return an empty output for the other one.
+inline bool supports(const RegisteredImpl<double, index>& impl, TriangulationPolicy policy)
+{
+    if (impl.name == "DivConq") { return policy == TriangulationPolicy::PointCloud; }
+    if (impl.name == "Poly2tri") { return policy == TriangulationPolicy::CDT; }
+    return true;
+}
+
+// The implementations that compute the predicates in single precision may output faces that are not Delaunay in double precision
+inline bool exact_in_double(const RegisteredImpl<double, index>& impl)
+{
+    return impl.name != "CDT_fp32";
+}
+
+inline std::string_view policy_name(TriangulationPolicy policy)
+{
+    return policy == TriangulationPolicy::CDT ? "CDT" : "point cloud";
+}
+
+// The warnings are expected (e.g. the unsupported policies), not the errors
+inline const stdutils::io::ErrorHandler& no_error_handler()
+{
+    static const stdutils::io::ErrorHandler handler = [](stdutils::io::SeverityCode code, stdutils::io::ErrorMessage msg) {
+        if (code < stdutils::io::Severity::WARN) { FAIL(std::string(msg)); }
+    };
+    return handler;
+}
+
+// Count the errors, for the tests of the invalid inputs
+inline stdutils::io::ErrorHandler error_counter(std::size_t& nb_errors)
+{
+    return [&nb_errors](stdutils::io::SeverityCode code, stdutils::io::ErrorMessage) {
+        if (code <= stdutils::io::Severity::ERR) { nb_errors++; }
+    };
+}
+
+// The input of a triangulation: The first path is the outer boundary of the CDT, the other ones are holes
+struct Input
+{
+    std::vector<shapes::PointPath2d<double>> paths;
+    std::vector<shapes::Point2d<double>> steiner;
+    shapes::Edges2d<double, index> edges;
+};
+
+inline void add_input(Interface<double, index>& algo, const Input& input)
+{
+    for (std::size_t path_idx = 0; path_idx < input.paths.size(); path_idx++)
+    {
+        if (path_idx == 0) { algo.add_path(input.paths[path_idx]); }
+        else { algo.add_hole(input.paths[path_idx]); }
+    }
+    if (!input.edges.indices.empty()) { algo.add_edges(input.edges); }
+    if (!input.steiner.empty()) { algo.add_steiner(stdutils::make_const_span(input.steiner)); }
+}
+
+inline shapes::Triangles2d<double, index> triangulate(const RegisteredImpl<double, index>& impl, const Input& input, TriangulationPolicy policy, const CancellationToken* token = nullptr)
+{
+    auto algo = get_impl(impl, &no_error_handler());
+    if (!algo) { return shapes::Triangles2d<double, index>(); }
+    add_input(*algo, input);
+    return algo->triangulate(policy, token);
+}
+
+// The Delaunay criterion is checked on all the faces, unless the policy is CDT
+inline ValidationReport validate_all(const shapes::Triangles2d<double, index>& triangles, TriangulationPolicy policy)
+{
+    ValidationOptions options;
+    options.nb_delaunay_samples = policy == TriangulationPolicy::PointCloud ? triangles.faces.size() : 0;
+    return validate(stdutils::parallel::Policy(), triangles, options);
+}
+
+} // namespace test
+} // namespace delaunay
@@ -2,6 +2,7 @@
 
 #include <lin/mat.h>
 
+#include <cstddef>
 #include <vector>
 #include <sstream>
 #include <string>
@@ -70,4 +71,65 @@ TEST_CASE("Test matrix copy", "[mat]")
     CHECK(copy_test[2][2] == 11);
 }
 
+TEST_CASE("Test constexpr matrix operations", "[mat]")
+{
+    constexpr mat3d m {
+        2, 0, 1,
+        1, 3, 0,
+        0, 1, 4
+    };
+    static_assert(determinant(m) == 25);
+    static_assert(determinant(mat2d { 1, 2, 3, 4 }) == -2);
+    constexpr auto y = m * vect3d { 1, 2, 3 };
+    static_assert(y[0] == 5 && y[1] == 7 && y[2] == 14);
+    constexpr auto mm = m * mat3d::identity();
+    static_assert(mm(2, 1) == 1 && mm(1, 0) == 1 && mm(0, 1) == 0);
+    CHECK(mm.values() == m.values());
+}
+
+namespace {
+
+template <typename F, dim_t N>
+void check_mul_batch(const mat<F, N, N>& m, std::size_t count)
+{
+    std::vector<F> in(N * count);
+    for (std::size_t idx = 0; idx < in.size(); idx++) { in[idx] = static_cast<F>(idx % 17) - F{8}; }
+    std::vector<F> out(N * count);
+    mul_batch(m, in.data(), out.data(), count);
+    for (std::size_t v = 0; v < count; v++)
+    {
+        vect<F, N> x;
+        for (dim_t i = 0; i < N; i++) { x[i] = in[v * N + i]; }
+        const auto y = m * x;
+        for (dim_t i = 0; i < N; i++)
+        {
+            CAPTURE(v); CAPTURE(i);
+            CHECK_THAT(static_cast<double>(out[v * N + i]), Catch::Matchers::WithinAbs(static_cast<double>(y[i]), 1e-4));
+        }
+    }
+
+    // In place
+    mul_batch(m, in.data(), in.data(), count);
+    CHECK(in == out);
+}
+
+} // namespace
+
+TEST_CASE("Test batched matrix-vector product", "[mat]")
+{
+    // The SIMD kernels (mat4f, mat2d), and the portable loop
+    check_mul_batch(mat4f { 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, -1.f, 0.5f, 0.f, 2.f, 0.f, 0.f, 0.f, 1.f }, 13);
+    check_mul_batch(mat2d { 0.5, -2.0, 3.0, 0.25 }, 13);
+    check_mul_batch(mat3d { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.5 }, 13);
+    check_mul_batch(mat2f { 0.5f, -2.f, 3.f, 0.25f }, 13);
+    check_mul_batch(mat4f::identity(), 0);
+
+    // Non-square
+    const mat<double, 2, 3> m { 1, 2, 3, 4, 5, 6 };
+    const std::vector<double> in = { 1, 0, 0, 0, 1, 1 };
+    std::vector<double> out(4);
+    mul_batch(m, in.data(), out.data(), 2);
+    CHECK(out == std::vector<double> { 1, 4, 5, 11 });
+}
+
 } // namespace lin
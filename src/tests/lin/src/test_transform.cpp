@@ -0,0 +1,118 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <lin/mat.h>
+#include <lin/transform.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace lin {
+
+TEST_CASE("Matrix product", "[transform]")
+{
+    const mat<double, 2, 3> a {
+        1, 2, 3,
+        4, 5, 6
+    };
+    const mat<double, 3, 2> b {
+        7,  8,
+        9, 10,
+       11, 12
+    };
+    const auto c = a * b;
+    CHECK(c.rows == 2);
+    CHECK(c.cols == 2);
+    CHECK(c[0][0] == 58);
+    CHECK(c[0][1] == 64);
+    CHECK(c[1][0] == 139);
+    CHECK(c[1][1] == 154);
+
+    const auto id = mat3d::identity();
+    const auto t = affine2(1.0, 2.0, 3.0, 4.0, 5.0, 6.0);
+    CHECK((id * t).values() == t.values());
+    CHECK((t * id).values() == t.values());
+}
+
+TEST_CASE("2D affine transformations", "[transform]")
+{
+    // The SVG convention: { a, b, c, d, e, f }
+    const auto t = affine2(1.0, 2.0, 3.0, 4.0, 5.0, 6.0);
+    CHECK(is_affine2(t));
+    CHECK(transform_point(t, vect2d { 1.0, 1.0 }) == vect2d { 9.0, 12.0 });
+    CHECK(transform_vector(t, vect2d { 1.0, 1.0 }) == vect2d { 4.0, 6.0 });
+
+    // The right-hand side of the product is applied first
+    const auto scale_then_translate = translation2(1.0, -1.0) * scaling2(2.0, 3.0);
+    CHECK(is_affine2(scale_then_translate));
+    CHECK(transform_point(scale_then_translate, vect2d { 1.0, 1.0 }) == vect2d { 3.0, 2.0 });
+    const auto translate_then_scale = scaling2(2.0, 3.0) * translation2(1.0, -1.0);
+    CHECK(transform_point(translate_then_scale, vect2d { 1.0, 1.0 }) == vect2d { 4.0, 0.0 });
+}
+
+TEST_CASE("Batched 2D affine transformations", "[transform]")
+{
+    const auto t = affine2(0.5, -1.0, 2.0, 0.25, 3.0, -4.0);
+    constexpr std::size_t nb_points = 101;
+    std::vector<float> in(2 * nb_points);
+    for (std::size_t idx = 0; idx < in.size(); idx++) { in[idx] = static_cast<float>(idx) - 50.f; }
+
+    // Mixed precision: The input in float, the computation and the output in double
+    std::vector<double> out(2 * nb_points);
+    transform_points(t, in.data(), out.data(), nb_points);
+    for (std::size_t idx = 0; idx < nb_points; idx++)
+    {
+        CAPTURE(idx);
+        const auto expected = transform_point(t, vect2d { static_cast<double>(in[2 * idx]), static_cast<double>(in[2 * idx + 1]) });
+        CHECK(out[2 * idx] == expected[0]);
+        CHECK(out[2 * idx + 1] == expected[1]);
+    }
+
+    // In place
+    std::vector<double> in_place(in.begin(), in.end());
+    transform_points(t, in_place.data(), in_place.data(), nb_points);
+    CHECK(in_place == out);
+
+    // No point
+    transform_points(t, in.data(), out.data(), 0);
+    CHECK(out == in_place);
+}
+
+TEST_CASE("Batched 2D affine transformations in single and double precision", "[transform]")
+{
+    // With the same type in and out, the SIMD kernels, if any. An odd number of points for the last point of the float kernel.
+    constexpr std::size_t nb_points = 37;
+    {
+        const auto t = affine2(0.5, -1.0, 2.0, 0.25, 3.0, -4.0);
+        std::vector<double> points(2 * nb_points);
+        for (std::size_t idx = 0; idx < points.size(); idx++) { points[idx] = 0.1 * static_cast<double>(idx); }
+        std::vector<double> out(2 * nb_points);
+        transform_points(t, points.data(), out.data(), nb_points);
+        for (std::size_t idx = 0; idx < nb_points; idx++)
+        {
+            CAPTURE(idx);
+            const auto expected = transform_point(t, vect2d { points[2 * idx], points[2 * idx + 1] });
+            CHECK_THAT(out[2 * idx], Catch::Matchers::WithinAbs(expected[0], 1e-12));
+            CHECK_THAT(out[2 * idx + 1], Catch::Matchers::WithinAbs(expected[1], 1e-12));
+        }
+    }
+    {
+        const auto t = affine2(0.5f, -1.f, 2.f, 0.25f, 3.f, -4.f);
+        std::vector<float> points(2 * nb_points);
+        for (std::size_t idx = 0; idx < points.size(); idx++) { points[idx] = 0.1f * static_cast<float>(idx); }
+        std::vector<float> out(2 * nb_points);
+        transform_points(t, points.data(), out.data(), nb_points);
+        for (std::size_t idx = 0; idx < nb_points; idx++)
+        {
+            CAPTURE(idx);
+            const auto expected = transform_point(t, vect2f { points[2 * idx], points[2 * idx + 1] });
+            CHECK_THAT(static_cast<double>(out[2 * idx]), Catch::Matchers::WithinAbs(static_cast<double>(expected[0]), 1e-5));
+            CHECK_THAT(static_cast<double>(out[2 * idx + 1]), Catch::Matchers::WithinAbs(static_cast<double>(expected[1]), 1e-5));
+        }
+        transform_points(t, points.data(), points.data(), nb_points);
+        CHECK(points == out);
+    }
+}
+
+} // namespace lin
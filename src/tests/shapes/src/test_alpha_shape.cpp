@@ -0,0 +1,120 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <graphs/graph.h>
+#include <graphs/triangulation.h>
+#include <shapes/alpha_shape.h>
+#include <shapes/point.h>
+#include <shapes/triangle.h>
+#include <stdutils/parallel.h>
+#include <stdutils/span.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <vector>
+
+namespace shapes {
+
+namespace {
+namespace tests {
+
+using F = double;
+using I = std::uint32_t;
+
+// Two grids of n x n unit cells, 3 units apart, and the triangles bridging them
+Triangles2d<F, I> test_two_grids(I n)
+{
+    Triangles2d<F, I> result;
+    for (I j = 0; j <= n; j++)
+        for (I i = 0; i <= 2 * n + 1; i++)
+            result.vertices.emplace_back(static_cast<F>(i <= n ? i : i + 2), static_cast<F>(j));
+    const I row = 2 * n + 2;
+    for (I j = 0; j < n; j++)
+        for (I i = 0; i <= 2 * n; i++)
+        {
+            const I v = j * row + i;
+            result.faces.emplace_back(v, v + 1, v + row + 1);
+            result.faces.emplace_back(v, v + row + 1, v + row);
+        }
+    return result;
+}
+
+// The edges of the faces that are not shared by two of them, in a canonical form
+std::vector<graphs::Edge<I>> brute_force_borders(stdutils::Span<const graphs::Triangle<I>> faces)
+{
+    std::map<graphs::Edge<I>, int> count;
+    for (const auto& t : faces)
+        for (const auto& e : t.edges())
+            count[graphs::ordered_edge(e)]++;
+    std::vector<graphs::Edge<I>> result;
+    for (const auto& [e, c] : count) { if (c == 1) { result.push_back(e); } }
+    return result;
+}
+
+std::vector<graphs::Edge<I>> canonical(graphs::EdgeSoup<I> edges)
+{
+    std::transform(edges.begin(), edges.end(), edges.begin(), [](const auto& e) { return graphs::ordered_edge(e); });
+    std::sort(edges.begin(), edges.end());
+    return edges;
+}
+
+} // namespace tests
+} // namespace
+
+TEST_CASE("Alpha shapes of a triangulation", "[alpha_shape]")
+{
+    using F = tests::F;
+    constexpr tests::I n = 4;
+    auto triangles = tests::test_two_grids(n);
+    const AlphaShape<F, tests::I> alpha_shape(stdutils::parallel::Policy{ 4, 4 }, triangles);
+    const auto& radii = alpha_shape.sorted_radii();
+    REQUIRE(radii.size() == triangles.faces.size());
+    CHECK(std::is_sorted(radii.cbegin(), radii.cend()));
+
+    // The cells of the grids have the smallest circumradius, the bridging faces are stretched
+    CHECK(alpha_shape.nb_faces(F{0.5}) == 0);
+    CHECK(alpha_shape.nb_faces(F{0.75}) == 4 * n * n);
+    CHECK(alpha_shape.nb_faces(F{1000}) == triangles.faces.size());
+
+    // Outline of the two grids: two squares of 4 * n edges each
+    CHECK(alpha_shape.border_edges(F{0.75}).size() == 8 * n);
+    CHECK(alpha_shape.border_edges(F{0.5}).empty());
+    const auto outline = alpha_shape.outline(F{1000});
+    CHECK(outline.vertices.size() == triangles.vertices.size());
+    CHECK(outline.indices.size() == 2 * (2 * n + 1) + 2 * n);
+
+    // Same with and without the adjacency, and against the brute force
+    triangles.adjacency = graphs::triangle_adjacency(triangles.faces);
+    const AlphaShape<F, tests::I> alpha_shape_adj(triangles);
+    for (const F alpha : radii)
+    {
+        const auto borders = tests::canonical(alpha_shape.border_edges(alpha));
+        CHECK(borders == tests::brute_force_borders(alpha_shape.faces(alpha)));
+        CHECK(borders == tests::canonical(alpha_shape_adj.border_edges(alpha)));
+        CHECK(alpha_shape.triangles(alpha).faces.size() == alpha_shape.nb_faces(alpha));
+    }
+}
+
+TEST_CASE("Alpha shape with degenerate faces", "[alpha_shape]")
+{
+    using F = tests::F;
+    Triangles2d<F, tests::I> triangles;
+    triangles.vertices = { Point2d<F>(0.0, 0.0), Point2d<F>(1.0, 0.0), Point2d<F>(0.0, 1.0), Point2d<F>(2.0, 0.0) };
+    triangles.faces.emplace_back(0, 1, 2);
+    triangles.faces.emplace_back(0, 1, 3);
+    const AlphaShape<F, tests::I> alpha_shape(triangles);
+    CHECK(alpha_shape.nb_faces(std::numeric_limits<F>::max()) == 1);
+    CHECK(alpha_shape.nb_faces(std::numeric_limits<F>::infinity()) == 1);
+    CHECK(alpha_shape.border_edges(F{1}).size() == 3);
+
+    const AlphaShape<F, tests::I> empty;
+    CHECK(empty.nb_faces(F{1}) == 0);
+    CHECK(empty.faces(F{1}).size() == 0);
+    CHECK(empty.border_edges(F{1}).empty());
+}
+
+} // namespace shapes
@@ -4,6 +4,10 @@
 
 #include <shapes/bounding_box.h>
 #include <shapes/bounding_box_algos.h>
+#include <shapes/point.h>
+#include <shapes/point_cloud.h>
+#include <shapes/point_soa.h>
+#include <stdutils/parallel.h>
 
 #include <cstdlib>
 #include <sstream>
@@ -73,4 +77,23 @@ TEST_CASE("Conservative rounding to a bounding box with a floating-point type",
     CHECK(extent_out.y == F1{8});
 }
 
+TEST_CASE("Parallel fast_bounding_box matches the sequential one", "[bounding_box]")
+{
+    stdutils::parallel::Policy policy;
+    policy.nb_threads = 3;
+    policy.min_chunk_size = 8;
+    PointCloud2d<double> pc;
+    for (int idx = 0; idx < 100; idx++) { pc.vertices.emplace_back(static_cast<double>((idx * 37) % 101) - 50.0, static_cast<double>((idx * 53) % 97)); }
+    const auto bb = fast_bounding_box(pc);
+    CHECK(bb.min() == Point2d<double>(-50.0, 0.0));
+    CHECK(bb.max() == Point2d<double>(50.0, 96.0));
+    CHECK(fast_bounding_box(policy, pc) == bb);
+    CHECK(fast_bounding_box(policy, to_soa(pc)) == bb);
+    CHECK(!fast_bounding_box(policy, PointCloud2d<double>()).is_populated());
+
+    PointCloud3d<double> pc_3d;
+    pc_3d.vertices = { { 1.0, 2.0, 3.0 }, { -1.0, 0.0, 5.0 } };
+    CHECK(fast_bounding_box(policy, pc_3d).max() == Point3d<double>(1.0, 2.0, 5.0));
+}
+
 } // namespace shapes
@@ -0,0 +1,110 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <graphs/triangulation.h>
+#include <shapes/compressed_mesh.h>
+#include <shapes/memory.h>
+#include <shapes/triangle.h>
+#include <shapes/triangle_algos.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+
+namespace shapes {
+
+namespace {
+
+// Triangulation of a jittered grid of (n + 1) x (n + 1) vertices
+Triangles2d<double> jittered_grid(std::uint32_t n)
+{
+    Triangles2d<double> result;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> jitter(-0.2, 0.2);
+    for (std::uint32_t j = 0; j <= n; j++)
+        for (std::uint32_t i = 0; i <= n; i++)
+            result.vertices.emplace_back(static_cast<double>(i) + jitter(rng), static_cast<double>(j) + jitter(rng));
+    const auto v = [n](std::uint32_t i, std::uint32_t j) { return j * (n + 1) + i; };
+    for (std::uint32_t j = 0; j < n; j++)
+        for (std::uint32_t i = 0; i < n; i++)
+        {
+            result.faces.emplace_back(v(i, j), v(i + 1, j), v(i + 1, j + 1));
+            result.faces.emplace_back(v(i, j), v(i + 1, j + 1), v(i, j + 1));
+        }
+    result.adjacency = graphs::triangle_adjacency(result.faces);
+    return result;
+}
+
+bool same_face(const graphs::Triangle<std::uint32_t>& lhs, const graphs::Triangle<std::uint32_t>& rhs)
+{
+    return lhs[0] == rhs[0] && lhs[1] == rhs[1] && lhs[2] == rhs[2];
+}
+
+bool same_faces(const graphs::TriangleSoup<std::uint32_t>& lhs, const graphs::TriangleSoup<std::uint32_t>& rhs)
+{
+    return std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend(), same_face);
+}
+
+} // namespace
+
+TEST_CASE("Compressed triangulation round trip", "[compressed_mesh]")
+{
+    auto triangles = jittered_grid(100);
+    renumber_along_hilbert_curve(triangles);
+    const CompressedTriangles<double> compressed(triangles);
+    CHECK(compressed.nb_vertices() == triangles.vertices.size());
+    CHECK(compressed.nb_faces() == triangles.faces.size());
+    CHECK(compressed.has_adjacency());
+    CHECK(4 * compressed.byte_size() < byte_size(triangles));
+
+    const auto decoded = compressed.decode();
+    CHECK(same_faces(decoded.faces, triangles.faces));
+    CHECK(decoded.adjacency == triangles.adjacency);
+    REQUIRE(decoded.vertices.size() == triangles.vertices.size());
+    const double max_error = compressed.max_quantization_error();
+    CHECK(max_error > 0.0);
+    CHECK(max_error < 1e-5);
+    for (std::size_t idx = 0; idx < decoded.vertices.size(); idx++)
+    {
+        CHECK(std::abs(decoded.vertices[idx].x - triangles.vertices[idx].x) <= 1.01 * max_error);
+        CHECK(std::abs(decoded.vertices[idx].y - triangles.vertices[idx].y) <= 1.01 * max_error);
+    }
+
+    // Comparison without decoding
+    auto other = triangles;
+    CHECK(compressed.same_faces(CompressedTriangles<double>(other, 8)));
+    std::swap(other.faces[3][1], other.faces[3][2]);
+    const CompressedTriangles<double> other_compressed(other);
+    CHECK_FALSE(compressed.same_faces(other_compressed));
+    std::size_t nb_different_faces = 0;
+    std::size_t face_idx = 0;
+    other_compressed.for_each_face([&](const graphs::Triangle<std::uint32_t>& face) { if (!same_face(face, triangles.faces[face_idx++])) { nb_different_faces++; } });
+    CHECK(nb_different_faces == 1);
+}
+
+TEST_CASE("Compressed triangulation edge cases", "[compressed_mesh]")
+{
+    const Triangles2d<double> empty;
+    const CompressedTriangles<double> compressed_empty(empty);
+    CHECK(compressed_empty.nb_vertices() == 0);
+    CHECK(compressed_empty.decode().faces.empty());
+    CHECK(compressed_empty.max_quantization_error() == 0.0);
+
+    // A single, flat triangle
+    Triangles2d<float> flat;
+    flat.vertices = { { 1.f, 2.f }, { 3.f, 2.f }, { 2.f, 2.f } };
+    flat.faces.emplace_back(0, 1, 2);
+    const auto decoded = CompressedTriangles<float>(flat).decode();
+    CHECK(decoded.vertices == flat.vertices);
+    CHECK(same_faces(decoded.faces, flat.faces));
+    CHECK(decoded.adjacency.empty());
+
+    CHECK_THROWS_AS(CompressedTriangles<float>(flat, 0), std::invalid_argument);
+    CHECK_THROWS_AS(CompressedTriangles<float>(flat, 32), std::invalid_argument);
+}
+
+} // namespace shapes
@@ -0,0 +1,94 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <shapes/convex_hull.h>
+#include <shapes/generators.h>
+#include <shapes/path.h>
+#include <shapes/point.h>
+#include <stdutils/parallel.h>
+#include <stdutils/span.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace shapes {
+
+namespace {
+namespace tests {
+
+using F = double;
+
+F orient(const Point2d<F>& a, const Point2d<F>& b, const Point2d<F>& c)
+{
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+// The hull is strictly convex, counter-clockwise, and all the points are inside
+void check_hull(const PointPath2d<F>& hull, const Points2d<F>& points)
+{
+    REQUIRE(hull.closed);
+    const auto& v = hull.vertices;
+    REQUIRE(v.size() >= 3);
+    for (std::size_t idx = 0; idx < v.size(); idx++)
+    {
+        const auto& a = v[idx];
+        const auto& b = v[(idx + 1) % v.size()];
+        CHECK(orient(a, b, v[(idx + 2) % v.size()]) > F{0});
+        CHECK(std::all_of(points.cbegin(), points.cend(), [&a, &b](const Point2d<F>& p) { return orient(a, b, p) >= F{0}; }));
+        CHECK(std::find(points.cbegin(), points.cend(), a) != points.cend());
+    }
+}
+
+} // namespace tests
+} // namespace
+
+TEST_CASE("Convex hull of random points", "[convex_hull]")
+{
+    const auto uniform = generators::uniform_point_cloud<tests::F>(5000, 1).vertices;
+    const auto clustered = generators::clustered_point_cloud<tests::F>(5000, 2).vertices;
+    for (const auto* points : { &uniform, &clustered })
+    {
+        const auto hull = convex_hull(stdutils::make_const_span(*points));
+        tests::check_hull(hull, *points);
+        const auto parallel_hull = convex_hull(stdutils::parallel::Policy{ 4, 500 }, stdutils::make_const_span(*points));
+        CHECK(parallel_hull.vertices == hull.vertices);
+    }
+}
+
+TEST_CASE("Akl-Toussaint filter", "[convex_hull]")
+{
+    const auto points = generators::uniform_point_cloud<tests::F>(10000, 3).vertices;
+    const auto filtered = akl_toussaint_filter(stdutils::parallel::Policy{ 4, 500 }, stdutils::make_const_span(points));
+    CHECK(filtered.size() < points.size() / 4);
+    const auto hull = convex_hull(stdutils::make_const_span(points));
+    for (const auto& p : hull.vertices) { CHECK(std::find(filtered.cbegin(), filtered.cend(), p) != filtered.cend()); }
+    CHECK(convex_hull(stdutils::make_const_span(filtered)).vertices == hull.vertices);
+}
+
+TEST_CASE("Convex hull of degenerate point sets", "[convex_hull]")
+{
+    using F = tests::F;
+    CHECK(convex_hull(stdutils::Span<const Point2d<F>>()).vertices.empty());
+
+    Points2d<F> points = { Point2d<F>(1.0, 2.0), Point2d<F>(1.0, 2.0) };
+    auto hull = convex_hull(stdutils::make_const_span(points));
+    CHECK(hull.closed == false);
+    CHECK(hull.vertices == Points2d<F>{ Point2d<F>(1.0, 2.0) });
+
+    // Aligned points
+    points.clear();
+    for (int idx = 0; idx < 10; idx++) { points.emplace_back(static_cast<F>(idx), static_cast<F>(2 * idx)); }
+    hull = convex_hull(stdutils::parallel::Policy{ 2, 2 }, stdutils::make_const_span(points));
+    CHECK(hull.closed);
+    CHECK(hull.vertices == Points2d<F>{ Point2d<F>(0.0, 0.0), Point2d<F>(9.0, 18.0) });
+
+    // Square with points on its sides, and duplicates
+    points = { Point2d<F>(0.0, 0.0), Point2d<F>(1.0, 0.0), Point2d<F>(2.0, 0.0), Point2d<F>(2.0, 2.0), Point2d<F>(0.0, 2.0),
+               Point2d<F>(0.0, 1.0), Point2d<F>(1.0, 1.0), Point2d<F>(2.0, 2.0), Point2d<F>(0.0, 0.0) };
+    hull = convex_hull(stdutils::make_const_span(points));
+    CHECK(hull.vertices == Points2d<F>{ Point2d<F>(0.0, 0.0), Point2d<F>(2.0, 0.0), Point2d<F>(2.0, 2.0), Point2d<F>(0.0, 2.0) });
+}
+
+} // namespace shapes
@@ -0,0 +1,144 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <shapes/generators.h>
+#include <shapes/path.h>
+#include <shapes/point_cloud.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace shapes {
+
+namespace {
+
+template <typename F>
+F cross(const Point2d<F>& o, const Point2d<F>& a, const Point2d<F>& b)
+{
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+// Proper intersection of segments [a0, a1] and [b0, b1]
+template <typename F>
+bool segments_intersect(const Point2d<F>& a0, const Point2d<F>& a1, const Point2d<F>& b0, const Point2d<F>& b1)
+{
+    return cross(a0, a1, b0) * cross(a0, a1, b1) < F{0} && cross(b0, b1, a0) * cross(b0, b1, a1) < F{0};
+}
+
+// Brute force: The edges of the paths do not cross each other
+template <typename F>
+bool no_crossing_edges(const std::vector<PointPath2d<F>>& paths)
+{
+    std::vector<std::pair<Point2d<F>, Point2d<F>>> segments;
+    for (const auto& pp : paths)
+    {
+        const std::size_t n = pp.vertices.size();
+        for (std::size_t idx = 0; idx < n; idx++)
+            segments.emplace_back(pp.vertices[idx], pp.vertices[(idx + 1) % n]);
+    }
+    for (std::size_t i = 0; i < segments.size(); i++)
+        for (std::size_t j = i + 1; j < segments.size(); j++)
+            if (segments_intersect(segments[i].first, segments[i].second, segments[j].first, segments[j].second))
+                return false;
+    return true;
+}
+
+// Ray casting
+template <typename F>
+bool is_inside(const Point2d<F>& p, const PointPath2d<F>& pp)
+{
+    bool inside = false;
+    const std::size_t n = pp.vertices.size();
+    for (std::size_t i = 0, j = n - 1; i < n; j = i++)
+    {
+        const auto& a = pp.vertices[i];
+        const auto& b = pp.vertices[j];
+        if ((a.y > p.y) != (b.y > p.y) && p.x < (b.x - a.x) * (p.y - a.y) / (b.y - a.y) + a.x)
+            inside = !inside;
+    }
+    return inside;
+}
+
+template <typename F>
+bool in_unit_square(const PointCloud2d<F>& pc)
+{
+    return std::all_of(pc.vertices.cbegin(), pc.vertices.cend(), [](const auto& p) { return F{0} <= p.x && p.x <= F{1} && F{0} <= p.y && p.y <= F{1}; });
+}
+
+} // namespace
+
+TEST_CASE("Generators of point clouds", "[generators]")
+{
+    const auto uniform = generators::uniform_point_cloud<double>(1000, 42);
+    CHECK(uniform.vertices.size() == 1000);
+    CHECK(in_unit_square(uniform));
+    CHECK(generators::uniform_point_cloud<double>(1000, 42).vertices == uniform.vertices);
+    CHECK(generators::uniform_point_cloud<double>(1000, 43).vertices != uniform.vertices);
+
+    CHECK(generators::gaussian_point_cloud<float>(1000).vertices.size() == 1000);
+    CHECK(generators::clustered_point_cloud<double>(1000).vertices.size() == 1000);
+    CHECK(generators::clustered_point_cloud<double>(1000, 0, 3).vertices.size() == 1000);
+
+    const auto grid = generators::grid_point_cloud<double>(10);
+    REQUIRE(grid.vertices.size() == 10);
+    CHECK(grid.vertices[3] == Point2d<double>(3.0, 0.0));
+    CHECK(grid.vertices[4] == Point2d<double>(0.0, 1.0));
+    CHECK(grid.vertices[9] == Point2d<double>(1.0, 2.0));
+
+    const auto cocircular = generators::cocircular_point_cloud<double>(100);
+    REQUIRE(cocircular.vertices.size() == 100);
+    CHECK(std::all_of(cocircular.vertices.cbegin(), cocircular.vertices.cend(), [](const auto& p) { return std::abs(norm(p - Point2d<double>(0.5, 0.5)) - 0.5) < 1.e-12; }));
+    const auto near_cocircular = generators::cocircular_point_cloud<double>(100, 1.e-6);
+    CHECK(std::all_of(near_cocircular.vertices.cbegin(), near_cocircular.vertices.cend(), [](const auto& p) { return std::abs(norm(p - Point2d<double>(0.5, 0.5)) - 0.5) <= 0.5e-6 + 1.e-12; }));
+}
+
+TEST_CASE("Poisson-disk sampling", "[generators]")
+{
+    const double min_distance = 0.05;
+    const auto pc = generators::poisson_disk_point_cloud<double>(min_distance, 1);
+    CHECK(in_unit_square(pc));
+    const auto expected_size = 0.7 / (min_distance * min_distance);
+    CHECK(static_cast<double>(pc.vertices.size()) > 0.5 * expected_size);
+    CHECK(static_cast<double>(pc.vertices.size()) < 1.5 * expected_size);
+    double min_sq_dist = 1.0;
+    for (std::size_t i = 0; i < pc.vertices.size(); i++)
+        for (std::size_t j = i + 1; j < pc.vertices.size(); j++)
+            min_sq_dist = std::min(min_sq_dist, sq_norm(pc.vertices[i] - pc.vertices[j]));
+    CHECK(min_sq_dist >= min_distance * min_distance);
+}
+
+TEST_CASE("Generators of polygons", "[generators]")
+{
+    for (const std::size_t n : { 3u, 4u, 10u, 200u })
+    {
+        const auto polygon = generators::random_polygon<double>(n, 7);
+        REQUIRE(polygon.vertices.size() == n);
+        CHECK(polygon.closed);
+        CHECK(no_crossing_edges<double>({ polygon }));
+        if (n >= 4) { CHECK(is_inside(Point2d<double>(0.5, 0.5), polygon)); }
+
+        const auto coastline = generators::fractal_coastline<double>(n, 0.6, 7);
+        REQUIRE(coastline.vertices.size() == n);
+        CHECK(coastline.closed);
+        CHECK(no_crossing_edges<double>({ coastline }));
+    }
+
+    for (const std::size_t nb_holes : { 0u, 1u, 5u, 16u })
+    {
+        const auto paths = generators::random_polygon_with_holes<double>(400, nb_holes, 3);
+        REQUIRE(paths.size() == nb_holes + 1);
+        CHECK(no_crossing_edges(paths));
+        for (std::size_t idx = 1; idx < paths.size(); idx++)
+        {
+            CHECK(paths[idx].closed);
+            CHECK(paths[idx].vertices.size() >= 3);
+            CHECK(std::all_of(paths[idx].vertices.cbegin(), paths[idx].vertices.cend(), [&paths](const auto& p) { return is_inside(p, paths.front()); }));
+        }
+    }
+}
+
+} // namespace shapes
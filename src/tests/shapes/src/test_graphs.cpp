@@ -2,11 +2,20 @@
 // This code is distributed under the terms of the MIT License
 #include <catch_amalgamated.hpp>
 
+#include <graphs/compact_indexing.h>
+#include <graphs/components.h>
+#include <graphs/csr_graph.h>
 #include <graphs/graph.h>
 #include <graphs/graph_algos.h>
+#include <graphs/triangulation.h>
+#include <graphs/union_find.h>
+#include <stdutils/parallel.h>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstdint>
+#include <random>
 #include <sstream>
 #include <string>
 #include <type_traits>
@@ -120,6 +129,26 @@ EdgeSoup<I> edge_soup_non_manifold_five_star()
     return out;
 }
 
+template <typename I = std::uint32_t>
+TriangleSoup<I> triangle_soup_square_with_center()
+{
+    //                                   //
+    //      3 ------- 2                  //
+    //      | \     / |                  //
+    //      |   \ /   |                  //
+    //      |    4    |                  //
+    //      |   / \   |                  //
+    //      | /     \ |                  //
+    //      0 ------- 1                  //
+    //                                   //
+    TriangleSoup<I> out;
+    out.emplace_back(0, 1, 4);
+    out.emplace_back(1, 2, 4);
+    out.emplace_back(2, 3, 4);
+    out.emplace_back(3, 0, 4);
+    return out;
+}
+
 } // namespace assets
 } // namespace tests
 } // namespace
@@ -260,6 +289,38 @@ TEST_CASE("Invalid EdgeSoup: Duplicate edges", "[graphs]")
     CHECK(is_valid(edges) == true);
 }
 
+TEST_CASE("EdgeSoup: filter out duplicates and loops", "[graphs]")
+{
+    using I = std::uint32_t;
+    EdgeSoup<I> edges;
+    edges.push_back(Edge<I>(3, 1));
+    edges.push_back(Edge<I>(2, 2));
+    edges.push_back(Edge<I>(0, 4));
+    edges.push_back(Edge<I>(1, 3));
+    edges.push_back(Edge<I>(4, 0));
+    edges.push_back(Edge<I>(2, 5));
+    edges.push_back(Edge<I>(2, 2));
+    CHECK(has_duplicated_edges(edges) == true);
+
+    // The first occurence of each edge is kept, in the original order
+    auto filtered = edges;
+    filter_out_duplicates(filtered);
+    EdgeSoup<I> expected;
+    expected.push_back(Edge<I>(3, 1));
+    expected.push_back(Edge<I>(2, 2));
+    expected.push_back(Edge<I>(0, 4));
+    expected.push_back(Edge<I>(2, 5));
+    CHECK(filtered == expected);
+
+    filter_out_duplicates_and_loops(edges);
+    expected.erase(expected.begin() + 1);
+    CHECK(edges == expected);
+    CHECK(has_duplicated_edges(edges) == false);
+    CHECK(is_valid(edges));
+    CHECK(nb_vertices(edges) == 6);
+    CHECK(to_vertex_set(edges) == VertexSet<I>{ 0, 1, 2, 3, 4, 5 });
+}
+
 TEST_CASE("Invalid EdgeSoup: Undef index", "[graphs]")
 {
     using I = std::uint8_t;
@@ -306,6 +367,107 @@ TEST_CASE("EdgeSoup: min_degree, max_degree and minmax_degree", "[graphs]")
     }
 }
 
+TEST_CASE("CsrGraph of an edge soup", "[graphs]")
+{
+    const auto edges = tests::assets::edge_soup_non_manifold_five_star();
+    const CsrGraph<> graph(edges);
+    REQUIRE(graph.nb_vertices() == 6);
+    CHECK(graph.nb_half_edges() == 10);
+    CHECK(graph.degree(5) == 5);
+    CHECK(graph.degree(0) == 1);
+    CHECK(graph.degree(6) == 0);
+    CHECK(minmax_degree(graph) == MinMaxDeg{1, 5});
+    REQUIRE(graph.has_edge_indices());
+    for (std::uint32_t v = 0; v < 6; v++)
+    {
+        for (std::size_t half_edge = graph.first_half_edge(v); half_edge < graph.first_half_edge(v) + graph.degree(v); half_edge++)
+        {
+            const auto& e = edges[graph.edge_index(half_edge)];
+            CHECK(((e.orig() == v && e.dest() == graph.neighbor(half_edge)) || (e.dest() == v && e.orig() == graph.neighbor(half_edge))));
+        }
+    }
+
+    // A hub vertex of high degree
+    EdgeSoup<> star;
+    for (std::uint32_t idx = 1; idx <= 10000; idx++) { star.emplace_back(0, idx); }
+    const CsrGraph<> star_graph(star);
+    CHECK(star_graph.nb_half_edges() == 20000);
+    CHECK(max_degree(star_graph) == 10000);
+    CHECK(minmax_degree(star) == MinMaxDeg{1, 10000});
+    CHECK(extract_paths(star).size() == 10000);
+}
+
+TEST_CASE("CsrGraph of a triangle soup", "[graphs]")
+{
+    const CsrGraph<> graph(tests::assets::triangle_soup_square_with_center());
+    REQUIRE(graph.nb_vertices() == 5);
+    CHECK(graph.nb_half_edges() == 16);
+    CHECK(graph.degree(4) == 4);
+    CHECK(minmax_degree(graph) == MinMaxDeg{3, 4});
+    CHECK_FALSE(graph.has_edge_indices());
+    std::vector<std::uint32_t> neighbors;
+    graph.for_each_neighbor(0, [&neighbors](std::uint32_t v) { neighbors.push_back(v); });
+    CHECK(neighbors == std::vector<std::uint32_t>{ 1, 3, 4 });
+}
+
+TEST_CASE("Connected components of two islands", "[graphs]")
+{
+    // The square with a center, and a copy of it with indices shifted by 6. Index 5 is not used.
+    TriangleSoup<> triangles = tests::assets::triangle_soup_square_with_center();
+    for (const auto& t : tests::assets::triangle_soup_square_with_center()) { triangles.emplace_back(t[0] + 6, t[1] + 6, t[2] + 6); }
+    const stdutils::parallel::Policy policy;
+    const auto components = connected_components(policy, triangles);
+    CHECK(components.nb_components == 2);
+    REQUIRE(components.labels.size() == 11);
+    CHECK(components.labels == std::vector<std::uint32_t>{ 0, 0, 0, 0, 0, IndexTraits<std::uint32_t>::undef(), 1, 1, 1, 1, 1 });
+    CHECK(component_sizes(components) == std::vector<std::size_t>{ 5, 5 });
+
+    // Same labels from the edges and from the CSR graph
+    const auto edges = to_edge_soup(triangles);
+    CHECK(connected_components(policy, edges).labels == components.labels);
+    CHECK(connected_components(policy, CsrGraph<>(triangles)).labels == components.labels);
+    CHECK(connected_components(policy, EdgeSoup<>()).nb_components == 0);
+}
+
+TEST_CASE("Parallel connected components of a random edge soup", "[graphs]")
+{
+    using I = std::uint32_t;
+    constexpr I N = 20000;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<I> vertex(0, N - 1);
+    EdgeSoup<I> edges;
+    for (std::size_t idx = 0; idx < N / 2; idx++)
+    {
+        const I i = vertex(rng);
+        const I j = vertex(rng);
+        if (i != j) { edges.emplace_back(i, j); }
+    }
+    UnionFind<I> reference(N);
+    for (const auto& e : edges) { reference.subset_union(e.orig(), e.dest()); }
+
+    stdutils::parallel::Policy sequential;
+    sequential.nb_threads = 1;
+    stdutils::parallel::Policy parallel;
+    parallel.nb_threads = 4;
+    parallel.min_chunk_size = 256;
+    const auto components = connected_components(sequential, edges);
+    CHECK(connected_components(parallel, edges).labels == components.labels);
+    CHECK(connected_components(parallel, CsrGraph<I>(edges)).labels == components.labels);
+    REQUIRE(components.labels.size() <= N);
+    std::size_t nb_components = 0;
+    for (I v = 0; v < static_cast<I>(components.labels.size()); v++)
+    {
+        const I label = components.labels[v];
+        if (!is_defined(label)) { continue; }
+        if (reference.find(v) == v) { nb_components++; }
+        for (I w = 0; w < v; w += 97)
+        {
+            if (is_defined(components.labels[w])) { CHECK((label == components.labels[w]) == (reference.find(v) == reference.find(w))); }
+        }
+    }
+    CHECK(components.nb_components == nb_components);
+}
+
 TEST_CASE("EdgeSoup: minmax_indices", "[graphs]")
 {
     using I = std::uint8_t;
@@ -366,6 +528,61 @@ TEST_CASE("EdgeSoup: nb_vertices and compact indexing", "[graphs]")
     }
 }
 
+TEST_CASE("Parallel compact indexing of a sparse edge soup and a sparse triangle soup", "[graphs]")
+{
+    using I = std::uint32_t;
+    constexpr I N = 100000;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<I> vertex(1000, N - 1);        // Some indices are not used, including the lowest ones
+    EdgeSoup<I> edges;
+    TriangleSoup<I> triangles;
+    for (std::size_t idx = 0; idx < 5000; idx++)
+    {
+        edges.emplace_back(vertex(rng), vertex(rng));
+        triangles.emplace_back(vertex(rng), vertex(rng), vertex(rng));
+    }
+    const EdgeSoup<I> input_edges = edges;
+    const TriangleSoup<I> input_triangles = triangles;
+
+    stdutils::parallel::Policy parallel;
+    parallel.nb_threads = 4;
+    parallel.min_chunk_size = 256;
+    std::vector<I> old_indices;
+    auto expected_edges = input_edges;
+    compact_indexing(expected_edges);
+    CHECK(compact_indexing(parallel, edges, &old_indices) == nb_vertices(input_edges));
+    CHECK(edges == expected_edges);
+    REQUIRE(old_indices.size() == nb_vertices(input_edges));
+    CHECK(std::is_sorted(old_indices.cbegin(), old_indices.cend()));
+    for (std::size_t idx = 0; idx < edges.size(); idx++)
+    {
+        CHECK(old_indices[edges[idx].orig()] == input_edges[idx].orig());
+        CHECK(old_indices[edges[idx].dest()] == input_edges[idx].dest());
+    }
+
+    auto expected_triangles = input_triangles;
+    compact_indexing(expected_triangles);
+    CHECK(compact_indexing(parallel, triangles) == nb_vertices(input_triangles));
+    REQUIRE(triangles.size() == expected_triangles.size());
+    for (std::size_t idx = 0; idx < triangles.size(); idx++)
+        for (std::size_t k = 0; k < 3; k++)
+            CHECK(triangles[idx][k] == expected_triangles[idx][k]);
+
+    // Sequential, and a dense range that fits in a single word of the bitmap
+    stdutils::parallel::Policy sequential;
+    sequential.nb_threads = 1;
+    auto small_edges = tests::assets::edge_soup_non_manifold_five_star<I>();
+    auto expected_small_edges = small_edges;
+    compact_indexing(expected_small_edges);
+    CHECK(compact_indexing(sequential, small_edges, &old_indices) == 6);
+    CHECK(small_edges == expected_small_edges);
+    CHECK(old_indices.size() == 6);
+
+    EdgeSoup<I> empty;
+    CHECK(compact_indexing(parallel, empty, &old_indices) == 0);
+    CHECK(old_indices.empty());
+}
+
 TEST_CASE("Algo: Extract paths of empty edge soup", "[graphs]")
 {
     EdgeSoup<> test;
@@ -417,4 +634,59 @@ TEST_CASE("Algo: Extract paths from edge soup", "[graphs]")
     }
 }
 
+TEST_CASE("Triangulation: adjacency of a triangle soup", "[graphs]")
+{
+    using I = std::uint32_t;
+    constexpr I Undef = IndexTraits<I>::undef();
+    const auto triangles = tests::assets::triangle_soup_square_with_center<I>();
+
+    const auto adjacency = triangle_adjacency(triangles);
+    REQUIRE(adjacency.size() == triangles.size());
+    CHECK(is_valid(adjacency, triangles));
+    const std::array<I, 3> expected_adj_0{ Undef, 1, 3 };
+    const std::array<I, 3> expected_adj_2{ Undef, 3, 1 };
+    CHECK(adjacency[0] == expected_adj_0);
+    CHECK(adjacency[2] == expected_adj_2);
+
+    CHECK(edge_index(triangles[1], I{4}, I{1}) == 2);
+    CHECK(edge_index(triangles[1], I{0}, I{1}) == 3);
+    CHECK(opposite_vertex(triangles, adjacency, I{0}, 1) == 2);
+    CHECK(opposite_vertex(triangles, adjacency, I{0}, 0) == Undef);
+
+    // Same edges as the set-based algorithms
+    auto edges = to_edge_soup(triangles, adjacency);
+    std::sort(edges.begin(), edges.end());
+    CHECK(edges == to_edge_soup(triangles));
+    const auto borders = extract_borders(triangles, adjacency);
+    const auto expected_borders = extract_borders(triangles);
+    CHECK(borders.borders == expected_borders.borders);
+    CHECK(borders.nb_inner_edges == expected_borders.nb_inner_edges);
+    CHECK(borders.nb_inner_edges == 4);
+
+    // Invalid adjacency
+    auto wrong_adjacency = adjacency;
+    wrong_adjacency[0][1] = 2;
+    CHECK(is_valid(wrong_adjacency, triangles) == false);
+}
+
+TEST_CASE("64-bit indices", "[graphs]")
+{
+    using I = std::uint64_t;
+
+    const auto edge_soup = tests::assets::edge_soup_non_manifold_five_star<I>();
+    REQUIRE(is_valid(edge_soup));
+    CHECK(minmax_degree(edge_soup) == std::make_pair(std::size_t{1}, std::size_t{5}));
+    const auto paths = extract_paths(edge_soup);
+    CHECK(paths.size() == 5);
+    CHECK(std::all_of(paths.cbegin(), paths.cend(), [](const auto& path) { return !path.closed && path.vertices.size() == 2; }));
+
+    const auto triangles = tests::assets::triangle_soup_square_with_center<I>();
+    const auto adjacency = triangle_adjacency(triangles);
+    CHECK(is_valid(adjacency, triangles));
+    CHECK(opposite_vertex(triangles, adjacency, I{0}, 0) == IndexTraits<I>::undef());
+    const CsrGraph<I> graph(triangles);
+    CHECK(graph.nb_half_edges() == 16);
+    CHECK(graph.degree(I{4}) == 4);
+}
+
 } // namespace graphs
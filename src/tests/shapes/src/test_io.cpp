@@ -0,0 +1,332 @@
+// Copyright (c) 2023 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <shapes/io.h>
+#include <shapes/shapes.h>
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace shapes {
+namespace io {
+
+namespace {
+
+const stdutils::io::ErrorHandler throw_on_error = [](stdutils::io::SeverityCode code, std::string_view msg) {
+    if (code < stdutils::io::Severity::WARN) { FAIL(msg); }
+};
+
+ShapeAggregate<double> test_shape_aggregate()
+{
+    ShapeAggregate<double> result;
+    {
+        PointCloud2d<double> pc;
+        pc.vertices.emplace_back(1.0, 2.0);
+        pc.vertices.emplace_back(-0.5, 1e-300);
+        result.emplace_back(pc, "point cloud");
+    }
+    {
+        PointPath3d<double> pp;
+        pp.closed = true;
+        pp.vertices.emplace_back(0.0, 0.0, 1.0);
+        pp.vertices.emplace_back(1.0, 0.0, 1.0);
+        pp.vertices.emplace_back(1.0, 1.0, 0.25);
+        result.emplace_back(pp, "a closed path");
+    }
+    {
+        Edges2d<double> edges;
+        edges.vertices.emplace_back(0.0, 0.0);
+        edges.vertices.emplace_back(1.0, 0.0);
+        edges.vertices.emplace_back(0.0, 1.0);
+        edges.indices.emplace_back(0, 1);
+        edges.indices.emplace_back(2, 0);
+        result.emplace_back(edges);
+    }
+    {
+        Triangles2d<double> triangles;
+        triangles.vertices.emplace_back(0.0, 0.0);
+        triangles.vertices.emplace_back(1.0, 0.0);
+        triangles.vertices.emplace_back(0.0, 1.0);
+        triangles.vertices.emplace_back(1.0, 1.0);
+        triangles.faces.emplace_back(0, 1, 2);
+        triangles.faces.emplace_back(2, 1, 3);
+        result.emplace_back(triangles, "two triangles");
+    }
+    return result;
+}
+
+std::string to_dat_string(const ShapeAggregate<double>& shapes)
+{
+    std::ostringstream out;
+    dat::save_shapes_as_stream(out, shapes, throw_on_error);
+    return out.str();
+}
+
+} // namespace
+
+TEST_CASE("ShapeWrapper moves the geometry of an rvalue", "[shapes::io]")
+{
+    PointCloud2d<double> pc;
+    pc.vertices.emplace_back(1.0, 2.0);
+    pc.vertices.emplace_back(3.0, 4.0);
+    const auto* vertex_buffer = pc.vertices.data();
+
+    const ShapeWrapper<double> copied_wrapper(pc, "copy");
+    CHECK(pc.vertices.size() == 2);
+    CHECK(std::get<PointCloud2d<double>>(copied_wrapper.shape).vertices.data() != vertex_buffer);
+
+    const ShapeWrapper<double> moved_wrapper(std::move(pc), "move");
+    CHECK(moved_wrapper.descr == "move");
+    CHECK(std::get<PointCloud2d<double>>(moved_wrapper.shape).vertices.data() == vertex_buffer);
+}
+
+TEST_CASE("DAT triangle soup vertices are deduplicated in order of first occurrence", "[shapes::io]")
+{
+    std::istringstream in(R"(TRIANGLE_SOUP
+0 0
+1 0
+0 1
+0 1
+1 0
+1 1
+-0 1
+1 1
+2 2
+)");
+    const auto shapes = dat::parse_shapes_from_stream(in, throw_on_error);
+    REQUIRE(shapes.size() == 1);
+    const auto& triangles = std::get<Triangles2d<double>>(shapes.front().shape);
+    const std::vector<Point2d<double>> expected_vertices { { 0.0, 0.0 }, { 1.0, 0.0 }, { 0.0, 1.0 }, { 1.0, 1.0 }, { 2.0, 2.0 } };
+    CHECK(triangles.vertices == expected_vertices);
+    REQUIRE(triangles.faces.size() == 3);
+    CHECK(triangles.faces[1][0] == 2);
+    CHECK(triangles.faces[1][2] == 3);
+    CHECK(triangles.faces[2][0] == 2);
+    CHECK(triangles.faces[2][2] == 4);
+}
+
+TEST_CASE("DAT incremental parsing", "[shapes::io]")
+{
+    const auto shapes = test_shape_aggregate();
+    std::stringstream dat_stream;
+    dat::save_shapes_as_stream(dat_stream, shapes, throw_on_error);
+    const std::string dat_str = dat_stream.str();
+
+    SECTION("All shapes")
+    {
+        std::istringstream in(dat_str);
+        ShapeAggregate<double> parsed_shapes;
+        const bool success = dat::parse_shapes_from_stream(in, [&parsed_shapes](ShapeWrapper<double>&& shape) {
+            parsed_shapes.emplace_back(std::move(shape));
+            return true;
+        }, throw_on_error);
+        CHECK(success);
+        std::istringstream in_ref(dat_str);
+        CHECK(to_dat_string(parsed_shapes) == to_dat_string(dat::parse_shapes_from_stream(in_ref, throw_on_error)));
+        CHECK(parsed_shapes.size() == shapes.size());
+    }
+    SECTION("Stop after the second shape")
+    {
+        std::istringstream in(dat_str);
+        std::vector<std::size_t> shape_types;
+        const bool success = dat::parse_shapes_from_stream(in, [&shape_types](ShapeWrapper<double>&& shape) {
+            shape_types.push_back(shape.shape.index());
+            return shape_types.size() < 2;
+        }, throw_on_error);
+        CHECK(success);
+        REQUIRE(shape_types.size() == 2);
+        CHECK(shape_types[0] == shapes[0].shape.index());
+        CHECK(shape_types[1] == shapes[1].shape.index());
+    }
+}
+
+TEST_CASE("DAT round trip of the coordinates", "[shapes::io]")
+{
+    PointPath2d<double> pp;
+    pp.closed = false;
+    pp.vertices.emplace_back(0.1, -1.0 / 3.0);
+    pp.vertices.emplace_back(1e-300, 123456789.125);
+    pp.vertices.emplace_back(-0.0, 5e-324);
+    ShapeAggregate<double> shapes;
+    shapes.emplace_back(pp);
+
+    const std::string dat_str = to_dat_string(shapes);
+    CHECK(dat_str.find("0.1 ") != std::string::npos);             // Shortest representation
+    std::istringstream in(dat_str);
+    const auto parsed_shapes = dat::parse_shapes_from_stream(in, throw_on_error);
+    REQUIRE(parsed_shapes.size() == 1);
+    const auto& parsed_pp = std::get<PointPath2d<double>>(parsed_shapes.front().shape);
+    CHECK(parsed_pp.closed == false);
+    CHECK(parsed_pp.vertices == pp.vertices);
+}
+
+TEST_CASE("CDT round trip of a soup", "[shapes::io]")
+{
+    Soup2d<double> soup;
+    soup.point_cloud.vertices.emplace_back(5.0, 5.0);
+    soup.edges.vertices.emplace_back(0.1, 0.2);
+    soup.edges.vertices.emplace_back(0.3, 0.4);
+    soup.edges.indices.emplace_back(1, 0);
+    soup.triangles.vertices.emplace_back(0.0, 0.0);
+    soup.triangles.vertices.emplace_back(1.0, 0.0);
+    soup.triangles.vertices.emplace_back(0.0, 1.0);
+    soup.triangles.vertices.emplace_back(1.0, 1.0);
+    soup.triangles.faces.emplace_back(0, 1, 2);
+    soup.triangles.faces.emplace_back(2, 1, 3);
+
+    std::stringstream stream;
+    cdt::save_2d_shapes_as_stream(stream, soup, throw_on_error);
+    CHECK(stream.str().rfind("7 1 2\n", 0) == 0);
+    const auto parsed_soup = cdt::parse_2d_shapes_from_stream(stream, throw_on_error);
+    CHECK(parsed_soup.point_cloud.vertices == soup.point_cloud.vertices);
+    CHECK(parsed_soup.edges.vertices == soup.edges.vertices);
+    CHECK(parsed_soup.edges.indices == soup.edges.indices);
+    CHECK(parsed_soup.triangles.vertices == soup.triangles.vertices);
+    REQUIRE(parsed_soup.triangles.faces.size() == soup.triangles.faces.size());
+    for (std::size_t idx = 0; idx < soup.triangles.faces.size(); idx++)
+        for (std::size_t k = 0; k < 3; k++)
+            CHECK(parsed_soup.triangles.faces[idx][k] == soup.triangles.faces[idx][k]);
+}
+
+TEST_CASE("CDT projected parsing of a 3D soup", "[shapes::io]")
+{
+    // More vertices than a block of vertex lines
+    Soup3d<double> soup;
+    for (unsigned int idx = 0; idx < 5000; idx++)
+        soup.point_cloud.vertices.emplace_back(0.5 * idx, -0.25 * idx, 1.0 + 0.125 * (idx % 16));
+    soup.edges.vertices.emplace_back(0.1, 0.2, -3.0);
+    soup.edges.vertices.emplace_back(0.3, 0.4, 3.0);
+    soup.edges.indices.emplace_back(1, 0);
+    soup.triangles.vertices.emplace_back(0.0, 0.0, 2.0);
+    soup.triangles.vertices.emplace_back(1.0, 0.0, 2.5);
+    soup.triangles.vertices.emplace_back(0.0, 1.0, 3.0);
+    soup.triangles.faces.emplace_back(0, 1, 2);
+    std::stringstream stream;
+    cdt::save_3d_shapes_as_stream(stream, soup, throw_on_error);
+    const std::string cdt_string = stream.str();
+
+    SECTION("Drop an axis")
+    {
+        std::istringstream input(cdt_string);
+        cdt::SoupHeights heights;
+        const auto parsed_soup = cdt::parse_3d_shapes_projected_from_stream(input, cdt::Projection::drop_axis(2), throw_on_error, &heights);
+        const auto drop_z = [](const auto& vertices) {
+            std::vector<Point2d<double>> result;
+            for (const auto& p : vertices) { result.emplace_back(p.x, p.y); }
+            return result;
+        };
+        const auto z_of = [](const auto& vertices) {
+            std::vector<float> result;
+            for (const auto& p : vertices) { result.push_back(static_cast<float>(p.z)); }
+            return result;
+        };
+        CHECK(parsed_soup.point_cloud.vertices == drop_z(soup.point_cloud.vertices));
+        CHECK(parsed_soup.edges.vertices == drop_z(soup.edges.vertices));
+        CHECK(parsed_soup.edges.indices == soup.edges.indices);
+        CHECK(parsed_soup.triangles.vertices == drop_z(soup.triangles.vertices));
+        REQUIRE(parsed_soup.triangles.faces.size() == 1);
+        for (std::size_t k = 0; k < 3; k++)
+            CHECK(parsed_soup.triangles.faces[0][k] == soup.triangles.faces[0][k]);
+        CHECK(heights.point_cloud == z_of(soup.point_cloud.vertices));
+        CHECK(heights.edges == z_of(soup.edges.vertices));
+        CHECK(heights.triangles == z_of(soup.triangles.vertices));
+    }
+    SECTION("Project on a plane")
+    {
+        const Point3d<double> origin(1.0, 2.0, 3.0);
+        const Vect3d<double> normal(1.0, 1.0, 1.0);
+        const auto projection = cdt::Projection::plane(origin, normal);
+        CHECK_THAT(dot(projection.u, normal), Catch::Matchers::WithinAbs(0.0, 1e-12));
+        CHECK_THAT(dot(projection.v, normal), Catch::Matchers::WithinAbs(0.0, 1e-12));
+        CHECK_THAT(dot(projection.u, projection.v), Catch::Matchers::WithinAbs(0.0, 1e-12));
+        CHECK_THAT(dot(cross_product(projection.u, projection.v), normal), Catch::Matchers::WithinRel(norm(normal), 1e-12));
+
+        std::istringstream input(cdt_string);
+        cdt::SoupHeights heights;
+        const auto parsed_soup = cdt::parse_3d_shapes_projected_from_stream(input, projection, throw_on_error, &heights);
+        REQUIRE(parsed_soup.triangles.vertices.size() == 3);
+        REQUIRE(heights.triangles.size() == 3);
+        for (std::size_t idx = 0; idx < 3; idx++)
+        {
+            // The projection is an isometry
+            const auto& p = parsed_soup.triangles.vertices[idx];
+            const double h = static_cast<double>(heights.triangles[idx]);
+            const auto d = soup.triangles.vertices[idx] - origin;
+            CHECK_THAT(sq_norm(p) + h * h, Catch::Matchers::WithinRel(sq_norm(d), 1e-6));
+            CHECK_THAT(h, Catch::Matchers::WithinRel(dot(d, normal) / norm(normal), 1e-6));
+        }
+    }
+}
+
+TEST_CASE("SHB round trip of a shape aggregate", "[shapes::io]")
+{
+    const auto shapes = test_shape_aggregate();
+    std::ostringstream out;
+    shb::save_shapes_as_stream(out, shapes, throw_on_error);
+    const std::string buffer = out.str();
+    CHECK(buffer.size() % 8 == 0);
+
+    const auto parsed_shapes = shb::parse_shapes_from_buffer(buffer, throw_on_error);
+    REQUIRE(parsed_shapes.size() == shapes.size());
+    for (std::size_t idx = 0; idx < shapes.size(); idx++)
+    {
+        CHECK(parsed_shapes[idx].shape.index() == shapes[idx].shape.index());
+        CHECK(parsed_shapes[idx].descr == shapes[idx].descr);
+    }
+    CHECK(to_dat_string(parsed_shapes) == to_dat_string(shapes));
+    CHECK(std::get<PointPath3d<double>>(parsed_shapes[1].shape).closed == true);
+}
+
+TEST_CASE("SHB zero-copy view", "[shapes::io]")
+{
+    const auto shapes = test_shape_aggregate();
+    std::ostringstream out;
+    shb::save_shapes_as_stream(out, shapes, throw_on_error);
+    const std::string str = out.str();
+    std::vector<double> aligned_buffer(str.size() / sizeof(double));
+    std::memcpy(aligned_buffer.data(), str.data(), str.size());
+    const std::string_view buffer(reinterpret_cast<const char*>(aligned_buffer.data()), str.size());
+
+    std::vector<shb::ChunkView> chunks;
+    REQUIRE(shb::view_chunks(buffer, chunks, throw_on_error));
+    REQUIRE(chunks.size() == 4);
+    CHECK(chunks[0].descr == "point cloud");
+    CHECK(chunks[0].coordinates.size() == 4);
+    CHECK(chunks[0].coordinates[2] == -0.5);
+    CHECK(chunks[0].indices.empty());
+    CHECK(chunks[1].closed == true);
+    CHECK(chunks[1].coordinates.size() == 9);
+    CHECK(chunks[3].indices.size() == 6);
+    CHECK(chunks[3].indices[5] == 3);
+}
+
+TEST_CASE("SHB invalid buffers", "[shapes::io]")
+{
+    std::vector<stdutils::io::SeverityCode> errors;
+    const stdutils::io::ErrorHandler err_handler = [&errors](stdutils::io::SeverityCode code, std::string_view) { errors.push_back(code); };
+    std::ostringstream out;
+    shb::save_shapes_as_stream(out, test_shape_aggregate(), throw_on_error);
+    const std::string buffer = out.str();
+
+    SECTION("Not a SHB buffer")
+    {
+        CHECK(shb::parse_shapes_from_buffer("POINT_CLOUD\n1 2\n", err_handler).empty());
+        REQUIRE(!errors.empty());
+        CHECK(errors.back() == stdutils::io::Severity::ERR);
+    }
+    SECTION("Truncated buffer")
+    {
+        CHECK(shb::parse_shapes_from_buffer(std::string_view(buffer).substr(0, buffer.size() - 8), err_handler).empty());
+        REQUIRE(!errors.empty());
+        CHECK(errors.back() == stdutils::io::Severity::ERR);
+    }
+}
+
+} // namespace io
+} // namespace shapes
@@ -0,0 +1,139 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <shapes/path.h>
+#include <shapes/path_algos.h>
+#include <shapes/point.h>
+#include <stdutils/parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace shapes {
+
+namespace {
+
+// Dense sampling of a sine wave, on [0, 2 pi]
+PointPath2d<double> sine_wave(std::size_t nb_vertices)
+{
+    PointPath2d<double> result;
+    for (std::size_t idx = 0; idx < nb_vertices; idx++)
+    {
+        const double x = 2.0 * M_PI * static_cast<double>(idx) / static_cast<double>(nb_vertices - 1);
+        result.vertices.emplace_back(x, std::sin(x));
+    }
+    return result;
+}
+
+double max_distance_to_path(const PointPath2d<double>& original, const PointPath2d<double>& simplified)
+{
+    double result = 0.0;
+    const std::size_t n = simplified.vertices.size();
+    const std::size_t nb_segments = simplified.closed ? n : n - 1;
+    for (const auto& p : original.vertices)
+    {
+        double min_sq_dist = std::numeric_limits<double>::max();
+        for (std::size_t idx = 0; idx < nb_segments; idx++)
+            min_sq_dist = std::min(min_sq_dist, details::simplification::sq_distance_to_segment(p, simplified.vertices[idx], simplified.vertices[(idx + 1) % n]));
+        result = std::max(result, std::sqrt(min_sq_dist));
+    }
+    return result;
+}
+
+bool intersect(const PointPath2d<double>& open_path, const PointPath2d<double>& closed_path)
+{
+    const auto& u = open_path.vertices;
+    const auto& v = closed_path.vertices;
+    for (std::size_t i = 0; i + 1 < u.size(); i++)
+    {
+        for (std::size_t j = 0; j < v.size(); j++)
+        {
+            if (details::simplification::segments_intersect(u[i], u[i + 1], v[j], v[(j + 1) % v.size()]))
+                return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+TEST_CASE("Douglas-Peucker simplification", "[path_algos]")
+{
+    const auto wave = sine_wave(1000);
+    SimplificationOptions options;
+    options.method = SimplificationMethod::DouglasPeucker;
+    options.tolerance = 0.01;
+    const auto simplified = simplify_path(wave, options);
+    CHECK(simplified.vertices.size() < 50);
+    CHECK(simplified.vertices.front() == wave.vertices.front());
+    CHECK(simplified.vertices.back() == wave.vertices.back());
+    CHECK(max_distance_to_path(wave, simplified) <= options.tolerance);
+
+    // A zero tolerance keeps all the vertices
+    options.tolerance = 0.0;
+    CHECK(simplify_path(wave, options).vertices.size() == wave.vertices.size());
+
+    // A closed path keeps at least 3 vertices
+    PointPath2d<double> square;
+    square.closed = true;
+    square.vertices = { { 0.0, 0.0 }, { 0.5, 0.0 }, { 1.0, 0.0 }, { 1.0, 1.0 }, { 0.0, 1.0 } };
+    options.tolerance = 10.0;
+    const auto simplified_square = simplify_path(square, options);
+    CHECK(simplified_square.closed);
+    CHECK(simplified_square.vertices.size() == 3);
+    options.tolerance = 0.1;
+    CHECK(simplify_path(square, options).vertices.size() == 4);
+}
+
+TEST_CASE("Visvalingam-Whyatt simplification", "[path_algos]")
+{
+    const auto wave = sine_wave(1000);
+    SimplificationOptions options;
+    options.method = SimplificationMethod::VisvalingamWhyatt;
+    options.tolerance = 0.01;
+    const auto simplified = simplify_path(wave, options);
+    CHECK(simplified.vertices.size() < 100);
+    CHECK(simplified.vertices.size() > 2);
+    CHECK(simplified.vertices.front() == wave.vertices.front());
+    CHECK(simplified.vertices.back() == wave.vertices.back());
+
+    // The collinear vertices are removed
+    PointPath2d<double> square;
+    square.closed = true;
+    square.vertices = { { 0.0, 0.0 }, { 0.5, 0.0 }, { 1.0, 0.0 }, { 1.0, 0.5 }, { 1.0, 1.0 }, { 0.5, 1.0 }, { 0.0, 1.0 }, { 0.0, 0.5 } };
+    options.tolerance = 0.01;
+    CHECK(simplify_path(square, options).vertices.size() == 4);
+}
+
+TEST_CASE("Simplification preserving the topology between paths", "[path_algos]")
+{
+    // A wave, and a small closed path inside its first bump, which the chord of the bump crosses
+    const auto wave = sine_wave(1000);
+    PointPath2d<double> hole;
+    hole.closed = true;
+    hole.vertices = { { 0.7, 0.5 }, { 0.9, 0.5 }, { 0.8, 0.68 } };
+    REQUIRE_FALSE(intersect(wave, hole));
+    const std::vector<PointPath2d<double>> paths = { wave, hole };
+    const stdutils::parallel::Policy policy;
+    for (const auto method : { SimplificationMethod::DouglasPeucker, SimplificationMethod::VisvalingamWhyatt })
+    {
+        SimplificationOptions options;
+        options.method = method;
+        options.tolerance = 0.5;
+        options.preserve_topology = false;
+        const auto unconstrained = simplify_paths(policy, paths, options);
+        if (method == SimplificationMethod::DouglasPeucker) { CHECK(intersect(unconstrained[0], unconstrained[1])); }
+        options.preserve_topology = true;
+        const auto constrained = simplify_paths(policy, paths, options);
+        REQUIRE(constrained.size() == 2);
+        CHECK(constrained[1].vertices.size() == 3);
+        CHECK(constrained[0].vertices.size() >= unconstrained[0].vertices.size());
+        CHECK_FALSE(intersect(constrained[0], constrained[1]));
+    }
+}
+
+} // namespace shapes
@@ -0,0 +1,117 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <shapes/point.h>
+#include <shapes/point_order.h>
+#include <shapes/vect.h>
+#include <stdutils/span.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace shapes {
+
+namespace {
+namespace tests {
+
+using F = double;
+using I = std::uint32_t;
+
+Points2d<F> random_points(std::size_t n, std::uint32_t seed = 0)
+{
+    Points2d<F> result;
+    result.reserve(n);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<F> coord(F{-10}, F{10});
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        const F x = coord(rng);
+        const F y = coord(rng);
+        result.emplace_back(x, y);
+    }
+    return result;
+}
+
+bool is_permutation(const std::vector<I>& order, std::size_t n)
+{
+    std::vector<I> sorted = order;
+    std::sort(sorted.begin(), sorted.end());
+    for (std::size_t idx = 0; idx < sorted.size(); idx++) { if (sorted[idx] != static_cast<I>(idx)) { return false; } }
+    return sorted.size() == n;
+}
+
+F path_length(const Points2d<F>& points, const std::vector<I>& order)
+{
+    F result = F{0};
+    for (std::size_t idx = 1; idx < order.size(); idx++) { result += norm(points[order[idx]] - points[order[idx - 1]]); }
+    return result;
+}
+
+} // namespace tests
+} // namespace
+
+TEST_CASE("hilbert_index visits each cell of the grid once, moving to an adjacent cell at each step", "[point_order]")
+{
+    constexpr unsigned int order = 4;
+    constexpr std::uint32_t side = 1u << order;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> cells(side * side);
+    std::set<std::uint32_t> indices;
+    for (std::uint32_t x = 0; x < side; x++)
+        for (std::uint32_t y = 0; y < side; y++)
+        {
+            const auto d = hilbert_index(x, y, order);
+            REQUIRE(d < side * side);
+            indices.insert(d);
+            cells[d] = { x, y };
+        }
+    CHECK(indices.size() == side * side);
+    CHECK(cells.front() == std::make_pair(0u, 0u));
+    CHECK(cells.back() == std::make_pair(side - 1, 0u));
+    for (std::size_t d = 1; d < cells.size(); d++)
+    {
+        const auto dx = static_cast<int>(cells[d].first) - static_cast<int>(cells[d - 1].first);
+        const auto dy = static_cast<int>(cells[d].second) - static_cast<int>(cells[d - 1].second);
+        CHECK(std::abs(dx) + std::abs(dy) == 1);
+    }
+}
+
+TEST_CASE("hilbert_order and brio_order are permutations that improve the locality", "[point_order]")
+{
+    const auto points = tests::random_points(2000);
+    const auto span = stdutils::make_const_span(points);
+    std::vector<tests::I> identity(points.size());
+    for (std::size_t idx = 0; idx < identity.size(); idx++) { identity[idx] = static_cast<tests::I>(idx); }
+    const auto input_length = tests::path_length(points, identity);
+
+    const auto hilbert = hilbert_order<tests::I>(span);
+    CHECK(tests::is_permutation(hilbert, points.size()));
+    CHECK(tests::path_length(points, hilbert) < input_length / 10);
+
+    const auto brio = brio_order<tests::I>(span, 42);
+    CHECK(tests::is_permutation(brio, points.size()));
+    CHECK(tests::path_length(points, brio) < input_length / 5);
+    CHECK(brio == brio_order<tests::I>(span, 42));
+}
+
+TEST_CASE("Point orders of degenerate inputs", "[point_order]")
+{
+    const stdutils::Span<const Point2d<tests::F>> empty;
+    CHECK(hilbert_order<tests::I>(empty).empty());
+    CHECK(brio_order<tests::I>(empty).empty());
+
+    const Points2d<tests::F> aligned = { { 0.0, 1.0 }, { 0.0, 3.0 }, { 0.0, 2.0 }, { 0.0, 0.0 } };
+    const auto hilbert = hilbert_order<tests::I>(stdutils::make_const_span(aligned));
+    CHECK(tests::is_permutation(hilbert, aligned.size()));
+    CHECK(tests::is_permutation(brio_order<tests::I>(stdutils::make_const_span(aligned)), aligned.size()));
+
+    const Points2d<tests::F> same = { { 1.0, 1.0 }, { 1.0, 1.0 }, { 1.0, 1.0 } };
+    CHECK(tests::is_permutation(hilbert_order<tests::I>(stdutils::make_const_span(same)), same.size()));
+}
+
+} // namespace shapes
@@ -0,0 +1,62 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <graphs/graph.h>
+#include <shapes/bounding_box_algos.h>
+#include <shapes/path.h>
+#include <shapes/point.h>
+#include <shapes/point_cloud.h>
+#include <shapes/point_soa.h>
+#include <shapes/triangle.h>
+#include <stdutils/span.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace shapes {
+
+TEST_CASE("Conversions between AoS and SoA point storage", "[point_soa]")
+{
+    PointPath2d<double> pp;
+    pp.closed = true;
+    pp.vertices = { { 1.0, 2.0 }, { -3.0, 4.0 }, { 5.0, -6.0 } };
+    const auto pp_soa = to_soa(pp);
+    CHECK(pp_soa.closed);
+    REQUIRE(pp_soa.vertices.size() == 3);
+    CHECK(pp_soa.vertices[1] == Point2d<double>(-3.0, 4.0));
+    CHECK(reinterpret_cast<std::uintptr_t>(pp_soa.vertices.x.data()) % Points2dSoA<double>::Alignment == 0);
+    CHECK(reinterpret_cast<std::uintptr_t>(pp_soa.vertices.y.data()) % Points2dSoA<double>::Alignment == 0);
+    const auto pp_aos = to_aos(pp_soa);
+    CHECK(pp_aos.closed);
+    CHECK(pp_aos.vertices == pp.vertices);
+
+    Triangles2d<double> triangles;
+    triangles.vertices = pp.vertices;
+    triangles.faces.emplace_back(0, 1, 2);
+    const auto tri_aos = to_aos(to_soa(triangles));
+    CHECK(tri_aos.vertices == triangles.vertices);
+    CHECK(tri_aos.faces.size() == 1);
+
+    const PointCloud2d<double> empty_pc;
+    const auto empty_soa = to_soa(empty_pc);
+    CHECK(empty_soa.vertices.empty());
+    CHECK(to_aos(empty_soa).vertices.empty());
+}
+
+TEST_CASE("Kernels on SoA points", "[point_soa]")
+{
+    PointCloud2d<double> pc;
+    pc.vertices = { { 1.0, 2.0 }, { -3.0, 4.0 }, { 5.0, -6.0 }, { 0.0, 0.0 }, { 2.0, 1.0 } };
+    const auto pc_soa = to_soa(pc);
+    CHECK(fast_bounding_box(pc_soa) == fast_bounding_box(pc));
+    CHECK(fast_bounding_box(pc_soa).min() == Point2d<double>(-3.0, -6.0));
+    CHECK(!fast_bounding_box(PointCloud2dSoA<double>()).is_populated());
+
+    const std::vector<graphs::Edge<std::uint32_t>> edges = { { 0, 1 }, { 2, 3 }, { 4, 4 } };
+    std::vector<double> sq_lengths(edges.size());
+    sq_distances(view(pc_soa.vertices), stdutils::make_const_span(edges), stdutils::make_span(sq_lengths));
+    CHECK(sq_lengths == std::vector<double>{ 20.0, 61.0, 0.0 });
+}
+
+} // namespace shapes
@@ -0,0 +1,122 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <graphs/graph.h>
+#include <shapes/point.h>
+#include <shapes/predicates.h>
+#include <stdutils/span.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace shapes {
+
+namespace {
+
+template <typename F>
+std::vector<Point2d<F>> grid_points(unsigned int n)
+{
+    std::vector<Point2d<F>> result;
+    for (unsigned int j = 0; j < n; j++)
+    {
+        for (unsigned int i = 0; i < n; i++)
+            result.emplace_back(static_cast<F>(i) / F{8}, static_cast<F>(j) / F{8});
+    }
+    return result;
+}
+
+template <typename F>
+std::int8_t sign_of(F value)
+{
+    return static_cast<std::int8_t>((value > F{0}) - (value < F{0}));
+}
+
+} // namespace
+
+TEST_CASE("orient2d is exact on collinear points", "[predicates]")
+{
+    const Point2d<double> a(0.5, 0.5);
+    const Point2d<double> b(12.0, 12.0);
+    const Point2d<double> c(24.0, 24.0);
+    CHECK(orient2d(a, b, c) == 0.0);
+    CHECK(orient2d(a, b, Point2d<double>(24.0, 24.0 + 1e-14)) > 0.0);
+    CHECK(orient2d(a, b, Point2d<double>(24.0, 24.0 - 1e-14)) < 0.0);
+
+    // Near-degenerate: Shift the first point by a few ulps along the line and check the sign against the exact answer
+    const double step = std::ldexp(1.0, -53);
+    for (unsigned int i = 0; i < 16; i++)
+    {
+        for (unsigned int j = 0; j < 16; j++)
+        {
+            const Point2d<double> p(0.5 + i * step, 0.5 + j * step);
+            CAPTURE(i, j);
+            CHECK(sign_of(orient2d(p, b, c)) == sign_of(static_cast<int>(j) - static_cast<int>(i)));
+        }
+    }
+
+    const Point2d<float> fa(0.1f, 0.1f);
+    CHECK(orient2d(fa, Point2d<float>(0.2f, 0.2f), Point2d<float>(0.4f, 0.4f)) == 0.0);
+    CHECK(orient2d(fa, Point2d<float>(1.f, 0.f), Point2d<float>(0.f, 1.f)) > 0.0);
+}
+
+TEST_CASE("incircle is exact on co-circular points", "[predicates]")
+{
+    // Corners of a square, far from the origin
+    const double offset = 1e6;
+    const Point2d<double> a(offset, offset);
+    const Point2d<double> b(offset + 0.125, offset);
+    const Point2d<double> c(offset + 0.125, offset + 0.125);
+    const Point2d<double> d(offset, offset + 0.125);
+    CHECK(incircle(a, b, c, d) == 0.0);
+    CHECK(incircle(a, b, c, Point2d<double>(offset + 0.0625, offset + 0.0625)) > 0.0);
+    CHECK(incircle(a, b, c, Point2d<double>(offset - 0.0625, offset + 0.0625)) < 0.0);
+    CHECK(incircle(a, b, c, Point2d<double>(offset, offset + 0.125 + 1e-10)) < 0.0);
+    CHECK(incircle(a, b, c, Point2d<double>(offset, offset + 0.125 - 1e-10)) > 0.0);
+
+    const Point2d<float> fa(0.f, 0.f);
+    CHECK(incircle(fa, Point2d<float>(2.f, 0.f), Point2d<float>(2.f, 2.f), Point2d<float>(0.f, 2.f)) == 0.0);
+}
+
+TEST_CASE("The batched predicates agree with the scalar ones", "[predicates]")
+{
+    const auto check_batches = [](const auto& points) {
+        const std::uint32_t n = static_cast<std::uint32_t>(points.size());
+        graphs::TriangleSoup<std::uint32_t> triangles;
+        std::vector<std::uint32_t> opposite;
+        for (std::uint32_t i = 0; i < n; i += 3)
+        {
+            for (std::uint32_t j = 1; j < n; j += 5)
+            {
+                triangles.emplace_back(i, j, (i * 7 + j * 13) % n);
+                opposite.push_back((i + j * 11) % n);
+            }
+        }
+        std::vector<std::int8_t> orient_out(triangles.size());
+        orient2d_signs(stdutils::make_const_span(points), stdutils::make_const_span(triangles), stdutils::make_span(orient_out));
+        std::size_t nb_zeros = 0;
+        for (std::size_t idx = 0; idx < triangles.size(); idx++)
+        {
+            const auto& t = triangles[idx];
+            CHECK(orient_out[idx] == sign_of(orient2d(points[t[0]], points[t[1]], points[t[2]])));
+            if (orient_out[idx] == 0) { nb_zeros++; }
+            if (orient_out[idx] < 0) { triangles[idx] = graphs::Triangle<std::uint32_t>(t[0], t[2], t[1]); }
+        }
+        CHECK(nb_zeros > 0);        // The grid has collinear triples
+        std::vector<std::int8_t> incircle_out(triangles.size());
+        incircle_signs(stdutils::make_const_span(points), stdutils::make_const_span(triangles), stdutils::make_const_span(opposite), stdutils::make_span(incircle_out));
+        nb_zeros = 0;
+        for (std::size_t idx = 0; idx < triangles.size(); idx++)
+        {
+            const auto& t = triangles[idx];
+            CHECK(incircle_out[idx] == sign_of(incircle(points[t[0]], points[t[1]], points[t[2]], points[opposite[idx]])));
+            if (incircle_out[idx] == 0) { nb_zeros++; }
+        }
+        CHECK(nb_zeros > 0);        // The grid has co-circular quadruples
+    };
+    check_batches(grid_points<double>(12));
+    check_batches(grid_points<float>(12));
+}
+
+} // namespace shapes
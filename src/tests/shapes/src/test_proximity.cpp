@@ -0,0 +1,458 @@
+// Copyright (c) 2023 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <dt/proximity_graphs.h>
+#include <graphs/graph.h>
+#include <graphs/graph_algos.h>
+#include <graphs/proximity.h>
+#include <graphs/union_find.h>
+#include <shapes/bounding_box.h>
+#include <shapes/incremental_proximity.h>
+#include <shapes/point.h>
+#include <shapes/point_cloud.h>
+#include <shapes/proximity_graphs.h>
+#include <shapes/triangle.h>
+#include <shapes/vect.h>
+#include <shapes/voronoi.h>
+#include <stdutils/io.h>
+#include <stdutils/parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace shapes {
+
+namespace {
+namespace tests {
+
+using F = double;
+using I = std::uint32_t;
+
+// Brute-force Delaunay triangulation in O(n^4), only suitable for small point sets in general position
+Triangles2d<F, I> brute_force_delaunay(const Points2d<F>& points)
+{
+    Triangles2d<F, I> result;
+    result.vertices = points;
+    const auto n = static_cast<I>(points.size());
+    for (I i = 0; i < n; i++)
+        for (I j = i + 1; j < n; j++)
+            for (I k = j + 1; k < n; k++)
+            {
+                const auto& a = points[i];
+                const auto& b = points[j];
+                const auto& c = points[k];
+                const F orient = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+                if (orient == F{0}) { continue; }
+                const bool empty_circumcircle = std::none_of(points.cbegin(), points.cend(), [&](const Point2d<F>& d) {
+                    const F adx = a.x - d.x, ady = a.y - d.y;
+                    const F bdx = b.x - d.x, bdy = b.y - d.y;
+                    const F cdx = c.x - d.x, cdy = c.y - d.y;
+                    const F det = (adx * adx + ady * ady) * (bdx * cdy - cdx * bdy)
+                                - (bdx * bdx + bdy * bdy) * (adx * cdy - cdx * ady)
+                                + (cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady);
+                    return orient > F{0} ? det > F{0} : det < F{0};
+                });
+                if (empty_circumcircle) { result.faces.emplace_back(i, j, k); }
+            }
+    return result;
+}
+
+Points2d<F> random_points(std::size_t n, unsigned int seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<F> distrib(F{0}, F{1});
+    Points2d<F> result;
+    result.reserve(n);
+    for (std::size_t idx = 0; idx < n; idx++) { result.emplace_back(distrib(gen), distrib(gen)); }
+    return result;
+}
+
+graphs::EdgeSoup<I> sorted_ordered_edges(const graphs::EdgeSoup<I>& edges)
+{
+    graphs::EdgeSoup<I> result;
+    result.reserve(edges.size());
+    std::transform(edges.cbegin(), edges.cend(), std::back_inserter(result), [](const auto& e) { return graphs::ordered_edge(e); });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+template <typename Func>
+graphs::EdgeSoup<I> naive_proximity_graph(const Triangles2d<F, I>& triangles, Func func)
+{
+    const auto& vertices = triangles.vertices;
+    details::WeightEdges<F, I> edges;
+    for (const auto& e : graphs::to_edge_soup<I>(triangles.faces))
+    {
+        auto& w_edge = edges.emplace_back();
+        w_edge.m_edge = e;
+        w_edge.m_sq_length = shapes::sq_norm(vertices[e.dest()] - vertices[e.orig()]);
+    }
+    const auto graph_end = func(edges.begin(), edges.end(), details::squared_distance<I>(vertices));
+    graphs::EdgeSoup<I> result;
+    std::transform(edges.begin(), graph_end, std::back_inserter(result), [](const auto& w_edge) { return w_edge.edge(); });
+    return result;
+}
+
+} // namespace tests
+} // namespace
+
+TEST_CASE("RNG and GG computed from the Delaunay adjacency match the naive algorithms", "[graphs]")
+{
+    using WeightEdgeIt = details::WeightEdges<tests::F, tests::I>::iterator;
+    const auto naive_rng = [](WeightEdgeIt begin, WeightEdgeIt end, const auto& weight) { return graphs::relative_neighborhood_graph(begin, end, weight); };
+    const auto naive_gg = [](WeightEdgeIt begin, WeightEdgeIt end, const auto& weight) { return graphs::gabriel_graph(begin, end, weight, details::WeightMode); };
+
+    for (unsigned int seed = 0; seed < 5; seed++)
+    {
+        const auto triangles = tests::brute_force_delaunay(tests::random_points(24, seed));
+        REQUIRE(is_valid(triangles));
+        REQUIRE(!triangles.faces.empty());
+
+        const auto rng = relative_neighborhood_graph(triangles);
+        const auto gg = gabriel_graph(triangles);
+        CHECK(tests::sorted_ordered_edges(rng.indices) == tests::sorted_ordered_edges(tests::naive_proximity_graph(triangles, naive_rng)));
+        CHECK(tests::sorted_ordered_edges(gg.indices) == tests::sorted_ordered_edges(tests::naive_proximity_graph(triangles, naive_gg)));
+
+        // MST is a subgraph of the RNG, which is a subgraph of the GG
+        CHECK(rng.indices.size() <= gg.indices.size());
+        CHECK(minimum_spanning_tree(triangles).indices.size() <= rng.indices.size());
+    }
+}
+
+TEST_CASE("Parallel RNG and GG match the sequential ones", "[graphs]")
+{
+    stdutils::parallel::Policy policy;
+    policy.nb_threads = 3;
+    policy.min_chunk_size = 4;
+    for (unsigned int seed = 0; seed < 5; seed++)
+    {
+        const auto triangles = tests::brute_force_delaunay(tests::random_points(40, seed));
+        const auto rng = relative_neighborhood_graph(triangles);
+        const auto gg = gabriel_graph(triangles);
+        const auto rng_par = relative_neighborhood_graph(policy, triangles);
+        const auto gg_par = gabriel_graph(policy, triangles);
+        CHECK(rng_par.indices == rng.indices);
+        CHECK(gg_par.indices == gg.indices);
+        CHECK(rng_par.vertices == triangles.vertices);
+    }
+}
+
+TEST_CASE("Parallel MST matches the sequential MST", "[graphs]")
+{
+    stdutils::parallel::Policy policy;
+    policy.nb_threads = 3;
+    policy.min_chunk_size = 4;
+    for (unsigned int seed = 0; seed < 5; seed++)
+    {
+        // Random points: The edge lengths are distinct and the MST is unique
+        const auto triangles = tests::brute_force_delaunay(tests::random_points(40, seed));
+        const auto mst = minimum_spanning_tree(triangles);
+        const auto mst_par = minimum_spanning_tree(policy, triangles);
+        CHECK(mst.indices.size() == triangles.vertices.size() - 1);
+        CHECK(mst_par.indices.size() == mst.indices.size());
+        CHECK(tests::sorted_ordered_edges(mst_par.indices) == tests::sorted_ordered_edges(mst.indices));
+    }
+}
+
+TEST_CASE("MST of a graph large enough to be sorted with the radix sort", "[graphs]")
+{
+    // Complete graph of random points
+    const auto points = tests::random_points(100, 0);
+    const auto n = static_cast<tests::I>(points.size());
+    std::vector<details::WeightEdge<tests::F, tests::I>> edges;
+    for (tests::I i = 0; i < n; i++)
+        for (tests::I j = i + 1; j < n; j++)
+        {
+            auto& w_edge = edges.emplace_back();
+            w_edge.m_edge = graphs::Edge<tests::I>(i, j);
+            w_edge.m_sq_length = shapes::sq_norm(points[j] - points[i]);
+        }
+    REQUIRE(edges.size() >= graphs::details::radix_sort_threshold);
+
+    // Reference: Comparison sort and Kruskal
+    auto sorted_edges = edges;
+    std::sort(sorted_edges.begin(), sorted_edges.end(), [](const auto& lhs, const auto& rhs) { return lhs.weight() < rhs.weight(); });
+    graphs::UnionFind<tests::I> components(n);
+    const auto ref_end = graphs::details::kruskal(sorted_edges.begin(), sorted_edges.end(), components);
+    graphs::EdgeSoup<tests::I> ref_mst;
+    std::transform(sorted_edges.begin(), ref_end, std::back_inserter(ref_mst), [](const auto& w_edge) { return w_edge.edge(); });
+    REQUIRE(ref_mst.size() == points.size() - 1);
+
+    stdutils::parallel::Policy policy;
+    policy.nb_threads = 3;
+    policy.min_chunk_size = 512;
+    auto mst_edges = edges;
+    const auto mst_end = graphs::minimum_spanning_tree(mst_edges.begin(), mst_edges.end());
+    auto mst_par_edges = edges;
+    const auto mst_par_end = graphs::minimum_spanning_tree(policy, mst_par_edges.begin(), mst_par_edges.end());
+    graphs::EdgeSoup<tests::I> mst;
+    graphs::EdgeSoup<tests::I> mst_par;
+    std::transform(mst_edges.begin(), mst_end, std::back_inserter(mst), [](const auto& w_edge) { return w_edge.edge(); });
+    std::transform(mst_par_edges.begin(), mst_par_end, std::back_inserter(mst_par), [](const auto& w_edge) { return w_edge.edge(); });
+    CHECK(mst == ref_mst);
+    CHECK(tests::sorted_ordered_edges(mst_par) == tests::sorted_ordered_edges(ref_mst));
+}
+
+TEST_CASE("Linear NN matches the NN of the sorted edges", "[graphs]")
+{
+    stdutils::parallel::Policy policy;
+    policy.nb_threads = 3;
+    policy.min_chunk_size = 4;
+    for (unsigned int seed = 0; seed < 5; seed++)
+    {
+        const auto triangles = tests::brute_force_delaunay(tests::random_points(40, seed));
+        auto sorted_edges = details::weight_edges(triangles);
+        std::sort(sorted_edges.begin(), sorted_edges.end(), [](const auto& lhs, const auto& rhs) { return lhs.weight() < rhs.weight(); });
+        const auto sorted_nn_end = graphs::details::nearest_neighbor_sorted(sorted_edges.begin(), sorted_edges.end());
+        graphs::EdgeSoup<tests::I> sorted_nn;
+        std::transform(sorted_edges.begin(), sorted_nn_end, std::back_inserter(sorted_nn), [](const auto& w_edge) { return w_edge.edge(); });
+
+        const auto nn = nearest_neighbor(triangles);
+        const auto nn_par = nearest_neighbor(policy, triangles);
+        CHECK(tests::sorted_ordered_edges(nn.indices) == tests::sorted_ordered_edges(sorted_nn));
+        CHECK(nn_par.indices == nn.indices);
+        CHECK(nn.vertices == triangles.vertices);
+    }
+
+    // Ties: The first of the edges of equal weight is selected, the edges keep their relative order
+    using WEdge = details::WeightEdge<tests::F, tests::I>;
+    std::vector<WEdge> edges(4);
+    const std::pair<tests::I, tests::I> endpoints[] = { {0, 1}, {1, 2}, {2, 3}, {0, 3} };
+    for (std::size_t idx = 0; idx < edges.size(); idx++)
+    {
+        edges[idx].m_edge = graphs::Edge<tests::I>(endpoints[idx].first, endpoints[idx].second);
+        edges[idx].m_sq_length = tests::F{1};
+    }
+    for (const bool parallel : { false, true })
+    {
+        auto copy = edges;
+        const auto nn_end = parallel ? graphs::nearest_neighbor(policy, copy.begin(), copy.end()) : graphs::nearest_neighbor(copy.begin(), copy.end());
+        REQUIRE(nn_end - copy.begin() == 3);
+        CHECK(copy[0].edge() == edges[0].edge());
+        CHECK(copy[1].edge() == edges[1].edge());
+        CHECK(copy[2].edge() == edges[2].edge());
+    }
+}
+
+TEST_CASE("Combined proximity graphs match the individual graphs", "[graphs]")
+{
+    stdutils::parallel::Policy policy;
+    policy.nb_threads = 3;
+    for (unsigned int seed = 0; seed < 3; seed++)
+    {
+        const auto triangles = tests::brute_force_delaunay(tests::random_points(30, seed));
+        for (const auto& all : { proximity_graphs(triangles), proximity_graphs(policy, triangles) })
+        {
+            CHECK(tests::sorted_ordered_edges(all.nn.indices) == tests::sorted_ordered_edges(nearest_neighbor(triangles).indices));
+            CHECK(tests::sorted_ordered_edges(all.mst.indices) == tests::sorted_ordered_edges(minimum_spanning_tree(triangles).indices));
+            CHECK(tests::sorted_ordered_edges(all.rng.indices) == tests::sorted_ordered_edges(relative_neighborhood_graph(triangles).indices));
+            CHECK(tests::sorted_ordered_edges(all.gg.indices) == tests::sorted_ordered_edges(gabriel_graph(triangles).indices));
+            CHECK(tests::sorted_ordered_edges(all.dt.indices) == tests::sorted_ordered_edges(graphs::to_edge_soup<tests::I>(triangles.faces)));
+            CHECK(all.dt.vertices == triangles.vertices);
+        }
+    }
+
+    ProximityGraphsSelection selection;
+    selection.nn = false;
+    selection.dt = false;
+    const auto all = proximity_graphs(policy, tests::brute_force_delaunay(tests::random_points(20, 0)), selection);
+    CHECK(all.nn.indices.empty());
+    CHECK(all.dt.indices.empty());
+    CHECK(!all.mst.indices.empty());
+    CHECK(all.vertices.empty());
+}
+
+TEST_CASE("Combined proximity graphs with shared vertices", "[graphs]")
+{
+    stdutils::parallel::Policy policy;
+    policy.nb_threads = 3;
+    const auto triangles = tests::brute_force_delaunay(tests::random_points(30, 0));
+    ProximityGraphsSelection selection;
+    selection.share_vertices = true;
+    const auto shared = proximity_graphs(policy, triangles, selection);
+    const auto copied = proximity_graphs(policy, triangles);
+    CHECK(shared.vertices == triangles.vertices);
+    for (const auto& [shared_graph, copied_graph] : { std::make_pair(&shared.nn, &copied.nn), std::make_pair(&shared.mst, &copied.mst),
+                                                      std::make_pair(&shared.rng, &copied.rng), std::make_pair(&shared.gg, &copied.gg), std::make_pair(&shared.dt, &copied.dt) })
+    {
+        CHECK(shared_graph->vertices.empty());
+        CHECK(!shared_graph->indices.empty());
+        CHECK(shared_graph->indices == copied_graph->indices);
+    }
+}
+
+TEST_CASE("The proximity hierarchy matches the individual graphs", "[graphs]")
+{
+    const auto prefix = [](const graphs::EdgeSoup<tests::I>& edges, std::size_t count) {
+        return tests::sorted_ordered_edges(graphs::EdgeSoup<tests::I>(edges.cbegin(), edges.cbegin() + static_cast<std::ptrdiff_t>(count)));
+    };
+    for (unsigned int seed = 0; seed < 5; seed++)
+    {
+        const auto triangles = tests::brute_force_delaunay(tests::random_points(30, seed));
+        const auto hierarchy = proximity_hierarchy(triangles);
+        const auto& indices = hierarchy.edges.indices;
+        CHECK(hierarchy.nb_nn_edges <= hierarchy.nb_mst_edges);
+        CHECK(hierarchy.nb_mst_edges <= hierarchy.nb_rng_edges);
+        CHECK(hierarchy.nb_rng_edges <= hierarchy.nb_gg_edges);
+        CHECK(hierarchy.nb_gg_edges <= indices.size());
+        CHECK(prefix(indices, hierarchy.nb_nn_edges) == tests::sorted_ordered_edges(nearest_neighbor(triangles).indices));
+        CHECK(prefix(indices, hierarchy.nb_mst_edges) == tests::sorted_ordered_edges(minimum_spanning_tree(triangles).indices));
+        CHECK(prefix(indices, hierarchy.nb_rng_edges) == tests::sorted_ordered_edges(relative_neighborhood_graph(triangles).indices));
+        CHECK(prefix(indices, hierarchy.nb_gg_edges) == tests::sorted_ordered_edges(gabriel_graph(triangles).indices));
+        CHECK(tests::sorted_ordered_edges(indices) == tests::sorted_ordered_edges(graphs::to_edge_soup<tests::I>(triangles.faces)));
+    }
+    CHECK(proximity_hierarchy(Triangles2d<tests::F, tests::I>()).edges.indices.empty());
+}
+
+TEST_CASE("Incremental proximity graphs match the graphs computed from scratch", "[graphs]")
+{
+    for (unsigned int seed = 0; seed < 3; seed++)
+    {
+        const auto points = tests::random_points(60, seed);
+        Points2d<tests::F> current(points.cbegin(), points.cbegin() + 20);
+        IncrementalProximityGraphs<tests::F, tests::I> incremental(tests::brute_force_delaunay(current));
+        std::size_t nb_inserted = 0;
+        for (std::size_t idx = current.size(); idx < points.size(); idx++)
+        {
+            current.push_back(points[idx]);
+            if (incremental.insert(points[idx]))
+            {
+                nb_inserted++;
+                CHECK(incremental.latest_stats().nb_cavity_faces > 0);
+            }
+            else
+            {
+                // Outside of the convex hull: The caller starts over
+                incremental = IncrementalProximityGraphs<tests::F, tests::I>(tests::brute_force_delaunay(current));
+            }
+            REQUIRE(incremental.nb_vertices() == current.size());
+        }
+        CHECK(nb_inserted > 20);
+        const auto triangulation = incremental.triangulation();
+        CHECK(graphs::is_valid(triangulation.adjacency, triangulation.faces));
+
+        const auto expected = proximity_graphs(tests::brute_force_delaunay(current));
+        const auto actual = incremental.graphs();
+        CHECK(tests::sorted_ordered_edges(actual.dt.indices) == tests::sorted_ordered_edges(expected.dt.indices));
+        CHECK(tests::sorted_ordered_edges(actual.gg.indices) == tests::sorted_ordered_edges(expected.gg.indices));
+        CHECK(tests::sorted_ordered_edges(actual.rng.indices) == tests::sorted_ordered_edges(expected.rng.indices));
+        CHECK(tests::sorted_ordered_edges(actual.mst.indices) == tests::sorted_ordered_edges(expected.mst.indices));
+        CHECK(tests::sorted_ordered_edges(actual.nn.indices) == tests::sorted_ordered_edges(expected.nn.indices));
+        CHECK(actual.dt.vertices == current);
+    }
+}
+
+TEST_CASE("Incremental proximity graphs skip the points they cannot insert locally", "[graphs]")
+{
+    const auto points = tests::random_points(20, 3);
+    IncrementalProximityGraphs<tests::F, tests::I> incremental(tests::brute_force_delaunay(points));
+    const auto before = incremental.graphs();
+    CHECK(!incremental.insert(Point2d<tests::F>(tests::F{2}, tests::F{2})));        // Outside of the convex hull
+    CHECK(!incremental.insert(points[5]));                                          // Duplicate
+    CHECK(incremental.nb_vertices() == points.size());
+    CHECK(tests::sorted_ordered_edges(incremental.graphs().mst.indices) == tests::sorted_ordered_edges(before.mst.indices));
+
+    IncrementalProximityGraphs<tests::F, tests::I> empty(Triangles2d<tests::F, tests::I>{});
+    CHECK(!empty.insert(Point2d<tests::F>(tests::F{0}, tests::F{0})));
+}
+
+TEST_CASE("Voronoi diagram of a Delaunay triangulation", "[graphs]")
+{
+    using F = tests::F;
+    using I = tests::I;
+    auto triangles = tests::brute_force_delaunay(tests::random_points(40, 17));
+    triangles.adjacency = graphs::triangle_adjacency(triangles.faces);
+    const auto nb_dt_edges = graphs::to_edge_soup<I>(triangles.faces).size();
+
+    for (const bool large_box : { true, false })
+    {
+        BoundingBox2d<F> clip_box;
+        if (large_box) { clip_box.add(F{-1000}, F{-1000}).add(F{1000}, F{1000}); }
+        else { clip_box.add(F{0.2}, F{0.3}).add(F{0.8}, F{0.7}); }
+        const auto voronoi = voronoi_diagram(stdutils::parallel::Policy{ 4, 8 }, triangles, clip_box);
+        const auto& vertices = voronoi.edges.vertices;
+        REQUIRE(voronoi.sites.size() == voronoi.edges.indices.size());
+        if (large_box) { CHECK(voronoi.sites.size() == nb_dt_edges); }
+        else { CHECK(voronoi.sites.size() < nb_dt_edges); }
+        for (const auto& p : vertices)
+        {
+            CHECK(clip_box.rx.min <= p.x);
+            CHECK(p.x <= clip_box.rx.max);
+            CHECK(clip_box.ry.min <= p.y);
+            CHECK(p.y <= clip_box.ry.max);
+        }
+        for (std::size_t e = 0; e < voronoi.sites.size(); e++)
+        {
+            // The Voronoi edge is equidistant to its two sites, which are the nearest sites of its points
+            const auto& edge = voronoi.edges.indices[e];
+            const auto& a = vertices[edge.orig()];
+            const auto& b = vertices[edge.dest()];
+            const Point2d<F> mid((a.x + b.x) / F{2}, (a.y + b.y) / F{2});
+            const F dist_0 = norm(triangles.vertices[voronoi.sites[e].orig()] - mid);
+            const F dist_1 = norm(triangles.vertices[voronoi.sites[e].dest()] - mid);
+            CHECK(std::abs(dist_0 - dist_1) < 1e-9 * (F{1} + dist_0));
+            for (const auto& site : triangles.vertices) { CHECK(norm(site - mid) >= dist_0 - 1e-9 * (F{1} + dist_0)); }
+        }
+    }
+}
+
+TEST_CASE("k-NN graph matches the brute force", "[graphs]")
+{
+    using F = tests::F;
+    using I = tests::I;
+    const stdutils::io::ErrorHandler err_handler = [](stdutils::io::SeverityCode code, stdutils::io::ErrorMessage msg) {
+        if (code <= stdutils::io::Severity::ERR) { FAIL(std::string(msg)); }
+    };
+    PointCloud2d<F> pc;
+    pc.vertices = tests::random_points(200, 23);
+    for (std::size_t idx = 0; idx < 20; idx++) { pc.vertices.push_back(pc.vertices[3 * idx]); }     // Duplicated points
+    pc.vertices.push_back(pc.vertices[0]);
+
+    for (const std::size_t k : { std::size_t{1}, std::size_t{4}, std::size_t{8} })
+    {
+        CAPTURE(k);
+        // The k nearest neighbors of each point, other than itself. The ties, e.g. between duplicated points, are broken by the index.
+        std::vector<std::pair<I, I>> expected;
+        for (std::size_t idx = 0; idx < pc.vertices.size(); idx++)
+        {
+            std::vector<std::pair<F, I>> candidates;
+            for (std::size_t other = 0; other < pc.vertices.size(); other++)
+            {
+                if (other == idx) { continue; }
+                const auto d = pc.vertices[other] - pc.vertices[idx];
+                candidates.emplace_back(d.x * d.x + d.y * d.y, static_cast<I>(other));
+            }
+            std::sort(candidates.begin(), candidates.end());
+            for (std::size_t j = 0; j < k; j++)
+            {
+                const auto n = candidates[j].second;
+                expected.emplace_back(std::min(static_cast<I>(idx), n), std::max(static_cast<I>(idx), n));
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+        expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+        const auto knn = delaunay::k_nearest_neighbors<Point2d<F>, I>(stdutils::parallel::Policy{ 4, 16 }, pc, k, err_handler);
+        CHECK(knn.vertices == pc.vertices);
+        std::vector<std::pair<I, I>> actual;
+        for (const auto& e : knn.indices)
+        {
+            CHECK(e.orig() < e.dest());
+            actual.emplace_back(e.orig(), e.dest());
+        }
+        std::sort(actual.begin(), actual.end());
+        CHECK(actual.size() == knn.indices.size());         // No duplicated edge
+        actual.erase(std::unique(actual.begin(), actual.end()), actual.end());
+        CHECK(actual.size() == knn.indices.size());
+        CHECK(actual == expected);
+    }
+}
+
+} // namespace shapes
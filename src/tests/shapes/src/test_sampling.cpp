@@ -8,12 +8,15 @@
 #include <shapes/sampling.h>
 #include <shapes/path.h>
 #include <stdutils/io.h>
+#include <stdutils/parallel.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <iomanip>
 #include <vector>
 #include <sstream>
+#include <stack>
 #include <string>
 #include <type_traits>
 
@@ -206,4 +209,270 @@ TEST_CASE("Casteljau sampling of a CBP", "[sampling]")
     }
 }
 
+namespace {
+
+// The previous implementation of the Casteljau sampling, with a std::stack of CasteljauCubicBezier2d: The reference for the test and the benchmark below
+template <typename F>
+PointPath2d<F> reference_casteljau_sampling(const CubicBezierPath2d<F>& cbp, F resolution_length)
+{
+    const F resolution_sq = resolution_length * resolution_length;
+    const std::size_t nb_vertices = cbp.vertices.size();
+    PointPath2d<F> pp;
+    pp.closed = cbp.closed;
+    std::stack<CasteljauCubicBezier2d<F>> split_stack;
+    for (std::size_t seg_idx = 0; seg_idx < nb_segments(cbp); seg_idx++)
+    {
+        std::array<Vect2d<F>, 4> segment;
+        for (std::size_t i = 0; i < 4; i++) { segment[i] = cbp.vertices[(3 * seg_idx + i) % nb_vertices]; }
+        split_stack.emplace(CubicBezierMap2d<F>(&segment[0]));
+        while (!split_stack.empty())
+        {
+            auto& casteljau = split_stack.top();
+            if (details::casteljau_split_predicate(casteljau.bezier().cps(), resolution_sq))
+            {
+                CasteljauCubicBezier2d<F> casteljau_split0(casteljau.split0());
+                CasteljauCubicBezier2d<F> casteljau_split1(casteljau.split1());
+                std::swap(casteljau, casteljau_split1);
+                split_stack.emplace(std::move(casteljau_split0));
+            }
+            else
+            {
+                pp.vertices.emplace_back(casteljau.bezier().first());
+                split_stack.pop();
+            }
+        }
+    }
+    if (!cbp.closed) { pp.vertices.emplace_back(cbp.vertices.back()); }
+    return pp;
+}
+
+template <typename F>
+CubicBezierPath2d<F> test_zigzag_cbp(std::size_t nb_segs, bool closed)
+{
+    CubicBezierPath2d<F> cbp;
+    cbp.closed = closed;
+    for (std::size_t idx = 0; idx < 3 * nb_segs + (closed ? 0 : 1); idx++)
+    {
+        const F x = static_cast<F>(idx);
+        cbp.vertices.emplace_back(x, (idx % 3 == 1) ? F{2} : (idx % 3 == 2 ? F{-1} : F{0}));
+    }
+    return cbp;
+}
+
+} // namespace
+
+TEST_CASE("Casteljau sampling matches the reference implementation", "[sampling]")
+{
+    using F = double;
+    for (const bool closed : { false, true })
+    {
+        CAPTURE(closed);
+        const auto cbp = test_zigzag_cbp<F>(20, closed);
+        shapes::CasteljauSamplingCubicBezier2d<F> sampler;
+        for (const auto resolution : std::vector<F> { 0.1, 0.01, 0.001 })
+        {
+            CAPTURE(resolution);
+            const auto pp = sampler.sample(cbp, resolution);
+            const auto ref_pp = reference_casteljau_sampling(cbp, resolution);
+            CHECK(pp.closed == ref_pp.closed);
+            CHECK(pp.vertices == ref_pp.vertices);
+        }
+    }
+}
+
+TEST_CASE("Benchmark the Casteljau sampling", "[sampling][benchmark]")
+{
+    using F = double;
+    const auto cbp = test_zigzag_cbp<F>(1000, true);
+    shapes::CasteljauSamplingCubicBezier2d<F> sampler;
+
+    BENCHMARK("Reference implementation")
+    {
+        return reference_casteljau_sampling(cbp, 0.001);
+    };
+
+    BENCHMARK("Explicit stack implementation")
+    {
+        return sampler.sample(cbp, 0.001);
+    };
+}
+
+TEST_CASE("Polynomial evaluation of cubic Bezier maps", "[sampling]")
+{
+    using F = double;
+    const std::array<Vect2d<F>, 4> cps = { Vect2d<F>(0.0, 0.0), Vect2d<F>(1.0, 2.0), Vect2d<F>(3.0, -1.0), Vect2d<F>(4.0, 1.0) };
+    const CubicBezierMap2d<F> bezier(cps.data());
+    const CubicBezierPolynomial2d<F> poly(bezier);
+
+    constexpr std::size_t n = 64;
+    std::vector<Vect2d<F>> samples(n + 1);
+    poly.uniform_samples(n, samples.data());
+    for (std::size_t i = 0; i <= n; i++)
+    {
+        CAPTURE(i);
+        const F t = static_cast<F>(i) / static_cast<F>(n);
+        CHECK(norm(poly.at(t) - bezier.at(static_cast<float>(t))) < 1.e-6);
+        CHECK(norm(samples[i] - poly.at(t)) < 1.e-12);
+    }
+    CHECK(norm(samples.front() - cps[0]) == 0.0);
+    CHECK(norm(samples.back() - cps[3]) < 1.e-12);
+
+    const std::array<Vect2d<F>, 3> derivate_cps = { F{3} * (cps[1] - cps[0]), F{3} * (cps[2] - cps[1]), F{3} * (cps[3] - cps[2]) };
+    const QuadraticBezierMap2d<F> derivate_bezier(derivate_cps.data());
+    const QuadraticBezierPolynomial2d<F> derivate_poly(derivate_bezier);
+    for (const F t : { 0.0, 0.1, 0.25, 0.5, 0.9, 1.0 })
+    {
+        CAPTURE(t);
+        CHECK(norm(derivate_poly.at(t) - derivate_bezier.at(static_cast<float>(t))) < 1.e-5);
+    }
+}
+
+TEST_CASE("Parallel sampling of a CBP", "[sampling]")
+{
+    using F = double;
+    for (const bool closed : { false, true })
+    {
+        CAPTURE(closed);
+        const std::size_t nb_segs = 37;
+        const auto cbp = test_zigzag_cbp<F>(nb_segs, closed);
+        REQUIRE(nb_segments(cbp) == nb_segs);
+
+        stdutils::parallel::Policy policy;
+        policy.nb_threads = 4;
+        policy.min_chunk_size = 5;
+
+        SECTION("Casteljau")
+        {
+            shapes::CasteljauSamplingCubicBezier2d<F> sampler;
+            const auto pp_serial = sampler.sample(cbp, 0.01);
+            const auto pp_parallel = sampler.sample(policy, cbp, 0.01);
+            CHECK(pp_parallel.closed == pp_serial.closed);
+            CHECK(pp_parallel.vertices == pp_serial.vertices);
+        }
+        SECTION("Uniform")
+        {
+            UniformSamplingCubicBezier2d<F> serial_sampler(cbp);
+            UniformSamplingCubicBezier2d<F> parallel_sampler(policy, cbp);
+            CHECK(parallel_sampler.max_segment_length() == serial_sampler.max_segment_length());
+            const auto pp_serial = serial_sampler.sample(0.1);
+            const auto pp_parallel = parallel_sampler.sample(0.1);
+            CHECK(pp_parallel.closed == pp_serial.closed);
+            CHECK(pp_parallel.vertices == pp_serial.vertices);
+        }
+    }
+}
+
+TEST_CASE("Resample the edited segments of a CBP", "[sampling]")
+{
+    using F = double;
+    for (const bool closed : { false, true })
+    {
+        CAPTURE(closed);
+        const std::size_t nb_segs = 37;
+        auto cbp = test_zigzag_cbp<F>(nb_segs, closed);
+
+        stdutils::parallel::Policy policy;
+        policy.nb_threads = 4;
+        policy.min_chunk_size = 5;
+        UniformSamplingCubicBezier2d<F> uniform_sampler(policy, cbp);
+        auto uniform_pp = uniform_sampler.sample(0.1);
+        shapes::CasteljauSamplingCubicBezier2d<F> casteljau_sampler;
+        std::vector<std::size_t> segment_offsets;
+        auto casteljau_pp = casteljau_sampler.sample(cbp, 0.01, segment_offsets);
+        CHECK(casteljau_pp.vertices == casteljau_sampler.sample(cbp, 0.01).vertices);
+        REQUIRE(segment_offsets.size() == nb_segs + 1);
+
+        // A control point inside of a segment, an endpoint shared by two segments, and the first vertex of the path
+        const std::size_t last_seg = nb_segs - 1;
+        // With a closed CBP, the segments of the first vertex are not contiguous: They are updated one after the other.
+        struct Edit { std::size_t vertex_idx; F dy; std::size_t begin_seg; std::size_t end_seg; };
+        std::vector<Edit> edits = { { 31, F{3}, 10, 11 }, { 60, F{3}, 19, 21 }, { 0, F{3}, 0, 1 } };
+        if (closed) { edits.push_back(Edit{ 0, F{0}, last_seg, nb_segs }); }
+        else { edits.push_back(Edit{ cbp.vertices.size() - 1, F{3}, last_seg, nb_segs }); }
+        for (const auto& edit : edits)
+        {
+            CAPTURE(edit.vertex_idx);
+            cbp.vertices[edit.vertex_idx].y += edit.dy;
+            uniform_sampler.update_segments(cbp, edit.begin_seg, edit.end_seg);
+            uniform_sampler.resample_segments(0.1, edit.begin_seg, edit.end_seg, uniform_pp);
+            casteljau_sampler.resample_segments(cbp, 0.01, edit.begin_seg, edit.end_seg, casteljau_pp, segment_offsets);
+        }
+
+        const UniformSamplingCubicBezier2d<F> new_uniform_sampler(policy, cbp);
+        CHECK(uniform_sampler.max_segment_length() == new_uniform_sampler.max_segment_length());
+        const auto new_uniform_pp = new_uniform_sampler.sample(0.1);
+        CHECK(uniform_pp.closed == new_uniform_pp.closed);
+        CHECK(uniform_pp.vertices == new_uniform_pp.vertices);
+        CHECK(uniform_sampler.sample(0.1).vertices == new_uniform_pp.vertices);
+
+        std::vector<std::size_t> new_segment_offsets;
+        const auto new_casteljau_pp = casteljau_sampler.sample(cbp, 0.01, new_segment_offsets);
+        CHECK(casteljau_pp.closed == new_casteljau_pp.closed);
+        CHECK(casteljau_pp.vertices == new_casteljau_pp.vertices);
+        CHECK(segment_offsets == new_segment_offsets);
+    }
+}
+
+TEST_CASE("Parallel uniform sampling of a point path", "[sampling]")
+{
+    using F = double;
+    for (const bool closed : { false, true })
+    {
+        CAPTURE(closed);
+        PointPath2d<F> pp;
+        pp.closed = closed;
+        for (unsigned int idx = 0; idx < 53; idx++)
+            pp.vertices.emplace_back(static_cast<F>(idx), static_cast<F>(idx % 3));
+        const std::size_t nb_segs = nb_edges(pp);
+
+        stdutils::parallel::Policy policy;
+        policy.nb_threads = 4;
+        policy.min_chunk_size = 5;
+        UniformSamplingPointPath2d<F> serial_sampler(pp);
+        UniformSamplingPointPath2d<F> parallel_sampler(policy, pp);
+        CHECK(parallel_sampler.max_segment_length() == serial_sampler.max_segment_length());
+        const auto pp_serial = serial_sampler.sample(0.1);
+        const auto pp_parallel = parallel_sampler.sample(0.1);
+        CHECK(pp_parallel.closed == pp_serial.closed);
+        CHECK(pp_parallel.vertices == pp_serial.vertices);
+
+        // The input vertices are samples, and the edges of the output are within the sampling length
+        REQUIRE(pp_serial.vertices.size() > pp.vertices.size());
+        CHECK(pp_serial.vertices.front() == pp.vertices.front());
+        if (!closed) { CHECK(pp_serial.vertices.back() == pp.vertices.back()); }
+        CHECK(nb_edges(pp_serial) >= 10 * nb_segs);
+        CHECK(path_normalized_uniformity_stats(pp_serial).max <= 1.5);
+    }
+}
+
+TEST_CASE("Parallel uniformity stats", "[sampling]")
+{
+    using F = double;
+    const auto cbp = test_zigzag_cbp<F>(37, true);
+    const auto pp = CasteljauSamplingCubicBezier2d<F>().sample(cbp, 0.01);
+    REQUIRE(shapes::nb_edges(pp) > 100);
+
+    stdutils::parallel::Policy policy;
+    policy.nb_threads = 4;
+    policy.min_chunk_size = 16;
+    const auto serial_stats = path_normalized_uniformity_stats(pp);
+    const auto parallel_stats = path_normalized_uniformity_stats(policy, pp);
+    CHECK(parallel_stats.n == serial_stats.n);
+    CHECK_THAT(parallel_stats.min, Catch::Matchers::WithinRel(serial_stats.min, 1e-12));
+    CHECK_THAT(parallel_stats.max, Catch::Matchers::WithinRel(serial_stats.max, 1e-12));
+    CHECK_THAT(parallel_stats.mean, Catch::Matchers::WithinRel(serial_stats.mean, 1e-12));
+    CHECK_THAT(parallel_stats.stdev, Catch::Matchers::WithinAbs(serial_stats.stdev, 1e-9));
+
+    io::ShapeAggregate<F> shapes;
+    shapes.emplace_back(AllShapes<F>(pp));
+    shapes.emplace_back(AllShapes<F>(cbp));
+    shapes.emplace_back(AllShapes<F>(PointPath2d<F>()));
+    const auto batch_stats = paths_normalized_uniformity_stats(policy, shapes);
+    REQUIRE(batch_stats.size() == 3);
+    CHECK(batch_stats[0].n == serial_stats.n);
+    CHECK(batch_stats[0].stdev == serial_stats.stdev);
+    CHECK(batch_stats[1].n == 0);
+    CHECK(batch_stats[2].n == 0);
+}
+
 } // namespace shapes
@@ -2,14 +2,24 @@
 // This code is distributed under the terms of the MIT License
 #include <catch_amalgamated.hpp>
 
+#include <graphs/index.h>
+#include <graphs/triangulation.h>
 #include <shapes/conversion.h>
+#include <shapes/hash.h>
+#include <shapes/memory.h>
 #include <shapes/shapes.h>
+#include <shapes/triangle_algos.h>
+#include <stdutils/parallel.h>
 
 #include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <sstream>
 #include <string>
 #include <type_traits>
+#include <variant>
 
 namespace shapes {
 
@@ -140,4 +150,253 @@ TEST_CASE("Generic functions on AllShapes variant", "[shapes]")
     CHECK(nb_faces(s) == 1);
 }
 
+TEST_CASE("Byte size of the shapes", "[shapes]")
+{
+    AllShapes<double> s;
+
+    s = test_point_cloud_2d<double>();
+    CHECK(byte_size(s) >= 3 * sizeof(Point2d<double>));
+
+    s = test_cbp_3d<double>();
+    CHECK(byte_size(s) >= 4 * sizeof(Point3d<double>));
+
+    const auto triangles = test_triangles_2d<double>();
+    s = triangles;
+    CHECK(byte_size(s) == byte_size(std::get<Triangles2d<double>>(s)));
+    CHECK(byte_size(triangles) >= 3 * sizeof(Point2d<double>) + sizeof(Triangles2d<double>::face));
+
+    Soup2d<double> soup;
+    CHECK(byte_size(soup) == 0);
+    soup.point_cloud = test_point_cloud_2d<double>();
+    soup.triangles = triangles;
+    CHECK(byte_size(soup) == byte_size(soup.point_cloud) + byte_size(soup.triangles));
+}
+
+TEST_CASE("Content hash of the shapes", "[shapes]")
+{
+    const AllShapes<double> pc = test_point_cloud_2d<double>();
+    CHECK(content_hash(pc) == content_hash(AllShapes<double>(test_point_cloud_2d<double>())));
+
+    // Same vertices, different type
+    PointPath2d<double> pp;
+    pp.vertices = std::get<PointCloud2d<double>>(pc).vertices;
+    pp.closed = false;
+    CHECK(content_hash(AllShapes<double>(pp)) != content_hash(pc));
+
+    // Closed flag, one coordinate, signed zero
+    auto other_pp = pp;
+    other_pp.closed = true;
+    CHECK(content_hash(other_pp) != content_hash(pp));
+    other_pp = pp;
+    other_pp.vertices.back().x += 1.0;
+    CHECK(content_hash(other_pp) != content_hash(pp));
+    other_pp = pp;
+    other_pp.vertices.emplace_back(0.0, 0.0);
+    auto negative_zero_pp = pp;
+    negative_zero_pp.vertices.emplace_back(-0.0, 0.0);
+    CHECK(content_hash(other_pp) == content_hash(negative_zero_pp));
+
+    // Faces
+    const auto triangles = test_triangles_2d<double>();
+    auto other_triangles = triangles;
+    other_triangles.faces.front() = Triangles2d<double>::face(1, 0, 2);
+    CHECK(content_hash(AllShapes<double>(triangles)) == content_hash(AllShapes<double>(test_triangles_2d<double>())));
+    CHECK(content_hash(other_triangles) != content_hash(triangles));
+}
+
+TEST_CASE("Triangles with 64-bit indices", "[shapes]")
+{
+    Triangles2d<double, std::uint64_t> triangles;
+    triangles.vertices.emplace_back(0.0, 0.0);
+    triangles.vertices.emplace_back(1.0, 0.0);
+    triangles.vertices.emplace_back(0.0, 1.0);
+    triangles.faces.emplace_back(0, 1, 2);
+    CHECK(is_valid(triangles));
+    CHECK(nb_edges(triangles) == 3);
+    triangles.faces.emplace_back(0, 1, std::uint64_t{1} << 32);
+    CHECK(is_valid(triangles) == false);
+}
+
+namespace {
+
+// Regular grid of n x n cells, each split in two triangles. One in two faces is clockwise.
+Triangles2d<double> test_grid_triangulation(std::uint32_t n)
+{
+    Triangles2d<double> result;
+    for (std::uint32_t j = 0; j <= n; j++)
+        for (std::uint32_t i = 0; i <= n; i++)
+            result.vertices.emplace_back(static_cast<double>(i), static_cast<double>(j));
+    const auto v = [n](std::uint32_t i, std::uint32_t j) { return j * (n + 1) + i; };
+    for (std::uint32_t j = 0; j < n; j++)
+        for (std::uint32_t i = 0; i < n; i++)
+        {
+            result.faces.emplace_back(v(i, j), v(i + 1, j), v(i + 1, j + 1));
+            result.faces.emplace_back(v(i, j), v(i, j + 1), v(i + 1, j + 1));
+        }
+    result.adjacency = graphs::triangle_adjacency(result.faces);
+    return result;
+}
+
+bool face_contains(const Triangles2d<double>& triangles, std::uint32_t f, const Point2d<double>& p)
+{
+    const auto orient = [](const Point2d<double>& a, const Point2d<double>& b, const Point2d<double>& c) { return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x); };
+    const auto& t = triangles.faces[f];
+    const auto& a = triangles.vertices[t[0]];
+    const auto& b = triangles.vertices[t[1]];
+    const auto& c = triangles.vertices[t[2]];
+    const double s = orient(a, b, c) > 0.0 ? 1.0 : -1.0;
+    return s * orient(a, b, p) >= 0.0 && s * orient(b, c, p) >= 0.0 && s * orient(c, a, p) >= 0.0;
+}
+
+} // namespace
+
+TEST_CASE("Point location in a triangulation", "[shapes]")
+{
+    constexpr std::uint32_t n = 40;
+    const auto triangles = test_grid_triangulation(n);
+    TriangleLocator<double> locator(triangles);
+    CHECK(graphs::is_defined(locator.latest_face()) == false);
+
+    // Walk along a line: The consecutive queries are close to each other
+    std::size_t total_nb_steps = 0;
+    for (unsigned int k = 0; k < 200; k++)
+    {
+        const Point2d<double> p(0.1 + 0.19 * static_cast<double>(k), 0.3 + 0.17 * static_cast<double>(k % 100));
+        const auto f = locator.locate(p);
+        REQUIRE(graphs::is_defined(f));
+        CHECK(face_contains(triangles, f, p));
+        CHECK(locator.latest_face() == f);
+        total_nb_steps += locator.latest_nb_steps();
+    }
+    CHECK(total_nb_steps < 200 * 10);
+
+    // On a vertex, and outside of the triangulation
+    const auto f = locator.locate(Point2d<double>(3.0, 5.0));
+    REQUIRE(graphs::is_defined(f));
+    CHECK(face_contains(triangles, f, Point2d<double>(3.0, 5.0)));
+    CHECK(graphs::is_defined(locator.locate(Point2d<double>(-1.0, 5.0))) == false);
+    CHECK(graphs::is_defined(locator.locate(Point2d<double>(20.0, 40.5))) == false);
+    CHECK(locator.latest_face() == f);
+}
+
+TEST_CASE("Renumbering of a triangulation along a Hilbert curve", "[shapes]")
+{
+    constexpr std::uint32_t n = 20;
+    const auto original = test_grid_triangulation(n);
+    auto triangles = original;
+    const auto permutation = renumber_along_hilbert_curve(triangles);
+    REQUIRE(permutation.vertex_order.size() == original.vertices.size());
+    REQUIRE(permutation.face_order.size() == original.faces.size());
+    CHECK(is_valid(triangles));
+    CHECK(graphs::is_valid(triangles.adjacency, triangles.faces));
+
+    // Same faces, with the vertices and the faces permuted
+    for (std::size_t idx = 0; idx < triangles.vertices.size(); idx++)
+    {
+        CHECK(triangles.vertices[idx] == original.vertices[permutation.vertex_order[idx]]);
+    }
+    for (std::size_t idx = 0; idx < triangles.faces.size(); idx++)
+    {
+        const auto& face = triangles.faces[idx];
+        const auto& original_face = original.faces[permutation.face_order[idx]];
+        for (std::size_t k = 0; k < 3; k++) { CHECK(triangles.vertices[face[k]] == original.vertices[original_face[k]]); }
+    }
+
+    // Consecutive vertices along the curve are close in the grid
+    double total_distance = 0.0;
+    for (std::size_t idx = 1; idx < triangles.vertices.size(); idx++)
+    {
+        const auto& p = triangles.vertices[idx - 1];
+        const auto& q = triangles.vertices[idx];
+        total_distance += std::abs(p.x - q.x) + std::abs(p.y - q.y);
+    }
+    CHECK(total_distance / static_cast<double>(triangles.vertices.size() - 1) < 1.5);
+
+    // Empty
+    Triangles2d<double> empty;
+    CHECK(renumber_along_hilbert_curve(empty).vertex_order.empty());
+}
+
+TEST_CASE("Quality and size statistics of a triangulation", "[shapes]")
+{
+    constexpr std::uint32_t n = 20;
+    auto triangles = test_grid_triangulation(n);
+    stdutils::parallel::Policy parallel;
+    parallel.nb_threads = 4;
+    parallel.min_chunk_size = 64;
+
+    // Half squares
+    const auto stats = triangulation_stats(parallel, triangles);
+    CHECK(stats.nb_degenerate_faces == 0);
+    CHECK(stats.min_angle.n == 2 * n * n);
+    CHECK_THAT(stats.min_angle.min, Catch::Matchers::WithinRel(45.0, 1e-9));
+    CHECK_THAT(stats.min_angle.max, Catch::Matchers::WithinRel(45.0, 1e-9));
+    CHECK_THAT(stats.aspect_ratio.mean, Catch::Matchers::WithinRel((1.0 + std::sqrt(2.0)) / 2.0, 1e-9));
+    CHECK_THAT(stats.area.mean, Catch::Matchers::WithinRel(0.5, 1e-9));
+    CHECK_THAT(stats.area.stdev, Catch::Matchers::WithinAbs(0.0, 1e-6));
+    const std::size_t nb_axis_edges = 2 * n * (n + 1);
+    const std::size_t nb_diagonals = n * n;
+    CHECK(stats.edge_length.n == nb_axis_edges + nb_diagonals);
+    CHECK_THAT(stats.edge_length.min, Catch::Matchers::WithinRel(1.0, 1e-9));
+    CHECK_THAT(stats.edge_length.max, Catch::Matchers::WithinRel(std::sqrt(2.0), 1e-9));
+    CHECK_THAT(stats.edge_length.mean, Catch::Matchers::WithinRel((static_cast<double>(nb_axis_edges) + std::sqrt(2.0) * static_cast<double>(nb_diagonals)) / static_cast<double>(nb_axis_edges + nb_diagonals), 1e-9));
+
+    // Without the adjacency, each face samples its three edges
+    triangles.adjacency.clear();
+    CHECK(triangulation_stats(parallel, triangles).edge_length.n == 3 * 2 * n * n);
+
+    // An equilateral triangle and a degenerate one
+    Triangles2d<double> two_faces;
+    two_faces.vertices.emplace_back(0.0, 0.0);
+    two_faces.vertices.emplace_back(2.0, 0.0);
+    two_faces.vertices.emplace_back(1.0, std::sqrt(3.0));
+    two_faces.vertices.emplace_back(4.0, 0.0);
+    two_faces.faces.emplace_back(0, 1, 2);
+    two_faces.faces.emplace_back(0, 1, 3);
+    const auto two_faces_stats = triangulation_stats(stdutils::parallel::Policy(), two_faces);
+    CHECK(two_faces_stats.nb_degenerate_faces == 1);
+    CHECK(two_faces_stats.aspect_ratio.n == 1);
+    CHECK_THAT(two_faces_stats.aspect_ratio.mean, Catch::Matchers::WithinRel(1.0, 1e-9));
+    CHECK(two_faces_stats.min_angle.n == 2);
+    CHECK_THAT(two_faces_stats.min_angle.min, Catch::Matchers::WithinAbs(0.0, 1e-12));
+    CHECK_THAT(two_faces_stats.min_angle.max, Catch::Matchers::WithinRel(60.0, 1e-9));
+    CHECK_THAT(two_faces_stats.area.max, Catch::Matchers::WithinRel(std::sqrt(3.0), 1e-9));
+
+    // Empty
+    CHECK(triangulation_stats(parallel, Triangles2d<double>()).min_angle.n == 0);
+}
+
+TEST_CASE("Point location in a triangulation with a hole", "[shapes]")
+{
+    constexpr std::uint32_t n = 10;
+    auto triangles = test_grid_triangulation(n);
+
+    // Remove the cells of the two middle columns, except for the top row
+    Triangles2d<double> holed = triangles;
+    holed.faces.clear();
+    for (std::size_t f = 0; f < triangles.faces.size(); f++)
+    {
+        const std::size_t cell_i = (f / 2) % n;
+        const std::size_t cell_j = (f / 2) / n;
+        if ((cell_i == 4 || cell_i == 5) && cell_j + 1 < n) { continue; }
+        holed.faces.push_back(triangles.faces[f]);
+    }
+    holed.adjacency = graphs::triangle_adjacency(holed.faces);
+    TriangleLocator<double> locator(holed);
+    for (double y = 0.25; y < static_cast<double>(n); y += 0.5)
+        for (double x = 0.25; x < static_cast<double>(n); x += 0.5)
+        {
+            const Point2d<double> p(x, y);
+            const auto f = locator.locate(p);
+            const bool in_hole = x > 4.0 && x < 6.0 && y < static_cast<double>(n - 1);
+            CHECK(graphs::is_defined(f) == !in_hole);
+            if (graphs::is_defined(f)) { CHECK(face_contains(holed, f, p)); }
+        }
+
+    // Empty
+    const Triangles2d<double> empty;
+    TriangleLocator<double> empty_locator(empty);
+    CHECK(graphs::is_defined(empty_locator.locate(Point2d<double>(0.0, 0.0))) == false);
+}
+
 } // namespace shapes
@@ -0,0 +1,161 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <graphs/index.h>
+#include <shapes/bounding_box.h>
+#include <shapes/generators.h>
+#include <shapes/point.h>
+#include <shapes/spatial_index.h>
+#include <stdutils/parallel.h>
+#include <stdutils/span.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace shapes {
+
+namespace {
+namespace tests {
+
+using F = double;
+using I = std::uint32_t;
+
+F sq_dist(const Point2d<F>& p, const Point2d<F>& q)
+{
+    const F dx = p.x - q.x;
+    const F dy = p.y - q.y;
+    return dx * dx + dy * dy;
+}
+
+// Brute-force k nearest neighbors, ordered by (squared distance, index)
+std::vector<I> brute_force_k_nearest(const Points2d<F>& points, const Point2d<F>& q, std::size_t k)
+{
+    std::vector<std::pair<F, I>> candidates;
+    for (std::size_t idx = 0; idx < points.size(); idx++) { candidates.emplace_back(sq_dist(points[idx], q), static_cast<I>(idx)); }
+    std::sort(candidates.begin(), candidates.end());
+    std::vector<I> result;
+    for (std::size_t idx = 0; idx < std::min(k, candidates.size()); idx++) { result.push_back(candidates[idx].second); }
+    return result;
+}
+
+std::vector<I> brute_force_range(const Points2d<F>& points, const BoundingBox2d<F>& bb)
+{
+    std::vector<I> result;
+    for (std::size_t idx = 0; idx < points.size(); idx++)
+    {
+        const auto& p = points[idx];
+        if (bb.rx.min <= p.x && p.x <= bb.rx.max && bb.ry.min <= p.y && p.y <= bb.ry.max) { result.push_back(static_cast<I>(idx)); }
+    }
+    return result;
+}
+
+std::vector<I> brute_force_radius(const Points2d<F>& points, const Point2d<F>& q, F r)
+{
+    std::vector<I> result;
+    for (std::size_t idx = 0; idx < points.size(); idx++) { if (sq_dist(points[idx], q) <= r * r) { result.push_back(static_cast<I>(idx)); } }
+    return result;
+}
+
+std::vector<I> sorted(std::vector<I> indices)
+{
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+template <typename SpatialIndex>
+void check_queries(const SpatialIndex& spatial_index, const Points2d<F>& points)
+{
+    REQUIRE(spatial_index.size() == points.size());
+    std::vector<I> result;
+    const auto queries = generators::uniform_point_cloud<F>(50, 7).vertices;
+    for (const auto& q0 : queries)
+    {
+        // Some queries are outside of the bounding box of the points
+        const Point2d<F> q(F{3} * q0.x - F{1}, F{3} * q0.y - F{1});
+        const auto expected_knn = brute_force_k_nearest(points, q, 10);
+        CHECK(spatial_index.nearest(q) == expected_knn.front());
+        spatial_index.k_nearest(q, 10, result);
+        CHECK(result == expected_knn);
+
+        BoundingBox2d<F> bb;
+        bb.add(q).add(Point2d<F>(q.x + F{0.3}, q.y + F{0.2}));
+        spatial_index.range(bb, result);
+        CHECK(sorted(result) == brute_force_range(points, bb));
+
+        spatial_index.radius(q, F{0.15}, result);
+        CHECK(sorted(result) == brute_force_radius(points, q, F{0.15}));
+    }
+}
+
+} // namespace tests
+} // namespace
+
+TEST_CASE("KdTree queries", "[spatial_index]")
+{
+    const auto uniform = generators::uniform_point_cloud<tests::F>(2000, 1).vertices;
+    const auto clustered = generators::clustered_point_cloud<tests::F>(2000, 2).vertices;
+    for (const auto* points : { &uniform, &clustered })
+    {
+        const KdTree<tests::F, tests::I> kd_tree(stdutils::make_const_span(*points));
+        tests::check_queries(kd_tree, *points);
+    }
+}
+
+TEST_CASE("UniformGrid queries", "[spatial_index]")
+{
+    const auto uniform = generators::uniform_point_cloud<tests::F>(2000, 1).vertices;
+    const auto clustered = generators::clustered_point_cloud<tests::F>(2000, 2).vertices;
+    for (const auto* points : { &uniform, &clustered })
+    {
+        const UniformGrid<tests::F, tests::I> grid(stdutils::make_const_span(*points));
+        CHECK(grid.nb_cells_x() * grid.nb_cells_y() <= points->size());
+        tests::check_queries(grid, *points);
+    }
+}
+
+TEST_CASE("Spatial indices built in parallel", "[spatial_index]")
+{
+    const auto points = generators::uniform_point_cloud<tests::F>(20000, 3).vertices;
+    const stdutils::parallel::Policy policy{ 4, 1000 };
+    const KdTree<tests::F, tests::I> kd_tree(policy, stdutils::make_const_span(points));
+    tests::check_queries(kd_tree, points);
+    const UniformGrid<tests::F, tests::I> grid(policy, stdutils::make_const_span(points));
+    tests::check_queries(grid, points);
+}
+
+TEST_CASE("Spatial indices of degenerate point sets", "[spatial_index]")
+{
+    using F = tests::F;
+    using I = tests::I;
+    std::vector<I> result;
+
+    // Empty
+    const KdTree<F, I> empty_kd_tree;
+    const UniformGrid<F, I> empty_grid;
+    CHECK(empty_kd_tree.nearest(Point2d<F>(0.0, 0.0)) == graphs::IndexTraits<I>::undef());
+    CHECK(empty_grid.nearest(Point2d<F>(0.0, 0.0)) == graphs::IndexTraits<I>::undef());
+    empty_grid.k_nearest(Point2d<F>(0.0, 0.0), 3, result);
+    CHECK(result.empty());
+
+    // Aligned points, and duplicates
+    Points2d<F> points;
+    for (int idx = 0; idx < 100; idx++) { points.emplace_back(static_cast<F>(idx % 50), 1.0); }
+    const KdTree<F, I> kd_tree(stdutils::make_const_span(points));
+    const UniformGrid<F, I> grid(stdutils::make_const_span(points));
+    CHECK(grid.nb_cells_y() == 1);
+    tests::check_queries(kd_tree, points);
+    tests::check_queries(grid, points);
+    CHECK(kd_tree.nearest(Point2d<F>(3.2, 0.0)) == 3);
+    CHECK(grid.nearest(Point2d<F>(3.2, 0.0)) == 3);
+    grid.k_nearest(Point2d<F>(3.2, 0.0), 2, result);
+    CHECK(result == std::vector<I>{ 3, 53 });
+    kd_tree.k_nearest(Point2d<F>(3.2, 0.0), 200, result);
+    CHECK(result.size() == points.size());
+}
+
+} // namespace shapes
@@ -4,6 +4,10 @@
 
 #include <graphs/union_find.h>
 
+#include <cstdint>
+#include <thread>
+#include <vector>
+
 namespace graphs {
 
 TEST_CASE("Union Find: simple test", "[graphs]")
@@ -40,4 +44,56 @@ TEST_CASE("Union Find: simple test", "[graphs]")
     CHECK(set.find(4) == set.find(5));
 }
 
+TEST_CASE("Union Find: path compression", "[graphs]")
+{
+    using I = UnionFind<>::index;
+    constexpr I N = 1000;
+
+    UnionFind<I> set(N);
+    for (I i = 1; i < N; i++) { set.subset_union(i - 1, i); }
+    const UnionFind<I>& const_set = set;
+    CHECK(const_set.subset_size(0) == N);
+    const I root = const_set.find(N - 1);
+    for (I i = 0; i < N; i++)
+    {
+        CHECK(set.find(i) == root);
+        CHECK(const_set.find(i) == root);
+    }
+}
+
+TEST_CASE("Concurrent Union Find", "[graphs]")
+{
+    using I = ConcurrentUnionFind<>::index;
+    constexpr I N = 10000;
+    constexpr I NB_THREADS = 4;
+
+    {
+        ConcurrentUnionFind<I> small_set(10);
+        CHECK(small_set.size() == 10);
+        CHECK(small_set.subset_union(2, 3) == true);
+        CHECK(small_set.subset_union(3, 2) == false);
+        CHECK(small_set.same_subset(2, 3));
+        CHECK(!small_set.same_subset(2, 4));
+    }
+
+    ConcurrentUnionFind<I> set(N);
+
+    // Each thread merges the elements of same parity in an interleaved order
+    std::vector<std::thread> threads;
+    for (I t = 0; t < NB_THREADS; t++)
+    {
+        threads.emplace_back([&set, t]() {
+            for (I i = 2 + t; i < N; i += NB_THREADS) { set.subset_union(i - 2, i); }
+        });
+    }
+    for (auto& thread : threads) { thread.join(); }
+
+    for (I i = 0; i < N; i++)
+    {
+        CHECK(set.same_subset(i, i % 2));
+        CHECK(set.find(i) == set.find(i % 2));
+    }
+    CHECK(!set.same_subset(0, 1));
+}
+
 } // namespace graphs
@@ -2,8 +2,12 @@
 // This code is distributed under the terms of the MIT License
 #include <catch_amalgamated.hpp>
 
+#include <graphs/graph.h>
 #include <shapes/vect.h>
+#include <shapes/vect_batch.h>
+#include <stdutils/span.h>
 
+#include <cstdint>
 #include <vector>
 #include <sstream>
 #include <string>
@@ -83,4 +87,32 @@ TEST_CASE("Test vector norms", "[vect]")
     CHECK(norm(a) == 1.f);
 }
 
+TEST_CASE("Test batch operations on vectors", "[vect]")
+{
+    const std::vector<Vect2d<float>> vects = { { 3.f, 4.f }, { -1.f, 2.f }, { 0.f, 0.f }, { 5.f, -2.f }, { -6.f, -8.f } };
+    const auto in = stdutils::make_const_span(vects);
+
+    std::vector<float> out(vects.size());
+    sq_norms(in, stdutils::make_span(out));
+    CHECK(out == std::vector<float>{ 25.f, 5.f, 0.f, 29.f, 100.f });
+    norms(in, stdutils::make_span(out));
+    CHECK(out[0] == 5.f);
+    CHECK(out[4] == 10.f);
+
+    const std::vector<graphs::Edge<std::uint32_t>> edges = { { 0, 1 }, { 4, 0 }, { 2, 2 } };
+    std::vector<float> sq_lengths(edges.size());
+    sq_distances(in, stdutils::make_const_span(edges), stdutils::make_span(sq_lengths));
+    CHECK(sq_lengths == std::vector<float>{ 20.f, 225.f, 0.f });
+
+    const auto bb = bounding_box(in);
+    CHECK(bb.min() == Vect2d<float>(-6.f, -8.f));
+    CHECK(bb.max() == Vect2d<float>(5.f, 4.f));
+    CHECK(!bounding_box(stdutils::Span<const Point2d<float>>()).is_populated());
+
+    std::vector<Vect2d<float>> transformed(vects.size());
+    affine_transform(in, Vect2d<float>(2.f, -1.f), Vect2d<float>(1.f, 1.f), stdutils::make_span(transformed));
+    CHECK(transformed[0] == Vect2d<float>(7.f, -3.f));
+    CHECK(transformed[4] == Vect2d<float>(-11.f, 9.f));
+}
+
 } // namespace shapes
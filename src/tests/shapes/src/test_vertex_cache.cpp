@@ -0,0 +1,88 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <graphs/graph.h>
+#include <graphs/graph_algos.h>
+#include <graphs/vertex_cache.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace graphs {
+
+namespace {
+
+// Triangulation of a regular grid of n x n vertices, with its faces shuffled
+TriangleSoup<std::uint32_t> shuffled_grid(std::uint32_t n)
+{
+    TriangleSoup<std::uint32_t> result;
+    for (std::uint32_t j = 0; j + 1 < n; j++)
+    {
+        for (std::uint32_t i = 0; i + 1 < n; i++)
+        {
+            const std::uint32_t v = j * n + i;
+            result.emplace_back(v, v + 1, v + n + 1);
+            result.emplace_back(v, v + n + 1, v + n);
+        }
+    }
+    std::mt19937 rng(1234);
+    std::shuffle(result.begin(), result.end(), rng);
+    return result;
+}
+
+std::vector<std::size_t> identity_order(std::size_t n)
+{
+    std::vector<std::size_t> result(n);
+    std::iota(result.begin(), result.end(), std::size_t{0});
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Vertex cache order of a shuffled grid", "[vertex_cache]")
+{
+    const auto triangles = shuffled_grid(100);
+    auto face_order = identity_order(triangles.size());
+    const float initial_acmr = average_cache_miss_ratio(triangles, face_order.cbegin(), face_order.cend());
+    CHECK(initial_acmr > 2.5f);
+    vertex_cache_order(triangles, face_order.begin(), face_order.end());
+
+    // A permutation of the faces
+    auto sorted_order = face_order;
+    std::sort(sorted_order.begin(), sorted_order.end());
+    CHECK(sorted_order == identity_order(triangles.size()));
+    const float optimized_acmr = average_cache_miss_ratio(triangles, face_order.cbegin(), face_order.cend());
+    CHECK(optimized_acmr < 0.8f);
+
+    // Same result on the faces themselves
+    auto optimized_triangles = triangles;
+    optimize_vertex_cache(optimized_triangles);
+    const auto optimized_order = identity_order(optimized_triangles.size());
+    CHECK(average_cache_miss_ratio(optimized_triangles, optimized_order.cbegin(), optimized_order.cend()) == optimized_acmr);
+}
+
+TEST_CASE("Vertex cache order of a sub-range of the faces", "[vertex_cache]")
+{
+    const auto triangles = shuffled_grid(30);
+    auto face_order = identity_order(triangles.size());
+    const std::size_t half = face_order.size() / 2;
+    vertex_cache_order(triangles, face_order.begin() + static_cast<std::ptrdiff_t>(half), face_order.end());
+    CHECK(std::is_sorted(face_order.cbegin(), face_order.cbegin() + static_cast<std::ptrdiff_t>(half)));
+    auto second_half = std::vector<std::size_t>(face_order.cbegin() + static_cast<std::ptrdiff_t>(half), face_order.cend());
+    std::sort(second_half.begin(), second_half.end());
+    CHECK(second_half.front() == half);
+    CHECK(second_half.back() == triangles.size() - 1);
+    CHECK(std::adjacent_find(second_half.cbegin(), second_half.cend()) == second_half.cend());
+
+    // Empty and single face ranges are left as is
+    vertex_cache_order(triangles, face_order.begin(), face_order.begin());
+    vertex_cache_order(triangles, face_order.begin(), face_order.begin() + 1);
+    CHECK(face_order.front() == 0);
+}
+
+} // namespace graphs
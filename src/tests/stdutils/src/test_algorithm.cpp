@@ -3,14 +3,20 @@
 #include <catch_amalgamated.hpp>
 
 #include <stdutils/algorithm.h>
+#include <stdutils/parallel.h>
 #include <stdutils/span.h>
 #include <stdutils/testing.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <list>
 #include <locale>
+#include <numeric>
 #include <queue>
+#include <random>
 #include <stack>
 #include <string>
 #include <vector>
@@ -184,3 +190,82 @@ TEST_CASE("merge", "[algorithm]")
     stdutils::merge(dst, src, std::less<char>());
     CHECK(dst == "abcdefghijklmnopqrstuvwxyz");
 }
+
+namespace {
+
+template <typename F>
+void check_radix_sort_by_key()
+{
+    using Elt = std::pair<F, int>;
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<F> distrib(F{-1000}, F{1000});
+    std::vector<Elt> input;
+    for (int idx = 0; idx < 20000; idx++) { input.emplace_back(idx % 7 == 0 ? std::round(distrib(gen)) + F{0} : distrib(gen), idx); }     // With duplicates, and no -0.0
+    input.emplace_back(std::numeric_limits<F>::infinity(), -1);
+    input.emplace_back(-std::numeric_limits<F>::infinity(), -2);
+    input.emplace_back(F{0}, -3);
+    auto expected = input;
+    std::stable_sort(expected.begin(), expected.end(), [](const Elt& lhs, const Elt& rhs) { return lhs.first < rhs.first; });
+
+    stdutils::parallel::Policy policy;
+    policy.nb_threads = 3;
+    policy.min_chunk_size = 1000;
+    for (const auto& p : { stdutils::parallel::Policy{ 1 }, policy })
+    {
+        auto sorted = input;
+        stdutils::radix_sort_by_key(p, sorted.begin(), sorted.end(), [](const Elt& elt) { return elt.first; });
+        CHECK(sorted == expected);
+    }
+
+    // Small ranges, and a byte shared by all the keys
+    std::vector<Elt> small { { F{2}, 0 }, { F{1}, 1 }, { F{2}, 2 } };
+    stdutils::radix_sort_by_key(policy, small.begin(), small.end(), [](const Elt& elt) { return elt.first; });
+    CHECK(small == std::vector<Elt>{ { F{1}, 1 }, { F{2}, 0 }, { F{2}, 2 } });
+    std::vector<Elt> empty;
+    stdutils::radix_sort_by_key(policy, empty.begin(), empty.end(), [](const Elt& elt) { return elt.first; });
+    CHECK(empty.empty());
+}
+
+} // namespace
+
+TEST_CASE("radix_sort_by_key", "[algorithm]")
+{
+    check_radix_sort_by_key<float>();
+    check_radix_sort_by_key<double>();
+}
+
+TEST_CASE("Parallel algorithms wrappers", "[algorithm]")
+{
+    stdutils::parallel::Policy policy;
+    policy.nb_threads = 3;
+    policy.min_chunk_size = 100;
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> distrib(-1000, 1000);
+    std::vector<int> input(10007);
+    std::generate(input.begin(), input.end(), [&]() { return distrib(gen); });
+    for (const auto& p : { stdutils::parallel::Policy{ 1 }, policy })
+    {
+        auto sorted = input;
+        stdutils::parallel_sort(p, sorted.begin(), sorted.end(), std::greater<int>());
+        CHECK(std::is_sorted(sorted.cbegin(), sorted.cend(), std::greater<int>()));
+
+        std::vector<long long> squares(input.size());
+        const auto squares_end = stdutils::parallel_transform(p, input.cbegin(), input.cend(), squares.begin(), [](int v) { return static_cast<long long>(v) * v; });
+        CHECK(squares_end == squares.end());
+        CHECK(squares[42] == static_cast<long long>(input[42]) * input[42]);
+
+        const long long sum = stdutils::parallel_reduce(p, squares.cbegin(), squares.cend(), 5ll, std::plus<long long>());
+        CHECK(sum == std::accumulate(squares.cbegin(), squares.cend(), 5ll));
+
+        auto partitioned = input;
+        const auto is_even = [](int v) { return v % 2 == 0; };
+        const auto mid = stdutils::parallel_partition(p, partitioned.begin(), partitioned.end(), is_even);
+        CHECK(mid - partitioned.begin() == std::count_if(input.cbegin(), input.cend(), is_even));
+        CHECK(std::all_of(partitioned.begin(), mid, is_even));
+        CHECK(std::none_of(mid, partitioned.end(), is_even));
+        std::sort(partitioned.begin(), partitioned.end());
+        auto input_sorted = input;
+        std::sort(input_sorted.begin(), input_sorted.end());
+        CHECK(partitioned == input_sorted);
+    }
+}
@@ -0,0 +1,63 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <stdutils/arena.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+TEST_CASE("Arena allocations", "[arena]")
+{
+    stdutils::Arena arena(1024);
+    CHECK(arena.capacity() == 1024);
+
+    void* a = arena.allocate(10, 1);
+    void* b = arena.allocate(16, 64);
+    CHECK(a != nullptr);
+    CHECK(reinterpret_cast<std::uintptr_t>(b) % 64 == 0);
+    CHECK(static_cast<std::byte*>(b) >= static_cast<std::byte*>(a) + 10);
+    CHECK(arena.nb_overflows() == 0);
+
+    // Overflow, then the buffer grows to the high-water mark
+    void* c = arena.allocate(4096, 8);
+    CHECK(c != nullptr);
+    CHECK(arena.nb_overflows() == 1);
+    const std::size_t high_water_mark = arena.high_water_mark();
+    CHECK(high_water_mark > 4096);
+    arena.reset();
+    CHECK(arena.nb_overflows() == 0);
+    CHECK(arena.capacity() == high_water_mark);
+
+    // Same sequence of allocations: No overflow
+    arena.allocate(10, 1);
+    arena.allocate(16, 64);
+    arena.allocate(4096, 8);
+    CHECK(arena.nb_overflows() == 0);
+    CHECK(arena.high_water_mark() == high_water_mark);
+}
+
+TEST_CASE("Arena allocator", "[arena]")
+{
+    stdutils::Arena arena;
+    CHECK(arena.capacity() == 0);
+    for (int job = 0; job < 3; job++)
+    {
+        stdutils::ArenaVector<int> vect{ stdutils::ArenaAllocator<int>(&arena) };
+        for (int idx = 0; idx < 1000; idx++) { vect.push_back(idx); }
+        CHECK(std::accumulate(vect.cbegin(), vect.cend(), 0) == 499500);
+        const auto copy = vect;
+        CHECK(copy.get_allocator() == vect.get_allocator());
+        CHECK((arena.nb_overflows() > 0) == (job == 0));         // The buffer is grown by the first reset()
+        arena.reset();
+    }
+    CHECK(arena.capacity() >= 2000 * sizeof(int));
+
+    // Without an arena, the allocator falls back on the heap
+    stdutils::ArenaVector<double> heap_vect(100, 1.0);
+    CHECK(heap_vect.get_allocator().arena() == nullptr);
+    CHECK(heap_vect.get_allocator() != stdutils::ArenaAllocator<double>(&arena));
+    CHECK(std::accumulate(heap_vect.cbegin(), heap_vect.cend(), 0.0) == 100.0);
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <stdutils/benchmark.h>
+
+#include <chrono>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST_CASE("Benchmark statistics with outliers", "[benchmark]")
+{
+    const std::vector<double> samples = { 10.0, 10.2, 9.9, 10.1, 10.0, 9.8, 55.0, 10.1 };
+    const auto report = stdutils::benchmark::analyze(samples);
+
+    CHECK(report.samples_ms == samples);
+    CHECK(report.nb_outliers == 1);
+    CHECK(report.result.n == 7);
+    CHECK(report.result.max == 10.2);
+    CHECK(report.result.median == 10.0);
+    CHECK_THAT(report.result.mean, Catch::Matchers::WithinAbs(10.014, 0.001));
+    CHECK(report.ci_half_width > 0.0);
+    CHECK(report.ci_half_width < 0.2);
+    CHECK(report.converged);
+}
+
+TEST_CASE("Benchmark statistics of constant samples", "[benchmark]")
+{
+    const auto report = stdutils::benchmark::analyze(std::vector<double>(5, 2.0));
+    CHECK(report.nb_outliers == 0);
+    CHECK(report.result.n == 5);
+    CHECK(report.result.median == 2.0);
+    CHECK(report.ci_half_width == 0.0);
+    CHECK(report.converged);
+
+    const auto empty_report = stdutils::benchmark::analyze(std::vector<double>());
+    CHECK(empty_report.result.n == 0);
+    CHECK_FALSE(empty_report.converged);
+}
+
+TEST_CASE("Benchmark harness", "[benchmark]")
+{
+    stdutils::benchmark::Settings settings;
+    settings.warmup_runs = 2;
+    settings.min_runs = 4;
+    settings.max_runs = 20;
+    settings.target_ci_ratio = 1.0;
+
+    std::vector<int> input(1000);
+    std::iota(input.begin(), input.end(), 0);
+    unsigned int nb_calls = 0;
+    const auto report = stdutils::benchmark::run([&]() { nb_calls++; return std::accumulate(input.cbegin(), input.cend(), 0); }, settings);
+    CHECK(report.samples_ms.size() >= settings.min_runs);
+    CHECK(report.samples_ms.size() <= settings.max_runs);
+    CHECK(nb_calls == settings.warmup_runs + report.samples_ms.size());
+
+    // The setup is called once per run, warm-up included
+    unsigned int nb_setups = 0;
+    const auto setup_report = stdutils::benchmark::run_with_setup([&]() { nb_setups++; return input; }, [](std::vector<int>& v) { v.back() = 0; }, settings);
+    CHECK(nb_setups == settings.warmup_runs + setup_report.samples_ms.size());
+
+    std::stringstream out;
+    out << setup_report;
+    CHECK(out.str().find("samples: ") == 0);
+    CHECK(out.str().find(", ci95: ") != std::string::npos);
+}
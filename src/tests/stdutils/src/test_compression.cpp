@@ -0,0 +1,78 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <stdutils/compression.h>
+#include <stdutils/io.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+std::string sample_text(std::size_t nb_lines)
+{
+    std::string result;
+    for (std::size_t idx = 0; idx < nb_lines; idx++)
+    {
+        result += std::to_string(idx) + " " + std::to_string(idx * idx % 977) + "\n";
+    }
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Detection of the compression format", "[stdutils::io]")
+{
+    using stdutils::io::Compression;
+    CHECK(stdutils::io::compression_from_magic(std::string_view("\x1f\x8b\x08\x00", 4)) == Compression::Gzip);
+    CHECK(stdutils::io::compression_from_magic(std::string_view("\x28\xb5\x2f\xfd", 4)) == Compression::Zstd);
+    CHECK(stdutils::io::compression_from_magic("\x28\xb5") == Compression::None);
+    CHECK(stdutils::io::compression_from_magic("1 2\n") == Compression::None);
+    CHECK(stdutils::io::compression_from_magic("") == Compression::None);
+
+    CHECK(stdutils::io::compression_from_extension("points.dat.gz") == Compression::Gzip);
+    CHECK(stdutils::io::compression_from_extension("points.cdt.zst") == Compression::Zstd);
+    CHECK(stdutils::io::compression_from_extension("points.dat") == Compression::None);
+    CHECK(stdutils::io::compression_from_extension("gz") == Compression::None);
+
+    CHECK(stdutils::io::is_supported(Compression::None));
+}
+
+TEST_CASE("Compression round trip", "[stdutils::io]")
+{
+    using stdutils::io::Compression;
+    const std::string text = sample_text(100000);
+    for (const auto compression : { Compression::Gzip, Compression::Zstd })
+    {
+        CAPTURE(stdutils::io::str_compression(compression));
+        std::vector<std::string> errors;
+        const stdutils::io::ErrorHandler err_handler = [&errors](stdutils::io::SeverityCode, std::string_view msg) { errors.emplace_back(msg); };
+        std::string compressed;
+        stdutils::io::CompressionOptions options;
+        options.frame_size = std::size_t{1} << 16;          // Several zstd frames
+        if (!stdutils::io::is_supported(compression))
+        {
+            CHECK(stdutils::io::compress(compression, text, compressed, err_handler, options) == false);
+            CHECK(errors.size() == 1);
+            continue;
+        }
+        REQUIRE(stdutils::io::compress(compression, text, compressed, err_handler, options));
+        CHECK(stdutils::io::compression_from_magic(compressed) == compression);
+        CHECK(compressed.size() < text.size());
+
+        std::string decompressed;
+        REQUIRE(stdutils::io::decompress(compression, compressed, decompressed, err_handler));
+        CHECK(decompressed == text);
+
+        // Concatenated members or frames
+        REQUIRE(stdutils::io::decompress(compression, compressed + compressed, decompressed, err_handler));
+        CHECK(decompressed == text + text);
+
+        // Truncated input
+        CHECK(stdutils::io::decompress(compression, std::string_view(compressed).substr(0, compressed.size() / 2), decompressed, err_handler) == false);
+        CHECK(errors.size() == 1);
+        CHECK(decompressed.empty());
+    }
+}
@@ -4,8 +4,10 @@
 
 #include <stdutils/io.h>
 
+#include <ostream>
 #include <string>
 #include <sstream>
+#include <vector>
 
 // str_severity_code() is robust to any input integer
 TEST_CASE("Severity codes as strings", "[stdutils::io]")
@@ -192,6 +194,61 @@ world
     CHECK(stdutils::io::countlines(istream) == 3);
 }
 
+TEST_CASE("ErrorLog records and forwards messages", "[stdutils::io]")
+{
+    stdutils::io::ErrorLog log;
+    CHECK(log.empty());
+    {
+        const auto handler = log.handler();
+        handler(stdutils::io::Severity::WARN, "first");
+        handler(stdutils::io::Severity::ERR, "second");
+    }
+    CHECK(log.empty() == false);
+    std::vector<std::string> forwarded;
+    log.forward([&forwarded](stdutils::io::SeverityCode code, stdutils::io::ErrorMessage msg) {
+        forwarded.emplace_back(std::string(stdutils::io::str_severity_code(code)) + ": " + std::string(msg));
+    });
+    CHECK(forwarded == std::vector<std::string> { "WARNING: first", "ERROR: second" });
+    log.clear();
+    CHECK(log.empty());
+}
+
+TEST_CASE("RepeatedMessage reports the first occurrences, then a summary", "[stdutils::io]")
+{
+    stdutils::io::ErrorLog log;
+    const auto handler = log.handler();
+    int nb_formatted = 0;
+    {
+        stdutils::io::RepeatedMessage warning(handler, stdutils::io::Severity::WARN, "Invalid lines", 2);
+        for (int line_nb = 1; line_nb <= 5; line_nb++)
+        {
+            warning([line_nb, &nb_formatted](std::ostream& out) { out << "Invalid line " << line_nb; nb_formatted++; });
+        }
+        CHECK(warning.count() == 5);
+    }
+    CHECK(nb_formatted == 2);
+    std::vector<std::string> forwarded;
+    log.forward([&forwarded](stdutils::io::SeverityCode, stdutils::io::ErrorMessage msg) { forwarded.emplace_back(msg); });
+    CHECK(forwarded == std::vector<std::string> { "Invalid line 1", "Invalid line 2", "Invalid lines: 3 more were not reported" });
+
+    // Below the severity threshold, the messages are not even formatted
+    log.clear();
+    stdutils::io::set_severity_threshold(stdutils::io::Severity::ERR);
+    CHECK(stdutils::io::is_severity_enabled(stdutils::io::Severity::ERR));
+    CHECK(!stdutils::io::is_severity_enabled(stdutils::io::Severity::WARN));
+    nb_formatted = 0;
+    {
+        stdutils::io::RepeatedMessage warning(handler, stdutils::io::Severity::WARN, "Invalid lines", 2);
+        for (int line_nb = 1; line_nb <= 5; line_nb++)
+        {
+            warning([&nb_formatted](std::ostream&) { nb_formatted++; });
+        }
+    }
+    stdutils::io::set_severity_threshold(stdutils::io::Severity::TRACE);
+    CHECK(nb_formatted == 0);
+    CHECK(log.empty());
+}
+
 TEST_CASE("SkipLineStream to skip empty lines", "[stdutils::io]")
 {
     // 6 non-empty lines
@@ -425,3 +482,54 @@ e
         CHECK(stdutils::io::countlines(sstream) == TOTAL_NB_OF_LINES);
     }
 }
+
+TEST_CASE("SkipLineView reads the same lines as SkipLineStream", "[stdutils::io]")
+{
+    static const std::vector<std::string> test_inputs {
+        "",
+        "\n",
+        "a",
+        "a\n",
+        "a\n\n  \n\t\nb\n\n",
+        "# comment\n1 2\n  # indented comment\n3 4",
+        "\n\n#\n"
+    };
+    for (const auto& input : test_inputs)
+    {
+        CAPTURE(input);
+        std::istringstream sstream(input);
+        auto line_stream = stdutils::io::SkipLineStream(sstream).skip_blank_lines().skip_comment_lines("#");
+        auto line_view = stdutils::io::SkipLineView(input).skip_blank_lines().skip_comment_lines("#");
+        std::string stream_line;
+        std::string_view view_line;
+        std::size_t stream_line_nb{0u};
+        std::size_t view_line_nb{0u};
+        bool stream_no_fail = true;
+        while (stream_no_fail)
+        {
+            CHECK(line_view.good() == line_stream.good());
+            stream_no_fail = line_stream.getline(stream_line, stream_line_nb);
+            const bool view_no_fail = line_view.getline(view_line, view_line_nb);
+            REQUIRE(view_no_fail == stream_no_fail);
+            CHECK(view_line == stream_line);
+            CHECK(view_line_nb == stream_line_nb);
+            CHECK(line_view.line_nb() == line_stream.line_nb());
+        }
+        CHECK(line_view.good() == false);
+    }
+}
+
+TEST_CASE("LineView strips the carriage return of DOS line endings", "[stdutils::io]")
+{
+    auto line_view = stdutils::io::LineView("hello\r\n\r\nworld\r\n");
+    std::string_view line;
+    std::size_t line_nb{0u};
+    REQUIRE(line_view.getline(line, line_nb));
+    CHECK(line == "hello");
+    REQUIRE(line_view.getline(line, line_nb));
+    CHECK(line.empty());
+    REQUIRE(line_view.getline(line, line_nb));
+    CHECK(line == "world");
+    CHECK(line_nb == 3);
+    CHECK(line_view.getline(line, line_nb) == false);
+}
@@ -0,0 +1,79 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <stdutils/io.h>
+#include <stdutils/log_sink.h>
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+TEST_CASE("stdutils::io::LogSink forwards the messages of concurrent threads", "[log_sink]")
+{
+    constexpr int nb_threads = 4;
+    constexpr int nb_messages_per_thread = 500;
+    std::vector<std::pair<stdutils::io::SeverityCode, std::string>> messages;
+    stdutils::io::LogSink sink([&messages](stdutils::io::SeverityCode code, stdutils::io::ErrorMessage msg) { messages.emplace_back(code, std::string(msg)); }, 64);
+    {
+        std::vector<std::thread> threads;
+        for (int thread_idx = 0; thread_idx < nb_threads; thread_idx++)
+        {
+            threads.emplace_back([&sink, thread_idx]() {
+                const auto handler = sink.handler();
+                for (int msg_idx = 0; msg_idx < nb_messages_per_thread; msg_idx++)
+                {
+                    handler(stdutils::io::Severity::WARN, std::to_string(thread_idx) + " " + std::to_string(msg_idx));
+                    if (msg_idx % 16 == 0) { sink.flush(); }
+                }
+            });
+        }
+        for (auto& thread : threads) { thread.join(); }
+    }
+    sink.flush();
+    CHECK(messages.size() + sink.nb_dropped() == static_cast<std::size_t>(nb_threads * nb_messages_per_thread));
+
+    // The messages of a thread are in order
+    std::vector<int> last_msg_idx(nb_threads, -1);
+    for (const auto& [code, msg] : messages)
+    {
+        CHECK(code == stdutils::io::Severity::WARN);
+        const auto sep = msg.find(' ');
+        REQUIRE(sep != std::string::npos);
+        const int thread_idx = std::stoi(msg.substr(0, sep));
+        const int msg_idx = std::stoi(msg.substr(sep + 1));
+        REQUIRE(thread_idx < nb_threads);
+        CHECK(msg_idx > last_msg_idx[static_cast<std::size_t>(thread_idx)]);
+        last_msg_idx[static_cast<std::size_t>(thread_idx)] = msg_idx;
+    }
+}
+
+TEST_CASE("stdutils::io::LogSink drops the messages once full", "[log_sink]")
+{
+    std::atomic<bool> release{false};
+    std::vector<std::string> messages;
+    stdutils::io::LogSink sink([&messages, &release](stdutils::io::SeverityCode, stdutils::io::ErrorMessage msg) {
+        while (!release) { std::this_thread::yield(); }            // The consumer thread is stuck until released
+        messages.emplace_back(msg);
+    }, 4);
+    std::size_t nb_accepted = 0;
+    for (int msg_idx = 0; msg_idx < 10; msg_idx++)
+    {
+        if (sink.push(stdutils::io::Severity::INFO, "msg")) { nb_accepted++; }
+    }
+    CHECK(nb_accepted <= 5);                                        // The capacity, plus the message held by the consumer thread
+    CHECK(sink.nb_dropped() == 10 - nb_accepted);
+    release = true;
+    sink.flush();
+    CHECK(messages.size() == nb_accepted);
+
+    // Long messages are truncated
+    const std::string long_message(2 * stdutils::io::LogSink::MAX_MESSAGE_SIZE, 'x');
+    CHECK(sink.push(stdutils::io::Severity::INFO, long_message));
+    sink.flush();
+    REQUIRE(messages.size() == nb_accepted + 1);
+    CHECK(messages.back().size() == stdutils::io::LogSink::MAX_MESSAGE_SIZE);
+}
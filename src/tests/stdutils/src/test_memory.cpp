@@ -0,0 +1,64 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <stdutils/memory.h>
+
+#include <cstdint>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST_CASE("Byte size of the containers", "[memory]")
+{
+    std::vector<std::uint32_t> vect;
+    CHECK(stdutils::memory::byte_size(vect) == 0);
+    vect.reserve(100);
+    CHECK(stdutils::memory::byte_size(vect) == vect.capacity() * 4);
+    vect.push_back(1);
+    CHECK(stdutils::memory::byte_size(vect) >= 400);
+
+    std::vector<bool> flags(800);
+    CHECK(stdutils::memory::byte_size(flags) >= 100);
+
+    std::map<int, double> map;
+    CHECK(stdutils::memory::byte_size(map) == 0);
+    map[0] = 1.0;
+    map[1] = 2.0;
+    CHECK(stdutils::memory::byte_size(map) > 2 * (sizeof(int) + sizeof(double)));
+}
+
+TEST_CASE("Resident set size of the process", "[memory]")
+{
+    const std::size_t current_rss = stdutils::memory::get_current_rss();
+    const std::size_t peak_rss = stdutils::memory::get_peak_rss();
+    if (current_rss == 0 || peak_rss == 0)
+    {
+        FAIL("The RSS is not available on this platform");
+    }
+    CHECK(current_rss <= peak_rss);
+
+    // The peak RSS never decreases
+    {
+        std::vector<char> buffer(16 * 1024 * 1024, 'a');
+        CHECK(buffer.back() == 'a');
+    }
+    CHECK(stdutils::memory::get_peak_rss() >= peak_rss);
+}
+
+TEST_CASE("Human-readable byte sizes", "[memory]")
+{
+    const auto to_string = [](std::size_t bytes) {
+        std::stringstream out;
+        out << stdutils::memory::HumanReadable{ bytes };
+        return out.str();
+    };
+    CHECK(to_string(0) == "0 B");
+    CHECK(to_string(999) == "999 B");
+    CHECK(to_string(1000) == "1 kB");
+    CHECK(to_string(12345) == "12.3 kB");
+    CHECK(to_string(4500000) == "4.5 MB");
+    CHECK(to_string(2000000000) == "2 GB");
+    CHECK(stdutils::memory::to_string(stdutils::memory::HumanReadable{ 12345 }) == "12.3 kB");
+}
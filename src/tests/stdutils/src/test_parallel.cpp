@@ -0,0 +1,123 @@
+// Copyright (c) 2023 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <stdutils/parallel.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("stdutils::parallel::nb_chunks", "[parallel]")
+{
+    stdutils::parallel::Policy policy;
+    policy.nb_threads = 4;
+    policy.min_chunk_size = 10;
+    CHECK(stdutils::parallel::max_threads(policy) == 4);
+    CHECK(stdutils::parallel::nb_chunks(policy, 0) == 1);
+    CHECK(stdutils::parallel::nb_chunks(policy, 15) == 1);
+    CHECK(stdutils::parallel::nb_chunks(policy, 25) == 2);
+    CHECK(stdutils::parallel::nb_chunks(policy, 1000) == 4);
+
+    policy.nb_threads = 0;
+    CHECK(stdutils::parallel::max_threads(policy) >= 1);
+}
+
+TEST_CASE("stdutils::parallel::for_each_chunk", "[parallel]")
+{
+    stdutils::parallel::Policy policy;
+    policy.nb_threads = 3;
+    policy.min_chunk_size = 1;
+    constexpr std::size_t n = 100;
+    std::vector<int> visited(n, 0);
+    std::atomic<std::size_t> nb_calls{0};
+    stdutils::parallel::for_each_chunk(policy, n, [&visited, &nb_calls](std::size_t, std::size_t begin_idx, std::size_t end_idx) {
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++) { visited[idx]++; }
+        nb_calls++;
+    });
+    CHECK(nb_calls == 3);
+    CHECK(std::all_of(visited.cbegin(), visited.cend(), [](int v) { return v == 1; }));
+
+    // Exceptions are propagated to the calling thread
+    CHECK_THROWS_AS(stdutils::parallel::for_each_chunk(policy, n, [](std::size_t chunk_idx, std::size_t, std::size_t) {
+        if (chunk_idx == 2) { throw std::runtime_error("Chunk failure"); }
+    }), std::runtime_error);
+}
+
+TEST_CASE("stdutils::parallel::sort", "[parallel]")
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> distrib(-1000, 1000);
+    for (unsigned int nb_threads = 1; nb_threads <= 5; nb_threads++)
+    {
+        CAPTURE(nb_threads);
+        stdutils::parallel::Policy policy;
+        policy.nb_threads = nb_threads;
+        policy.min_chunk_size = 16;
+        std::vector<int> values(1001);
+        std::generate(values.begin(), values.end(), [&]() { return distrib(gen); });
+        auto expected = values;
+        std::sort(expected.begin(), expected.end(), std::greater<int>());
+        stdutils::parallel::sort(policy, values.begin(), values.end(), std::greater<int>());
+        CHECK(values == expected);
+    }
+}
+
+TEST_CASE("stdutils::parallel::for_each_ordered", "[parallel]")
+{
+    stdutils::parallel::Policy policy;
+    policy.nb_threads = 4;
+    constexpr std::size_t N = 100;
+    std::vector<std::size_t> results(N, 0);
+    std::vector<std::size_t> done_order;
+    stdutils::parallel::for_each_ordered(policy, N, [&results](std::size_t idx) {
+        results[idx] = idx * idx;
+    }, [&results, &done_order](std::size_t idx) {
+        CHECK(results[idx] == idx * idx);
+        done_order.push_back(idx);
+    });
+    std::vector<std::size_t> expected_order(N);
+    std::iota(expected_order.begin(), expected_order.end(), std::size_t{0});
+    CHECK(done_order == expected_order);
+
+    // Exceptions
+    done_order.clear();
+    CHECK_THROWS_AS(stdutils::parallel::for_each_ordered(policy, N, [](std::size_t idx) {
+        if (idx == 10) { throw std::runtime_error("Task failure"); }
+    }, [&done_order](std::size_t idx) {
+        done_order.push_back(idx);
+    }), std::runtime_error);
+    CHECK(done_order.size() <= 10);
+    CHECK(std::is_sorted(done_order.cbegin(), done_order.cend()));
+    CHECK_THROWS_AS(stdutils::parallel::for_each_ordered(policy, N, [](std::size_t) {}, [](std::size_t idx) {
+        if (idx == 20) { throw std::runtime_error("Callback failure"); }
+    }), std::runtime_error);
+}
+
+TEST_CASE("stdutils::parallel::for_each_dynamic", "[parallel]")
+{
+    stdutils::parallel::Policy policy;
+    policy.nb_threads = 4;
+    constexpr std::size_t N = 1000;
+    CHECK(stdutils::parallel::nb_workers(policy, N) == 4);
+    CHECK(stdutils::parallel::nb_workers(policy, 2) == 2);
+    CHECK(stdutils::parallel::nb_workers(policy, 0) == 1);
+    std::vector<std::size_t> results(N, 0);
+    std::vector<std::size_t> worker_of_task(N, 0);
+    stdutils::parallel::for_each_dynamic(policy, N, [&results, &worker_of_task](std::size_t worker_idx, std::size_t idx) {
+        results[idx] = idx * idx;
+        worker_of_task[idx] = worker_idx;
+    });
+    for (std::size_t idx = 0; idx < N; idx++) { CHECK(results[idx] == idx * idx); }
+    CHECK(std::all_of(worker_of_task.cbegin(), worker_of_task.cend(), [](std::size_t worker_idx) { return worker_idx < 4; }));
+
+    // Exceptions
+    CHECK_THROWS_AS(stdutils::parallel::for_each_dynamic(policy, N, [](std::size_t, std::size_t idx) {
+        if (idx == 10) { throw std::runtime_error("Task failure"); }
+    }), std::runtime_error);
+}
@@ -38,3 +38,19 @@ TEST_CASE("System paths", "[platform]")
     }
     std::cerr << ">>> Local application data path: " << local_app_data_path << " <<<" << std::endl;
 }
+
+TEST_CASE("CPU topology", "[platform]")
+{
+    const auto nodes = stdutils::platform::numa_nodes();
+    REQUIRE(!nodes.empty());
+    for (const auto& node : nodes)
+    {
+        CAPTURE(node.id);
+        CHECK(!node.cpus.empty());
+    }
+    std::stringstream out;
+    stdutils::platform::print_cpu_topology(out, stdutils::platform::NO_ENDL);
+    std::cerr << ">>> " << out.str() << " <<<" << std::endl;
+
+    CHECK(stdutils::platform::set_current_thread_affinity({}) == false);
+}
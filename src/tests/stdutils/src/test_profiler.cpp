@@ -0,0 +1,58 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <stdutils/profiler.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace stdutils {
+
+namespace {
+
+    std::size_t count_occurrences(const std::string& str, const std::string& pattern)
+    {
+        std::size_t count = 0;
+        for (auto pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + pattern.size()))
+            count++;
+        return count;
+    }
+
+    std::string chrome_trace()
+    {
+        std::stringstream out;
+        profiler::save_chrome_trace(out);
+        return out.str();
+    }
+
+} // namespace
+
+TEST_CASE("Profiler zones are only recorded when enabled", "[profiler]")
+{
+    profiler::clear();
+    profiler::set_enabled(false);
+    {
+        const profiler::Zone zone("test_zone_disabled");
+    }
+    CHECK(count_occurrences(chrome_trace(), "\"test_zone_disabled\"") == 0);
+
+    profiler::set_enabled(true);
+    {
+        const profiler::Zone zone("test_zone_enabled");
+    }
+    std::thread thread([]() { const profiler::Zone zone("test_zone_enabled"); });
+    thread.join();
+    profiler::set_enabled(false);
+
+    const std::string trace = chrome_trace();
+    CHECK(trace.rfind("{\"traceEvents\":[", 0) == 0);
+    CHECK(count_occurrences(trace, "\"name\":\"test_zone_enabled\",\"ph\":\"X\"") == 2);
+    CHECK(count_occurrences(trace, "\"tid\":") == 2);
+
+    profiler::clear();
+    CHECK(count_occurrences(chrome_trace(), "\"test_zone_enabled\"") == 0);
+}
+
+} // namespace stdutils
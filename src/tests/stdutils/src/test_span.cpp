@@ -35,6 +35,21 @@ TEST_CASE("Dynamic extent span<T> from containers with make_span", "[span]")
     CHECK(const_span[0] == 1);
 }
 
+TEST_CASE("Dynamic extent span<T> from empty containers", "[span]")
+{
+    std::vector<int> test_vect;
+
+    auto span = stdutils::make_span(test_vect);
+    CHECK(span.size() == 0);
+    CHECK(span.empty());
+    CHECK(span.begin() == span.end());
+
+    auto const_span = stdutils::make_const_span(test_vect);
+    CHECK(const_span.empty());
+    const stdutils::Span<const int> converted(span);
+    CHECK(converted.empty());
+}
+
 TEST_CASE("Static extent span<T> to span<const T>", "[span]")
 {
     std::vector<int> test_vect { 1, 2, 3, 4 };
@@ -136,3 +136,59 @@ TEST_CASE("ostream", "[stats]")
     out << stdutils::stats::Result<float>();
     CHECK(!out.str().empty());
 }
+
+TEST_CASE("P2Quantile", "[stats]")
+{
+    stdutils::stats::P2Quantile<double> median(0.5);
+    CHECK(median.nb_samples() == 0);
+    CHECK(std::isnan(median.quantile()));
+
+    // Exact on the first samples
+    for (const double val : { 3., 1., 2. }) { median.add_sample(val); }
+    CHECK(median.nb_samples() == 3);
+    CHECK(median.quantile() == 2.);
+
+    // Approximate on a large number of samples
+    stdutils::stats::P2Quantile<double> p90(0.9);
+    stdutils::stats::P2Quantile<double> p99(0.99);
+    const std::size_t n = 100000;
+    for (std::size_t idx = 0; idx < n; idx++)
+    {
+        const double val = static_cast<double>((idx * 7919) % n) / static_cast<double>(n);      // A permutation of [0, 1)
+        median.add_sample(val);
+        p90.add_sample(val);
+        p99.add_sample(val);
+    }
+    CHECK_THAT(median.quantile(), Catch::Matchers::WithinAbs(0.5, 0.01));
+    CHECK_THAT(p90.quantile(), Catch::Matchers::WithinAbs(0.9, 0.01));
+    CHECK_THAT(p99.quantile(), Catch::Matchers::WithinAbs(0.99, 0.01));
+}
+
+TEST_CASE("CumulSamples with quantiles", "[stats]")
+{
+    // The estimates are biased on sorted or nearly sorted samples: Add them in a permuted order
+    stdutils::stats::CumulSamples<float> samples(true);
+    const auto distrib = gen_circle_1d_distrib<float>(1000, 2.f);
+    for (std::size_t idx = 0; idx < distrib.size(); idx++) { samples.add_sample(distrib[(idx * 389) % distrib.size()]); }
+
+    const auto& result = samples.get_result();
+    CHECK(result.n == 1000);
+    CHECK(result.has_median());
+    CHECK(result.has_quantiles());
+    CHECK_THAT(result.median, Catch::Matchers::WithinAbs(0.f, 0.05f));
+    CHECK_THAT(result.p90, Catch::Matchers::WithinAbs(2.f * std::cos(0.1f * stdutils::numbers::pi_v<float>), 0.05f));
+    CHECK(result.p99 <= result.max);
+    CHECK(result.p90 <= result.p99);
+
+    std::stringstream out;
+    out << result;
+    CHECK(out.str().find("p99") != std::string::npos);
+
+    // The quantiles are dropped by a merge
+    stdutils::stats::CumulSamples<float> other;
+    other.add_sample(1.f);
+    samples += other;
+    CHECK(samples.get_result().n == 1001);
+    CHECK(!samples.get_result().has_median());
+    CHECK(!samples.get_result().has_quantiles());
+}
@@ -0,0 +1,106 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <stdutils/parallel.h>
+#include <stdutils/platform.h>
+#include <stdutils/thread_pool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("stdutils::parallel::TaskGroup", "[thread_pool]")
+{
+    stdutils::parallel::ThreadPool pool(3);
+    CHECK(pool.nb_workers() == 3);
+    std::atomic<int> sum{0};
+    {
+        stdutils::parallel::TaskGroup group(pool);
+        for (int idx = 1; idx <= 100; idx++) { group.run([&sum, idx]() { sum += idx; }); }
+        group.wait();
+        CHECK(sum == 5050);
+    }
+
+    // The first exception is rethrown by wait()
+    stdutils::parallel::TaskGroup group(pool);
+    group.run([]() { throw std::runtime_error("Task failure"); });
+    CHECK_THROWS_AS(group.wait(), std::runtime_error);
+    CHECK(group.is_cancelled());
+
+    // The tasks of a cancelled group are skipped
+    std::atomic<int> nb_runs{0};
+    group.run([&nb_runs]() { nb_runs++; });
+    group.wait();
+    CHECK(nb_runs == 0);
+}
+
+TEST_CASE("stdutils::parallel::TaskGroup without worker threads", "[thread_pool]")
+{
+    // The waiting thread runs the tasks
+    stdutils::parallel::ThreadPool pool(0);
+    std::atomic<int> nb_runs{0};
+    stdutils::parallel::TaskGroup group(pool);
+    for (int idx = 0; idx < 10; idx++) { group.run([&nb_runs]() { nb_runs++; }); }
+    group.wait();
+    CHECK(nb_runs == 10);
+}
+
+TEST_CASE("A thread pool pinned to a NUMA node", "[thread_pool]")
+{
+    const auto nodes = stdutils::platform::numa_nodes();
+    REQUIRE(!nodes.empty());
+    const auto& cpus = nodes.front().cpus;
+    stdutils::parallel::ThreadPool pool(2, cpus);
+    CHECK(pool.cpu_affinity() == cpus);
+    std::atomic<int> sum{0};
+    {
+        stdutils::parallel::TaskGroup group(pool);
+        for (int k = 1; k <= 100; k++) { group.run([&sum, k]() { sum += k; }); }
+        group.wait();
+    }
+    CHECK(sum == 5050);
+}
+
+TEST_CASE("stdutils::parallel::parallel_for", "[thread_pool]")
+{
+    constexpr std::size_t n = 10000;
+    std::vector<int> visited(n, 0);
+    std::atomic<std::size_t> nb_large_ranges{0};
+    stdutils::parallel::parallel_for(n, 64, [&visited, &nb_large_ranges](std::size_t begin_idx, std::size_t end_idx) {
+        if (end_idx - begin_idx > 64) { nb_large_ranges++; }
+        for (std::size_t idx = begin_idx; idx < end_idx; idx++) { visited[idx]++; }
+    });
+    CHECK(nb_large_ranges == 0);
+    CHECK(std::all_of(visited.cbegin(), visited.cend(), [](int v) { return v == 1; }));
+
+    // Cancellation
+    stdutils::parallel::TaskGroup group;
+    std::atomic<std::size_t> nb_visited{0};
+    CHECK_THROWS_AS(stdutils::parallel::parallel_for(group, n, 1, [&nb_visited](std::size_t begin_idx, std::size_t end_idx) {
+        nb_visited += end_idx - begin_idx;
+        if (begin_idx == 0) { throw std::runtime_error("Range failure"); }
+    }), std::runtime_error);
+    CHECK(group.is_cancelled());
+    CHECK(nb_visited < n);
+}
+
+TEST_CASE("Nested parallel algorithms share the default pool", "[thread_pool]")
+{
+    stdutils::parallel::Policy policy;
+    policy.nb_threads = 4;
+    policy.min_chunk_size = 1;
+    constexpr std::size_t n = 16;
+    std::vector<std::size_t> sums(n, 0);
+    stdutils::parallel::for_each_dynamic(policy, n, [&policy, &sums](std::size_t, std::size_t idx) {
+        std::vector<std::size_t> chunk_sums(stdutils::parallel::nb_chunks(policy, 1000), 0);
+        stdutils::parallel::for_each_chunk(policy, 1000, [&chunk_sums](std::size_t chunk_idx, std::size_t begin_idx, std::size_t end_idx) {
+            for (std::size_t k = begin_idx; k < end_idx; k++) { chunk_sums[chunk_idx] += k; }
+        });
+        for (const auto s : chunk_sums) { sums[idx] += s; }
+    });
+    CHECK(std::all_of(sums.cbegin(), sums.cend(), [](std::size_t s) { return s == 999 * 1000 / 2; }));
+    CHECK(stdutils::parallel::set_default_thread_pool_size(2) == false);
+}
@@ -0,0 +1,137 @@
+// Copyright (c) 2024 Pierre DEJOUE
+// This code is distributed under the terms of the MIT License
+#include <catch_amalgamated.hpp>
+
+#include <svg/svg.h>
+
+#include <shapes/path.h>
+#include <stdutils/io.h>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace {
+
+// A fresh directory for the SVG file and the cache, removed at the end of the test
+class TestDirectory
+{
+public:
+    explicit TestDirectory(std::string_view name)
+        : m_path(std::filesystem::temp_directory_path() / name)
+    {
+        std::filesystem::remove_all(m_path);
+        std::filesystem::create_directories(m_path / "cache");
+    }
+    ~TestDirectory() { std::error_code err_code; std::filesystem::remove_all(m_path, err_code); }
+
+    const std::filesystem::path& path() const noexcept { return m_path; }
+    std::filesystem::path cache_dir() const { return m_path / "cache"; }
+
+private:
+    std::filesystem::path m_path;
+};
+
+void write_file(const std::filesystem::path& filepath, std::string_view content)
+{
+    std::ofstream out(filepath, std::ios::binary | std::ios::trunc);
+    REQUIRE(out.is_open());
+    out << content;
+}
+
+std::size_t nb_files(const std::filesystem::path& dir)
+{
+    std::size_t count = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) { if (entry.is_regular_file()) { count++; } }
+    return count;
+}
+
+bool same_paths(const svg::io::Paths<double>& lhs, const svg::io::Paths<double>& rhs)
+{
+    if (lhs.point_paths.size() != rhs.point_paths.size() || lhs.cubic_bezier_paths.size() != rhs.cubic_bezier_paths.size())
+        return false;
+    for (std::size_t idx = 0; idx < lhs.point_paths.size(); idx++)
+    {
+        if (lhs.point_paths[idx].closed != rhs.point_paths[idx].closed || lhs.point_paths[idx].vertices != rhs.point_paths[idx].vertices)
+            return false;
+    }
+    for (std::size_t idx = 0; idx < lhs.cubic_bezier_paths.size(); idx++)
+    {
+        if (lhs.cubic_bezier_paths[idx].closed != rhs.cubic_bezier_paths[idx].closed || lhs.cubic_bezier_paths[idx].vertices != rhs.cubic_bezier_paths[idx].vertices)
+            return false;
+    }
+    return true;
+}
+
+constexpr std::string_view SQUARE_SVG = R"(<svg xmlns="http://www.w3.org/2000/svg" width="10" height="10"><path d="M 0 0 L 10 0 L 10 10 L 0 10 Z"/></svg>)";
+constexpr std::string_view CURVE_SVG = R"(<svg xmlns="http://www.w3.org/2000/svg" width="10" height="10"><path d="M 0 0 C 1 5 9 5 10 0 L 10 10 Z"/></svg>)";
+
+} // namespace
+
+TEST_CASE("SVG cache: Miss, hit and stale entry", "[svg]")
+{
+    const TestDirectory test_dir("delaunay_viewer_utests_svg_cache");
+    const auto svg_path = test_dir.path() / "shape.svg";
+    write_file(svg_path, SQUARE_SVG);
+
+    std::size_t nb_errors = 0;
+    bool is_cache_hit = false;
+    const stdutils::io::ErrorHandler err_handler = [&nb_errors, &is_cache_hit](stdutils::io::SeverityCode code, stdutils::io::ErrorMessage msg) {
+        if (code <= stdutils::io::Severity::WARN) { nb_errors++; }
+        if (msg == "Loaded the SVG paths from the cache") { is_cache_hit = true; }
+    };
+    const auto no_cache_paths = svg::io::parse_svg_paths(svg_path, err_handler);
+    REQUIRE(!no_cache_paths.point_paths.empty());
+
+    // Miss: The entry is written, and no temporary file is left
+    const auto miss_paths = svg::io::parse_svg_paths(svg_path, test_dir.cache_dir(), err_handler);
+    CHECK(!is_cache_hit);
+    CHECK(same_paths(miss_paths, no_cache_paths));
+    CHECK(nb_files(test_dir.cache_dir()) == 1);
+
+    // Hit
+    const auto hit_paths = svg::io::parse_svg_paths(svg_path, test_dir.cache_dir(), err_handler);
+    CHECK(is_cache_hit);
+    CHECK(same_paths(hit_paths, no_cache_paths));
+    CHECK(nb_errors == 0);
+
+    // Stale entry: The SVG file was modified since the entry was written, therefore it is parsed again
+    write_file(svg_path, CURVE_SVG);
+    std::filesystem::last_write_time(svg_path, std::filesystem::last_write_time(svg_path) + std::chrono::seconds(10));
+    const auto modified_paths = svg::io::parse_svg_paths(svg_path, err_handler);
+    REQUIRE(!same_paths(modified_paths, no_cache_paths));
+    is_cache_hit = false;
+    const auto stale_paths = svg::io::parse_svg_paths(svg_path, test_dir.cache_dir(), err_handler);
+    CHECK(!is_cache_hit);
+    CHECK(same_paths(stale_paths, modified_paths));
+    CHECK(nb_files(test_dir.cache_dir()) == 2);
+    CHECK(nb_errors == 0);
+}
+
+TEST_CASE("SVG cache: Corrupted entry", "[svg]")
+{
+    const TestDirectory test_dir("delaunay_viewer_utests_svg_corrupted");
+    const auto svg_path = test_dir.path() / "shape.svg";
+    write_file(svg_path, SQUARE_SVG);
+    const auto expected_paths = svg::io::parse_svg_paths(svg_path, stdutils::io::ErrorHandler([](stdutils::io::SeverityCode, stdutils::io::ErrorMessage) {}));
+
+    std::size_t nb_warnings = 0;
+    const stdutils::io::ErrorHandler err_handler = [&nb_warnings](stdutils::io::SeverityCode code, stdutils::io::ErrorMessage) {
+        if (code == stdutils::io::Severity::WARN) { nb_warnings++; }
+    };
+    svg::io::parse_svg_paths(svg_path, test_dir.cache_dir(), err_handler);
+    REQUIRE(nb_files(test_dir.cache_dir()) == 1);
+    const auto entry_path = std::filesystem::directory_iterator(test_dir.cache_dir())->path();
+    write_file(entry_path, "Not an SHB file");
+
+    // The entry is ignored with a warning, then overwritten
+    CHECK(same_paths(svg::io::parse_svg_paths(svg_path, test_dir.cache_dir(), err_handler), expected_paths));
+    CHECK(nb_warnings == 1);
+    CHECK(same_paths(svg::io::parse_svg_paths(svg_path, test_dir.cache_dir(), err_handler), expected_paths));
+    CHECK(nb_warnings == 1);
+    CHECK(nb_files(test_dir.cache_dir()) == 1);
+}